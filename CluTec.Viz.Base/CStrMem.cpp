@@ -51,7 +51,17 @@ CStrMem::CStrMem(const char* nstr)
 CStrMem::CStrMem(const CStrMem& nstr)
 {
 	str.SetBlockSize(nstr.str.GetBlockSize());
-	str   = nstr.str;
+	Assign(nstr.Str(), nstr.Len());
+	cfill = nstr.cfill;
+}
+
+// Move Constructor. Leaves an empty string in nstr.
+CStrMem::CStrMem(CStrMem&& nstr)
+{
+	str.SetBlockSize(32);
+	str    = 1;
+	str[0] = 0;
+	str.SwapData(nstr.str);
 	cfill = nstr.cfill;
 }
 
@@ -107,6 +117,9 @@ CStrMem CStrMem::operator()(size_t fpos, size_t lpos, bool bCut)
 
 	strncpy_s(sdata, s.Len() + 1, &data[fpos], iLen);
 
+	// The sub string is shorter if lpos is beyond the end of this string
+	s.str.Set(strlen(sdata) + 1);
+
 	// Remove characters from original string
 	if (bCut)
 	{
@@ -177,8 +190,23 @@ CStrMem CStrMem::First(int iNumChars, bool bCut)
 // Assignment operator
 CStrMem& CStrMem::operator=(const CStrMem& nstr)
 {
-	str   = nstr.str;
-	cfill = nstr.cfill;
+	if (this != &nstr)
+	{
+		Assign(nstr.Str(), nstr.Len());
+		cfill = nstr.cfill;
+	}
+
+	return *this;
+}
+
+// Move assignment operator. Swaps the memory of both strings.
+CStrMem& CStrMem::operator=(CStrMem&& nstr)
+{
+	if (this != &nstr)
+	{
+		str.SwapData(nstr.str);
+		cfill = nstr.cfill;
+	}
 
 	return *this;
 }
@@ -188,10 +216,7 @@ CStrMem& CStrMem::operator=(const char* nstr)
 {
 	if (nstr)
 	{
-		if ((str = strlen(nstr) + 1))
-		{
-			strcpy_s(str.Data(), str.Count(), nstr);
-		}
+		Assign(nstr, strlen(nstr));
 	}
 	else
 	{
@@ -205,11 +230,7 @@ CStrMem& CStrMem::operator=(const char* nstr)
 // Assignment operator
 CStrMem& CStrMem::operator=(const char a)
 {
-	str    = 2;
-	str[0] = a;
-	str[1] = 0;
-
-	return *this;
+	return Assign(&a, 1);
 }
 
 // Assignment operator
@@ -278,6 +299,91 @@ CStrMem& CStrMem::operator=(const void* a)
 	return *this;
 }
 
+// Set string to nLen characters of pcText
+CStrMem& CStrMem::Assign(const char* pcText, size_t nLen)
+{
+	char* pcData = str.Data();
+
+	if ((pcText >= pcData) && (pcText < pcData + str.Count()))
+	{
+		// Part of this string. Move it before the memory is resized.
+		memmove(pcData, pcText, nLen);
+		if (str.Set(nLen + 1))
+		{
+			str[nLen] = 0;
+		}
+	}
+	else if (str.Set(nLen + 1))
+	{
+		memcpy(str.Data(), pcText, nLen);
+		str[nLen] = 0;
+	}
+
+	return *this;
+}
+
+// Set length of string. If the memory is too small, at least twice the current capacity is reserved.
+bool CStrMem::Grow(size_t nLen)
+{
+	size_t nCount = nLen + 1;
+
+	if (nCount > str.Capacity())
+	{
+		size_t nCap = 2 * str.Capacity();
+
+		if (!str.Reserve(nCap > nCount ? nCap : nCount))
+		{
+			return false;
+		}
+	}
+
+	return str.Set(nCount);
+}
+
+// Reserve memory for nLen characters
+bool CStrMem::Reserve(size_t nLen)
+{
+	if (nLen + 1 <= str.Capacity())
+	{
+		return true;
+	}
+
+	return str.Reserve(nLen + 1);
+}
+
+// Append nLen characters
+CStrMem& CStrMem::Append(const char* pcText, size_t nLen)
+{
+	size_t nCurLen = Len();
+	char* pcData   = str.Data();
+
+	if (!nLen)
+	{
+		return *this;
+	}
+
+	// Text may be part of this string and be moved by Grow()
+	if ((pcText >= pcData) && (pcText < pcData + str.Count()))
+	{
+		size_t nOffset = size_t(pcText - pcData);
+
+		if (Grow(nCurLen + nLen))
+		{
+			pcData = str.Data();
+			memmove(&pcData[nCurLen], &pcData[nOffset], nLen);
+			pcData[nCurLen + nLen] = 0;
+		}
+	}
+	else if (Grow(nCurLen + nLen))
+	{
+		pcData = str.Data();
+		memcpy(&pcData[nCurLen], pcText, nLen);
+		pcData[nCurLen + nLen] = 0;
+	}
+
+	return *this;
+}
+
 // Test whether char is a format char
 int isFormat(char c)
 {
@@ -414,57 +520,58 @@ CStrMem operator~(const CStrMem& a)
 // Concat Strings
 CStrMem operator+(const CStrMem& a, const CStrMem& b)
 {
-	CStrMem c, d;
-	c = a;
-	d = b;
+	CStrMem c;
+	c.cfill = a.cfill;
 
-	if ((c.str += strlen(d.str.Data())))
-	{
-		strcat_s(c.str.Data(), c.str.Count(), d.str.Data());
-	}
+	c.Reserve(a.Len() + b.Len());
+	c.Append(a).Append(b);
 
 	return c;
 }
 
-// Concat to this String
-CStrMem& operator+=(CStrMem& a, const CStrMem& b)
+// Concat to temporary string, e.g. in a sum of strings
+CStrMem operator+(CStrMem&& a, const CStrMem& b)
 {
-	CStrMem c;
-	c = b;
+	a.Append(b);
 
-	if ((a.str += strlen(c.str.Data())))
-	{
-		strcat_s(a.str.Data(), a.str.Count(), c.str.Data());
-	}
+	return std::move(a);
+}
 
-	return a;
+// Concat to this String
+CStrMem& operator+=(CStrMem& a, const CStrMem& b)
+{
+	return a.Append(b);
 }
 
 // Concat Strings
 CStrMem operator+(const CStrMem& a, const char* b)
 {
 	CStrMem c;
-	c = a;
+	size_t nLen = strlen(b);
+	c.cfill = a.cfill;
 
-	if ((c.str += strlen(b)))
-	{
-		strcat_s(c.str.Data(), c.str.Count(), b);
-	}
+	c.Reserve(a.Len() + nLen);
+	c.Append(a).Append(b, nLen);
 
 	return c;
 }
 
+// Concat to temporary string, e.g. in a sum of strings
+CStrMem operator+(CStrMem&& a, const char* b)
+{
+	a.Append(b);
+
+	return std::move(a);
+}
+
 // Concat Strings
 CStrMem operator+(const char* b, const CStrMem& a)
 {
-	CStrMem c, d;
-	c = b;
-	d = a;
+	CStrMem c;
+	size_t nLen = strlen(b);
 
-	if ((c.str += strlen(d.str.Data())))
-	{
-		strcat_s(c.str.Data(), c.str.Count(), d.str.Data());
-	}
+	c.Reserve(nLen + a.Len());
+	c.Append(b, nLen).Append(a);
 
 	return c;
 }
@@ -472,25 +579,17 @@ CStrMem operator+(const char* b, const CStrMem& a)
 // Concat to this String
 CStrMem& operator+=(CStrMem& a, const char* b)
 {
-	if ((a.str += strlen(b)))
-	{
-		strcat_s(a.str.Data(), a.str.Count(), b);
-	}
-
-	return a;
+	return a.Append(b);
 }
 
 // add char
 CStrMem operator+(const CStrMem& a, const char b)
 {
 	CStrMem c;
-	c = a;
-
-	size_t no = c.str.Count();
+	c.cfill = a.cfill;
 
-	c.str        += 1;
-	c.str[no - 1] = b;
-	c.str[no]     = 0;
+	c.Reserve(a.Len() + 1);
+	c.Append(a).Append(b);
 
 	return c;
 }
@@ -500,11 +599,8 @@ CStrMem operator+(const char b, const CStrMem& a)
 {
 	CStrMem c;
 
-	c.str   += 1;
-	c.str[0] = b;
-	c.str[1] = 0;
-
-	c += a;
+	c.Reserve(a.Len() + 1);
+	c.Append(b).Append(a);
 
 	return c;
 }
@@ -512,13 +608,7 @@ CStrMem operator+(const char b, const CStrMem& a)
 // Add char to this String
 CStrMem& operator+=(CStrMem& a, const char b)
 {
-	size_t no = a.str.Count();
-
-	a.str        += 1;
-	a.str[no - 1] = b;
-	a.str[no]     = 0;
-
-	return a;
+	return a.Append(b);
 }
 
 // Concat uint to string
@@ -925,6 +1015,8 @@ CStrMem operator*(const CStrMem& a, size_t n)
 		return f;
 	}
 
+	f.Reserve(a.Len() * n);
+
 	for (size_t i = 0; i < n; i++)
 	{
 		f += a;
@@ -943,6 +1035,8 @@ CStrMem operator*(size_t n, const CStrMem& a)
 		return f;
 	}
 
+	f.Reserve(a.Len() * n);
+
 	for (size_t i = 0; i < n; i++)
 	{
 		f += a;
@@ -961,12 +1055,14 @@ CStrMem& operator*=(CStrMem& a, size_t n)
 		return a;
 	}
 
+	f.Reserve(a.Len() * n);
+
 	for (size_t i = 0; i < n; i++)
 	{
 		f += a;
 	}
 
-	a = f;
+	a = std::move(f);
 	return a;
 }
 
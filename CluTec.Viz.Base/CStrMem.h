@@ -31,6 +31,10 @@ Operators + and << can be used concurrently.
 The former for sums including at least one element at the first or second
 position of type cStr.
 The latter for streams that do not necessarily include vars of type cStr.
+
+The length of a string is Count() - 1 of its memory. Code that writes to Str()
+directly must not shorten the string. Appending grows the memory geometrically,
+so that building a string from many parts takes linear time.
 */
 
 #ifndef _CSTR_HH_
@@ -39,6 +43,7 @@ The latter for streams that do not necessarily include vars of type cStr.
 #include <stdio.h>
 #include <string.h>
 #include <ctype.h>
+#include <utility>
 #include "mem.h"
 
 class CStrMem;
@@ -59,6 +64,7 @@ class CStrMem
 public:
 	CStrMem(const char *nstr = 0);
 	CStrMem(const CStrMem& nstr);
+	CStrMem(CStrMem&& nstr);
 	~CStrMem();
 	
 	//  char& operator[] (uint pos) { return str[pos]; }
@@ -95,6 +101,7 @@ public:
 
 
 	CStrMem& operator= (const CStrMem& nstr);
+	CStrMem& operator= (CStrMem&& nstr);
 	CStrMem& operator= (const char *nstr);
 	CStrMem& operator= (const char a);
 	CStrMem& operator= (const int a);
@@ -103,6 +110,24 @@ public:
 	CStrMem& operator= (const double a);
 	CStrMem& operator= (const long double a);
 	CStrMem& operator= (const void* a);
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	/// <summary>
+	/// 	Reserves memory for a string of nLen characters, so that appending up to this length does not reallocate.
+	/// </summary>
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	bool Reserve(size_t nLen);
+	size_t Capacity() const { return (str.Capacity() > 0 ? str.Capacity() - 1 : 0); }
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	/// <summary>
+	/// 	Appends nLen characters of pcText to this string. pcText may point into this string.
+	/// </summary>
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	CStrMem& Append(const char* pcText, size_t nLen);
+	CStrMem& Append(const char* pcText) { return (pcText ? Append(pcText, strlen(pcText)) : *this); }
+	CStrMem& Append(const CStrMem& csText) { return Append(csText.Str(), csText.Len()); }
+	CStrMem& Append(const char cSym) { return Append(&cSym, 1); }
 	
 	friend int operator== (const CStrMem& a, const CStrMem& b);
 	friend int operator!= (const CStrMem& a, const CStrMem& b);
@@ -124,9 +149,11 @@ public:
 	friend CStrMem operator~ (const CStrMem& a); // Reverse String
 	
 	friend CStrMem operator+ (const CStrMem& a, const CStrMem& b);
+	friend CStrMem operator+ (CStrMem&& a, const CStrMem& b);
 	friend CStrMem& operator+= (CStrMem& a, const CStrMem& b);
 	
 	friend CStrMem operator+ (const CStrMem& a, const char *b);
+	friend CStrMem operator+ (CStrMem&& a, const char *b);
 	friend CStrMem operator+ (const char *b, const CStrMem& a);
 	friend CStrMem& operator+= (CStrMem& a, const char *b);
 	
@@ -213,6 +240,12 @@ protected:
 	char cfill;
 	
 	CStrMem& MakeFormatStr(char *ts);
+
+	// Set the string to nLen characters of pcText
+	CStrMem& Assign(const char* pcText, size_t nLen);
+
+	// Set the length of the string to nLen characters. The memory grows geometrically.
+	bool Grow(size_t nLen);
 };
 
 
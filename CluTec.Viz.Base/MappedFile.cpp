@@ -0,0 +1,189 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// project:   CluTec.Viz.Base
+// file:      MappedFile.cpp
+//
+// summary:   Implements the mapped file class
+//
+//            Copyright (c) 2019 by Christian Perwass.
+//
+//            This file is part of the CluTecLib library.
+//
+//            The CluTecLib library is free software: you can redistribute it and / or modify
+//            it under the terms of the GNU Lesser General Public License as published by
+//            the Free Software Foundation, either version 3 of the License, or
+//            (at your option) any later version.
+//
+//            The CluTecLib library is distributed in the hope that it will be useful,
+//            but WITHOUT ANY WARRANTY; without even the implied warranty of
+//            MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//            GNU Lesser General Public License for more details.
+//
+//            You should have received a copy of the GNU Lesser General Public License
+//            along with the CluTecLib library.
+//            If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <stdint.h>
+
+#ifdef WIN32
+	#include <windows.h>
+#else
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+#include "MappedFile.h"
+
+//////////////////////////////////////////////////////////////////////
+// Constructor
+
+CMappedFile::CMappedFile()
+{
+	m_bOpen  = false;
+	m_pcData = nullptr;
+	m_nSize  = 0;
+
+#ifdef WIN32
+	m_hFile = INVALID_HANDLE_VALUE;
+	m_hMap  = nullptr;
+#else
+	m_iFile = -1;
+#endif
+}
+
+//////////////////////////////////////////////////////////////////////
+// Destructor
+
+CMappedFile::~CMappedFile()
+{
+	Close();
+}
+
+//////////////////////////////////////////////////////////////////////
+// Map a file
+
+bool CMappedFile::Open(const char* pcFilename)
+{
+	Close();
+
+	if (!pcFilename)
+	{
+		m_sError = "No filename given.";
+		return false;
+	}
+
+#ifdef WIN32
+	m_hFile = CreateFileA(pcFilename, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+			FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (m_hFile == INVALID_HANDLE_VALUE)
+	{
+		m_sError = std::string("File '") + pcFilename + "' could not be opened.";
+		return false;
+	}
+
+	LARGE_INTEGER liSize;
+	if (!GetFileSizeEx(m_hFile, &liSize) || (unsigned long long) liSize.QuadPart > (unsigned long long) SIZE_MAX)
+	{
+		Close();
+		m_sError = std::string("File '") + pcFilename + "' is too large to be mapped.";
+		return false;
+	}
+
+	m_nSize = size_t(liSize.QuadPart);
+
+	// Files of size zero cannot be mapped
+	if (m_nSize > 0)
+	{
+		m_hMap = CreateFileMappingA(m_hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (m_hMap)
+		{
+			m_pcData = (const char*) MapViewOfFile(m_hMap, FILE_MAP_READ, 0, 0, 0);
+		}
+
+		if (!m_pcData)
+		{
+			Close();
+			m_sError = std::string("File '") + pcFilename + "' could not be mapped.";
+			return false;
+		}
+	}
+#else
+	m_iFile = open(pcFilename, O_RDONLY);
+	if (m_iFile < 0)
+	{
+		m_sError = std::string("File '") + pcFilename + "' could not be opened.";
+		return false;
+	}
+
+	struct stat xStat;
+	if (fstat(m_iFile, &xStat) != 0)
+	{
+		Close();
+		m_sError = std::string("File '") + pcFilename + "' could not be opened.";
+		return false;
+	}
+
+	m_nSize = size_t(xStat.st_size);
+
+	if (m_nSize > 0)
+	{
+		void* pvData = mmap(nullptr, m_nSize, PROT_READ, MAP_PRIVATE, m_iFile, 0);
+		if (pvData == MAP_FAILED)
+		{
+			Close();
+			m_sError = std::string("File '") + pcFilename + "' could not be mapped.";
+			return false;
+		}
+
+		madvise(pvData, m_nSize, MADV_SEQUENTIAL);
+		m_pcData = (const char*) pvData;
+	}
+#endif
+
+	m_bOpen = true;
+	m_sError.clear();
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Unmap the file
+
+void CMappedFile::Close()
+{
+#ifdef WIN32
+	if (m_pcData)
+	{
+		UnmapViewOfFile(m_pcData);
+	}
+
+	if (m_hMap)
+	{
+		CloseHandle(m_hMap);
+		m_hMap = nullptr;
+	}
+
+	if (m_hFile != INVALID_HANDLE_VALUE)
+	{
+		CloseHandle(m_hFile);
+		m_hFile = INVALID_HANDLE_VALUE;
+	}
+#else
+	if (m_pcData)
+	{
+		munmap((void*) m_pcData, m_nSize);
+	}
+
+	if (m_iFile >= 0)
+	{
+		close(m_iFile);
+		m_iFile = -1;
+	}
+#endif
+
+	m_bOpen  = false;
+	m_pcData = nullptr;
+	m_nSize  = 0;
+}
@@ -0,0 +1,76 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// project:   CluTec.Viz.Base
+// file:      MappedFile.h
+//
+// summary:   Declares the mapped file class
+//
+//            Copyright (c) 2019 by Christian Perwass.
+//
+//            This file is part of the CluTecLib library.
+//
+//            The CluTecLib library is free software: you can redistribute it and / or modify
+//            it under the terms of the GNU Lesser General Public License as published by
+//            the Free Software Foundation, either version 3 of the License, or
+//            (at your option) any later version.
+//
+//            The CluTecLib library is distributed in the hope that it will be useful,
+//            but WITHOUT ANY WARRANTY; without even the implied warranty of
+//            MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//            GNU Lesser General Public License for more details.
+//
+//            You should have received a copy of the GNU Lesser General Public License
+//            along with the CluTecLib library.
+//            If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Read-only memory mapping of a whole file. The operating system reads the pages
+// of the file only when they are accessed, so large files can be parsed in place
+// without reading them into memory first.
+
+#ifndef _MAPPED_FILE_H_
+#define _MAPPED_FILE_H_
+
+#include <stddef.h>
+#include <string>
+
+class CMappedFile
+{
+public:
+
+	CMappedFile();
+	~CMappedFile();
+
+	// Map the given file. Returns false and sets the error text if the file cannot be opened or mapped.
+	bool Open(const char* pcFilename);
+	void Close();
+
+	bool IsOpen() const { return m_bOpen; }
+
+	// Contents of the file. Null for an empty file. Not zero terminated.
+	const char* GetData() const { return m_pcData; }
+	size_t GetSize() const { return m_nSize; }
+
+	const std::string& GetError() const { return m_sError; }
+
+protected:
+
+	CMappedFile(const CMappedFile&);
+	CMappedFile& operator=(const CMappedFile&);
+
+protected:
+
+	bool m_bOpen;
+	const char* m_pcData;
+	size_t m_nSize;
+	std::string m_sError;
+
+#ifdef WIN32
+	void* m_hFile;
+	void* m_hMap;
+#else
+	int m_iFile;
+#endif
+};
+
+#endif
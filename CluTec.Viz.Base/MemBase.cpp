@@ -52,6 +52,29 @@ MemBase::MemBase(size_t _uElSize, size_t _uElNo)
 	m_uElSize = _uElSize;
 	m_pcData = 0;
 
+	m_pcFixedData = 0;
+	m_uFixedCapElNo = 0;
+
+	Set(_uElNo);
+}
+
+//////////////////////////////////////////////////////////////////////////////////
+// Constructor with fixed memory block
+
+MemBase::MemBase(size_t _uElSize, void* pFixedData, size_t uFixedCapElNo, size_t _uElNo)
+{
+	m_bDirectAlloc = true;
+
+	m_uElNo = 0;
+	m_uCapElNo = 0;
+	m_uBlockSize = 32;
+
+	m_uElSize = _uElSize;
+	m_pcData = 0;
+
+	m_pcFixedData = (char *) pFixedData;
+	m_uFixedCapElNo = (pFixedData ? uFixedCapElNo : 0);
+
 	Set(_uElNo);
 }
 
@@ -63,6 +86,9 @@ MemBase::MemBase(const MemBase &a)
 {
 	m_pcData = 0;
 
+	m_pcFixedData = 0;
+	m_uFixedCapElNo = 0;
+
 	*this = a;
 }
 
@@ -73,9 +99,9 @@ MemBase::MemBase(const MemBase &a)
 MemBase::~MemBase()
 {
 #ifdef _DEBUG
-	if (m_pcData) free(m_pcData);
+	if (m_pcData && !IsFixedData()) free(m_pcData);
 #else
-	if (m_pcData) free(m_pcData);
+	if (m_pcData && !IsFixedData()) free(m_pcData);
 #endif
 }
 
@@ -108,10 +134,77 @@ MemBase& MemBase::operator=(const MemBase &a)
 }
 
 
+////////////////////////////////////////////////////////////////////////////
+// Swap data with other memory object without copying.
+// Not possible if either object stores its data in a fixed memory block.
+
+bool MemBase::SwapData(MemBase& rMem)
+{
+	if ( m_uElSize != rMem.m_uElSize || IsFixedData() || rMem.IsFixedData() )
+		return false;
+
+	bool bDirectAlloc = m_bDirectAlloc;
+	m_bDirectAlloc = rMem.m_bDirectAlloc;
+	rMem.m_bDirectAlloc = bDirectAlloc;
+
+	size_t uVal = m_uElNo;
+	m_uElNo = rMem.m_uElNo;
+	rMem.m_uElNo = uVal;
+
+	uVal = m_uCapElNo;
+	m_uCapElNo = rMem.m_uCapElNo;
+	rMem.m_uCapElNo = uVal;
+
+	uVal = m_uBlockSize;
+	m_uBlockSize = rMem.m_uBlockSize;
+	rMem.m_uBlockSize = uVal;
+
+	char *pcData = m_pcData;
+	m_pcData = rMem.m_pcData;
+	rMem.m_pcData = pcData;
+
+	return true;
+}
+
+
 ////////////////////////////////////////////////////////////////////////////
 // Allocate Memory
 bool MemBase::Alloc(size_t nElNo)
 {
+	if ( m_pcFixedData )
+	{
+		if ( nElNo <= m_uFixedCapElNo )
+		{
+			// Move data from heap back to fixed memory block
+			if ( m_pcData != m_pcFixedData )
+			{
+				if ( m_pcData )
+				{
+					memcpy(m_pcFixedData, m_pcData, (m_uElNo < nElNo ? m_uElNo : nElNo) * m_uElSize);
+					free(m_pcData);
+				}
+
+				m_pcData = m_pcFixedData;
+			}
+
+			return true;
+		}
+		else if ( m_pcData == m_pcFixedData )
+		{
+			// Move data from fixed memory block to heap
+			m_pcData = 0;
+
+			if ( !Alloc(nElNo) )
+			{
+				m_pcData = m_pcFixedData;
+				return false;
+			}
+
+			memcpy(m_pcData, m_pcFixedData, m_uElNo * m_uElSize);
+			return true;
+		}
+	}
+
 	++sm_uTotalAllocCount;
 
 	size_t nSize = ((nElNo == 0) ? 1 : nElNo) * m_uElSize;
@@ -45,11 +45,20 @@ public:
 	virtual ~MemBase();  
 
 protected:
+	// Constructor for derived classes that provide a fixed memory block
+	// for uFixedCapElNo elements. This block is used instead of heap memory
+	// as long as the capacity does not exceed uFixedCapElNo.
+	MemBase(size_t _uElSize, void* pFixedData, size_t uFixedCapElNo, size_t nno = 0);
+
 	bool Alloc(size_t uElNo);
 
 public:
 	MemBase& operator= (const MemBase& a);
 
+	// Swap data with other memory object of same element size without copying.
+	// Returns false if either object uses a fixed memory block.
+	bool SwapData(MemBase& rMem);
+
 	// If direct alloc is enabled, each Add, Sub, Set command
 	// directly changes the allocated memory. This is the default.
 	// If this is disabled, then a capacity can be set and 
@@ -94,6 +103,9 @@ public:
 	size_t MapToBlockSize(size_t uElNo);
 
 	void* Data() const { return m_pcData; }
+
+	// True if data is stored in fixed memory block of derived class
+	bool IsFixedData() const { return (m_pcFixedData != 0 && m_pcData == m_pcFixedData); }
 	void* GetElPtr(size_t uEl) const { return &m_pcData[(uEl >= m_uElNo ? 0 : uEl) * m_uElSize]; }
 
 protected:
@@ -109,6 +121,9 @@ protected:
 
 	char *m_pcData;		// Data pointer	
 
+	char *m_pcFixedData;	// Fixed memory block of derived class
+	size_t m_uFixedCapElNo;	// capacity of fixed memory block
+
 private:
 	static size_t sm_uTotalAllocCount;
 };
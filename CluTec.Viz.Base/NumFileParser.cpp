@@ -0,0 +1,594 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// project:   CluTec.Viz.Base
+// file:      NumFileParser.cpp
+//
+// summary:   Implements the number file parser class
+//
+//            Copyright (c) 2019 by Christian Perwass.
+//
+//            This file is part of the CluTecLib library.
+//
+//            The CluTecLib library is free software: you can redistribute it and / or modify
+//            it under the terms of the GNU Lesser General Public License as published by
+//            the Free Software Foundation, either version 3 of the License, or
+//            (at your option) any later version.
+//
+//            The CluTecLib library is distributed in the hope that it will be useful,
+//            but WITHOUT ANY WARRANTY; without even the implied warranty of
+//            MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//            GNU Lesser General Public License for more details.
+//
+//            You should have received a copy of the GNU Lesser General Public License
+//            along with the CluTecLib library.
+//            If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+#include <limits>
+
+#include "NumFileParser.h"
+#include "MappedFile.h"
+#include "matkernel.h"
+
+// Size of the chunks that are parsed in parallel. Chunks end at a line end.
+#define NUMFILE_CHUNK_SIZE		(4 * 1024 * 1024)
+
+// Longest number that is converted without allocating memory
+#define NUMFILE_NUMBER_BUF		128
+
+static const double s_pdPow10[] =
+{
+	1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10,
+	1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+//////////////////////////////////////////////////////////////////////
+// Constructor
+
+CNumFileParser::CNumFileParser()
+{
+	m_nFirstLine   = 0;
+	m_nLastLine    = LINE_END;
+	m_dFill        = std::numeric_limits<double>::quiet_NaN();
+	m_bSkipInvalid = false;
+	m_bKeepEmpty   = false;
+
+	m_pProgressFunc     = nullptr;
+	m_pvProgressContext = nullptr;
+
+	m_nRowCnt    = 0;
+	m_nColCnt    = 0;
+	m_bCancelled = false;
+
+	SetSeparators(nullptr);
+}
+
+//////////////////////////////////////////////////////////////////////
+// Set the separator characters
+
+void CNumFileParser::SetSeparators(const char* pcSep)
+{
+	memset(m_pbSep, 0, sizeof(m_pbSep));
+
+	m_pbSep[(unsigned char) ' ']  = true;
+	m_pbSep[(unsigned char) '\t'] = true;
+	m_pbSep[(unsigned char) '\r'] = true;
+
+	if (pcSep)
+	{
+		for (; *pcSep; ++pcSep)
+		{
+			m_pbSep[(unsigned char) *pcSep] = true;
+		}
+	}
+}
+
+//////////////////////////////////////////////////////////////////////
+// Select the columns to read
+
+void CNumFileParser::SetColumns(const std::vector<int>& vecCol)
+{
+	m_vecCol = vecCol;
+	m_vecColMap.clear();
+
+	for (size_t nIdx = 0; nIdx < vecCol.size(); ++nIdx)
+	{
+		int iCol = vecCol[nIdx];
+		if (iCol < 0)
+		{
+			continue;
+		}
+
+		if (size_t(iCol) >= m_vecColMap.size())
+		{
+			m_vecColMap.resize(size_t(iCol) + 1, -1);
+		}
+
+		// If a column is selected more than once, only its last position is filled here.
+		// The other positions are copied from it after parsing a row.
+		m_vecColMap[iCol] = int(nIdx);
+	}
+}
+
+//////////////////////////////////////////////////////////////////////
+// Select the lines to read
+
+void CNumFileParser::SetLineRange(size_t nFirst, size_t nLast)
+{
+	m_nFirstLine = nFirst;
+	m_nLastLine  = nLast;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Parse a number
+
+bool CNumFileParser::ParseNumber(const char* pcBegin, const char* pcEnd, double& dVal)
+{
+	const char* pcPos = pcBegin;
+	unsigned long long uMant = 0;
+	int iExp    = 0;
+	bool bNeg   = false;
+	bool bDigit = false;
+	bool bExact = true;
+
+	if ((pcPos < pcEnd) && ((*pcPos == '-') || (*pcPos == '+')))
+	{
+		bNeg = (*pcPos == '-');
+		++pcPos;
+	}
+
+	for (; pcPos < pcEnd && unsigned(*pcPos - '0') < 10; ++pcPos)
+	{
+		bDigit = true;
+		if (uMant < 100000000000000000ULL)
+		{
+			uMant = uMant * 10 + unsigned(*pcPos - '0');
+		}
+		else
+		{
+			++iExp;
+			bExact = bExact && (*pcPos == '0');
+		}
+	}
+
+	if ((pcPos < pcEnd) && (*pcPos == '.'))
+	{
+		for (++pcPos; pcPos < pcEnd && unsigned(*pcPos - '0') < 10; ++pcPos)
+		{
+			bDigit = true;
+			if (uMant < 100000000000000000ULL)
+			{
+				uMant = uMant * 10 + unsigned(*pcPos - '0');
+				--iExp;
+			}
+			else
+			{
+				bExact = bExact && (*pcPos == '0');
+			}
+		}
+	}
+
+	if (bDigit && (pcPos < pcEnd) && ((*pcPos == 'e') || (*pcPos == 'E')))
+	{
+		const char* pcExp = pcPos + 1;
+		bool bExpNeg      = false;
+		int iExpVal       = 0;
+
+		if ((pcExp < pcEnd) && ((*pcExp == '-') || (*pcExp == '+')))
+		{
+			bExpNeg = (*pcExp == '-');
+			++pcExp;
+		}
+
+		if ((pcExp < pcEnd) && unsigned(*pcExp - '0') < 10)
+		{
+			for (; pcExp < pcEnd && unsigned(*pcExp - '0') < 10; ++pcExp)
+			{
+				if (iExpVal < 100000)
+				{
+					iExpVal = iExpVal * 10 + int(*pcExp - '0');
+				}
+			}
+
+			iExp += (bExpNeg ? -iExpVal : iExpVal);
+			pcPos = pcExp;
+		}
+	}
+
+	// Fast path: a mantissa of at most 53 bits times a power of ten that is exactly
+	// representable is rounded correctly by a single multiplication or division.
+	if (bDigit && bExact && (pcPos == pcEnd))
+	{
+		if (uMant == 0)
+		{
+			dVal = (bNeg ? -0.0 : 0.0);
+			return true;
+		}
+
+		if ((uMant <= (1ULL << 53)) && (iExp >= -22) && (iExp <= 22))
+		{
+			double dMant = double(uMant);
+
+			dMant = (iExp < 0 ? dMant / s_pdPow10[-iExp] : dMant * s_pdPow10[iExp]);
+			dVal  = (bNeg ? -dMant : dMant);
+			return true;
+		}
+	}
+
+	// Everything else, like long mantissas, large exponents, hexadecimal numbers,
+	// 'inf' and 'nan', is converted by strtod.
+	size_t nLen = size_t(pcEnd - pcBegin);
+	char pcBuf[NUMFILE_NUMBER_BUF];
+	std::string sBuf;
+	const char* pcText;
+	char* pcStop;
+
+	if (nLen < NUMFILE_NUMBER_BUF)
+	{
+		memcpy(pcBuf, pcBegin, nLen);
+		pcBuf[nLen] = 0;
+		pcText      = pcBuf;
+	}
+	else
+	{
+		sBuf.assign(pcBegin, nLen);
+		pcText = sBuf.c_str();
+	}
+
+	dVal = strtod(pcText, &pcStop);
+
+	return pcStop != pcText;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Split data into chunks that end at line ends
+
+void CNumFileParser::SplitChunks(const char* pcData, size_t nSize)
+{
+	size_t nPos = 0;
+
+	m_vecChunk.clear();
+
+	while (nPos < nSize)
+	{
+		size_t nEnd = nPos + NUMFILE_CHUNK_SIZE;
+
+		if (nEnd >= nSize)
+		{
+			nEnd = nSize;
+		}
+		else
+		{
+			const char* pcLineEnd = (const char*) memchr(pcData + nEnd, '\n', nSize - nEnd);
+			nEnd = (pcLineEnd ? size_t(pcLineEnd - pcData) + 1 : nSize);
+		}
+
+		SChunk xChunk;
+		xChunk.pcBegin    = pcData + nPos;
+		xChunk.pcEnd      = pcData + nEnd;
+		xChunk.nFirstLine = 0;
+		xChunk.nMaxRowLen = 0;
+		xChunk.nFirstRow  = 0;
+		m_vecChunk.push_back(xChunk);
+
+		nPos = nEnd;
+	}
+}
+
+//////////////////////////////////////////////////////////////////////
+// Parse the lines of a chunk
+
+void CNumFileParser::ParseChunk(SChunk& xChunk) const
+{
+	const char* pcPos    = xChunk.pcBegin;
+	const char* pcEnd    = xChunk.pcEnd;
+	size_t nLine         = xChunk.nFirstLine;
+	size_t nSelCnt       = m_vecCol.size();
+	size_t nColMapCnt    = m_vecColMap.size();
+	std::vector<double>& vecVal = xChunk.vecVal;
+	double dVal;
+
+	while (pcPos < pcEnd && nLine <= m_nLastLine)
+	{
+		const char* pcLineEnd = (const char*) memchr(pcPos, '\n', size_t(pcEnd - pcPos));
+		if (!pcLineEnd)
+		{
+			pcLineEnd = pcEnd;
+		}
+
+		if (nLine >= m_nFirstLine)
+		{
+			size_t nRowStart = vecVal.size();
+			size_t nCol      = 0;
+			bool bAny        = false;
+
+			if (nSelCnt)
+			{
+				vecVal.resize(nRowStart + nSelCnt, m_dFill);
+			}
+
+			while (true)
+			{
+				while (pcPos < pcLineEnd && m_pbSep[(unsigned char) *pcPos])
+				{
+					++pcPos;
+				}
+
+				if (pcPos >= pcLineEnd)
+				{
+					break;
+				}
+
+				const char* pcValEnd = pcPos + 1;
+				while (pcValEnd < pcLineEnd && !m_pbSep[(unsigned char) *pcValEnd])
+				{
+					++pcValEnd;
+				}
+
+				bAny = true;
+
+				if (nSelCnt)
+				{
+					// No further columns are read from this line
+					if (nCol >= nColMapCnt)
+					{
+						break;
+					}
+
+					int iOut = m_vecColMap[nCol];
+					if ((iOut >= 0) && ParseNumber(pcPos, pcValEnd, dVal))
+					{
+						vecVal[nRowStart + size_t(iOut)] = dVal;
+					}
+				}
+				else if (ParseNumber(pcPos, pcValEnd, dVal))
+				{
+					vecVal.push_back(dVal);
+				}
+				else if (!m_bSkipInvalid)
+				{
+					vecVal.push_back(m_dFill);
+				}
+
+				++nCol;
+				pcPos = pcValEnd;
+			}
+
+			if (bAny || m_bKeepEmpty)
+			{
+				size_t nLen = vecVal.size() - nRowStart;
+
+				if (nSelCnt)
+				{
+					// Columns selected more than once
+					for (size_t nIdx = 0; nIdx < nSelCnt; ++nIdx)
+					{
+						int iCol = m_vecCol[nIdx];
+						if ((iCol >= 0) && (m_vecColMap[iCol] != int(nIdx)))
+						{
+							vecVal[nRowStart + nIdx] = vecVal[nRowStart + size_t(m_vecColMap[iCol])];
+						}
+					}
+				}
+
+				xChunk.vecRowLen.push_back(unsigned(nLen));
+				if (nLen > xChunk.nMaxRowLen)
+				{
+					xChunk.nMaxRowLen = nLen;
+				}
+			}
+			else
+			{
+				vecVal.resize(nRowStart);
+			}
+		}
+
+		pcPos = (pcLineEnd < pcEnd ? pcLineEnd + 1 : pcEnd);
+		++nLine;
+	}
+}
+
+//////////////////////////////////////////////////////////////////////
+// Parse a file
+
+bool CNumFileParser::Parse(const char* pcFilename)
+{
+	CMappedFile xFile;
+
+	if (!xFile.Open(pcFilename))
+	{
+		m_vecChunk.clear();
+		m_nRowCnt    = 0;
+		m_nColCnt    = 0;
+		m_bCancelled = false;
+		m_sError     = xFile.GetError();
+		return false;
+	}
+
+	return Parse(xFile.GetData(), xFile.GetSize());
+}
+
+//////////////////////////////////////////////////////////////////////
+// Parse a block of memory
+
+bool CNumFileParser::Parse(const char* pcData, size_t nSize)
+{
+	bool bRange   = (m_nFirstLine > 0 || m_nLastLine != LINE_END);
+	size_t nChunk, nLineCnt = 0;
+
+	m_nRowCnt    = 0;
+	m_nColCnt    = 0;
+	m_bCancelled = false;
+	m_sError.clear();
+
+	if (!pcData)
+	{
+		nSize = 0;
+	}
+
+	SplitChunks(pcData, nSize);
+
+	// Line numbers are only needed to select a range of lines.
+	// Counting line ends is much faster than parsing, so all chunks are counted first
+	// and only those chunks are parsed that contain selected lines.
+	if (bRange)
+	{
+		std::vector<size_t> vecLineCnt(m_vecChunk.size());
+
+		MatrixParallelFor(m_vecChunk.size() > 1, 0, m_vecChunk.size(), 1,
+			[&](size_t nFirst, size_t nLast)
+		{
+			for (size_t nIdx = nFirst; nIdx < nLast; ++nIdx)
+			{
+				const char* pcPos = m_vecChunk[nIdx].pcBegin;
+				const char* pcEnd = m_vecChunk[nIdx].pcEnd;
+				size_t nCnt       = 0;
+
+				while ((pcPos = (const char*) memchr(pcPos, '\n', size_t(pcEnd - pcPos))) != nullptr)
+				{
+					++nCnt;
+					++pcPos;
+				}
+
+				vecLineCnt[nIdx] = nCnt;
+			}
+		});
+
+		std::vector<SChunk> vecSel;
+		for (nChunk = 0; nChunk < m_vecChunk.size(); ++nChunk)
+		{
+			SChunk& xChunk = m_vecChunk[nChunk];
+			// A chunk without a final line end contains one more line
+			size_t nLastLine = nLineCnt + vecLineCnt[nChunk] - (xChunk.pcEnd[-1] == '\n' ? 1 : 0);
+
+			xChunk.nFirstLine = nLineCnt;
+			nLineCnt += vecLineCnt[nChunk];
+
+			if ((nLastLine >= m_nFirstLine) && (xChunk.nFirstLine <= m_nLastLine))
+			{
+				vecSel.push_back(xChunk);
+			}
+		}
+
+		m_vecChunk.swap(vecSel);
+	}
+
+	size_t nTotal = 0, nDone = 0;
+	for (const SChunk& xChunk : m_vecChunk)
+	{
+		nTotal += size_t(xChunk.pcEnd - xChunk.pcBegin);
+	}
+
+	// Chunks are parsed in blocks, so that progress can be reported and parsing can be cancelled.
+	size_t nBlock = 4 * size_t(CMatrixThreadPool::Global().ThreadCount());
+	std::atomic<bool> bNoMem(false);
+
+	for (nChunk = 0; nChunk < m_vecChunk.size(); nChunk += nBlock)
+	{
+		size_t nEnd = (nChunk + nBlock < m_vecChunk.size() ? nChunk + nBlock : m_vecChunk.size());
+
+		MatrixParallelFor(nEnd - nChunk > 1, nChunk, nEnd, 1,
+			[&](size_t nFirst, size_t nLast)
+		{
+			for (size_t nIdx = nFirst; nIdx < nLast; ++nIdx)
+			{
+				try
+				{
+					ParseChunk(m_vecChunk[nIdx]);
+				}
+				catch (...)
+				{
+					bNoMem = true;
+				}
+			}
+		});
+
+		if (bNoMem)
+		{
+			m_vecChunk.clear();
+			m_sError = "Not enough memory to store the values.";
+			return false;
+		}
+
+		for (size_t nIdx = nChunk; nIdx < nEnd; ++nIdx)
+		{
+			nDone += size_t(m_vecChunk[nIdx].pcEnd - m_vecChunk[nIdx].pcBegin);
+		}
+
+		if (m_pProgressFunc && !m_pProgressFunc(m_pvProgressContext, nTotal > 0 ? double(nDone) / double(nTotal) : 1.0))
+		{
+			m_vecChunk.clear();
+			m_bCancelled = true;
+			m_sError     = "Parsing cancelled.";
+			return false;
+		}
+	}
+
+	// The empty text after the last line end
+	if (m_bKeepEmpty && ((nSize == 0) || (pcData[nSize - 1] == '\n')))
+	{
+		// Without a line range nLineCnt is not known and not needed
+		if (!bRange || ((nLineCnt >= m_nFirstLine) && (nLineCnt <= m_nLastLine)))
+		{
+			SChunk xChunk;
+			xChunk.pcBegin    = pcData + nSize;
+			xChunk.pcEnd      = pcData + nSize;
+			xChunk.nFirstLine = nLineCnt;
+			xChunk.nMaxRowLen = m_vecCol.size();
+			xChunk.nFirstRow  = 0;
+			xChunk.vecVal.resize(m_vecCol.size(), m_dFill);
+			xChunk.vecRowLen.push_back(unsigned(m_vecCol.size()));
+			m_vecChunk.push_back(xChunk);
+		}
+	}
+
+	for (SChunk& xChunk : m_vecChunk)
+	{
+		xChunk.nFirstRow = m_nRowCnt;
+		m_nRowCnt += xChunk.vecRowLen.size();
+
+		if (xChunk.nMaxRowLen > m_nColCnt)
+		{
+			m_nColCnt = xChunk.nMaxRowLen;
+		}
+	}
+
+	if (!m_vecCol.empty())
+	{
+		m_nColCnt = m_vecCol.size();
+	}
+
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Copy the values to row major memory
+
+void CNumFileParser::CopyTo(double* pdData) const
+{
+	MatrixParallelFor(m_vecChunk.size() > 1, 0, m_vecChunk.size(), 1,
+		[&](size_t nFirst, size_t nLast)
+	{
+		for (size_t nIdx = nFirst; nIdx < nLast; ++nIdx)
+		{
+			const SChunk& xChunk = m_vecChunk[nIdx];
+			const double* pdVal  = xChunk.vecVal.data();
+			double* pdRow        = pdData + xChunk.nFirstRow * m_nColCnt;
+
+			for (unsigned uLen : xChunk.vecRowLen)
+			{
+				memcpy(pdRow, pdVal, size_t(uLen) * sizeof(double));
+				for (size_t nCol = uLen; nCol < m_nColCnt; ++nCol)
+				{
+					pdRow[nCol] = m_dFill;
+				}
+
+				pdVal += uLen;
+				pdRow += m_nColCnt;
+			}
+		}
+	});
+}
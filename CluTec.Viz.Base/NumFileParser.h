@@ -0,0 +1,156 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// project:   CluTec.Viz.Base
+// file:      NumFileParser.h
+//
+// summary:   Declares the number file parser class
+//
+//            Copyright (c) 2019 by Christian Perwass.
+//
+//            This file is part of the CluTecLib library.
+//
+//            The CluTecLib library is free software: you can redistribute it and / or modify
+//            it under the terms of the GNU Lesser General Public License as published by
+//            the Free Software Foundation, either version 3 of the License, or
+//            (at your option) any later version.
+//
+//            The CluTecLib library is distributed in the hope that it will be useful,
+//            but WITHOUT ANY WARRANTY; without even the implied warranty of
+//            MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//            GNU Lesser General Public License for more details.
+//
+//            You should have received a copy of the GNU Lesser General Public License
+//            along with the CluTecLib library.
+//            If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Parser for text files of numbers, one row per line. The file is memory mapped and
+// split into chunks at line ends, which are parsed in parallel on the matrix thread pool.
+// The values of each chunk are stored densely, so that no per value objects are created.
+//
+// Values are separated by any number of separator characters. Blanks, tabs and
+// carriage returns always separate values. Lines without values are skipped.
+
+#ifndef _NUM_FILE_PARSER_H_
+#define _NUM_FILE_PARSER_H_
+
+#include <stddef.h>
+#include <string>
+#include <vector>
+
+class CNumFileParser
+{
+public:
+
+	// Called between blocks of chunks with the fraction of the data parsed so far.
+	// Parsing is cancelled if the function returns false.
+	typedef bool (*TProgressFunc)(void* pvContext, double dFraction);
+
+	static const size_t LINE_END = size_t(-1);
+
+public:
+
+	CNumFileParser();
+
+	// Characters that separate values in addition to blanks, tabs and carriage returns
+	void SetSeparators(const char* pcSep);
+
+	// Zero based indices of the columns to read, in the order in which they are returned.
+	// An empty list reads all columns.
+	void SetColumns(const std::vector<int>& vecCol);
+
+	// Zero based range of lines to read, including the last line.
+	void SetLineRange(size_t nFirst, size_t nLast = LINE_END);
+
+	// Value of entries missing in a row and of entries that are not numbers. Standard is NaN.
+	void SetFillValue(double dVal) { m_dFill = dVal; }
+
+	// If true, entries that are not numbers are dropped instead of being replaced by the fill value.
+	// Has no effect if columns are selected.
+	void SetSkipInvalid(bool bSkip) { m_bSkipInvalid = bSkip; }
+
+	// If true, lines without values are returned as rows of length zero.
+	// The text after the last line end is a line, even if it is empty.
+	void SetKeepEmptyLines(bool bKeep) { m_bKeepEmpty = bKeep; }
+
+	void SetProgressFunc(TProgressFunc pFunc, void* pvContext) { m_pProgressFunc = pFunc; m_pvProgressContext = pvContext; }
+
+	// Parse a file or a block of memory. The memory has to stay valid until parsing is finished.
+	// Returns false and sets the error text if the file cannot be read or parsing is cancelled.
+	bool Parse(const char* pcFilename);
+	bool Parse(const char* pcData, size_t nSize);
+
+	bool IsCancelled() const { return m_bCancelled; }
+	const std::string& GetError() const { return m_sError; }
+
+	// Number of rows and maximal number of values in a row
+	size_t GetRowCount() const { return m_nRowCnt; }
+	size_t GetColCount() const { return m_nColCnt; }
+
+	// Copy all rows to row major memory of GetRowCount() * GetColCount() values.
+	// Rows with fewer values are filled with the fill value.
+	void CopyTo(double* pdData) const;
+
+	// Call funcRow(const double* pdVal, size_t nCount) for each row in the order of the file
+	template<class TFunc>
+	void ForEachRow(TFunc funcRow) const
+	{
+		for (const SChunk& xChunk : m_vecChunk)
+		{
+			const double* pdVal = xChunk.vecVal.data();
+
+			for (unsigned uLen : xChunk.vecRowLen)
+			{
+				funcRow(pdVal, size_t(uLen));
+				pdVal += uLen;
+			}
+		}
+	}
+
+	// Parse a number from [pcBegin, pcEnd). Returns false if the text does not start with a number.
+	// Numbers with at most 15 significant digits and a decimal exponent of at most 22 are
+	// converted exactly without calling strtod.
+	static bool ParseNumber(const char* pcBegin, const char* pcEnd, double& dVal);
+
+protected:
+
+	struct SChunk
+	{
+		const char* pcBegin;
+		const char* pcEnd;
+		// Index of the first line in the chunk
+		size_t nFirstLine;
+		// Values of all rows and number of values per row
+		std::vector<double> vecVal;
+		std::vector<unsigned> vecRowLen;
+		size_t nMaxRowLen;
+		// Index of the first row of the chunk in the result
+		size_t nFirstRow;
+	};
+
+	void SplitChunks(const char* pcData, size_t nSize);
+	void ParseChunk(SChunk& xChunk) const;
+
+protected:
+
+	bool m_pbSep[256];
+	std::vector<int> m_vecCol;
+	// Output column of each input column, or -1 if the column is not read
+	std::vector<int> m_vecColMap;
+	size_t m_nFirstLine;
+	size_t m_nLastLine;
+	double m_dFill;
+	bool m_bSkipInvalid;
+	bool m_bKeepEmpty;
+
+	TProgressFunc m_pProgressFunc;
+	void* m_pvProgressContext;
+
+	std::vector<SChunk> m_vecChunk;
+	size_t m_nRowCnt;
+	size_t m_nColCnt;
+	bool m_bCancelled;
+	std::string m_sError;
+};
+
+#endif
@@ -0,0 +1,255 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// project:   CluTec.Viz.Base
+// file:      SharedBuffer.cpp
+//
+// summary:   Implements the shared buffer class
+//
+//            Copyright (c) 2019 by Christian Perwass.
+//
+//            This file is part of the CluTecLib library.
+//
+//            The CluTecLib library is free software: you can redistribute it and / or modify
+//            it under the terms of the GNU Lesser General Public License as published by
+//            the Free Software Foundation, either version 3 of the License, or
+//            (at your option) any later version.
+//
+//            The CluTecLib library is distributed in the hope that it will be useful,
+//            but WITHOUT ANY WARRANTY; without even the implied warranty of
+//            MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//            GNU Lesser General Public License for more details.
+//
+//            You should have received a copy of the GNU Lesser General Public License
+//            along with the CluTecLib library.
+//            If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "SharedBuffer.h"
+
+//////////////////////////////////////////////////////////////////////
+// Constructor
+
+CSharedBuffer::CSharedBuffer(EDataType eType, const std::vector<int>& vecDim)
+{
+	m_iRefCnt = 1;
+	m_eType   = eType;
+	m_vecDim  = vecDim;
+
+	m_nElCnt = (vecDim.size() > 0 ? 1 : 0);
+	for (size_t nIdx = 0; nIdx < vecDim.size(); ++nIdx)
+	{
+		m_nElCnt *= size_t(vecDim[nIdx] > 0 ? vecDim[nIdx] : 0);
+	}
+
+	m_nByteCnt = m_nElCnt * DataTypeSize(eType);
+
+	for (int iSlot = 0; iSlot < 3; ++iSlot)
+	{
+		// Allocate at least one element, so that the data pointers are never null
+		m_pvSlot[iSlot]      = calloc(m_nByteCnt > 0 ? m_nByteCnt : 8, 1);
+		m_puSlotFrame[iSlot] = 0;
+	}
+
+	m_iBack       = 0;
+	m_iFront      = 1;
+	m_uFrontFrame = 0;
+	m_uPending    = 2;
+	m_uPublishCnt = 0;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Destructor
+
+CSharedBuffer::~CSharedBuffer()
+{
+	for (int iSlot = 0; iSlot < 3; ++iSlot)
+	{
+		free(m_pvSlot[iSlot]);
+	}
+}
+
+//////////////////////////////////////////////////////////////////////
+// Release a reference
+
+void CSharedBuffer::Release()
+{
+	if (m_iRefCnt.fetch_sub(1, std::memory_order_acq_rel) == 1)
+	{
+		delete this;
+	}
+}
+
+//////////////////////////////////////////////////////////////////////
+// Size of element type in bytes
+
+size_t CSharedBuffer::DataTypeSize(EDataType eType)
+{
+	switch (eType)
+	{
+	case DT_UINT8:
+		return 1;
+
+	case DT_FLOAT:
+		return sizeof(float);
+
+	case DT_DOUBLE:
+		return sizeof(double);
+	}
+
+	return 0;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Swap the back slot with the pending slot
+
+void CSharedBuffer::Publish()
+{
+	unsigned uFrame = m_uPublishCnt.fetch_add(1, std::memory_order_relaxed) + 1;
+
+	m_puSlotFrame[m_iBack] = uFrame;
+
+	// Release makes the data written to the back slot visible to the consumer
+	unsigned uPrev = m_uPending.exchange(unsigned(m_iBack) | SLOT_NEW, std::memory_order_acq_rel);
+
+	m_iBack = int(uPrev & ~SLOT_NEW);
+}
+
+//////////////////////////////////////////////////////////////////////
+// Swap the front slot with the pending slot, if the latter holds a new frame
+
+bool CSharedBuffer::Acquire()
+{
+	if (!HasNewData())
+	{
+		return false;
+	}
+
+	unsigned uPrev = m_uPending.exchange(unsigned(m_iFront), std::memory_order_acq_rel);
+
+	m_iFront      = int(uPrev & ~SLOT_NEW);
+	m_uFrontFrame = m_puSlotFrame[m_iFront];
+
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Create a named buffer
+
+CSharedBuffer* CSharedBufferRegistry::Create(const std::string& sName, int iDataType, const std::vector<int>& vecDim)
+{
+	if (sName.empty() || !CSharedBuffer::IsValidDataType(iDataType) || vecDim.size() == 0)
+	{
+		return nullptr;
+	}
+
+	for (size_t nIdx = 0; nIdx < vecDim.size(); ++nIdx)
+	{
+		if (vecDim[nIdx] <= 0)
+		{
+			return nullptr;
+		}
+	}
+
+	CSharedBuffer* pBuffer = new CSharedBuffer(CSharedBuffer::EDataType(iDataType), vecDim);
+
+	// Reference of the caller
+	pBuffer->AddRef();
+
+	std::lock_guard<std::mutex> xLock(m_xMutex);
+
+	TBufferMap::iterator itEl = m_mapBuffer.find(sName);
+	if (itEl != m_mapBuffer.end())
+	{
+		itEl->second->Release();
+		itEl->second = pBuffer;
+	}
+	else
+	{
+		m_mapBuffer[sName] = pBuffer;
+	}
+
+	return pBuffer;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Get a named buffer
+
+CSharedBuffer* CSharedBufferRegistry::Get(const std::string& sName)
+{
+	std::lock_guard<std::mutex> xLock(m_xMutex);
+
+	TBufferMap::iterator itEl = m_mapBuffer.find(sName);
+	if (itEl == m_mapBuffer.end())
+	{
+		return nullptr;
+	}
+
+	itEl->second->AddRef();
+	return itEl->second;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Remove a named buffer
+
+bool CSharedBufferRegistry::Remove(const std::string& sName)
+{
+	std::lock_guard<std::mutex> xLock(m_xMutex);
+
+	TBufferMap::iterator itEl = m_mapBuffer.find(sName);
+	if (itEl == m_mapBuffer.end())
+	{
+		return false;
+	}
+
+	itEl->second->Release();
+	m_mapBuffer.erase(itEl);
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Remove all buffers
+
+void CSharedBufferRegistry::Clear()
+{
+	std::lock_guard<std::mutex> xLock(m_xMutex);
+
+	for (TBufferMap::iterator itEl = m_mapBuffer.begin(); itEl != m_mapBuffer.end(); ++itEl)
+	{
+		itEl->second->Release();
+	}
+
+	m_mapBuffer.clear();
+}
+
+//////////////////////////////////////////////////////////////////////
+// Sum of publish counts of all buffers
+
+unsigned CSharedBufferRegistry::GetPublishCount()
+{
+	std::lock_guard<std::mutex> xLock(m_xMutex);
+
+	unsigned uCnt = 0;
+	for (TBufferMap::iterator itEl = m_mapBuffer.begin(); itEl != m_mapBuffer.end(); ++itEl)
+	{
+		uCnt += itEl->second->GetPublishCount();
+	}
+
+	return uCnt;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Names of all buffers
+
+void CSharedBufferRegistry::GetNames(std::vector<std::string>& vecName)
+{
+	std::lock_guard<std::mutex> xLock(m_xMutex);
+
+	vecName.clear();
+	for (TBufferMap::iterator itEl = m_mapBuffer.begin(); itEl != m_mapBuffer.end(); ++itEl)
+	{
+		vecName.push_back(itEl->first);
+	}
+}
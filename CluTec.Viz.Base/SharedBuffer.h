@@ -0,0 +1,169 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// project:   CluTec.Viz.Base
+// file:      SharedBuffer.h
+//
+// summary:   Declares the shared buffer class
+//
+//            Copyright (c) 2019 by Christian Perwass.
+//
+//            This file is part of the CluTecLib library.
+//
+//            The CluTecLib library is free software: you can redistribute it and / or modify
+//            it under the terms of the GNU Lesser General Public License as published by
+//            the Free Software Foundation, either version 3 of the License, or
+//            (at your option) any later version.
+//
+//            The CluTecLib library is distributed in the hope that it will be useful,
+//            but WITHOUT ANY WARRANTY; without even the implied warranty of
+//            MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//            GNU Lesser General Public License for more details.
+//
+//            You should have received a copy of the GNU Lesser General Public License
+//            along with the CluTecLib library.
+//            If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Typed data buffers that are filled by a host application and read by scripts
+// without copying the data between threads. Each buffer has three slots:
+// the producer writes into its back slot and publishes it, the consumer reads from
+// its front slot and takes over the newest published slot when it is ready for it.
+// Neither side ever waits for the other.
+
+#ifndef _SHARED_BUFFER_H_
+#define _SHARED_BUFFER_H_
+
+#include <stddef.h>
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+class CSharedBuffer
+{
+public:
+
+	// Element types. The values are those of the corresponding OpenGL data types.
+	enum EDataType
+	{
+		DT_UINT8  = 0x1401,
+		DT_FLOAT  = 0x1406,
+		DT_DOUBLE = 0x140A
+	};
+
+public:
+
+	// The buffer is created with a reference count of one.
+	CSharedBuffer(EDataType eType, const std::vector<int>& vecDim);
+
+	void AddRef() { m_iRefCnt.fetch_add(1, std::memory_order_relaxed); }
+	void Release();
+
+	static bool IsValidDataType(int iType)
+	{ return iType == DT_UINT8 || iType == DT_FLOAT || iType == DT_DOUBLE; }
+
+	static size_t DataTypeSize(EDataType eType);
+
+	EDataType GetDataType() const { return m_eType; }
+	const std::vector<int>& GetDim() const { return m_vecDim; }
+	size_t GetElementCount() const { return m_nElCnt; }
+	size_t GetByteCount() const { return m_nByteCnt; }
+
+	// Producer: Memory to write the next frame to. Stays valid until Publish() is called.
+	void* GetWriteData() { return m_pvSlot[m_iBack]; }
+
+	// Producer: Make the data written to GetWriteData() available to the consumer.
+	// A frame that has not been acquired by the consumer yet is dropped.
+	void Publish();
+
+	// Number of frames published so far
+	unsigned GetPublishCount() const { return m_uPublishCnt.load(std::memory_order_relaxed); }
+
+	// Consumer: True if a frame was published that has not been acquired yet.
+	bool HasNewData() const { return (m_uPending.load(std::memory_order_acquire) & SLOT_NEW) != 0; }
+
+	// Consumer: Take over the newest published frame, if there is one.
+	// Returns true if the data returned by GetReadData() changed.
+	bool Acquire();
+
+	// Consumer: Data of the last acquired frame. Stays valid until the next call to Acquire().
+	const void* GetReadData() const { return m_pvSlot[m_iFront]; }
+
+	// Consumer: Number of the last acquired frame. Zero if no frame has been acquired yet.
+	unsigned GetFrame() const { return m_uFrontFrame; }
+
+protected:
+
+	// Only deleted by Release()
+	~CSharedBuffer();
+
+	CSharedBuffer(const CSharedBuffer&);
+	CSharedBuffer& operator=(const CSharedBuffer&);
+
+protected:
+
+	// Flag in m_uPending marking a slot that holds a frame not yet acquired
+	static const unsigned SLOT_NEW = 0x4;
+
+	std::atomic<int> m_iRefCnt;
+
+	EDataType m_eType;
+	std::vector<int> m_vecDim;
+	size_t m_nElCnt;
+	size_t m_nByteCnt;
+
+	void* m_pvSlot[3];
+	// Frame number of the data in each slot
+	unsigned m_puSlotFrame[3];
+
+	// Slot owned by producer
+	int m_iBack;
+	// Slot owned by consumer
+	int m_iFront;
+	unsigned m_uFrontFrame;
+
+	// Slot exchanged between producer and consumer, ORed with SLOT_NEW if it holds a new frame
+	std::atomic<unsigned> m_uPending;
+	std::atomic<unsigned> m_uPublishCnt;
+};
+
+// Named shared buffers of one script environment.
+// All functions may be called from any thread.
+class CSharedBufferRegistry
+{
+public:
+
+	CSharedBufferRegistry() { }
+	~CSharedBufferRegistry() { Clear(); }
+
+	// Create a buffer, replacing a buffer of the same name.
+	// Returns the buffer with a reference owned by the caller, or nullptr if the parameters are invalid.
+	CSharedBuffer* Create(const std::string& sName, int iDataType, const std::vector<int>& vecDim);
+
+	// Returns the buffer with a reference owned by the caller, or nullptr if there is no such buffer.
+	CSharedBuffer* Get(const std::string& sName);
+
+	// Remove a buffer. Holders of references can still use it.
+	bool Remove(const std::string& sName);
+	void Clear();
+
+	// Sum of the publish counts of all buffers. Changes whenever a frame is published.
+	unsigned GetPublishCount();
+
+	void GetNames(std::vector<std::string>& vecName);
+
+protected:
+
+	CSharedBufferRegistry(const CSharedBufferRegistry&);
+	CSharedBufferRegistry& operator=(const CSharedBufferRegistry&);
+
+protected:
+
+	typedef std::map<std::string, CSharedBuffer*> TBufferMap;
+
+	std::mutex m_xMutex;
+	TBufferMap m_mapBuffer;
+};
+
+#endif
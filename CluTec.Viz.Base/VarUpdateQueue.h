@@ -0,0 +1,276 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// project:   CluTec.Viz.Base
+// file:      VarUpdateQueue.h
+//
+// summary:   Declares the variable update queue class
+//
+//            Copyright (c) 2019 by Christian Perwass.
+//
+//            This file is part of the CluTecLib library.
+//
+//            The CluTecLib library is free software: you can redistribute it and / or modify
+//            it under the terms of the GNU Lesser General Public License as published by
+//            the Free Software Foundation, either version 3 of the License, or
+//            (at your option) any later version.
+//
+//            The CluTecLib library is distributed in the hope that it will be useful,
+//            but WITHOUT ANY WARRANTY; without even the implied warranty of
+//            MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//            GNU Lesser General Public License for more details.
+//
+//            You should have received a copy of the GNU Lesser General Public License
+//            along with the CluTecLib library.
+//            If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef _VAR_UPDATE_QUEUE_H_
+#define _VAR_UPDATE_QUEUE_H_
+
+#include <atomic>
+#include <future>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+////////////////////////////////////////////////////////////////
+/// Lock-free multi-producer, single-consumer queue of variable updates.
+///
+/// Any thread may push updates without waiting for the visualization thread.
+/// The visualization thread takes all queued updates at once, keeps only
+/// the last write to each variable of each view and applies those.
+/// Updates may carry a promise that is fulfilled when the update, or a later
+/// write to the same variable that replaced it, has been applied.
+///
+/// The queue is closed while there is no consumer. Closing fails all queued updates.
+/// A producer checks again after pushing, whether the queue was closed meanwhile,
+/// so that no update remains in a closed queue without its promises being fulfilled.
+
+class CCLUVizVarUpdateQueue
+{
+public:
+
+	enum EVarType
+	{
+		VAR_INT = 0,
+		VAR_DOUBLE,
+		VAR_STRING,
+		VAR_TENSOR,
+		VAR_COLOR,
+		// Does not set a variable. Used to wait until all earlier updates are applied.
+		VAR_NONE,
+	};
+
+	struct SUpdate
+	{
+		SUpdate(int _iHandle, const char* _pcVarName, EVarType _eType)
+		{
+			pNext   = 0;
+			iHandle = _iHandle;
+			sName   = (_pcVarName ? _pcVarName : "");
+			eType   = _eType;
+			iVal    = 0;
+			dVal    = 0.0;
+			for (int i = 0; i < 4; ++i)
+			{
+				pdColor[i] = 0.0;
+			}
+		}
+
+		SUpdate* pNext;
+
+		int iHandle;
+		std::string sName;
+		EVarType eType;
+
+		int iVal;
+		double dVal;
+		double pdColor[4];
+		std::string sVal;
+		std::vector<int> vecDim;
+		std::vector<double> vecData;
+
+		// Promises of this update and of all updates it replaced
+		std::vector<std::promise<bool> > vecDone;
+	};
+
+	typedef std::pair<int, std::string> TVarKey;
+
+public:
+
+	CCLUVizVarUpdateQueue()
+	{
+		m_pHead         = nullptr;
+		m_uCoalescedCnt = 0;
+		m_bClosed       = true;
+	}
+
+	~CCLUVizVarUpdateQueue()
+	{
+		Close();
+	}
+
+	// Accept updates. Called by the consumer when it starts.
+	void Open()
+	{
+		m_bClosed.store(false);
+	}
+
+	// Reject further updates and fail all queued updates. Called by the consumer when it ends.
+	void Close()
+	{
+		m_bClosed.store(true);
+		FailAll();
+	}
+
+	bool IsClosed() const
+	{
+		return m_bClosed.load();
+	}
+
+	// Push an update. Returns false if the queue is closed. In that case the promises
+	// of the update have been fulfilled with false and the update has been deleted.
+	// rbWake is set to true if the queue was empty before, i.e. the consumer has to be woken up.
+	bool Push(SUpdate* pUpdate, bool& rbWake)
+	{
+		rbWake = false;
+
+		if (m_bClosed.load())
+		{
+			Finish(pUpdate, false);
+			return false;
+		}
+
+		// Sequentially consistent, so that either Close() takes this update,
+		// or the check below sees that the queue was closed.
+		SUpdate* pHead = m_pHead.load(std::memory_order_relaxed);
+		do
+		{
+			pUpdate->pNext = pHead;
+		}
+		while (!m_pHead.compare_exchange_weak(pHead, pUpdate, std::memory_order_seq_cst, std::memory_order_relaxed));
+
+		if (m_bClosed.load())
+		{
+			// The consumer may have ended before this update was pushed
+			FailAll();
+			return false;
+		}
+
+		rbWake = (pHead == nullptr);
+		return true;
+	}
+
+	bool IsEmpty() const
+	{
+		return m_pHead.load(std::memory_order_acquire) == nullptr;
+	}
+
+	// Take all queued updates and coalesce writes to the same variable.
+	// The returned updates are in the order of their last write and have to be deleted by the caller.
+	void PopCoalesced(std::vector<SUpdate*>& vecUpdate)
+	{
+		vecUpdate.clear();
+
+		// Entries are only removed by taking the whole list, which avoids the ABA problem.
+		// Once the queue is closed, producers may do this concurrently and each gets distinct entries.
+		SUpdate* pList = m_pHead.exchange(nullptr, std::memory_order_seq_cst);
+
+		// The list is in LIFO order
+		SUpdate* pFifo = 0;
+		while (pList)
+		{
+			SUpdate* pNext = pList->pNext;
+			pList->pNext = pFifo;
+			pFifo        = pList;
+			pList        = pNext;
+		}
+
+		std::map<TVarKey, size_t> mapIdx;
+
+		for (SUpdate* pUpdate = pFifo; pUpdate; )
+		{
+			SUpdate* pNext = pUpdate->pNext;
+			pUpdate->pNext = 0;
+
+			if (pUpdate->eType != VAR_NONE)
+			{
+				TVarKey xKey(pUpdate->iHandle, pUpdate->sName);
+				std::map<TVarKey, size_t>::iterator itEl = mapIdx.find(xKey);
+
+				if (itEl != mapIdx.end())
+				{
+					// Replace the earlier write and take over its promises
+					SUpdate* pPrev = vecUpdate[itEl->second];
+					for (size_t i = 0; i < pPrev->vecDone.size(); ++i)
+					{
+						pUpdate->vecDone.push_back(std::move(pPrev->vecDone[i]));
+					}
+
+					delete pPrev;
+					vecUpdate[itEl->second] = 0;
+					++m_uCoalescedCnt;
+				}
+
+				mapIdx[xKey] = vecUpdate.size();
+			}
+
+			vecUpdate.push_back(pUpdate);
+			pUpdate = pNext;
+		}
+
+		// Remove the entries of replaced updates
+		size_t nDst = 0;
+		for (size_t i = 0; i < vecUpdate.size(); ++i)
+		{
+			if (vecUpdate[i])
+			{
+				vecUpdate[nDst++] = vecUpdate[i];
+			}
+		}
+		vecUpdate.resize(nDst);
+	}
+
+	// Fulfill the promises of an update and delete it
+	static void Finish(SUpdate* pUpdate, bool bSuccess)
+	{
+		for (size_t i = 0; i < pUpdate->vecDone.size(); ++i)
+		{
+			pUpdate->vecDone[i].set_value(bSuccess);
+		}
+
+		delete pUpdate;
+	}
+
+protected:
+
+	// Remove all queued updates and signal failure to those waiting for them
+	void FailAll()
+	{
+		std::vector<SUpdate*> vecUpdate;
+
+		PopCoalesced(vecUpdate);
+		for (size_t i = 0; i < vecUpdate.size(); ++i)
+		{
+			Finish(vecUpdate[i], false);
+		}
+	}
+
+public:
+
+	// Number of writes that were replaced by a later write before being applied
+	unsigned GetCoalescedCount() const
+	{
+		return m_uCoalescedCnt.load(std::memory_order_relaxed);
+	}
+
+protected:
+
+	std::atomic<SUpdate*> m_pHead;
+	std::atomic<bool> m_bClosed;
+
+	std::atomic<unsigned> m_uCoalescedCnt;
+};
+
+#endif
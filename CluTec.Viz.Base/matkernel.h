@@ -0,0 +1,1001 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// project:   CluTec.Viz.Base
+// file:      matkernel.h
+//
+// summary:   Blocked, vectorized and multithreaded kernels used by the matrix class
+//
+//            Copyright (c) 2019 by Christian Perwass.
+//
+//            This file is part of the CluTecLib library.
+//
+//            The CluTecLib library is free software: you can redistribute it and / or modify
+//            it under the terms of the GNU Lesser General Public License as published by
+//            the Free Software Foundation, either version 3 of the License, or
+//            (at your option) any later version.
+//
+//            The CluTecLib library is distributed in the hope that it will be useful,
+//            but WITHOUT ANY WARRANTY; without even the implied warranty of
+//            MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//            GNU Lesser General Public License for more details.
+//
+//            You should have received a copy of the GNU Lesser General Public License
+//            along with the CluTecLib library.
+//            If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Kernels for matrix products and decompositions of large matrices.
+// The matrix class uses these kernels only above a minimal size. Below that size,
+// or if the reference kernels are selected, the original loops are used.
+// Since matrix.cxx is included in several libraries, everything in here is a template or inline.
+
+#ifndef _MATRIX_KERNEL_H_
+#define _MATRIX_KERNEL_H_
+
+#include <stddef.h>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+
+// SIMD instruction sets used by the matrix kernels
+#if defined(__AVX__)
+	#define MATKERNEL_USE_AVX
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+	#define MATKERNEL_USE_SSE2
+#endif
+
+#if defined(MATKERNEL_USE_AVX)
+	#include <immintrin.h>
+#elif defined(MATKERNEL_USE_SSE2)
+	#include <emmintrin.h>
+#endif
+
+// Rows per register tile of the product kernel
+#define MATKERNEL_GEMM_MR		4
+// Depth of a packed panel of the right matrix of a product
+#define MATKERNEL_GEMM_KC		256
+// Width of a packed panel of the right matrix of a product
+#define MATKERNEL_GEMM_NC		512
+// Minimal number of multiply-adds of a product to use the blocked kernel
+#define MATKERNEL_GEMM_MIN_OPS	(16 * 16 * 16)
+// Minimal number of multiply-adds of a product to use several threads
+#define MATKERNEL_PAR_MIN_OPS	(96 * 96 * 96)
+// Minimal matrix dimension for the blocked LU decomposition
+#define MATKERNEL_LU_MIN_DIM	96
+// Width of the column panels of the blocked LU decomposition
+#define MATKERNEL_LU_NB			64
+// Minimal number of multiply-adds of a Householder update to use several threads
+#define MATKERNEL_HH_PAR_MIN_OPS	(64 * 1024)
+
+typedef unsigned int uint;
+
+////////////////////////////////////////////////////////////////////////////////////
+// Kernel selection
+
+enum EMatrixKernel
+{
+	// Original loops, single threaded
+	MATKERNEL_REFERENCE = 0,
+	// Blocked and vectorized kernels, single threaded
+	MATKERNEL_BLOCKED,
+	// Blocked and vectorized kernels, using the thread pool for large matrices
+	MATKERNEL_PARALLEL,
+};
+
+inline EMatrixKernel& _MatrixKernelRef()
+{
+	static EMatrixKernel eKernel = MATKERNEL_PARALLEL;
+	return eKernel;
+}
+
+inline EMatrixKernel GetMatrixKernel()
+{
+	return _MatrixKernelRef();
+}
+
+inline void SetMatrixKernel(EMatrixKernel eKernel)
+{
+	_MatrixKernelRef() = eKernel;
+}
+
+inline bool UseMatrixKernelParallel(double dOps, double dMinOps)
+{
+	return _MatrixKernelRef() == MATKERNEL_PARALLEL && dOps >= dMinOps;
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// Thread pool
+//
+// The pool is created on first use and never destroyed, so that no worker threads
+// have to be joined while a module is unloaded. Only one range is processed at a time.
+// If the pool is busy or Run() is called from within a worker, the range is processed
+// by the calling thread.
+
+class CMatrixThreadPool
+{
+public:
+	typedef std::function<void(size_t, size_t)> TRangeFunc;
+
+public:
+	static CMatrixThreadPool& Global()
+	{
+		static CMatrixThreadPool* pPool = new CMatrixThreadPool();
+		return *pPool;
+	}
+
+	// Number of threads that work on a range, including the calling thread
+	uint ThreadCount()
+	{
+		return uint(m_vecThread.size()) + 1;
+	}
+
+	// Set the number of worker threads. Zero uses one thread per hardware thread.
+	void SetThreadCount(uint uCount)
+	{
+		std::lock_guard<std::mutex> xRunLock(m_mtxRun);
+
+		if (uCount == 0)
+		{
+			uCount = std::thread::hardware_concurrency();
+		}
+
+		if (uCount == 0)
+		{
+			uCount = 1;
+		}
+
+		StopWorkers();
+		StartWorkers(uCount - 1);
+	}
+
+	// Call funcRange for consecutive sub-ranges of [nBegin, nEnd) that contain
+	// at least nGrain elements, distributed over the threads of the pool.
+	void Run(size_t nBegin, size_t nEnd, size_t nGrain, const TRangeFunc& funcRange)
+	{
+		if (nEnd <= nBegin)
+		{
+			return;
+		}
+
+		size_t nCount = nEnd - nBegin;
+		size_t nTaskCnt;
+
+		if (nGrain == 0)
+		{
+			nGrain = 1;
+		}
+
+		nTaskCnt = (nCount + nGrain - 1) / nGrain;
+		if (nTaskCnt > 4 * size_t(ThreadCount()))
+		{
+			nTaskCnt = 4 * size_t(ThreadCount());
+		}
+
+		if (nTaskCnt <= 1 || m_vecThread.empty() || IsWorker())
+		{
+			funcRange(nBegin, nEnd);
+			return;
+		}
+
+		std::unique_lock<std::mutex> xRunLock(m_mtxRun, std::try_to_lock);
+		if (!xRunLock.owns_lock())
+		{
+			funcRange(nBegin, nEnd);
+			return;
+		}
+
+		{
+			std::lock_guard<std::mutex> xLock(m_mtxJob);
+			m_pFunc    = &funcRange;
+			m_nBegin   = nBegin;
+			m_nCount   = nCount;
+			m_nTaskCnt = nTaskCnt;
+			m_nNextTask.store(0);
+			m_nDoneTask = 0;
+			m_nActive   = 0;
+			++m_uJobID;
+		}
+		m_cvJob.notify_all();
+
+		size_t nDone = ProcessTasks();
+
+		std::unique_lock<std::mutex> xLock(m_mtxJob);
+		m_nDoneTask += nDone;
+		// Wait until all tasks are done and no worker accesses the job any more
+		m_cvDone.wait(xLock, [this]() { return m_nDoneTask == m_nTaskCnt && m_nActive == 0; });
+		m_pFunc = nullptr;
+	}
+
+protected:
+	CMatrixThreadPool()
+	{
+		m_pFunc     = nullptr;
+		m_nBegin    = 0;
+		m_nCount    = 0;
+		m_nTaskCnt  = 0;
+		m_nDoneTask = 0;
+		m_nActive   = 0;
+		m_uJobID    = 0;
+		m_bStop     = false;
+		m_nNextTask.store(0);
+
+		uint uCount = std::thread::hardware_concurrency();
+		StartWorkers(uCount > 1 ? uCount - 1 : 0);
+	}
+
+	static bool& IsWorker()
+	{
+		static thread_local bool s_bWorker = false;
+		return s_bWorker;
+	}
+
+	void StartWorkers(uint uCount)
+	{
+		m_bStop = false;
+		for (uint uIdx = 0; uIdx < uCount; ++uIdx)
+		{
+			m_vecThread.push_back(std::thread(&CMatrixThreadPool::WorkerLoop, this));
+		}
+	}
+
+	void StopWorkers()
+	{
+		{
+			std::lock_guard<std::mutex> xLock(m_mtxJob);
+			m_bStop = true;
+		}
+		m_cvJob.notify_all();
+
+		for (std::thread& xThread : m_vecThread)
+		{
+			xThread.join();
+		}
+
+		m_vecThread.clear();
+	}
+
+	// Process tasks of the current job until none are left. Returns the number of tasks processed.
+	size_t ProcessTasks()
+	{
+		size_t nDone = 0;
+		size_t nTask;
+
+		while ((nTask = m_nNextTask.fetch_add(1)) < m_nTaskCnt)
+		{
+			size_t nFirst = m_nBegin + (m_nCount * nTask) / m_nTaskCnt;
+			size_t nLast  = m_nBegin + (m_nCount * (nTask + 1)) / m_nTaskCnt;
+
+			(*m_pFunc)(nFirst, nLast);
+			++nDone;
+		}
+
+		return nDone;
+	}
+
+	void WorkerLoop()
+	{
+		unsigned uLastJobID = 0;
+
+		IsWorker() = true;
+
+		while (true)
+		{
+			{
+				std::unique_lock<std::mutex> xLock(m_mtxJob);
+				m_cvJob.wait(xLock, [this, uLastJobID]() { return m_bStop || (m_uJobID != uLastJobID && m_pFunc != nullptr); });
+
+				if (m_bStop)
+				{
+					return;
+				}
+
+				uLastJobID = m_uJobID;
+				++m_nActive;
+			}
+
+			size_t nDone = ProcessTasks();
+
+			{
+				std::lock_guard<std::mutex> xLock(m_mtxJob);
+				m_nDoneTask += nDone;
+				--m_nActive;
+				if (m_nDoneTask == m_nTaskCnt && m_nActive == 0)
+				{
+					m_cvDone.notify_all();
+				}
+			}
+		}
+	}
+
+protected:
+	std::vector<std::thread> m_vecThread;
+
+	std::mutex m_mtxRun;
+	std::mutex m_mtxJob;
+	std::condition_variable m_cvJob;
+	std::condition_variable m_cvDone;
+
+	const TRangeFunc* m_pFunc;
+	size_t m_nBegin, m_nCount, m_nTaskCnt, m_nDoneTask, m_nActive;
+	std::atomic<size_t> m_nNextTask;
+	unsigned m_uJobID;
+	bool m_bStop;
+};
+
+// Process the range [nBegin, nEnd) in sub-ranges of at least nGrain elements.
+// Uses the thread pool if bParallel is true.
+template<class TFunc>
+inline void MatrixParallelFor(bool bParallel, size_t nBegin, size_t nEnd, size_t nGrain, const TFunc& funcRange)
+{
+	if (!bParallel)
+	{
+		funcRange(nBegin, nEnd);
+		return;
+	}
+
+	CMatrixThreadPool::TRangeFunc funcTask(funcRange);
+	CMatrixThreadPool::Global().Run(nBegin, nEnd, nGrain, funcTask);
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// Register tiles of the matrix product
+//
+// A tile evaluates for r < MATKERNEL_GEMM_MR and c < NR
+//   pC[r * nLDC + c] += pA[r * nLDA + k] * pB[k * NR + c], summed over k < uK,
+// where pB is a packed panel of width NR. If bSub is true the product is subtracted.
+
+template<class CType>
+struct SMatrixGemmTile
+{
+	enum { NR = 4 };
+
+	static inline void Full(uint uK, const CType* pA, size_t nLDA, const CType* pB, CType* pC, size_t nLDC, bool bSub)
+	{
+		CType pdAcc[MATKERNEL_GEMM_MR][NR];
+		uint r, c, k;
+
+		for (r = 0; r < MATKERNEL_GEMM_MR; ++r)
+		{
+			for (c = 0; c < NR; ++c)
+			{
+				pdAcc[r][c] = CType(0);
+			}
+		}
+
+		for (k = 0; k < uK; ++k)
+		{
+			const CType* pBk = &pB[k * NR];
+
+			for (r = 0; r < MATKERNEL_GEMM_MR; ++r)
+			{
+				CType dA = pA[r * nLDA + k];
+				for (c = 0; c < NR; ++c)
+				{
+					pdAcc[r][c] += dA * pBk[c];
+				}
+			}
+		}
+
+		for (r = 0; r < MATKERNEL_GEMM_MR; ++r)
+		{
+			CType* pCr = &pC[r * nLDC];
+			for (c = 0; c < NR; ++c)
+			{
+				if (bSub)
+				{
+					pCr[c] -= pdAcc[r][c];
+				}
+				else
+				{
+					pCr[c] += pdAcc[r][c];
+				}
+			}
+		}
+	}
+};
+
+#if defined(MATKERNEL_USE_AVX)
+
+template<>
+struct SMatrixGemmTile<double>
+{
+	enum { NR = 8 };
+
+	static inline void Full(uint uK, const double* pA, size_t nLDA, const double* pB, double* pC, size_t nLDC, bool bSub)
+	{
+		__m256d xC00 = _mm256_setzero_pd(), xC01 = _mm256_setzero_pd();
+		__m256d xC10 = _mm256_setzero_pd(), xC11 = _mm256_setzero_pd();
+		__m256d xC20 = _mm256_setzero_pd(), xC21 = _mm256_setzero_pd();
+		__m256d xC30 = _mm256_setzero_pd(), xC31 = _mm256_setzero_pd();
+		__m256d xA, xB0, xB1;
+
+		const double* pA0 = pA;
+		const double* pA1 = pA + nLDA;
+		const double* pA2 = pA + 2 * nLDA;
+		const double* pA3 = pA + 3 * nLDA;
+
+		for (uint k = 0; k < uK; ++k, pB += NR)
+		{
+			xB0 = _mm256_loadu_pd(pB);
+			xB1 = _mm256_loadu_pd(pB + 4);
+
+			xA   = _mm256_broadcast_sd(pA0 + k);
+			xC00 = _mm256_add_pd(xC00, _mm256_mul_pd(xA, xB0));
+			xC01 = _mm256_add_pd(xC01, _mm256_mul_pd(xA, xB1));
+			xA   = _mm256_broadcast_sd(pA1 + k);
+			xC10 = _mm256_add_pd(xC10, _mm256_mul_pd(xA, xB0));
+			xC11 = _mm256_add_pd(xC11, _mm256_mul_pd(xA, xB1));
+			xA   = _mm256_broadcast_sd(pA2 + k);
+			xC20 = _mm256_add_pd(xC20, _mm256_mul_pd(xA, xB0));
+			xC21 = _mm256_add_pd(xC21, _mm256_mul_pd(xA, xB1));
+			xA   = _mm256_broadcast_sd(pA3 + k);
+			xC30 = _mm256_add_pd(xC30, _mm256_mul_pd(xA, xB0));
+			xC31 = _mm256_add_pd(xC31, _mm256_mul_pd(xA, xB1));
+		}
+
+		Store(pC, xC00, xC01, bSub);
+		Store(pC + nLDC, xC10, xC11, bSub);
+		Store(pC + 2 * nLDC, xC20, xC21, bSub);
+		Store(pC + 3 * nLDC, xC30, xC31, bSub);
+	}
+
+	static inline void Store(double* pC, __m256d xC0, __m256d xC1, bool bSub)
+	{
+		if (bSub)
+		{
+			_mm256_storeu_pd(pC, _mm256_sub_pd(_mm256_loadu_pd(pC), xC0));
+			_mm256_storeu_pd(pC + 4, _mm256_sub_pd(_mm256_loadu_pd(pC + 4), xC1));
+		}
+		else
+		{
+			_mm256_storeu_pd(pC, _mm256_add_pd(_mm256_loadu_pd(pC), xC0));
+			_mm256_storeu_pd(pC + 4, _mm256_add_pd(_mm256_loadu_pd(pC + 4), xC1));
+		}
+	}
+};
+
+template<>
+struct SMatrixGemmTile<float>
+{
+	enum { NR = 16 };
+
+	static inline void Full(uint uK, const float* pA, size_t nLDA, const float* pB, float* pC, size_t nLDC, bool bSub)
+	{
+		__m256 xC00 = _mm256_setzero_ps(), xC01 = _mm256_setzero_ps();
+		__m256 xC10 = _mm256_setzero_ps(), xC11 = _mm256_setzero_ps();
+		__m256 xC20 = _mm256_setzero_ps(), xC21 = _mm256_setzero_ps();
+		__m256 xC30 = _mm256_setzero_ps(), xC31 = _mm256_setzero_ps();
+		__m256 xA, xB0, xB1;
+
+		const float* pA0 = pA;
+		const float* pA1 = pA + nLDA;
+		const float* pA2 = pA + 2 * nLDA;
+		const float* pA3 = pA + 3 * nLDA;
+
+		for (uint k = 0; k < uK; ++k, pB += NR)
+		{
+			xB0 = _mm256_loadu_ps(pB);
+			xB1 = _mm256_loadu_ps(pB + 8);
+
+			xA   = _mm256_broadcast_ss(pA0 + k);
+			xC00 = _mm256_add_ps(xC00, _mm256_mul_ps(xA, xB0));
+			xC01 = _mm256_add_ps(xC01, _mm256_mul_ps(xA, xB1));
+			xA   = _mm256_broadcast_ss(pA1 + k);
+			xC10 = _mm256_add_ps(xC10, _mm256_mul_ps(xA, xB0));
+			xC11 = _mm256_add_ps(xC11, _mm256_mul_ps(xA, xB1));
+			xA   = _mm256_broadcast_ss(pA2 + k);
+			xC20 = _mm256_add_ps(xC20, _mm256_mul_ps(xA, xB0));
+			xC21 = _mm256_add_ps(xC21, _mm256_mul_ps(xA, xB1));
+			xA   = _mm256_broadcast_ss(pA3 + k);
+			xC30 = _mm256_add_ps(xC30, _mm256_mul_ps(xA, xB0));
+			xC31 = _mm256_add_ps(xC31, _mm256_mul_ps(xA, xB1));
+		}
+
+		Store(pC, xC00, xC01, bSub);
+		Store(pC + nLDC, xC10, xC11, bSub);
+		Store(pC + 2 * nLDC, xC20, xC21, bSub);
+		Store(pC + 3 * nLDC, xC30, xC31, bSub);
+	}
+
+	static inline void Store(float* pC, __m256 xC0, __m256 xC1, bool bSub)
+	{
+		if (bSub)
+		{
+			_mm256_storeu_ps(pC, _mm256_sub_ps(_mm256_loadu_ps(pC), xC0));
+			_mm256_storeu_ps(pC + 8, _mm256_sub_ps(_mm256_loadu_ps(pC + 8), xC1));
+		}
+		else
+		{
+			_mm256_storeu_ps(pC, _mm256_add_ps(_mm256_loadu_ps(pC), xC0));
+			_mm256_storeu_ps(pC + 8, _mm256_add_ps(_mm256_loadu_ps(pC + 8), xC1));
+		}
+	}
+};
+
+#elif defined(MATKERNEL_USE_SSE2)
+
+template<>
+struct SMatrixGemmTile<double>
+{
+	enum { NR = 4 };
+
+	static inline void Full(uint uK, const double* pA, size_t nLDA, const double* pB, double* pC, size_t nLDC, bool bSub)
+	{
+		__m128d xC00 = _mm_setzero_pd(), xC01 = _mm_setzero_pd();
+		__m128d xC10 = _mm_setzero_pd(), xC11 = _mm_setzero_pd();
+		__m128d xC20 = _mm_setzero_pd(), xC21 = _mm_setzero_pd();
+		__m128d xC30 = _mm_setzero_pd(), xC31 = _mm_setzero_pd();
+		__m128d xA, xB0, xB1;
+
+		const double* pA0 = pA;
+		const double* pA1 = pA + nLDA;
+		const double* pA2 = pA + 2 * nLDA;
+		const double* pA3 = pA + 3 * nLDA;
+
+		for (uint k = 0; k < uK; ++k, pB += NR)
+		{
+			xB0 = _mm_loadu_pd(pB);
+			xB1 = _mm_loadu_pd(pB + 2);
+
+			xA   = _mm_set1_pd(pA0[k]);
+			xC00 = _mm_add_pd(xC00, _mm_mul_pd(xA, xB0));
+			xC01 = _mm_add_pd(xC01, _mm_mul_pd(xA, xB1));
+			xA   = _mm_set1_pd(pA1[k]);
+			xC10 = _mm_add_pd(xC10, _mm_mul_pd(xA, xB0));
+			xC11 = _mm_add_pd(xC11, _mm_mul_pd(xA, xB1));
+			xA   = _mm_set1_pd(pA2[k]);
+			xC20 = _mm_add_pd(xC20, _mm_mul_pd(xA, xB0));
+			xC21 = _mm_add_pd(xC21, _mm_mul_pd(xA, xB1));
+			xA   = _mm_set1_pd(pA3[k]);
+			xC30 = _mm_add_pd(xC30, _mm_mul_pd(xA, xB0));
+			xC31 = _mm_add_pd(xC31, _mm_mul_pd(xA, xB1));
+		}
+
+		Store(pC, xC00, xC01, bSub);
+		Store(pC + nLDC, xC10, xC11, bSub);
+		Store(pC + 2 * nLDC, xC20, xC21, bSub);
+		Store(pC + 3 * nLDC, xC30, xC31, bSub);
+	}
+
+	static inline void Store(double* pC, __m128d xC0, __m128d xC1, bool bSub)
+	{
+		if (bSub)
+		{
+			_mm_storeu_pd(pC, _mm_sub_pd(_mm_loadu_pd(pC), xC0));
+			_mm_storeu_pd(pC + 2, _mm_sub_pd(_mm_loadu_pd(pC + 2), xC1));
+		}
+		else
+		{
+			_mm_storeu_pd(pC, _mm_add_pd(_mm_loadu_pd(pC), xC0));
+			_mm_storeu_pd(pC + 2, _mm_add_pd(_mm_loadu_pd(pC + 2), xC1));
+		}
+	}
+};
+
+template<>
+struct SMatrixGemmTile<float>
+{
+	enum { NR = 8 };
+
+	static inline void Full(uint uK, const float* pA, size_t nLDA, const float* pB, float* pC, size_t nLDC, bool bSub)
+	{
+		__m128 xC00 = _mm_setzero_ps(), xC01 = _mm_setzero_ps();
+		__m128 xC10 = _mm_setzero_ps(), xC11 = _mm_setzero_ps();
+		__m128 xC20 = _mm_setzero_ps(), xC21 = _mm_setzero_ps();
+		__m128 xC30 = _mm_setzero_ps(), xC31 = _mm_setzero_ps();
+		__m128 xA, xB0, xB1;
+
+		const float* pA0 = pA;
+		const float* pA1 = pA + nLDA;
+		const float* pA2 = pA + 2 * nLDA;
+		const float* pA3 = pA + 3 * nLDA;
+
+		for (uint k = 0; k < uK; ++k, pB += NR)
+		{
+			xB0 = _mm_loadu_ps(pB);
+			xB1 = _mm_loadu_ps(pB + 4);
+
+			xA   = _mm_set1_ps(pA0[k]);
+			xC00 = _mm_add_ps(xC00, _mm_mul_ps(xA, xB0));
+			xC01 = _mm_add_ps(xC01, _mm_mul_ps(xA, xB1));
+			xA   = _mm_set1_ps(pA1[k]);
+			xC10 = _mm_add_ps(xC10, _mm_mul_ps(xA, xB0));
+			xC11 = _mm_add_ps(xC11, _mm_mul_ps(xA, xB1));
+			xA   = _mm_set1_ps(pA2[k]);
+			xC20 = _mm_add_ps(xC20, _mm_mul_ps(xA, xB0));
+			xC21 = _mm_add_ps(xC21, _mm_mul_ps(xA, xB1));
+			xA   = _mm_set1_ps(pA3[k]);
+			xC30 = _mm_add_ps(xC30, _mm_mul_ps(xA, xB0));
+			xC31 = _mm_add_ps(xC31, _mm_mul_ps(xA, xB1));
+		}
+
+		Store(pC, xC00, xC01, bSub);
+		Store(pC + nLDC, xC10, xC11, bSub);
+		Store(pC + 2 * nLDC, xC20, xC21, bSub);
+		Store(pC + 3 * nLDC, xC30, xC31, bSub);
+	}
+
+	static inline void Store(float* pC, __m128 xC0, __m128 xC1, bool bSub)
+	{
+		if (bSub)
+		{
+			_mm_storeu_ps(pC, _mm_sub_ps(_mm_loadu_ps(pC), xC0));
+			_mm_storeu_ps(pC + 4, _mm_sub_ps(_mm_loadu_ps(pC + 4), xC1));
+		}
+		else
+		{
+			_mm_storeu_ps(pC, _mm_add_ps(_mm_loadu_ps(pC), xC0));
+			_mm_storeu_ps(pC + 4, _mm_add_ps(_mm_loadu_ps(pC + 4), xC1));
+		}
+	}
+};
+
+#endif
+
+////////////////////////////////////////////////////////////////////////////////////
+// Partial register tile at the border of a product with uRows <= MR and uCols <= NR
+
+template<class CType>
+inline void MatrixGemmTileEdge(uint uRows, uint uCols, uint uK, const CType* pA, size_t nLDA, const CType* pB, uint uNR, CType* pC, size_t nLDC, bool bSub)
+{
+	uint r, c, k;
+	CType dSum;
+
+	for (r = 0; r < uRows; ++r)
+	{
+		const CType* pAr = &pA[r * nLDA];
+		CType* pCr       = &pC[r * nLDC];
+
+		for (c = 0; c < uCols; ++c)
+		{
+			dSum = CType(0);
+			for (k = 0; k < uK; ++k)
+			{
+				dSum += pAr[k] * pB[k * uNR + c];
+			}
+
+			if (bSub)
+			{
+				pCr[c] -= dSum;
+			}
+			else
+			{
+				pCr[c] += dSum;
+			}
+		}
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// Blocked matrix product
+//
+// Evaluates C += A * B, or C -= A * B if bSub is true, where
+// A is a uM x uK matrix with row stride nLDA, B is a uK x uN matrix with row stride nLDB
+// and C is a uM x uN matrix with row stride nLDC. All matrices are stored row major.
+// Blocks of B are packed into panels of width NR which are reused for all rows of A.
+
+template<class CType>
+void MatrixGemm(uint uM, uint uN, uint uK, const CType* pA, size_t nLDA, const CType* pB, size_t nLDB, CType* pC, size_t nLDC, bool bSub = false)
+{
+	typedef SMatrixGemmTile<CType> TTile;
+	const uint uNR = uint(TTile::NR);
+	const uint uMR = MATKERNEL_GEMM_MR;
+
+	if (uM == 0 || uN == 0 || uK == 0)
+	{
+		return;
+	}
+
+	bool bParallel = UseMatrixKernelParallel(double(uM) * double(uN) * double(uK), double(MATKERNEL_PAR_MIN_OPS));
+	uint uKK, uJJ, uKC, uNC, uPanelCnt, uPanel, uW, c, k;
+	std::vector<CType> vecPack(size_t(MATKERNEL_GEMM_KC) * size_t(MATKERNEL_GEMM_NC + uNR));
+
+	for (uKK = 0; uKK < uK; uKK += MATKERNEL_GEMM_KC)
+	{
+		uKC = (uK - uKK < MATKERNEL_GEMM_KC ? uK - uKK : MATKERNEL_GEMM_KC);
+
+		for (uJJ = 0; uJJ < uN; uJJ += MATKERNEL_GEMM_NC)
+		{
+			uNC       = (uN - uJJ < MATKERNEL_GEMM_NC ? uN - uJJ : MATKERNEL_GEMM_NC);
+			uPanelCnt = (uNC + uNR - 1) / uNR;
+
+			// Pack B[uKK:uKK+uKC, uJJ:uJJ+uNC] into panels of width NR, padded with zeros
+			CType* pPack = vecPack.data();
+			for (uPanel = 0; uPanel < uPanelCnt; ++uPanel)
+			{
+				uW = (uNC - uPanel * uNR < uNR ? uNC - uPanel * uNR : uNR);
+				CType* pPanel = &pPack[size_t(uPanel) * uKC * uNR];
+
+				for (k = 0; k < uKC; ++k)
+				{
+					const CType* pBk = &pB[size_t(uKK + k) * nLDB + uJJ + uPanel * uNR];
+					CType* pDst      = &pPanel[k * uNR];
+
+					for (c = 0; c < uW; ++c)
+					{
+						pDst[c] = pBk[c];
+					}
+
+					for (; c < uNR; ++c)
+					{
+						pDst[c] = CType(0);
+					}
+				}
+			}
+
+			// Multiply all row tiles of A with the packed panels
+			size_t nTileCnt = (size_t(uM) + uMR - 1) / uMR;
+
+			MatrixParallelFor(bParallel, 0, nTileCnt, 4,
+				[&](size_t nFirst, size_t nLast)
+			{
+				for (size_t nTile = nFirst; nTile < nLast; ++nTile)
+				{
+					uint uR  = uint(nTile) * uMR;
+					uint uMH = (uM - uR < uMR ? uM - uR : uMR);
+					const CType* pAr = &pA[size_t(uR) * nLDA + uKK];
+
+					for (uint uP = 0; uP < uPanelCnt; ++uP)
+					{
+						uint uCol = uP * uNR;
+						uint uNW  = (uNC - uCol < uNR ? uNC - uCol : uNR);
+						const CType* pPanel = &pPack[size_t(uP) * uKC * uNR];
+						CType* pCt = &pC[size_t(uR) * nLDC + uJJ + uCol];
+
+						if (uMH == uMR && uNW == uNR)
+						{
+							TTile::Full(uKC, pAr, nLDA, pPanel, pCt, nLDC, bSub);
+						}
+						else
+						{
+							MatrixGemmTileEdge(uMH, uNW, uKC, pAr, nLDA, pPanel, uNR, pCt, nLDC, bSub);
+						}
+					}
+				}
+			});
+		}
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// Householder column update
+//
+// Evaluates for all columns j in [uColBegin, uColEnd) of the row major matrix pM
+// with row stride nLDM
+//   s_j = sum_k pSum[k * nSumStep] * pM[k * nLDM + j], for k in [uSumBegin, uSumEnd)
+//   f_j = (s_j / dDiv) * dMul
+//   pM[k * nLDM + j] += f_j * pUpd[k * nUpdStep], for k in [uUpdBegin, uUpdEnd)
+//
+// The column vectors pSum and pUpd must not lie in the columns that are updated.
+// The original loops evaluate one column after the other, which accesses pM with
+// a stride of one row. Here the sums of all columns are accumulated row by row.
+// Since the order of the additions of each sum is the same, the result is identical.
+
+template<class CType>
+void MatrixHouseholderCols(CType* pM, size_t nLDM, uint uColBegin, uint uColEnd,
+	const CType* pSum, size_t nSumStep, uint uSumBegin, uint uSumEnd,
+	const CType* pUpd, size_t nUpdStep, uint uUpdBegin, uint uUpdEnd,
+	CType dDiv, CType dMul)
+{
+	uint j, k;
+
+	if (uColEnd <= uColBegin)
+	{
+		return;
+	}
+
+	if (GetMatrixKernel() == MATKERNEL_REFERENCE)
+	{
+		CType s, f;
+
+		for (j = uColBegin; j < uColEnd; ++j)
+		{
+			s = CType(0);
+			for (k = uSumBegin; k < uSumEnd; ++k)
+			{
+				s += pSum[k * nSumStep] * pM[k * nLDM + j];
+			}
+
+			f = (s / dDiv) * dMul;
+			for (k = uUpdBegin; k < uUpdEnd; ++k)
+			{
+				pM[k * nLDM + j] += f * pUpd[k * nUpdStep];
+			}
+		}
+
+		return;
+	}
+
+	double dOps = double(uColEnd - uColBegin) * double((uSumEnd - uSumBegin) + (uUpdEnd - uUpdBegin));
+	bool bParallel = UseMatrixKernelParallel(dOps, double(MATKERNEL_HH_PAR_MIN_OPS));
+
+	MatrixParallelFor(bParallel, uColBegin, uColEnd, 64,
+		[&](size_t nFirst, size_t nLast)
+	{
+		uint uFirst = uint(nFirst);
+		uint uCnt   = uint(nLast - nFirst);
+		uint c, k;
+		std::vector<CType> vecS(uCnt, CType(0));
+		CType* pS = vecS.data();
+
+		for (k = uSumBegin; k < uSumEnd; ++k)
+		{
+			CType dA = pSum[k * nSumStep];
+			const CType* pRow = &pM[k * nLDM + uFirst];
+
+			for (c = 0; c < uCnt; ++c)
+			{
+				pS[c] += dA * pRow[c];
+			}
+		}
+
+		for (c = 0; c < uCnt; ++c)
+		{
+			pS[c] = (pS[c] / dDiv) * dMul;
+		}
+
+		for (k = uUpdBegin; k < uUpdEnd; ++k)
+		{
+			CType dA    = pUpd[k * nUpdStep];
+			CType* pRow = &pM[k * nLDM + uFirst];
+
+			for (c = 0; c < uCnt; ++c)
+			{
+				pRow[c] += pS[c] * dA;
+			}
+		}
+	});
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// Householder row update
+//
+// Evaluates for all rows j in [uRowBegin, uRowEnd) of the row major matrix pM
+// with row stride nLDM
+//   s_j = sum_k pM[j * nLDM + k] * pV[k], for k in [uColBegin, uColEnd)
+//   pM[j * nLDM + k] += s_j * pW[k], for k in [uColBegin, uColEnd)
+// The row vector pV must not lie in the rows that are updated.
+
+template<class CType>
+void MatrixHouseholderRows(CType* pM, size_t nLDM, uint uRowBegin, uint uRowEnd,
+	const CType* pV, const CType* pW, uint uColBegin, uint uColEnd)
+{
+	if (uRowEnd <= uRowBegin || uColEnd <= uColBegin)
+	{
+		return;
+	}
+
+	double dOps = double(uRowEnd - uRowBegin) * double(2 * (uColEnd - uColBegin));
+	bool bParallel = GetMatrixKernel() != MATKERNEL_REFERENCE
+		&& UseMatrixKernelParallel(dOps, double(MATKERNEL_HH_PAR_MIN_OPS));
+
+	MatrixParallelFor(bParallel, uRowBegin, uRowEnd, 16,
+		[&](size_t nFirst, size_t nLast)
+	{
+		uint j, k;
+		CType s;
+
+		for (j = uint(nFirst); j < uint(nLast); ++j)
+		{
+			CType* pRow = &pM[j * nLDM];
+
+			s = CType(0);
+			for (k = uColBegin; k < uColEnd; ++k)
+			{
+				s += pRow[k] * pV[k];
+			}
+
+			for (k = uColBegin; k < uColEnd; ++k)
+			{
+				pRow[k] += s * pW[k];
+			}
+		}
+	});
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// Column rotations
+//
+// A rotation evaluates for all rows r of a row major matrix M
+//   y = M[r, uCol1], z = M[r, uCol2]
+//   M[r, uCol1] = (y * dC) + (z * dS)
+//   M[r, uCol2] = -(y * dS) + (z * dC)
+
+template<class CType>
+struct SMatrixRotation
+{
+	SMatrixRotation(uint _uCol1, uint _uCol2, CType _dC, CType _dS)
+	{
+		uCol1 = _uCol1;
+		uCol2 = _uCol2;
+		dC    = _dC;
+		dS    = _dS;
+	}
+
+	uint uCol1, uCol2;
+	CType dC, dS;
+};
+
+// Apply a sequence of column rotations to the matrix M with uRows rows, which is given
+// transposed as pMT with row stride nLDMT. That is, the columns of M are the contiguous
+// rows of pMT. Since the rows of M are independent, the whole sequence is applied to a
+// block of rows of M after the other. This gives the same result as applying one rotation
+// after the other to all rows, but touches each element only once and the elements of
+// a block are contiguous.
+
+template<class CType>
+void MatrixApplyColRotationsT(CType* pMT, size_t nLDMT, uint uRows, const std::vector< SMatrixRotation<CType> >& vecRot)
+{
+	const size_t nBlock = 32;
+
+	if (vecRot.empty() || uRows == 0)
+	{
+		return;
+	}
+
+	double dOps = double(uRows) * double(6 * vecRot.size());
+	bool bParallel = UseMatrixKernelParallel(dOps, double(MATKERNEL_HH_PAR_MIN_OPS));
+	const SMatrixRotation<CType>* pRot = vecRot.data();
+	size_t nRotCnt = vecRot.size();
+
+	MatrixParallelFor(bParallel, 0, (size_t(uRows) + nBlock - 1) / nBlock, 1,
+		[&](size_t nFirst, size_t nLast)
+	{
+		CType y, z;
+		size_t nRow, nCnt, nRot, nIdx;
+
+		for (size_t nBlk = nFirst; nBlk < nLast; ++nBlk)
+		{
+			nRow = nBlk * nBlock;
+			nCnt = (nRow + nBlock < size_t(uRows) ? nBlock : size_t(uRows) - nRow);
+
+			for (nRot = 0; nRot < nRotCnt; ++nRot)
+			{
+				CType* pCol1   = &pMT[pRot[nRot].uCol1 * nLDMT + nRow];
+				CType* pCol2   = &pMT[pRot[nRot].uCol2 * nLDMT + nRow];
+				const CType dC = pRot[nRot].dC;
+				const CType dS = pRot[nRot].dS;
+
+				for (nIdx = 0; nIdx < nCnt; ++nIdx)
+				{
+					y = pCol1[nIdx];
+					z = pCol2[nIdx];
+					pCol1[nIdx] = (y * dC) + (z * dS);
+					pCol2[nIdx] = -(y * dS) + (z * dC);
+				}
+			}
+		}
+	});
+}
+
+// Transpose the uRows x uCols matrix pM with row stride nLDM into pMT with row stride nLDMT
+
+template<class CType>
+void MatrixTranspose(const CType* pM, size_t nLDM, uint uRows, uint uCols, CType* pMT, size_t nLDMT)
+{
+	const uint uBlock = 32;
+	uint uR, uC, r, c, uRE, uCE;
+
+	for (uR = 0; uR < uRows; uR += uBlock)
+	{
+		uRE = (uRows - uR < uBlock ? uRows : uR + uBlock);
+		for (uC = 0; uC < uCols; uC += uBlock)
+		{
+			uCE = (uCols - uC < uBlock ? uCols : uC + uBlock);
+			for (r = uR; r < uRE; ++r)
+			{
+				for (c = uC; c < uCE; ++c)
+				{
+					pMT[c * nLDMT + r] = pM[r * nLDM + c];
+				}
+			}
+		}
+	}
+}
+
+#endif
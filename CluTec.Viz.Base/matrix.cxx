@@ -45,6 +45,7 @@ to be defined.
 //#include "eispack.h"
 #include "matrix.h"
 #include "matinst.h"
+#include "matkernel.h"
 
 #include "malloc.h"
 
@@ -871,19 +872,26 @@ to be defined.
 		if ((nRow1 == nRow2) || !nRow1 || !nRow2
 		    || (nRow1 > m_nRows) || (nRow2 > m_nRows)) { return; }
 
-		uint size   = m_nCols * sizeof(CType);
-		char* srow  = new char[size];
 		CType* data = m_mData.Data();
-		//CType dum;
+		CType* prow1;
+		CType* prow2;
+		CType dum;
 
 		nRow1--;
 		nRow2--;
 
-		memcpy(srow, &data[nRow1 * m_nCols], size);
-		memmove(&data[nRow1 * m_nCols], &data[nRow2 * m_nCols], size);
-		memcpy(&data[nRow2 * m_nCols], srow, size);
+		prow1 = &data[nRow1 * m_nCols];
+		prow2 = &data[nRow2 * m_nCols];
 
-		m_iRowPar *= 1 - 2 * (Mag(int(nRow1) - int(nRow2)) % 2);
+		for (uint i = 0; i < m_nCols; i++)
+		{
+			dum      = prow1[i];
+			prow1[i] = prow2[i];
+			prow2[i] = dum;
+		}
+
+		// Every transposition of two rows changes the sign of the permutation
+		m_iRowPar = -m_iRowPar;
 	}
 
 // /////////////////////////////////////////////////////////////////////////////////////////////////
@@ -1057,6 +1065,20 @@ to be defined.
 	{
 		if (m_nRows != m_nCols) { return false; }
 
+		if (GetMatrixKernel() == MATKERNEL_REFERENCE || m_nRows < MATKERNEL_LU_MIN_DIM)
+		{
+			return LUDecompCrout();
+		}
+
+		return LUDecompBlocked();
+	}
+
+// LU Decomposition with Crout's method
+	template<class CType>
+	bool Matrix<CType>::LUDecompCrout()
+	{
+		if (m_nRows != m_nCols) { return false; }
+
 		CType* data    = m_mData.Data();
 		CType* impscal = new CType[m_nRows];	// Keeps track of implicit scaling of rows
 		CType big;	// Biggest element in row
@@ -1158,6 +1180,122 @@ to be defined.
 		return true;
 	}
 
+// Blocked LU Decomposition
+// Uses the same implicit row scaling and pivot selection as LUDecompCrout(), but
+// factorizes panels of MATKERNEL_LU_NB columns. The update of the trailing sub-matrix
+// with the panel is a matrix product, which uses the blocked product kernel.
+	template<class CType>
+	bool Matrix<CType>::LUDecompBlocked()
+	{
+		if (m_nRows != m_nCols) { return false; }
+
+		uint n         = m_nRows;
+		CType* data    = m_mData.Data();
+		CType* impscal = new CType[n];	// Keeps track of implicit scaling of rows
+		CType big;	// Biggest element in row
+		CType dum;	// Dummy Variable
+		uint bestrow = 0;	// Row with largest figure of merit
+
+		uint r, c, i, j, rp, cp, k0, kn, nb;
+		m_iRowPar = 1;
+		m_iColPar = 1;
+
+		for (r = 0; r < n; r++)
+		{
+			big = CType(0);
+			rp  = r * n;
+
+			for (c = 0; c < n; c++)
+			{
+				dum = (CType) Mag(data[rp + c]);
+				if (dum > big) { big = dum; }
+			}
+
+			if (big == CType(0))
+			{
+				delete[] impscal;
+				return false;
+			}
+
+			impscal[r] = CType(1) / big;
+		}
+
+		for (k0 = 0; k0 < n; k0 += nb)
+		{
+			nb = (n - k0 < MATKERNEL_LU_NB ? n - k0 : MATKERNEL_LU_NB);
+			kn = k0 + nb;
+
+			// Factorize the panel of columns [k0, kn)
+			for (c = k0; c < kn; c++)
+			{
+				big = CType(0);
+				for (r = c; r < n; r++)
+				{
+					dum = impscal[r] * Mag(data[r * n + c]);
+					if (dum >= big)
+					{
+						big     = dum;
+						bestrow = r;
+					}
+				}
+
+				if (c != bestrow)
+				{
+					SwapRows(c + 1, bestrow + 1);
+					dum              = impscal[bestrow];
+					impscal[bestrow] = impscal[c];
+					impscal[c]       = dum;
+				}
+
+				cp = c * n;
+				if (data[cp + c] == CType(0))
+				{
+					delete[] impscal;
+					return false;
+				}
+
+				dum = CType(1) / data[cp + c];
+				for (r = c + 1; r < n; r++)
+				{
+					rp = r * n;
+					data[rp + c] *= dum;
+
+					CType l = data[rp + c];
+					for (j = c + 1; j < kn; j++)
+					{
+						data[rp + j] -= l * data[cp + j];
+					}
+				}
+			}
+
+			if (kn >= n)
+			{
+				break;
+			}
+
+			// Rows [k0, kn) of U right of the panel: solve with the unit lower triangle of the panel
+			for (i = k0 + 1; i < kn; i++)
+			{
+				rp = i * n;
+				for (r = k0; r < i; r++)
+				{
+					CType l = data[rp + r];
+					cp = r * n;
+					for (j = kn; j < n; j++)
+					{
+						data[rp + j] -= l * data[cp + j];
+					}
+				}
+			}
+
+			// Update the trailing sub-matrix: A22 -= L21 * U12
+			MatrixGemm(n - kn, n - kn, nb, &data[kn * n + k0], n, &data[k0 * n + kn], n, &data[kn * n + kn], n, true);
+		}
+
+		delete[] impscal;
+		return true;
+	}
+
 // Backsubstitution of LU decomposed MAtrix
 //template<class CType>
 //Matrix<CType> Matrix<CType>::LUBackSub()
@@ -1344,6 +1482,13 @@ to be defined.
 		CType* bdata = b.m_mData.Data();
 		CType* cdata = c.m_mData.Data();
 
+		if (GetMatrixKernel() != MATKERNEL_REFERENCE
+		    && double(a.m_nRows) * double(a.m_nCols) * double(b.m_nCols) >= double(MATKERNEL_GEMM_MIN_OPS))
+		{
+			MatrixGemm(a.m_nRows, b.m_nCols, a.m_nCols, adata, a.m_nCols, bdata, b.m_nCols, cdata, c.m_nCols);
+			return c;
+		}
+
 		CType dA, dB;
 		uint ra, ca, cb;
 		uint rpa, rpc, cpos, apos, bpos;
@@ -2069,22 +2214,10 @@ to be defined.
 					h               = f * g - s;
 					udata[urpi + i] = f - g;
 
-					for (j = l; j < m_nCols; j++)
-					{
-						s = CType(0);
-						for (k = i; k < m_nRows; k++)
-						{
-							urp = k * m_nCols;
-							s  += udata[urp + i] * udata[urp + j];
-						}
-
-						f = s / h;
-						for (k = i; k < m_nRows; k++)
-						{
-							urp             = k * m_nCols;
-							udata[urp + j] += f * udata[urp + i];
-						}
-					}	// for(j=l;j<cols;j++)
+					// for(j=l;j<cols;j++) u[k,j] += (sum_k u[k,i] * u[k,j] / h) * u[k,i]
+					MatrixHouseholderCols(udata, m_nCols, l, m_nCols,
+						&udata[i], m_nCols, i, m_nRows,
+						&udata[i], m_nCols, i, m_nRows, h, CType(1));
 
 					for (k = i; k < m_nRows; k++)
 					{
@@ -2124,21 +2257,8 @@ to be defined.
 						rv1[k] = udata[urpi + k] / h;
 					}
 
-					for (j = l; j < m_nRows; j++)
-					{
-						urpj = j * m_nCols;
-
-						s = CType(0);
-						for (k = l; k < m_nCols; k++)
-						{
-							s += udata[urpj + k] * udata[urpi + k];
-						}
-
-						for (k = l; k < m_nCols; k++)
-						{
-							udata[urpj + k] += s * rv1[k];
-						}
-					}	// for(j=l;j<rows;j++)
+					// for(j=l;j<rows;j++) u[j,k] += (sum_k u[j,k] * u[i,k]) * rv1[k]
+					MatrixHouseholderRows(udata, m_nCols, l, m_nRows, &udata[urpi], rv1, l, m_nCols);
 
 					for (k = l; k < m_nCols; k++)
 					{
@@ -2165,20 +2285,10 @@ to be defined.
 						vdata[j * m_nCols + i] = (udata[urpi + j] / udata[urpi + l]) / g;
 					}
 
-					for (j = l; j < m_nCols; j++)
-					{
-						s = CType(0);
-						for (k = l; k < m_nCols; k++)
-						{
-							s += udata[urpi + k] * vdata[k * m_nCols + j];
-						}
-
-						for (k = l; k < m_nCols; k++)
-						{
-							vrp             = k * m_nCols;
-							vdata[vrp + j] += s * vdata[vrp + i];
-						}
-					}	// for(j=l;j<cols;j++)
+					// for(j=l;j<cols;j++) v[k,j] += (sum_k u[i,k] * v[k,j]) * v[k,i]
+					MatrixHouseholderCols(vdata, m_nCols, l, m_nCols,
+						&udata[urpi], 1, l, m_nCols,
+						&vdata[i], m_nCols, l, m_nCols, CType(1), CType(1));
 				}	// if (g != CType(0))
 
 				for (j = l; j < m_nCols; j++)
@@ -2218,23 +2328,10 @@ to be defined.
 			{
 				g = CType(1) / g;
 
-				for (j = l; j < m_nCols; j++)
-				{
-					s = CType(0);
-					for (k = l; k < m_nRows; k++)
-					{
-						urp = k * m_nCols;
-						s  += udata[urp + i] * udata[urp + j];
-					}
-
-					f = (s / udata[urpi + i]) * g;
-
-					for (k = i; k < m_nRows; k++)
-					{
-						urp             = k * m_nCols;
-						udata[urp + j] += f * udata[urp + i];
-					}
-				}	// for(j=l;j<cols;j++)
+				// for(j=l;j<cols;j++) u[k,j] += ((sum_k u[k,i] * u[k,j]) / u[i,i]) * g * u[k,i]
+				MatrixHouseholderCols(udata, m_nCols, l, m_nCols,
+					&udata[i], m_nCols, l, m_nRows,
+					&udata[i], m_nCols, i, m_nRows, udata[urpi + i], g);
 
 				for (j = i; j < m_nRows; j++)
 				{
@@ -2252,8 +2349,23 @@ to be defined.
 		}	// for(i=rcmin-1,l=rcmin;l>0;i--,l--)
 
 		// Diagonalization of the bidiagonal form
+		// The rotations of a sweep act on pairs of columns of u and v. Unless the reference
+		// kernels are selected, u and v are transposed and the rotations of a sweep are
+		// collected and then applied block by block. Each element sees the same sequence
+		// of rotations, but the memory is accessed contiguously.
 
 		int status = 0;
+		bool bDefer = (GetMatrixKernel() != MATKERNEL_REFERENCE);
+		std::vector< SMatrixRotation<CType> > vecRotU, vecRotV;
+		std::vector<CType> vecUT, vecVT;
+
+		if (bDefer)
+		{
+			vecUT.resize(size_t(m_nRows) * m_nCols);
+			vecVT.resize(size_t(m_nCols) * m_nCols);
+			MatrixTranspose(udata, m_nCols, m_nRows, m_nCols, vecUT.data(), m_nRows);
+			MatrixTranspose(vdata, m_nCols, m_nCols, m_nCols, vecVT.data(), m_nCols);
+		}
 
 		for (k = m_nCols - 1, hi = m_nCols; hi > 0; k--, hi--)	// Loop over singular values
 		{
@@ -2299,6 +2411,12 @@ to be defined.
 						c        = g * h;
 						s        = -(f * h);
 
+						if (bDefer)
+						{
+							vecRotU.push_back(SMatrixRotation<CType>(cr, i, c, s));
+							continue;
+						}
+
 						for (j = 0; j < m_nRows; j++)
 						{
 							urpj = j * m_nCols;
@@ -2309,6 +2427,12 @@ to be defined.
 							udata[urpj + i]  = -(y * s) + (z * c);
 						}	// for(j=0;j<rows;j++)
 					}	// for(i=l;i<=k;i++)
+
+					if (bDefer)
+					{
+						MatrixApplyColRotationsT(vecUT.data(), m_nRows, m_nRows, vecRotU);
+						vecRotU.clear();
+					}
 				}	// if (!status)
 
 				z = wdata[k];
@@ -2317,10 +2441,20 @@ to be defined.
 					if (z < CType(0))
 					{
 						wdata[k] = -z;
-						for (j = 0; j < m_nCols; j++)
+						if (bDefer)
 						{
-							vrp        = j * m_nCols + k;
-							vdata[vrp] = -vdata[vrp];
+							for (j = 0, vrp = k * m_nCols; j < m_nCols; j++, vrp++)
+							{
+								vecVT[vrp] = -vecVT[vrp];
+							}
+						}
+						else
+						{
+							for (j = 0; j < m_nCols; j++)
+							{
+								vrp        = j * m_nCols + k;
+								vdata[vrp] = -vdata[vrp];
+							}
 						}
 					}	// if (z < CType(0))
 					retval = 1;
@@ -2362,13 +2496,20 @@ to be defined.
 					h  = y * s;
 					y *= c;
 
-					for (jj = 0; jj < m_nCols; jj++)
+					if (bDefer)
 					{
-						vrp            = jj * m_nCols;
-						x              = vdata[vrp + j];
-						z              = vdata[vrp + i];
-						vdata[vrp + j] = (x * c) + (z * s);
-						vdata[vrp + i] = -(x * s) + (z * c);
+						vecRotV.push_back(SMatrixRotation<CType>(j, i, c, s));
+					}
+					else
+					{
+						for (jj = 0; jj < m_nCols; jj++)
+						{
+							vrp            = jj * m_nCols;
+							x              = vdata[vrp + j];
+							z              = vdata[vrp + i];
+							vdata[vrp + j] = (x * c) + (z * s);
+							vdata[vrp + i] = -(x * s) + (z * c);
+						}
 					}
 
 					z        = pythag(f, h);
@@ -2384,22 +2525,43 @@ to be defined.
 					f = (c * g) + (s * y);
 					x = -(s * g) + (c * y);
 
-					for (jj = 0; jj < m_nRows; jj++)
+					if (bDefer)
 					{
-						urp            = jj * m_nCols;
-						y              = udata[urp + j];
-						z              = udata[urp + i];
-						udata[urp + j] = (y * c) + (z * s);
-						udata[urp + i] = -(y * s) + (z * c);
+						vecRotU.push_back(SMatrixRotation<CType>(j, i, c, s));
+					}
+					else
+					{
+						for (jj = 0; jj < m_nRows; jj++)
+						{
+							urp            = jj * m_nCols;
+							y              = udata[urp + j];
+							z              = udata[urp + i];
+							udata[urp + j] = (y * c) + (z * s);
+							udata[urp + i] = -(y * s) + (z * c);
+						}
 					}
 				}	// for(j=l,i=l+1;j<cr;j++,i++)
 
+				if (bDefer)
+				{
+					MatrixApplyColRotationsT(vecVT.data(), m_nCols, m_nCols, vecRotV);
+					MatrixApplyColRotationsT(vecUT.data(), m_nRows, m_nRows, vecRotU);
+					vecRotV.clear();
+					vecRotU.clear();
+				}
+
 				rv1[l]   = CType(0);
 				rv1[k]   = f;
 				wdata[k] = x;
 			}	// for(its=0;its<_MAXSVDITS_;its++)
 		}	// for(k=cols-1;k>=0;k--)     // Loop over singular values
 
+		if (bDefer)
+		{
+			MatrixTranspose(vecUT.data(), m_nRows, m_nCols, m_nRows, udata, m_nCols);
+			MatrixTranspose(vecVT.data(), m_nCols, m_nCols, m_nCols, vdata, m_nCols);
+		}
+
 		delete[] rv1;
 
 		return retval;
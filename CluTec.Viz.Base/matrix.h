@@ -192,6 +192,10 @@ public:
 	Matrix<CType> Left();
 	Matrix<CType> Upper();
 	bool LUDecomp();
+	// LU decomposition with Crout's method, used for small matrices
+	bool LUDecompCrout();
+	// LU decomposition in column panels, used for large matrices
+	bool LUDecompBlocked();
 
 
 	CType Tiny() { return tiny; }
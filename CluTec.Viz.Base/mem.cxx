@@ -43,6 +43,17 @@ Mem<CType>::Mem(size_t nno) : MemBase(sizeof(CType), nno)
 }
 
 
+//////////////////////////////////////////////////////////////////////////////////
+// Constructor with fixed memory block
+
+template<class CType>
+Mem<CType>::Mem(size_t nno, CType* pFixedData, size_t uFixedCapElNo) 
+	: MemBase(sizeof(CType), (void*) pFixedData, uFixedCapElNo, nno)
+{
+
+}
+
+
 ////////////////////////////////////////////////////////////////////////////
 // Copy Constructor
 
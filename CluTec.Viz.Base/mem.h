@@ -55,6 +55,44 @@ public:
 	inline bool PushBack(const Mem<CType> &mData);
 
 	inline CType* Data() const;
+
+protected:
+	Mem(size_t nno, CType* pFixedData, size_t uFixedCapElNo);
+};
+
+
+// MemInline Class ---------------------------------------
+//
+// Same as Mem but stores up to t_uInlineElNo elements in a memory block
+// that is part of the instance. Heap memory is only allocated if more
+// elements are needed. Instances can therefore not be moved with memcpy.
+
+template<class CType, size_t t_uInlineElNo>
+class MemInline : public Mem<CType>
+{
+public:
+	MemInline(size_t nno = 0) : Mem<CType>(nno, m_pInlineData, t_uInlineElNo) 
+	{ }
+
+	MemInline(const Mem<CType> &a) : Mem<CType>(0, m_pInlineData, t_uInlineElNo)
+	{ Mem<CType>::operator=(a); }
+
+	MemInline(const MemInline<CType, t_uInlineElNo> &a) : Mem<CType>(0, m_pInlineData, t_uInlineElNo)
+	{ Mem<CType>::operator=(a); }
+
+	virtual ~MemInline()
+	{ }
+
+	bool operator=(size_t ano) { return this->Set(ano); }
+
+	MemInline<CType, t_uInlineElNo>& operator=(const Mem<CType> &a)
+	{ Mem<CType>::operator=(a); return *this; }
+
+	MemInline<CType, t_uInlineElNo>& operator=(const MemInline<CType, t_uInlineElNo> &a)
+	{ Mem<CType>::operator=(a); return *this; }
+
+protected:
+	CType m_pInlineData[t_uInlineElNo];
 };
 
 
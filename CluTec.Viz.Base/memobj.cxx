@@ -29,9 +29,17 @@
 #include<stdlib.h>
 #include<memory.h>
 #include<string.h>
+#include<new>
+#include<utility>
 
 #include"memobj.h"
 
+template<class CType>
+std::atomic<size_t> MemObj<CType>::sm_uHeapElAllocCnt(0);
+
+template<class CType>
+std::atomic<size_t> MemObj<CType>::sm_uChunkAllocCnt(0);
+
 
 //////////////////////////////////////////////////////////////////////////////////
 // Constructor
@@ -42,6 +50,12 @@ MemObj<CType>::MemObj(size_t nno)
 	m_uInitElNo = 0;
 	m_bDirectAlloc = true;
 	m_mData.EnableDirectAlloc(false);
+
+	m_uChunkElNo = 0;
+	m_uChunkCapElNo = 0;
+	m_uChunkLiveElNo = 0;
+	m_pCurChunk = 0;
+
 	Set(nno);
 }
 
@@ -56,10 +70,34 @@ MemObj<CType>::MemObj(const MemObj<CType> &_rMemObj)
 	m_bDirectAlloc = true;
 	m_mData.EnableDirectAlloc(false);
 
+	m_uChunkElNo = 0;
+	m_uChunkCapElNo = 0;
+	m_uChunkLiveElNo = 0;
+	m_pCurChunk = 0;
+
 	*this = _rMemObj;
 }
 
 
+////////////////////////////////////////////////////////////////////////////
+// Move Constructor
+
+template<class CType>
+MemObj<CType>::MemObj(MemObj<CType>&& _rMemObj)
+{
+	m_uInitElNo = 0;
+	m_bDirectAlloc = true;
+	m_mData.EnableDirectAlloc(false);
+
+	m_uChunkElNo = 0;
+	m_uChunkCapElNo = 0;
+	m_uChunkLiveElNo = 0;
+	m_pCurChunk = 0;
+
+	SwapData(_rMemObj);
+}
+
+
 ////////////////////////////////////////////////////////////////////////////
 // Destructor
 
@@ -68,6 +106,9 @@ MemObj<CType>::~MemObj()
 {
 	Set(0);	// deletes all objects in m_mData
 	Prune();
+
+	// Frees chunks that still contain forgotten elements
+	ReleaseChunks();
 }
 
 
@@ -79,6 +120,11 @@ MemObj<CType>& MemObj<CType>::operator=(const MemObj<CType> &_rMemObj)
 {
 	size_t no = _rMemObj.Count();
 
+	if ( this == &_rMemObj )
+		return *this;
+
+	m_uChunkElNo = _rMemObj.m_uChunkElNo;
+
 	if ( !(m_bDirectAlloc = _rMemObj.m_bDirectAlloc) )
 	{
 		Reserve(_rMemObj.m_mData.Capacity());
@@ -96,6 +142,45 @@ MemObj<CType>& MemObj<CType>::operator=(const MemObj<CType> &_rMemObj)
 }
 
 
+////////////////////////////////////////////////////////////////////////////
+// Move Memory Data
+
+template<class CType>
+MemObj<CType>& MemObj<CType>::operator=(MemObj<CType>&& _rMemObj)
+{
+	if ( this != &_rMemObj )
+	{
+		// The previous elements of this list are destroyed with _rMemObj
+		SwapData(_rMemObj);
+	}
+
+	return *this;
+}
+
+
+////////////////////////////////////////////////////////////////////////////
+// Swap all elements with given list. Since the chunks are swapped
+// together with the element pointers, all element pointers stay valid.
+
+template<class CType>
+bool MemObj<CType>::SwapData(MemObj<CType>& _rMemObj)
+{
+	if ( !m_mData.SwapData(_rMemObj.m_mData) )
+		return false;
+
+	std::swap(m_bDirectAlloc, _rMemObj.m_bDirectAlloc);
+	std::swap(m_uInitElNo, _rMemObj.m_uInitElNo);
+	std::swap(m_uChunkElNo, _rMemObj.m_uChunkElNo);
+	std::swap(m_uChunkCapElNo, _rMemObj.m_uChunkCapElNo);
+	std::swap(m_uChunkLiveElNo, _rMemObj.m_uChunkLiveElNo);
+	std::swap(m_pCurChunk, _rMemObj.m_pCurChunk);
+	m_mapChunk.swap(_rMemObj.m_mapChunk);
+	m_vecChunkFreeEl.swap(_rMemObj.m_vecChunkFreeEl);
+
+	return true;
+}
+
+
 
 ////////////////////////////////////////////////////////////////////////////
 // Move parts of Memory
@@ -223,9 +308,7 @@ bool MemObj<CType>::Replace(size_t uPos, CType* pData)
 	if ( uPos >= m_mData.Count() )
 		return false;
 
-	PCType pEl = ((PCType*) m_mData.Data())[uPos];
-	if ( pEl )
-		delete pEl;
+	DeleteElement(((PCType*) m_mData.Data())[uPos]);
 
 	m_mData[uPos] = pData;
 	return true;
@@ -239,18 +322,26 @@ bool MemObj<CType>::InitElements(size_t uElCnt)
 
 	if ( m_uInitElNo < uElCnt )
 	{
+		// Place all new elements contiguously in one chunk
+		if ( m_uChunkElNo > 0 )
+		{
+			size_t uNewCnt  = uElCnt - m_uInitElNo;
+			size_t uFreeCnt = m_vecChunkFreeEl.size();
+
+			if ( uNewCnt > uFreeCnt && !ReserveChunkElements(uNewCnt - uFreeCnt) )
+				return false;
+		}
+
 		for ( uIdx = m_uInitElNo; uIdx < uElCnt; ++uIdx )
 		{
-			((PCType*) m_mData.Data())[uIdx] = new CType;
+			((PCType*) m_mData.Data())[uIdx] = NewElement();
 		}
 	}
 	else if ( m_uInitElNo > uElCnt )
 	{
 		for ( uIdx = m_uInitElNo; uIdx > uElCnt; --uIdx )
 		{
-			PCType pEl = ((PCType*) m_mData.Data())[uIdx-1];
-			if ( pEl )
-				delete pEl;
+			DeleteElement(((PCType*) m_mData.Data())[uIdx-1]);
 		}
 	}
 
@@ -298,6 +389,12 @@ bool MemObj<CType>::Reserve(size_t uCapElNo)
 	if ( !m_mData.Reserve(uCapElNo) )
 		return false;
 
+	if ( m_uChunkElNo > 0 && uCapElNo > m_uInitElNo + m_vecChunkFreeEl.size() )
+	{
+		if ( !ReserveChunkElements(uCapElNo - m_uInitElNo - m_vecChunkFreeEl.size()) )
+			return false;
+	}
+
 	// switch to indirect allocation mode
 	m_bDirectAlloc = false;
 
@@ -351,14 +448,14 @@ template<class CType>
 bool MemObj<CType>::PushBack( const CType& xValue )
 {
 	size_t uElNo = m_mData.Count();
-	CType *pValue = new CType( xValue );
+	CType *pValue = NewElement( xValue );
 
 	if ( !pValue )
 		return false;
 
 	if ( !m_mData.Set(uElNo + 1) )
 	{
-		delete pValue;
+		DeleteElement(pValue);
 		return false;
 	}
 
@@ -379,9 +476,12 @@ bool MemObj<CType>::PushBack( const MemObj<CType> &mData )
 	if ( !m_mData.Set( uCurElNo + uCnt ) )
 		return false;
 
+	if ( m_uChunkElNo > 0 && uCnt > m_vecChunkFreeEl.size() )
+		ReserveChunkElements(uCnt - m_vecChunkFreeEl.size());
+
 	for ( size_t uPos = 0; uPos < uCnt; ++uPos )
 	{
-		CType* pValue = new CType(mData[uPos]);
+		CType* pValue = NewElement(mData[uPos]);
 		if ( !pValue )
 			bResult = false;
 
@@ -441,3 +541,160 @@ bool MemObj<CType>::Swap(size_t uPos1, size_t uPos2)
 	return true;
 }
 
+
+////////////////////////////////////////////////////////////////////////////
+// Create new element
+
+template<class CType>
+typename MemObj<CType>::PCType MemObj<CType>::NewElement()
+{
+	if ( m_uChunkElNo == 0 )
+	{
+		sm_uHeapElAllocCnt.fetch_add(1, std::memory_order_relaxed);
+		return new CType;
+	}
+
+	void* pMem = AllocChunkElement();
+	if ( !pMem )
+		return 0;
+
+	return new (pMem) CType;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Create new element as copy of given value
+
+template<class CType>
+typename MemObj<CType>::PCType MemObj<CType>::NewElement(const CType& xValue)
+{
+	if ( m_uChunkElNo == 0 )
+	{
+		sm_uHeapElAllocCnt.fetch_add(1, std::memory_order_relaxed);
+		return new CType(xValue);
+	}
+
+	void* pMem = AllocChunkElement();
+	if ( !pMem )
+		return 0;
+
+	return new (pMem) CType(xValue);
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Delete element. Elements in chunks are destructed and their memory
+// is reused for new elements. All chunks are freed when the last
+// chunk element is deleted.
+
+template<class CType>
+void MemObj<CType>::DeleteElement(PCType pEl)
+{
+	if ( !pEl )
+		return;
+
+	if ( m_mapChunk.size() > 0 )
+	{
+		const char* pcEl = (const char*) pEl;
+		typename std::map<const char*, SChunk>::iterator itChunk = m_mapChunk.upper_bound(pcEl);
+
+		if ( itChunk != m_mapChunk.begin() )
+		{
+			--itChunk;
+			SChunk& rChunk = itChunk->second;
+
+			if ( pcEl < rChunk.pcData + rChunk.uCapElNo * sizeof(CType) )
+			{
+				pEl->~CType();
+				m_vecChunkFreeEl.push_back(pEl);
+
+				if ( --m_uChunkLiveElNo == 0 )
+					ReleaseChunks();
+
+				return;
+			}
+		}
+	}
+
+	delete pEl;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Get memory for one element from chunks
+
+template<class CType>
+void* MemObj<CType>::AllocChunkElement()
+{
+	void* pMem;
+
+	if ( m_vecChunkFreeEl.size() > 0 )
+	{
+		pMem = m_vecChunkFreeEl.back();
+		m_vecChunkFreeEl.pop_back();
+	}
+	else
+	{
+		if ( !ReserveChunkElements(1) )
+			return 0;
+
+		pMem = m_pCurChunk->pcData + m_pCurChunk->uUsedElNo * sizeof(CType);
+		++m_pCurChunk->uUsedElNo;
+	}
+
+	++m_uChunkLiveElNo;
+	return pMem;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Ensure that current chunk has space for given number of elements.
+// Otherwise a new chunk is allocated, whose size grows with the total
+// capacity of all chunks, up to sm_uMaxChunkSize bytes.
+
+template<class CType>
+bool MemObj<CType>::ReserveChunkElements(size_t uElNo)
+{
+	if ( m_pCurChunk && m_pCurChunk->uCapElNo - m_pCurChunk->uUsedElNo >= uElNo )
+		return true;
+
+	size_t uMaxElNo = sm_uMaxChunkSize / sizeof(CType);
+	size_t uCapElNo = (m_uChunkCapElNo < uMaxElNo ? m_uChunkCapElNo : uMaxElNo);
+
+	if ( uCapElNo < m_uChunkElNo )
+		uCapElNo = m_uChunkElNo;
+
+	if ( uCapElNo < uElNo )
+		uCapElNo = uElNo;
+
+	SChunk xChunk;
+
+	if ( !(xChunk.pcData = (char*) malloc(uCapElNo * sizeof(CType))) )
+		return false;
+
+	xChunk.uCapElNo = uCapElNo;
+	xChunk.uUsedElNo = 0;
+
+	sm_uChunkAllocCnt.fetch_add(1, std::memory_order_relaxed);
+
+	m_pCurChunk = &(m_mapChunk[xChunk.pcData] = xChunk);
+	m_uChunkCapElNo += uCapElNo;
+
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Free all chunks. Elements in chunks are not destructed.
+
+template<class CType>
+void MemObj<CType>::ReleaseChunks()
+{
+	typename std::map<const char*, SChunk>::iterator itChunk;
+
+	for ( itChunk = m_mapChunk.begin(); itChunk != m_mapChunk.end(); ++itChunk )
+	{
+		free(itChunk->second.pcData);
+	}
+
+	m_mapChunk.clear();
+	m_vecChunkFreeEl.clear();
+	m_pCurChunk = 0;
+	m_uChunkCapElNo = 0;
+	m_uChunkLiveElNo = 0;
+}
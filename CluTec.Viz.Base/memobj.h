@@ -28,10 +28,23 @@
 //
 // This class can be used for all objects. It uses new/delete and copies with operator=
 // If this is not necessary use Mem class, to increase speed.
+//
+// By default each element is allocated separately on the heap. If chunk allocation
+// is enabled with EnableChunkAlloc(), elements are constructed in place in large
+// memory chunks instead. Chunks are never reallocated, so that element pointers stay
+// valid, and consecutively created elements are stored contiguously in memory.
+// Elements passed in by pointer via PushBack(CType*) or Replace() are still owned
+// as heap objects, so both kinds of elements may be mixed in one list.
+// Note that elements which are taken out of a list with Forget() have to be heap
+// objects, since chunk elements cannot be deleted by the caller.
 
 #ifndef _MEMOBJ_HH_
 #define _MEMOBJ_HH_
 
+#include <atomic>
+#include <map>
+#include <vector>
+
 #include "mem.h"
 
 typedef unsigned int uint;
@@ -44,6 +57,7 @@ public:
 
 	MemObj(size_t nno=0);
 	MemObj(const MemObj<CType> &a);
+	MemObj(MemObj<CType>&& a);
 	virtual ~MemObj();  
 	
 	// If direct alloc is enabled, each Add, Sub, Set command
@@ -57,6 +71,21 @@ public:
 		m_mData.EnableDirectAlloc(bEnable); 
 	}
 
+	// Enable construction of elements in memory chunks of at least
+	// the given number of elements. Passing zero disables chunk allocation
+	// for elements created from now on.
+	void EnableChunkAlloc(size_t uChunkElNo = 16) { m_uChunkElNo = uChunkElNo; }
+	bool IsChunkAlloc() const { return m_uChunkElNo > 0; }
+
+	// Number of chunks currently allocated
+	size_t GetChunkCount() const { return m_mapChunk.size(); }
+
+	// Number of elements allocated separately on the heap and number of chunks
+	// allocated by all lists of this element type since the last reset.
+	static size_t GetHeapElementAllocCount() { return sm_uHeapElAllocCnt.load(std::memory_order_relaxed); }
+	static size_t GetChunkAllocCount() { return sm_uChunkAllocCnt.load(std::memory_order_relaxed); }
+	static void ResetAllocCounts() { sm_uHeapElAllocCnt = 0; sm_uChunkAllocCnt = 0; }
+
 	// reserve memory for the given number of elements
 	// calling reserve automatically disables direct alloc
 	bool Reserve(size_t uNo);
@@ -80,6 +109,10 @@ public:
 
 	bool operator=(size_t ano) { return Set(ano); }
 	MemObj<CType>& operator=(const MemObj<CType> &a);
+	MemObj<CType>& operator=(MemObj<CType>&& a);
+
+	// Swap all elements with the given list without copying them.
+	bool SwapData(MemObj<CType>& rMemObj);
 
 	CType& operator[] (size_t pos) const { return *m_mData[pos]; }
 
@@ -107,10 +140,52 @@ public:
 protected:
 	bool InitElements(size_t uElNo);
 
+	// Create and delete single elements either on heap or in chunks
+	PCType NewElement();
+	PCType NewElement(const CType& xValue);
+	void DeleteElement(PCType pEl);
+
+	// Memory for a single element in a chunk
+	void* AllocChunkElement();
+
+	// Ensure that the current chunk has space for the given number of elements
+	bool ReserveChunkElements(size_t uElNo);
+
+	// Free all chunks
+	void ReleaseChunks();
+
+protected:
+	struct SChunk
+	{
+		char* pcData;
+		size_t uCapElNo;
+		size_t uUsedElNo;
+	};
+
+	// Maximal size of a chunk in bytes, unless a larger number of
+	// elements is requested at once.
+	static const size_t sm_uMaxChunkSize = 1 << 20;
+
+	// Allocation statistics of all lists of this element type
+	static std::atomic<size_t> sm_uHeapElAllocCnt;
+	static std::atomic<size_t> sm_uChunkAllocCnt;
+
 protected:
 	bool m_bDirectAlloc;
 	size_t m_uInitElNo;
 	Mem<PCType> m_mData; // Data: Pointers to CType 	
+
+	// Minimal number of elements per chunk. Zero if chunk allocation is disabled.
+	size_t m_uChunkElNo;
+	// Total capacity and number of live elements of all chunks
+	size_t m_uChunkCapElNo;
+	size_t m_uChunkLiveElNo;
+	// Chunks sorted by their start address
+	std::map<const char*, SChunk> m_mapChunk;
+	// Chunk from which new elements are taken
+	SChunk* m_pCurChunk;
+	// Free element slots in chunks
+	std::vector<PCType> m_vecChunkFreeEl;
 };
 
 
@@ -78,6 +78,7 @@ CCLUDrawBase::CCLUDrawBase()
 	m_bOGLMouse         = false;
 	m_bDrawColorStereo  = false;
 	m_bDrawTransparency = true;
+	m_pPickBVH          = nullptr;
 
 	m_bSendControlKeyEvents  = false;	// Send control key events to script
 	m_bSendFunctionKeyEvents = false;	// Send function key events to script
@@ -220,6 +221,61 @@ CCLUDrawBase::CCLUDrawBase()
 
 CCLUDrawBase::~CCLUDrawBase()
 {
+	delete m_pPickBVH;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void CCLUDrawBase::EnablePickBVH(bool bVal)
+{
+	if (bVal && !m_pPickBVH)
+	{
+		m_pPickBVH = new COGLPickBVH();
+	}
+	else if (!bVal && m_pPickBVH)
+	{
+		delete m_pPickBVH;
+		m_pPickBVH = nullptr;
+	}
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void CCLUDrawBase::BeginPickBVHUpdate()
+{
+	if (!m_pPickBVH)
+	{
+		return;
+	}
+
+	float pfFrameMat[16];
+	m_SceneApplyData.xMatrixStack.GetMatrix(Clu::CMatrixStack::ModelView, pfFrameMat);
+
+	m_pPickBVH->BeginUpdate(pfFrameMat);
+
+	// The name stacks are stored as they are evaluated in PickDraw()
+	m_SceneApplyData.InitPickNames();
+	m_SceneApplyData.pPickBVH         = m_pPickBVH;
+	m_SceneApplyData.uPickBVHNameBase = 0;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void CCLUDrawBase::EndPickBVHUpdate()
+{
+	if (!m_pPickBVH || (m_SceneApplyData.pPickBVH != m_pPickBVH))
+	{
+		return;
+	}
+
+	m_SceneApplyData.pPickBVH = nullptr;
+	m_pPickBVH->EndUpdate();
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void CCLUDrawBase::InvalidatePickBVH()
+{
+	if (m_pPickBVH)
+	{
+		m_pPickBVH->Invalidate();
+	}
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -477,27 +533,46 @@ bool CCLUDrawBase::BeginDraw()
 		/************************************************************************/
 		/* Begin Reset Matrices                                                 */
 		/************************************************************************/
+		Clu::CMatrixStack& rStack = m_SceneApplyData.xMatrixStack;
+
+		// The matrices may have been changed outside of the matrix stack since the last frame
+		rStack.BeginFrame();
+
+		// Keep the culling statistics of the previous frame
+		m_SceneApplyData.xCullFrameStats = m_SceneApplyData.xCullStats;
+		m_SceneApplyData.xCullStats.Reset();
+		m_SceneApplyData.eCullState = COGLBaseElement::CULL_TEST;
+
 		if (m_bGLHas_MultiTexture)
 		{
 			int iTexUnitCnt;
 			glGetIntegerv(GL_MAX_TEXTURE_UNITS, (GLint*) &iTexUnitCnt);
 
-			glMatrixMode(GL_TEXTURE);
+			rStack.MatrixMode(Clu::CMatrixStack::Texture);
 			for (int iTexUnit = 0; iTexUnit < iTexUnitCnt; iTexUnit++)
 			{
 				glActiveTexture(GL_TEXTURE0 + iTexUnit);
-				glLoadIdentity();
+
+				// The matrix stack only keeps the texture units that are used for drawing
+				if (iTexUnit < OGL_MAX_TEX_UNITS)
+				{
+					rStack.LoadIdentity();
+				}
+				else
+				{
+					glLoadIdentity();
+				}
 			}
 
 			glActiveTexture(GL_TEXTURE0);
 		}
 		else
 		{
-			glMatrixMode(GL_TEXTURE);
-			glLoadIdentity();
+			rStack.MatrixMode(Clu::CMatrixStack::Texture);
+			rStack.LoadIdentity();
 		}
 
-		m_SceneApplyData.xMatrixStack.PushAll();
+		rStack.PushAll();
 
 		/************************************************************************/
 		/* End Reset Matrices                                                   */
@@ -577,20 +652,22 @@ void CCLUDrawBase::WorldTransform()
 	float afViewRotation[16];
 	m_xCameraTransform.RotationMatToArray(afViewRotation);
 
+	Clu::CMatrixStack& rStack = m_SceneApplyData.xMatrixStack;
+
 	// CAMERA Movement
 	// apply camera transformation
-	glMultMatrixf(afViewRotation);
+	rStack.MultMatrix(afViewRotation);
 
 	// and translate the camera
-	glTranslatef(vfViewTranslate.x(), vfViewTranslate.y(), vfViewTranslate.z());
+	rStack.Translate(vfViewTranslate.x(), vfViewTranslate.y(), vfViewTranslate.z());
 
-	glTranslatef(vfModelTranslate.x(), vfModelTranslate.y(), vfModelTranslate.z());
+	rStack.Translate(vfModelTranslate.x(), vfModelTranslate.y(), vfModelTranslate.z());
 
 	if (m_bUseLocalRot)		// && !(m_bIsAnimated && m_iAnimRotType))
 	{
-		glRotatef(rTrans.pfRot[2], 1, 0, 0);
-		glRotatef(rTrans.pfRot[0], 0, 1, 0);
-		glRotatef(rTrans.pfRot[1], 0, 0, 1);
+		rStack.Rotate(rTrans.pfRot[2], 1, 0, 0);
+		rStack.Rotate(rTrans.pfRot[0], 0, 1, 0);
+		rStack.Rotate(rTrans.pfRot[1], 0, 0, 1);
 	}
 	else
 	{
@@ -603,7 +680,7 @@ void CCLUDrawBase::WorldTransform()
 		rTrans.pfRot[1] = m_vAxis[2];
 		rTrans.pfRot[2] = m_vAxis[3];
 
-		glRotatef(m_fFrameAngle, m_vAxis[1], m_vAxis[2], m_vAxis[3]);
+		rStack.Rotate(m_fFrameAngle, m_vAxis[1], m_vAxis[2], m_vAxis[3]);
 	}
 }
 
@@ -674,20 +751,24 @@ void CCLUDrawBase::UpdateMatrices()
 {
 	try
 	{
-		CLU_OGL_CALL(glMatrixMode(GL_PROJECTION));
-		CLU_OGL_CALL(glLoadIdentity());
+		// This is called outside of a frame, so the matrices may have been changed outside of the matrix stack
+		Clu::CMatrixStack& rStack = m_SceneApplyData.xMatrixStack;
+		rStack.Invalidate();
+
+		rStack.MatrixMode(Clu::CMatrixStack::Projection);
+		rStack.LoadIdentity();
 
 		if (m_b2DViewEnabled)
 		{
-			CLU_OGL_CALL(glOrtho(m_xOrtho.fLeft, m_xOrtho.fRight, m_xOrtho.fBottom, m_xOrtho.fTop, m_xOrtho.fNear, m_xOrtho.fFar));
+			rStack.Ortho(m_xOrtho.fLeft, m_xOrtho.fRight, m_xOrtho.fBottom, m_xOrtho.fTop, m_xOrtho.fNear, m_xOrtho.fFar);
 		}
 		else
 		{
-			CLU_OGL_CALL(gluPerspective(m_xPers.fAngle, m_xPers.fAspect, m_xPers.fNear, m_xPers.fFar));
+			rStack.Perspective(m_xPers.fAngle, m_xPers.fAspect, m_xPers.fNear, m_xPers.fFar);
 		}
 
-		CLU_OGL_CALL(glMatrixMode(GL_MODELVIEW));
-		CLU_OGL_CALL(glLoadIdentity());
+		rStack.MatrixMode(Clu::CMatrixStack::ModelView);
+		rStack.LoadIdentity();
 	}
 	catch (Clu::CIException& ex)
 	{
@@ -1115,27 +1196,48 @@ bool CCLUDrawBase::Picking(EMousePickType ePickType, int iX, int iY, int iPickW,
 	int piViewport[4];
 	glGetIntegerv(GL_VIEWPORT, piViewport);
 
-	m_SceneApplyData.xMatrixStack.Push(Clu::CMatrixStack::Projection);
-	CLU_OGL_CALL(glLoadIdentity());
+	// Picking is done outside of a frame, so the matrices may have been changed outside of the matrix stack
+	Clu::CMatrixStack& rStack = m_SceneApplyData.xMatrixStack;
+	rStack.Invalidate();
+
+	m_SceneApplyData.eCullState = COGLBaseElement::CULL_TEST;
+
+	rStack.Push(Clu::CMatrixStack::Projection);
+	rStack.LoadIdentity();
 
 	if (m_b2DViewEnabled)
 	{
-		CLU_OGL_CALL(glOrtho(m_xOrtho.fLeft, m_xOrtho.fRight, m_xOrtho.fBottom, m_xOrtho.fTop, m_xOrtho.fNear, m_xOrtho.fFar));
+		rStack.Ortho(m_xOrtho.fLeft, m_xOrtho.fRight, m_xOrtho.fBottom, m_xOrtho.fTop, m_xOrtho.fNear, m_xOrtho.fFar);
 	}
 	else
 	{
-		CLU_OGL_CALL(gluPerspective(m_xPers.fAngle, m_xPers.fAspect, m_xPers.fNear, m_xPers.fFar));
+		rStack.Perspective(m_xPers.fAngle, m_xPers.fAspect, m_xPers.fNear, m_xPers.fFar);
 	}
 
-	m_SceneApplyData.xMatrixStack.Push(Clu::CMatrixStack::ModelView);
-	CLU_OGL_CALL(glLoadIdentity());
+	rStack.Push(Clu::CMatrixStack::ModelView);
+	rStack.LoadIdentity();
 
 	WorldTransform();
 
 	// Instead of using gluPickMatrix use additional clipping planes for this purpose need to find coordinates of corners of picking region in world coordinates.
 	double pdProj[16], pdFrame[16];
-	glGetDoublev(GL_PROJECTION_MATRIX, pdProj);
-	glGetDoublev(GL_MODELVIEW_MATRIX, pdFrame);
+	rStack.GetMatrix(Clu::CMatrixStack::Projection, pdProj);
+	rStack.GetMatrix(Clu::CMatrixStack::ModelView, pdFrame);
+
+	// If the scene keeps a bounding volume hierarchy of its geometry, the picked object can be found
+	// on the CPU without rendering the scene in pick mode and reading back the frame buffer.
+	// If the scene changed since the hierarchy was last updated, the scene is drawn in pick mode
+	// and the hierarchy is refit while doing so.
+	COGLPickBVH* pPickBVH = GetPickBVH();
+	if (pPickBVH && !pPickBVH->IsEmpty() && !pPickBVH->IsDirty())
+	{
+		m_SceneApplyData.xMatrixStack.Pop(Clu::CMatrixStack::Projection);
+		m_SceneApplyData.xMatrixStack.Pop(Clu::CMatrixStack::ModelView);
+
+		return PickingBVH(*pPickBVH, ePickType, iX, iY, iPickW, iPickH, piViewport, pdFrame, pdProj);
+	}
+
+	bool bUpdatePickBVH = (pPickBVH && (pPickBVH == m_pPickBVH));
 
 	double dXL = double(iX - iPickW);
 	double dXR = double(iX + iPickW);
@@ -1253,7 +1355,16 @@ bool CCLUDrawBase::Picking(EMousePickType ePickType, int iX, int iY, int iPickW,
 	glDrawBuffer(GL_BACK);
 
 	// Draw for picking
-	PickDraw();
+	if (bUpdatePickBVH)
+	{
+		BeginPickBVHUpdate();
+		PickDraw();
+		EndPickBVHUpdate();
+	}
+	else
+	{
+		PickDraw();
+	}
 
 	// Flush all drawing operations
 	glFlush();
@@ -1323,6 +1434,69 @@ bool CCLUDrawBase::Picking(EMousePickType ePickType, int iX, int iY, int iPickW,
 	return PickProcessHits(ePickType, uPickColor, fPickMinDepth);	//, iHitCnt, mSelBuf );
 }
 
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+bool CCLUDrawBase::PickingBVH(COGLPickBVH& rPickBVH, EMousePickType ePickType, int iX, int iY, int iPickW, int iPickH, const int* piViewport, const double* pdFrame, const double* pdProj)
+{
+	// Projection times frame matrix, column-major
+	float pfViewProj[16];
+	for (int iCol = 0; iCol < 4; ++iCol)
+	{
+		for (int iRow = 0; iRow < 4; ++iRow)
+		{
+			double dVal = 0.0;
+			for (int i = 0; i < 4; ++i)
+			{
+				dVal += pdProj[i * 4 + iRow] * pdFrame[iCol * 4 + i];
+			}
+
+			pfViewProj[iCol * 4 + iRow] = float(dVal);
+		}
+	}
+
+	// Pick position and pick region half width and height in normalized device coordinates
+	float fX    = 2.0f * float(iX - piViewport[0]) / float(piViewport[2]) - 1.0f;
+	float fY    = 2.0f * float(piViewport[3] - iY - 1 - piViewport[1]) / float(piViewport[3]) - 1.0f;
+	float fTolX = 2.0f * float(iPickW) / float(piViewport[2]);
+	float fTolY = 2.0f * float(iPickH) / float(piViewport[3]);
+
+	// Pick color zero and maximal depth denote that nothing was picked, as when nothing is drawn in pick mode.
+	uint uPickColor     = 0;
+	float fPickMinDepth = 1.0f;
+
+	m_SceneApplyData.InitPickNames();
+
+	COGLPickBVH::SRay xRay;
+	COGLPickBVH::SHit xHit;
+	if (COGLPickBVH::RayFromViewProj(pfViewProj, fX, fY, fTolX, fTolY, xRay) && rPickBVH.PickRay(xRay, xHit))
+	{
+		// Store the name stack of the hit instance, as it would have been stored when drawing it in pick mode.
+		size_t nNameCnt;
+		const unsigned* puName = rPickBVH.GetInstanceNameStack(xHit.uInst, nNameCnt);
+		for (size_t nIdx = 0; nIdx < nNameCnt; ++nIdx)
+		{
+			m_SceneApplyData.PushPickName(puName[nIdx]);
+		}
+
+		uPickColor = COGLBaseElement::SApplyData::ConvertNameToColor(m_SceneApplyData.StorePickNameStack(), xHit.uPartId);
+
+		// Depth buffer value of hit position
+		float pfClip[4];
+		for (int iRow = 0; iRow < 4; ++iRow)
+		{
+			pfClip[iRow] = pfViewProj[iRow] * xHit.pfPos[0] + pfViewProj[4 + iRow] * xHit.pfPos[1]
+				       + pfViewProj[8 + iRow] * xHit.pfPos[2] + pfViewProj[12 + iRow];
+		}
+
+		if (pfClip[3] != 0.0f)
+		{
+			fPickMinDepth = 0.5f * (pfClip[2] / pfClip[3]) + 0.5f;
+			fPickMinDepth = (fPickMinDepth < 0.0f ? 0.0f : (fPickMinDepth > 1.0f ? 1.0f : fPickMinDepth));
+		}
+	}
+
+	return PickProcessHits(ePickType, uPickColor, fPickMinDepth);
+}
+
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 void CCLUDrawBase::ActiveMouseMove(int iX, int iY)
 {
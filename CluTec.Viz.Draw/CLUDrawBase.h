@@ -43,6 +43,7 @@
 #include "OGLMaterial.h"
 #include "OGLBitmap.h"
 #include "IOGLWinBase.h"
+#include "OGLPickBVH.h"
 
 #include "CameraTransform.h"
 
@@ -422,6 +423,14 @@
 		void EnableColorStereo(bool bVal = true) { m_bDrawColorStereo = bVal; }
 		void EnableTransparency(bool bVal = true) { m_bDrawTransparency = bVal; }
 
+		// Keep a bounding volume hierarchy of the main scene that is used for picking instead of drawing in pick mode.
+		void EnablePickBVH(bool bVal = true);
+		bool IsPickBVHEnabled() const { return m_pPickBVH != nullptr; }
+
+		// Skip scene elements whose bounds lie outside of the view frustum.
+		void EnableFrustumCulling(bool bVal = true) { m_SceneApplyData.bCullEnable = bVal; }
+		bool IsFrustumCullingEnabled() const { return m_SceneApplyData.bCullEnable; }
+
 		void EnableSendControlKeyEvents(bool bVal = true) { m_bSendControlKeyEvents = bVal; };
 		void EnableSendFunctionKeyEvents(bool bVal = true) { m_bSendFunctionKeyEvents = bVal; };
 
@@ -497,6 +506,14 @@
 		// Transformation of the world called in BeginDraw
 		virtual void WorldTransform();
 
+		// Number of matrices read from and written to OpenGL while drawing the previous frame
+		const Clu::CMatrixStack::SStats& GetMatrixStackStats() const
+		{ return m_SceneApplyData.xMatrixStack.GetFrameStats(); }
+
+		// Number of elements tested against the view frustum, culled and drawn in the previous frame
+		const COGLBaseElement::SCullStats& GetCullStats() const
+		{ return m_SceneApplyData.xCullFrameStats; }
+
 		virtual COGLColor GetBGColor();
 		virtual void SetBGColor(COGLColor& rBGCol);
 		virtual void SetBoxColor(COGLColor& rCol, COGLColor& rXCol, COGLColor& rYCol, COGLColor& rZCol);
@@ -545,6 +562,18 @@
 		// Process the picking data
 		virtual bool PickProcessHits(EMousePickType ePickType, uint uPickColor, float fDepth) { return true; }
 
+		// Returns the bounding volume hierarchy of the main scene used for picking, if it is enabled.
+		// If a non-empty hierarchy is returned, Picking() evaluates the pick ray on the CPU instead of calling PickDraw().
+		virtual COGLPickBVH* GetPickBVH() { return m_pPickBVH; }
+		// Picking on the CPU with the given bounding volume hierarchy
+		bool PickingBVH(COGLPickBVH& rPickBVH, EMousePickType ePickType, int iX, int iY, int iPickW, int iPickH, const int* piViewport, const double* pdFrame, const double* pdProj);
+		// Start and end updating the pick hierarchy while drawing the main scene in the first render pass.
+		// The current model view matrix at the start is the frame of the pick hierarchy.
+		void BeginPickBVHUpdate();
+		void EndPickBVHUpdate();
+		// Marks the pick hierarchy as out of date, so that the next picking draws the scene in pick mode and refits it.
+		void InvalidatePickBVH();
+
 		// returns milliseconds since last call of idlefunc
 		float timeElapsed() { return m_fTimeStep; }
 		void UpdateMatrices();
@@ -601,6 +630,7 @@
 		bool m_bOGLMouse;	// Show OpenGL Mouse
 		bool m_bDrawColorStereo;// If true scene is drawn in color stereo
 		bool m_bDrawTransparency;	// If true double pass is used for drawing transparent objects
+		COGLPickBVH* m_pPickBVH;	// If not null, used for picking instead of drawing in pick mode
 
 		bool m_bSendControlKeyEvents;	// Send control key events to script
 		bool m_bSendFunctionKeyEvents;	// Send function key events to script
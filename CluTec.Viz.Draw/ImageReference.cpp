@@ -50,21 +50,31 @@ CImageReference::CImageReference(const CImageReference& Ref)
 
 CImageReference::~CImageReference()
 {
-	if (m_pImgRep)
-		m_pImgRep->DeRegister(*this);
+	_Release();
 }
 
 
 CImageReference& CImageReference::operator= (const CImageReference& Ref)
 {
-	if (m_pImgRep)
-		m_pImgRep->DeRegister(*this);
+	if (m_pImage == Ref.m_pImage)
+	{
+		m_pImgRep = Ref.m_pImgRep;
+		return *this;
+	}
 
-	m_pImage = Ref.m_pImage;
-	m_pImgRep = Ref.m_pImgRep;
+	TImagePtr pImage = Ref.m_pImage;
+	CImageRepository* pImgRep = Ref.m_pImgRep;
 
-	if (m_pImgRep)
-		m_pImgRep->Register(*this);
+	// Count the new image first, since Ref may be released with the current image
+	if (pImage)
+		pImage->m_lRefCnt.fetch_add(1, std::memory_order_relaxed);
+
+	_Release();
+
+	m_pImage = pImage;
+	m_pImgRep = pImgRep;
+
+	_Track();
 
 	return *this;
 }
@@ -74,8 +84,70 @@ void CImageReference::Invalidate()
 {
 	m_pImgRep = 0;
 	m_pImage = 0;
+	m_bTracked = false;
 }
 
+
+void CImageReference::_AddRef()
+{
+	if (!m_pImage)
+		return;
+
+	m_pImage->m_lRefCnt.fetch_add(1, std::memory_order_relaxed);
+
+	_Track();
+}
+
+
+void CImageReference::_Track()
+{
+	CImageRepository* pRep = m_pImage ? m_pImage->m_pImgRep : 0;
+
+	if (pRep && pRep->IsRefTrackingEnabled())
+	{
+		m_bTracked = pRep->Register(*this);
+	}
+}
+
+
+void CImageReference::_Release()
+{
+	if (!m_pImage)
+		return;
+
+	TImagePtr pImage = m_pImage;
+	CImageRepository* pRep = pImage->m_pImgRep;
+
+	m_pImage = 0;
+
+	if (m_bTracked)
+	{
+		if (pRep)
+			pRep->DeRegister(pImage, *this);
+
+		m_bTracked = false;
+	}
+
+	if (pImage->m_lRefCnt.fetch_sub(1, std::memory_order_acq_rel) == 1)
+	{
+		// The repository may already have been reset
+		if (pRep)
+			pRep->Remove(pImage);
+
+		delete pImage;
+	}
+}
+
+
+size_t CImageReference::GetRefCount() const
+{
+	if (!m_pImage)
+		return 0;
+
+	return size_t(m_pImage->m_lRefCnt.load(std::memory_order_relaxed));
+}
+
+
 bool CImageReference::Set(TImagePtr pImg, CImageRepository *pImgRep)
 {
 	if (m_pImage && m_pImgRep)
@@ -84,5 +156,7 @@ bool CImageReference::Set(TImagePtr pImg, CImageRepository *pImgRep)
 	m_pImage = pImg;
 	m_pImgRep = pImgRep;
 
+	_AddRef();
+
 	return true;
 }
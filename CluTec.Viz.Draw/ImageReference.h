@@ -57,6 +57,7 @@ public:
 	TImagePtr operator-> () { return m_pImage; }
 
 	bool IsValid() { return (m_pImage ? true : false); }
+	size_t GetRefCount() const;
 	CImageRepository* GetImageRepositoryPtr() { return m_pImgRep; }
 
 protected:
@@ -66,13 +67,25 @@ protected:
 	// Set pointers to zero
 	void Invalidate();
 
+	// Increment the reference count of the image
+	void _AddRef();
+
+	// List this reference in the repository if reference tracking is enabled
+	void _Track();
+
+	// Decrement the reference count of the image and delete it if this was the last reference
+	void _Release();
+
 protected:
 	// Pointer to the actual image
 	TImagePtr m_pImage;
 
-	// Pointer to the Image Repository where this reference is registered
+	// Pointer to the Image Repository that created the image
 	CImageRepository *m_pImgRep;
 
+	// True if this reference is listed in the reference map of the repository
+	bool m_bTracked;
+
 };
 
 #endif // !defined(AFX_IMAGEREFERENCE_H__29DD89BE_9839_4381_A23B_049B46BAD391__INCLUDED_)
@@ -37,6 +37,7 @@
 
 CImageRepository::CImageRepository()
 {
+	m_bTrackRefs = false;
 	m_hMutexLock = CreateMutex( NULL, FALSE, NULL );
 }
 
@@ -69,32 +70,40 @@ void CImageRepository::Unlock()
 	ReleaseMutex( m_hMutexLock );
 }
 
+//////////////////////////////////////////////////////////////////////
+// Enable or disable the reference lists
+
+void CImageRepository::EnableRefTracking(bool bEnable)
+{
+	Lock();
+
+	m_bTrackRefs = bEnable;
+	if (!bEnable)
+	{
+		// Tracked references ignore missing entries when they are released
+		m_mapImgToRef.clear();
+	}
+
+	Unlock();
+}
+
 //////////////////////////////////////////////////////////////////////
 // Register Image Reference
 
 bool CImageRepository::Register(CImageReference& rRef)
 {
-	TImgToRefMap::iterator it_End, it_El;
+	if (rRef.m_pImage == 0)
+		return false;
 
 	Lock();
 
-	if (rRef.m_pImage == 0)
+	if (!m_bTrackRefs)
 	{
 		Unlock();
 		return false;
 	}
 
-	// Check whether Ref references image that is already in repository
-	if ((it_El = m_mapImgToRef.find(rRef.m_pImage)) == m_mapImgToRef.end())
-	{
-		// if not, then add it to repository
-		m_mapImgToRef[rRef.m_pImage].push_back(&rRef);
-	}
-	else
-	{
-		// If yes, then add Ref to list
-		it_El->second.push_back(&rRef);
-	}
+	m_mapImgToRef[rRef.m_pImage].push_back(&rRef);
 
 	Unlock();
 
@@ -105,39 +114,28 @@ bool CImageRepository::Register(CImageReference& rRef)
 //////////////////////////////////////////////////////////////////////
 // DeRegister Image Reference
 
-bool CImageRepository::DeRegister(CImageReference& rRef)
+bool CImageRepository::DeRegister(TImagePtr pImage, CImageReference& rRef)
 {
-	TImgToRefMap::iterator it_End, it_El;
+	TImgToRefMap::iterator it_El;
 
 	Lock();
 
-	if (rRef.m_pImage == 0)
-		return false;
-
 	// Check whether Ref references image that is in repository
-	if ((it_El = m_mapImgToRef.find(rRef.m_pImage)) == m_mapImgToRef.end())
+	if ((it_El = m_mapImgToRef.find(pImage)) == m_mapImgToRef.end())
 	{
-		// if not, then there is a problem
+		// Tracking may have been switched off in the meantime
 		Unlock();
 		return false;
 	}
-	else
-	{
-		// If yes, then find it and remove it
-		TImgRefList &rList = it_El->second;
 
-		// Remove reference from list
-		rList.remove(&rRef);
+	TImgRefList &rList = it_El->second;
 
-		// Check whether there are any references left
-		if (rList.empty())
-		{
-			// if nothing is left then delete image
-			delete it_El->first;
+	// Remove reference from list
+	rList.remove(&rRef);
 
-			// remove the entry we found from the map
-			m_mapImgToRef.erase(it_El);
-		}
+	if (rList.empty())
+	{
+		m_mapImgToRef.erase(it_El);
 	}
 
 	Unlock();
@@ -145,58 +143,74 @@ bool CImageRepository::DeRegister(CImageReference& rRef)
 	return true;
 }
 
-
 //////////////////////////////////////////////////////////////////////
-// Create a new image and return the reference
+// Add a new image to the image set and return a reference to it
 
-CImageReference CImageRepository::New()
+CImageReference CImageRepository::Add(TImagePtr pImage)
 {
-	TImagePtr pImage;
 	CImageReference ImgRef;
 
 	Lock();
 
-	//pImgRef = new CImageReference;
-	
-	if (!(pImage = new TImage))
-	{
-		Unlock();
-		return ImgRef;
-	}
+	pImage->m_pImgRep = this;
+	m_setImage.insert(pImage);
+
+	Unlock();
 
 	ImgRef.Set(pImage, this);
 
-	Register(ImgRef);
+	return ImgRef;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Remove an image whose last reference was released.
+// The image is deleted by the caller outside of the lock.
+
+void CImageRepository::Remove(TImagePtr pImage)
+{
+	Lock();
+
+	m_setImage.erase(pImage);
+	m_mapImgToRef.erase(pImage);
 
 	Unlock();
-	return ImgRef;
 }
 
+
 //////////////////////////////////////////////////////////////////////
-// Create a new image which is a copy of the one given.
-// Return a pointer to the image.
-// IMPORTANT: Need to delete returned pointer manually!
+/// Get number of times given image is referenced
 
-CImageReference CImageRepository::New(CImageReference& rRef)
+size_t CImageRepository::GetRefCount(const TImage* pImage)
+{
+	if (!pImage)
+		return 0;
+
+	return size_t(pImage->m_lRefCnt.load(std::memory_order_relaxed));
+}
+
+
+//////////////////////////////////////////////////////////////////////
+// Create a new image and return the reference
+
+CImageReference CImageRepository::New()
 {
 	TImagePtr pImage;
-	CImageReference ImgRef;
-	
-	Lock();
-	//pImgRef = new CImageReference;
 
-	if (!(pImage = new TImage(*rRef.m_pImage)))
+	if (!(pImage = new TImage))
 	{
-		Unlock();
-		return ImgRef;
+		return CImageReference();
 	}
 
-	ImgRef.Set(pImage, this);
+	return Add(pImage);
+}
 
-	Register(ImgRef);
+//////////////////////////////////////////////////////////////////////
+// Create a new image which is a copy of the one given.
+// Return a reference to the image.
 
-	Unlock();
-	return ImgRef;	
+CImageReference CImageRepository::New(CImageReference& rRef)
+{
+	return Copy(rRef);
 }
 
 
@@ -207,56 +221,35 @@ CImageReference CImageRepository::New(CImageReference& rRef)
 CImageReference CImageRepository::Copy(CImageReference& rRef)
 {
 	TImagePtr pImage;
-	CImageReference ImgRef;
-	
-	Lock();
-	if (!(pImage = new TImage(*rRef.m_pImage)))
+
+	if (!rRef.m_pImage || !(pImage = new TImage(*rRef.m_pImage)))
 	{
-		Unlock();
-		return ImgRef;
+		return CImageReference();
 	}
 
-	ImgRef.Set(pImage, this);
-
-	Register(ImgRef);
-
-	Unlock();
-	return ImgRef;	
+	return Add(pImage);
 }
 
 
 //////////////////////////////////////////////////////////////////////
-// Delete all images
+// Detach all images from the repository.
+// References stay valid and images are deleted when their last reference is released.
 
 void CImageRepository::Reset()
 {
-	TImgToRefMap::iterator it_El, it_End;
-	TImgRefList::iterator it_LEl, it_LEnd;
+	TImageSet::iterator it_El;
 
 	Lock();
 
-	it_End = m_mapImgToRef.end();
-
-	for( it_El = m_mapImgToRef.begin();
-		 it_El != it_End;
+	for( it_El = m_setImage.begin();
+		 it_El != m_setImage.end();
 		 ++it_El)
 	{
-		TImgRefList rList = it_El->second;
-		it_LEnd = rList.end();
-
-		// Invalidate all references
-		for( it_LEl = rList.begin();
-			 it_LEl != it_LEnd;
-			 ++it_LEl)
-		{
-			(*it_LEl)->Invalidate();
-		}
-
-		delete it_El->first;
+		(*it_El)->m_pImgRep = 0;
 	}
 
-	// Delete the whole map
-	m_mapImgToRef.erase(m_mapImgToRef.begin(), m_mapImgToRef.end());
+	m_setImage.clear();
+	m_mapImgToRef.clear();
 
 	Unlock();
 }
@@ -33,14 +33,17 @@
 
 #include <list>
 #include <map>
+#include <set>
 
 #include "OGLImage.h"
 
 using std::list;
 using std::map;
+using std::set;
 
 class CImageReference;
 
+// Images count their references themselves, see COGLBERepository.
 class CLUDRAW_API CImageRepository
 {
 public:
@@ -51,6 +54,7 @@ public:
 	typedef TImage* TImagePtr;
 	typedef list<CImageReference*> TImgRefList;
 	typedef map<TImagePtr, TImgRefList> TImgToRefMap;
+	typedef set<TImagePtr> TImageSet;
 
 public:
 	CImageRepository();
@@ -66,9 +70,17 @@ public:
 	// Create a new image which is a copy of the one given
 	CImageReference Copy(CImageReference& rRef);
 
-	// Delete all images
+	// Detach all images from the repository. Images are deleted when their last reference is released.
 	void Reset();
 
+	// Keep a list of references per image. Only references created while enabled are listed.
+	void EnableRefTracking(bool bEnable);
+	bool IsRefTrackingEnabled() const { return m_bTrackRefs; }
+
+	// Number of references to the given image
+	static size_t GetRefCount(const TImage* pImage);
+
+	const TImageSet* GetImageSet() { return &m_setImage; }
 	const TImgToRefMap* GetImgToRefMap() { return &m_mapImgToRef; }
 
 	bool Lock( int iWait = INFINITE );
@@ -76,11 +88,19 @@ public:
 
 protected:
 	bool Register(CImageReference& rRef);
-	bool DeRegister(CImageReference& rRef);
+	bool DeRegister(TImagePtr pImage, CImageReference& rRef);
+
+	// Create a new reference to a new image
+	CImageReference Add(TImagePtr pImage);
+	// Remove an image whose last reference was released
+	void Remove(TImagePtr pImage);
 
 protected:
+	TImageSet m_setImage;
 	TImgToRefMap m_mapImgToRef;
 
+	bool m_bTrackRefs;
+
 	HANDLE m_hMutexLock;
 };
 
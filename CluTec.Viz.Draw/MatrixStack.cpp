@@ -27,47 +27,62 @@
 #include "stdafx.h"
 #include "MatrixStack.h"
 
+#include <string.h>
+#include <math.h>
+
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // namespace: Clu
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 namespace Clu
 {
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	CMatrixStack::CMatrixStack()
+	{
+		for (int iSlot = 0; iSlot < c_iSlotCount; iSlot++)
+		{
+			m_pxSlot[iSlot].bValid = false;
+			m_pxSlot[iSlot].vecStack.reserve(32);
+		}
+
+		m_uMode = 0;
+		memset(&m_xStats, 0, sizeof(SStats));
+		memset(&m_xFrameStats, 0, sizeof(SStats));
+	}
+
 	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 	void CMatrixStack::Push(EMatrixMode eMode)
 	{
 		try
 		{
 			// Activate the given matrix mode. This is required since some callers rely on this behavior
-			CLU_OGL_CALL(glMatrixMode((unsigned)eMode));
+			MatrixMode(eMode);
 
 			if (eMode == EMatrixMode::ModelView)
 			{
-				// Get matrix and push it
-				m_xStackModelView.push(SMatrix(GL_MODELVIEW_MATRIX));
+				// Push a copy of the current matrix
+				_Validate(c_iSlotModelView);
+				m_pxSlot[c_iSlotModelView].vecStack.push_back(m_pxSlot[c_iSlotModelView].xMatrix);
+				++m_xStats.uPushCnt;
 			}
 			else if (eMode == EMatrixMode::Projection)
 			{
-				// Get matrix and push it
-				m_xStackProjection.push(SMatrix(GL_PROJECTION_MATRIX));
+				// Push a copy of the current matrix
+				_Validate(c_iSlotProjection);
+				m_pxSlot[c_iSlotProjection].vecStack.push_back(m_pxSlot[c_iSlotProjection].xMatrix);
+				++m_xStats.uPushCnt;
 			}
 			else
 			{
-				// Save active texture unit
-				int iActiveTexUnit;
-				CLU_OGL_CALL(glGetIntegerv(GL_ACTIVE_TEXTURE, &iActiveTexUnit));
+				_ValidateTextures();
 
 				// Push the matrix for each texture unit
 				for (int iTexUnit = 0; iTexUnit < OGL_MAX_TEX_UNITS; iTexUnit++)
 				{
-					// Activate current texture unit
-					CLU_OGL_CALL(glActiveTexture(GL_TEXTURE0 + iTexUnit));
-
-					// Get matrix and push it
-					m_xStackTextures[iTexUnit].push(SMatrix(GL_TEXTURE_MATRIX));
+					SSlot& rSlot = m_pxSlot[c_iSlotTexture + iTexUnit];
+					rSlot.vecStack.push_back(rSlot.xMatrix);
 				}
 
-				// Restore active texture unit
-				CLU_OGL_CALL(glActiveTexture(iActiveTexUnit));
+				m_xStats.uPushCnt += OGL_MAX_TEX_UNITS;
 			}
 		}
 		catch (Clu::CIException& ex)
@@ -82,36 +97,47 @@ namespace Clu
 		try
 		{
 			// Activate the given matrix mode. This is required for setting the desired matrix
-			CLU_OGL_CALL(glMatrixMode((unsigned)eMode));
+			MatrixMode(eMode);
 
 			if (eMode == EMatrixMode::ModelView)
 			{
 				// Pop top of the stack and apply matrix
-				_Pop(m_xStackModelView);
+				_Pop(m_pxSlot[c_iSlotModelView]);
 			}
 			else if (eMode == EMatrixMode::Projection)
 			{
 				// Pop top of the stack and apply matrix
-				_Pop(m_xStackProjection);
+				_Pop(m_pxSlot[c_iSlotProjection]);
 			}
 			else
 			{
-				// Save active texture unit
-				int iActiveTexUnit;
-				CLU_OGL_CALL(glGetIntegerv(GL_ACTIVE_TEXTURE, &iActiveTexUnit));
+				// The active texture unit is only changed for matrices that have to be loaded
+				int iActiveTexUnit = -1;
 
-				// Push the matrix for each texture unit
+				// Pop the matrix for each texture unit
 				for (int iTexUnit = 0; iTexUnit < OGL_MAX_TEX_UNITS; iTexUnit++)
 				{
-					// Activate current texture unit
-					CLU_OGL_CALL(glActiveTexture(GL_TEXTURE0 + iTexUnit));
+					SSlot& rSlot = m_pxSlot[c_iSlotTexture + iTexUnit];
+
+					if (!rSlot.vecStack.empty() && (!rSlot.bValid || memcmp(&rSlot.xMatrix, &rSlot.vecStack.back(), sizeof(SMatrix)) != 0))
+					{
+						if (iActiveTexUnit < 0)
+						{
+							iActiveTexUnit = _GetActiveTexUnit();
+						}
+
+						CLU_OGL_CALL(glActiveTexture(GL_TEXTURE0 + iTexUnit));
+					}
 
 					// Pop top of the stack and apply matrix
-					_Pop(m_xStackTextures[iTexUnit]);
+					_Pop(rSlot);
 				}
 
 				// Restore active texture unit
-				CLU_OGL_CALL(glActiveTexture(iActiveTexUnit));
+				if (iActiveTexUnit >= 0)
+				{
+					CLU_OGL_CALL(glActiveTexture(GL_TEXTURE0 + iActiveTexUnit));
+				}
 			}
 		}
 		catch (Clu::CIException& ex)
@@ -121,31 +147,423 @@ namespace Clu
 	}
 
 	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-	void CMatrixStack::_Pop(std::stack<SMatrix>& xStack)
+	void CMatrixStack::_Pop(SSlot& rSlot)
 	{
-		if (xStack.empty())
+		if (rSlot.vecStack.empty())
 		{
 			throw CLU_EXCEPTION("The desired stack is empty");
 		}
 
-		// Get top of the stack and apply matrix
-		CLU_OGL_CALL(glLoadMatrixf(xStack.top().pfData));
+		// Only apply the matrix if it has been changed since it was pushed
+		const SMatrix& xTop = rSlot.vecStack.back();
+		if (!rSlot.bValid || memcmp(&rSlot.xMatrix, &xTop, sizeof(SMatrix)) != 0)
+		{
+			rSlot.xMatrix = xTop;
+			rSlot.bValid  = true;
+
+			CLU_OGL_CALL(glLoadMatrixf(rSlot.xMatrix.pfData));
+			++m_xStats.uWriteCnt;
+		}
 
 		// Remove the top of the stack
-		xStack.pop();
+		rSlot.vecStack.pop_back();
 	}
 
 	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-	bool CMatrixStack::IsEmpty() const
+	void CMatrixStack::_Validate(int iSlot)
 	{
-		bool bIsEmpty = true;
+		SSlot& rSlot = m_pxSlot[iSlot];
+		if (rSlot.bValid)
+		{
+			return;
+		}
+
+		if (iSlot == c_iSlotModelView)
+		{
+			CLU_OGL_CALL(glGetFloatv(GL_MODELVIEW_MATRIX, rSlot.xMatrix.pfData));
+		}
+		else if (iSlot == c_iSlotProjection)
+		{
+			CLU_OGL_CALL(glGetFloatv(GL_PROJECTION_MATRIX, rSlot.xMatrix.pfData));
+		}
+		else
+		{
+			// The texture unit of the slot has to be active
+			CLU_OGL_CALL(glGetFloatv(GL_TEXTURE_MATRIX, rSlot.xMatrix.pfData));
+		}
+
+		rSlot.bValid = true;
+		++m_xStats.uReadCnt;
+	}
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	void CMatrixStack::_ValidateTextures()
+	{
+		int iActiveTexUnit = -1;
+
 		for (int iTexUnit = 0; iTexUnit < OGL_MAX_TEX_UNITS; iTexUnit++)
 		{
-			bIsEmpty &= m_xStackTextures[iTexUnit].empty();
+			if (m_pxSlot[c_iSlotTexture + iTexUnit].bValid)
+			{
+				continue;
+			}
+
+			if (iActiveTexUnit < 0)
+			{
+				iActiveTexUnit = _GetActiveTexUnit();
+			}
+
+			CLU_OGL_CALL(glActiveTexture(GL_TEXTURE0 + iTexUnit));
+			_Validate(c_iSlotTexture + iTexUnit);
+		}
+
+		// Restore active texture unit
+		if (iActiveTexUnit >= 0)
+		{
+			CLU_OGL_CALL(glActiveTexture(GL_TEXTURE0 + iActiveTexUnit));
+		}
+	}
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	int CMatrixStack::_GetActiveTexUnit()
+	{
+		int iActiveTexUnit;
+		CLU_OGL_CALL(glGetIntegerv(GL_ACTIVE_TEXTURE, &iActiveTexUnit));
+		++m_xStats.uTexUnitQueryCnt;
+
+		iActiveTexUnit -= GL_TEXTURE0;
+		if ((iActiveTexUnit < 0) || (iActiveTexUnit >= OGL_MAX_TEX_UNITS))
+		{
+			throw CLU_EXCEPTION(CLU_S "Texture unit " << iActiveTexUnit << " is not supported by the matrix stack");
 		}
 
-		bIsEmpty &= m_xStackProjection.empty();
-		bIsEmpty &= m_xStackModelView.empty();
+		return iActiveTexUnit;
+	}
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	int CMatrixStack::_GetActiveSlot()
+	{
+		switch (GetMatrixMode())
+		{
+		case CMatrixStack::ModelView:
+			return c_iSlotModelView;
+		case CMatrixStack::Projection:
+			return c_iSlotProjection;
+		default:
+			return c_iSlotTexture + _GetActiveTexUnit();
+		}
+	}
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	void CMatrixStack::_Load(int iSlot)
+	{
+		CLU_OGL_CALL(glLoadMatrixf(m_pxSlot[iSlot].xMatrix.pfData));
+		++m_xStats.uWriteCnt;
+	}
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	void CMatrixStack::_Set(const double* pdMatrix)
+	{
+		int iSlot    = _GetActiveSlot();
+		SSlot& rSlot = m_pxSlot[iSlot];
+
+		SMatrix xMatrix;
+		for (int i = 0; i < 16; i++)
+		{
+			xMatrix.pfData[i] = float(pdMatrix[i]);
+		}
+
+		// Nothing to do if the matrix is already set
+		if (rSlot.bValid && memcmp(&rSlot.xMatrix, &xMatrix, sizeof(SMatrix)) == 0)
+		{
+			return;
+		}
+
+		rSlot.xMatrix = xMatrix;
+		rSlot.bValid  = true;
+		_Load(iSlot);
+	}
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	void CMatrixStack::_Mult(const double* pdMatrix)
+	{
+		int iSlot = _GetActiveSlot();
+		_Validate(iSlot);
+
+		// Column-major product of the current matrix with the given one
+		const float* pfA = m_pxSlot[iSlot].xMatrix.pfData;
+		double pdResult[16];
+
+		for (int iCol = 0; iCol < 4; iCol++)
+		{
+			for (int iRow = 0; iRow < 4; iRow++)
+			{
+				double dValue = 0.0;
+				for (int k = 0; k < 4; k++)
+				{
+					dValue += double(pfA[k * 4 + iRow]) * pdMatrix[iCol * 4 + k];
+				}
+
+				pdResult[iCol * 4 + iRow] = dValue;
+			}
+		}
+
+		_Set(pdResult);
+	}
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	void CMatrixStack::MatrixMode(EMatrixMode eMode)
+	{
+		CLU_OGL_CALL(glMatrixMode((unsigned) eMode));
+		m_uMode = (unsigned) eMode;
+	}
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	CMatrixStack::EMatrixMode CMatrixStack::GetMatrixMode()
+	{
+		if (m_uMode == 0)
+		{
+			int iMode;
+			CLU_OGL_CALL(glGetIntegerv(GL_MATRIX_MODE, &iMode));
+			m_uMode = (unsigned) iMode;
+		}
+
+		return EMatrixMode(m_uMode);
+	}
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	void CMatrixStack::LoadIdentity()
+	{
+		const double pdMatrix[16] = { 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1 };
+		_Set(pdMatrix);
+	}
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	void CMatrixStack::LoadMatrix(const float* pfMatrix)
+	{
+		double pdMatrix[16];
+		for (int i = 0; i < 16; i++)
+		{
+			pdMatrix[i] = double(pfMatrix[i]);
+		}
+
+		_Set(pdMatrix);
+	}
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	void CMatrixStack::LoadMatrix(const double* pdMatrix)
+	{
+		_Set(pdMatrix);
+	}
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	void CMatrixStack::MultMatrix(const float* pfMatrix)
+	{
+		double pdMatrix[16];
+		for (int i = 0; i < 16; i++)
+		{
+			pdMatrix[i] = double(pfMatrix[i]);
+		}
+
+		_Mult(pdMatrix);
+	}
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	void CMatrixStack::MultMatrix(const double* pdMatrix)
+	{
+		_Mult(pdMatrix);
+	}
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	void CMatrixStack::Translate(double dX, double dY, double dZ)
+	{
+		const double pdMatrix[16] = { 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, dX, dY, dZ, 1 };
+		_Mult(pdMatrix);
+	}
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	void CMatrixStack::Rotate(double dAngle, double dX, double dY, double dZ)
+	{
+		double dLen = sqrt(dX * dX + dY * dY + dZ * dZ);
+		if (dLen == 0.0)
+		{
+			return;
+		}
+
+		dX /= dLen;
+		dY /= dLen;
+		dZ /= dLen;
+
+		double dRad = dAngle * 3.14159265358979323846 / 180.0;
+		double dC   = cos(dRad);
+		double dS   = sin(dRad);
+		double dT   = 1.0 - dC;
+
+		const double pdMatrix[16] =
+		{
+			dX * dX * dT + dC, dY * dX * dT + dZ * dS, dX * dZ * dT - dY * dS, 0,
+			dX * dY * dT - dZ * dS, dY * dY * dT + dC, dY * dZ * dT + dX * dS, 0,
+			dX * dZ * dT + dY * dS, dY * dZ * dT - dX * dS, dZ * dZ * dT + dC, 0,
+			0, 0, 0, 1
+		};
+
+		_Mult(pdMatrix);
+	}
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	void CMatrixStack::Scale(double dX, double dY, double dZ)
+	{
+		const double pdMatrix[16] = { dX, 0, 0, 0, 0, dY, 0, 0, 0, 0, dZ, 0, 0, 0, 0, 1 };
+		_Mult(pdMatrix);
+	}
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	void CMatrixStack::Ortho(double dLeft, double dRight, double dBottom, double dTop, double dNear, double dFar)
+	{
+		// OpenGL leaves the matrix unchanged for an empty volume
+		if ((dLeft == dRight) || (dBottom == dTop) || (dNear == dFar))
+		{
+			return;
+		}
+
+		const double pdMatrix[16] =
+		{
+			2.0 / (dRight - dLeft), 0, 0, 0,
+			0, 2.0 / (dTop - dBottom), 0, 0,
+			0, 0, -2.0 / (dFar - dNear), 0,
+			-(dRight + dLeft) / (dRight - dLeft), -(dTop + dBottom) / (dTop - dBottom), -(dFar + dNear) / (dFar - dNear), 1
+		};
+
+		_Mult(pdMatrix);
+	}
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	void CMatrixStack::Frustum(double dLeft, double dRight, double dBottom, double dTop, double dNear, double dFar)
+	{
+		// OpenGL leaves the matrix unchanged for an invalid volume
+		if ((dLeft == dRight) || (dBottom == dTop) || (dNear == dFar) || (dNear <= 0.0) || (dFar <= 0.0))
+		{
+			return;
+		}
+
+		const double pdMatrix[16] =
+		{
+			2.0 * dNear / (dRight - dLeft), 0, 0, 0,
+			0, 2.0 * dNear / (dTop - dBottom), 0, 0,
+			(dRight + dLeft) / (dRight - dLeft), (dTop + dBottom) / (dTop - dBottom), -(dFar + dNear) / (dFar - dNear), -1,
+			0, 0, -2.0 * dFar * dNear / (dFar - dNear), 0
+		};
+
+		_Mult(pdMatrix);
+	}
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	void CMatrixStack::Perspective(double dAngle, double dAspect, double dNear, double dFar)
+	{
+		double dRad = dAngle * 3.14159265358979323846 / 360.0;
+		double dSin = sin(dRad);
+
+		// gluPerspective leaves the matrix unchanged in these cases
+		if ((dFar == dNear) || (dSin == 0.0) || (dAspect == 0.0))
+		{
+			return;
+		}
+
+		double dCot = cos(dRad) / dSin;
+
+		const double pdMatrix[16] =
+		{
+			dCot / dAspect, 0, 0, 0,
+			0, dCot, 0, 0,
+			0, 0, -(dFar + dNear) / (dFar - dNear), -1,
+			0, 0, -2.0 * dNear * dFar / (dFar - dNear), 0
+		};
+
+		_Mult(pdMatrix);
+	}
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	void CMatrixStack::GetMatrix(EMatrixMode eMode, float* pfMatrix)
+	{
+		int iSlot;
+		if (eMode == EMatrixMode::ModelView)
+		{
+			iSlot = c_iSlotModelView;
+		}
+		else if (eMode == EMatrixMode::Projection)
+		{
+			iSlot = c_iSlotProjection;
+		}
+		else
+		{
+			iSlot = c_iSlotTexture + _GetActiveTexUnit();
+		}
+
+		_Validate(iSlot);
+		memcpy(pfMatrix, m_pxSlot[iSlot].xMatrix.pfData, 16 * sizeof(float));
+	}
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	void CMatrixStack::GetMatrix(EMatrixMode eMode, double* pdMatrix)
+	{
+		float pfMatrix[16];
+		GetMatrix(eMode, pfMatrix);
+
+		for (int i = 0; i < 16; i++)
+		{
+			pdMatrix[i] = double(pfMatrix[i]);
+		}
+	}
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	void CMatrixStack::GetTextureMatrix(int iTexUnit, float* pfMatrix)
+	{
+		if ((iTexUnit < 0) || (iTexUnit >= OGL_MAX_TEX_UNITS))
+		{
+			throw CLU_EXCEPTION(CLU_S "Texture unit " << iTexUnit << " is not supported by the matrix stack");
+		}
+
+		SSlot& rSlot = m_pxSlot[c_iSlotTexture + iTexUnit];
+		if (!rSlot.bValid)
+		{
+			int iActiveTexUnit = _GetActiveTexUnit();
+
+			CLU_OGL_CALL(glActiveTexture(GL_TEXTURE0 + iTexUnit));
+			_Validate(c_iSlotTexture + iTexUnit);
+			CLU_OGL_CALL(glActiveTexture(GL_TEXTURE0 + iActiveTexUnit));
+		}
+
+		memcpy(pfMatrix, rSlot.xMatrix.pfData, 16 * sizeof(float));
+	}
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	void CMatrixStack::Invalidate()
+	{
+		for (int iSlot = 0; iSlot < c_iSlotCount; iSlot++)
+		{
+			m_pxSlot[iSlot].bValid = false;
+		}
+
+		m_uMode = 0;
+	}
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	void CMatrixStack::BeginFrame()
+	{
+		m_xFrameStats = m_xStats;
+		memset(&m_xStats, 0, sizeof(SStats));
+
+		Invalidate();
+	}
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	bool CMatrixStack::IsEmpty() const
+	{
+		bool bIsEmpty = true;
+		for (int iSlot = 0; iSlot < c_iSlotCount; iSlot++)
+		{
+			bIsEmpty &= m_pxSlot[iSlot].vecStack.empty();
+		}
 
 		return bIsEmpty;
 	}
@@ -157,17 +575,17 @@ namespace Clu
 		switch (eMode)
 		{
 		case Clu::CMatrixStack::ModelView:
-			bIsEmpty &= m_xStackModelView.empty();
+			bIsEmpty &= m_pxSlot[c_iSlotModelView].vecStack.empty();
 			break;
 
 		case Clu::CMatrixStack::Projection:
-			bIsEmpty &= m_xStackProjection.empty();
+			bIsEmpty &= m_pxSlot[c_iSlotProjection].vecStack.empty();
 			break;
 
 		case Clu::CMatrixStack::Texture:
 			for (int iTexUnit = 0; iTexUnit < OGL_MAX_TEX_UNITS; iTexUnit++)
 			{
-				bIsEmpty &= m_xStackTextures[iTexUnit].empty();
+				bIsEmpty &= m_pxSlot[c_iSlotTexture + iTexUnit].vecStack.empty();
 			}
 
 			break;
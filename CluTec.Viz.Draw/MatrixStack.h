@@ -26,8 +26,8 @@
 
 #pragma once
 
-#include <stack>
 #include <vector>
+#include <string>
 
 #include "GL/gl.h"
 
@@ -47,6 +47,12 @@ namespace Clu
 	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 	/// <summary>
 	/// 	Stack of matrices.
+	///
+	/// 	The stack keeps a copy of the current model view, projection and texture matrices on the CPU. Pushing a matrix copies
+	/// 	this shadow matrix and popping a matrix only loads it into OpenGL if it differs from the current one. Matrices are
+	/// 	only read from OpenGL if they are not known, i.e. after a call to Invalidate(). For this to work, all matrix operations
+	/// 	within a frame have to be done through this class. Code that changes OpenGL matrices directly has to call Invalidate()
+	/// 	afterwards.
 	/// </summary>
 	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 	class CMatrixStack
@@ -58,7 +64,7 @@ namespace Clu
 		/// 	Default constructor.
 		/// </summary>
 		/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-		CMatrixStack() = default;
+		CMatrixStack();
 
 		/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 		/// <summary>
@@ -81,6 +87,23 @@ namespace Clu
 			Texture = GL_TEXTURE,
 		};
 
+		/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// <summary>
+		/// 	Number of matrices read from and written to OpenGL.
+		/// </summary>
+		/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		struct SStats
+		{
+			/// <summary> Number of matrices read with glGet. </summary>
+			unsigned uReadCnt;
+			/// <summary> Number of matrices loaded into OpenGL. </summary>
+			unsigned uWriteCnt;
+			/// <summary> Number of matrices pushed. </summary>
+			unsigned uPushCnt;
+			/// <summary> Number of queries of the active texture unit. </summary>
+			unsigned uTexUnitQueryCnt;
+		};
+
 	private:
 
 		/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -90,31 +113,31 @@ namespace Clu
 		/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 		struct SMatrix
 		{
-			/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-			/// <summary>
-			/// 	Default constructor. Matrix is not initialized.
-			/// </summary>
-			/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-			SMatrix()
-			{
-			}
-
-			/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-			/// <summary>
-			/// 	Constructor that gets the given matrix from OpenGL.
-			/// </summary>
-			///
-			/// <param name="uType"> The matrix type. </param>
-			/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-			SMatrix(unsigned uType)
-			{
-				CLU_OGL_CALL(glGetFloatv(uType, pfData));
-			}
-
 			/// <summary> Pointer to the memory. </summary>
 			float pfData[16];
 		};
 
+		/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// <summary>
+		/// 	The current matrix of one matrix mode or texture unit and its stack.
+		/// </summary>
+		/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		struct SSlot
+		{
+			/// <summary> The current matrix, if bValid is true. </summary>
+			SMatrix xMatrix;
+			/// <summary> True if xMatrix is the matrix set in OpenGL. </summary>
+			bool bValid;
+			/// <summary> The stack. </summary>
+			std::vector<SMatrix> vecStack;
+		};
+
+		/// <summary> Slot indices. The texture units follow the projection slot. </summary>
+		static const int c_iSlotModelView = 0;
+		static const int c_iSlotProjection = 1;
+		static const int c_iSlotTexture = 2;
+		static const int c_iSlotCount = c_iSlotTexture + OGL_MAX_TEX_UNITS;
+
 	public:
 
 		/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -149,6 +172,102 @@ namespace Clu
 		/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 		void Pop(EMatrixMode eMode);
 
+	public:
+
+		/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// <summary>
+		/// 	Activates the given matrix mode. The following matrix operations act on the matrix of this mode. In texture mode they
+		/// 	act on the matrix of the active texture unit.
+		/// </summary>
+		///
+		/// <param name="eMode"> The matrix mode. </param>
+		/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		void MatrixMode(EMatrixMode eMode);
+
+		/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// <summary>
+		/// 	Gets the active matrix mode.
+		/// </summary>
+		///
+		/// <returns> The matrix mode. </returns>
+		/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		EMatrixMode GetMatrixMode();
+
+		/// <summary> Replaces the matrix of the active mode by the identity. </summary>
+		void LoadIdentity();
+
+		/// <summary> Replaces the matrix of the active mode by the given column-major matrix. </summary>
+		void LoadMatrix(const float* pfMatrix);
+		void LoadMatrix(const double* pdMatrix);
+
+		/// <summary> Multiplies the matrix of the active mode from the right with the given column-major matrix. </summary>
+		void MultMatrix(const float* pfMatrix);
+		void MultMatrix(const double* pdMatrix);
+
+		/// <summary> Same as glTranslate. </summary>
+		void Translate(double dX, double dY, double dZ);
+
+		/// <summary> Same as glRotate. The angle is given in degrees. </summary>
+		void Rotate(double dAngle, double dX, double dY, double dZ);
+
+		/// <summary> Same as glScale. </summary>
+		void Scale(double dX, double dY, double dZ);
+
+		/// <summary> Same as glOrtho. </summary>
+		void Ortho(double dLeft, double dRight, double dBottom, double dTop, double dNear, double dFar);
+
+		/// <summary> Same as glFrustum. </summary>
+		void Frustum(double dLeft, double dRight, double dBottom, double dTop, double dNear, double dFar);
+
+		/// <summary> Same as gluPerspective. The angle is given in degrees. </summary>
+		void Perspective(double dAngle, double dAspect, double dNear, double dFar);
+
+		/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// <summary>
+		/// 	Gets the current matrix of the given mode without changing the active mode. For the texture mode the matrix of the
+		/// 	active texture unit is returned.
+		/// </summary>
+		///
+		/// <param name="eMode">    The matrix mode. </param>
+		/// <param name="pfMatrix"> [out] The column-major matrix. </param>
+		/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		void GetMatrix(EMatrixMode eMode, float* pfMatrix);
+		void GetMatrix(EMatrixMode eMode, double* pdMatrix);
+
+		/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// <summary>
+		/// 	Gets the current texture matrix of the given texture unit.
+		/// </summary>
+		///
+		/// <param name="iTexUnit"> The texture unit. </param>
+		/// <param name="pfMatrix"> [out] The column-major matrix. </param>
+		/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		void GetTextureMatrix(int iTexUnit, float* pfMatrix);
+
+	public:
+
+		/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// <summary>
+		/// 	Forgets the current matrices and the active matrix mode. They are read from OpenGL again when they are needed. Call
+		/// 	this after the OpenGL matrices have been changed without this class. The stacks are not changed.
+		/// </summary>
+		/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		void Invalidate();
+
+		/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// <summary>
+		/// 	Starts a new frame. Stores the statistics of the previous frame, resets the counters and invalidates the current
+		/// 	matrices.
+		/// </summary>
+		/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		void BeginFrame();
+
+		/// <summary> Gets the statistics since the start of the current frame. </summary>
+		const SStats& GetStats() const { return m_xStats; }
+
+		/// <summary> Gets the statistics of the previous frame. </summary>
+		const SStats& GetFrameStats() const { return m_xFrameStats; }
+
 	public:
 
 		/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -175,12 +294,44 @@ namespace Clu
 
 		/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 		/// <summary>
-		/// 	Removes and returns the top-of-stack object. Tests if the stack is empty.
+		/// 	Removes the top-of-stack object and makes it the current matrix. Tests if the stack is empty. The matrix is only
+		/// 	loaded into OpenGL if it differs from the current matrix. The matrix mode and, for texture matrices, the texture
+		/// 	unit of the slot have to be active.
 		/// </summary>
 		///
-		/// <param name="xStack"> [in] The stack. </param>
+		/// <param name="rSlot"> [in] The slot. </param>
 		/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-		void _Pop(std::stack<SMatrix>& xStack);
+		void _Pop(SSlot& rSlot);
+
+		/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// <summary>
+		/// 	Reads the matrix of the slot from OpenGL, if it is not known.
+		/// </summary>
+		///
+		/// <param name="iSlot"> The slot index. </param>
+		/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		void _Validate(int iSlot);
+
+		/// <summary> Reads the matrices of all texture units that are not known. </summary>
+		void _ValidateTextures();
+
+		/// <summary> Gets the slot index of the active matrix mode and texture unit. </summary>
+		int _GetActiveSlot();
+
+		/// <summary>
+		/// 	Gets the active texture unit. It is queried from OpenGL each time, since textures change it directly and not through
+		/// 	this class.
+		/// </summary>
+		int _GetActiveTexUnit();
+
+		/// <summary> Loads the current matrix of the active slot into OpenGL. </summary>
+		void _Load(int iSlot);
+
+		/// <summary> Sets the matrix of the active slot to the product of its current matrix and the given matrix. </summary>
+		void _Mult(const double* pdMatrix);
+
+		/// <summary> Sets the matrix of the active slot to the given matrix. </summary>
+		void _Set(const double* pdMatrix);
 
 		/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 		/// <summary>
@@ -208,11 +359,14 @@ namespace Clu
 
 	private:
 
-		/// <summary> The texture matrix stack for each texture unit. </summary>
-		std::stack<SMatrix> m_xStackTextures[OGL_MAX_TEX_UNITS];
-		/// <summary> The projection matrix stack. </summary>
-		std::stack<SMatrix> m_xStackProjection;
-		/// <summary> The model view stack. </summary>
-		std::stack<SMatrix> m_xStackModelView;
+		/// <summary> The model view, projection and texture unit slots. </summary>
+		SSlot m_pxSlot[c_iSlotCount];
+		/// <summary> The active matrix mode. Zero if it is not known. </summary>
+		unsigned m_uMode;
+
+		/// <summary> The statistics of the current frame. </summary>
+		SStats m_xStats;
+		/// <summary> The statistics of the previous frame. </summary>
+		SStats m_xFrameStats;
 	};
 }
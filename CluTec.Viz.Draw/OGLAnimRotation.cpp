@@ -192,7 +192,7 @@ bool COGLAnimRotation::Apply(COGLBaseElement::EApplyMode eMode, COGLBaseElement:
 	}
 	else
 	{
-		glRotatef( m_fAngle, m_fX, m_fY, m_fZ );
+		rData.xMatrixStack.Rotate( m_fAngle, m_fX, m_fY, m_fZ );
 	}
 
 	return true;
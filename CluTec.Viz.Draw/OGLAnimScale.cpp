@@ -162,7 +162,7 @@ bool COGLAnimScale::Apply(COGLBaseElement::EApplyMode eMode, COGLBaseElement::SA
 	}
 	else
 	{
-		glScalef( 1.0f + fFac * m_fX, 1.0f + fFac * m_fY, 1.0f + fFac * m_fZ );
+		rData.xMatrixStack.Scale( 1.0f + fFac * m_fX, 1.0f + fFac * m_fY, 1.0f + fFac * m_fZ );
 	}
 
 	return true;
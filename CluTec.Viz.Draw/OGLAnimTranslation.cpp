@@ -161,7 +161,7 @@ bool COGLAnimTranslation::Apply(COGLBaseElement::EApplyMode eMode, COGLBaseEleme
 	}
 	else
 	{
-		glTranslatef( fFac * m_fX, fFac * m_fY, fFac * m_fZ );
+		rData.xMatrixStack.Translate( fFac * m_fX, fFac * m_fY, fFac * m_fZ );
 	}
 
 	return true;
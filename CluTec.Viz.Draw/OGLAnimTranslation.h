@@ -72,6 +72,9 @@ public:
 
 	bool Apply(COGLBaseElement::EApplyMode eMode, COGLBaseElement::SApplyData &rData);
 
+	// Animated, so that the transformation is not known in advance
+	const SBoundInfo& GetBoundInfo() { return COGLBaseElement::GetBoundInfo(); }
+
 protected:
 	void TellParentContentChanged();
 
@@ -51,21 +51,31 @@ COGLBEReference::COGLBEReference(const COGLBEReference& Ref)
 
 COGLBEReference::~COGLBEReference()
 {
-	if (m_pObjRep)
-		m_pObjRep->DeRegister(*this);
+	_Release();
 }
 
 
 COGLBEReference& COGLBEReference::operator= (const COGLBEReference& Ref)
 {
-	if (m_pObjRep)
-		m_pObjRep->DeRegister(*this);
+	if (m_pObject == Ref.m_pObject)
+	{
+		m_pObjRep = Ref.m_pObjRep;
+		return *this;
+	}
 
-	m_pObject = Ref.m_pObject;
-	m_pObjRep = Ref.m_pObjRep;
+	TObjectPtr pObject = Ref.m_pObject;
+	COGLBERepository* pObjRep = Ref.m_pObjRep;
 
-	if (m_pObjRep)
-		m_pObjRep->Register(*this);
+	// Count the new object first, since Ref may be owned by the object released here
+	if (pObject)
+		pObject->m_lRefCnt.fetch_add(1, std::memory_order_relaxed);
+
+	_Release();
+
+	m_pObject = pObject;
+	m_pObjRep = pObjRep;
+
+	_Track();
 
 	return *this;
 }
@@ -75,15 +85,67 @@ void COGLBEReference::Invalidate()
 {
 	m_pObjRep = 0;
 	m_pObject = 0;
+	m_bTracked = false;
+}
+
+
+void COGLBEReference::_AddRef()
+{
+	if (!m_pObject)
+		return;
+
+	m_pObject->m_lRefCnt.fetch_add(1, std::memory_order_relaxed);
+
+	_Track();
+}
+
+
+void COGLBEReference::_Track()
+{
+	COGLBERepository* pRep = m_pObject ? m_pObject->m_pBERep : 0;
+
+	if (pRep && pRep->IsRefTrackingEnabled())
+	{
+		m_bTracked = pRep->Register(*this);
+	}
+}
+
+
+void COGLBEReference::_Release()
+{
+	if (!m_pObject)
+		return;
+
+	TObjectPtr pObject = m_pObject;
+	COGLBERepository* pRep = pObject->m_pBERep;
+
+	m_pObject = 0;
+
+	if (m_bTracked)
+	{
+		if (pRep)
+			pRep->DeRegister(pObject, *this);
+
+		m_bTracked = false;
+	}
+
+	if (pObject->m_lRefCnt.fetch_sub(1, std::memory_order_acq_rel) == 1)
+	{
+		// The repository may already have been reset
+		if (pRep)
+			pRep->Remove(pObject);
+
+		delete pObject;
+	}
 }
 
 
 size_t COGLBEReference::GetRefCount() const
 {
-	if (!m_pObjRep || !m_pObject)
+	if (!m_pObject)
 		return 0;
 
-	return m_pObjRep->GetRefCount( *this );
+	return size_t(m_pObject->m_lRefCnt.load(std::memory_order_relaxed));
 }
 
 
@@ -95,5 +157,7 @@ bool COGLBEReference::Set(TObjectPtr pObj, COGLBERepository *pObjRep)
 	m_pObject = pObj;
 	m_pObjRep = pObjRep;
 
+	_AddRef();
+
 	return true;
 }
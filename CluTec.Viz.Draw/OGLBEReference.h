@@ -81,11 +81,7 @@
 		/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 		void Clear()
 		{
-			if (m_pObjRep)
-			{
-				m_pObjRep->DeRegister(*this);
-				m_pObject = nullptr;
-			}
+			_Release();
 		}
 
 		/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -114,13 +110,25 @@
 		// Set pointers to zero
 		void Invalidate();
 
+		// Increment the reference count of the object
+		void _AddRef();
+
+		// List this reference in the repository if reference tracking is enabled
+		void _Track();
+
+		// Decrement the reference count of the object and delete it if this was the last reference
+		void _Release();
+
 	protected:
 
 		// Pointer to the actual image
 		TObjectPtr m_pObject;
 
-		// Pointer to the Image Repository where this reference is registered
+		// Pointer to the repository that created the object
 		COGLBERepository* m_pObjRep;
+
+		// True if this reference is listed in the reference map of the repository
+		bool m_bTracked;
 	};
 
 #endif	// !defined(AFX_IMAGEREFERENCE_H__29DD89BE_9839_4381_A23B_049B46BAD391__INCLUDED_)
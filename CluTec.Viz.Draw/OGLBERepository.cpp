@@ -38,7 +38,7 @@
 
 COGLBERepository::COGLBERepository()
 {
-
+	m_bTrackRefs = false;
 }
 
 
@@ -48,27 +48,36 @@ COGLBERepository::~COGLBERepository()
 }
 
 
+//////////////////////////////////////////////////////////////////////
+// Enable or disable the reference lists
+
+void COGLBERepository::EnableRefTracking(bool bEnable)
+{
+	std::lock_guard<std::mutex> xLock(m_xMutex);
+
+	m_bTrackRefs = bEnable;
+	if (!bEnable)
+	{
+		// Tracked references ignore missing entries when they are released
+		m_mapObjToRef.clear();
+	}
+}
+
+
 //////////////////////////////////////////////////////////////////////
 // Register Image Reference
 
 bool COGLBERepository::Register(COGLBEReference& rRef)
 {
-	TObjToRefMap::iterator it_End, it_El;
-
 	if (rRef.m_pObject == 0)
 		return false;
 
-	// Check whether Ref references image that is already in repository
-	if ((it_El = m_mapObjToRef.find(rRef.m_pObject)) == m_mapObjToRef.end())
-	{
-		// if not, then add it to repository
-		m_mapObjToRef[rRef.m_pObject].push_back(&rRef);
-	}
-	else
-	{
-		// If yes, then add Ref to list
-		it_El->second.push_back(&rRef);
-	}
+	std::lock_guard<std::mutex> xLock(m_xMutex);
+
+	if (!m_bTrackRefs)
+		return false;
+
+	m_mapObjToRef[rRef.m_pObject].push_back(&rRef);
 
 	return true;
 }
@@ -77,64 +86,70 @@ bool COGLBERepository::Register(COGLBEReference& rRef)
 //////////////////////////////////////////////////////////////////////
 // DeRegister Image Reference
 
-bool COGLBERepository::DeRegister(COGLBEReference& rRef)
+bool COGLBERepository::DeRegister(TObjectPtr pObject, COGLBEReference& rRef)
 {
-	TObjToRefMap::iterator it_End, it_El;
+	TObjToRefMap::iterator it_El;
 
-	if (rRef.m_pObject == 0)
-		return false;
+	std::lock_guard<std::mutex> xLock(m_xMutex);
 
 	// Check whether Ref references image that is in repository
-	if ((it_El = m_mapObjToRef.find(rRef.m_pObject)) == m_mapObjToRef.end())
+	if ((it_El = m_mapObjToRef.find(pObject)) == m_mapObjToRef.end())
 	{
-		// if not, then there is a problem
+		// Tracking may have been switched off in the meantime
 		return false;
 	}
-	else
-	{
-		// If yes, then find it and remove it
-		TObjRefList &rList = it_El->second;
 
-		// Remove reference from list
-		rList.remove(&rRef);
+	TObjRefList &rList = it_El->second;
 
-		// Check whether there are any references left
-		if (rList.empty())
-		{
-			// if nothing is left then delete image
-			delete it_El->first;
+	// Remove reference from list
+	rList.remove(&rRef);
 
-			// remove the entry we found from the map
-			m_mapObjToRef.erase(it_El);
-		}
+	if (rList.empty())
+	{
+		m_mapObjToRef.erase(it_El);
 	}
 
 	return true;
 }
 
+//////////////////////////////////////////////////////////////////////
+// Add a new element to the object set
+
+void COGLBERepository::Add(TObjectPtr pObject)
+{
+	std::lock_guard<std::mutex> xLock(m_xMutex);
+
+	pObject->m_pBERep = this;
+	m_setObject.insert(pObject);
+}
+
+//////////////////////////////////////////////////////////////////////
+// Remove an element whose last reference was released.
+// The element is deleted by the caller outside of the lock,
+// since its destructor may release further references.
+
+void COGLBERepository::Remove(TObjectPtr pObject)
+{
+	std::lock_guard<std::mutex> xLock(m_xMutex);
+
+	m_setObject.erase(pObject);
+	m_mapObjToRef.erase(pObject);
+}
+
 //////////////////////////////////////////////////////////////////////
 /// Get number of times given object is referenced
 
 size_t COGLBERepository::GetRefCount( const COGLBEReference &rRef )
 {
-	TObjToRefMap::iterator it_End, it_El;
-
-	if (rRef.m_pObject == 0)
-		return 0;
+	return rRef.GetRefCount();
+}
 
-	// Check whether Ref references image that is in repository
-	if ((it_El = m_mapObjToRef.find(rRef.m_pObject)) == m_mapObjToRef.end())
-	{
-		// if not, then there is a problem
+size_t COGLBERepository::GetRefCount( const TObject* pObject )
+{
+	if (!pObject)
 		return 0;
-	}
-	else
-	{
-		// If yes, then find it and get number of times it is referenced
-		TObjRefList &rList = it_El->second;
 
-		return rList.size();
-	}
+	return size_t(pObject->m_lRefCnt.load(std::memory_order_relaxed));
 }
 
 //////////////////////////////////////////////////////////////////////
@@ -144,14 +159,16 @@ COGLBEReference COGLBERepository::New( TObjectPtr pObject )
 {
 	COGLBEReference ObjRef;
 
-	//pObjRef = new COGLBEReference;
-	
 	if (!pObject)
 		return ObjRef;
 
-	ObjRef.Set(pObject, this);
+	// Elements may be passed again to create further references
+	if (pObject->m_pBERep != this)
+	{
+		Add(pObject);
+	}
 
-	Register( ObjRef );
+	ObjRef.Set(pObject, this);
 
 	return ObjRef;
 }
@@ -164,49 +181,35 @@ COGLBEReference COGLBERepository::Copy(const COGLBEReference& rRef)
 {
 	TObjectPtr pObject;
 	COGLBEReference ObjRef;
-	
-	//pObjRef = new COGLBEReference;
 
-	if ( !(pObject = rRef.m_pObject->Copy()) )
+	if ( !rRef.m_pObject || !(pObject = rRef.m_pObject->Copy()) )
 		return ObjRef;
 
-	ObjRef.Set(pObject, this);
+	Add(pObject);
 
-	Register( ObjRef );
+	ObjRef.Set(pObject, this);
 
 	return ObjRef;	
 }
 
 
 //////////////////////////////////////////////////////////////////////
-// Delete all images
+// Detach all elements from the repository.
+// References stay valid and elements are deleted when their last reference is released.
 
 void COGLBERepository::Reset()
 {
-	TObjToRefMap::iterator it_El, it_End;
-	TObjRefList::iterator it_LEl, it_LEnd;
+	TObjectSet::iterator it_El;
 
-	it_End = m_mapObjToRef.end();
+	std::lock_guard<std::mutex> xLock(m_xMutex);
 
-	for( it_El = m_mapObjToRef.begin();
-		 it_El != it_End;
+	for( it_El = m_setObject.begin();
+		 it_El != m_setObject.end();
 		 ++it_El)
 	{
-		TObjRefList rList = it_El->second;
-		it_LEnd = rList.end();
-
-		// Invalidate all references
-		for( it_LEl = rList.begin();
-			 it_LEl != it_LEnd;
-			 ++it_LEl)
-		{
-			(*it_LEl)->Invalidate();
-		}
-
-		delete it_El->first;
+		(*it_El)->m_pBERep = 0;
 	}
 
-	// Delete the whole map
-	m_mapObjToRef.erase(m_mapObjToRef.begin(), m_mapObjToRef.end());
+	m_setObject.clear();
+	m_mapObjToRef.clear();
 }
-
@@ -33,6 +33,8 @@
 
 #include <list>
 #include <map>
+#include <set>
+#include <mutex>
 
 //#ifdef _DEBUG
 //#	define new _NEW_CRT
@@ -42,10 +44,15 @@
 
 using std::list;
 using std::map;
+using std::set;
 
 class COGLBaseElement;
 class COGLBEReference;
 
+// Elements count their references themselves, so copying a reference only increments
+// the counter of the element. The repository keeps the set of elements it created,
+// which only changes when an element is created or deleted.
+// For debugging, the repository can in addition keep a list of all references per element.
 class CLUDRAW_API COGLBERepository
 {
 public:
@@ -56,6 +63,7 @@ public:
 	typedef TObject* TObjectPtr;
 	typedef list<COGLBEReference*> TObjRefList;
 	typedef map<TObjectPtr, TObjRefList> TObjToRefMap;
+	typedef set<TObjectPtr> TObjectSet;
 
 public:
 	COGLBERepository();
@@ -67,19 +75,39 @@ public:
 	// Create a new image which is a copy of the one given
 	COGLBEReference Copy(const COGLBEReference& rRef);
 
-	// Delete all images
+	// Detach all elements from the repository. Elements are deleted when their last reference is released.
 	void Reset();
 
 	size_t GetRefCount( const COGLBEReference &rRef );
+	static size_t GetRefCount( const TObject* pObject );
 
+	// Keep a list of references per element. Only references created while enabled are listed.
+	void EnableRefTracking(bool bEnable);
+	bool IsRefTrackingEnabled() const { return m_bTrackRefs; }
+
+	// Lock the repository while accessing the object set or the reference map
+	void Lock() { m_xMutex.lock(); }
+	void Unlock() { m_xMutex.unlock(); }
+
+	const TObjectSet* GetObjectSet() { return &m_setObject; }
 	const TObjToRefMap* GetObjToRefMap() { return &m_mapObjToRef; }
 
 protected:
 	bool Register(COGLBEReference& rRef);
-	bool DeRegister(COGLBEReference& rRef);
+	bool DeRegister(TObjectPtr pObject, COGLBEReference& rRef);
+
+	// Add a new element to the object set
+	void Add(TObjectPtr pObject);
+	// Remove an element whose last reference was released
+	void Remove(TObjectPtr pObject);
 
 protected:
+	TObjectSet m_setObject;
 	TObjToRefMap m_mapObjToRef;
+
+	bool m_bTrackRefs;
+
+	std::mutex m_xMutex;
 };
 
 //CLUDRAW_EXT template class CLUDRAW_API std::list<COGLBEReference*>;
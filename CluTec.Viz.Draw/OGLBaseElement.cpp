@@ -47,6 +47,9 @@ COGLBaseElement::COGLBaseElement()
 	m_sTypeName = "BaseElement";
 
 	m_uUID = ++::sm_uLastUID;
+
+	m_lRefCnt = 0;
+	m_pBERep  = 0;
 }
 
 COGLBaseElement::COGLBaseElement(const string sName)
@@ -55,6 +58,9 @@ COGLBaseElement::COGLBaseElement(const string sName)
 
 	m_uUID = ++::sm_uLastUID;
 	m_sName = sName;
+
+	m_lRefCnt = 0;
+	m_pBERep  = 0;
 }
 
 COGLBaseElement::~COGLBaseElement()
@@ -64,6 +70,10 @@ COGLBaseElement::~COGLBaseElement()
 
 COGLBaseElement::COGLBaseElement(const COGLBaseElement& rBaseElement)
 {
+	// A copy is a new element without references
+	m_lRefCnt = 0;
+	m_pBERep  = 0;
+
 	*this = rBaseElement;
 }
 
@@ -107,3 +117,47 @@ bool COGLBaseElement::RemoveParent( COGLBaseElement* pParent )
 
 	return false;
 }
+
+
+//////////////////////////////////////////////////////////////////////
+/// Bound info of elements whose extent is not known
+
+const COGLBaseElement::SBoundInfo& COGLBaseElement::GetBoundInfo()
+{
+	struct SUnbounded : public SBoundInfo
+	{
+		SUnbounded() { Reset(false, true); }
+	};
+
+	static const SUnbounded s_xInfo;
+	return s_xInfo;
+}
+
+//////////////////////////////////////////////////////////////////////
+/// Bound info of elements that only change state
+
+const COGLBaseElement::SBoundInfo& COGLBaseElement::GetStateBoundInfo()
+{
+	struct SStateOnly : public SBoundInfo
+	{
+		SStateOnly() { Reset(true, true); }
+	};
+
+	static const SStateOnly s_xInfo;
+	return s_xInfo;
+}
+
+//////////////////////////////////////////////////////////////////////
+/// Invalidate bounds of parents
+
+void COGLBaseElement::InvalidateParentBounds()
+{
+	list<COGLBaseElement*>::iterator itEl;
+
+	for (itEl = m_listParent.begin();
+		itEl != m_listParent.end();
+		++itEl)
+	{
+		(*itEl)->InvalidateBounds();
+	}
+}
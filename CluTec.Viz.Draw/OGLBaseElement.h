@@ -41,13 +41,17 @@
 #include <map>
 #include <list>
 #include <vector>
+#include <atomic>
 
 #include "OGLBEReference.h"
 //#include "CluTec.Viz.ImgRepo/CvCoreImgRepo.h"
 #include "MatrixStack.h"
+#include "OGLBoundingBox.h"
 
 	using namespace std;
 
+	class COGLPickBVH;
+
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 /// <summary>
 /// 	The base class of all OpenGL elements.
@@ -68,6 +72,84 @@
 			PICK = 1
 		};
 
+		/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// <summary>
+		/// 	Bounds of the geometry an element draws, which are used for view frustum culling. Applying an element may also
+		/// 	change the model view matrix or other state for the elements that follow it in a list.
+		/// </summary>
+		/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		struct SBoundInfo
+		{
+			SBoundInfo()
+			{
+				Reset(true, false);
+			}
+
+			void Reset(bool bIsBounded, bool bChangesState)
+			{
+				xBox.Reset();
+				uGeoCnt       = 0;
+				bBounded      = bIsBounded;
+				bHasState     = bChangesState;
+				bHasTransform = false;
+				COGLBoundingBox::Identity(pdTransform);
+			}
+
+			// Bounding box of the drawn geometry in the frame the element is applied in
+			COGLBoundingBox xBox;
+			// Number of geometry elements within the box
+			unsigned uGeoCnt;
+			// If false, the extent of the drawn geometry is not known and the element is never culled
+			bool bBounded;
+			// True if the element changes state other than the model view matrix that following elements depend on
+			bool bHasState;
+			// True if the element multiplies the model view matrix by pdTransform for the following elements
+			bool bHasTransform;
+			double pdTransform[16];
+		};
+
+		/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// <summary>
+		/// 	Counters of view frustum culling.
+		/// </summary>
+		/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		struct SCullStats
+		{
+			SCullStats()
+			{
+				Reset();
+			}
+
+			void Reset()
+			{
+				uTestCnt = 0;
+				uCullCnt = 0;
+				uDrawCnt = 0;
+			}
+
+			// Number of bounding boxes tested against the view frustum
+			unsigned uTestCnt;
+			// Number of geometry elements that were not drawn since they are outside of the view frustum
+			unsigned uCullCnt;
+			// Number of geometry elements drawn
+			unsigned uDrawCnt;
+		};
+
+		/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// <summary>
+		/// 	Values that represent the culling state of the elements that are currently applied.
+		/// </summary>
+		/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		enum ECullState
+		{
+			// Elements have to be tested against the view frustum
+			CULL_TEST = 0,
+			// Elements are inside of the view frustum
+			CULL_INSIDE,
+			// Elements are outside of the view frustum and only their state changes are applied
+			CULL_OUTSIDE
+		};
+
 		/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 		/// <summary>
 		/// 	An apply data.
@@ -129,6 +211,11 @@
 				pfCurColor[3] = 1.0f;
 
 				pCurRenderTarget = nullptr;
+				pPickBVH         = nullptr;
+				uPickBVHNameBase = 0;
+
+				bCullEnable = true;
+				eCullState  = CULL_TEST;
 			}
 
 			/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -444,6 +531,12 @@
 			// The current render target
 			COGLBaseElement* pCurRenderTarget;
 
+			// If not null, vertex lists add themselves to this pick hierarchy while drawing.
+			// Pick names are then also pushed in drawing mode.
+			COGLPickBVH* pPickBVH;
+			// Index into the pick name stack where the name stacks stored in pPickBVH start.
+			uint uPickBVHNameBase;
+
 			// The currently set color
 			float pfCurColor[4];
 
@@ -452,6 +545,14 @@
 
 			/// <summary> Stack of matrices. </summary>
 			Clu::CMatrixStack xMatrixStack;
+
+			// If true, elements outside of the view frustum are not drawn
+			bool bCullEnable;
+			ECullState eCullState;
+
+			// Culling counters of the current and of the previous frame
+			SCullStats xCullStats;
+			SCullStats xCullFrameStats;
 		};
 
 	public:
@@ -485,6 +586,20 @@
 		bool AddParent(COGLBaseElement* pParent);
 		bool RemoveParent(COGLBaseElement* pParent);
 
+		// Bounds of the geometry drawn by this element. Elements that do not override this function are never culled.
+		virtual const SBoundInfo& GetBoundInfo();
+
+		// Called by a child element whose bounds changed
+		virtual void InvalidateBounds() {}
+
+	protected:
+
+		// Invalidates the bounds cached by all lists that contain this element
+		void InvalidateParentBounds();
+
+		// Bound info of elements that do not draw anything, but change state
+		static const SBoundInfo& GetStateBoundInfo();
+
 	protected:
 
 		string  m_sName;	// Human readable name (not necessarily unique)
@@ -495,7 +610,15 @@
 
 	private:
 
+		friend class COGLBEReference;
+		friend class COGLBERepository;
+
 		uint    m_uUID;			// Unique ID for picking
+
+		// Number of references to this element. Only changed by COGLBEReference.
+		std::atomic<long> m_lRefCnt;
+		// Repository that created this element. Zero if the element is not managed or the repository was reset.
+		COGLBERepository* m_pBERep;
 		//static uint sm_uLastUID;	// Last used unique ID
 	};
 
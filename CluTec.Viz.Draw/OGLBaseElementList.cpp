@@ -45,6 +45,10 @@ COGLBaseElementList::COGLBaseElementList()
 
 	m_bContentChanged         = false;
 	m_bNeedContentChangedInfo = false;
+
+	m_bBoundInfoValid    = false;
+	m_iBoundRepeatCnt    = 1;
+	m_bBoundRestoreFrame = true;
 }
 
 COGLBaseElementList::COGLBaseElementList(const COGLBaseElementList& rList)
@@ -54,6 +58,10 @@ COGLBaseElementList::COGLBaseElementList(const COGLBaseElementList& rList)
 	m_bContentChanged         = false;
 	m_bNeedContentChangedInfo = false;
 
+	m_bBoundInfoValid    = false;
+	m_iBoundRepeatCnt    = 1;
+	m_bBoundRestoreFrame = true;
+
 	*this = rList;
 }
 
@@ -68,6 +76,8 @@ COGLBaseElementList& COGLBaseElementList::operator=(const COGLBaseElementList& r
 	m_bContentChanged         = false;
 	m_bNeedContentChangedInfo = rList.m_bNeedContentChangedInfo;
 
+	InvalidateBounds();
+
 	// Set also this list as parent of elements
 	list<COGLBEReference>::iterator itEl;
 
@@ -115,6 +125,12 @@ void COGLBaseElementList::Reset()
 
 void COGLBaseElementList::SetContentChanged(bool bVal, bool bTellParents, bool bTellChildren)
 {
+	// The bounds may have changed with the content, independent of whether the content changed info is needed
+	if (bVal && bTellParents)
+	{
+		InvalidateBounds();
+	}
+
 	// Only distribute content changed info if this list actually needs it.
 	if (!m_bNeedContentChangedInfo)
 	{
@@ -172,7 +188,10 @@ bool COGLBaseElementList::Apply(COGLBaseElement::EApplyMode eMode, COGLBaseEleme
 		// Save all matrices
 		rData.xMatrixStack.PushAll();
 
-		if (eMode == COGLBaseElement::PICK)
+		// Pick names are also needed in drawing mode if a pick hierarchy is updated
+		bool bPushPickName = (eMode == COGLBaseElement::PICK) || (rData.pPickBVH != nullptr);
+
+		if (bPushPickName)
 		{
 			rData.PushPickName(GetUID());
 		}
@@ -180,7 +199,7 @@ bool COGLBaseElementList::Apply(COGLBaseElement::EApplyMode eMode, COGLBaseEleme
 		// Apply list. Returns false if one element in list couldn't not be applied
 		bool bApplied = COGLBaseElementList::ApplyList(m_listElement, eMode, rData);
 
-		if (eMode == COGLBaseElement::PICK)
+		if (bPushPickName)
 		{
 			rData.PopPickName();
 			rData.PopPickName();
@@ -213,8 +232,13 @@ bool COGLBaseElementList::ApplyList(const list<COGLBEReference>& xList, COGLBase
 				// Get object from reference
 				const COGLBEReference::TObjectPtr xRefObject = (COGLBEReference::TObjectPtr) *itEl;
 
+				// Elements are only culled if the list is not known to be inside of the view frustum. A pick hierarchy and
+				// a display list that are recorded need all elements, and an active shader may move the vertices.
+				bool bCull = rData.bCullEnable && (rData.eCullState != COGLBaseElement::CULL_INSIDE)
+					     && !rData.pPickBVH && !rData.bDispListRecord && !rData.pCurShader;
+
 				// Apply object
-				if (xRefObject->Apply(eMode, rData))
+				if (bCull ? ApplyCulled(*xRefObject, eMode, rData) : xRefObject->Apply(eMode, rData))
 				{
 					// Continue to next object if apply was successfully
 					continue;
@@ -233,6 +257,139 @@ bool COGLBaseElementList::ApplyList(const list<COGLBEReference>& xList, COGLBase
 	}
 }
 
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+bool COGLBaseElementList::ApplyCulled(COGLBaseElement& rElement, COGLBaseElement::EApplyMode eMode, COGLBaseElement::SApplyData& rData)
+{
+	const SBoundInfo& xInfo = rElement.GetBoundInfo();
+
+	if (!xInfo.bBounded || xInfo.xBox.IsEmpty())
+	{
+		return rElement.Apply(eMode, rData);
+	}
+
+	ECullState ePrevState = rData.eCullState;
+	COGLBoundingBox::EClip eClip = COGLBoundingBox::OUTSIDE;
+
+	if (ePrevState == CULL_TEST)
+	{
+		double pdProj[16], pdFrame[16], pdClip[16];
+
+		rData.xMatrixStack.GetMatrix(Clu::CMatrixStack::Projection, pdProj);
+		rData.xMatrixStack.GetMatrix(Clu::CMatrixStack::ModelView, pdFrame);
+		COGLBoundingBox::MultMatrix(pdClip, pdProj, pdFrame);
+
+		eClip = xInfo.xBox.Clip(pdClip);
+		++rData.xCullStats.uTestCnt;
+
+		if (eClip == COGLBoundingBox::INTERSECT)
+		{
+			return rElement.Apply(eMode, rData);
+		}
+
+		if (eClip == COGLBoundingBox::OUTSIDE)
+		{
+			rData.xCullStats.uCullCnt += xInfo.uGeoCnt;
+		}
+	}
+
+	// Elements outside of the view frustum are only applied for their effect on the following elements
+	if ((eClip == COGLBoundingBox::OUTSIDE) && !xInfo.bHasState && !xInfo.bHasTransform)
+	{
+		return true;
+	}
+
+	rData.eCullState = (eClip == COGLBoundingBox::INSIDE ? CULL_INSIDE : CULL_OUTSIDE);
+	bool bApplied = rElement.Apply(eMode, rData);
+	rData.eCullState = ePrevState;
+
+	return bApplied;
+}
+
+//////////////////////////////////////////////////////////////////////
+/// Bounds of list
+
+const COGLBaseElement::SBoundInfo& COGLBaseElementList::GetBoundInfo()
+{
+	if (!m_bBoundInfoValid || (m_iBoundRepeatCnt != 1) || !m_bBoundRestoreFrame)
+	{
+		// The matrices are restored after applying a list
+		EvalBoundInfo(1, true);
+	}
+
+	return m_xBoundInfo;
+}
+
+//////////////////////////////////////////////////////////////////////
+/// Invalidate bounds of list and all its parents
+
+void COGLBaseElementList::InvalidateBounds()
+{
+	if (m_bBoundInfoValid)
+	{
+		m_bBoundInfoValid = false;
+		InvalidateParentBounds();
+	}
+}
+
+//////////////////////////////////////////////////////////////////////
+/// Evaluate bounds of elements
+
+void COGLBaseElementList::EvalBoundInfo(int iRepeatCnt, bool bRestoreFrame)
+{
+	SBoundInfo& rInfo = m_xBoundInfo;
+
+	rInfo.Reset(true, false);
+	m_bBoundInfoValid    = true;
+	m_iBoundRepeatCnt    = iRepeatCnt;
+	m_bBoundRestoreFrame = bRestoreFrame;
+
+	// Transformation from the frame of the current element to the frame of the list
+	double pdFrame[16], pdProd[16];
+	bool bIdentity = true;
+
+	COGLBoundingBox::Identity(pdFrame);
+
+	for (int iRepeat = 0; iRepeat < iRepeatCnt; ++iRepeat)
+	{
+		list<COGLBEReference>::iterator itEl;
+
+		for (itEl = m_listElement.begin();
+		     itEl != m_listElement.end();
+		     ++itEl)
+		{
+			if (!itEl->IsValid())
+			{
+				continue;
+			}
+
+			const SBoundInfo& xInfo = (*itEl)->GetBoundInfo();
+
+			if (!xInfo.bBounded)
+			{
+				rInfo.Reset(false, true);
+				return;
+			}
+
+			rInfo.xBox.AddBox(xInfo.xBox, (bIdentity ? nullptr : pdFrame));
+			rInfo.uGeoCnt   += xInfo.uGeoCnt;
+			rInfo.bHasState |= xInfo.bHasState;
+
+			if (xInfo.bHasTransform)
+			{
+				COGLBoundingBox::MultMatrix(pdProd, pdFrame, xInfo.pdTransform);
+				memcpy(pdFrame, pdProd, 16 * sizeof(double));
+				bIdentity = false;
+			}
+		}
+	}
+
+	if (!bRestoreFrame && !bIdentity)
+	{
+		rInfo.bHasTransform = true;
+		memcpy(rInfo.pdTransform, pdFrame, 16 * sizeof(double));
+	}
+}
+
 //////////////////////////////////////////////////////////////////////
 /// Tell all children that they have to notify changes
 
@@ -269,6 +426,7 @@ bool COGLBaseElementList::Add(const COGLBEReference& rElement)
 
 	m_listElement.push_back(rElement);
 	m_mapIDtoElement[rElement->GetUID()] = rElement;
+	InvalidateBounds();
 
 	if (rElement->GetName().size())
 	{
@@ -323,6 +481,7 @@ bool COGLBaseElementList::Delete(const COGLBEReference& rElement)
 	(*itEl)->RemoveParent((COGLBaseElement*) this);
 
 	m_listElement.erase(itEl);
+	InvalidateBounds();
 
 	map<uint, COGLBEReference >::iterator itMapID;
 	map<string, vector<uint> >::iterator itMapName;
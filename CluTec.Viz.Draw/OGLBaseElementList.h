@@ -103,6 +103,34 @@
 		/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 		static bool ApplyList(const list<COGLBEReference>& xList, COGLBaseElement::EApplyMode eMode, COGLBaseElement::SApplyData& rData);
 
+		// Bounds of all elements in the list. The bounds are cached until an element is added or deleted, or a child tells that its bounds changed.
+		virtual const SBoundInfo& GetBoundInfo();
+
+		virtual void InvalidateBounds();
+
+	protected:
+
+		/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// \brief
+		/// 	Evaluates the bounds of the element list into m_xBoundInfo.
+		///
+		/// \param	iRepeatCnt	 	The number of times the list is applied.
+		/// \param	bRestoreFrame	True if the model view matrix is restored after applying the list.
+		/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		void EvalBoundInfo(int iRepeatCnt, bool bRestoreFrame);
+
+		/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// \brief
+		/// 	Applies an element if it is not outside of the view frustum.
+		///
+		/// \param [in,out]	rElement	The element.
+		/// \param	eMode		 	The apply mode.
+		/// \param [in,out]	rData	The apply data.
+		///
+		/// \return True if it succeeds, false if the element could not be applied.
+		/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		static bool ApplyCulled(COGLBaseElement& rElement, COGLBaseElement::EApplyMode eMode, COGLBaseElement::SApplyData& rData);
+
 	protected:
 
 		list<COGLBEReference> m_listElement;
@@ -111,6 +139,12 @@
 
 		bool m_bContentChanged;
 		bool m_bNeedContentChangedInfo;
+
+		// Cached bounds and the parameters they were evaluated for
+		SBoundInfo m_xBoundInfo;
+		bool m_bBoundInfoValid;
+		int m_iBoundRepeatCnt;
+		bool m_bBoundRestoreFrame;
 	};
 
 #endif	// !defined(AFX_OGLBASEELEMENTLIST_H__5746B287_573C_4800_9DE1_B801F31D0EB4__INCLUDED_)
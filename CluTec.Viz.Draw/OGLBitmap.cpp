@@ -165,8 +165,8 @@ bool COGLBitmap::Apply(COGLBaseElement::EApplyMode eMode, COGLBaseElement::SAppl
 	m_Image->GetType(iImgType, iDataType, iBytesPerPixel);
 
 	glGetIntegerv(GL_VIEWPORT, piViewport);
-	glGetDoublev(GL_MODELVIEW_MATRIX, pdModelView);
-	glGetDoublev(GL_PROJECTION_MATRIX, pdProjection);
+	rData.xMatrixStack.GetMatrix(Clu::CMatrixStack::ModelView, pdModelView);
+	rData.xMatrixStack.GetMatrix(Clu::CMatrixStack::Projection, pdProjection);
 
 	glGetFloatv(GL_ZOOM_X, &fScaleX);
 	glGetFloatv(GL_ZOOM_Y, &fScaleY);
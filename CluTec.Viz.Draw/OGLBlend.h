@@ -97,6 +97,12 @@ public:
 	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 	bool Apply(COGLBaseElement::EApplyMode eMode, COGLBaseElement::SApplyData& rData);
 
+	// True if blending is switched off
+	bool IsDefault() const { return m_bIsDefault; }
+
+	// Does not draw anything, but changes state
+	const SBoundInfo& GetBoundInfo() { return GetStateBoundInfo(); }
+
 protected:
 
 	unsigned m_uBlendModeDst;
@@ -0,0 +1,229 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// project:   CluTec.Viz.Draw
+// file:      OGLBoundingBox.cpp
+//
+// summary:   Implements the bounding box used for view frustum culling
+//
+//            Copyright (c) 2019 by Christian Perwass.
+//
+//            This file is part of the CluTecLib library.
+//
+//            The CluTecLib library is free software: you can redistribute it and / or modify
+//            it under the terms of the GNU Lesser General Public License as published by
+//            the Free Software Foundation, either version 3 of the License, or
+//            (at your option) any later version.
+//
+//            The CluTecLib library is distributed in the hope that it will be useful,
+//            but WITHOUT ANY WARRANTY; without even the implied warranty of
+//            MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//            GNU Lesser General Public License for more details.
+//
+//            You should have received a copy of the GNU Lesser General Public License
+//            along with the CluTecLib library.
+//            If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "stdafx.h"
+#include "OGLBoundingBox.h"
+
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+
+//////////////////////////////////////////////////////////////////////
+void COGLBoundingBox::Reset()
+{
+	m_pfMin[0] = m_pfMin[1] = m_pfMin[2] = FLT_MAX;
+	m_pfMax[0] = m_pfMax[1] = m_pfMax[2] = -FLT_MAX;
+}
+
+//////////////////////////////////////////////////////////////////////
+void COGLBoundingBox::AddPoint(float fX, float fY, float fZ)
+{
+	if (fX < m_pfMin[0]) { m_pfMin[0] = fX; }
+	if (fX > m_pfMax[0]) { m_pfMax[0] = fX; }
+	if (fY < m_pfMin[1]) { m_pfMin[1] = fY; }
+	if (fY > m_pfMax[1]) { m_pfMax[1] = fY; }
+	if (fZ < m_pfMin[2]) { m_pfMin[2] = fZ; }
+	if (fZ > m_pfMax[2]) { m_pfMax[2] = fZ; }
+}
+
+//////////////////////////////////////////////////////////////////////
+void COGLBoundingBox::AddPoints(const void* pvPoints, size_t nStride, size_t nCnt)
+{
+	const unsigned char* pubPoint = (const unsigned char*) pvPoints;
+
+	for (size_t nIdx = 0; nIdx < nCnt; ++nIdx, pubPoint += nStride)
+	{
+		const float* pfPoint = (const float*) pubPoint;
+		AddPoint(pfPoint[0], pfPoint[1], pfPoint[2]);
+	}
+}
+
+//////////////////////////////////////////////////////////////////////
+void COGLBoundingBox::AddBox(const COGLBoundingBox& rBox, const double* pdMat)
+{
+	if (rBox.IsEmpty())
+	{
+		return;
+	}
+
+	if (!pdMat)
+	{
+		AddPoint(rBox.m_pfMin[0], rBox.m_pfMin[1], rBox.m_pfMin[2]);
+		AddPoint(rBox.m_pfMax[0], rBox.m_pfMax[1], rBox.m_pfMax[2]);
+		return;
+	}
+
+	// For each axis of the target frame the extreme values are attained at the box corners,
+	// which can be found separately for each column of the matrix.
+	for (int iRow = 0; iRow < 3; ++iRow)
+	{
+		double dMin = pdMat[12 + iRow];
+		double dMax = dMin;
+
+		for (int iCol = 0; iCol < 3; ++iCol)
+		{
+			double dA = pdMat[4 * iCol + iRow] * double(rBox.m_pfMin[iCol]);
+			double dB = pdMat[4 * iCol + iRow] * double(rBox.m_pfMax[iCol]);
+
+			if (dA < dB)
+			{
+				dMin += dA;
+				dMax += dB;
+			}
+			else
+			{
+				dMin += dB;
+				dMax += dA;
+			}
+		}
+
+		if (float(dMin) < m_pfMin[iRow]) { m_pfMin[iRow] = float(dMin); }
+		if (float(dMax) > m_pfMax[iRow]) { m_pfMax[iRow] = float(dMax); }
+	}
+}
+
+//////////////////////////////////////////////////////////////////////
+COGLBoundingBox::EClip COGLBoundingBox::Clip(const double* pdClipMat) const
+{
+	if (IsEmpty())
+	{
+		return OUTSIDE;
+	}
+
+	// Bit i of the codes is set if a corner lies outside of clip plane i.
+	// The planes are -w <= x, x <= w, -w <= y, y <= w, -w <= z, z <= w.
+	unsigned uAllOutside = 0x3F;
+	unsigned uAnyOutside = 0;
+
+	for (int iCorner = 0; iCorner < 8; ++iCorner)
+	{
+		double dX = double((iCorner & 1) ? m_pfMax[0] : m_pfMin[0]);
+		double dY = double((iCorner & 2) ? m_pfMax[1] : m_pfMin[1]);
+		double dZ = double((iCorner & 4) ? m_pfMax[2] : m_pfMin[2]);
+
+		double pdC[4];
+		for (int iRow = 0; iRow < 4; ++iRow)
+		{
+			pdC[iRow] = pdClipMat[iRow] * dX + pdClipMat[4 + iRow] * dY + pdClipMat[8 + iRow] * dZ + pdClipMat[12 + iRow];
+		}
+
+		unsigned uCode = 0;
+		for (int iAxis = 0; iAxis < 3; ++iAxis)
+		{
+			if (pdC[iAxis] < -pdC[3]) { uCode |= (1 << (2 * iAxis)); }
+			if (pdC[iAxis] > pdC[3]) { uCode |= (2 << (2 * iAxis)); }
+		}
+
+		uAllOutside &= uCode;
+		uAnyOutside |= uCode;
+	}
+
+	if (uAllOutside)
+	{
+		return OUTSIDE;
+	}
+
+	return (uAnyOutside ? INTERSECT : INSIDE);
+}
+
+//////////////////////////////////////////////////////////////////////
+bool COGLBoundingBox::IsAffine(const double* pdMat)
+{
+	return pdMat[3] == 0.0 && pdMat[7] == 0.0 && pdMat[11] == 0.0 && pdMat[15] == 1.0;
+}
+
+//////////////////////////////////////////////////////////////////////
+void COGLBoundingBox::MultMatrix(double* pdRes, const double* pdA, const double* pdB)
+{
+	for (int iCol = 0; iCol < 4; ++iCol)
+	{
+		for (int iRow = 0; iRow < 4; ++iRow)
+		{
+			pdRes[4 * iCol + iRow] = pdA[iRow] * pdB[4 * iCol] + pdA[4 + iRow] * pdB[4 * iCol + 1]
+						 + pdA[8 + iRow] * pdB[4 * iCol + 2] + pdA[12 + iRow] * pdB[4 * iCol + 3];
+		}
+	}
+}
+
+//////////////////////////////////////////////////////////////////////
+void COGLBoundingBox::Identity(double* pdMat)
+{
+	for (int iIdx = 0; iIdx < 16; ++iIdx)
+	{
+		pdMat[iIdx] = ((iIdx % 5) == 0 ? 1.0 : 0.0);
+	}
+}
+
+//////////////////////////////////////////////////////////////////////
+void COGLBoundingBox::Translate(double* pdMat, double dX, double dY, double dZ)
+{
+	for (int iRow = 0; iRow < 4; ++iRow)
+	{
+		pdMat[12 + iRow] += pdMat[iRow] * dX + pdMat[4 + iRow] * dY + pdMat[8 + iRow] * dZ;
+	}
+}
+
+//////////////////////////////////////////////////////////////////////
+void COGLBoundingBox::Rotate(double* pdMat, double dAngle, double dX, double dY, double dZ)
+{
+	double dLen = sqrt(dX * dX + dY * dY + dZ * dZ);
+	if (dLen == 0.0)
+	{
+		return;
+	}
+
+	dX /= dLen;
+	dY /= dLen;
+	dZ /= dLen;
+
+	double dRad = dAngle * 3.14159265358979323846 / 180.0;
+	double dC   = cos(dRad);
+	double dS   = sin(dRad);
+	double dT   = 1.0 - dC;
+
+	const double pdRot[16] =
+	{
+		dX * dX * dT + dC, dY * dX * dT + dZ * dS, dX * dZ * dT - dY * dS, 0,
+		dX * dY * dT - dZ * dS, dY * dY * dT + dC, dY * dZ * dT + dX * dS, 0,
+		dX * dZ * dT + dY * dS, dY * dZ * dT - dX * dS, dZ * dZ * dT + dC, 0,
+		0, 0, 0, 1
+	};
+
+	double pdRes[16];
+	MultMatrix(pdRes, pdMat, pdRot);
+	memcpy(pdMat, pdRes, 16 * sizeof(double));
+}
+
+//////////////////////////////////////////////////////////////////////
+void COGLBoundingBox::Scale(double* pdMat, double dX, double dY, double dZ)
+{
+	for (int iRow = 0; iRow < 4; ++iRow)
+	{
+		pdMat[iRow]     *= dX;
+		pdMat[4 + iRow] *= dY;
+		pdMat[8 + iRow] *= dZ;
+	}
+}
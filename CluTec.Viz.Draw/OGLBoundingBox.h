@@ -0,0 +1,110 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// project:   CluTec.Viz.Draw
+// file:      OGLBoundingBox.h
+//
+// summary:   Declares the bounding box used for view frustum culling
+//
+//            Copyright (c) 2019 by Christian Perwass.
+//
+//            This file is part of the CluTecLib library.
+//
+//            The CluTecLib library is free software: you can redistribute it and / or modify
+//            it under the terms of the GNU Lesser General Public License as published by
+//            the Free Software Foundation, either version 3 of the License, or
+//            (at your option) any later version.
+//
+//            The CluTecLib library is distributed in the hope that it will be useful,
+//            but WITHOUT ANY WARRANTY; without even the implied warranty of
+//            MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//            GNU Lesser General Public License for more details.
+//
+//            You should have received a copy of the GNU Lesser General Public License
+//            along with the CluTecLib library.
+//            If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <stddef.h>
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// <summary>
+/// 	Axis aligned bounding box of geometry, which can be transformed into other frames and tested against a view
+/// 	frustum. Matrices are OpenGL style column-major 4x4 matrices. The class does not call any OpenGL functions.
+/// </summary>
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+class CLUDRAW_API COGLBoundingBox
+{
+public:
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	/// <summary>
+	/// 	Results of a view frustum test.
+	/// </summary>
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	enum EClip
+	{
+		OUTSIDE = 0,
+		INTERSECT,
+		INSIDE
+	};
+
+public:
+
+	COGLBoundingBox() { Reset(); }
+
+	// Make the box empty
+	void Reset();
+
+	bool IsEmpty() const { return m_pfMin[0] > m_pfMax[0]; }
+
+	const float* GetMin() const { return m_pfMin; }
+	const float* GetMax() const { return m_pfMax; }
+
+	// Extend the box by a point
+	void AddPoint(float fX, float fY, float fZ);
+
+	// Extend the box by nCnt points of three floats with nStride bytes between consecutive points
+	void AddPoints(const void* pvPoints, size_t nStride, size_t nCnt);
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	/// <summary>
+	/// 	Extends the box by another box that is transformed with the given affine matrix.
+	/// </summary>
+	///
+	/// <param name="rBox">  The box. </param>
+	/// <param name="pdMat"> The transformation from the frame of rBox into the frame of this box, or nullptr for the identity. </param>
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	void AddBox(const COGLBoundingBox& rBox, const double* pdMat = nullptr);
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	/// <summary>
+	/// 	Tests the box against the view frustum. A box is only reported as outside if all its corners lie outside of the
+	/// 	same clip plane, so that the test is conservative.
+	/// </summary>
+	///
+	/// <param name="pdClipMat"> The matrix that maps the frame of the box to clip coordinates, i.e. projection times model view. </param>
+	///
+	/// <returns> Whether the box is outside, inside or intersects the view frustum. </returns>
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	EClip Clip(const double* pdClipMat) const;
+
+	// Returns true if the matrix is affine, i.e. its last row is (0, 0, 0, 1)
+	static bool IsAffine(const double* pdMat);
+
+	// pdRes = pdA * pdB. pdRes must not be one of the operands.
+	static void MultMatrix(double* pdRes, const double* pdA, const double* pdB);
+
+	static void Identity(double* pdMat);
+
+	// Multiply pdMat from the right with a transformation in the same way as glTranslate, glRotate and glScale
+	static void Translate(double* pdMat, double dX, double dY, double dZ);
+	static void Rotate(double* pdMat, double dAngle, double dX, double dY, double dZ);
+	static void Scale(double* pdMat, double dX, double dY, double dZ);
+
+protected:
+
+	float m_pfMin[3];
+	float m_pfMax[3];
+};
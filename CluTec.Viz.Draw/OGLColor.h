@@ -102,6 +102,9 @@ public:
 
 	bool Apply(COGLBaseElement::EApplyMode eMode, COGLBaseElement::SApplyData &rData);
 
+	// Does not draw anything, but changes state
+	const SBoundInfo& GetBoundInfo() { return GetStateBoundInfo(); }
+
 	float* Data() { return m_pfCol; }
 	const float* Data() const { return m_pfCol; }
 
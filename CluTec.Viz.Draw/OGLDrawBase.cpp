@@ -53,6 +53,19 @@
 //#include "OGLObjWireSphere.h"
 #include "CluTec.Viz.Fltk\Fl_math.h"
 
+// Key of the mesh shared by the instances of a batch
+enum EInstanceMesh
+{
+	INST_MESH_SPHERE = 1,
+	INST_MESH_CONE,
+	INST_MESH_CYLINDER
+};
+
+static inline unsigned InstanceMeshKey(EInstanceMesh eMesh, unsigned uFlags, unsigned uParam)
+{
+	return (unsigned(eMesh) << 28) | ((uFlags & 0xFF) << 20) | (uParam & 0xFFFFF);
+}
+
 //////////////////////////////////////////////////////////////////////
 // Konstruktion/Destruktion
 //////////////////////////////////////////////////////////////////////
@@ -87,6 +100,12 @@ COGLDrawBase::COGLDrawBase()
 
 	m_iSphereDetailLevel = 1;
 
+	m_bUseInstanceBatch      = false;
+	m_bInstanceBatchColorSet = false;
+	m_pInstanceBatchScene    = 0;
+	m_uInstanceBatchCnt      = 0;
+	m_uInstanceCnt           = 0;
+
 	//m_vexDrawPos.Set( 0.0f, 0.0f, 0.0f );
 
 	m_mMaterial.Set(MAT_COUNT);
@@ -125,6 +144,8 @@ bool COGLDrawBase::SetScene(COGLBEReference& rSceneRef)
 		return false;
 	}
 
+	CloseInstanceBatch();
+
 	m_SceneRef = rSceneRef;
 	m_pScene   = pElList;
 
@@ -161,6 +182,84 @@ bool COGLDrawBase::ResetModes()
 	return true;
 }
 
+//////////////////////////////////////////////////////////////////////
+/// Get Mode State
+
+void COGLDrawBase::GetModeState(SModeState& rState) const
+{
+	rState.pScene = m_pScene;
+	memcpy(rState.pfColor, m_ActiveColor.Data(), 4 * sizeof(float));
+
+	rState.eDrawPointType = m_eDrawPointType;
+	rState.eDrawLineType  = m_eDrawLineType;
+
+	rState.iSphereDetailLevel   = m_iSphereDetailLevel;
+	rState.iCylinderDetailLevel = m_iCylinderDetailLevel;
+
+	rState.fPointSize       = m_fPointSize;
+	rState.fLineWidth       = m_fLineWidth;
+	rState.fTexRepFac       = m_fTexRepFac;
+	rState.fArrowLength     = m_fArrowLength;
+	rState.fArrowAngle      = m_fArrowAngle;
+	rState.fArrowLineRadius = m_fArrowLineRadius;
+
+	rState.bUseLighting          = m_bUseLighting;
+	rState.bUseTranslucency      = m_bUseTranslucency;
+	rState.bShowImaginaryObjects = m_bShowImaginaryObjects;
+	rState.bUseAbsTexCoords      = m_bUseAbsTexCoords;
+}
+
+//////////////////////////////////////////////////////////////////////
+/// Set Mode State
+/// The current scene is not changed, since the scene reference
+/// cannot be recovered from the pointer.
+
+void COGLDrawBase::SetModeState(const SModeState& rState)
+{
+	memcpy(m_ActiveColor.Data(), rState.pfColor, 4 * sizeof(float));
+
+	m_eDrawPointType = rState.eDrawPointType;
+	m_eDrawLineType  = rState.eDrawLineType;
+
+	m_iSphereDetailLevel   = rState.iSphereDetailLevel;
+	m_iCylinderDetailLevel = rState.iCylinderDetailLevel;
+
+	m_fPointSize       = rState.fPointSize;
+	m_fLineWidth       = rState.fLineWidth;
+	m_fTexRepFac       = rState.fTexRepFac;
+	m_fArrowLength     = rState.fArrowLength;
+	m_fArrowAngle      = rState.fArrowAngle;
+	m_fArrowLineRadius = rState.fArrowLineRadius;
+
+	m_bUseLighting          = rState.bUseLighting;
+	m_bUseTranslucency      = rState.bUseTranslucency;
+	m_bShowImaginaryObjects = rState.bShowImaginaryObjects;
+	m_bUseAbsTexCoords      = rState.bUseAbsTexCoords;
+}
+
+//////////////////////////////////////////////////////////////////////
+/// Compare Mode States
+
+bool COGLDrawBase::SModeState::IsEqual(const SModeState& rState) const
+{
+	return pScene == rState.pScene
+	       && memcmp(pfColor, rState.pfColor, 4 * sizeof(float)) == 0
+	       && eDrawPointType == rState.eDrawPointType
+	       && eDrawLineType == rState.eDrawLineType
+	       && iSphereDetailLevel == rState.iSphereDetailLevel
+	       && iCylinderDetailLevel == rState.iCylinderDetailLevel
+	       && fPointSize == rState.fPointSize
+	       && fLineWidth == rState.fLineWidth
+	       && fTexRepFac == rState.fTexRepFac
+	       && fArrowLength == rState.fArrowLength
+	       && fArrowAngle == rState.fArrowAngle
+	       && fArrowLineRadius == rState.fArrowLineRadius
+	       && bUseLighting == rState.bUseLighting
+	       && bUseTranslucency == rState.bUseTranslucency
+	       && bShowImaginaryObjects == rState.bShowImaginaryObjects
+	       && bUseAbsTexCoords == rState.bUseAbsTexCoords;
+}
+
 //////////////////////////////////////////////////////////////////////
 // Make Random Polygon Stipple Patterns
 
@@ -199,11 +298,203 @@ bool COGLDrawBase::SetColor(COGLColor& rCol)
 		return false;
 	}
 
+	// A color directly following an instance batch is applied after the batch.
+	// Instances that are added later store the color themselves.
+	bool bExtendBatch = _IsInstanceBatchOpen();
+
 	COGLColor* pCol        = new COGLColor(rCol);
 	COGLBEReference ColRef = m_pSceneRep->New(pCol);
 
 	m_pScene->Add(ColRef);
 
+	if (bExtendBatch)
+	{
+		m_refInstanceBatchTail   = ColRef;
+		m_bInstanceBatchColorSet = true;
+	}
+
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////
+/// Instance Batching
+
+void COGLDrawBase::CloseInstanceBatch()
+{
+	m_refInstanceBatch.Clear();
+	m_refInstanceBatchTail.Clear();
+	m_pInstanceBatchScene    = 0;
+	m_bInstanceBatchColorSet = false;
+}
+
+bool COGLDrawBase::_IsInstanceBatchOpen() const
+{
+	if (!m_refInstanceBatch.IsValid() || !m_pScene || (m_pScene != m_pInstanceBatchScene))
+	{
+		return false;
+	}
+
+	// The batch can only be extended if nothing else has been drawn since
+	const list<COGLBEReference>& rElList = m_pScene->GetElementList();
+
+	return !rElList.empty() && ((const COGLBaseElement*) rElList.back() == (const COGLBaseElement*) m_refInstanceBatchTail);
+}
+
+bool COGLDrawBase::_HasInstanceMesh(unsigned uMeshKey) const
+{
+	return m_mapInstanceMesh.find(uMeshKey) != m_mapInstanceMesh.end();
+}
+
+//////////////////////////////////////////////////////////////////////
+/// Redirect drawing into rMeshScene to generate the mesh of an instance batch.
+/// Returns the scene that has to be passed to _EndInstanceMesh().
+
+COGLBaseElementList* COGLDrawBase::_BeginInstanceMesh(COGLBaseElementList& rMeshScene)
+{
+	COGLBaseElementList* pPrevScene = m_pScene;
+
+	m_pScene            = &rMeshScene;
+	m_bUseInstanceBatch = false;
+
+	return pPrevScene;
+}
+
+//////////////////////////////////////////////////////////////////////
+/// Store the elements drawn since _BeginInstanceMesh() as mesh.
+/// The vertex lists are drawn at the origin with unit size. Their translation,
+/// rotation and scaling is removed, since the instances carry the transformation.
+
+std::vector<COGLBEReference>& COGLDrawBase::_EndInstanceMesh(unsigned uMeshKey, COGLBaseElementList& rMeshScene, COGLBaseElementList* pPrevScene)
+{
+	m_pScene            = pPrevScene;
+	m_bUseInstanceBatch = true;
+
+	const list<COGLBEReference>& rElList  = rMeshScene.GetElementList();
+	std::vector<COGLBEReference>& vecMesh = m_mapInstanceMesh[uMeshKey];
+
+	vecMesh.assign(rElList.begin(), rElList.end());
+
+	for (COGLBEReference& rRef : vecMesh)
+	{
+		COGLVertexList* pVexList = dynamic_cast<COGLVertexList*>((COGLBaseElement*) rRef);
+		if (!pVexList)
+		{
+			continue;
+		}
+
+		COGLVertex xTrans2;
+		pVexList->GetTranslation2(xTrans2);
+
+		pVexList->EnableScaling(false);
+		pVexList->SetTranslation1(COGLVertex(0.0f, 0.0f, 0.0f));
+		pVexList->SetRotation(0.0f, COGLVertex(0.0f, 0.0f, 1.0f));
+
+		if (xTrans2.Mag() == 0.0f)
+		{
+			pVexList->EnableTransform(false);
+		}
+	}
+
+	return vecMesh;
+}
+
+//////////////////////////////////////////////////////////////////////
+/// Add an instance of the mesh uMeshKey to the open batch or start a new batch.
+/// The open batch is only extended if it is the last element of the scene, apart from
+/// colors, and has the same mesh, so that the drawing order of the scene is kept.
+/// The instance is scaled by xScale, rotated such that the unit vector xAxis is mapped
+/// onto the unit vector xDir and translated to xP. xAxis has to lie along the z-axis.
+
+bool COGLDrawBase::_AddInstance(unsigned uMeshKey, const COGLVertex& xP, const COGLVertex& xAxis, const COGLVertex& xDir, const COGLVertex& xScale)
+{
+	COGLInstanceBatch* pBatch = 0;
+
+	if (_IsInstanceBatchOpen())
+	{
+		pBatch = dynamic_cast<COGLInstanceBatch*>((COGLBaseElement*) m_refInstanceBatch);
+
+		if (pBatch && (pBatch->GetMeshKey() != uMeshKey))
+		{
+			pBatch = 0;
+		}
+	}
+
+	if (!pBatch)
+	{
+		CloseInstanceBatch();
+
+		auto itMesh = m_mapInstanceMesh.find(uMeshKey);
+		if (itMesh == m_mapInstanceMesh.end())
+		{
+			return false;
+		}
+
+		pBatch = new COGLInstanceBatch;
+		pBatch->SetMesh(uMeshKey, itMesh->second);
+
+		COGLBEReference refBatch = m_pSceneRep->New(pBatch);
+		m_pScene->Add(refBatch);
+
+		m_refInstanceBatch     = refBatch;
+		m_refInstanceBatchTail = refBatch;
+		m_pInstanceBatchScene  = m_pScene;
+		++m_uInstanceBatchCnt;
+	}
+
+	// Rotation matrix from axis and angle
+	float pfRot[3][3];
+	COGLVertex xRotAxis = xAxis ^ xDir;
+	float fSin          = xRotAxis.Mag();
+	float fCos          = xAxis * xDir;
+
+	if (fSin > 1e-6f)
+	{
+		xRotAxis /= fSin;
+
+		float fOneMinusCos = 1.0f - fCos;
+		for (int iRow = 0; iRow < 3; ++iRow)
+		{
+			for (int iCol = 0; iCol < 3; ++iCol)
+			{
+				pfRot[iRow][iCol] = fOneMinusCos * xRotAxis[iRow] * xRotAxis[iCol] + (iRow == iCol ? fCos : 0.0f);
+			}
+		}
+
+		pfRot[0][1] -= fSin * xRotAxis[2];
+		pfRot[1][0] += fSin * xRotAxis[2];
+		pfRot[0][2] += fSin * xRotAxis[1];
+		pfRot[2][0] -= fSin * xRotAxis[1];
+		pfRot[1][2] -= fSin * xRotAxis[0];
+		pfRot[2][1] += fSin * xRotAxis[0];
+	}
+	else
+	{
+		// Either no rotation or a rotation by 180 degrees about the x-axis
+		float fSign = (fCos < 0.0f ? -1.0f : 1.0f);
+
+		memset(pfRot, 0, 9 * sizeof(float));
+		pfRot[0][0] = 1.0f;
+		pfRot[1][1] = fSign;
+		pfRot[2][2] = fSign;
+	}
+
+	// Column major transformation matrix
+	float pfTransform[16];
+	for (int iCol = 0; iCol < 3; ++iCol)
+	{
+		for (int iRow = 0; iRow < 3; ++iRow)
+		{
+			pfTransform[iCol * 4 + iRow] = pfRot[iRow][iCol] * xScale[iCol];
+		}
+
+		pfTransform[iCol * 4 + 3] = 0.0f;
+		pfTransform[12 + iCol]    = xP[iCol];
+	}
+	pfTransform[15] = 1.0f;
+
+	pBatch->AddInstance(pfTransform, (m_bInstanceBatchColorSet ? m_ActiveColor.Data() : nullptr));
+	++m_uInstanceCnt;
+
 	return true;
 }
 
@@ -1126,6 +1417,23 @@ bool COGLDrawBase::DrawSphere(const COGLVertex& xC, float fRadius, bool bSolid,
 	//else
 	//	iSphereID = 1;
 
+	if (_UseInstanceBatch())
+	{
+		unsigned uFlags = (bSolid ? 0x1 : 0) | (bDirected ? 0x2 : 0) | (bNegRadius ? 0x4 : 0);
+		unsigned uKey   = InstanceMeshKey(INST_MESH_SPHERE, uFlags, unsigned(m_iSphereDetailLevel));
+
+		if (!_HasInstanceMesh(uKey))
+		{
+			COGLBaseElementList xMeshScene;
+			COGLBaseElementList* pScene = _BeginInstanceMesh(xMeshScene);
+			DrawSphere(COGLVertex(0.0f, 0.0f, 0.0f), (bNegRadius ? -1.0f : 1.0f), bSolid, bDirected);
+			_EndInstanceMesh(uKey, xMeshScene, pScene);
+		}
+
+		COGLVertex xZ(0.0f, 0.0f, 1.0f);
+		return _AddInstance(uKey, xC, xZ, xZ, COGLVertex(fRadius, fRadius, fRadius));
+	}
+
 	MemObj<COGLVertexList>* pList;
 	if (bSolid)
 	{
@@ -2305,6 +2613,23 @@ bool COGLDrawBase::DrawCylinder(const COGLVertex& xC,           const COGLVertex
 		return DrawLine(xC, xN, false);
 	}
 
+	float fLen = xN.Mag();
+	if (_UseInstanceBatch() && (fLen > 0.0f))
+	{
+		unsigned uStepCnt = unsigned(360.0f / fAngleStep + 0.5f) + 1;
+		unsigned uKey     = InstanceMeshKey(INST_MESH_CYLINDER, (bClosed ? 0x1 : 0), uStepCnt);
+
+		if (!_HasInstanceMesh(uKey))
+		{
+			COGLBaseElementList xMeshScene;
+			COGLBaseElementList* pScene = _BeginInstanceMesh(xMeshScene);
+			DrawCylinder(COGLVertex(0.0f, 0.0f, 0.0f), COGLVertex(0.0f, 0.0f, 1.0f), 1.0f, bClosed, fAngleStep);
+			_EndInstanceMesh(uKey, xMeshScene, pScene);
+		}
+
+		return _AddInstance(uKey, xC, COGLVertex(0.0f, 0.0f, 1.0f), (1.0f / fLen) * xN, COGLVertex(fR, fR, fLen));
+	}
+
 	COGLVertexList* pVexListFront = 0;
 	COGLVertexList* pVexListBack  = 0;
 	//COGLVertexList::TVexList *pmVexF;
@@ -4074,6 +4399,23 @@ bool COGLDrawBase::DrawCone(const COGLVertex& xP, const COGLVertex& xD, float fR
 		bUseCol = true;
 	}
 
+	// Cones with vertex colors or whose elements are returned are not batched
+	float fLen = xD.Mag();
+	if (_UseInstanceBatch() && !bUseCol && !pmScene && (fR > 0.0f) && (fLen > 0.0f))
+	{
+		unsigned uKey = InstanceMeshKey(INST_MESH_CONE, (bClosed ? 0x1 : 0), unsigned(iStepCnt));
+
+		if (!_HasInstanceMesh(uKey))
+		{
+			COGLBaseElementList xMeshScene;
+			COGLBaseElementList* pScene = _BeginInstanceMesh(xMeshScene);
+			DrawCone(COGLVertex(0.0f, 0.0f, 0.0f), COGLVertex(0.0f, 0.0f, -1.0f), 1.0f, mColor, iStepCnt, bClosed);
+			_EndInstanceMesh(uKey, xMeshScene, pScene);
+		}
+
+		return _AddInstance(uKey, xP, COGLVertex(0.0f, 0.0f, -1.0f), (1.0f / fLen) * xD, COGLVertex(fR, fR, fLen));
+	}
+
 	++iStepCnt;
 
 	COGLVertexList* pVexListFan = new COGLVertexList;
@@ -43,6 +43,10 @@
 #include "OGLVertexList.h"
 #include "OGLDisplayList.h"
 #include "OGLBaseElementList.h"
+#include "OGLInstanceBatch.h"
+
+#include <map>
+#include <vector>
 
 //#include "CluTec.Viz.Base.GA/e3ga.h"
 //#include "CluTec.Viz.Base.GA/pga.h"
@@ -102,6 +106,32 @@
 
 		typedef unsigned TTriplet[3];
 
+		// The state of the draw base that is changed by drawing commands and that
+		// determines the elements created by subsequent drawing commands.
+		struct SModeState
+		{
+			COGLBaseElementList* pScene;
+			float pfColor[4];
+
+			TDrawPointType eDrawPointType;
+			TDrawLineType eDrawLineType;
+
+			int iSphereDetailLevel;
+			int iCylinderDetailLevel;
+
+			float fPointSize;
+			float fLineWidth;
+			float fTexRepFac;
+			float fArrowLength, fArrowAngle, fArrowLineRadius;
+
+			bool bUseLighting;
+			bool bUseTranslucency;
+			bool bShowImaginaryObjects;
+			bool bUseAbsTexCoords;
+
+			bool IsEqual(const SModeState& rState) const;
+		};
+
 	public:
 
 		COGLDrawBase();
@@ -123,6 +153,10 @@
 		bool SetMode(int iMode);
 		bool ResetModes();
 
+		// Get and set the mode state. Setting the mode state does not add any elements to the scene.
+		void GetModeState(SModeState& rState) const;
+		void SetModeState(const SModeState& rState);
+
 		bool SetColor(COGLColor& rCol);
 		COGLColor GetColor() { return m_ActiveColor; }
 
@@ -300,8 +334,37 @@
 		bool GenVexIcosahedron(COGLVertexList& rVexList, float fRadius, int iPower);
 		bool GenCubeSphere(MemObj<COGLVertexList>& mVexList, int iRowCnt, int iColCnt);
 
+		// If enabled, spheres, cones and cylinders of the same type drawn one after the other are collected
+		// in an instance batch, which stores one transformation per primitive and shares the mesh between
+		// all instances. The batch is extended as long as only colors have been added to the scene after it.
+		// Batching is disabled by default.
+		void EnableInstanceBatching(bool bVal = true)
+		{ CloseInstanceBatch(); m_bUseInstanceBatch = bVal; }
+
+		bool IsInstanceBatchingEnabled() const
+		{ return m_bUseInstanceBatch; }
+
+		// Start new batches for the next primitives that are drawn.
+		void CloseInstanceBatch();
+
+		// Number of batches and instances created since the last reset of the statistics.
+		void GetInstanceBatchStats(unsigned& uBatchCnt, unsigned& uInstanceCnt) const
+		{ uBatchCnt = m_uInstanceBatchCnt; uInstanceCnt = m_uInstanceCnt; }
+
+		void ResetInstanceBatchStats()
+		{ m_uInstanceBatchCnt = 0; m_uInstanceCnt = 0; }
+
 	protected:
 
+		bool _UseInstanceBatch() const
+		{ return m_bUseInstanceBatch && m_pScene && m_pSceneRep; }
+
+		bool _IsInstanceBatchOpen() const;
+		bool _HasInstanceMesh(unsigned uMeshKey) const;
+		COGLBaseElementList* _BeginInstanceMesh(COGLBaseElementList& rMeshScene);
+		std::vector<COGLBEReference>& _EndInstanceMesh(unsigned uMeshKey, COGLBaseElementList& rMeshScene, COGLBaseElementList* pPrevScene);
+		bool _AddInstance(unsigned uMeshKey, const COGLVertex& xP, const COGLVertex& xAxis, const COGLVertex& xDir, const COGLVertex& xScale);
+
 		//bool GenerateSphereVL(double dAngleStepTheta, double dAngleStepPhi);
 		bool MakeRandPolyStipple(double dLevel);
 
@@ -370,6 +433,16 @@
 
 		TDrawPointType m_eDrawPointType;
 		TDrawLineType m_eDrawLineType;
+
+		// Instance batching
+		bool m_bUseInstanceBatch;
+		bool m_bInstanceBatchColorSet;	// Colors were added to the scene after the first batch
+		COGLBEReference m_refInstanceBatch;	// Batch that can still be extended
+		COGLBEReference m_refInstanceBatchTail;	// Last element of the scene that belongs to the batch
+		COGLBaseElementList* m_pInstanceBatchScene;
+		std::map<unsigned, std::vector<COGLBEReference>> m_mapInstanceMesh;
+		unsigned m_uInstanceBatchCnt;
+		unsigned m_uInstanceCnt;
 	};
 
 #endif	// !defined(AFX_OGLMVFILTERBASE_H__3D0F9FE0_C4C7_4C2C_9881_815CE941C428__INCLUDED_)
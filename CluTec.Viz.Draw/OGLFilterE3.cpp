@@ -122,9 +122,18 @@ bool COGLFilterE3::DrawMV(const MultiV<float>& vX, bool bAnalyzeOnly)
 	m_MVInfo.Reset();
 	m_dMVInfo.Reset();
 
-	if (!m_E3Base.AnalyzeMV(vA, m_MVInfo, m_bDrawOPNS, m_fSensitivity) || 
-		m_MVInfo.m_eType == GA_NONE)
-		return false;
+	SMVInfoKey xKey;
+	bool bUseCache = MakeMVInfoKey(xKey, vA, (m_bDrawOPNS ? 0x1 : 0), m_fSensitivity);
+
+	if (!bUseCache || !FindMVInfo(xKey))
+	{
+		if (!m_E3Base.AnalyzeMV(vA, m_MVInfo, m_bDrawOPNS, m_fSensitivity) || 
+			m_MVInfo.m_eType == GA_NONE)
+			return false;
+
+		if (bUseCache)
+			StoreMVInfo(xKey);
+	}
 
 	if (bAnalyzeOnly)
 		return true;
@@ -145,12 +154,21 @@ bool COGLFilterE3::DrawMV(const MultiV<double>& vX, bool bAnalyzeOnly)
 	m_MVInfo.Reset();
 	m_dMVInfo.Reset();
 
-	if (!m_dE3Base.AnalyzeMV(vA, m_dMVInfo, m_bDrawOPNS, m_fSensitivity) || 
-		m_dMVInfo.m_eType == GA_NONE)
-		return false;
+	SMVInfoKey xKey;
+	bool bUseCache = MakeMVInfoKey(xKey, vA, (m_bDrawOPNS ? 0x1 : 0), (double) m_fSensitivity);
 
-	if (!CastMVInfoToFloat(m_MVInfo, m_dMVInfo))
-		return false;
+	if (!bUseCache || !FindMVInfo(xKey))
+	{
+		if (!m_dE3Base.AnalyzeMV(vA, m_dMVInfo, m_bDrawOPNS, m_fSensitivity) || 
+			m_dMVInfo.m_eType == GA_NONE)
+			return false;
+
+		if (!CastMVInfoToFloat(m_MVInfo, m_dMVInfo))
+			return false;
+
+		if (bUseCache)
+			StoreMVInfo(xKey);
+	}
 
 	if (bAnalyzeOnly)
 		return true;
@@ -134,23 +134,32 @@ bool COGLFilterN3::DrawMV(const MultiV<float>& vX, bool bAnalyzeOnly)
 	m_MVInfo.Reset();
 	m_dMVInfo.Reset();
 
-	if (!m_bMVIsBlade && !m_bMVIsVersor)
-	{
-		if (!m_N3Base.AnalyzeMV(vA, m_MVInfo, m_bDrawOPNS, m_fSensitivity) || 
-			m_MVInfo.m_eType == GA_NONE)
-			return false;
-	}
-	else if (m_bMVIsBlade)
-	{
-		if (!m_N3Base.AnalyzeBlade(vA, m_MVInfo, m_bDrawOPNS, m_fSensitivity) || 
-			m_MVInfo.m_eType == GA_NONE)
-			return false;
-	}
-	else if (m_bMVIsVersor)
+	SMVInfoKey xKey;
+	bool bUseCache = MakeMVInfoKey(xKey, vA, GetMVInfoCacheMode(), m_fSensitivity);
+
+	if (!bUseCache || !FindMVInfo(xKey))
 	{
-		if (!m_N3Base.AnalyzeVersor(vA, m_MVInfo, m_fSensitivity) || 
-			m_MVInfo.m_eType == GA_NONE)
-			return false;
+		if (!m_bMVIsBlade && !m_bMVIsVersor)
+		{
+			if (!m_N3Base.AnalyzeMV(vA, m_MVInfo, m_bDrawOPNS, m_fSensitivity) || 
+				m_MVInfo.m_eType == GA_NONE)
+				return false;
+		}
+		else if (m_bMVIsBlade)
+		{
+			if (!m_N3Base.AnalyzeBlade(vA, m_MVInfo, m_bDrawOPNS, m_fSensitivity) || 
+				m_MVInfo.m_eType == GA_NONE)
+				return false;
+		}
+		else if (m_bMVIsVersor)
+		{
+			if (!m_N3Base.AnalyzeVersor(vA, m_MVInfo, m_fSensitivity) || 
+				m_MVInfo.m_eType == GA_NONE)
+				return false;
+		}
+
+		if (bUseCache)
+			StoreMVInfo(xKey);
 	}
 
 	if (bAnalyzeOnly)
@@ -171,27 +180,36 @@ bool COGLFilterN3::DrawMV(const MultiV<double>& vX, bool bAnalyzeOnly)
 	m_MVInfo.Reset();
 	m_dMVInfo.Reset();
 
-	if (!m_bMVIsBlade && !m_bMVIsVersor)
-	{
-		if (!m_dN3Base.AnalyzeMV(vA, m_dMVInfo, m_bDrawOPNS, m_dSensitivity) || 
-			m_dMVInfo.m_eType == GA_NONE)
-			return false;
-	}
-	else if (m_bMVIsBlade)
-	{
-		if (!m_dN3Base.AnalyzeBlade(vA, m_dMVInfo, m_bDrawOPNS, m_dSensitivity) || 
-			m_dMVInfo.m_eType == GA_NONE)
-			return false;
-	}
-	else if (m_bMVIsVersor)
+	SMVInfoKey xKey;
+	bool bUseCache = MakeMVInfoKey(xKey, vA, GetMVInfoCacheMode(), m_dSensitivity);
+
+	if (!bUseCache || !FindMVInfo(xKey))
 	{
-		if (!m_dN3Base.AnalyzeVersor(vA, m_dMVInfo, m_dSensitivity) || 
-			m_dMVInfo.m_eType == GA_NONE)
+		if (!m_bMVIsBlade && !m_bMVIsVersor)
+		{
+			if (!m_dN3Base.AnalyzeMV(vA, m_dMVInfo, m_bDrawOPNS, m_dSensitivity) || 
+				m_dMVInfo.m_eType == GA_NONE)
+				return false;
+		}
+		else if (m_bMVIsBlade)
+		{
+			if (!m_dN3Base.AnalyzeBlade(vA, m_dMVInfo, m_bDrawOPNS, m_dSensitivity) || 
+				m_dMVInfo.m_eType == GA_NONE)
+				return false;
+		}
+		else if (m_bMVIsVersor)
+		{
+			if (!m_dN3Base.AnalyzeVersor(vA, m_dMVInfo, m_dSensitivity) || 
+				m_dMVInfo.m_eType == GA_NONE)
+				return false;
+		}
+
+		if (!CastMVInfoToFloat(m_MVInfo, m_dMVInfo))
 			return false;
-	}
 
-	if (!CastMVInfoToFloat(m_MVInfo, m_dMVInfo))
-		return false;
+		if (bUseCache)
+			StoreMVInfo(xKey);
+	}
 
 	if (bAnalyzeOnly)
 		return true;
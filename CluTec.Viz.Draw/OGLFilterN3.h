@@ -68,6 +68,11 @@ public:
 	void EnableSolidObjects(bool bSolid = true) { m_bSolidObjects = bSolid; }
 	void EnableOPNSMode(bool bOPNS = true) { m_bDrawOPNS = bOPNS; }
 
+protected:
+	// Flags that influence the analysis of multivectors
+	uint GetMVInfoCacheMode() const
+	{ return (m_bDrawOPNS ? 0x1 : 0) | (m_bMVIsBlade ? 0x2 : 0) | (m_bMVIsVersor ? 0x4 : 0); }
+
 protected:
 	COGLFilterP3 m_P3Filter;
 	
@@ -96,9 +96,20 @@ bool COGLFilterP3::DrawMV(const MultiV<float>& vX, bool bAnalyzeOnly)
 	m_MVInfo.Reset();
 	m_dMVInfo.Reset();
 
-	if (!m_P3Base.AnalyzeMV(vA, m_MVInfo, m_bDrawOPNS) || (m_MVInfo.m_eType == GA_NONE))
+	SMVInfoKey xKey;
+	bool bUseCache = MakeMVInfoKey(xKey, vA, (m_bDrawOPNS ? 0x1 : 0), m_fSensitivity);
+
+	if (!bUseCache || !FindMVInfo(xKey))
 	{
-		return false;
+		if (!m_P3Base.AnalyzeMV(vA, m_MVInfo, m_bDrawOPNS) || (m_MVInfo.m_eType == GA_NONE))
+		{
+			return false;
+		}
+
+		if (bUseCache)
+		{
+			StoreMVInfo(xKey);
+		}
 	}
 
 	if (bAnalyzeOnly)
@@ -123,14 +134,25 @@ bool COGLFilterP3::DrawMV(const MultiV<double>& vX, bool bAnalyzeOnly)
 	m_MVInfo.Reset();
 	m_dMVInfo.Reset();
 
-	if (!m_dP3Base.AnalyzeMV(vA, m_dMVInfo, m_bDrawOPNS) || (m_dMVInfo.m_eType == GA_NONE))
-	{
-		return false;
-	}
+	SMVInfoKey xKey;
+	bool bUseCache = MakeMVInfoKey(xKey, vA, (m_bDrawOPNS ? 0x1 : 0), (double) m_fSensitivity);
 
-	if (!CastMVInfoToFloat(m_MVInfo, m_dMVInfo))
+	if (!bUseCache || !FindMVInfo(xKey))
 	{
-		return false;
+		if (!m_dP3Base.AnalyzeMV(vA, m_dMVInfo, m_bDrawOPNS) || (m_dMVInfo.m_eType == GA_NONE))
+		{
+			return false;
+		}
+
+		if (!CastMVInfoToFloat(m_MVInfo, m_dMVInfo))
+		{
+			return false;
+		}
+
+		if (bUseCache)
+		{
+			StoreMVInfo(xKey);
+		}
 	}
 
 	if (bAnalyzeOnly)
@@ -134,6 +134,8 @@ void COGLFrame::ResetContent()
 	m_dOrigX     = m_dOrigY = m_dOrigZ = 0.0;
 
 	m_refAnimateFrame.Clear();
+
+	InvalidateParentBounds();
 }
 
 //////////////////////////////////////////////////////////////////////
@@ -575,6 +577,45 @@ void COGLFrame::TellParentContentChanged()
 	}
 }
 
+//////////////////////////////////////////////////////////////////////
+/// Bounds
+
+const COGLBaseElement::SBoundInfo& COGLFrame::GetBoundInfo()
+{
+	if (m_eFrameMode == TEXTURE)
+	{
+		return GetStateBoundInfo();
+	}
+
+	if ((m_eFrameMode != MODELVIEW) || !m_bMultiplyMatrix || m_bAutoBillboard || m_bAutoScaleToPixelSize
+	    || m_refAnimateFrame.IsValid() || !COGLBoundingBox::IsAffine(m_matFrame.Data()))
+	{
+		return COGLBaseElement::GetBoundInfo();
+	}
+
+	// The frame also sets the pixel zoom and may invert the front face
+	m_xBoundInfo.Reset(true, true);
+	m_xBoundInfo.bHasTransform = true;
+
+	double* pdMat = m_xBoundInfo.pdTransform;
+	double pdOrig[16];
+
+	if (m_bUseOrigin)
+	{
+		COGLBoundingBox::Translate(pdMat, -m_dOrigX, -m_dOrigY, -m_dOrigZ);
+	}
+
+	memcpy(pdOrig, pdMat, 16 * sizeof(double));
+	COGLBoundingBox::MultMatrix(pdMat, pdOrig, m_matFrame.Data());
+
+	if (m_bUseOrigin)
+	{
+		COGLBoundingBox::Translate(pdMat, m_dOrigX, m_dOrigY, m_dOrigZ);
+	}
+
+	return m_xBoundInfo;
+}
+
 //////////////////////////////////////////////////////////////////////
 /// Apply
 
@@ -585,33 +626,34 @@ bool COGLFrame::Apply(COGLBaseElement::EApplyMode eMode, COGLBaseElement::SApply
 		rData.bInvertFrontFace = true;
 	}
 
-	int iMatrixMode;
-	glGetIntegerv(GL_MATRIX_MODE, &iMatrixMode);
+	// All matrix operations go through the matrix stack, which keeps a copy of the matrices
+	Clu::CMatrixStack& rStack = rData.xMatrixStack;
+	Clu::CMatrixStack::EMatrixMode eMatrixMode = rStack.GetMatrixMode();
 
 	switch (m_eFrameMode)
 	{
 	case MODELVIEW:
-		glMatrixMode(GL_MODELVIEW);
+		rStack.MatrixMode(Clu::CMatrixStack::ModelView);
 		break;
 
 	case PROJECTION:
-		glMatrixMode(GL_PROJECTION);
+		rStack.MatrixMode(Clu::CMatrixStack::Projection);
 		break;
 
 	case TEXTURE:
-		glMatrixMode(GL_TEXTURE);
+		rStack.MatrixMode(Clu::CMatrixStack::Texture);
 		break;
 	}
 
 	// Having a texture frame and autoscale mode, we need to reset the texture matrix. Otherwise the repeated calls to texture frames will multiply the scale factor!
 	if (m_bAutoScaleToPixelSize && (m_eFrameMode == TEXTURE))
 	{
-		glLoadIdentity();
+		rStack.LoadIdentity();
 	}
 
 	if (m_bUseOrigin)
 	{
-		glTranslated(-m_dOrigX, -m_dOrigY, -m_dOrigZ);
+		rStack.Translate(-m_dOrigX, -m_dOrigY, -m_dOrigZ);
 	}
 
 	if ((m_bAutoBillboard || m_bAutoScaleToPixelSize) && (m_eFrameMode == MODELVIEW))
@@ -632,8 +674,8 @@ bool COGLFrame::Apply(COGLBaseElement::EApplyMode eMode, COGLBaseElement::SApply
 		Matrix<double> mTInv(4, 4);
 
 		glGetIntegerv(GL_VIEWPORT, piViewport);
-		glGetDoublev(GL_MODELVIEW_MATRIX, pdModelView);
-		glGetDoublev(GL_PROJECTION_MATRIX, pdProjection);
+		rStack.GetMatrix(Clu::CMatrixStack::ModelView, pdModelView);
+		rStack.GetMatrix(Clu::CMatrixStack::Projection, pdProjection);
 
 		// Transform origin to window coordinates
 		gluProject(0.0, 0.0, 0.0,
@@ -701,11 +743,11 @@ bool COGLFrame::Apply(COGLBaseElement::EApplyMode eMode, COGLBaseElement::SApply
 
 		// Store the inverse matrix
 		mTInv = mT.InvSVD();
-		glMultMatrixd(mTInv.Data());
+		rStack.MultMatrix(mTInv.Data());
 
 		if (m_bAutoScaleToPixelSize)
 		{
-			glGetDoublev(GL_MODELVIEW_MATRIX, pdModelView);
+			rStack.GetMatrix(Clu::CMatrixStack::ModelView, pdModelView);
 
 			gluUnProject(dWO1, dWO2, dWO3,
 					pdModelView, pdProjection, piViewport,
@@ -731,10 +773,10 @@ bool COGLFrame::Apply(COGLBaseElement::EApplyMode eMode, COGLBaseElement::SApply
 			if (m_bAutoBillboard == false)
 			{
 				// undo the billboarding
-				glMultMatrixd(mT.Data());
+				rStack.MultMatrix(mT.Data());
 			}
 
-			glScaled(dFacW, dFacH, 1.0);
+			rStack.Scale(dFacW, dFacH, 1.0);
 		}
 	}
 	else if (m_bAutoScaleToPixelSize && (m_eFrameMode == TEXTURE))
@@ -754,8 +796,8 @@ bool COGLFrame::Apply(COGLBaseElement::EApplyMode eMode, COGLBaseElement::SApply
 		double dScale, dPixH, dScale2;
 
 		glGetIntegerv(GL_VIEWPORT, piViewport);
-		glGetDoublev(GL_MODELVIEW_MATRIX, pdModelView);
-		glGetDoublev(GL_PROJECTION_MATRIX, pdProjection);
+		rStack.GetMatrix(Clu::CMatrixStack::ModelView, pdModelView);
+		rStack.GetMatrix(Clu::CMatrixStack::Projection, pdProjection);
 
 		// Transform origin to window coordinates
 		gluProject(0.0, 0.0, 0.0,
@@ -809,7 +851,7 @@ bool COGLFrame::Apply(COGLBaseElement::EApplyMode eMode, COGLBaseElement::SApply
 			{
 				dScale2 = 1.0;
 			}
-			glScaled(dScale2, dScale * dScale2, 1.0);
+			rStack.Scale(dScale2, dScale * dScale2, 1.0);
 		}
 		else
 		{
@@ -827,26 +869,26 @@ bool COGLFrame::Apply(COGLBaseElement::EApplyMode eMode, COGLBaseElement::SApply
 			{
 				dScale2 = 1.0;
 			}
-			glScaled(dScale * dScale2, dScale2, 1.0);
+			rStack.Scale(dScale * dScale2, dScale2, 1.0);
 		}
 	}
 
 	if (m_bMultiplyMatrix)
 	{
-		glMultMatrixd(m_matFrame.Data());
+		rStack.MultMatrix(m_matFrame.Data());
 	}
 	else
 	{
-		glLoadMatrixd(m_matFrame.Data());
+		rStack.LoadMatrix(m_matFrame.Data());
 	}
 
 	if (m_refAnimateFrame.IsValid())
 	{
 		if (m_eFrameMode == TEXTURE)
 		{
-			glTranslatef(0.5, 0.5, 0);
+			rStack.Translate(0.5, 0.5, 0);
 			m_refAnimateFrame->Apply(eMode, rData);
-			glTranslatef(-0.5, -0.5, 0);
+			rStack.Translate(-0.5, -0.5, 0);
 		}
 		else
 		{
@@ -856,10 +898,10 @@ bool COGLFrame::Apply(COGLBaseElement::EApplyMode eMode, COGLBaseElement::SApply
 
 	if (m_bUseOrigin)
 	{
-		glTranslated(m_dOrigX, m_dOrigY, m_dOrigZ);
+		rStack.Translate(m_dOrigX, m_dOrigY, m_dOrigZ);
 	}
 
-	glMatrixMode(iMatrixMode);
+	rStack.MatrixMode(eMatrixMode);
 
 	glPixelZoom(float(m_dPixelZoomX), float(m_dPixelZoomY));
 
@@ -63,7 +63,7 @@ public:
 	COGLFrame& operator= (const COGLFrame& rTrans);
 
 	void EnableMultiplyMatrix( bool bVal = true )
-	{ m_bMultiplyMatrix = bVal; }
+	{ m_bMultiplyMatrix = bVal; InvalidateParentBounds(); }
 
 	// Set matrix to unit matrix
 	void Reset();
@@ -115,26 +115,27 @@ public:
 		m_bAllowTextureScaleDown = bAllowScaleDown;
 		m_dASWidth = dWidth; m_dASHeight = dHeight;
 		m_dASPWidth = dPixelWidth; m_dASPHeight = dPixelHeight;
+		InvalidateParentBounds();
 	}
 
 	// Enable Auto Billboard
 	void EnableAutoBillboard( bool bVal = true )
-	{ m_bAutoBillboard = bVal; }
+	{ m_bAutoBillboard = bVal; InvalidateParentBounds(); }
 
 	// Enable use of origin
 	void EnableOrigin( bool bVal = true )
-	{ m_bUseOrigin = bVal; }
+	{ m_bUseOrigin = bVal; InvalidateParentBounds(); }
 
 	// Set origin
 	void SetOrigin( double dX, double dY, double dZ )
-	{ m_dOrigX = dX; m_dOrigY = dY; m_dOrigZ = dZ; }
+	{ m_dOrigX = dX; m_dOrigY = dY; m_dOrigZ = dZ; InvalidateParentBounds(); }
 
 	// Set Animated frame
 	void SetAnimateFrame( const COGLBEReference &refAnim )
-	{ m_refAnimateFrame = refAnim; }
+	{ m_refAnimateFrame = refAnim; InvalidateParentBounds(); }
 
 	void SetFrameMode( EFrameMode eFrameMode )
-	{ m_eFrameMode = eFrameMode; }
+	{ m_eFrameMode = eFrameMode; InvalidateParentBounds(); }
 
 	// Get 4x4 Matrix
 	Matrix<double> Get()
@@ -144,8 +145,15 @@ public:
 	double* GetDataPtr()
 	{ return m_matFrame.Data(); }
 
+	// True if the frame is reflecting, so that the front face of the following elements is inverted
+	bool InvertsFrontFace() const
+	{ return m_bInvertFrontFace; }
+
 	bool Apply(COGLBaseElement::EApplyMode eMode, COGLBaseElement::SApplyData &rData);
 
+	// Model view frames apply to the following elements. Frames that depend on the view or on an animation are not bounded.
+	const SBoundInfo& GetBoundInfo();
+
 protected:
 	void CheckFrameFrontFace();
 	void TellParentContentChanged();
@@ -190,6 +198,8 @@ protected:
 
 	// BE Reference to Animated Frame
 	COGLBEReference m_refAnimateFrame;
+
+	SBoundInfo m_xBoundInfo;
 };
 
 #endif // !defined(AFX_OGLMATERIAL_H__2296DD19_C205_454A_82DB_D1881903B593__INCLUDED_)
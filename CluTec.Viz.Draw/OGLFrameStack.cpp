@@ -86,8 +86,7 @@ bool COGLFrameStack::Apply(COGLBaseElement::EApplyMode eMode, COGLBaseElement::S
 	try
 	{
 		// Store current matrix mode
-		int iMatrixMode;
-		CLU_OGL_CALL(glGetIntegerv(GL_MATRIX_MODE, &iMatrixMode));
+		Clu::CMatrixStack::EMatrixMode eMatrixMode = rData.xMatrixStack.GetMatrixMode();
 
 		if (m_bDoPush)
 		{
@@ -143,7 +142,7 @@ bool COGLFrameStack::Apply(COGLBaseElement::EApplyMode eMode, COGLBaseElement::S
 		}
 
 		// Restore former matrix mode
-		CLU_OGL_CALL(glMatrixMode(iMatrixMode));
+		rData.xMatrixStack.MatrixMode(eMatrixMode);
 		return true;
 	}
 	catch (Clu::CIException& ex)
@@ -33,6 +33,10 @@
 #include <vector>
 #include <algorithm>
 #include <functional>		// For greater<int>( )
+#include <limits>
+#include <string.h>
+
+#include "CluTec.Viz.Base\matkernel.h"
 
 using namespace std;
 
@@ -45,6 +49,7 @@ using namespace std;
 /// Template Functions
 
 #include "OGLImage_Pixel.cxx"
+#include "OGLImage_Exec_Rows.cxx"
 #include "OGLImage_Form.cxx"
 #include "OGLImage_Mask.cxx"
 #include "OGLImage_Arithmetic.cxx"
@@ -59,11 +64,18 @@ using namespace std;
 
 COGLImage::COGLImage(void)
 {
+	m_lRefCnt = 0;
+	m_pImgRep = 0;
+
 	ResetVars();
 }
 
 COGLImage::COGLImage(const COGLImage& OGLImage)
 {
+	// A copy is a new image without references
+	m_lRefCnt = 0;
+	m_pImgRep = 0;
+
 	*this = OGLImage;
 }
 
@@ -999,13 +1011,66 @@ bool COGLImage::FlipImage(bool bHorizontal)
 
 	ilBindImage(m_uImgID);
 
+	if (s_ePixelKernel == PIXKERNEL_SCALAR)
+	{
+		if (bHorizontal)
+		{
+			iluMirror();
+		}
+		else
+		{
+			iluFlipImage();
+		}
+
+		::UnlockImageAccess();
+		return true;
+	}
+
+	// Swap the pixels in place, in blocks of rows
+	int iBPP        = ilGetInteger(IL_IMAGE_BYTES_PER_PIXEL);
+	int iWidth      = ilGetInteger(IL_IMAGE_WIDTH);
+	int iHeight     = ilGetInteger(IL_IMAGE_HEIGHT);
+	size_t nRowSize = size_t(iWidth) * size_t(iBPP);
+	uchar* pData    = ilGetData();
+
+	if (!pData || (iBPP <= 0) || (iBPP > 32))
+	{
+		::UnlockImageAccess();
+		return false;
+	}
+
+	bool bParallel = UsePixelKernelParallel(iWidth * iHeight);
+	size_t nGrain  = OGLIMAGE_PAR_GRAIN / std::max(iWidth, 1) + 1;
+
 	if (bHorizontal)
 	{
-		iluMirror();
+		MatrixParallelFor(bParallel, 0, size_t(iHeight), nGrain, [&](size_t nBegin, size_t nEnd)
+		{
+			uchar pucPix[32];
+
+			for (size_t nRow = nBegin; nRow < nEnd; ++nRow)
+			{
+				uchar* pucL = pData + nRow * nRowSize;
+				uchar* pucR = pucL + nRowSize - iBPP;
+
+				for (; pucL < pucR; pucL += iBPP, pucR -= iBPP)
+				{
+					memcpy(pucPix, pucL, iBPP);
+					memcpy(pucL, pucR, iBPP);
+					memcpy(pucR, pucPix, iBPP);
+				}
+			}
+		});
 	}
 	else
 	{
-		iluFlipImage();
+		MatrixParallelFor(bParallel, 0, size_t(iHeight / 2), nGrain, [&](size_t nBegin, size_t nEnd)
+		{
+			for (size_t nRow = nBegin; nRow < nEnd; ++nRow)
+			{
+				std::swap_ranges(pData + nRow * nRowSize, pData + (nRow + 1) * nRowSize, pData + (iHeight - 1 - nRow) * nRowSize);
+			}
+		});
 	}
 
 	::UnlockImageAccess();
@@ -37,6 +37,7 @@
 
 #include <vector>
 #include <limits>
+#include <atomic>
 
 #include "CluTec.Types1\IImage.h"
 
@@ -51,6 +52,9 @@
 
 	using namespace std;
 
+	class CImageRepository;
+	class CImageReference;
+
 #undef clamp
 
 #ifdef LoadBitmap
@@ -328,6 +332,14 @@
 			FONT
 		};
 
+		// Kernels used by the pixel operators
+		enum EPixelKernel
+		{
+			PIXKERNEL_SCALAR = 0,	// Per pixel functors only
+			PIXKERNEL_VECTOR,		// Vectorized row kernels where available
+			PIXKERNEL_PARALLEL		// Vectorized row kernels, large images are split over threads
+		};
+
 	public:
 
 		COGLImage(void);
@@ -424,6 +436,11 @@
 		bool ImageBitAND(COGLImage& rMask, const COGLImage& rImage);
 		bool ImageBitOR(COGLImage& rMask, const COGLImage& rImage);
 
+		// Select the kernels used by the pixel operators of all images.
+		// If iThreadCount >= 0, also sets the number of threads. Zero uses one thread per hardware thread.
+		static void SetPixelKernel(EPixelKernel eKernel, int iThreadCount = -1);
+		static EPixelKernel GetPixelKernel();
+
 		void SetFilename(const char* pcText);
 
 		// Set Image Origin
@@ -1190,6 +1207,68 @@
 		template< template<class TPxL, class TPxR1, class TPxR2> class Functor, class Parameter, class TPxL, class TPxR2 >
 		bool ExecutePixelOperator_Type121_Level1(TPxL* pTrg, const COGLImage& rSrc1, TPxR2* pSrc1, Parameter& rPar);
 
+		////////////////////////////////////////////////////////////////
+		/// Row kernels
+		///
+		/// Pointwise operators are executed on blocks of pixels, which are distributed over
+		/// threads for large images. Some operators have vectorized kernels for images of equal type.
+
+		template< class Functor, class TPxL, class Parameter >
+		static bool ExecuteRows(TPxL* pTrg, Parameter& rPar);
+
+		template< class Functor, class TPxL, class TPxR, class Parameter >
+		static bool ExecuteRows(TPxL* pTrg, TPxR* pSrc, Parameter& rPar);
+
+		template< class Functor, class TPxL, class TPxR1, class TPxR2, class Parameter >
+		static bool ExecuteRows(TPxL* pTrg, TPxR1* pSrc1, TPxR2* pSrc2, Parameter& rPar);
+
+		/// Number of pixels a pointwise operator works on. Returns -1 for all other operators.
+		template< class Parameter >
+		static int GetRowPixelCount(const Parameter& rPar) { return -1; }
+		static int GetRowPixelCount(const PPixCnt& rPar) { return rPar.iPixelCount; }
+		static int GetRowPixelCount(const PMaskEqualCol& rPar) { return rPar.iPixelCount; }
+		static int GetRowPixelCount(const PMakeTrans& rPar) { return rPar.iPixelCount; }
+		static int GetRowPixelCount(const PFlushRGB& rPar) { return rPar.iPixelCount; }
+		static int GetRowPixelCount(const POpScalar& rPar) { return rPar.iWidth * rPar.iHeight; }
+		static int GetRowPixelCount(const POpColor& rPar) { return rPar.iWidth * rPar.iHeight; }
+
+		/// Restrict the parameter of a pointwise operator to iPixelCount pixels.
+		template< class Parameter >
+		static void SetRowPixelCount(Parameter& rPar, int iPixelCount) { }
+		static void SetRowPixelCount(PPixCnt& rPar, int iPixelCount) { rPar.iPixelCount = iPixelCount; }
+		static void SetRowPixelCount(PMaskEqualCol& rPar, int iPixelCount) { rPar.iPixelCount = iPixelCount; }
+		static void SetRowPixelCount(PMakeTrans& rPar, int iPixelCount) { rPar.iPixelCount = iPixelCount; }
+		static void SetRowPixelCount(PFlushRGB& rPar, int iPixelCount) { rPar.iPixelCount = iPixelCount; }
+		static void SetRowPixelCount(POpScalar& rPar, int iPixelCount) { rPar.iWidth = iPixelCount; rPar.iHeight = 1; }
+		static void SetRowPixelCount(POpColor& rPar, int iPixelCount) { rPar.iWidth = iPixelCount; rPar.iHeight = 1; }
+
+		/// Vectorized kernels. Return false if there is no kernel for the operator and pixel type.
+		template< class Functor, class TPxL, class TPxR, class Parameter >
+		static bool ExecuteVectorKernel(Functor* pFunctor, TPxL* pTrg, TPxR* pSrc, const Parameter& rPar) { return false; }
+
+		template< class Functor, class TPxL, class TPxR1, class TPxR2, class Parameter >
+		static bool ExecuteVectorKernel(Functor* pFunctor, TPxL* pTrg, TPxR1* pSrc1, TPxR2* pSrc2, const Parameter& rPar) { return false; }
+
+		template< class TPx >
+		static bool ExecuteVectorKernel(FOpMultScalar<TPx, TPx>* pFunctor, TPx* pTrg, TPx* pSrc, const POpScalar& rPar);
+
+		template< class TPx >
+		static bool ExecuteVectorKernel(FOpAddScalar<TPx, TPx>* pFunctor, TPx* pTrg, TPx* pSrc, const POpScalar& rPar);
+
+		template< class TPx >
+		static bool ExecuteVectorKernel(FOpAddImg<TPx, TPx, TPx>* pFunctor, TPx* pTrg, TPx* pSrc1, TPx* pSrc2, const PPixCnt& rPar);
+
+		template< class TPx >
+		static bool ExecuteVectorKernel(FOpSubImg<TPx, TPx, TPx>* pFunctor, TPx* pTrg, TPx* pSrc1, TPx* pSrc2, const PPixCnt& rPar);
+
+		template< class TPx >
+		static bool ExecuteVectorKernel(FOpMultImg<TPx, TPx, TPx>* pFunctor, TPx* pTrg, TPx* pSrc1, TPx* pSrc2, const PPixCnt& rPar);
+
+		/// Apply xOp to the color channels of pSrc1 and pSrc2 (may be zero) in blocks of pixels.
+		/// The alpha channel is copied from pSrc1 if bCopyAlpha is true and set to one otherwise.
+		template< class TPx, class TOp >
+		static bool ExecuteVectorBlocks(TPx* pTrg, const TPx* pSrc1, const TPx* pSrc2, int iPixelCount, bool bCopyAlpha, const TOp& xOp);
+
 	protected:
 
 		CStrMem m_csFilename;
@@ -1204,6 +1283,16 @@
 		vector<unsigned> m_pvecPixIdxLum[4];
 
 		ILuint m_uImgID;
+
+	private:
+
+		friend class CImageReference;
+		friend class CImageRepository;
+
+		// Number of references to this image. Only changed by CImageReference.
+		std::atomic<long> m_lRefCnt;
+		// Repository that created this image. Zero if the image is not managed or the repository was reset.
+		CImageRepository* m_pImgRep;
 	};
 
 #endif
@@ -30,8 +30,8 @@
 //#define EXECPIXELOP_LEVEL2( PXTYPE ) ExecutePixelOperator_AnyType_Level2( pTrg, (PXTYPE *) rSrc1.GetDataPtr(), rSrc2, rPar )
 //#define EXECPIXELOP_LEVEL3( PXTYPE ) ExecutePixelOperator_AnyType_Level3( pTrg, pSrc1, (PXTYPE *) rSrc2.GetDataPtr(), rPar )
 
-#define EXECPIXELOP_112( PXTYPE1, PXTYPE2, PXTYPE3 ) Functor<PXTYPE1,PXTYPE2,PXTYPE3>::Execute( (PXTYPE1 *) pTrg, (PXTYPE2 *) pSrc1, (PXTYPE3 *) rSrc2.GetDataPtr(), rPar );
-#define EXECPIXELOP_121( PXTYPE1, PXTYPE2, PXTYPE3 ) Functor<PXTYPE1,PXTYPE2,PXTYPE3>::Execute( (PXTYPE1 *) pTrg, (PXTYPE2 *) rSrc1.GetDataPtr(), (PXTYPE3 *) pSrc2, rPar );
+#define EXECPIXELOP_112( PXTYPE1, PXTYPE2, PXTYPE3 ) ExecuteRows< Functor<PXTYPE1,PXTYPE2,PXTYPE3> >( (PXTYPE1 *) pTrg, (PXTYPE2 *) pSrc1, (PXTYPE3 *) rSrc2.GetDataPtr(), rPar );
+#define EXECPIXELOP_121( PXTYPE1, PXTYPE2, PXTYPE3 ) ExecuteRows< Functor<PXTYPE1,PXTYPE2,PXTYPE3> >( (PXTYPE1 *) pTrg, (PXTYPE2 *) rSrc1.GetDataPtr(), (PXTYPE3 *) pSrc2, rPar );
 
 
 /// Any Type construct start
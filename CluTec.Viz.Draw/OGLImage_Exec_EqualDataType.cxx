@@ -25,7 +25,7 @@
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
 // Define to simplify code in ExecutePixelOperator_EqualType
-#define EXECPIXELOP( PXTYPE1, PXTYPE2 ) Functor<PXTYPE1,PXTYPE1,PXTYPE2>::Execute( \
+#define EXECPIXELOP( PXTYPE1, PXTYPE2 ) ExecuteRows< Functor<PXTYPE1,PXTYPE1,PXTYPE2> >( \
 		(PXTYPE1 *) rTrg.GetDataPtr(), (PXTYPE1 *) rSrc1.GetDataPtr(), (PXTYPE2 *) rSrc2.GetDataPtr(), rPar )
 
 // Expect data type of all images to be the same
@@ -1383,7 +1383,7 @@ bool COGLImage::ExecutePixelOperator_EqualDataType112( COGLImage &rTrg, const CO
 
 
 // Define to simplify code in ExecutePixelOperator_EqualType
-#define EXECPIXELOP( PXTYPE1, PXTYPE2 ) Functor<PXTYPE1,PXTYPE2,PXTYPE1>::Execute( \
+#define EXECPIXELOP( PXTYPE1, PXTYPE2 ) ExecuteRows< Functor<PXTYPE1,PXTYPE2,PXTYPE1> >( \
 		(PXTYPE1 *) rTrg.GetDataPtr(), (PXTYPE2 *) rSrc1.GetDataPtr(), (PXTYPE1 *) rSrc2.GetDataPtr(), rPar )
 
 // Expect data type of all images to be the same
@@ -25,7 +25,7 @@
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
 // Define to simplify code in ExecutePixelOperator_EqualType
-#define EXECPIXELOP( PXTYPE ) Functor<PXTYPE,PXTYPE>::Execute( (PXTYPE *) rTrg.GetDataPtr(), (PXTYPE *) rSrc.GetDataPtr(), rPar )
+#define EXECPIXELOP( PXTYPE ) ExecuteRows< Functor<PXTYPE,PXTYPE> >( (PXTYPE *) rTrg.GetDataPtr(), (PXTYPE *) rSrc.GetDataPtr(), rPar )
 
 template< template<class TPxL, class TPxR> class Functor, class Parameter >
 bool COGLImage::ExecutePixelOperator_EqualType( COGLImage &rTrg, COGLImage &rSrc, Parameter& rPar )
@@ -256,7 +256,7 @@ bool COGLImage::ExecutePixelOperator_EqualType( COGLImage &rTrg, COGLImage &rSrc
 #undef EXECPIXELOP
 
 // Define to simplify code in ExecutePixelOperator_EqualType
-#define EXECPIXELOP( PXTYPE ) Functor<PXTYPE,PXTYPE,PXTYPE>::Execute( \
+#define EXECPIXELOP( PXTYPE ) ExecuteRows< Functor<PXTYPE,PXTYPE,PXTYPE> >( \
 		(PXTYPE *) rTrg.GetDataPtr(), (PXTYPE *) rSrc1.GetDataPtr(), (PXTYPE *) rSrc2.GetDataPtr(), rPar )
 
 template< template<class TPxL, class TPxR1, class TPxR2> class Functor, class Parameter >
@@ -0,0 +1,504 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// project:   CluTec.Viz.Draw
+// file:      OGLImage_Exec_Rows.cxx
+//
+// summary:   ogl image row kernels
+//
+//            Copyright (c) 2019 by Christian Perwass.
+//
+//            This file is part of the CluTecLib library.
+//
+//            The CluTecLib library is free software: you can redistribute it and / or modify
+//            it under the terms of the GNU Lesser General Public License as published by
+//            the Free Software Foundation, either version 3 of the License, or
+//            (at your option) any later version.
+//
+//            The CluTecLib library is distributed in the hope that it will be useful,
+//            but WITHOUT ANY WARRANTY; without even the implied warranty of
+//            MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//            GNU Lesser General Public License for more details.
+//
+//            You should have received a copy of the GNU Lesser General Public License
+//            along with the CluTecLib library.
+//            If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Pointwise operators are executed on consecutive blocks of pixels. Images with at least
+// OGLIMAGE_PAR_MIN_PIXELS pixels are split over the thread pool of the matrix kernels.
+// The vectorized kernels convert the pixel values to double, exactly as Pixel2Float() and
+// Float2Pixel() do, so that they give the same results as the per pixel functors.
+
+// Minimal number of pixels of an image that is split over threads
+#define OGLIMAGE_PAR_MIN_PIXELS		(256 * 256)
+// Minimal number of pixels processed by one thread
+#define OGLIMAGE_PAR_GRAIN			(32 * 1024)
+// Number of pixels processed at a time by the vectorized kernels
+#define OGLIMAGE_VEC_BLOCK			256
+
+static COGLImage::EPixelKernel s_ePixelKernel = COGLImage::PIXKERNEL_PARALLEL;
+
+void COGLImage::SetPixelKernel(EPixelKernel eKernel, int iThreadCount)
+{
+	s_ePixelKernel = eKernel;
+
+	if (iThreadCount >= 0)
+	{
+		CMatrixThreadPool::Global().SetThreadCount(uint(iThreadCount));
+	}
+}
+
+COGLImage::EPixelKernel COGLImage::GetPixelKernel()
+{
+	return s_ePixelKernel;
+}
+
+static inline bool UsePixelKernelParallel(int iPixelCount)
+{
+	return s_ePixelKernel == COGLImage::PIXKERNEL_PARALLEL && iPixelCount >= OGLIMAGE_PAR_MIN_PIXELS;
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// Four double values, which are processed together
+
+#if defined(MATKERNEL_USE_AVX)
+
+struct TPixelKernelVec
+{
+	__m256d xVal;
+};
+
+static inline TPixelKernelVec PixelKernelVec(double dValue)
+{
+	TPixelKernelVec xR;
+	xR.xVal = _mm256_set1_pd(dValue);
+	return xR;
+}
+
+#define OGLIMAGE_VEC_OP( NAME, AVXOP, SSEOP ) \
+	static inline TPixelKernelVec NAME(const TPixelKernelVec& xA, const TPixelKernelVec& xB) \
+	{ \
+		TPixelKernelVec xR; \
+		xR.xVal = AVXOP(xA.xVal, xB.xVal); \
+		return xR; \
+	}
+
+#elif defined(MATKERNEL_USE_SSE2)
+
+struct TPixelKernelVec
+{
+	__m128d xVal0, xVal1;
+};
+
+static inline TPixelKernelVec PixelKernelVec(double dValue)
+{
+	TPixelKernelVec xR;
+	xR.xVal0 = xR.xVal1 = _mm_set1_pd(dValue);
+	return xR;
+}
+
+#define OGLIMAGE_VEC_OP( NAME, AVXOP, SSEOP ) \
+	static inline TPixelKernelVec NAME(const TPixelKernelVec& xA, const TPixelKernelVec& xB) \
+	{ \
+		TPixelKernelVec xR; \
+		xR.xVal0 = SSEOP(xA.xVal0, xB.xVal0); \
+		xR.xVal1 = SSEOP(xA.xVal1, xB.xVal1); \
+		return xR; \
+	}
+
+#endif
+
+#if defined(MATKERNEL_USE_AVX) || defined(MATKERNEL_USE_SSE2)
+	#define OGLIMAGE_USE_VEC
+
+	OGLIMAGE_VEC_OP(PixelKernelVecAdd, _mm256_add_pd, _mm_add_pd)
+	OGLIMAGE_VEC_OP(PixelKernelVecSub, _mm256_sub_pd, _mm_sub_pd)
+	OGLIMAGE_VEC_OP(PixelKernelVecMul, _mm256_mul_pd, _mm_mul_pd)
+	OGLIMAGE_VEC_OP(PixelKernelVecMin, _mm256_min_pd, _mm_min_pd)
+	OGLIMAGE_VEC_OP(PixelKernelVecMax, _mm256_max_pd, _mm_max_pd)
+#endif
+
+#undef OGLIMAGE_VEC_OP
+
+////////////////////////////////////////////////////////////////////////////////////
+// Conversion of four pixel values to double and back, exactly as Pixel2Float() and Float2Pixel().
+// Only the data types with a specialization are supported by the vectorized kernels.
+
+#if defined(OGLIMAGE_USE_VEC)
+
+template<class TType>
+struct TPixelKernelConv
+{
+	static const bool bSupported = false;
+
+	static inline TPixelKernelVec Load(const TType* pSrc) { return PixelKernelVec(0.0); }
+	static inline void Store(TType* pTrg, const TPixelKernelVec& xVal) { }
+};
+
+template<>
+struct TPixelKernelConv<unsigned char>
+{
+	static const bool bSupported = true;
+
+	static inline TPixelKernelVec Load(const unsigned char* pSrc)
+	{
+		TPixelKernelVec xR;
+		int iVal;
+
+		memcpy(&iVal, pSrc, 4);
+		__m128i xInt = _mm_cvtsi32_si128(iVal);
+		xInt = _mm_unpacklo_epi8(xInt, _mm_setzero_si128());
+		xInt = _mm_unpacklo_epi16(xInt, _mm_setzero_si128());
+
+#if defined(MATKERNEL_USE_AVX)
+		xR.xVal = _mm256_div_pd(_mm256_cvtepi32_pd(xInt), _mm256_set1_pd(double(UCHAR_MAX)));
+#else
+		xR.xVal0 = _mm_div_pd(_mm_cvtepi32_pd(xInt), _mm_set1_pd(double(UCHAR_MAX)));
+		xR.xVal1 = _mm_div_pd(_mm_cvtepi32_pd(_mm_shuffle_epi32(xInt, 0xEE)), _mm_set1_pd(double(UCHAR_MAX)));
+#endif
+		return xR;
+	}
+
+	static inline void Store(unsigned char* pTrg, const TPixelKernelVec& xVal)
+	{
+		TPixelKernelVec xC = PixelKernelVecMax(PixelKernelVec(0.0), PixelKernelVecMin(PixelKernelVec(1.0), xVal));
+		xC = PixelKernelVecMul(xC, PixelKernelVec(double(UCHAR_MAX)));
+
+#if defined(MATKERNEL_USE_AVX)
+		__m128i xInt = _mm256_cvttpd_epi32(xC.xVal);
+#else
+		__m128i xInt = _mm_unpacklo_epi64(_mm_cvttpd_epi32(xC.xVal0), _mm_cvttpd_epi32(xC.xVal1));
+#endif
+		xInt = _mm_packus_epi16(_mm_packs_epi32(xInt, xInt), xInt);
+		int iVal = _mm_cvtsi128_si32(xInt);
+		memcpy(pTrg, &iVal, 4);
+	}
+};
+
+template<>
+struct TPixelKernelConv<unsigned short>
+{
+	static const bool bSupported = true;
+
+	static inline TPixelKernelVec Load(const unsigned short* pSrc)
+	{
+		TPixelKernelVec xR;
+
+		__m128i xInt = _mm_loadl_epi64((const __m128i*) pSrc);
+		xInt = _mm_unpacklo_epi16(xInt, _mm_setzero_si128());
+
+#if defined(MATKERNEL_USE_AVX)
+		xR.xVal = _mm256_div_pd(_mm256_cvtepi32_pd(xInt), _mm256_set1_pd(double(USHRT_MAX)));
+#else
+		xR.xVal0 = _mm_div_pd(_mm_cvtepi32_pd(xInt), _mm_set1_pd(double(USHRT_MAX)));
+		xR.xVal1 = _mm_div_pd(_mm_cvtepi32_pd(_mm_shuffle_epi32(xInt, 0xEE)), _mm_set1_pd(double(USHRT_MAX)));
+#endif
+		return xR;
+	}
+
+	// SSE2 can only pack to signed 16 bit values. The values are therefore shifted
+	// by 0x8000 before packing and shifted back afterwards.
+	static inline void Store(unsigned short* pTrg, const TPixelKernelVec& xVal)
+	{
+		TPixelKernelVec xC = PixelKernelVecMax(PixelKernelVec(0.0), PixelKernelVecMin(PixelKernelVec(1.0), xVal));
+		xC = PixelKernelVecMul(xC, PixelKernelVec(double(USHRT_MAX)));
+
+#if defined(MATKERNEL_USE_AVX)
+		__m128i xInt = _mm256_cvttpd_epi32(xC.xVal);
+#else
+		__m128i xInt = _mm_unpacklo_epi64(_mm_cvttpd_epi32(xC.xVal0), _mm_cvttpd_epi32(xC.xVal1));
+#endif
+		xInt = _mm_sub_epi32(xInt, _mm_set1_epi32(0x8000));
+		xInt = _mm_xor_si128(_mm_packs_epi32(xInt, xInt), _mm_set1_epi16(short(0x8000)));
+		_mm_storel_epi64((__m128i*) pTrg, xInt);
+	}
+};
+
+template<>
+struct TPixelKernelConv<float>
+{
+	static const bool bSupported = true;
+
+	static inline TPixelKernelVec Load(const float* pSrc)
+	{
+		TPixelKernelVec xR;
+		__m128 xFlt = _mm_loadu_ps(pSrc);
+
+#if defined(MATKERNEL_USE_AVX)
+		xR.xVal = _mm256_cvtps_pd(xFlt);
+#else
+		xR.xVal0 = _mm_cvtps_pd(xFlt);
+		xR.xVal1 = _mm_cvtps_pd(_mm_movehl_ps(xFlt, xFlt));
+#endif
+		return xR;
+	}
+
+	// Values above the largest float are clamped. The maximum is the first operand of the
+	// min instruction, so that NaN values are passed on as in Float2Pixel().
+	static inline void Store(float* pTrg, const TPixelKernelVec& xVal)
+	{
+		TPixelKernelVec xC = PixelKernelVecMin(PixelKernelVec(double(std::numeric_limits<float>::max())), xVal);
+
+#if defined(MATKERNEL_USE_AVX)
+		_mm_storeu_ps(pTrg, _mm256_cvtpd_ps(xC.xVal));
+#else
+		_mm_storeu_ps(pTrg, _mm_movelh_ps(_mm_cvtpd_ps(xC.xVal0), _mm_cvtpd_ps(xC.xVal1)));
+#endif
+	}
+};
+
+#endif	// OGLIMAGE_USE_VEC
+
+////////////////////////////////////////////////////////////////////////////////////
+// Operators on the double values of one or two images
+
+struct FPixelKernelMultScalar
+{
+	double dValue;
+
+	FPixelKernelMultScalar(double _dValue) { dValue = _dValue; }
+
+	double operator()(double dA, double dB) const { return dA * dValue; }
+
+#if defined(OGLIMAGE_USE_VEC)
+	TPixelKernelVec operator()(const TPixelKernelVec& xA, const TPixelKernelVec& xB) const
+	{ return PixelKernelVecMul(xA, PixelKernelVec(dValue)); }
+#endif
+};
+
+struct FPixelKernelAddScalar
+{
+	double dValue;
+
+	FPixelKernelAddScalar(double _dValue) { dValue = _dValue; }
+
+	double operator()(double dA, double dB) const { return dA + dValue; }
+
+#if defined(OGLIMAGE_USE_VEC)
+	TPixelKernelVec operator()(const TPixelKernelVec& xA, const TPixelKernelVec& xB) const
+	{ return PixelKernelVecAdd(xA, PixelKernelVec(dValue)); }
+#endif
+};
+
+struct FPixelKernelAdd
+{
+	double operator()(double dA, double dB) const { return dA + dB; }
+
+#if defined(OGLIMAGE_USE_VEC)
+	TPixelKernelVec operator()(const TPixelKernelVec& xA, const TPixelKernelVec& xB) const
+	{ return PixelKernelVecAdd(xA, xB); }
+#endif
+};
+
+struct FPixelKernelSub
+{
+	double operator()(double dA, double dB) const { return dA - dB; }
+
+#if defined(OGLIMAGE_USE_VEC)
+	TPixelKernelVec operator()(const TPixelKernelVec& xA, const TPixelKernelVec& xB) const
+	{ return PixelKernelVecSub(xA, xB); }
+#endif
+};
+
+struct FPixelKernelMult
+{
+	double operator()(double dA, double dB) const { return dA * dB; }
+
+#if defined(OGLIMAGE_USE_VEC)
+	TPixelKernelVec operator()(const TPixelKernelVec& xA, const TPixelKernelVec& xB) const
+	{ return PixelKernelVecMul(xA, xB); }
+#endif
+};
+
+////////////////////////////////////////////////////////////////////////////////////
+// Vectorized kernels
+
+#if defined(OGLIMAGE_USE_VEC)
+
+template< class TPx, class TOp >
+bool COGLImage::ExecuteVectorBlocks(TPx* pTrg, const TPx* pSrc1, const TPx* pSrc2, int iPixelCount, bool bCopyAlpha, const TOp& xOp)
+{
+	typedef typename TPx::TType TType;
+	typedef TPixelKernelConv<TType> TConv;
+
+	if (!TConv::bSupported)
+	{
+		return false;
+	}
+
+	const int iElCnt = int(TPx::uColorCnt + TPx::uAlphaCnt);
+
+	TType ptAlpha[OGLIMAGE_VEC_BLOCK];
+	TType tAlphaOne;
+	int iPix, iBlockCnt, iIdx, iCnt;
+	double dVal1, dVal2;
+
+	Float2Pixel(tAlphaOne, 1.0);
+
+	for (iPix = 0; iPix < iPixelCount; iPix += iBlockCnt)
+	{
+		iBlockCnt = std::min(OGLIMAGE_VEC_BLOCK, iPixelCount - iPix);
+		iCnt      = iBlockCnt * iElCnt;
+
+		// The alpha values are read before anything is written, since pTrg may be equal to pSrc1.
+		if (TPx::uAlphaCnt)
+		{
+			for (iIdx = 0; iIdx < iBlockCnt; ++iIdx)
+			{
+				ptAlpha[iIdx] = (bCopyAlpha ? pSrc1[iPix + iIdx].a() : tAlphaOne);
+			}
+		}
+
+		TType* pT        = (TType*) (pTrg + iPix);
+		const TType* pS1 = (const TType*) (pSrc1 + iPix);
+		const TType* pS2 = (pSrc2 ? (const TType*) (pSrc2 + iPix) : pS1);
+
+		for (iIdx = 0; iIdx + 4 <= iCnt; iIdx += 4)
+		{
+			TConv::Store(pT + iIdx, xOp(TConv::Load(pS1 + iIdx), TConv::Load(pS2 + iIdx)));
+		}
+
+		for (; iIdx < iCnt; ++iIdx)
+		{
+			Pixel2Float(dVal1, pS1[iIdx]);
+			Pixel2Float(dVal2, pS2[iIdx]);
+			Float2Pixel(pT[iIdx], xOp(dVal1, dVal2));
+		}
+
+		if (TPx::uAlphaCnt)
+		{
+			for (iIdx = 0; iIdx < iBlockCnt; ++iIdx)
+			{
+				pTrg[iPix + iIdx].a() = ptAlpha[iIdx];
+			}
+		}
+	}
+
+	return true;
+}
+
+#else
+
+template< class TPx, class TOp >
+bool COGLImage::ExecuteVectorBlocks(TPx* pTrg, const TPx* pSrc1, const TPx* pSrc2, int iPixelCount, bool bCopyAlpha, const TOp& xOp)
+{
+	return false;
+}
+
+#endif	// OGLIMAGE_USE_VEC
+
+template< class TPx >
+bool COGLImage::ExecuteVectorKernel(FOpMultScalar<TPx, TPx>* pFunctor, TPx* pTrg, TPx* pSrc, const POpScalar& rPar)
+{
+	return ExecuteVectorBlocks(pTrg, pSrc, (const TPx*) 0, rPar.iWidth * rPar.iHeight, true, FPixelKernelMultScalar(rPar.dValue));
+}
+
+template< class TPx >
+bool COGLImage::ExecuteVectorKernel(FOpAddScalar<TPx, TPx>* pFunctor, TPx* pTrg, TPx* pSrc, const POpScalar& rPar)
+{
+	return ExecuteVectorBlocks(pTrg, pSrc, (const TPx*) 0, rPar.iWidth * rPar.iHeight, true, FPixelKernelAddScalar(rPar.dValue));
+}
+
+template< class TPx >
+bool COGLImage::ExecuteVectorKernel(FOpAddImg<TPx, TPx, TPx>* pFunctor, TPx* pTrg, TPx* pSrc1, TPx* pSrc2, const PPixCnt& rPar)
+{
+	return ExecuteVectorBlocks(pTrg, pSrc1, pSrc2, rPar.iPixelCount, false, FPixelKernelAdd());
+}
+
+template< class TPx >
+bool COGLImage::ExecuteVectorKernel(FOpSubImg<TPx, TPx, TPx>* pFunctor, TPx* pTrg, TPx* pSrc1, TPx* pSrc2, const PPixCnt& rPar)
+{
+	return ExecuteVectorBlocks(pTrg, pSrc1, pSrc2, rPar.iPixelCount, false, FPixelKernelSub());
+}
+
+template< class TPx >
+bool COGLImage::ExecuteVectorKernel(FOpMultImg<TPx, TPx, TPx>* pFunctor, TPx* pTrg, TPx* pSrc1, TPx* pSrc2, const PPixCnt& rPar)
+{
+	return ExecuteVectorBlocks(pTrg, pSrc1, pSrc2, rPar.iPixelCount, false, FPixelKernelMult());
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// Execution on blocks of pixels
+
+template< class Functor, class TPxL, class Parameter >
+bool COGLImage::ExecuteRows(TPxL* pTrg, Parameter& rPar)
+{
+	int iPixelCount = GetRowPixelCount(rPar);
+
+	if ((iPixelCount < 0) || (s_ePixelKernel == PIXKERNEL_SCALAR))
+	{
+		return Functor::Execute(pTrg, rPar);
+	}
+
+	std::atomic<bool> bResult(true);
+
+	MatrixParallelFor(UsePixelKernelParallel(iPixelCount), 0, size_t(iPixelCount), OGLIMAGE_PAR_GRAIN,
+		[&](size_t nBegin, size_t nEnd)
+	{
+		Parameter xPar(rPar);
+		SetRowPixelCount(xPar, int(nEnd - nBegin));
+
+		if (!Functor::Execute(pTrg + nBegin, xPar))
+		{
+			bResult = false;
+		}
+	});
+
+	return bResult;
+}
+
+template< class Functor, class TPxL, class TPxR, class Parameter >
+bool COGLImage::ExecuteRows(TPxL* pTrg, TPxR* pSrc, Parameter& rPar)
+{
+	int iPixelCount = GetRowPixelCount(rPar);
+
+	if ((iPixelCount < 0) || (s_ePixelKernel == PIXKERNEL_SCALAR))
+	{
+		return Functor::Execute(pTrg, pSrc, rPar);
+	}
+
+	std::atomic<bool> bResult(true);
+
+	MatrixParallelFor(UsePixelKernelParallel(iPixelCount), 0, size_t(iPixelCount), OGLIMAGE_PAR_GRAIN,
+		[&](size_t nBegin, size_t nEnd)
+	{
+		Parameter xPar(rPar);
+		SetRowPixelCount(xPar, int(nEnd - nBegin));
+
+		if (!ExecuteVectorKernel((Functor*) 0, pTrg + nBegin, pSrc + nBegin, xPar)
+		    && !Functor::Execute(pTrg + nBegin, pSrc + nBegin, xPar))
+		{
+			bResult = false;
+		}
+	});
+
+	return bResult;
+}
+
+template< class Functor, class TPxL, class TPxR1, class TPxR2, class Parameter >
+bool COGLImage::ExecuteRows(TPxL* pTrg, TPxR1* pSrc1, TPxR2* pSrc2, Parameter& rPar)
+{
+	int iPixelCount = GetRowPixelCount(rPar);
+
+	if ((iPixelCount < 0) || (s_ePixelKernel == PIXKERNEL_SCALAR))
+	{
+		return Functor::Execute(pTrg, pSrc1, pSrc2, rPar);
+	}
+
+	std::atomic<bool> bResult(true);
+
+	MatrixParallelFor(UsePixelKernelParallel(iPixelCount), 0, size_t(iPixelCount), OGLIMAGE_PAR_GRAIN,
+		[&](size_t nBegin, size_t nEnd)
+	{
+		Parameter xPar(rPar);
+		SetRowPixelCount(xPar, int(nEnd - nBegin));
+
+		if (!ExecuteVectorKernel((Functor*) 0, pTrg + nBegin, pSrc1 + nBegin, pSrc2 + nBegin, xPar)
+		    && !Functor::Execute(pTrg + nBegin, pSrc1 + nBegin, pSrc2 + nBegin, xPar))
+		{
+			bResult = false;
+		}
+	});
+
+	return bResult;
+}
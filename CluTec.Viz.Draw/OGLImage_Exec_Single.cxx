@@ -25,7 +25,7 @@
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
 // Define to simplify code in ExecutePixelOperator
-#define EXECPIXELOP( PXTYPE ) Functor<PXTYPE>::Execute( (PXTYPE *) rTrg.GetDataPtr(), rPar )
+#define EXECPIXELOP( PXTYPE ) ExecuteRows< Functor<PXTYPE> >( (PXTYPE *) rTrg.GetDataPtr(), rPar )
 
 template< template<class TPxL> class Functor, class Parameter >
 bool COGLImage::ExecutePixelOperator( COGLImage &rTrg, Parameter& rPar )
@@ -110,39 +110,47 @@ bool COGLImage::FInsChanImg<TPxL, TPxR>::Execute( TPxL *pTrg, TPxL *pSrc, const
 template < class TPxL, class TPxR >
 bool COGLImage::FRot90Img<TPxL, TPxR>::Execute( TPxL *pTrg, TPxL *pSrc, const PRot90Img& rPar )
 {
-	int iSrcPos, iTrgPos, iSrcX, iSrcY, iSize;
+	int iSize;
 
 	iSize = rPar.iTrgWidth * rPar.iTrgHeight;
 
-	if (rPar.iSteps == 1)
+	// Each source row is written to its own target column or row, so that
+	// blocks of source rows can be processed in parallel.
+	MatrixParallelFor(UsePixelKernelParallel(iSize), 0, size_t(rPar.iSrcHeight), OGLIMAGE_PAR_GRAIN / std::max(rPar.iSrcWidth, 1) + 1,
+		[&](size_t nBegin, size_t nEnd)
 	{
-		for (iSrcY = 0, iSrcPos = 0; iSrcY < rPar.iSrcHeight; iSrcY++)
+		int iSrcPos, iTrgPos, iSrcX, iSrcY;
+
+		if (rPar.iSteps == 1)
 		{
-			iTrgPos = rPar.iTrgWidth - iSrcY - 1;
-			for (iSrcX = 0; iSrcX < rPar.iSrcWidth; iSrcX++, iSrcPos++, iTrgPos += rPar.iTrgWidth)
+			for (iSrcY = int(nBegin), iSrcPos = iSrcY * rPar.iSrcWidth; iSrcY < int(nEnd); iSrcY++)
 			{
-				pTrg[iTrgPos] = pSrc[iSrcPos];
-			} 
+				iTrgPos = rPar.iTrgWidth - iSrcY - 1;
+				for (iSrcX = 0; iSrcX < rPar.iSrcWidth; iSrcX++, iSrcPos++, iTrgPos += rPar.iTrgWidth)
+				{
+					pTrg[iTrgPos] = pSrc[iSrcPos];
+				}
+			}
 		}
-	}
-	else if (rPar.iSteps == 2)
-	{
-		for (iTrgPos = iSize - 1, iSrcPos = 0; iTrgPos >= 0; iTrgPos--, iSrcPos++)
+		else if (rPar.iSteps == 2)
 		{
-			pTrg[iTrgPos] = pSrc[iSrcPos];
+			for (iSrcPos = int(nBegin) * rPar.iSrcWidth, iTrgPos = iSize - 1 - iSrcPos; iSrcPos < int(nEnd) * rPar.iSrcWidth; iTrgPos--, iSrcPos++)
+			{
+				pTrg[iTrgPos] = pSrc[iSrcPos];
+			}
 		}
-	}
-	else if (rPar.iSteps == 3)
-	{
-		for (iSrcY = 0, iSrcPos = 0; iSrcY < rPar.iSrcHeight; iSrcY++)
+		else if (rPar.iSteps == 3)
 		{
-			iTrgPos = iSize - rPar.iTrgWidth + iSrcY;
-			for (iSrcX = 0; iSrcX < rPar.iSrcWidth; iSrcX++, iSrcPos++, iTrgPos -= rPar.iTrgWidth)
+			for (iSrcY = int(nBegin), iSrcPos = iSrcY * rPar.iSrcWidth; iSrcY < int(nEnd); iSrcY++)
 			{
-				pTrg[iTrgPos] = pSrc[iSrcPos];
+				iTrgPos = iSize - rPar.iTrgWidth + iSrcY;
+				for (iSrcX = 0; iSrcX < rPar.iSrcWidth; iSrcX++, iSrcPos++, iTrgPos -= rPar.iTrgWidth)
+				{
+					pTrg[iTrgPos] = pSrc[iSrcPos];
+				}
 			}
 		}
-	}
+	});
 
 	return true;
 }
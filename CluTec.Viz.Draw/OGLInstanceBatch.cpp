@@ -0,0 +1,157 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// project:   CluTec.Viz.Draw
+// file:      OGLInstanceBatch.cpp
+//
+// summary:   Implements the element that draws many instances of one mesh
+//
+//            Copyright (c) 2019 by Christian Perwass.
+//
+//            This file is part of the CluTecLib library.
+//
+//            The CluTecLib library is free software: you can redistribute it and / or modify
+//            it under the terms of the GNU Lesser General Public License as published by
+//            the Free Software Foundation, either version 3 of the License, or
+//            (at your option) any later version.
+//
+//            The CluTecLib library is distributed in the hope that it will be useful,
+//            but WITHOUT ANY WARRANTY; without even the implied warranty of
+//            MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//            GNU Lesser General Public License for more details.
+//
+//            You should have received a copy of the GNU Lesser General Public License
+//            along with the CluTecLib library.
+//            If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "StdAfx.h"
+#include "CluTec.Viz.OpenGL\Api.h"
+#include "OGLInstanceBatch.h"
+
+#include <cstring>
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+COGLInstanceBatch::COGLInstanceBatch()
+{
+	m_sTypeName = "InstanceBatch";
+
+	Reset();
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+COGLInstanceBatch::COGLInstanceBatch(const COGLInstanceBatch& rBatch)
+{
+	m_sTypeName = "InstanceBatch";
+
+	*this = rBatch;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+COGLInstanceBatch& COGLInstanceBatch::operator=(const COGLInstanceBatch& rBatch)
+{
+	COGLBaseElement::operator=(rBatch);
+
+	// The mesh is shared, only the instances are copied
+	m_uMeshKey    = rBatch.m_uMeshKey;
+	m_vecMesh     = rBatch.m_vecMesh;
+	m_vecInstance = rBatch.m_vecInstance;
+
+	return *this;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void COGLInstanceBatch::Reset()
+{
+	m_uMeshKey = 0;
+	m_vecMesh.clear();
+	m_vecInstance.clear();
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void COGLInstanceBatch::SetMesh(unsigned uMeshKey, const std::vector<COGLBEReference>& vecMesh)
+{
+	m_uMeshKey = uMeshKey;
+	m_vecMesh  = vecMesh;
+	m_vecInstance.clear();
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void COGLInstanceBatch::AddInstance(const float* pfTransform, const float* pfColor)
+{
+	m_vecInstance.resize(m_vecInstance.size() + 1);
+	SInstance& rInst = m_vecInstance.back();
+
+	memcpy(rInst.pfTransform, pfTransform, 16 * sizeof(float));
+
+	if (pfColor)
+	{
+		memcpy(rInst.pfColor, pfColor, 4 * sizeof(float));
+		rInst.bHasColor = true;
+	}
+	else
+	{
+		memset(rInst.pfColor, 0, 4 * sizeof(float));
+		rInst.bHasColor = false;
+	}
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+bool COGLInstanceBatch::Apply(COGLBaseElement::EApplyMode eMode, COGLBaseElement::SApplyData& rData)
+{
+	if (m_vecInstance.empty())
+	{
+		return true;
+	}
+
+	bool bPickMode   = (eMode == COGLBaseElement::PICK);
+	bool bApplied    = true;
+	bool bColorIsSet = false;
+
+	// Instances without color are drawn in the color that is current when the batch is applied
+	float pfColor[4];
+	memcpy(pfColor, rData.pfCurColor, 4 * sizeof(float));
+
+	// The instance transformations contain scalings
+	GLboolean bNormalize = glIsEnabled(GL_NORMALIZE);
+	CLU_OGL_CALL(glEnable(GL_NORMALIZE));
+
+	for (const SInstance& rInst : m_vecInstance)
+	{
+		if (!bPickMode && (rInst.bHasColor || bColorIsSet))
+		{
+			const float* pfInstColor = (rInst.bHasColor ? rInst.pfColor : pfColor);
+
+			CLU_OGL_CALL(glColor4fv(pfInstColor));
+			memcpy(rData.pfCurColor, pfInstColor, 4 * sizeof(float));
+			bColorIsSet = rInst.bHasColor;
+		}
+
+		rData.xMatrixStack.Push(Clu::CMatrixStack::ModelView);
+		rData.xMatrixStack.MultMatrix(rInst.pfTransform);
+
+		for (COGLBEReference& rMesh : m_vecMesh)
+		{
+			if (rMesh.IsValid() && !rMesh->Apply(eMode, rData))
+			{
+				bApplied = false;
+			}
+		}
+
+		rData.xMatrixStack.Pop(Clu::CMatrixStack::ModelView);
+	}
+
+	// The colors following the batch in the scene set the current color,
+	// so that the batch does not change it.
+	if (bColorIsSet)
+	{
+		CLU_OGL_CALL(glColor4fv(pfColor));
+		memcpy(rData.pfCurColor, pfColor, 4 * sizeof(float));
+	}
+
+	if (!bNormalize)
+	{
+		CLU_OGL_CALL(glDisable(GL_NORMALIZE));
+	}
+
+	return bApplied;
+}
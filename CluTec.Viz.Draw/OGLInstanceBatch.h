@@ -0,0 +1,91 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// project:   CluTec.Viz.Draw
+// file:      OGLInstanceBatch.h
+//
+// summary:   Declares the element that draws many instances of one mesh
+//
+//            Copyright (c) 2019 by Christian Perwass.
+//
+//            This file is part of the CluTecLib library.
+//
+//            The CluTecLib library is free software: you can redistribute it and / or modify
+//            it under the terms of the GNU Lesser General Public License as published by
+//            the Free Software Foundation, either version 3 of the License, or
+//            (at your option) any later version.
+//
+//            The CluTecLib library is distributed in the hope that it will be useful,
+//            but WITHOUT ANY WARRANTY; without even the implied warranty of
+//            MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//            GNU Lesser General Public License for more details.
+//
+//            You should have received a copy of the GNU Lesser General Public License
+//            along with the CluTecLib library.
+//            If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <vector>
+
+#include "OGLBaseElement.h"
+#include "OGLBEReference.h"
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// <summary>
+/// 	Draws many instances of one mesh with different transformations and colors.
+///
+/// 	The mesh is a list of vertex lists that is shared between all batches drawing the same primitive.
+/// 	Each instance stores a column major 4x4 transformation that is multiplied onto the model view matrix
+/// 	and optionally a color. Instances without color use the color that is current when the batch is applied.
+/// 	The batch leaves the current color unchanged.
+/// 	The mesh is replayed for each instance, i.e. there is still one draw call per instance and vertex list.
+/// 	The saving is in the scene, which holds one element for all instances instead of separate vertex lists,
+/// 	and in the vertex buffers, which are shared by all instances and only uploaded once.
+/// </summary>
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+class CLUDRAW_API COGLInstanceBatch : public COGLBaseElement
+{
+public:
+
+	struct SInstance
+	{
+		float pfTransform[16];
+		float pfColor[4];
+		bool bHasColor;
+	};
+
+public:
+
+	COGLInstanceBatch();
+	COGLInstanceBatch(const COGLInstanceBatch& rBatch);
+
+	virtual COGLBaseElement* Copy()
+	{
+		return (COGLBaseElement*) new COGLInstanceBatch(*this);
+	}
+
+	COGLInstanceBatch& operator=(const COGLInstanceBatch& rBatch);
+
+	void Reset();
+
+	// Set the mesh and the key identifying it. Removes all instances.
+	void SetMesh(unsigned uMeshKey, const std::vector<COGLBEReference>& vecMesh);
+
+	unsigned GetMeshKey() const { return m_uMeshKey; }
+	const std::vector<COGLBEReference>& GetMesh() const { return m_vecMesh; }
+
+	// Add an instance. If pfColor is null, the instance is drawn in the current color.
+	void AddInstance(const float* pfTransform, const float* pfColor = nullptr);
+
+	size_t GetInstanceCount() const { return m_vecInstance.size(); }
+	const std::vector<SInstance>& GetInstanceList() const { return m_vecInstance; }
+
+	bool Apply(COGLBaseElement::EApplyMode eMode, COGLBaseElement::SApplyData& rData);
+
+protected:
+
+	unsigned m_uMeshKey;
+	std::vector<COGLBEReference> m_vecMesh;
+	std::vector<SInstance> m_vecInstance;
+};
@@ -58,6 +58,9 @@ public:
 
 	bool Apply(COGLBaseElement::EApplyMode eMode, COGLBaseElement::SApplyData &rData);
 
+	// Does not draw anything, but changes state
+	const SBoundInfo& GetBoundInfo() { return GetStateBoundInfo(); }
+
 protected:
 	GLfloat m_fWidth;
 };
@@ -176,6 +176,44 @@ void COGLMVFilter::SetSensitivity(double dSens)
 	m_El2Filter.SetSensitivity(dSens);
 }
 
+//////////////////////////////////////////////////////////////////////
+/// Multivector Analysis Cache
+
+void COGLMVFilter::EnableMVInfoCache(bool bVal)
+{
+	COGLMVFilterBase::EnableMVInfoCache(bVal);
+
+	m_E3Filter.EnableMVInfoCache(bVal);
+	m_P3Filter.EnableMVInfoCache(bVal);
+	m_N3Filter.EnableMVInfoCache(bVal);
+	m_El2Filter.EnableMVInfoCache(bVal);
+}
+
+void COGLMVFilter::GetMVInfoCacheStats(unsigned& uHitCnt, unsigned& uMissCnt) const
+{
+	const COGLMVFilterBase* ppFilter[] = { &m_E3Filter, &m_P3Filter, &m_N3Filter, &m_El2Filter };
+
+	uHitCnt  = 0;
+	uMissCnt = 0;
+
+	for (const COGLMVFilterBase* pFilter : ppFilter)
+	{
+		unsigned uHit, uMiss;
+
+		pFilter->GetMVInfoCacheStats(uHit, uMiss);
+		uHitCnt  += uHit;
+		uMissCnt += uMiss;
+	}
+}
+
+void COGLMVFilter::ResetMVInfoCacheStats()
+{
+	m_E3Filter.ResetMVInfoCacheStats();
+	m_P3Filter.ResetMVInfoCacheStats();
+	m_N3Filter.ResetMVInfoCacheStats();
+	m_El2Filter.ResetMVInfoCacheStats();
+}
+
 
 //////////////////////////////////////////////////////////////////////
 /// Get MV Info
@@ -57,6 +57,11 @@ public:
 		
 	void SetSensitivity(double dSens);
 
+	// Enable the caches of multivector analyses and get their statistics summed over all algebras
+	void EnableMVInfoCache(bool bVal = true);
+	void GetMVInfoCacheStats(unsigned& uHitCnt, unsigned& uMissCnt) const;
+	void ResetMVInfoCacheStats();
+
 	CMVInfo<float> GetMVInfo();
 	void GetMVInfo(CMVInfo<float> &rInfo);
 	void GetMVInfo(CMVInfo<double> &rInfo);
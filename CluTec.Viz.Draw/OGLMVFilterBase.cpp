@@ -48,6 +48,9 @@
 //#include "OGLObjWireSphere.h"
 #include "CluTec.Viz.Fltk\Fl_math.h"
 
+#include <cmath>
+#include <cstring>
+
 //////////////////////////////////////////////////////////////////////
 // Konstruktion/Destruktion
 //////////////////////////////////////////////////////////////////////
@@ -59,6 +62,12 @@ COGLMVFilterBase::COGLMVFilterBase()
 	m_fPi = 2.0f * (float) asin(1.0);
 
 	m_fSensitivity = 1e-7f;
+	m_dSensitivity = 1e-7;
+
+	m_bUseMVInfoCache      = true;
+	m_nMVInfoCacheMaxCount = 1024;
+	m_uMVInfoCacheHitCnt   = 0;
+	m_uMVInfoCacheMissCnt  = 0;
 	
 	ResetModes();
 }
@@ -137,3 +146,118 @@ bool COGLMVFilterBase::CastMVInfoToFloat(CMVInfo<float>& fMVInfo, CMVInfo<double
 	return true;
 }
 
+
+//////////////////////////////////////////////////////////////////////
+/// Multivector Analysis Cache
+
+bool COGLMVFilterBase::SMVInfoKey::operator<(const SMVInfoKey& rKey) const
+{
+	if (uBaseID != rKey.uBaseID)
+		return uBaseID < rKey.uBaseID;
+
+	if (uMode != rKey.uMode)
+		return uMode < rKey.uMode;
+
+	if (dSens != rKey.dSens)
+		return dSens < rKey.dSens;
+
+	return vecCoef < rKey.vecCoef;
+}
+
+template<class CType>
+static bool QuantizeMVCoef(std::vector<long long>& vecCoef, MultiV<CType>& vA, CType tSens)
+{
+	uint i, n = vA.GetGADim();
+
+	vecCoef.resize(n);
+
+	for(i=0;i<n;i++)
+	{
+		double dVal = double(vA[i]);
+
+		if (tSens > CType(0))
+		{
+			dVal = floor(dVal / double(tSens) + 0.5);
+
+			// Also fails for NaN
+			if (!(fabs(dVal) < 9.0e18))
+				return false;
+
+			vecCoef[i] = (long long) dVal;
+		}
+		else
+		{
+			// Without sensitivity only identical coefficients are equal
+			vecCoef[i] = 0;
+			memcpy(&vecCoef[i], &dVal, sizeof(double));
+		}
+	}
+
+	return true;
+}
+
+bool COGLMVFilterBase::MakeMVInfoKey(SMVInfoKey& rKey, MultiV<float>& vA, uint uMode, float fSens)
+{
+	if (!m_bUseMVInfoCache || !vA.HasStyle())
+		return false;
+
+	rKey.uBaseID = vA.BasePtr()->BaseID();
+	rKey.uMode   = uMode;
+	rKey.dSens   = double(fSens);
+
+	return QuantizeMVCoef(rKey.vecCoef, vA, fSens);
+}
+
+bool COGLMVFilterBase::MakeMVInfoKey(SMVInfoKey& rKey, MultiV<double>& vA, uint uMode, double dSens)
+{
+	if (!m_bUseMVInfoCache || !vA.HasStyle())
+		return false;
+
+	// Distinguish double from float analyses of the same multivector
+	rKey.uBaseID = vA.BasePtr()->BaseID();
+	rKey.uMode   = uMode | 0x80000000;
+	rKey.dSens   = dSens;
+
+	return QuantizeMVCoef(rKey.vecCoef, vA, dSens);
+}
+
+bool COGLMVFilterBase::FindMVInfo(const SMVInfoKey& rKey)
+{
+	TMVInfoMap::iterator itEntry = m_mapMVInfoCache.find(rKey);
+
+	if (itEntry == m_mapMVInfoCache.end())
+	{
+		++m_uMVInfoCacheMissCnt;
+		return false;
+	}
+
+	// Move entry to front of list of recently used analyses
+	m_listMVInfoCache.splice(m_listMVInfoCache.begin(), m_listMVInfoCache, itEntry->second);
+
+	m_MVInfo  = itEntry->second->xInfo;
+	m_dMVInfo = itEntry->second->xDInfo;
+
+	++m_uMVInfoCacheHitCnt;
+	return true;
+}
+
+void COGLMVFilterBase::StoreMVInfo(const SMVInfoKey& rKey)
+{
+	if (m_nMVInfoCacheMaxCount == 0 || m_mapMVInfoCache.find(rKey) != m_mapMVInfoCache.end())
+		return;
+
+	while (m_listMVInfoCache.size() >= m_nMVInfoCacheMaxCount)
+	{
+		m_mapMVInfoCache.erase(m_listMVInfoCache.back().xKey);
+		m_listMVInfoCache.pop_back();
+	}
+
+	m_listMVInfoCache.push_front(SMVInfoEntry());
+
+	SMVInfoEntry& rEntry = m_listMVInfoCache.front();
+	rEntry.xKey   = rKey;
+	rEntry.xInfo  = m_MVInfo;
+	rEntry.xDInfo = m_dMVInfo;
+
+	m_mapMVInfoCache[rKey] = m_listMVInfoCache.begin();
+}
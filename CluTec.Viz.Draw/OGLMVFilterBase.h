@@ -47,6 +47,10 @@
 #include "OGLDrawBase.h"
 #include "OGLBERepository.h"
 
+#include <list>
+#include <map>
+#include <vector>
+
 #define MODE_OPNS	(ID_ALL << 16) + 0x0001
 #define MODE_IPNS	(ID_ALL << 16) + 0x0002
 #define DRAW_POINT_AS_DOT		(ID_ALL << 16) + 0x0100
@@ -136,9 +140,63 @@ public:
 	void GetMVInfo(CMVInfo<float> &rInfo) { rInfo = m_MVInfo; }
 	void GetMVInfo(CMVInfo<double> &rInfo) { rInfo = m_dMVInfo; }
 
+	// The analysis of multivectors is cached, so that a multivector that is drawn
+	// unchanged again is not analyzed again. The cache is keyed by the algebra,
+	// the analysis mode and the coefficients quantized by the sensitivity.
+	// If the cache is full, the least recently used analysis is removed.
+	void EnableMVInfoCache(bool bVal = true)
+	{ m_bUseMVInfoCache = bVal; ClearMVInfoCache(); }
+
+	bool IsMVInfoCacheEnabled() const
+	{ return m_bUseMVInfoCache; }
+
+	void SetMVInfoCacheSize(size_t nMaxCount)
+	{ m_nMVInfoCacheMaxCount = nMaxCount; ClearMVInfoCache(); }
+
+	void ClearMVInfoCache()
+	{ m_listMVInfoCache.clear(); m_mapMVInfoCache.clear(); }
+
+	void GetMVInfoCacheStats(unsigned& uHitCnt, unsigned& uMissCnt) const
+	{ uHitCnt = m_uMVInfoCacheHitCnt; uMissCnt = m_uMVInfoCacheMissCnt; }
+
+	void ResetMVInfoCacheStats()
+	{ m_uMVInfoCacheHitCnt = 0; m_uMVInfoCacheMissCnt = 0; }
+
+protected:
+	struct SMVInfoKey
+	{
+		uint uBaseID;
+		uint uMode;
+		double dSens;
+		std::vector<long long> vecCoef;
+
+		bool operator<(const SMVInfoKey& rKey) const;
+	};
+
+	struct SMVInfoEntry
+	{
+		SMVInfoKey xKey;
+		CMVInfo<float> xInfo;
+		CMVInfo<double> xDInfo;
+	};
+
+	typedef std::list<SMVInfoEntry> TMVInfoList;
+	typedef std::map<SMVInfoKey, TMVInfoList::iterator> TMVInfoMap;
+
 protected:
 	bool CastMVInfoToFloat(CMVInfo<float>& fMVInfo, CMVInfo<double>& dMVInfo);
 
+	// Create the cache key of vA. uMode has to contain all flags that influence the analysis.
+	// Returns false if the cache is disabled or vA cannot be quantized.
+	bool MakeMVInfoKey(SMVInfoKey& rKey, MultiV<float>& vA, uint uMode, float fSens);
+	bool MakeMVInfoKey(SMVInfoKey& rKey, MultiV<double>& vA, uint uMode, double dSens);
+
+	// Set m_MVInfo and m_dMVInfo from the cache. Returns false if rKey is not in the cache.
+	bool FindMVInfo(const SMVInfoKey& rKey);
+
+	// Store m_MVInfo and m_dMVInfo in the cache.
+	void StoreMVInfo(const SMVInfoKey& rKey);
+
 protected:
 	COGLDrawBase *m_pDrawBase;
 
@@ -160,6 +218,13 @@ protected:
 	double m_dSensitivity;
 
 	bool m_bShowImaginaryObjects;
+
+	bool m_bUseMVInfoCache;
+	size_t m_nMVInfoCacheMaxCount;
+	TMVInfoList m_listMVInfoCache;	// Most recently used analysis first
+	TMVInfoMap m_mapMVInfoCache;
+	unsigned m_uMVInfoCacheHitCnt;
+	unsigned m_uMVInfoCacheMissCnt;
 };
 
 #endif // !defined(AFX_OGLMVFILTERBASE_H__3D0F9FE0_C4C7_4C2C_9881_815CE941C428__INCLUDED_)
@@ -82,11 +82,16 @@ public:
 	{ m_Emission = pfVal; }
 
 	void Shininess(float fV) { m_fShininess = fV; }
-	void Face(GLenum eFace) { m_eFace = eFace; }
+	// A render queue only sorts materials for front and back faces
+	void Face(GLenum eFace) { m_eFace = eFace; InvalidateParentBounds(); }
+	GLenum GetFace() const { return m_eFace; }
 
 	bool Apply(COGLBaseElement::EApplyMode eMode, COGLBaseElement::SApplyData &rData);
 	bool Apply();
 
+	// Does not draw anything, but changes state
+	const SBoundInfo& GetBoundInfo() { return GetStateBoundInfo(); }
+
 protected:
 	COGLColor m_Ambient, m_Diffuse, m_Specular, m_Emission;
 	float m_fShininess;
@@ -176,9 +176,9 @@ bool COGLPeek::Apply(COGLBaseElement::EApplyMode eMode,
 
 	if ( m_uType & PT_FRAMES )
 	{
-		glGetDoublev( GL_PROJECTION_MATRIX, m_mProjMat.Data() );
-		glGetDoublev( GL_MODELVIEW_MATRIX, m_mModelMat.Data() );
-		glGetDoublev( GL_TEXTURE_MATRIX, m_mTexMat.Data() );
+		rData.xMatrixStack.GetMatrix( Clu::CMatrixStack::Projection, m_mProjMat.Data() );
+		rData.xMatrixStack.GetMatrix( Clu::CMatrixStack::ModelView, m_mModelMat.Data() );
+		rData.xMatrixStack.GetMatrix( Clu::CMatrixStack::Texture, m_mTexMat.Data() );
 		glGetIntegerv( GL_VIEWPORT, m_piViewport );
 
 		//mViewport(1,1) = double( m_piViewport[0] );
@@ -0,0 +1,1280 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// project:   CluTec.Viz.Draw
+// file:      OGLPickBVH.cpp
+//
+// summary:   Implements the bounding volume hierarchy used for picking on the CPU
+//
+//            Copyright (c) 2019 by Christian Perwass.
+//
+//            This file is part of the CluTecLib library.
+//
+//            The CluTecLib library is free software: you can redistribute it and / or modify
+//            it under the terms of the GNU Lesser General Public License as published by
+//            the Free Software Foundation, either version 3 of the License, or
+//            (at your option) any later version.
+//
+//            The CluTecLib library is distributed in the hope that it will be useful,
+//            but WITHOUT ANY WARRANTY; without even the implied warranty of
+//            MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//            GNU Lesser General Public License for more details.
+//
+//            You should have received a copy of the GNU Lesser General Public License
+//            along with the CluTecLib library.
+//            If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "stdafx.h"
+#include "OGLPickBVH.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+
+//////////////////////////////////////////////////////////////////////
+// Construction/Destruction
+//////////////////////////////////////////////////////////////////////
+
+COGLPickBVH::COGLPickBVH()
+{
+	m_xInstTree.fBuildArea = 0.0f;
+	m_bHasBaseMat          = false;
+	memset(m_pfInvBaseMat, 0, 16 * sizeof(float));
+
+	m_bDirty               = false;
+
+	ResetStats();
+}
+
+COGLPickBVH::~COGLPickBVH()
+{
+}
+
+//////////////////////////////////////////////////////////////////////
+void COGLPickBVH::Clear()
+{
+	m_mapMesh.clear();
+	m_vecInst.clear();
+	m_vecNextInst.clear();
+	m_vecNameStack.clear();
+	m_vecNextNameStack.clear();
+	m_vecInstBox.clear();
+	m_xInstTree.vecNode.clear();
+	m_xInstTree.vecItem.clear();
+	m_xInstTree.fBuildArea = 0.0f;
+	m_bDirty               = false;
+}
+
+//////////////////////////////////////////////////////////////////////
+void COGLPickBVH::ResetStats()
+{
+	m_xStats.uInstBuildCnt = 0;
+	m_xStats.uInstRefitCnt = 0;
+	m_xStats.uMeshBuildCnt = 0;
+	m_xStats.uMeshRefitCnt = 0;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Update
+
+void COGLPickBVH::BeginUpdate(const float* pfBaseMat)
+{
+	m_vecNextInst.clear();
+	m_vecNextNameStack.clear();
+
+	m_bHasBaseMat = (pfBaseMat != nullptr && _InvertMatrix(m_pfInvBaseMat, pfBaseMat));
+}
+
+//////////////////////////////////////////////////////////////////////
+bool COGLPickBVH::IsGeometryCurrent(const void* pvKey, unsigned uStamp) const
+{
+	TMeshMap::const_iterator itMesh = m_mapMesh.find(pvKey);
+
+	return (itMesh != m_mapMesh.end()) && (itMesh->second.uStamp == uStamp);
+}
+
+//////////////////////////////////////////////////////////////////////
+void COGLPickBVH::SetGeometry(const void* pvKey, unsigned uStamp, const SGeometry& rGeo)
+{
+	TMeshMap::iterator itMesh = m_mapMesh.find(pvKey);
+	bool bNew                 = (itMesh == m_mapMesh.end());
+
+	if (bNew)
+	{
+		itMesh = m_mapMesh.insert(TMeshMap::value_type(pvKey, SMesh())).first;
+		itMesh->second.bUsed = false;
+	}
+
+	SMesh& xMesh = itMesh->second;
+
+	std::vector<SPrim> vecPrevPrim;
+	vecPrevPrim.swap(xMesh.vecPrim);
+
+	// Copy vertices
+	size_t nVexIdx, nVexCnt = (rGeo.pubVex ? rGeo.nVexCnt : 0);
+	xMesh.vecVex.resize(3 * nVexCnt);
+
+	const GLubyte* pubVex = rGeo.pubVex;
+	for (nVexIdx = 0; nVexIdx < nVexCnt; ++nVexIdx, pubVex += rGeo.nVexStride)
+	{
+		memcpy(&xMesh.vecVex[3 * nVexIdx], pubVex, 3 * sizeof(float));
+	}
+
+	// Copy part IDs. Only the lower 20 bits are the part ID, the upper bits may contain a pick color.
+	if (rGeo.pubPartId && nVexCnt > 0)
+	{
+		xMesh.vecPartId.resize(nVexCnt);
+
+		const GLubyte* pubPartId = rGeo.pubPartId;
+		for (nVexIdx = 0; nVexIdx < nVexCnt; ++nVexIdx, pubPartId += rGeo.nPartIdStride)
+		{
+			xMesh.vecPartId[nVexIdx] = *((const unsigned*) pubPartId) & 0x000FFFFF;
+		}
+	}
+	else
+	{
+		xMesh.vecPartId.clear();
+	}
+
+	// Decompose into primitives
+	xMesh.vecPrim.reserve(vecPrevPrim.size());
+
+	if (rGeo.vecIdxList.empty())
+	{
+		_AddPrimitives(xMesh, rGeo, nullptr, nVexCnt);
+	}
+	else
+	{
+		for (size_t nList = 0; nList < rGeo.vecIdxList.size() && nList < rGeo.vecIdxCnt.size(); ++nList)
+		{
+			if (rGeo.vecIdxList[nList])
+			{
+				_AddPrimitives(xMesh, rGeo, rGeo.vecIdxList[nList], rGeo.vecIdxCnt[nList]);
+			}
+		}
+	}
+
+	// Evaluate primitive bounding boxes
+	size_t nPrimIdx, nPrimCnt = xMesh.vecPrim.size();
+	xMesh.vecPrimBox.resize(nPrimCnt);
+
+	for (nPrimIdx = 0; nPrimIdx < nPrimCnt; ++nPrimIdx)
+	{
+		const SPrim& xPrim = xMesh.vecPrim[nPrimIdx];
+		SBox& xBox         = xMesh.vecPrimBox[nPrimIdx];
+
+		_BoxEmpty(xBox);
+		for (unsigned uVex = 0; uVex < xPrim.uVexCnt; ++uVex)
+		{
+			_BoxAdd(xBox, &xMesh.vecVex[3 * xPrim.puVex[uVex]]);
+		}
+	}
+
+	// Refit if the primitive structure did not change and the refitted hierarchy is not much worse than the built one
+	bool bRefit = !bNew && !xMesh.xTree.vecNode.empty() && (vecPrevPrim.size() == nPrimCnt)
+			&& (memcmp(vecPrevPrim.data(), xMesh.vecPrim.data(), nPrimCnt * sizeof(SPrim)) == 0);
+
+	if (bRefit)
+	{
+		_RefitTree(xMesh.xTree, xMesh.vecPrimBox);
+		bRefit = (_BoxArea(xMesh.xTree.vecNode[0].xBox) <= 2.0f * xMesh.xTree.fBuildArea);
+	}
+
+	if (bRefit)
+	{
+		++m_xStats.uMeshRefitCnt;
+	}
+	else
+	{
+		_BuildTree(xMesh.xTree, xMesh.vecPrimBox);
+		++m_xStats.uMeshBuildCnt;
+	}
+
+	xMesh.uStamp   = uStamp;
+	xMesh.bChanged = true;
+}
+
+//////////////////////////////////////////////////////////////////////
+void COGLPickBVH::_AddPrimitives(SMesh& xMesh, const SGeometry& rGeo, const unsigned* puIdx, size_t nIdxCnt)
+{
+	size_t nVexCnt = xMesh.vecVex.size() / 3;
+	size_t nIdx;
+	SPrim xPrim;
+
+	// Index of i-th vertex in list
+	#define PICK_BVH_IDX(i)	(puIdx ? puIdx[i] : unsigned(i))
+
+	// Adds a primitive if all its indices are valid
+	auto fnAdd = [&](unsigned uVexCnt, size_t nA, size_t nB, size_t nC)
+	{
+		xPrim.uVexCnt  = uVexCnt;
+		xPrim.puVex[0] = PICK_BVH_IDX(nA);
+		xPrim.puVex[1] = (uVexCnt > 1 ? PICK_BVH_IDX(nB) : xPrim.puVex[0]);
+		xPrim.puVex[2] = (uVexCnt > 2 ? PICK_BVH_IDX(nC) : xPrim.puVex[1]);
+
+		if ((xPrim.puVex[0] < nVexCnt) && (xPrim.puVex[1] < nVexCnt) && (xPrim.puVex[2] < nVexCnt))
+		{
+			xMesh.vecPrim.push_back(xPrim);
+		}
+	};
+
+	switch (rGeo.eMode)
+	{
+	case GL_LINES:
+		for (nIdx = 0; nIdx + 1 < nIdxCnt; nIdx += 2)
+		{
+			fnAdd(2, nIdx, nIdx + 1, 0);
+		}
+		break;
+
+	case GL_LINE_STRIP:
+	case GL_LINE_LOOP:
+		for (nIdx = 0; nIdx + 1 < nIdxCnt; ++nIdx)
+		{
+			fnAdd(2, nIdx, nIdx + 1, 0);
+		}
+
+		if ((rGeo.eMode == GL_LINE_LOOP) && (nIdxCnt > 2))
+		{
+			fnAdd(2, nIdxCnt - 1, 0, 0);
+		}
+		break;
+
+	case GL_TRIANGLES:
+		for (nIdx = 0; nIdx + 2 < nIdxCnt; nIdx += 3)
+		{
+			fnAdd(3, nIdx, nIdx + 1, nIdx + 2);
+		}
+		break;
+
+	case GL_TRIANGLE_STRIP:
+		for (nIdx = 0; nIdx + 2 < nIdxCnt; ++nIdx)
+		{
+			fnAdd(3, nIdx, nIdx + 1, nIdx + 2);
+		}
+		break;
+
+	case GL_TRIANGLE_FAN:
+	case GL_POLYGON:
+		for (nIdx = 1; nIdx + 1 < nIdxCnt; ++nIdx)
+		{
+			fnAdd(3, 0, nIdx, nIdx + 1);
+		}
+		break;
+
+	case GL_QUADS:
+		for (nIdx = 0; nIdx + 3 < nIdxCnt; nIdx += 4)
+		{
+			fnAdd(3, nIdx, nIdx + 1, nIdx + 2);
+			fnAdd(3, nIdx, nIdx + 2, nIdx + 3);
+		}
+		break;
+
+	case GL_QUAD_STRIP:
+		for (nIdx = 0; nIdx + 3 < nIdxCnt; nIdx += 2)
+		{
+			fnAdd(3, nIdx, nIdx + 1, nIdx + 3);
+			fnAdd(3, nIdx, nIdx + 3, nIdx + 2);
+		}
+		break;
+
+	default:
+		// Points and all primitive types that are only meaningful with geometry shaders
+		for (nIdx = 0; nIdx < nIdxCnt; ++nIdx)
+		{
+			fnAdd(1, nIdx, 0, 0);
+		}
+		break;
+	}
+
+	#undef PICK_BVH_IDX
+}
+
+//////////////////////////////////////////////////////////////////////
+bool COGLPickBVH::AddInstance(const void* pvKey, unsigned uUID, const float* pfModelView, const unsigned* puNameStack, size_t nNameCnt)
+{
+	TMeshMap::iterator itMesh = m_mapMesh.find(pvKey);
+	if (itMesh == m_mapMesh.end())
+	{
+		return false;
+	}
+
+	SInstance xInst;
+
+	xInst.pvKey = pvKey;
+	xInst.pMesh = &itMesh->second;
+	xInst.uUID  = uUID;
+
+	if (pfModelView == nullptr)
+	{
+		memset(xInst.pfMat, 0, 16 * sizeof(float));
+		xInst.pfMat[0] = xInst.pfMat[5] = xInst.pfMat[10] = xInst.pfMat[15] = 1.0f;
+	}
+	else if (m_bHasBaseMat)
+	{
+		_MultMatrix(xInst.pfMat, m_pfInvBaseMat, pfModelView);
+	}
+	else
+	{
+		memcpy(xInst.pfMat, pfModelView, 16 * sizeof(float));
+	}
+
+	// Instances that are scaled to zero cannot be hit
+	if (!_InvertMatrix(xInst.pfInvMat, xInst.pfMat))
+	{
+		return false;
+	}
+
+	xInst.nNameFirst = m_vecNextNameStack.size();
+	xInst.nNameCnt   = (puNameStack ? nNameCnt : 0);
+	if (xInst.nNameCnt > 0)
+	{
+		m_vecNextNameStack.insert(m_vecNextNameStack.end(), puNameStack, puNameStack + nNameCnt);
+	}
+
+	_BoxEmpty(xInst.xBox);
+
+	itMesh->second.bUsed = true;
+	m_vecNextInst.push_back(xInst);
+
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////
+void COGLPickBVH::EndUpdate()
+{
+	size_t nInst, nInstCnt = m_vecNextInst.size();
+
+	bool bSameInst = (nInstCnt == m_vecInst.size()) && ((nInstCnt == 0) || !m_xInstTree.vecNode.empty());
+
+	for (nInst = 0; nInst < nInstCnt && bSameInst; ++nInst)
+	{
+		bSameInst = (m_vecNextInst[nInst].pvKey == m_vecInst[nInst].pvKey);
+	}
+
+	if (bSameInst)
+	{
+		// Only update the boxes of instances whose transformation or geometry changed
+		bool bRefit = false;
+
+		for (nInst = 0; nInst < nInstCnt; ++nInst)
+		{
+			SInstance& xInst       = m_vecNextInst[nInst];
+			const SInstance& xPrev = m_vecInst[nInst];
+
+			if (xInst.pMesh->bChanged || (memcmp(xInst.pfMat, xPrev.pfMat, 16 * sizeof(float)) != 0))
+			{
+				_UpdateInstanceBox(xInst);
+				m_vecInstBox[nInst] = xInst.xBox;
+				bRefit              = true;
+			}
+			else
+			{
+				xInst.xBox = xPrev.xBox;
+			}
+		}
+
+		m_vecInst.swap(m_vecNextInst);
+		m_vecNameStack.swap(m_vecNextNameStack);
+
+		if (bRefit)
+		{
+			_RefitTree(m_xInstTree, m_vecInstBox);
+
+			if (_BoxArea(m_xInstTree.vecNode[0].xBox) > 2.0f * m_xInstTree.fBuildArea)
+			{
+				_BuildInstanceTree();
+			}
+			else
+			{
+				++m_xStats.uInstRefitCnt;
+			}
+		}
+	}
+	else
+	{
+		for (nInst = 0; nInst < nInstCnt; ++nInst)
+		{
+			_UpdateInstanceBox(m_vecNextInst[nInst]);
+		}
+
+		m_vecInst.swap(m_vecNextInst);
+		m_vecNameStack.swap(m_vecNextNameStack);
+
+		_BuildInstanceTree();
+	}
+
+	m_vecNextInst.clear();
+	m_vecNextNameStack.clear();
+
+	// Remove meshes without instances
+	TMeshMap::iterator itMesh = m_mapMesh.begin();
+	while (itMesh != m_mapMesh.end())
+	{
+		if (!itMesh->second.bUsed)
+		{
+			itMesh = m_mapMesh.erase(itMesh);
+		}
+		else
+		{
+			itMesh->second.bUsed    = false;
+			itMesh->second.bChanged = false;
+			++itMesh;
+		}
+	}
+
+	m_bDirty = false;
+}
+
+//////////////////////////////////////////////////////////////////////
+void COGLPickBVH::_UpdateInstanceBox(SInstance& xInst)
+{
+	const STree& xTree = xInst.pMesh->xTree;
+
+	if (xTree.vecNode.empty())
+	{
+		_BoxEmpty(xInst.xBox);
+	}
+	else
+	{
+		_TransformBox(xInst.xBox, xInst.pfMat, xTree.vecNode[0].xBox);
+	}
+}
+
+//////////////////////////////////////////////////////////////////////
+void COGLPickBVH::_BuildInstanceTree()
+{
+	size_t nInst, nInstCnt = m_vecInst.size();
+
+	m_vecInstBox.resize(nInstCnt);
+	for (nInst = 0; nInst < nInstCnt; ++nInst)
+	{
+		m_vecInstBox[nInst] = m_vecInst[nInst].xBox;
+	}
+
+	_BuildTree(m_xInstTree, m_vecInstBox);
+	++m_xStats.uInstBuildCnt;
+}
+
+//////////////////////////////////////////////////////////////////////
+const unsigned* COGLPickBVH::GetInstanceNameStack(unsigned uInst, size_t& nNameCnt) const
+{
+	if (uInst >= m_vecInst.size() || m_vecInst[uInst].nNameCnt == 0)
+	{
+		nNameCnt = 0;
+		return nullptr;
+	}
+
+	nNameCnt = m_vecInst[uInst].nNameCnt;
+	return &m_vecNameStack[m_vecInst[uInst].nNameFirst];
+}
+
+//////////////////////////////////////////////////////////////////////
+// Hierarchy
+
+void COGLPickBVH::_BuildTree(STree& xTree, const std::vector<SBox>& vecBox)
+{
+	unsigned uItem, uItemCnt = unsigned(vecBox.size());
+
+	xTree.vecNode.clear();
+	xTree.vecItem.resize(uItemCnt);
+	xTree.fBuildArea = 0.0f;
+
+	if (uItemCnt == 0)
+	{
+		return;
+	}
+
+	std::vector<float> vecCenter(3 * uItemCnt);
+	for (uItem = 0; uItem < uItemCnt; ++uItem)
+	{
+		const SBox& xBox = vecBox[uItem];
+
+		xTree.vecItem[uItem] = uItem;
+		for (int i = 0; i < 3; ++i)
+		{
+			vecCenter[3 * uItem + i] = 0.5f * xBox.pfMin[i] + 0.5f * xBox.pfMax[i];
+		}
+	}
+
+	xTree.vecNode.reserve(2 * uItemCnt);
+	xTree.vecNode.resize(1);
+
+	_BuildNode(xTree, 0, 0, uItemCnt, vecBox, vecCenter);
+
+	xTree.fBuildArea = _BoxArea(xTree.vecNode[0].xBox);
+}
+
+//////////////////////////////////////////////////////////////////////
+// Splits the items at the median of the longest axis of the box of centers
+
+void COGLPickBVH::_BuildNode(STree& xTree, unsigned uNode, unsigned uFirst, unsigned uCount, const std::vector<SBox>& vecBox, const std::vector<float>& vecCenter)
+{
+	unsigned uItem, uEnd = uFirst + uCount;
+	SBox xBox, xCenterBox;
+
+	_BoxEmpty(xBox);
+	_BoxEmpty(xCenterBox);
+
+	for (uItem = uFirst; uItem < uEnd; ++uItem)
+	{
+		unsigned uIdx = xTree.vecItem[uItem];
+
+		_BoxAdd(xBox, vecBox[uIdx]);
+		_BoxAdd(xCenterBox, &vecCenter[3 * uIdx]);
+	}
+
+	xTree.vecNode[uNode].xBox = xBox;
+
+	int iAxis = 0;
+	float fExtent = xCenterBox.pfMax[0] - xCenterBox.pfMin[0];
+	for (int i = 1; i < 3; ++i)
+	{
+		if (xCenterBox.pfMax[i] - xCenterBox.pfMin[i] > fExtent)
+		{
+			fExtent = xCenterBox.pfMax[i] - xCenterBox.pfMin[i];
+			iAxis   = i;
+		}
+	}
+
+	if ((uCount <= sm_uMaxLeafSize) || !(fExtent > 0.0f))
+	{
+		xTree.vecNode[uNode].uFirst = uFirst;
+		xTree.vecNode[uNode].uCount = uCount;
+		return;
+	}
+
+	unsigned uMid = uFirst + uCount / 2;
+	std::nth_element(xTree.vecItem.begin() + uFirst, xTree.vecItem.begin() + uMid, xTree.vecItem.begin() + uEnd,
+			[&vecCenter, iAxis](unsigned uA, unsigned uB)
+			{
+				return vecCenter[3 * uA + iAxis] < vecCenter[3 * uB + iAxis];
+			});
+
+	unsigned uLeft = unsigned(xTree.vecNode.size());
+	xTree.vecNode.resize(uLeft + 2);
+
+	xTree.vecNode[uNode].uFirst = uLeft;
+	xTree.vecNode[uNode].uCount = 0;
+
+	_BuildNode(xTree, uLeft, uFirst, uMid - uFirst, vecBox, vecCenter);
+	_BuildNode(xTree, uLeft + 1, uMid, uEnd - uMid, vecBox, vecCenter);
+}
+
+//////////////////////////////////////////////////////////////////////
+// Children always have larger indices than their parents, so that the
+// nodes can be refitted in reverse order.
+
+void COGLPickBVH::_RefitTree(STree& xTree, const std::vector<SBox>& vecBox)
+{
+	for (size_t nNode = xTree.vecNode.size(); nNode > 0; --nNode)
+	{
+		SNode& xNode = xTree.vecNode[nNode - 1];
+
+		if (xNode.uCount > 0)
+		{
+			_BoxEmpty(xNode.xBox);
+			for (unsigned uItem = xNode.uFirst; uItem < xNode.uFirst + xNode.uCount; ++uItem)
+			{
+				_BoxAdd(xNode.xBox, vecBox[xTree.vecItem[uItem]]);
+			}
+		}
+		else
+		{
+			xNode.xBox = xTree.vecNode[xNode.uFirst].xBox;
+			_BoxAdd(xNode.xBox, xTree.vecNode[xNode.uFirst + 1].xBox);
+		}
+	}
+}
+
+//////////////////////////////////////////////////////////////////////
+// Queries
+
+bool COGLPickBVH::PickRay(const SRay& rRay, SHit& rHit) const
+{
+	if (m_xInstTree.vecNode.empty())
+	{
+		return false;
+	}
+
+	float pfInvDir[3];
+	for (int i = 0; i < 3; ++i)
+	{
+		pfInvDir[i] = 1.0f / rRay.pfDir[i];
+	}
+
+	float fTBest = rRay.fTMax;
+	bool bHit    = false;
+
+	SStackEntry pxStack[128];
+	int iStackPos = 0;
+
+	_PushRayNode(m_xInstTree, 0, rRay.pfOrig, pfInvDir, 1.0f, rRay, fTBest, pxStack, iStackPos);
+
+	while (iStackPos > 0)
+	{
+		const SStackEntry& xEntry = pxStack[--iStackPos];
+		if (xEntry.fTNear > fTBest)
+		{
+			continue;
+		}
+
+		const SNode& xNode = m_xInstTree.vecNode[xEntry.uNode];
+
+		if (xNode.uCount > 0)
+		{
+			for (unsigned uItem = xNode.uFirst; uItem < xNode.uFirst + xNode.uCount; ++uItem)
+			{
+				unsigned uInst = m_xInstTree.vecItem[uItem];
+
+				if (_PickMesh(m_vecInst[uInst], rRay, fTBest, rHit))
+				{
+					rHit.uInst = uInst;
+					bHit       = true;
+				}
+			}
+		}
+		else
+		{
+			_PushRayChildren(m_xInstTree, xNode, rRay.pfOrig, pfInvDir, 1.0f, rRay, fTBest, pxStack, iStackPos);
+		}
+	}
+
+	return bHit;
+}
+
+//////////////////////////////////////////////////////////////////////
+bool COGLPickBVH::_PickMesh(const SInstance& xInst, const SRay& rRay, float& fTBest, SHit& rHit) const
+{
+	const SMesh& xMesh = *xInst.pMesh;
+	const STree& xTree = xMesh.xTree;
+
+	if (xTree.vecNode.empty())
+	{
+		return false;
+	}
+
+	// Ray in local coordinates. Since the transformation is affine, the ray parameter is the same.
+	float pfOrig[3], pfDir[3], pfInvDir[3];
+	_TransformPoint(pfOrig, xInst.pfInvMat, rRay.pfOrig);
+	_TransformDir(pfDir, xInst.pfInvMat, rRay.pfDir);
+
+	for (int i = 0; i < 3; ++i)
+	{
+		pfInvDir[i] = 1.0f / pfDir[i];
+	}
+
+	// The Frobenius norm of the inverse bounds the scale of the pick tolerance in local coordinates
+	float fPadScale = 0.0f;
+	for (int iCol = 0; iCol < 3; ++iCol)
+	{
+		for (int iRow = 0; iRow < 3; ++iRow)
+		{
+			fPadScale += xInst.pfInvMat[4 * iCol + iRow] * xInst.pfInvMat[4 * iCol + iRow];
+		}
+	}
+	fPadScale = sqrt(fPadScale);
+
+	const float* pfRO = rRay.pfOrig;
+	const float* pfRD = rRay.pfDir;
+	float fDD         = pfRD[0] * pfRD[0] + pfRD[1] * pfRD[1] + pfRD[2] * pfRD[2];
+	bool bHit         = false;
+
+	SStackEntry pxStack[128];
+	int iStackPos = 0;
+
+	_PushRayNode(xTree, 0, pfOrig, pfInvDir, fPadScale, rRay, fTBest, pxStack, iStackPos);
+
+	while (iStackPos > 0)
+	{
+		const SStackEntry& xEntry = pxStack[--iStackPos];
+		if (xEntry.fTNear > fTBest)
+		{
+			continue;
+		}
+
+		const SNode& xNode = xTree.vecNode[xEntry.uNode];
+
+		if (xNode.uCount == 0)
+		{
+			_PushRayChildren(xTree, xNode, pfOrig, pfInvDir, fPadScale, rRay, fTBest, pxStack, iStackPos);
+			continue;
+		}
+
+		for (unsigned uItem = xNode.uFirst; uItem < xNode.uFirst + xNode.uCount; ++uItem)
+		{
+			unsigned uPrim     = xTree.vecItem[uItem];
+			const SPrim& xPrim = xMesh.vecPrim[uPrim];
+
+			// Primitive tests are done in the base frame, so that the tolerance is applied there
+			float pfV[3][3];
+			for (unsigned uVex = 0; uVex < xPrim.uVexCnt; ++uVex)
+			{
+				_TransformPoint(pfV[uVex], xInst.pfMat, &xMesh.vecVex[3 * xPrim.puVex[uVex]]);
+			}
+
+			float fT = -1.0f;
+
+			if (xPrim.uVexCnt == 3)
+			{
+				// Two-sided ray/triangle intersection
+				float pfE1[3], pfE2[3], pfP[3], pfS[3], pfQ[3];
+				for (int i = 0; i < 3; ++i)
+				{
+					pfE1[i] = pfV[1][i] - pfV[0][i];
+					pfE2[i] = pfV[2][i] - pfV[0][i];
+					pfS[i]  = pfRO[i] - pfV[0][i];
+				}
+
+				pfP[0] = pfRD[1] * pfE2[2] - pfRD[2] * pfE2[1];
+				pfP[1] = pfRD[2] * pfE2[0] - pfRD[0] * pfE2[2];
+				pfP[2] = pfRD[0] * pfE2[1] - pfRD[1] * pfE2[0];
+
+				float fDet = pfE1[0] * pfP[0] + pfE1[1] * pfP[1] + pfE1[2] * pfP[2];
+				if (fabs(fDet) <= FLT_MIN)
+				{
+					continue;
+				}
+
+				float fInvDet = 1.0f / fDet;
+				float fU      = (pfS[0] * pfP[0] + pfS[1] * pfP[1] + pfS[2] * pfP[2]) * fInvDet;
+				if (fU < 0.0f || fU > 1.0f)
+				{
+					continue;
+				}
+
+				pfQ[0] = pfS[1] * pfE1[2] - pfS[2] * pfE1[1];
+				pfQ[1] = pfS[2] * pfE1[0] - pfS[0] * pfE1[2];
+				pfQ[2] = pfS[0] * pfE1[1] - pfS[1] * pfE1[0];
+
+				float fV = (pfRD[0] * pfQ[0] + pfRD[1] * pfQ[1] + pfRD[2] * pfQ[2]) * fInvDet;
+				if (fV < 0.0f || fU + fV > 1.0f)
+				{
+					continue;
+				}
+
+				fT = (pfE2[0] * pfQ[0] + pfE2[1] * pfQ[1] + pfE2[2] * pfQ[2]) * fInvDet;
+			}
+			else if (xPrim.uVexCnt == 2)
+			{
+				// Closest points of ray and line segment
+				float pfE[3], pfW[3];
+				for (int i = 0; i < 3; ++i)
+				{
+					pfE[i] = pfV[1][i] - pfV[0][i];
+					pfW[i] = pfRO[i] - pfV[0][i];
+				}
+
+				float fDE  = pfRD[0] * pfE[0] + pfRD[1] * pfE[1] + pfRD[2] * pfE[2];
+				float fEE  = pfE[0] * pfE[0] + pfE[1] * pfE[1] + pfE[2] * pfE[2];
+				float fDW  = pfRD[0] * pfW[0] + pfRD[1] * pfW[1] + pfRD[2] * pfW[2];
+				float fEW  = pfE[0] * pfW[0] + pfE[1] * pfW[1] + pfE[2] * pfW[2];
+				float fDen = fDD * fEE - fDE * fDE;
+				float fS   = 0.0f;
+
+				if (fEE > 0.0f)
+				{
+					fS = (fDen > 1e-12f * fDD * fEE ? (fDD * fEW - fDE * fDW) / fDen : 0.0f);
+					fS = std::min(std::max(fS, 0.0f), 1.0f);
+				}
+
+				// Ray parameter of point on ray closest to the point on the segment
+				float pfC[3];
+				for (int i = 0; i < 3; ++i)
+				{
+					pfC[i] = pfV[0][i] + fS * pfE[i];
+				}
+
+				fT = std::max(((pfC[0] - pfRO[0]) * pfRD[0] + (pfC[1] - pfRO[1]) * pfRD[1] + (pfC[2] - pfRO[2]) * pfRD[2]) / fDD, 0.0f);
+
+				float fDist = 0.0f;
+				for (int i = 0; i < 3; ++i)
+				{
+					float fD = pfRO[i] + fT * pfRD[i] - pfC[i];
+					fDist += fD * fD;
+				}
+
+				float fTol = rRay.fTol + rRay.fTolSlope * fT;
+				if (fDist > fTol * fTol)
+				{
+					continue;
+				}
+			}
+			else
+			{
+				fT = std::max(((pfV[0][0] - pfRO[0]) * pfRD[0] + (pfV[0][1] - pfRO[1]) * pfRD[1] + (pfV[0][2] - pfRO[2]) * pfRD[2]) / fDD, 0.0f);
+
+				float fDist = 0.0f;
+				for (int i = 0; i < 3; ++i)
+				{
+					float fD = pfRO[i] + fT * pfRD[i] - pfV[0][i];
+					fDist += fD * fD;
+				}
+
+				float fTol = rRay.fTol + rRay.fTolSlope * fT;
+				if (fDist > fTol * fTol)
+				{
+					continue;
+				}
+			}
+
+			if (fT < 0.0f || fT >= fTBest)
+			{
+				continue;
+			}
+
+			fTBest = fT;
+			bHit   = true;
+
+			rHit.uUID    = xInst.uUID;
+			rHit.uPrim   = uPrim;
+			rHit.uPartId = (xMesh.vecPartId.empty() ? 0 : xMesh.vecPartId[xPrim.puVex[0]]);
+			rHit.fT      = fT;
+
+			for (int i = 0; i < 3; ++i)
+			{
+				rHit.pfPos[i] = pfRO[i] + fT * pfRD[i];
+			}
+		}
+	}
+
+	return bHit;
+}
+
+//////////////////////////////////////////////////////////////////////
+size_t COGLPickBVH::PickFrustum(const float (*pfPlane)[4], int iPlaneCnt, std::vector<SHit>& vecHit) const
+{
+	if (m_xInstTree.vecNode.empty() || iPlaneCnt < 0 || iPlaneCnt > 16)
+	{
+		return 0;
+	}
+
+	size_t nHitCnt = 0;
+	SHit xHit;
+
+	unsigned puStack[128];
+	int iStackPos = 0;
+	puStack[iStackPos++] = 0;
+
+	while (iStackPos > 0)
+	{
+		const SNode& xNode = m_xInstTree.vecNode[puStack[--iStackPos]];
+
+		if (_IsBoxOutside(xNode.xBox, pfPlane, iPlaneCnt))
+		{
+			continue;
+		}
+
+		if (xNode.uCount > 0)
+		{
+			for (unsigned uItem = xNode.uFirst; uItem < xNode.uFirst + xNode.uCount; ++uItem)
+			{
+				unsigned uInst = m_xInstTree.vecItem[uItem];
+
+				if (_PickMeshFrustum(m_vecInst[uInst], pfPlane, iPlaneCnt, xHit))
+				{
+					xHit.uInst = uInst;
+					vecHit.push_back(xHit);
+					++nHitCnt;
+				}
+			}
+		}
+		else
+		{
+			puStack[iStackPos++] = xNode.uFirst;
+			puStack[iStackPos++] = xNode.uFirst + 1;
+		}
+	}
+
+	return nHitCnt;
+}
+
+//////////////////////////////////////////////////////////////////////
+bool COGLPickBVH::_PickMeshFrustum(const SInstance& xInst, const float (*pfPlane)[4], int iPlaneCnt, SHit& rHit) const
+{
+	const SMesh& xMesh = *xInst.pMesh;
+	const STree& xTree = xMesh.xTree;
+
+	if (xTree.vecNode.empty())
+	{
+		return false;
+	}
+
+	// Planes in local coordinates: p(M x) = (M^T n) x + (n t + d)
+	float pfLocPlane[16][4];
+	const float* pfM = xInst.pfMat;
+
+	for (int iPlane = 0; iPlane < iPlaneCnt; ++iPlane)
+	{
+		const float* pfP = pfPlane[iPlane];
+
+		for (int iCol = 0; iCol < 4; ++iCol)
+		{
+			pfLocPlane[iPlane][iCol] = pfM[4 * iCol] * pfP[0] + pfM[4 * iCol + 1] * pfP[1] + pfM[4 * iCol + 2] * pfP[2];
+		}
+
+		pfLocPlane[iPlane][3] += pfP[3];
+	}
+
+	unsigned puStack[128];
+	int iStackPos = 0;
+	puStack[iStackPos++] = 0;
+
+	while (iStackPos > 0)
+	{
+		const SNode& xNode = xTree.vecNode[puStack[--iStackPos]];
+
+		if (_IsBoxOutside(xNode.xBox, pfLocPlane, iPlaneCnt))
+		{
+			continue;
+		}
+
+		if (xNode.uCount == 0)
+		{
+			puStack[iStackPos++] = xNode.uFirst;
+			puStack[iStackPos++] = xNode.uFirst + 1;
+			continue;
+		}
+
+		for (unsigned uItem = xNode.uFirst; uItem < xNode.uFirst + xNode.uCount; ++uItem)
+		{
+			unsigned uPrim     = xTree.vecItem[uItem];
+			const SPrim& xPrim = xMesh.vecPrim[uPrim];
+			bool bOutside      = false;
+
+			for (int iPlane = 0; iPlane < iPlaneCnt && !bOutside; ++iPlane)
+			{
+				const float* pfP = pfLocPlane[iPlane];
+
+				bOutside = true;
+				for (unsigned uVex = 0; uVex < xPrim.uVexCnt && bOutside; ++uVex)
+				{
+					const float* pfV = &xMesh.vecVex[3 * xPrim.puVex[uVex]];
+					bOutside = (pfP[0] * pfV[0] + pfP[1] * pfV[1] + pfP[2] * pfV[2] + pfP[3] < 0.0f);
+				}
+			}
+
+			if (!bOutside)
+			{
+				rHit.uUID    = xInst.uUID;
+				rHit.uPrim   = uPrim;
+				rHit.uPartId = (xMesh.vecPartId.empty() ? 0 : xMesh.vecPartId[xPrim.puVex[0]]);
+				rHit.fT      = 0.0f;
+				_TransformPoint(rHit.pfPos, xInst.pfMat, &xMesh.vecVex[3 * xPrim.puVex[0]]);
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
+
+//////////////////////////////////////////////////////////////////////
+bool COGLPickBVH::RayFromViewProj(const float* pfViewProj, float fX, float fY, float fTolX, float fTolY, SRay& rRay)
+{
+	float pfInv[16];
+	if (!_InvertMatrix(pfInv, pfViewProj))
+	{
+		return false;
+	}
+
+	// Unproject points on near and far plane
+	float pfPnt[6][3];
+	const float pfNDC[6][3] =
+	{
+		{ fX, fY, -1.0f },
+		{ fX, fY, 1.0f },
+		{ fX + fTolX, fY, -1.0f },
+		{ fX + fTolX, fY, 1.0f },
+		{ fX, fY + fTolY, -1.0f },
+		{ fX, fY + fTolY, 1.0f }
+	};
+
+	for (int iPnt = 0; iPnt < 6; ++iPnt)
+	{
+		float pfH[4];
+		for (int iRow = 0; iRow < 4; ++iRow)
+		{
+			pfH[iRow] = pfInv[iRow] * pfNDC[iPnt][0] + pfInv[4 + iRow] * pfNDC[iPnt][1] + pfInv[8 + iRow] * pfNDC[iPnt][2] + pfInv[12 + iRow];
+		}
+
+		if (pfH[3] == 0.0f)
+		{
+			return false;
+		}
+
+		for (int i = 0; i < 3; ++i)
+		{
+			pfPnt[iPnt][i] = pfH[i] / pfH[3];
+		}
+	}
+
+	// The pick rectangle is approximated by a cone whose radius is the larger half extent
+	float fTolNearX = 0.0f, fTolFarX = 0.0f, fTolNearY = 0.0f, fTolFarY = 0.0f;
+	for (int i = 0; i < 3; ++i)
+	{
+		rRay.pfOrig[i] = pfPnt[0][i];
+		rRay.pfDir[i]  = pfPnt[1][i] - pfPnt[0][i];
+
+		fTolNearX += (pfPnt[2][i] - pfPnt[0][i]) * (pfPnt[2][i] - pfPnt[0][i]);
+		fTolFarX  += (pfPnt[3][i] - pfPnt[1][i]) * (pfPnt[3][i] - pfPnt[1][i]);
+		fTolNearY += (pfPnt[4][i] - pfPnt[0][i]) * (pfPnt[4][i] - pfPnt[0][i]);
+		fTolFarY  += (pfPnt[5][i] - pfPnt[1][i]) * (pfPnt[5][i] - pfPnt[1][i]);
+	}
+
+	float fTolNear = sqrt((fTolNearX > fTolNearY ? fTolNearX : fTolNearY));
+	float fTolFar  = sqrt((fTolFarX > fTolFarY ? fTolFarX : fTolFarY));
+
+	rRay.fTMax     = 1.0f;
+	rRay.fTol      = fTolNear;
+	rRay.fTolSlope = fTolFar - fTolNear;
+
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////
+// A point with clip coordinates c is inside the rectangle if
+// fLeft * c.w <= c.x <= fRight * c.w, and analogously for y and z.
+
+void COGLPickBVH::FrustumFromViewProj(const float* pfViewProj, float fLeft, float fRight, float fBottom, float fTop, float pfPlane[6][4])
+{
+	for (int iCol = 0; iCol < 4; ++iCol)
+	{
+		float fR0 = pfViewProj[4 * iCol];
+		float fR1 = pfViewProj[4 * iCol + 1];
+		float fR2 = pfViewProj[4 * iCol + 2];
+		float fR3 = pfViewProj[4 * iCol + 3];
+
+		pfPlane[0][iCol] = fR0 - fLeft * fR3;
+		pfPlane[1][iCol] = fRight * fR3 - fR0;
+		pfPlane[2][iCol] = fR1 - fBottom * fR3;
+		pfPlane[3][iCol] = fTop * fR3 - fR1;
+		pfPlane[4][iCol] = fR3 + fR2;
+		pfPlane[5][iCol] = fR3 - fR2;
+	}
+}
+
+//////////////////////////////////////////////////////////////////////
+// Helper
+
+void COGLPickBVH::_BoxEmpty(SBox& xBox)
+{
+	for (int i = 0; i < 3; ++i)
+	{
+		xBox.pfMin[i] = FLT_MAX;
+		xBox.pfMax[i] = -FLT_MAX;
+	}
+}
+
+//////////////////////////////////////////////////////////////////////
+void COGLPickBVH::_BoxAdd(SBox& xBox, const float* pfPnt)
+{
+	for (int i = 0; i < 3; ++i)
+	{
+		xBox.pfMin[i] = std::min(xBox.pfMin[i], pfPnt[i]);
+		xBox.pfMax[i] = std::max(xBox.pfMax[i], pfPnt[i]);
+	}
+}
+
+//////////////////////////////////////////////////////////////////////
+void COGLPickBVH::_BoxAdd(SBox& xBox, const SBox& xBoxB)
+{
+	for (int i = 0; i < 3; ++i)
+	{
+		xBox.pfMin[i] = std::min(xBox.pfMin[i], xBoxB.pfMin[i]);
+		xBox.pfMax[i] = std::max(xBox.pfMax[i], xBoxB.pfMax[i]);
+	}
+}
+
+//////////////////////////////////////////////////////////////////////
+float COGLPickBVH::_BoxArea(const SBox& xBox)
+{
+	float fDX = xBox.pfMax[0] - xBox.pfMin[0];
+	float fDY = xBox.pfMax[1] - xBox.pfMin[1];
+	float fDZ = xBox.pfMax[2] - xBox.pfMin[2];
+
+	if (fDX < 0.0f || fDY < 0.0f || fDZ < 0.0f)
+	{
+		return 0.0f;
+	}
+
+	return 2.0f * (fDX * fDY + fDY * fDZ + fDZ * fDX);
+}
+
+//////////////////////////////////////////////////////////////////////
+// Transforms an axis aligned box by an affine matrix (J. Arvo).
+
+void COGLPickBVH::_TransformBox(SBox& xBoxOut, const float* pfMat, const SBox& xBox)
+{
+	if (xBox.pfMin[0] > xBox.pfMax[0])
+	{
+		_BoxEmpty(xBoxOut);
+		return;
+	}
+
+	for (int iRow = 0; iRow < 3; ++iRow)
+	{
+		xBoxOut.pfMin[iRow] = xBoxOut.pfMax[iRow] = pfMat[12 + iRow];
+
+		for (int iCol = 0; iCol < 3; ++iCol)
+		{
+			float fA = pfMat[4 * iCol + iRow] * xBox.pfMin[iCol];
+			float fB = pfMat[4 * iCol + iRow] * xBox.pfMax[iCol];
+
+			xBoxOut.pfMin[iRow] += std::min(fA, fB);
+			xBoxOut.pfMax[iRow] += std::max(fA, fB);
+		}
+	}
+}
+
+//////////////////////////////////////////////////////////////////////
+void COGLPickBVH::_TransformPoint(float* pfOut, const float* pfMat, const float* pfPnt)
+{
+	for (int iRow = 0; iRow < 3; ++iRow)
+	{
+		pfOut[iRow] = pfMat[iRow] * pfPnt[0] + pfMat[4 + iRow] * pfPnt[1] + pfMat[8 + iRow] * pfPnt[2] + pfMat[12 + iRow];
+	}
+}
+
+//////////////////////////////////////////////////////////////////////
+void COGLPickBVH::_TransformDir(float* pfOut, const float* pfMat, const float* pfDir)
+{
+	for (int iRow = 0; iRow < 3; ++iRow)
+	{
+		pfOut[iRow] = pfMat[iRow] * pfDir[0] + pfMat[4 + iRow] * pfDir[1] + pfMat[8 + iRow] * pfDir[2];
+	}
+}
+
+//////////////////////////////////////////////////////////////////////
+void COGLPickBVH::_MultMatrix(float* pfOut, const float* pfA, const float* pfB)
+{
+	for (int iCol = 0; iCol < 4; ++iCol)
+	{
+		for (int iRow = 0; iRow < 4; ++iRow)
+		{
+			pfOut[4 * iCol + iRow] = pfA[iRow] * pfB[4 * iCol] + pfA[4 + iRow] * pfB[4 * iCol + 1]
+					+ pfA[8 + iRow] * pfB[4 * iCol + 2] + pfA[12 + iRow] * pfB[4 * iCol + 3];
+		}
+	}
+}
+
+//////////////////////////////////////////////////////////////////////
+// Inverse of general 4x4 matrix by cofactors, evaluated in double precision.
+
+bool COGLPickBVH::_InvertMatrix(float* pfOut, const float* pfMat)
+{
+	double m[16], pdInv[16];
+
+	for (int i = 0; i < 16; ++i)
+	{
+		m[i] = double(pfMat[i]);
+	}
+
+	pdInv[0]  = m[5] * m[10] * m[15] - m[5] * m[11] * m[14] - m[9] * m[6] * m[15] + m[9] * m[7] * m[14] + m[13] * m[6] * m[11] - m[13] * m[7] * m[10];
+	pdInv[4]  = -m[4] * m[10] * m[15] + m[4] * m[11] * m[14] + m[8] * m[6] * m[15] - m[8] * m[7] * m[14] - m[12] * m[6] * m[11] + m[12] * m[7] * m[10];
+	pdInv[8]  = m[4] * m[9] * m[15] - m[4] * m[11] * m[13] - m[8] * m[5] * m[15] + m[8] * m[7] * m[13] + m[12] * m[5] * m[11] - m[12] * m[7] * m[9];
+	pdInv[12] = -m[4] * m[9] * m[14] + m[4] * m[10] * m[13] + m[8] * m[5] * m[14] - m[8] * m[6] * m[13] - m[12] * m[5] * m[10] + m[12] * m[6] * m[9];
+	pdInv[1]  = -m[1] * m[10] * m[15] + m[1] * m[11] * m[14] + m[9] * m[2] * m[15] - m[9] * m[3] * m[14] - m[13] * m[2] * m[11] + m[13] * m[3] * m[10];
+	pdInv[5]  = m[0] * m[10] * m[15] - m[0] * m[11] * m[14] - m[8] * m[2] * m[15] + m[8] * m[3] * m[14] + m[12] * m[2] * m[11] - m[12] * m[3] * m[10];
+	pdInv[9]  = -m[0] * m[9] * m[15] + m[0] * m[11] * m[13] + m[8] * m[1] * m[15] - m[8] * m[3] * m[13] - m[12] * m[1] * m[11] + m[12] * m[3] * m[9];
+	pdInv[13] = m[0] * m[9] * m[14] - m[0] * m[10] * m[13] - m[8] * m[1] * m[14] + m[8] * m[2] * m[13] + m[12] * m[1] * m[10] - m[12] * m[2] * m[9];
+	pdInv[2]  = m[1] * m[6] * m[15] - m[1] * m[7] * m[14] - m[5] * m[2] * m[15] + m[5] * m[3] * m[14] + m[13] * m[2] * m[7] - m[13] * m[3] * m[6];
+	pdInv[6]  = -m[0] * m[6] * m[15] + m[0] * m[7] * m[14] + m[4] * m[2] * m[15] - m[4] * m[3] * m[14] - m[12] * m[2] * m[7] + m[12] * m[3] * m[6];
+	pdInv[10] = m[0] * m[5] * m[15] - m[0] * m[7] * m[13] - m[4] * m[1] * m[15] + m[4] * m[3] * m[13] + m[12] * m[1] * m[7] - m[12] * m[3] * m[5];
+	pdInv[14] = -m[0] * m[5] * m[14] + m[0] * m[6] * m[13] + m[4] * m[1] * m[14] - m[4] * m[2] * m[13] - m[12] * m[1] * m[6] + m[12] * m[2] * m[5];
+	pdInv[3]  = -m[1] * m[6] * m[11] + m[1] * m[7] * m[10] + m[5] * m[2] * m[11] - m[5] * m[3] * m[10] - m[9] * m[2] * m[7] + m[9] * m[3] * m[6];
+	pdInv[7]  = m[0] * m[6] * m[11] - m[0] * m[7] * m[10] - m[4] * m[2] * m[11] + m[4] * m[3] * m[10] + m[8] * m[2] * m[7] - m[8] * m[3] * m[6];
+	pdInv[11] = -m[0] * m[5] * m[11] + m[0] * m[7] * m[9] + m[4] * m[1] * m[11] - m[4] * m[3] * m[9] - m[8] * m[1] * m[7] + m[8] * m[3] * m[5];
+	pdInv[15] = m[0] * m[5] * m[10] - m[0] * m[6] * m[9] - m[4] * m[1] * m[10] + m[4] * m[2] * m[9] + m[8] * m[1] * m[6] - m[8] * m[2] * m[5];
+
+	double dDet = m[0] * pdInv[0] + m[1] * pdInv[4] + m[2] * pdInv[8] + m[3] * pdInv[12];
+	if (dDet == 0.0)
+	{
+		return false;
+	}
+
+	dDet = 1.0 / dDet;
+	for (int i = 0; i < 16; ++i)
+	{
+		pfOut[i] = float(pdInv[i] * dDet);
+	}
+
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////
+bool COGLPickBVH::_IntersectBox(const SBox& xBox, const float* pfOrig, const float* pfInvDir, float fPad, float fTMax, float& fTNear)
+{
+	// Empty box
+	if (xBox.pfMin[0] > xBox.pfMax[0])
+	{
+		return false;
+	}
+
+	float fTMin = 0.0f;
+
+	for (int i = 0; i < 3; ++i)
+	{
+		float fT1 = (xBox.pfMin[i] - fPad - pfOrig[i]) * pfInvDir[i];
+		float fT2 = (xBox.pfMax[i] + fPad - pfOrig[i]) * pfInvDir[i];
+
+		fTMin = std::max(fTMin, std::min(fT1, fT2));
+		fTMax = std::min(fTMax, std::max(fT1, fT2));
+	}
+
+	fTNear = fTMin;
+	return fTMin <= fTMax;
+}
+
+//////////////////////////////////////////////////////////////////////
+void COGLPickBVH::_PushRayNode(const STree& xTree, unsigned uNode, const float* pfOrig, const float* pfInvDir, float fPadScale, const SRay& rRay, float fTBest, SStackEntry* pxStack, int& iStackPos)
+{
+	float fTNear;
+
+	if (_IntersectBox(xTree.vecNode[uNode].xBox, pfOrig, pfInvDir, fPadScale * (rRay.fTol + rRay.fTolSlope * fTBest), fTBest, fTNear))
+	{
+		pxStack[iStackPos].uNode  = uNode;
+		pxStack[iStackPos].fTNear = fTNear;
+		++iStackPos;
+	}
+}
+
+//////////////////////////////////////////////////////////////////////
+// Pushes the children of an inner node such that the closer one is popped first
+
+void COGLPickBVH::_PushRayChildren(const STree& xTree, const SNode& xNode, const float* pfOrig, const float* pfInvDir, float fPadScale, const SRay& rRay, float fTBest, SStackEntry* pxStack, int& iStackPos)
+{
+	int iFirstPos = iStackPos;
+
+	_PushRayNode(xTree, xNode.uFirst, pfOrig, pfInvDir, fPadScale, rRay, fTBest, pxStack, iStackPos);
+	_PushRayNode(xTree, xNode.uFirst + 1, pfOrig, pfInvDir, fPadScale, rRay, fTBest, pxStack, iStackPos);
+
+	if ((iStackPos == iFirstPos + 2) && (pxStack[iFirstPos].fTNear < pxStack[iFirstPos + 1].fTNear))
+	{
+		std::swap(pxStack[iFirstPos], pxStack[iFirstPos + 1]);
+	}
+}
+
+//////////////////////////////////////////////////////////////////////
+bool COGLPickBVH::_IsBoxOutside(const SBox& xBox, const float (*pfPlane)[4], int iPlaneCnt)
+{
+	for (int iPlane = 0; iPlane < iPlaneCnt; ++iPlane)
+	{
+		const float* pfP = pfPlane[iPlane];
+
+		// Corner of box furthest along plane normal
+		float fVal = pfP[3];
+		for (int i = 0; i < 3; ++i)
+		{
+			fVal += pfP[i] * (pfP[i] >= 0.0f ? xBox.pfMax[i] : xBox.pfMin[i]);
+		}
+
+		if (fVal < 0.0f)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
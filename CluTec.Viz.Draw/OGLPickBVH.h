@@ -0,0 +1,393 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// project:   CluTec.Viz.Draw
+// file:      OGLPickBVH.h
+//
+// summary:   Declares the bounding volume hierarchy used for picking on the CPU
+//
+//            Copyright (c) 2019 by Christian Perwass.
+//
+//            This file is part of the CluTecLib library.
+//
+//            The CluTecLib library is free software: you can redistribute it and / or modify
+//            it under the terms of the GNU Lesser General Public License as published by
+//            the Free Software Foundation, either version 3 of the License, or
+//            (at your option) any later version.
+//
+//            The CluTecLib library is distributed in the hope that it will be useful,
+//            but WITHOUT ANY WARRANTY; without even the implied warranty of
+//            MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//            GNU Lesser General Public License for more details.
+//
+//            You should have received a copy of the GNU Lesser General Public License
+//            along with the CluTecLib library.
+//            If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <vector>
+#include <map>
+
+#include "GL/gl.h"
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// <summary>
+/// 	Bounding volume hierarchy over the geometry of vertex lists, which answers ray and frustum pick queries on the CPU.
+///
+/// 	The hierarchy has two levels. For each vertex list (mesh) a hierarchy over its primitives is built in local
+/// 	coordinates. A vertex list that is drawn more than once is one mesh with several instances. Each instance has a
+/// 	transformation into the base frame and the top level hierarchy is built over the bounding boxes of all instances in
+/// 	the base frame. If only transformations change between updates, the top level hierarchy is refitted and not rebuilt.
+/// 	If the geometry of a mesh changes but not its primitive structure, the mesh hierarchy is refitted as well.
+///
+/// 	The class does not call any OpenGL functions. Scenes fill it while drawing via BeginUpdate(), AddInstance() and
+/// 	EndUpdate(), but it can equally be filled directly with geometry and transformations.
+///
+/// 	Transformations are OpenGL style column-major 4x4 matrices and are assumed to be affine.
+/// </summary>
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+class CLUDRAW_API COGLPickBVH
+{
+public:
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	/// <summary>
+	/// 	Geometry of a mesh. The data is only referenced and copied by SetGeometry().
+	/// </summary>
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	struct SGeometry
+	{
+		SGeometry()
+		{
+			eMode         = GL_POINTS;
+			pubVex        = nullptr;
+			nVexStride    = 3 * sizeof(float);
+			nVexCnt       = 0;
+			pubPartId     = nullptr;
+			nPartIdStride = sizeof(unsigned);
+		}
+
+		// The OpenGL primitive type
+		GLenum eMode;
+
+		// Pointer to first vertex of three floats and stride in bytes between vertices
+		const GLubyte* pubVex;
+		size_t nVexStride;
+		size_t nVexCnt;
+
+		// Pointer to first part ID and stride in bytes. May be null.
+		const GLubyte* pubPartId;
+		size_t nPartIdStride;
+
+		// Index lists. Each list is drawn separately with eMode.
+		// If there are no index lists, all vertices are drawn in order.
+		std::vector<const unsigned*> vecIdxList;
+		std::vector<size_t> vecIdxCnt;
+	};
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	/// <summary>
+	/// 	A pick ray in the base frame. The ray is vOrig + t * vDir with t in [0, fTMax]. Points and lines are hit if their
+	/// 	distance to the ray is at most fTol + t * fTolSlope, which models a pick cone for central projections.
+	/// </summary>
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	struct SRay
+	{
+		SRay()
+		{
+			pfOrig[0] = pfOrig[1] = pfOrig[2] = 0.0f;
+			pfDir[0]  = pfDir[1] = 0.0f;
+			pfDir[2]  = -1.0f;
+			fTMax     = 1e30f;
+			fTol      = 0.0f;
+			fTolSlope = 0.0f;
+		}
+
+		float pfOrig[3];
+		float pfDir[3];
+		float fTMax;
+		float fTol;
+		float fTolSlope;
+	};
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	/// <summary>
+	/// 	A pick hit.
+	/// </summary>
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	struct SHit
+	{
+		// Index of instance
+		unsigned uInst;
+		// The UID given for the instance
+		unsigned uUID;
+		// Index of primitive in order of drawing
+		unsigned uPrim;
+		// The part ID of the first vertex of the primitive, or zero
+		unsigned uPartId;
+		// Ray parameter of hit. Zero for frustum queries.
+		float fT;
+		// The hit position in the base frame. For frustum queries the first vertex of the primitive found.
+		float pfPos[3];
+	};
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	/// <summary>
+	/// 	Build and refit counters, mainly for testing.
+	/// </summary>
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	struct SStats
+	{
+		unsigned uInstBuildCnt;
+		unsigned uInstRefitCnt;
+		unsigned uMeshBuildCnt;
+		unsigned uMeshRefitCnt;
+	};
+
+protected:
+
+	struct SBox
+	{
+		float pfMin[3];
+		float pfMax[3];
+	};
+
+	// Node of a hierarchy. Inner nodes have uCount == 0 and their children are at uFirst and uFirst + 1.
+	// Leaf nodes reference uCount entries of the item index list starting at uFirst.
+	struct SNode
+	{
+		SBox xBox;
+		unsigned uFirst;
+		unsigned uCount;
+	};
+
+	struct STree
+	{
+		std::vector<SNode> vecNode;
+		std::vector<unsigned> vecItem;
+		float fBuildArea;
+	};
+
+	// A primitive is a triangle, line or point given by up to three vertex indices
+	struct SPrim
+	{
+		unsigned puVex[3];
+		unsigned uVexCnt;
+	};
+
+	struct SMesh
+	{
+		unsigned uStamp;
+		// True if the mesh has an instance in the next update
+		bool bUsed;
+		// True if the geometry changed since the last update
+		bool bChanged;
+
+		std::vector<float> vecVex;
+		std::vector<unsigned> vecPartId;
+		std::vector<SPrim> vecPrim;
+		std::vector<SBox> vecPrimBox;
+		STree xTree;
+	};
+
+	struct SInstance
+	{
+		const void* pvKey;
+		SMesh* pMesh;
+		unsigned uUID;
+
+		float pfMat[16];
+		float pfInvMat[16];
+		SBox xBox;
+
+		// Position and length of name stack in m_vecNameStack
+		size_t nNameFirst;
+		size_t nNameCnt;
+	};
+
+	struct SStackEntry
+	{
+		unsigned uNode;
+		float fTNear;
+	};
+
+	typedef std::map<const void*, SMesh> TMeshMap;
+
+public:
+
+	COGLPickBVH();
+	virtual ~COGLPickBVH();
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	/// <summary>	Removes all meshes and instances. </summary>
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	void Clear();
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	/// <summary>
+	/// 	Starts collecting the instances for the next update.
+	/// </summary>
+	///
+	/// <param name="pfBaseMat">	The model view matrix of the base frame, or null for the identity. Transformations given
+	/// 							to AddInstance() are mapped into this frame. </param>
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	void BeginUpdate(const float* pfBaseMat = nullptr);
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	/// <summary>	Query whether the geometry of the mesh with the given key and stamp is available. </summary>
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	bool IsGeometryCurrent(const void* pvKey, unsigned uStamp) const;
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	/// <summary>
+	/// 	Copies the geometry of a mesh. The stamp identifies the state of the geometry. If the mesh exists with the same
+	/// 	primitive structure, its hierarchy is refitted, otherwise it is rebuilt.
+	/// </summary>
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	void SetGeometry(const void* pvKey, unsigned uStamp, const SGeometry& rGeo);
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	/// <summary>
+	/// 	Adds an instance of a mesh for the current update. The geometry of the mesh has to be set before.
+	/// </summary>
+	///
+	/// <param name="pvKey">	   	The key of the mesh. </param>
+	/// <param name="uUID">		   	The UID reported for hits. </param>
+	/// <param name="pfModelView"> 	The model view matrix of the instance, or null for the base frame itself. </param>
+	/// <param name="puNameStack"> 	The pick name stack of the instance. May be null. </param>
+	/// <param name="nNameCnt">	   	Number of names in the stack. </param>
+	///
+	/// <returns>	False if no geometry is set for the key. </returns>
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	bool AddInstance(const void* pvKey, unsigned uUID, const float* pfModelView, const unsigned* puNameStack = nullptr, size_t nNameCnt = 0);
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	/// <summary>
+	/// 	Ends the update. If the sequence of instances is the same as in the previous update, the instance hierarchy is only
+	/// 	refitted, otherwise it is rebuilt. Meshes without instances are removed.
+	/// </summary>
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	void EndUpdate();
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	/// <summary>	Finds the closest primitive hit by the given ray. </summary>
+	///
+	/// <returns>	True if something was hit. </returns>
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	bool PickRay(const SRay& rRay, SHit& rHit) const;
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	/// <summary>
+	/// 	Finds all instances with at least one primitive inside the convex volume bounded by the given planes. A point x is
+	/// 	inside a plane p if p[0] x[0] + p[1] x[1] + p[2] x[2] + p[3] >= 0, as for glClipPlane. The test is conservative,
+	/// 	i.e. a primitive is only rejected if all its vertices are outside one plane.
+	/// </summary>
+	///
+	/// <returns>	The number of instances found. One hit per instance is appended to vecHit. </returns>
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	size_t PickFrustum(const float (*pfPlane)[4], int iPlaneCnt, std::vector<SHit>& vecHit) const;
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	/// <summary>
+	/// 	Evaluates the pick ray through the given point in normalized device coordinates from the projection times model
+	/// 	view matrix of the base frame. The ray starts on the near plane and ends with t = 1 on the far plane.
+	/// </summary>
+	///
+	/// <param name="pfViewProj">	The projection times model view matrix, column-major. </param>
+	/// <param name="fX">		 	The x coordinate in [-1, 1]. </param>
+	/// <param name="fY">		 	The y coordinate in [-1, 1]. </param>
+	/// <param name="fTolX">	 	The half width of the pick region in normalized device coordinates. </param>
+	/// <param name="fTolY">	 	The half height of the pick region in normalized device coordinates. The pick region is
+	/// 							approximated by a cone whose radius is the larger of the two half extents. </param>
+	/// <param name="rRay">		 	[out] The ray. </param>
+	///
+	/// <returns>	False if the matrix cannot be inverted. </returns>
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	static bool RayFromViewProj(const float* pfViewProj, float fX, float fY, float fTolX, float fTolY, SRay& rRay);
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	/// <summary>
+	/// 	Evaluates the six planes of the sub-frustum of the given rectangle in normalized device coordinates.
+	/// </summary>
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	static void FrustumFromViewProj(const float* pfViewProj, float fLeft, float fRight, float fBottom, float fTop, float pfPlane[6][4]);
+
+	bool IsEmpty() const { return m_vecInst.empty(); }
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	/// <summary>
+	/// 	Marks the hierarchy as out of date, e.g. if the scene changed since the last update. The flag is reset by the next
+	/// 	update.
+	/// </summary>
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	void Invalidate() { m_bDirty = true; }
+	bool IsDirty() const { return m_bDirty; }
+	size_t GetInstanceCount() const { return m_vecInst.size(); }
+	size_t GetMeshCount() const { return m_mapMesh.size(); }
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	/// <summary>	Gets the pick name stack of an instance. </summary>
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	const unsigned* GetInstanceNameStack(unsigned uInst, size_t& nNameCnt) const;
+
+	const SStats& GetStats() const { return m_xStats; }
+	void ResetStats();
+
+protected:
+
+	static void _BoxEmpty(SBox& xBox);
+	static void _BoxAdd(SBox& xBox, const float* pfPnt);
+	static void _BoxAdd(SBox& xBox, const SBox& xBoxB);
+	static float _BoxArea(const SBox& xBox);
+	static void _TransformBox(SBox& xBoxOut, const float* pfMat, const SBox& xBox);
+	static void _TransformPoint(float* pfOut, const float* pfMat, const float* pfPnt);
+	static void _TransformDir(float* pfOut, const float* pfMat, const float* pfDir);
+	static void _MultMatrix(float* pfOut, const float* pfA, const float* pfB);
+	static bool _InvertMatrix(float* pfOut, const float* pfMat);
+
+	static void _BuildTree(STree& xTree, const std::vector<SBox>& vecBox);
+	static void _BuildNode(STree& xTree, unsigned uNode, unsigned uFirst, unsigned uCount, const std::vector<SBox>& vecBox, const std::vector<float>& vecCenter);
+	static void _RefitTree(STree& xTree, const std::vector<SBox>& vecBox);
+
+	static bool _IntersectBox(const SBox& xBox, const float* pfOrig, const float* pfInvDir, float fPad, float fTMax, float& fTNear);
+	static bool _IsBoxOutside(const SBox& xBox, const float (*pfPlane)[4], int iPlaneCnt);
+	static void _PushRayNode(const STree& xTree, unsigned uNode, const float* pfOrig, const float* pfInvDir, float fPadScale, const SRay& rRay, float fTBest, SStackEntry* pxStack, int& iStackPos);
+	static void _PushRayChildren(const STree& xTree, const SNode& xNode, const float* pfOrig, const float* pfInvDir, float fPadScale, const SRay& rRay, float fTBest, SStackEntry* pxStack, int& iStackPos);
+
+	static void _AddPrimitives(SMesh& xMesh, const SGeometry& rGeo, const unsigned* puIdx, size_t nIdxCnt);
+	void _UpdateInstanceBox(SInstance& xInst);
+	void _BuildInstanceTree();
+
+	bool _PickMesh(const SInstance& xInst, const SRay& rRay, float& fTBest, SHit& rHit) const;
+	bool _PickMeshFrustum(const SInstance& xInst, const float (*pfPlane)[4], int iPlaneCnt, SHit& rHit) const;
+
+protected:
+
+	// All meshes by key
+	TMeshMap m_mapMesh;
+
+	// Instances of current and of next update
+	std::vector<SInstance> m_vecInst;
+	std::vector<SInstance> m_vecNextInst;
+
+	// Name stacks of all instances of current and next update
+	std::vector<unsigned> m_vecNameStack;
+	std::vector<unsigned> m_vecNextNameStack;
+
+	// Hierarchy over instances
+	STree m_xInstTree;
+	std::vector<SBox> m_vecInstBox;
+
+	// Inverse of base frame of next update
+	float m_pfInvBaseMat[16];
+	bool m_bHasBaseMat;
+
+	// True if the hierarchy does not reflect the current scene
+	bool m_bDirty;
+
+	SStats m_xStats;
+
+	// Maximal number of items in leaf node
+	static const unsigned sm_uMaxLeafSize = 4;
+};
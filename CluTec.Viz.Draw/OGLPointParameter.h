@@ -59,6 +59,9 @@ public:
 
 	bool Apply(COGLBaseElement::EApplyMode eMode, COGLBaseElement::SApplyData &rData);
 
+	// Does not draw anything, but changes state
+	const SBoundInfo& GetBoundInfo() { return GetStateBoundInfo(); }
+
 protected:
 	GLfloat m_fSize;
 	GLfloat m_fSizeMin, m_fSizeMax;
@@ -0,0 +1,734 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// project:   CluTec.Viz.Draw
+// file:      OGLRenderQueue.cpp
+//
+// summary:   Implements the render queue of flattened scene elements sorted by state
+//
+//            Copyright (c) 2019 by Christian Perwass.
+//
+//            This file is part of the CluTecLib library.
+//
+//            The CluTecLib library is free software: you can redistribute it and / or modify
+//            it under the terms of the GNU Lesser General Public License as published by
+//            the Free Software Foundation, either version 3 of the License, or
+//            (at your option) any later version.
+//
+//            The CluTecLib library is distributed in the hope that it will be useful,
+//            but WITHOUT ANY WARRANTY; without even the implied warranty of
+//            MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//            GNU Lesser General Public License for more details.
+//
+//            You should have received a copy of the GNU Lesser General Public License
+//            along with the CluTecLib library.
+//            If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "stdafx.h"
+#include "OGLRenderQueue.h"
+#include "OGLScene.h"
+#include "OGLFrame.h"
+#include "OGLVertexList.h"
+#include "OGLColor.h"
+#include "OGLAnimColor.h"
+#include "OGLMaterial.h"
+#include "OGLBlend.h"
+#include "OGLShader.h"
+#include "OGLTexture.h"
+#include "OGLLineWidth.h"
+#include "OGLPointParameter.h"
+#include "CluTec.Base/Exception.h"
+
+#include <algorithm>
+#include <cstring>
+#include <typeinfo>
+
+namespace
+{
+	//////////////////////////////////////////////////////////////////////
+	/// Depth of the center of a box, or of the origin if there is no box, in eye coordinates. Larger values are closer to the viewer.
+
+	double EyeDepth(const COGLBoundingBox* pBox, const double* pdFrame)
+	{
+		double pdCenter[3] = { 0.0, 0.0, 0.0 };
+
+		if (pBox)
+		{
+			for (int i = 0; i < 3; ++i)
+			{
+				pdCenter[i] = 0.5 * (double(pBox->GetMin()[i]) + double(pBox->GetMax()[i]));
+			}
+		}
+
+		return pdFrame[2] * pdCenter[0] + pdFrame[6] * pdCenter[1] + pdFrame[10] * pdCenter[2] + pdFrame[14];
+	}
+
+	std::string Describe(const char* pcCmd, const COGLBaseElement& rElement)
+	{
+		std::string sCmd = std::string(pcCmd) + " " + rElement.GetTypeName();
+		std::string sName = rElement.GetName();
+
+		if (!sName.empty())
+		{
+			sCmd += " " + sName;
+		}
+
+		return sCmd;
+	}
+
+	//////////////////////////////////////////////////////////////////////
+	/// Executes the queue with OpenGL
+
+	class CApplyExec
+	{
+	public:
+
+		CApplyExec(COGLBaseElement::EApplyMode eMode, COGLBaseElement::SApplyData& rData)
+			: m_eMode(eMode), m_rData(rData)
+		{ }
+
+		void GetBase(double* pdBase)
+		{
+			m_rData.xMatrixStack.GetMatrix(Clu::CMatrixStack::ModelView, pdBase);
+			m_rData.xMatrixStack.GetMatrix(Clu::CMatrixStack::Projection, m_pdProj);
+		}
+
+		bool IsColorTransparent()
+		{ return m_rData.pfCurColor[3] < 1.0f; }
+
+		bool State(COGLBaseElement& rElement)
+		{ return rElement.Apply(m_eMode, m_rData); }
+
+		bool Draw(COGLBaseElement& rElement, const double* pdFrame, const COGLBoundingBox* pBox)
+		{
+			// Same conditions as for culling in COGLBaseElementList::ApplyList()
+			if (pBox && m_rData.bCullEnable && (m_rData.eCullState == COGLBaseElement::CULL_TEST) && !m_rData.pCurShader)
+			{
+				double pdClip[16];
+				COGLBoundingBox::MultMatrix(pdClip, m_pdProj, pdFrame);
+
+				++m_rData.xCullStats.uTestCnt;
+				if (pBox->Clip(pdClip) == COGLBoundingBox::OUTSIDE)
+				{
+					++m_rData.xCullStats.uCullCnt;
+					return true;
+				}
+			}
+
+			m_rData.xMatrixStack.LoadMatrix(pdFrame);
+			return rElement.Apply(m_eMode, m_rData);
+		}
+
+		bool End(COGLBaseElement* pElement, const double* pdFrame)
+		{
+			m_rData.xMatrixStack.LoadMatrix(pdFrame);
+			return (pElement ? pElement->Apply(m_eMode, m_rData) : true);
+		}
+
+	protected:
+
+		COGLBaseElement::EApplyMode m_eMode;
+		COGLBaseElement::SApplyData& m_rData;
+		double m_pdProj[16];
+	};
+
+	//////////////////////////////////////////////////////////////////////
+	/// Records the commands of the queue
+
+	class CRecordExec
+	{
+	public:
+
+		CRecordExec(std::vector<std::string>& vecCmd)
+			: m_vecCmd(vecCmd)
+		{ }
+
+		void GetBase(double* pdBase)
+		{ COGLBoundingBox::Identity(pdBase); }
+
+		bool IsColorTransparent()
+		{ return false; }
+
+		bool State(COGLBaseElement& rElement)
+		{
+			m_vecCmd.push_back(Describe("state", rElement));
+			return true;
+		}
+
+		bool Draw(COGLBaseElement& rElement, const double* pdFrame, const COGLBoundingBox* pBox)
+		{
+			m_vecCmd.push_back(Describe("draw", rElement));
+			return true;
+		}
+
+		bool End(COGLBaseElement* pElement, const double* pdFrame)
+		{
+			if (pElement)
+			{
+				m_vecCmd.push_back(Describe("apply", *pElement));
+			}
+
+			return true;
+		}
+
+	protected:
+
+		std::vector<std::string>& m_vecCmd;
+	};
+}
+
+//////////////////////////////////////////////////////////////////////
+// Construction/Destruction
+//////////////////////////////////////////////////////////////////////
+
+COGLRenderQueue::COGLRenderQueue()
+{
+	m_bValid        = false;
+	m_nSegmentFirst = 0;
+	m_uStateCnt     = 0;
+	m_bColorLast    = false;
+	memset(m_puState, 0, SLOT_COUNT * sizeof(unsigned));
+	memset(&m_xStats, 0, sizeof(SStats));
+}
+
+COGLRenderQueue::~COGLRenderQueue()
+{
+}
+
+//////////////////////////////////////////////////////////////////////
+void COGLRenderQueue::Clear()
+{
+	m_vecItem.clear();
+	m_vecSegment.clear();
+	m_vecState.clear();
+	m_mapStateIdx.clear();
+	m_mapColorIdx.clear();
+	m_vecColor.clear();
+	m_bValid = false;
+
+	m_xStats.uDrawItemCnt = 0;
+	m_xStats.uSegmentCnt  = 0;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Build
+
+void COGLRenderQueue::Build(COGLScene& rScene)
+{
+	Clear();
+
+	// State index zero stands for the state set before a segment
+	m_vecState.push_back(COGLBEReference());
+
+	m_nSegmentFirst = 0;
+	m_uStateCnt     = 0;
+	m_bColorLast    = false;
+	memset(m_puState, 0, SLOT_COUNT * sizeof(unsigned));
+
+	double pdFrame[16];
+	COGLBoundingBox::Identity(pdFrame);
+
+	_AddElementList(rScene.GetElementList(), pdFrame, rScene.IsAutoAdaptFrontFaceEnabled());
+
+	// The last segment only restores the state and the frame at the end of the scene
+	_EndSegment(COGLBEReference(), pdFrame);
+	m_vecSegment.back().bHasEnd = false;
+
+	m_mapStateIdx.clear();
+	m_mapColorIdx.clear();
+	m_bValid = true;
+
+	++m_xStats.uBuildCnt;
+	m_xStats.uDrawItemCnt = unsigned(m_vecItem.size());
+	m_xStats.uSegmentCnt  = unsigned(m_vecSegment.size());
+}
+
+//////////////////////////////////////////////////////////////////////
+void COGLRenderQueue::_AddElementList(const std::list<COGLBEReference>& listElement, double* pdFrame, bool bAutoAdaptFrontFace)
+{
+	for (const COGLBEReference& refElement : listElement)
+	{
+		if (!refElement.IsValid())
+		{
+			// Applying the queue fails at this point, as applying the list would
+			_EndSegment(refElement, pdFrame);
+			continue;
+		}
+
+		COGLBaseElement* pElement = (COGLBEReference::TObjectPtr) refElement;
+
+		// Evaluating the bounds of all elements makes sure that they tell the scene when they change
+		const COGLBaseElement::SBoundInfo& xInfo = pElement->GetBoundInfo();
+
+		int iSlot = 0;
+		switch (_GetKind(pElement, bAutoAdaptFrontFace, iSlot))
+		{
+		case KIND_NONE:
+			break;
+
+		case KIND_DRAW:
+		{
+			m_vecItem.push_back(SItem());
+			SItem& xItem = m_vecItem.back();
+
+			_SetItem(xItem, refElement, pdFrame);
+			xItem.bBounded = xInfo.bBounded && !xInfo.xBox.IsEmpty();
+			xItem.xBox     = xInfo.xBox;
+			break;
+		}
+
+		case KIND_STATE:
+			if (m_puState[iSlot] == 0)
+			{
+				++m_uStateCnt;
+			}
+
+			m_puState[iSlot] = _GetStateIndex(refElement);
+
+			if (iSlot == SLOT_MATERIAL)
+			{
+				m_bColorLast = false;
+			}
+			else if (iSlot == SLOT_COLOR)
+			{
+				m_bColorLast = true;
+			}
+			break;
+
+		case KIND_TRANSFORM:
+		{
+			double pdPrev[16];
+			memcpy(pdPrev, pdFrame, 16 * sizeof(double));
+			COGLBoundingBox::MultMatrix(pdFrame, pdPrev, xInfo.pdTransform);
+			break;
+		}
+
+		case KIND_GROUP:
+		{
+			// The scene restores the frame, but not the state
+			double pdGroupFrame[16];
+			memcpy(pdGroupFrame, pdFrame, 16 * sizeof(double));
+			_AddElementList(static_cast<COGLScene*>(pElement)->GetElementList(), pdGroupFrame, bAutoAdaptFrontFace);
+			break;
+		}
+
+		case KIND_APPLY:
+			_EndSegment(refElement, pdFrame);
+			COGLBoundingBox::Identity(pdFrame);
+			break;
+		}
+	}
+}
+
+//////////////////////////////////////////////////////////////////////
+void COGLRenderQueue::_EndSegment(const COGLBEReference& refElement, const double* pdFrame)
+{
+	m_vecSegment.push_back(SSegment());
+	SSegment& xSeg = m_vecSegment.back();
+
+	xSeg.nFirst  = m_nSegmentFirst;
+	xSeg.nEnd    = m_vecItem.size();
+	xSeg.nSorted = xSeg.nFirst;
+	xSeg.bHasEnd = true;
+
+	_SetItem(xSeg.xEnd, refElement, pdFrame);
+	xSeg.xEnd.bBounded = false;
+
+	if (xSeg.nEnd > xSeg.nFirst)
+	{
+		// Slots are only added in a segment, so that all draw items after the last one that uses a state set before the
+		// segment use the same slots and can be sorted.
+		unsigned uSortStateCnt = m_vecItem[xSeg.nEnd - 1].uStateCnt;
+
+		while ((xSeg.nSorted < xSeg.nEnd) && (m_vecItem[xSeg.nSorted].uStateCnt < uSortStateCnt))
+		{
+			++xSeg.nSorted;
+		}
+
+		std::stable_sort(m_vecItem.begin() + xSeg.nSorted, m_vecItem.begin() + xSeg.nEnd,
+				[](const SItem& xA, const SItem& xB)
+		{
+			for (int iSlot = 0; iSlot < SLOT_COUNT; ++iSlot)
+			{
+				if (xA.puState[iSlot] != xB.puState[iSlot])
+				{
+					return xA.puState[iSlot] < xB.puState[iSlot];
+				}
+			}
+
+			return !xA.bColorLast && xB.bColorLast;
+		});
+	}
+
+	// The state of the next segment is the state at the end of this one
+	m_nSegmentFirst = m_vecItem.size();
+	m_uStateCnt     = 0;
+	m_bColorLast    = false;
+	memset(m_puState, 0, SLOT_COUNT * sizeof(unsigned));
+}
+
+//////////////////////////////////////////////////////////////////////
+void COGLRenderQueue::_SetItem(SItem& xItem, const COGLBEReference& refElement, const double* pdFrame)
+{
+	xItem.refElement = refElement;
+	memcpy(xItem.pdFrame, pdFrame, 16 * sizeof(double));
+	memcpy(xItem.puState, m_puState, SLOT_COUNT * sizeof(unsigned));
+	xItem.uStateCnt  = m_uStateCnt;
+	xItem.bColorLast = m_bColorLast;
+	xItem.bBounded   = false;
+}
+
+//////////////////////////////////////////////////////////////////////
+unsigned COGLRenderQueue::_GetStateIndex(const COGLBEReference& refElement)
+{
+	COGLBaseElement* pElement = (COGLBEReference::TObjectPtr) refElement;
+
+	auto itState = m_mapStateIdx.find(pElement);
+	if (itState != m_mapStateIdx.end())
+	{
+		return itState->second;
+	}
+
+	COGLColor* pColor = dynamic_cast<COGLColor*>(pElement);
+	if (pColor)
+	{
+		const float* pfCol = pColor->Data();
+		auto xValue        = std::make_tuple(pfCol[0], pfCol[1], pfCol[2], pfCol[3]);
+		auto itColor       = m_mapColorIdx.find(xValue);
+
+		m_vecColor.push_back(std::make_pair(refElement, xValue));
+
+		if (itColor != m_mapColorIdx.end())
+		{
+			m_mapStateIdx[pElement] = itColor->second;
+			return itColor->second;
+		}
+	}
+
+	unsigned uIdx = unsigned(m_vecState.size());
+	m_vecState.push_back(refElement);
+	m_mapStateIdx[pElement] = uIdx;
+
+	if (pColor)
+	{
+		const float* pfCol = pColor->Data();
+		m_mapColorIdx[std::make_tuple(pfCol[0], pfCol[1], pfCol[2], pfCol[3])] = uIdx;
+	}
+
+	return uIdx;
+}
+
+//////////////////////////////////////////////////////////////////////
+// True if the value of a color element changed since the queue was built,
+// so that it may not share the state of the other colors anymore
+
+bool COGLRenderQueue::_HaveColorsChanged() const
+{
+	for (const auto& xColor : m_vecColor)
+	{
+		const COGLColor* pColor = dynamic_cast<const COGLColor*>((COGLBEReference::TObjectPtr) xColor.first);
+		if (!pColor)
+		{
+			continue;
+		}
+
+		const float* pfCol = pColor->Data();
+		if (std::make_tuple(pfCol[0], pfCol[1], pfCol[2], pfCol[3]) != xColor.second)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Classify elements
+
+COGLRenderQueue::EKind COGLRenderQueue::_GetKind(COGLBaseElement* pElement, bool bAutoAdaptFrontFace, int& iSlot)
+{
+	if (COGLVertexList* pVexList = dynamic_cast<COGLVertexList*>(pElement))
+	{
+		// Overriding the alpha value changes the current color
+		return (pVexList->UseOverrideAlpha() ? KIND_APPLY : KIND_DRAW);
+	}
+
+	if (COGLShader* pShader = dynamic_cast<COGLShader*>(pElement))
+	{
+		if (!pShader->IsEnabled())
+		{
+			return KIND_NONE;
+		}
+
+		iSlot = SLOT_SHADER;
+		return KIND_STATE;
+	}
+
+	if (COGLTexture* pTexture = dynamic_cast<COGLTexture*>(pElement))
+	{
+		if (pTexture->GetTextureUnit() >= OGL_MAX_TEX_UNITS)
+		{
+			return KIND_APPLY;
+		}
+
+		iSlot = SLOT_TEXTURE + int(pTexture->GetTextureUnit());
+		return KIND_STATE;
+	}
+
+	if (COGLMaterial* pMaterial = dynamic_cast<COGLMaterial*>(pElement))
+	{
+		// Materials of only front or back faces do not replace each other
+		if (pMaterial->GetFace() != GL_FRONT_AND_BACK)
+		{
+			return KIND_APPLY;
+		}
+
+		iSlot = SLOT_MATERIAL;
+		return KIND_STATE;
+	}
+
+	if (dynamic_cast<COGLBlend*>(pElement))
+	{
+		iSlot = SLOT_BLEND;
+		return KIND_STATE;
+	}
+
+	if (dynamic_cast<COGLColor*>(pElement))
+	{
+		// An animated color depends on the time it is applied at
+		if (dynamic_cast<COGLAnimColor*>(pElement))
+		{
+			return KIND_APPLY;
+		}
+
+		iSlot = SLOT_COLOR;
+		return KIND_STATE;
+	}
+
+	if (dynamic_cast<COGLLineWidth*>(pElement))
+	{
+		iSlot = SLOT_LINEWIDTH;
+		return KIND_STATE;
+	}
+
+	if (dynamic_cast<COGLPointParameter*>(pElement))
+	{
+		iSlot = SLOT_POINTPARAMETER;
+		return KIND_STATE;
+	}
+
+	if (COGLScene* pScene = dynamic_cast<COGLScene*>(pElement))
+	{
+		return (_IsGroup(*pScene, bAutoAdaptFrontFace) ? KIND_GROUP : KIND_APPLY);
+	}
+
+	// A reflecting frame inverts the front face of the following vertex lists
+	if (COGLFrame* pFrame = dynamic_cast<COGLFrame*>(pElement))
+	{
+		if (pFrame->InvertsFrontFace())
+		{
+			return KIND_APPLY;
+		}
+	}
+
+	const COGLBaseElement::SBoundInfo& xInfo = pElement->GetBoundInfo();
+	if (xInfo.bBounded && xInfo.bHasTransform && !xInfo.bHasState && (xInfo.uGeoCnt == 0))
+	{
+		return KIND_TRANSFORM;
+	}
+
+	return KIND_APPLY;
+}
+
+//////////////////////////////////////////////////////////////////////
+bool COGLRenderQueue::_IsGroup(COGLScene& rScene, bool bAutoAdaptFrontFace)
+{
+	// Classes derived from scenes, like tools, may change how the scene is applied
+	if ((typeid(rScene) != typeid(COGLScene)) || !rScene.CanFlatten(bAutoAdaptFrontFace))
+	{
+		return false;
+	}
+
+	for (const COGLBEReference& refElement : rScene.GetElementList())
+	{
+		int iSlot = 0;
+		if (!refElement.IsValid() || (_GetKind((COGLBEReference::TObjectPtr) refElement, bAutoAdaptFrontFace, iSlot) == KIND_APPLY))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////
+bool COGLRenderQueue::_IsTransparent(const SItem& xItem, bool bColorTransparent) const
+{
+	unsigned uBlend = xItem.puState[SLOT_BLEND];
+	if (uBlend && !static_cast<COGLBlend*>((COGLBEReference::TObjectPtr) m_vecState[uBlend])->IsDefault())
+	{
+		return true;
+	}
+
+	unsigned uColor = xItem.puState[SLOT_COLOR];
+	if (uColor)
+	{
+		return static_cast<COGLColor*>((COGLBEReference::TObjectPtr) m_vecState[uColor])->Alpha() < 1.0f;
+	}
+
+	return bColorTransparent;
+}
+
+//////////////////////////////////////////////////////////////////////
+template<class TExec>
+bool COGLRenderQueue::_Run(TExec& xExec)
+{
+	unsigned puCurState[SLOT_COUNT];
+	double pdBase[16], pdFrame[16];
+
+	m_xStats.uStateChangeCnt = 0;
+
+	for (const SSegment& xSeg : m_vecSegment)
+	{
+		// The frame and the state at the start of the segment
+		xExec.GetBase(pdBase);
+		memset(puCurState, 0, SLOT_COUNT * sizeof(unsigned));
+		bool bCurColorLast     = false;
+		bool bColorTransparent = xExec.IsColorTransparent();
+
+		// Draw items that use a state set before the segment in script order
+		for (size_t nIdx = xSeg.nFirst; nIdx < xSeg.nSorted; ++nIdx)
+		{
+			const SItem& xItem = m_vecItem[nIdx];
+			COGLBoundingBox::MultMatrix(pdFrame, pdBase, xItem.pdFrame);
+
+			if (!_SetState(xExec, xItem, puCurState, bCurColorLast) ||
+			    !xExec.Draw(*(COGLBEReference::TObjectPtr) xItem.refElement, pdFrame, xItem.bBounded ? &xItem.xBox : nullptr))
+			{
+				return false;
+			}
+		}
+
+		// Opaque draw items in the order of their state
+		m_vecDepth.clear();
+		for (size_t nIdx = xSeg.nSorted; nIdx < xSeg.nEnd; ++nIdx)
+		{
+			const SItem& xItem = m_vecItem[nIdx];
+			COGLBoundingBox::MultMatrix(pdFrame, pdBase, xItem.pdFrame);
+
+			if (_IsTransparent(xItem, bColorTransparent))
+			{
+				m_vecDepth.push_back(std::make_pair(EyeDepth(xItem.bBounded ? &xItem.xBox : nullptr, pdFrame), nIdx));
+				continue;
+			}
+
+			if (!_SetState(xExec, xItem, puCurState, bCurColorLast) ||
+			    !xExec.Draw(*(COGLBEReference::TObjectPtr) xItem.refElement, pdFrame, xItem.bBounded ? &xItem.xBox : nullptr))
+			{
+				return false;
+			}
+		}
+
+		// Transparent draw items from back to front
+		std::stable_sort(m_vecDepth.begin(), m_vecDepth.end(),
+				[](const std::pair<double, size_t>& xA, const std::pair<double, size_t>& xB) { return xA.first < xB.first; });
+
+		for (const std::pair<double, size_t>& xDepth : m_vecDepth)
+		{
+			const SItem& xItem = m_vecItem[xDepth.second];
+			COGLBoundingBox::MultMatrix(pdFrame, pdBase, xItem.pdFrame);
+
+			if (!_SetState(xExec, xItem, puCurState, bCurColorLast) ||
+			    !xExec.Draw(*(COGLBEReference::TObjectPtr) xItem.refElement, pdFrame, xItem.bBounded ? &xItem.xBox : nullptr))
+			{
+				return false;
+			}
+		}
+
+		// Restore the state and the frame at the end of the segment and apply the element that ends it
+		if (xSeg.bHasEnd && !xSeg.xEnd.refElement.IsValid())
+		{
+			return false;
+		}
+
+		COGLBoundingBox::MultMatrix(pdFrame, pdBase, xSeg.xEnd.pdFrame);
+
+		if (!_SetState(xExec, xSeg.xEnd, puCurState, bCurColorLast) ||
+		    !xExec.End(xSeg.bHasEnd ? (COGLBEReference::TObjectPtr) xSeg.xEnd.refElement : nullptr, pdFrame))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////
+template<class TExec>
+bool COGLRenderQueue::_SetState(TExec& xExec, const SItem& xItem, unsigned* puCurState, bool& bCurColorLast)
+{
+	// With color material enabled the material and the color both set the material colors. The one set last in the
+	// script is applied after the other one and is applied again if the other one was applied after it.
+	int iFirst = (xItem.bColorLast ? SLOT_MATERIAL : SLOT_COLOR);
+	int iLast  = (xItem.bColorLast ? SLOT_COLOR : SLOT_MATERIAL);
+	bool bKeepOrder = (xItem.puState[iFirst] != 0);
+
+	for (int iPos = 0; iPos < SLOT_COUNT; ++iPos)
+	{
+		int iSlot = (iPos == SLOT_MATERIAL ? iFirst : (iPos == SLOT_COLOR ? iLast : iPos));
+
+		unsigned uIdx = xItem.puState[iSlot];
+		if (uIdx == 0)
+		{
+			continue;
+		}
+
+		bool bApply = (uIdx != puCurState[iSlot]) || ((iSlot == iLast) && bKeepOrder && (bCurColorLast != xItem.bColorLast));
+		if (!bApply)
+		{
+			continue;
+		}
+
+		if (!xExec.State(*(COGLBEReference::TObjectPtr) m_vecState[uIdx]))
+		{
+			return false;
+		}
+
+		puCurState[iSlot] = uIdx;
+		++m_xStats.uStateChangeCnt;
+
+		if (iSlot == SLOT_MATERIAL)
+		{
+			bCurColorLast = false;
+		}
+		else if (iSlot == SLOT_COLOR)
+		{
+			bCurColorLast = true;
+		}
+	}
+
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Apply
+
+bool COGLRenderQueue::Apply(COGLBaseElement::EApplyMode eMode, COGLBaseElement::SApplyData& rData)
+{
+	try
+	{
+		CApplyExec xExec(eMode, rData);
+		return _Run(xExec);
+	}
+	catch (Clu::CIException& ex)
+	{
+		throw CLU_EXCEPTION_NEST("Error applying render queue", std::move(ex));
+	}
+}
+
+//////////////////////////////////////////////////////////////////////
+void COGLRenderQueue::Record(std::vector<std::string>& vecCmd)
+{
+	CRecordExec xExec(vecCmd);
+	_Run(xExec);
+}
@@ -0,0 +1,216 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// project:   CluTec.Viz.Draw
+// file:      OGLRenderQueue.h
+//
+// summary:   Declares the render queue of flattened scene elements sorted by state
+//
+//            Copyright (c) 2019 by Christian Perwass.
+//
+//            This file is part of the CluTecLib library.
+//
+//            The CluTecLib library is free software: you can redistribute it and / or modify
+//            it under the terms of the GNU Lesser General Public License as published by
+//            the Free Software Foundation, either version 3 of the License, or
+//            (at your option) any later version.
+//
+//            The CluTecLib library is distributed in the hope that it will be useful,
+//            but WITHOUT ANY WARRANTY; without even the implied warranty of
+//            MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//            GNU Lesser General Public License for more details.
+//
+//            You should have received a copy of the GNU Lesser General Public License
+//            along with the CluTecLib library.
+//            If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <vector>
+#include <string>
+#include <map>
+#include <tuple>
+#include <utility>
+
+#include "OGLBaseElement.h"
+
+class COGLScene;
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// <summary>
+/// 	Render queue of the elements of a scene. The element tree of the scene is flattened into a list of draw items, one
+/// 	for each vertex list, which store the transformation and the state elements (shader, textures, material, blending,
+/// 	color, line width and point parameters) that are active when the vertex list is drawn. The draw items are sorted by
+/// 	their state, so that each state element is applied as rarely as possible. Draw items that are transparent, i.e.
+/// 	drawn with blending or with a color alpha below one, are drawn after the opaque ones from back to front.
+///
+/// 	Elements that cannot be flattened, like text, images or scenes with their own view, are applied in script order.
+/// 	They split the queue into segments and draw items are only sorted within a segment. Draw items at the start of
+/// 	a segment that still use state set before the segment keep their order.
+///
+/// 	The queue only references the elements, so that changes of materials or vertex data are used without building the
+/// 	queue again. It has to be built again if the element tree or a transformation changes. Color elements of equal
+/// 	value share one state, so the queue is also built again if the value of one of its color elements changes.
+/// </summary>
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+class CLUDRAW_API COGLRenderQueue
+{
+public:
+
+	// Slots of state elements in order of the sort priority
+	enum EStateSlot
+	{
+		SLOT_SHADER = 0,
+		SLOT_TEXTURE,
+		SLOT_MATERIAL = SLOT_TEXTURE + OGL_MAX_TEX_UNITS,
+		SLOT_BLEND,
+		SLOT_COLOR,
+		SLOT_LINEWIDTH,
+		SLOT_POINTPARAMETER,
+		SLOT_COUNT
+	};
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	/// <summary>
+	/// 	Counters of building and applying the queue.
+	/// </summary>
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	struct SStats
+	{
+		unsigned uBuildCnt;
+		unsigned uDrawItemCnt;
+		unsigned uSegmentCnt;
+		// Number of state elements applied when the queue was last applied
+		unsigned uStateChangeCnt;
+	};
+
+protected:
+
+	// How an element is added to the queue
+	enum EKind
+	{
+		// Does not do anything
+		KIND_NONE = 0,
+		// A vertex list that becomes a draw item
+		KIND_DRAW,
+		// An element that sets the state of a slot
+		KIND_STATE,
+		// An element that only changes the model view matrix
+		KIND_TRANSFORM,
+		// A scene whose elements are added to the queue directly
+		KIND_GROUP,
+		// An element that is applied in script order
+		KIND_APPLY
+	};
+
+	struct SItem
+	{
+		// The vertex list drawn, or the element applied in script order at the end of a segment
+		COGLBEReference refElement;
+		// Transformation from the frame at the start of the segment to the frame of the element
+		double pdFrame[16];
+		// Index into m_vecState for each slot. Zero if the state is set before the segment.
+		unsigned puState[SLOT_COUNT];
+		// Number of slots with a state set in the segment
+		unsigned uStateCnt;
+		// True if the color was set after the material. With color material enabled both set the material colors.
+		bool bColorLast;
+		// Bounds of the vertex list in its frame
+		bool bBounded;
+		COGLBoundingBox xBox;
+	};
+
+	struct SSegment
+	{
+		// Draw items [nFirst, nSorted) keep their order, [nSorted, nEnd) are sorted by state
+		size_t nFirst;
+		size_t nSorted;
+		size_t nEnd;
+		// The state and frame at the end of the segment and the element applied there, if any
+		SItem xEnd;
+		bool bHasEnd;
+	};
+
+public:
+
+	COGLRenderQueue();
+	virtual ~COGLRenderQueue();
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	/// <summary>	Builds the queue from the elements of the scene. </summary>
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	void Build(COGLScene& rScene);
+
+	void Clear();
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	/// <summary>	Marks the queue to be built again before it is applied the next time. </summary>
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	void Invalidate() { m_bValid = false; }
+	bool IsValid() const { return m_bValid && !_HaveColorsChanged(); }
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	/// <summary>
+	/// 	Applies the queue in the current frame. Has the same effect as applying the elements of the scene in order.
+	/// </summary>
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	bool Apply(COGLBaseElement::EApplyMode eMode, COGLBaseElement::SApplyData& rData);
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	/// <summary>
+	/// 	Runs through the queue as Apply() does, but without calling OpenGL. Instead, each state element applied, vertex
+	/// 	list drawn and element applied in script order is appended to vecCmd as "state", "draw" or "apply", followed by
+	/// 	the type name and the name of the element. All elements are assumed to be inside of the view and the queue is
+	/// 	run in the identity frame.
+	/// </summary>
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	void Record(std::vector<std::string>& vecCmd);
+
+	const SStats& GetStats() const { return m_xStats; }
+
+protected:
+
+	void _AddElementList(const std::list<COGLBEReference>& listElement, double* pdFrame, bool bAutoAdaptFrontFace);
+	void _EndSegment(const COGLBEReference& refElement, const double* pdFrame);
+	void _SetItem(SItem& xItem, const COGLBEReference& refElement, const double* pdFrame);
+
+	static EKind _GetKind(COGLBaseElement* pElement, bool bAutoAdaptFrontFace, int& iSlot);
+	static bool _IsGroup(COGLScene& rScene, bool bAutoAdaptFrontFace);
+
+	unsigned _GetStateIndex(const COGLBEReference& refElement);
+	bool _HaveColorsChanged() const;
+
+	bool _IsTransparent(const SItem& xItem, bool bColorTransparent) const;
+
+	template<class TExec>
+	bool _Run(TExec& xExec);
+
+	template<class TExec>
+	bool _SetState(TExec& xExec, const SItem& xItem, unsigned* puCurState, bool& bCurColorLast);
+
+protected:
+
+	bool m_bValid;
+
+	std::vector<SItem> m_vecItem;
+	std::vector<SSegment> m_vecSegment;
+
+	// State elements referenced by the draw items. The first entry is the empty reference.
+	std::vector<COGLBEReference> m_vecState;
+	std::map<COGLBaseElement*, unsigned> m_mapStateIdx;
+	// Colors are compared by value, since a new color element is added each time a script sets a color
+	std::map<std::tuple<float, float, float, float>, unsigned> m_mapColorIdx;
+	// The color elements of the queue with their values when the queue was built
+	std::vector<std::pair<COGLBEReference, std::tuple<float, float, float, float>>> m_vecColor;
+
+	// Eye depth and index of the transparent draw items of a segment while applying the queue
+	std::vector<std::pair<double, size_t>> m_vecDepth;
+
+	// First draw item of the current segment and the current state while building
+	size_t m_nSegmentFirst;
+	unsigned m_puState[SLOT_COUNT];
+	unsigned m_uStateCnt;
+	bool m_bColorLast;
+
+	SStats m_xStats;
+};
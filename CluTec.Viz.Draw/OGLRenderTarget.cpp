@@ -262,7 +262,7 @@ bool COGLRenderTarget::Apply(COGLBaseElement::EApplyMode eMode, COGLBaseElement:
 		COGLRenderTarget* pRT = dynamic_cast<COGLRenderTarget*>(rData.pCurRenderTarget);
 		if (pRT != nullptr)
 		{
-			pRT->Finalize(rData.bInLastRenderPass);
+			pRT->Finalize(rData.bInLastRenderPass, rData.xMatrixStack);
 		}
 
 		rData.pCurRenderTarget = nullptr;
@@ -289,23 +289,23 @@ bool COGLRenderTarget::Apply(COGLBaseElement::EApplyMode eMode, COGLBaseElement:
 	CLU_OGL_CALL(glDisable(GL_SCISSOR_TEST));
 
 	// Store current projection matrix
-	CLU_OGL_CALL(glGetDoublev(GL_PROJECTION_MATRIX, m_pdProjMat));
+	rData.xMatrixStack.GetMatrix(Clu::CMatrixStack::Projection, m_pdProjMat);
 
 	CLU_OGL_CALL(glViewport(0, 0, m_uWidth, m_uHeight));
 
-	CLU_OGL_CALL(glMatrixMode(GL_PROJECTION));
+	rData.xMatrixStack.MatrixMode(Clu::CMatrixStack::Projection);
 	float fRatioX = float(m_piViewport[2]) / float(m_uWidth);
 	float fRatioY = float(m_piViewport[3]) / float(m_uHeight);
 	if (fRatioX > fRatioY)
 	{
-		CLU_OGL_CALL(glScalef(1.0f, fRatioY / fRatioX, 1.0f));
+		rData.xMatrixStack.Scale(1.0f, fRatioY / fRatioX, 1.0f);
 	}
 	else
 	{
-		CLU_OGL_CALL(glScalef(fRatioX / fRatioY, 1.0f, 1.0f));
+		rData.xMatrixStack.Scale(fRatioX / fRatioY, 1.0f, 1.0f);
 	}
 
-	CLU_OGL_CALL(glMatrixMode(GL_MODELVIEW));
+	rData.xMatrixStack.MatrixMode(Clu::CMatrixStack::ModelView);
 
 	if (rData.bInFirstRenderPass)
 	{
@@ -321,7 +321,7 @@ bool COGLRenderTarget::Apply(COGLBaseElement::EApplyMode eMode, COGLBaseElement:
 }
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-void COGLRenderTarget::Finalize(bool bInLastRenderPass)
+void COGLRenderTarget::Finalize(bool bInLastRenderPass, Clu::CMatrixStack& rStack)
 {
 	CLU_OGL_CALL(glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0));
 
@@ -358,9 +358,9 @@ void COGLRenderTarget::Finalize(bool bInLastRenderPass)
 
 	glViewport(m_piViewport[0], m_piViewport[1], m_piViewport[2], m_piViewport[3]);
 
-	glMatrixMode(GL_PROJECTION);
-	glLoadMatrixd(m_pdProjMat);
-	glMatrixMode(GL_MODELVIEW);
+	rStack.MatrixMode(Clu::CMatrixStack::Projection);
+	rStack.LoadMatrix(m_pdProjMat);
+	rStack.MatrixMode(Clu::CMatrixStack::ModelView);
 
 	if (m_bUseScissor)
 	{
@@ -211,8 +211,9 @@
 		/// </summary>
 		///
 		/// <param name="bLastRenderPass"> true to last render pass. </param>
+		/// <param name="rStack">          [in,out] The matrix stack used to restore the projection matrix. </param>
 		/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-		void Finalize(bool bLastRenderPass);
+		void Finalize(bool bLastRenderPass, Clu::CMatrixStack& rStack);
 
 	protected:
 
@@ -75,6 +75,8 @@ void COGLRotation::Reset()
 	m_fX = GLfloat( 1 );
 	m_fY = GLfloat( 0 );
 	m_fZ = GLfloat( 0 );
+
+	InvalidateParentBounds();
 }
 
 //////////////////////////////////////////////////////////////////////
@@ -86,6 +88,8 @@ void COGLRotation::Set( float fAngle, float fX, float fY, float fZ )
 	m_fX = GLfloat( fX );
 	m_fY = GLfloat( fY );
 	m_fZ = GLfloat( fZ );
+
+	InvalidateParentBounds();
 }
 
 //////////////////////////////////////////////////////////////////////
@@ -93,7 +97,19 @@ void COGLRotation::Set( float fAngle, float fX, float fY, float fZ )
 
 bool COGLRotation::Apply(COGLBaseElement::EApplyMode eMode, COGLBaseElement::SApplyData &rData)
 {
-	glRotatef( m_fAngle, m_fX, m_fY, m_fZ );
+	rData.xMatrixStack.Rotate( m_fAngle, m_fX, m_fY, m_fZ );
 
 	return true;
 }
+
+//////////////////////////////////////////////////////////////////////
+/// Bounds
+
+const COGLBaseElement::SBoundInfo& COGLRotation::GetBoundInfo()
+{
+	m_xBoundInfo.Reset(true, false);
+	m_xBoundInfo.bHasTransform = true;
+	COGLBoundingBox::Rotate(m_xBoundInfo.pdTransform, m_fAngle, m_fX, m_fY, m_fZ);
+
+	return m_xBoundInfo;
+}
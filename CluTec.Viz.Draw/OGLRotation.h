@@ -58,8 +58,13 @@ public:
 
 	bool Apply(COGLBaseElement::EApplyMode eMode, COGLBaseElement::SApplyData &rData);
 
+	// The transformation applies to the following elements
+	const SBoundInfo& GetBoundInfo();
+
 protected:
 	GLfloat m_fAngle, m_fX, m_fY, m_fZ;
+
+	SBoundInfo m_xBoundInfo;
 };
 
 #endif // !defined(AFX_OGLMATERIAL_H__2296DD19_C205_454A_82DB_D1881903B593__INCLUDED_)
@@ -73,6 +73,8 @@ void COGLScale::Reset()
 	m_fX = GLfloat( 1 );
 	m_fY = GLfloat( 1 );
 	m_fZ = GLfloat( 1 );
+
+	InvalidateParentBounds();
 }
 
 //////////////////////////////////////////////////////////////////////
@@ -83,6 +85,8 @@ void COGLScale::Set( float fX, float fY, float fZ )
 	m_fX = GLfloat( fX );
 	m_fY = GLfloat( fY );
 	m_fZ = GLfloat( fZ );
+
+	InvalidateParentBounds();
 }
 
 //////////////////////////////////////////////////////////////////////
@@ -91,7 +95,19 @@ void COGLScale::Set( float fX, float fY, float fZ )
 bool COGLScale::Apply(COGLBaseElement::EApplyMode eMode, 
 							COGLBaseElement::SApplyData &rData)
 {
-	glScalef( m_fX, m_fY, m_fZ );
+	rData.xMatrixStack.Scale( m_fX, m_fY, m_fZ );
 
 	return true;
 }
+
+//////////////////////////////////////////////////////////////////////
+/// Bounds
+
+const COGLBaseElement::SBoundInfo& COGLScale::GetBoundInfo()
+{
+	m_xBoundInfo.Reset(true, false);
+	m_xBoundInfo.bHasTransform = true;
+	COGLBoundingBox::Scale(m_xBoundInfo.pdTransform, m_fX, m_fY, m_fZ);
+
+	return m_xBoundInfo;
+}
@@ -134,6 +134,9 @@ COGLScene::COGLScene()
 	m_bAutoAdaptFrontFace = false;
 	m_bIsPickable         = false;
 	m_bDoPickDraw         = true;
+	m_pPickBVH            = nullptr;
+	m_pRenderQueue        = nullptr;
+	m_pFrameContextUser   = nullptr;
 	m_bDoNotify           = false;
 	m_bDoNotifyMouseOver  = false;
 	m_bDoNotifyMouseClick = false;
@@ -239,6 +242,9 @@ COGLScene::COGLScene()
 COGLScene::COGLScene(const COGLScene& rList)
 {
 	m_sTypeName = "Scene";
+	m_pPickBVH          = nullptr;
+	m_pRenderQueue      = nullptr;
+	m_pFrameContextUser = nullptr;
 
 	*this = rList;
 }
@@ -261,9 +267,10 @@ COGLScene& COGLScene::operator=(const COGLScene& rList)
 		m_mSinglePickSceneRef[i] = rList.m_mSinglePickSceneRef[i].Copy();
 	}
 
+	// The copy uses the same frame context scene, but is not registered as its user
+	DetachFrameContextScene();
 	m_refAutoFrame         = rList.m_refAutoFrame;
 	m_refFrameContextScene = rList.m_refFrameContextScene;
-	m_refFrameContextUser  = rList.m_refFrameContextUser;
 
 	m_mAllowDrag       = rList.m_mAllowDrag;
 	m_mScreenPlaneDrag = rList.m_mScreenPlaneDrag;
@@ -291,6 +298,8 @@ COGLScene& COGLScene::operator=(const COGLScene& rList)
 
 	m_bAutoAdaptFrontFace = rList.m_bAutoAdaptFrontFace;
 	m_bIsPickable         = rList.m_bIsPickable;
+	EnablePickBVH(rList.IsPickBVHEnabled());
+	EnableBufferScene(rList.IsBufferSceneEnabled());
 	m_bDoNotify           = rList.m_bDoNotify;
 	m_bDoNotifyMouseOver  = rList.m_bDoNotifyMouseOver;
 	m_bDoNotifyMouseClick = rList.m_bDoNotifyMouseClick;
@@ -369,10 +378,153 @@ COGLScene& COGLScene::operator=(const COGLScene& rList)
 
 COGLScene::~COGLScene()
 {
+	// The frame context scene is referenced until the end of the destructor
+	DetachFrameContextScene();
+
 	if (m_uDispListID)
 	{
 		glDeleteLists(m_uDispListID, 1);
 	}
+
+	delete m_pPickBVH;
+	delete m_pRenderQueue;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Set Scene whose frame context is used for auto rotation and translation
+
+void COGLScene::SetFrameContextScene(COGLBEReference& rFrameContext)
+{
+	DetachFrameContextScene();
+
+	if (rFrameContext.IsValid())
+	{
+		COGLScene* pScene = dynamic_cast<COGLScene*>((COGLBaseElement*) rFrameContext);
+		if (pScene)
+		{
+			m_refFrameContextScene      = rFrameContext;
+			pScene->m_pFrameContextUser = this;
+		}
+	}
+	else
+	{
+		m_refFrameContextScene = rFrameContext;
+	}
+}
+
+//////////////////////////////////////////////////////////////////////
+// Remove this scene as user of its frame context scene
+
+void COGLScene::DetachFrameContextScene()
+{
+	if (!m_refFrameContextScene.IsValid())
+	{
+		return;
+	}
+
+	COGLScene* pScene = dynamic_cast<COGLScene*>((COGLBaseElement*) m_refFrameContextScene);
+	if (pScene && (pScene->m_pFrameContextUser == this))
+	{
+		pScene->m_pFrameContextUser = nullptr;
+	}
+}
+
+//////////////////////////////////////////////////////////////////////
+// Enable pick hierarchy
+
+void COGLScene::EnablePickBVH(bool bVal)
+{
+	if (bVal && !m_pPickBVH)
+	{
+		m_pPickBVH = new COGLPickBVH();
+	}
+	else if (!bVal && m_pPickBVH)
+	{
+		delete m_pPickBVH;
+		m_pPickBVH = nullptr;
+	}
+
+	InvalidateBounds();
+}
+
+//////////////////////////////////////////////////////////////////////
+// Bounds of scene
+
+const COGLBaseElement::SBoundInfo& COGLScene::GetBoundInfo()
+{
+	if (m_bBoundInfoValid && (m_iBoundRepeatCnt == m_iRepeatCount) && (m_bBoundRestoreFrame == m_bLocalFrame))
+	{
+		return m_xBoundInfo;
+	}
+
+	if (HasDynamicFrame())
+	{
+		// Also cached, so that the parents are told when the scene changes
+		m_xBoundInfo.Reset(false, true);
+		m_bBoundInfoValid    = true;
+		m_iBoundRepeatCnt    = m_iRepeatCount;
+		m_bBoundRestoreFrame = m_bLocalFrame;
+		return m_xBoundInfo;
+	}
+
+	// Without a local frame the transformations of the elements also apply to the elements following the scene
+	EvalBoundInfo(m_iRepeatCount, m_bLocalFrame);
+
+	// The local time is advanced when the scene is applied
+	if (m_bUseLocalTime)
+	{
+		m_xBoundInfo.bHasState = true;
+	}
+
+	return m_xBoundInfo;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Invalidate bounds and render queue
+
+void COGLScene::InvalidateBounds()
+{
+	// The queue references the elements of sub-scenes, so it is also invalidated if the bounds are not cached
+	if (m_pRenderQueue)
+	{
+		m_pRenderQueue->Invalidate();
+	}
+
+	COGLBaseElementList::InvalidateBounds();
+}
+
+//////////////////////////////////////////////////////////////////////
+// Frame of elements depends on view, picking or dragging
+
+bool COGLScene::HasDynamicFrame() const
+{
+	return m_bLocalView || m_bLocalProj || m_bResetFrame || m_bIsPickable || m_pPickBVH || m_bAutoAdjustFrame ||
+	       m_bAutoTranslate || m_bAutoRotate1 || m_bAutoRotate2 || m_bAutoScale || m_bAutoPixelZoom;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Scene can be drawn as part of a render queue of a parent scene
+
+bool COGLScene::CanFlatten(bool bAutoAdaptFrontFace) const
+{
+	return !HasDynamicFrame() && m_bLocalFrame && m_bDrawScene && m_bDrawOpaque && m_bDrawTransparent && !m_bNormalize && !m_bAdaptiveRedraw &&
+	       !m_bUseLocalTime && (m_iRepeatCount == 1) && (m_bAutoAdaptFrontFace == bAutoAdaptFrontFace);
+}
+
+//////////////////////////////////////////////////////////////////////
+// Enable render queue
+
+void COGLScene::EnableBufferScene(bool bVal)
+{
+	if (bVal && !m_pRenderQueue)
+	{
+		m_pRenderQueue = new COGLRenderQueue();
+	}
+	else if (!bVal && m_pRenderQueue)
+	{
+		delete m_pRenderQueue;
+		m_pRenderQueue = nullptr;
+	}
 }
 
 //////////////////////////////////////////////////////////////////////
@@ -1656,6 +1808,7 @@ void COGLScene::EnableAdaptiveRedraw(bool bVal)
 {
 	m_bAdaptiveRedraw = bVal;
 	m_bHasSceneImage  = false;
+	InvalidateBounds();
 
 	// Set all child BaseElementLists accordingly
 	EnableContentChangedInfo(bVal);
@@ -1681,58 +1834,58 @@ void COGLScene::TellParentContentChanged()
 }
 
 //////////////////////////////////////////////////////////////////////
-// Either read current projection matrix from OpenGL or copy
+// Either get current projection matrix from the matrix stack or copy
 // previously read matrix.
 
-void COGLScene::GetProjMat()
+void COGLScene::GetProjMat(Clu::CMatrixStack& rStack)
 {
 	if (m_bProjMatCurrent)
 	{
 		return;
 	}
 
-	glGetDoublev(GL_PROJECTION_MATRIX, m_pdCurProjMat);
+	rStack.GetMatrix(Clu::CMatrixStack::Projection, m_pdCurProjMat);
 	m_bProjMatCurrent = true;
 }
 
 //////////////////////////////////////////////////////////////////////
-// Either read current projection matrix from OpenGL or copy
+// Either get current projection matrix from the matrix stack or copy
 // previously read matrix.
 
-void COGLScene::GetProjMat(GLdouble* pMat)
+void COGLScene::GetProjMat(Clu::CMatrixStack& rStack, GLdouble* pMat)
 {
 	if (!m_bProjMatCurrent)
 	{
-		GetProjMat();
+		GetProjMat(rStack);
 	}
 
 	memcpy(pMat, m_pdCurProjMat, 16 * sizeof(GLdouble));
 }
 
 //////////////////////////////////////////////////////////////////////
-// Either read current model view matrix from OpenGL or copy
+// Either get current model view matrix from the matrix stack or copy
 // previously read matrix.
 
-void COGLScene::GetFrameMat()
+void COGLScene::GetFrameMat(Clu::CMatrixStack& rStack)
 {
 	if (m_bFrameMatCurrent)
 	{
 		return;
 	}
 
-	glGetDoublev(GL_MODELVIEW_MATRIX, m_pdCurFrameMat);
+	rStack.GetMatrix(Clu::CMatrixStack::ModelView, m_pdCurFrameMat);
 	m_bFrameMatCurrent = true;
 }
 
 //////////////////////////////////////////////////////////////////////
-// Either read current model view matrix from OpenGL or copy
+// Either get current model view matrix from the matrix stack or copy
 // previously read matrix.
 
-void COGLScene::GetFrameMat(GLdouble* pMat)
+void COGLScene::GetFrameMat(Clu::CMatrixStack& rStack, GLdouble* pMat)
 {
 	if (!m_bFrameMatCurrent)
 	{
-		GetFrameMat();
+		GetFrameMat(rStack);
 	}
 
 	memcpy(pMat, m_pdCurFrameMat, 16 * sizeof(GLdouble));
@@ -1912,6 +2065,10 @@ void COGLScene::EvalPickClipPlanes(GLdouble pdClipPlanes[4][4],        int iX, i
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 bool COGLScene::Apply(COGLBaseElement::EApplyMode eMode, COGLBaseElement::SApplyData& rData)
 {
+	// The pick hierarchy that is updated outside of this scene
+	COGLPickBVH* pPrevPickBVH = rData.pPickBVH;
+	uint uPrevPickBVHNameBase = rData.uPickBVHNameBase;
+
 	try
 	{
 		// If is not to be drawn, return immediately
@@ -2073,8 +2230,8 @@ bool COGLScene::Apply(COGLBaseElement::EApplyMode eMode, COGLBaseElement::SApply
 
 			if (m_Viewport.bLocalOrigin)
 			{
-				GetFrameMat(m_pdFrameMat);
-				GetProjMat(m_pdProjMat);
+				GetFrameMat(rData.xMatrixStack, m_pdFrameMat);
+				GetProjMat(rData.xMatrixStack, m_pdProjMat);
 
 				gluProject(double(m_Viewport.fLeft), double(m_Viewport.fBottom), double(m_Viewport.fDepth),
 						m_pdFrameMat, m_pdProjMat, piCurViewport, &dWLeft, &dWBottom, &dWDepth);
@@ -2291,16 +2448,16 @@ bool COGLScene::Apply(COGLBaseElement::EApplyMode eMode, COGLBaseElement::SApply
 					else
 					{
 						rData.xMatrixStack.Push(Clu::CMatrixStack::Projection);
-						gluOrtho2D(0.0, float(iWidth), 0.0, float(iHeight));
+						rData.xMatrixStack.Ortho(0.0, float(iWidth), 0.0, float(iHeight), -1.0, 1.0);
 
 						rData.xMatrixStack.Push(Clu::CMatrixStack::ModelView);
-						glLoadIdentity();
+						rData.xMatrixStack.LoadIdentity();
 						glRasterPos3f(0.0, 0.0, 0.0);
 
 						rData.xMatrixStack.Pop(Clu::CMatrixStack::ModelView);
 						rData.xMatrixStack.Pop(Clu::CMatrixStack::Projection);
 
-						glMatrixMode(GL_MODELVIEW);
+						rData.xMatrixStack.MatrixMode(Clu::CMatrixStack::ModelView);
 					}
 
 					glPixelStorei(GL_UNPACK_ROW_LENGTH, iWidth);
@@ -2347,14 +2504,14 @@ bool COGLScene::Apply(COGLBaseElement::EApplyMode eMode, COGLBaseElement::SApply
 			// new viewport.
 			if (!m_bLocalProj)
 			{
-				GetProjMat(m_pdProjMat);
-				GetFrameMat(m_pdFrameMat);
+				GetProjMat(rData.xMatrixStack, m_pdProjMat);
+				GetFrameMat(rData.xMatrixStack, m_pdFrameMat);
 
-				glMatrixMode(GL_PROJECTION);
+				rData.xMatrixStack.MatrixMode(Clu::CMatrixStack::Projection);
 				ClearProjMatCurrent();
-				glScalef(float(piCurViewport[2]) / float(piViewport[2]), float(piCurViewport[3]) / float(piViewport[3]), 1.0f);
-				GetProjMat();
-				glMatrixMode(GL_MODELVIEW);
+				rData.xMatrixStack.Scale(float(piCurViewport[2]) / float(piViewport[2]), float(piCurViewport[3]) / float(piViewport[3]), 1.0f);
+				GetProjMat(rData.xMatrixStack);
+				rData.xMatrixStack.MatrixMode(Clu::CMatrixStack::ModelView);
 
 				// If we are in picking mode and there is no local
 				// projection defined, then need to adapt pick clip planes.
@@ -2379,11 +2536,11 @@ bool COGLScene::Apply(COGLBaseElement::EApplyMode eMode, COGLBaseElement::SApply
 		if (m_bLocalProj)
 		{
 			GetViewport(piViewport);
-			GetFrameMat(m_pdFrameMat);
-			GetProjMat(m_pdProjMat);
+			GetFrameMat(rData.xMatrixStack, m_pdFrameMat);
+			GetProjMat(rData.xMatrixStack, m_pdProjMat);
 
-			glMatrixMode(GL_PROJECTION);
-			glLoadIdentity();
+			rData.xMatrixStack.MatrixMode(Clu::CMatrixStack::Projection);
+			rData.xMatrixStack.LoadIdentity();
 			ClearProjMatCurrent();
 
 			if (m_eProjType == /*EProjType::*/ ORTHO)
@@ -2423,7 +2580,7 @@ bool COGLScene::Apply(COGLBaseElement::EApplyMode eMode, COGLBaseElement::SApply
 					}
 				}
 
-				glOrtho(GLdouble(fLeft), GLdouble(fRight),
+				rData.xMatrixStack.Ortho(GLdouble(fLeft), GLdouble(fRight),
 						GLdouble(fBottom), GLdouble(fTop),
 						GLdouble(m_OrthoProj.fNear), GLdouble(m_OrthoProj.fFar));
 			}
@@ -2448,14 +2605,14 @@ bool COGLScene::Apply(COGLBaseElement::EApplyMode eMode, COGLBaseElement::SApply
 						fHWidth  = fHHeight * fAspect;
 					}
 
-					glFrustum(GLdouble(-fHWidth), GLdouble(fHWidth),
+					rData.xMatrixStack.Frustum(GLdouble(-fHWidth), GLdouble(fHWidth),
 							GLdouble(-fHHeight), GLdouble(fHHeight),
 							GLdouble(m_Perspective.fNear),
 							GLdouble(m_Perspective.fFar));
 				}
 				else
 				{
-					glFrustum(
+					rData.xMatrixStack.Frustum(
 							GLdouble(m_Perspective.fLeft),
 							GLdouble(m_Perspective.fRight),
 							GLdouble(m_Perspective.fBottom),
@@ -2466,8 +2623,8 @@ bool COGLScene::Apply(COGLBaseElement::EApplyMode eMode, COGLBaseElement::SApply
 
 				if (rData.bUseColorStereo)
 				{
-					glTranslatef(rData.fColorStereoSep, 0, 0);
-					glRotatef(rData.fColorStereoDegAngle, 0, 1, 0);
+					rData.xMatrixStack.Translate(rData.fColorStereoSep, 0, 0);
+					rData.xMatrixStack.Rotate(rData.fColorStereoDegAngle, 0, 1, 0);
 				}
 			}
 			else if (m_eProjType ==	/*EProjType::*/ PIXEL)
@@ -2477,18 +2634,18 @@ bool COGLScene::Apply(COGLBaseElement::EApplyMode eMode, COGLBaseElement::SApply
 				int iRight  = piViewport[2] - iLeft - 1;
 				int iTop    = piViewport[3] - iBottom - 1;
 
-				glOrtho(-GLdouble(iLeft), GLdouble(iRight),
+				rData.xMatrixStack.Ortho(-GLdouble(iLeft), GLdouble(iRight),
 						-GLdouble(iBottom), GLdouble(iTop),
 						-1.01, 1.01);
 			}
 
-			glMatrixMode(GL_MODELVIEW);
+			rData.xMatrixStack.MatrixMode(Clu::CMatrixStack::ModelView);
 
 			// Update pick clip planes if in picking mode
 			if (eMode == COGLBaseElement::/*EApplyMode::*/ PICK)
 			{
 				// Get current projection matrix
-				GetProjMat();
+				GetProjMat(rData.xMatrixStack);
 
 				// Signal that pick clip planes need to be restored
 				bRestorePickClipPlanes = true;
@@ -2516,29 +2673,62 @@ bool COGLScene::Apply(COGLBaseElement::EApplyMode eMode, COGLBaseElement::SApply
 
 		if (m_bResetFrame)
 		{
-			glLoadIdentity();
+			rData.xMatrixStack.LoadIdentity();
 			ClearFrameMatCurrent();
 
 			if (m_eProjType == /*EProjType::*/ CENTRAL)
 			{
-				glTranslatef(0.0f, 0.0f, -5.0f);
+				rData.xMatrixStack.Translate(0.0f, 0.0f, -5.0f);
 			}
 
 			glPixelZoom(1.0f, 1.0f);
 		}
 
-		if (eMode == COGLBaseElement::PICK)
+		// Update the pick hierarchy of this scene in the first render pass. The elements of this scene are then only added to
+		// this pick hierarchy and not to one of a parent scene. Sub-scenes with a local view or projection use a different
+		// projection and are therefore excluded from the pick hierarchy of a parent scene, as are scenes with their own
+		// pick hierarchy when it is not updated.
+		bool bUpdatePickBVH = (m_pPickBVH && (eMode == COGLBaseElement::DRAW) && rData.bInFirstRenderPass && (rData.iRepeatIdx == 0));
+
+		if (bUpdatePickBVH)
+		{
+			float pfFrameMat[16];
+			rData.xMatrixStack.GetMatrix(Clu::CMatrixStack::ModelView, pfFrameMat);
+
+			m_pPickBVH->BeginUpdate(pfFrameMat);
+
+			// The name stacks stored start with the name of this scene
+			if (rData.vecPickNameStack.size() < rData.cuMaxPickNameStackLen)
+			{
+				rData.vecPickNameStack.resize(rData.cuMaxPickNameStackLen);
+			}
+
+			rData.pPickBVH         = m_pPickBVH;
+			rData.uPickBVHNameBase = rData.uNextPickNameStackIdx;
+		}
+		else if (m_bLocalView || m_bLocalProj || m_pPickBVH)
+		{
+			rData.pPickBVH = nullptr;
+		}
+
+		// In drawing mode pick names are only needed to update a pick hierarchy
+		bool bPushPickName = (eMode == COGLBaseElement::PICK) || (rData.pPickBVH != nullptr);
+
+		if (bPushPickName)
 		{
 			rData.PushPickName(GetUID());
+		}
 
+		if (eMode == COGLBaseElement::PICK)
+		{
 			// Make sure this scene gets an entry in the select buffer independent of whether the mouse pointer is above something that is drawn
 			if (m_bLocalView && m_bPickableView)
 			{
 				double pdProj[16], pdFrame[16];
 				int piView[4];
 
-				GetProjMat(pdProj);
-				GetFrameMat(pdFrame);
+				GetProjMat(rData.xMatrixStack, pdProj);
+				GetFrameMat(rData.xMatrixStack, pdFrame);
 				GetViewport(piView);
 
 				double dX1, dY1, dZ1;
@@ -2572,8 +2762,8 @@ bool COGLScene::Apply(COGLBaseElement::EApplyMode eMode, COGLBaseElement::SApply
 
 		if (bStoreFrame)
 		{
-			GetProjMat(m_pdMouseProjMat);
-			GetFrameMat(m_pdMouseFrameMat);
+			GetProjMat(rData.xMatrixStack, m_pdMouseProjMat);
+			GetFrameMat(rData.xMatrixStack, m_pdMouseFrameMat);
 			GetViewport(m_piMouseViewport);
 		}
 
@@ -2586,7 +2776,7 @@ bool COGLScene::Apply(COGLBaseElement::EApplyMode eMode, COGLBaseElement::SApply
 
 				if (m_bAutoScale)
 				{
-					glScalef(m_AutoScale[0], m_AutoScale[1], m_AutoScale[2]);
+					rData.xMatrixStack.Scale(m_AutoScale[0], m_AutoScale[1], m_AutoScale[2]);
 				}
 
 				if (m_bAutoPixelZoom)
@@ -2603,7 +2793,7 @@ bool COGLScene::Apply(COGLBaseElement::EApplyMode eMode, COGLBaseElement::SApply
 				if (abs(dAngle) > 1e-4)
 				{
 					m_vAxis = (m_mRMain[m_iDragIdxRotate1](2)) & m_E3Base.vI;
-					glRotatef(float(dAngle), m_vAxis[1], m_vAxis[2], m_vAxis[3]);
+					rData.xMatrixStack.Rotate(float(dAngle), m_vAxis[1], m_vAxis[2], m_vAxis[3]);
 				}
 			}
 
@@ -2616,16 +2806,16 @@ bool COGLScene::Apply(COGLBaseElement::EApplyMode eMode, COGLBaseElement::SApply
 
 				if (IsScreenPlaneDragEnabled(m_iDragIdxTranslate))
 				{
-					glTranslatef(fX, fY, fZ);
+					rData.xMatrixStack.Translate(fX, fY, fZ);
 				}
 				else if (IsProjDirDragEnabled(m_iDragIdxTranslate))
 				{
-					glTranslatef(fX, fY, fZ);
+					rData.xMatrixStack.Translate(fX, fY, fZ);
 				}
 				else
 				{
 					COGLVertex vexTrans = m_mDragBasis[m_iDragIdxTranslate].LinComb(fX, fY, fZ);
-					glTranslatef(vexTrans[0], vexTrans[1], vexTrans[2]);
+					rData.xMatrixStack.Translate(vexTrans[0], vexTrans[1], vexTrans[2]);
 				}
 			}
 
@@ -2636,7 +2826,7 @@ bool COGLScene::Apply(COGLBaseElement::EApplyMode eMode, COGLBaseElement::SApply
 				float fAngle = float(2.0 * acos(Scalar(m_mRMain[m_iDragIdxRotate2]))) / m_fRadPerDeg;
 
 				m_vAxis = (m_mRMain[m_iDragIdxRotate2](2)) & m_E3Base.vI;
-				glRotatef(fAngle, m_vAxis[1], m_vAxis[2], m_vAxis[3]);
+				rData.xMatrixStack.Rotate(fAngle, m_vAxis[1], m_vAxis[2], m_vAxis[3]);
 			}
 
 			if ((m_bAutoScale || m_bAutoPixelZoom) && (m_bAutoScaleAboutLocalOrigin || m_bAutoScaleAboutMouseOrigin))
@@ -2645,12 +2835,12 @@ bool COGLScene::Apply(COGLBaseElement::EApplyMode eMode, COGLBaseElement::SApply
 
 				if (m_bAutoScaleAboutMouseOrigin)
 				{
-					glTranslatef(m_AutoScaleOffset[0], m_AutoScaleOffset[1], m_AutoScaleOffset[2]);
+					rData.xMatrixStack.Translate(m_AutoScaleOffset[0], m_AutoScaleOffset[1], m_AutoScaleOffset[2]);
 				}
 
 				if (m_bAutoScale)
 				{
-					glScalef(m_AutoScale[0], m_AutoScale[1], m_AutoScale[2]);
+					rData.xMatrixStack.Scale(m_AutoScale[0], m_AutoScale[1], m_AutoScale[2]);
 				}
 
 				if (m_bAutoPixelZoom)
@@ -2663,7 +2853,7 @@ bool COGLScene::Apply(COGLBaseElement::EApplyMode eMode, COGLBaseElement::SApply
 		// Store Modelview Frame after auto transformation
 		if (bStoreFrame)
 		{
-			GetFrameMat(m_pdATMouseFrameMat);
+			GetFrameMat(rData.xMatrixStack, m_pdATMouseFrameMat);
 		}
 
 		if (m_bIsPickable)
@@ -2921,6 +3111,8 @@ bool COGLScene::Apply(COGLBaseElement::EApplyMode eMode, COGLBaseElement::SApply
 		{
 			if (!pSinglePickScene->ApplyElementList(eMode, rData))
 			{
+				rData.pPickBVH         = pPrevPickBVH;
+				rData.uPickBVHNameBase = uPrevPickBVHNameBase;
 				return false;
 			}
 		}
@@ -2929,6 +3121,8 @@ bool COGLScene::Apply(COGLBaseElement::EApplyMode eMode, COGLBaseElement::SApply
 		{
 			if (!pPickScene->ApplyElementList(eMode, rData))
 			{
+				rData.pPickBVH         = pPrevPickBVH;
+				rData.uPickBVHNameBase = uPrevPickBVHNameBase;
 				return false;
 			}
 		}
@@ -2937,6 +3131,8 @@ bool COGLScene::Apply(COGLBaseElement::EApplyMode eMode, COGLBaseElement::SApply
 		{
 			if (!ApplyElementList(eMode, rData))
 			{
+				rData.pPickBVH         = pPrevPickBVH;
+				rData.uPickBVHNameBase = uPrevPickBVHNameBase;
 				return false;
 			}
 		}
@@ -2966,11 +3162,19 @@ bool COGLScene::Apply(COGLBaseElement::EApplyMode eMode, COGLBaseElement::SApply
 			glDisable(GL_NORMALIZE);
 		}
 
-		if (eMode == COGLBaseElement::PICK)
+		if (bPushPickName)
 		{
 			rData.PopPickName();
 		}
 
+		if (bUpdatePickBVH)
+		{
+			m_pPickBVH->EndUpdate();
+		}
+
+		rData.pPickBVH         = pPrevPickBVH;
+		rData.uPickBVHNameBase = uPrevPickBVHNameBase;
+
 		if (m_bLocalFrame)
 		{
 			rData.xMatrixStack.Pop(Clu::CMatrixStack::Texture);
@@ -2981,9 +3185,9 @@ bool COGLScene::Apply(COGLBaseElement::EApplyMode eMode, COGLBaseElement::SApply
 
 		if (m_bLocalProj)
 		{
-			glMatrixMode(GL_PROJECTION);
-			glLoadMatrixd(m_pdProjMat);
-			glMatrixMode(GL_MODELVIEW);
+			rData.xMatrixStack.MatrixMode(Clu::CMatrixStack::Projection);
+			rData.xMatrixStack.LoadMatrix(m_pdProjMat);
+			rData.xMatrixStack.MatrixMode(Clu::CMatrixStack::ModelView);
 		}
 
 		if (m_bLocalView)
@@ -3036,9 +3240,9 @@ bool COGLScene::Apply(COGLBaseElement::EApplyMode eMode, COGLBaseElement::SApply
 			// restore the previous one.
 			if (!m_bLocalProj)
 			{
-				glMatrixMode(GL_PROJECTION);
-				glLoadMatrixd(m_pdProjMat);
-				glMatrixMode(GL_MODELVIEW);
+				rData.xMatrixStack.MatrixMode(Clu::CMatrixStack::Projection);
+				rData.xMatrixStack.LoadMatrix(m_pdProjMat);
+				rData.xMatrixStack.MatrixMode(Clu::CMatrixStack::ModelView);
 			}
 		}
 
@@ -3057,6 +3261,8 @@ bool COGLScene::Apply(COGLBaseElement::EApplyMode eMode, COGLBaseElement::SApply
 	}
 	catch (Clu::CIException& ex)
 	{
+		rData.pPickBVH         = pPrevPickBVH;
+		rData.uPickBVHNameBase = uPrevPickBVHNameBase;
 		throw CLU_EXCEPTION_NEST("Error applying scene", std::move(ex));
 	}
 }
@@ -3104,11 +3310,20 @@ bool COGLScene::ApplyElementList(COGLBaseElement::EApplyMode eMode, COGLBaseElem
 			}
 		}
 
+		// The render queue is only used for drawing. A pick hierarchy and a display list that are recorded need the
+		// elements in script order.
+		bool bUseQueue = (m_pRenderQueue && (eMode == COGLBaseElement::DRAW) && !rData.pPickBVH && !rData.bDispListRecord);
+
+		if (bUseQueue && !m_pRenderQueue->IsValid())
+		{
+			m_pRenderQueue->Build(*this);
+		}
+
 		int iCurRepeatIdx = rData.iRepeatIdx;
 		for (int iRepeat = 0; iRepeat < m_iRepeatCount; iRepeat++)
 		{
 			// Apply list. Returns false if one element in list couldn't not be applied
-			if (!COGLBaseElementList::ApplyList(m_listElement, eMode, rData))
+			if (bUseQueue ? !m_pRenderQueue->Apply(eMode, rData) : !COGLBaseElementList::ApplyList(m_listElement, eMode, rData))
 			{
 				return false;
 			}
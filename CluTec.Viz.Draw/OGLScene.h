@@ -41,6 +41,8 @@
 #include "OGLBEReference.h"
 #include "OGLVertex.h"
 #include "OGLImage.h"
+#include "OGLPickBVH.h"
+#include "OGLRenderQueue.h"
 
 #include "time.h"
 #include "sys/timeb.h"
@@ -348,20 +350,23 @@
 
 		// Enable/Disable Drawing in opaque pass
 		void EnableOpaqueDraw(bool bVal = true)
-		{ m_bDrawOpaque = bVal; }
+		{ m_bDrawOpaque = bVal; InvalidateBounds(); }
 
 		// Enable/Disable Drawing in transparency pass
 		void EnableTransparentDraw(bool bVal = true)
-		{ m_bDrawTransparent = bVal; }
+		{ m_bDrawTransparent = bVal; InvalidateBounds(); }
 
 		// Enable/Disable automatic adaptation of vertex list front face
 		// according to whether current frame is reflected (determinant < 0)
 		void EnableAutoAdaptFrontFace(bool bVal = true)
-		{ m_bAutoAdaptFrontFace = bVal; }
+		{ m_bAutoAdaptFrontFace = bVal; InvalidateBounds(); }
+
+		bool IsAutoAdaptFrontFaceEnabled() const
+		{ return m_bAutoAdaptFrontFace; }
 
 		// Make scene pickable
 		void EnablePick(bool bVal = true)
-		{ m_bIsPickable = bVal; }
+		{ m_bIsPickable = bVal; InvalidateBounds(); }
 
 		// Draw scene in pick mode
 		void EnablePickDraw(bool bVal = true)
@@ -369,6 +374,45 @@
 			m_bDoPickDraw = bVal;
 		}
 
+		/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// <summary>
+		/// 	Enables a bounding volume hierarchy over the vertex lists of this scene, which allows picking on the CPU without
+		/// 	a pick render pass. The hierarchy is updated in the first render pass while drawing. Coordinates are relative to
+		/// 	the frame in which the scene is applied, i.e. before its own drag transformations. Sub-scenes with a local view
+		/// 	and vertex lists whose data is not kept on the host are not included.
+		/// </summary>
+		/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		void EnablePickBVH(bool bVal = true);
+
+		bool IsPickBVHEnabled() const
+		{ return m_pPickBVH != nullptr; }
+
+		// Returns null if the pick hierarchy is not enabled
+		COGLPickBVH* GetPickBVH()
+		{ return m_pPickBVH; }
+
+		/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// <summary>
+		/// 	Bounds of the scene in the frame it is applied in. Scenes with a local view or projection, a reset frame, pick or
+		/// 	mouse dependent transformations are not bounded as a whole, but their elements are still culled when the scene is
+		/// 	applied.
+		/// </summary>
+		/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		virtual const SBoundInfo& GetBoundInfo();
+
+		// Also invalidates the render queue of the scene
+		virtual void InvalidateBounds();
+
+		/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// <summary>
+		/// 	True if applying the scene has the same effect as applying its elements in a local frame. The elements of such a
+		/// 	scene can be drawn by the render queue of a parent scene. The elements themselves are not tested.
+		/// </summary>
+		///
+		/// <param name="bAutoAdaptFrontFace"> The auto adapt front face flag of the parent scene. </param>
+		/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		bool CanFlatten(bool bAutoAdaptFrontFace) const;
+
 		// Notify Script on actions
 		void EnableNotify(bool bVal = true)
 		{
@@ -407,19 +451,19 @@
 
 		// Use local transformation
 		void EnableLocalFrame(bool bVal = true)
-		{ m_bLocalFrame = bVal; }
+		{ m_bLocalFrame = bVal; InvalidateBounds(); }
 
 		void EnableLocalProj(bool bVal = true)
-		{ m_bLocalProj = bVal; }
+		{ m_bLocalProj = bVal; InvalidateBounds(); }
 
 		void EnableLocalView(bool bVal = true)
-		{ m_bLocalView = bVal; }
+		{ m_bLocalView = bVal; InvalidateBounds(); }
 
 		void EnableViewScissor(bool bVal = true)
 		{ m_bUseViewScissor = bVal; }
 
 		void EnableResetFrame(bool bVal = true)
-		{ m_bResetFrame = bVal; }
+		{ m_bResetFrame = bVal; InvalidateBounds(); }
 
 		void EnablePickableView(bool bVal = true)
 		{ m_bPickableView = bVal; }
@@ -432,23 +476,23 @@
 
 		// Enable/Disable auto translation
 		void EnableAutoTranslate(bool bVal = true)
-		{ m_bAutoTranslate = bVal; }
+		{ m_bAutoTranslate = bVal; InvalidateBounds(); }
 
 		// Enable/Disable auto rotation
 		void EnableAutoRotate1(bool bVal = true)
-		{ m_bAutoRotate1 = bVal; }
+		{ m_bAutoRotate1 = bVal; InvalidateBounds(); }
 
 		// Enable/Disable auto rotation
 		void EnableAutoRotate2(bool bVal = true)
-		{ m_bAutoRotate2 = bVal; }
+		{ m_bAutoRotate2 = bVal; InvalidateBounds(); }
 
 		// Enable/Disable auto scale
 		void EnableAutoScale(bool bVal = true)
-		{ m_bAutoScale = bVal; EnableNormalize(bVal); if (bVal) { EvalAutoScale(); } }
+		{ m_bAutoScale = bVal; EnableNormalize(bVal); if (bVal) { EvalAutoScale(); } InvalidateBounds(); }
 
 		// Enable/Disable auto pixel zoom
 		void EnableAutoPixelZoom(bool bVal = true)
-		{ m_bAutoPixelZoom = bVal; if (bVal) { EvalAutoScale(); } }
+		{ m_bAutoPixelZoom = bVal; if (bVal) { EvalAutoScale(); } InvalidateBounds(); }
 
 		// Enable/Disable auto scale about local origin, i.e. after local translate
 		void EnableAutoScaleAboutLocalOrigin(bool bVal = true)
@@ -460,18 +504,29 @@
 
 		// Enable/Disable auto adjusting of frame
 		void EnableAutoAdjustFrame(bool bVal = true)
-		{ m_bAutoAdjustFrame = bVal; }
+		{ m_bAutoAdjustFrame = bVal; InvalidateBounds(); }
+
+		/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// <summary>
+		/// 	Enables buffering the scene in a render queue, which draws the vertex lists of the scene and of its sub-scenes
+		/// 	sorted by their state elements. The queue is built again when the elements of the scene change.
+		/// </summary>
+		/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		void EnableBufferScene(bool bVal = true);
+
+		bool IsBufferSceneEnabled() const
+		{ return m_pRenderQueue != nullptr; }
 
-		// Enable/Disable buffer scene
-		void EnableBufferScene(bool bVal = true)
-		{ m_bBufferScene = bVal; }
+		// Returns null if buffering the scene is not enabled
+		COGLRenderQueue* GetRenderQueue()
+		{ return m_pRenderQueue; }
 
 		// Enable/Disable draw scene
 		void EnableDrawScene(bool bVal = true)
-		{ m_bDrawScene = bVal; }
+		{ m_bDrawScene = bVal; InvalidateBounds(); }
 
 		void EnableNormalize(bool bVal = true)
-		{ m_bNormalize = bVal; }
+		{ m_bNormalize = bVal; InvalidateBounds(); }
 
 		// Is Scene to be drawn?
 		bool DoDrawScene()
@@ -734,7 +789,7 @@
 
 		// Enable/Disable the use of local time
 		void EnableLocalTime(bool bVal = true)
-		{ m_bUseLocalTime = bVal; }
+		{ m_bUseLocalTime = bVal; InvalidateBounds(); }
 
 		// Set the local time
 		void SetLocalTime(double dVal)
@@ -752,7 +807,7 @@
 
 		// Set Repeat Count
 		void SetRepeatCount(int iCount)
-		{ m_iRepeatCount = (iCount < 0 ? 0 : iCount); }
+		{ m_iRepeatCount = (iCount < 0 ? 0 : iCount); InvalidateBounds(); }
 
 		// Get Repeat Count
 		int GetRepeatCount()
@@ -763,22 +818,7 @@
 		{ m_refAutoFrame = rFrameRef; }
 
 		// Set Scene whose frame context is used for auto rotation and translation
-		void SetFrameContextScene(COGLBEReference& rFrameContext)
-		{
-			if (rFrameContext.IsValid())
-			{
-				COGLScene* pScene = dynamic_cast<COGLScene*>((COGLBaseElement*) rFrameContext);
-				if (pScene)
-				{
-					m_refFrameContextScene        = rFrameContext;
-					pScene->m_refFrameContextUser = rFrameContext.GetRepositoryPtr()->New(this);
-				}
-			}
-			else
-			{
-				m_refFrameContextScene = rFrameContext;
-			}
-		}
+		void SetFrameContextScene(COGLBEReference& rFrameContext);
 
 		// Set Drag Start Mouse World Coordinates
 		void SetMouseDragStartWorld(double dX, double dY, double dZ)
@@ -824,6 +864,9 @@
 		void UpdateAutoAdjustFrame();
 		void EvalAutoScale();
 
+		// True if the frame of the elements depends on the view, picking or dragging
+		bool HasDynamicFrame() const;
+
 		int GetPickSceneIdx(bool bShift, bool bCtrl, bool bAlt, bool bDrag)
 		{
 			return (bShift ? 1 : 0) | (bCtrl ? 2 : 0) | (bAlt ? 4 : 0) | (bDrag ? 8 : 0);
@@ -831,16 +874,19 @@
 
 		void TellParentContentChanged();
 
-		// Either read current projection matrix from OpenGL or copy
+		// Remove this scene as user of its frame context scene
+		void DetachFrameContextScene();
+
+		// Either get current projection matrix from the matrix stack or copy
 		// previously read matrix.
-		void GetProjMat();
-		void GetProjMat(GLdouble* pMat);
+		void GetProjMat(Clu::CMatrixStack& rStack);
+		void GetProjMat(Clu::CMatrixStack& rStack, GLdouble* pMat);
 		void ClearProjMatCurrent() { m_bProjMatCurrent = false; }
 
-		// Either read current model view matrix from OpenGL or copy
+		// Either get current model view matrix from the matrix stack or copy
 		// previously read matrix.
-		void GetFrameMat();
-		void GetFrameMat(GLdouble* pMat);
+		void GetFrameMat(Clu::CMatrixStack& rStack);
+		void GetFrameMat(Clu::CMatrixStack& rStack, GLdouble* pMat);
 		void ClearFrameMatCurrent() { m_bFrameMatCurrent = false; }
 
 		// Either read current viewport from OpenGL or copy
@@ -901,6 +947,9 @@
 		// Draw scene in pick mode?
 		bool m_bDoPickDraw;
 
+		// Pick hierarchy over vertex lists of scene. Null if not enabled.
+		COGLPickBVH* m_pPickBVH;
+
 		// Should script be notified on actions?
 		bool m_bDoNotify;
 		bool m_bDoNotifyMouseOver;
@@ -974,8 +1023,8 @@
 		// Scaling function
 		EScaleFunc m_eScaleFunc;
 
-		// Buffer scene in display list or some other way
-		bool m_bBufferScene;
+		// Buffer scene in a render queue. Null if not enabled.
+		COGLRenderQueue* m_pRenderQueue;
 
 		// Adjust given frame through dragging
 		bool m_bAutoAdjustFrame;
@@ -1200,8 +1249,9 @@
 		// Reference to scene whose frame context is used for auto translation and rotation
 		COGLBEReference m_refFrameContextScene;
 
-		// Reference to scene that uses frame context of this scene
-		COGLBEReference m_refFrameContextUser;
+		// Scene that uses frame context of this scene. This is not a reference,
+		// since the user references this scene, which would give a reference cycle.
+		COGLScene* m_pFrameContextUser;
 	};
 
 #endif	// !defined(AFX_OGLBASEELEMENTLIST_H__5746B287_573C_4800_9DE1_B801F31D0EB4__INCLUDED_)
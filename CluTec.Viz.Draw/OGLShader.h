@@ -147,7 +147,8 @@
 		bool IsGSOK() { return m_bGSOK; }
 		bool IsProgOK() { return m_bProgOK; }
 
-		void Enable(bool bVal = true) { m_bEnabled = bVal; }
+		// A disabled shader does not change the state, which a render queue has to know
+		void Enable(bool bVal = true) { m_bEnabled = bVal; InvalidateParentBounds(); }
 		bool IsEnabled() { return m_bEnabled; }
 
 		void EnableForPicking(bool bVal = true) { m_bEnabledForPicking = bVal; }
@@ -132,6 +132,9 @@ bool COGLTexture::SetTextureUnit(uint uTexUnit)
 	}
 
 	m_uTexUnit = uTexUnit;
+
+	// The texture unit is the state slot of the texture in a render queue
+	InvalidateParentBounds();
 	return true;
 }
 
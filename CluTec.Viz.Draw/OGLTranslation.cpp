@@ -78,6 +78,8 @@ void COGLTranslation::Reset()
 	m_fZ = GLfloat( 0 );
 
 	m_bWindowCoords = false;
+
+	InvalidateParentBounds();
 }
 
 //////////////////////////////////////////////////////////////////////
@@ -88,6 +90,8 @@ void COGLTranslation::Set( float fX, float fY, float fZ )
 	m_fX = GLfloat( fX );
 	m_fY = GLfloat( fY );
 	m_fZ = GLfloat( fZ );
+
+	InvalidateParentBounds();
 }
 
 //////////////////////////////////////////////////////////////////////
@@ -98,12 +102,24 @@ bool COGLTranslation::Apply(COGLBaseElement::EApplyMode eMode,
 {
 	if ( !m_bWindowCoords )
 	{
-		glTranslatef( m_fX, m_fY, m_fZ );
+		rData.xMatrixStack.Translate( m_fX, m_fY, m_fZ );
 	}
 	else
 	{
-		glTranslatef( m_fX, m_fY, m_fZ );
+		rData.xMatrixStack.Translate( m_fX, m_fY, m_fZ );
 	}
 
 	return true;
 }
+
+//////////////////////////////////////////////////////////////////////
+/// Bounds
+
+const COGLBaseElement::SBoundInfo& COGLTranslation::GetBoundInfo()
+{
+	m_xBoundInfo.Reset(true, false);
+	m_xBoundInfo.bHasTransform = true;
+	COGLBoundingBox::Translate(m_xBoundInfo.pdTransform, m_fX, m_fY, m_fZ);
+
+	return m_xBoundInfo;
+}
@@ -39,6 +39,8 @@
 #include "CluTec.Math/Matrix.h"
 #include "CluTec.Math/Matrix.Algo.SVD.h"
 
+#include <atomic>
+
 //// IMPORTANT IMPORTANT IMPORTANT
 /*
 		Never write this:
@@ -55,6 +57,23 @@
 
 #define BUFFER_OFFSET(i) ((char*) NULL + (i))
 
+// Offsets and sizes of attributes in SData in the order of COGLVertexList::EAttribute
+static const int s_piAttribOffset[COGLVertexList::ATTR_COUNT] =
+{
+	COGLVertexList::SData::iOffsetVex,
+	COGLVertexList::SData::iOffsetTex,
+	COGLVertexList::SData::iOffsetNorm,
+	COGLVertexList::SData::iOffsetCol,
+	COGLVertexList::SData::iOffsetFog,
+	COGLVertexList::SData::iOffsetPartId,
+	COGLVertexList::SData::iOffsetEdge
+};
+
+static const int s_piAttribSize[COGLVertexList::ATTR_COUNT] =
+{
+	sizeof(COGLVertex), sizeof(COGLVertex), sizeof(COGLVertex), sizeof(TColor), sizeof(GLfloat), sizeof(GLuint), sizeof(GLboolean)
+};
+
 //////////////////////////////////////////////////////////////////////
 // Konstruktion/Destruktion
 //////////////////////////////////////////////////////////////////////
@@ -63,6 +82,8 @@ COGLVertexList::COGLVertexList()
 {
 	m_sTypeName = "Object";
 
+	m_bBoundInfoValid = false;
+
 	m_bScaleBackColor = false;
 	m_fBackColorScale = 1.0f;
 
@@ -101,6 +122,25 @@ COGLVertexList::COGLVertexList()
 
 	m_vexScale.Set(1.0f, 1.0f, 1.0f);
 
+	m_eLayout     = LAYOUT_INTERLEAVED;
+	m_eColFormat  = COLFMT_FLOAT;
+	m_eNormFormat = NORMFMT_FLOAT;
+
+	for (int iAttr = 0; iAttr < ATTR_COUNT; ++iAttr)
+	{
+		m_pAttrib[iAttr].nElSize    = _AttribElSize(EAttribute(iAttr));
+		m_pAttrib[iAttr].nBufOffset = 0;
+		m_pAttrib[iAttr].mData.EnableDirectAlloc(false);
+	}
+
+	m_nBufVexCnt      = 0;
+	m_uBufAttribMask  = 0;
+	m_nLastUploadSize = 0;
+
+	m_pSharedVex       = nullptr;
+	m_uSharedVexFrame  = 0;
+	m_bSharedVexDirect = false;
+
 	Reset();
 
 	m_bVexModified = false;
@@ -124,6 +164,11 @@ COGLVertexList::COGLVertexList()
 
 COGLVertexList::~COGLVertexList()
 {
+	if (m_pSharedVex)
+	{
+		m_pSharedVex->Release();
+	}
+
 	// do not delete VBOs if they are external ones
 	if (m_bExternalVBO == false)
 	{
@@ -138,6 +183,28 @@ COGLVertexList::~COGLVertexList()
 COGLVertexList::COGLVertexList(const COGLVertexList& rVexList)
 {
 	m_sTypeName = "Object";
+
+	m_bBoundInfoValid = false;
+
+	m_eLayout     = LAYOUT_INTERLEAVED;
+	m_eColFormat  = COLFMT_FLOAT;
+	m_eNormFormat = NORMFMT_FLOAT;
+
+	for (int iAttr = 0; iAttr < ATTR_COUNT; ++iAttr)
+	{
+		m_pAttrib[iAttr].nElSize    = _AttribElSize(EAttribute(iAttr));
+		m_pAttrib[iAttr].nBufOffset = 0;
+		m_pAttrib[iAttr].mData.EnableDirectAlloc(false);
+	}
+
+	m_nBufVexCnt      = 0;
+	m_uBufAttribMask  = 0;
+	m_nLastUploadSize = 0;
+
+	m_pSharedVex       = nullptr;
+	m_uSharedVexFrame  = 0;
+	m_bSharedVexDirect = false;
+
 	Reset();
 
 	m_bVexModified = false;
@@ -159,9 +226,10 @@ COGLVertexList& COGLVertexList::operator=(const COGLVertexList& rVexList)
 
 	m_bVexModified = true;
 	m_bIdxModified = true;
+	_TouchGeometry();
 
 	m_eMode          = rVexList.m_eMode;
-	m_mDataList      = rVexList.m_mDataList;
+	_CopyVertexData(rVexList);
 	m_iVexCnt        = rVexList.m_iVexCnt;
 	m_iTexCnt        = rVexList.m_iTexCnt;
 	m_iNormCnt       = rVexList.m_iNormCnt;
@@ -207,6 +275,21 @@ COGLVertexList& COGLVertexList::operator=(const COGLVertexList& rVexList)
 
 	m_matTrans = rVexList.m_matTrans;
 
+	if (rVexList.m_pSharedVex)
+	{
+		rVexList.m_pSharedVex->AddRef();
+	}
+
+	if (m_pSharedVex)
+	{
+		m_pSharedVex->Release();
+	}
+
+	// The current frame of the shared buffer is taken over when the copy is drawn
+	m_pSharedVex       = rVexList.m_pSharedVex;
+	m_uSharedVexFrame  = 0;
+	m_bSharedVexDirect = rVexList.m_bSharedVexDirect;
+
 	return *this;
 }
 
@@ -215,9 +298,39 @@ void COGLVertexList::ApplyVertexAndIndexData(const COGLVertexList& xSource)
 {
 	try
 	{
-		// Set the vertex data
-		ApplyVertexData(xSource.m_eMode, xSource.m_mDataList.Count(), xSource.m_mDataList.Data(), (xSource.m_iVexCnt != 0), (xSource.m_iTexCnt != 0),
-				(xSource.m_iNormCnt != 0), (xSource.m_iColCnt != 0), false, (xSource.m_iEdgeCnt != 0), (xSource.m_iPartIdCnt != 0), xSource.m_uVexBufID);
+		if (xSource.m_eLayout == LAYOUT_SEPARATE)
+		{
+			_CopyVertexData(xSource);
+
+			m_eMode      = xSource.m_eMode;
+			m_iVexCnt    = xSource.m_iVexCnt;
+			m_iTexCnt    = xSource.m_iTexCnt;
+			m_iNormCnt   = xSource.m_iNormCnt;
+			m_iColCnt    = xSource.m_iColCnt;
+			m_iEdgeCnt   = xSource.m_iEdgeCnt;
+			m_iPartIdCnt = xSource.m_iPartIdCnt;
+
+			if (xSource.GetHostDataSize() > 0)
+			{
+				m_bVexModified = true;
+				_TouchGeometry();
+			}
+			else
+			{
+				// The source does not keep its data on the host, so use its vertex buffer.
+				m_bExternalVBO   = true;
+				m_uVexBufID      = xSource.m_uVexBufID;
+				m_nBufVexCnt     = xSource.m_nBufVexCnt;
+				m_uBufAttribMask = xSource.m_uBufAttribMask;
+				m_bVexModified   = false;
+			}
+		}
+		else
+		{
+			// Set the vertex data
+			ApplyVertexData(xSource.m_eMode, xSource.m_mDataList.Count(), xSource.m_mDataList.Data(), (xSource.m_iVexCnt != 0), (xSource.m_iTexCnt != 0),
+					(xSource.m_iNormCnt != 0), (xSource.m_iColCnt != 0), false, (xSource.m_iEdgeCnt != 0), (xSource.m_iPartIdCnt != 0), xSource.m_uVexBufID);
+		}
 
 		// Set the index data
 		m_mIdxList = xSource.m_mIdxList;
@@ -244,19 +357,55 @@ void COGLVertexList::ApplyVertexData(GLenum eMode,
 	// If pData is a valid pointer, copy the data
 	if (pData != nullptr)
 	{
-		if (nCount != m_mDataList.Count())
+		if (m_eLayout == LAYOUT_SEPARATE)
 		{
-			if (!m_mDataList.Set(nCount))
+			// Fog coordinates are not stored in separate layout, since they are not drawn.
+			bool pbUseAttrib[ATTR_COUNT] = { bUseVex, bUseTex, bUseNorm, bUseCol, false, bEnablePartPicking, bUseEdge };
+
+			m_nSepCnt = nCount;
+
+			for (int iAttr = 0; iAttr < ATTR_COUNT; ++iAttr)
 			{
-				throw CLU_EXCEPTION("Error creating target memory");
+				if (!pbUseAttrib[iAttr])
+				{
+					continue;
+				}
+
+				if (!_EnsureAttrib(EAttribute(iAttr), nCount))
+				{
+					throw CLU_EXCEPTION("Error creating target memory");
+				}
+
+				for (size_t nIdx = 0; nIdx < nCount; ++nIdx)
+				{
+					_PackAttrib(EAttribute(iAttr), nIdx, ((const char*) &pData[nIdx]) + s_piAttribOffset[iAttr]);
+				}
+			}
+		}
+		else
+		{
+			if (nCount != m_mDataList.Count())
+			{
+				if (!m_mDataList.Set(nCount))
+				{
+					throw CLU_EXCEPTION("Error creating target memory");
+				}
 			}
+
+			memcpy(m_mDataList.Data(), pData, nCount * sizeof(SData));
 		}
 
-		memcpy(m_mDataList.Data(), pData, nCount * sizeof(SData));
 		m_bVexModified = true;
+		_TouchGeometry();
 	}
 	else
 	{
+		// External vertex buffers contain interleaved SData records
+		if (m_eLayout != LAYOUT_INTERLEAVED)
+		{
+			SetLayout(LAYOUT_INTERLEAVED);
+		}
+
 		// There is no valid pData pointer, so we assume to have an external VertexBufferID
 		m_bExternalVBO = true;
 		m_uVexBufID    = uVertexBufferID;
@@ -313,6 +462,7 @@ bool COGLVertexList::SetIndexLists(const unsigned** const ppuIndexLists, const u
 		}
 
 		m_bIdxModified = true;
+		_TouchGeometry();
 	}
 	else
 	{
@@ -338,6 +488,12 @@ bool COGLVertexList::SetIndexLists(const unsigned** const ppuIndexLists, const u
 
 bool COGLVertexList::AddVex(const COGLVertex& rVex)
 {
+	if (m_eLayout == LAYOUT_SEPARATE)
+	{
+		COGLVertex xVex(rVex);
+		return _AddAttrib(ATTR_VEX, m_iVexCnt, &xVex.Clamp());
+	}
+
 	if (m_iVexCnt == m_mDataList.Count())
 	{
 		if (!(m_mDataList.Add(1))) { return false; } }
@@ -346,6 +502,7 @@ bool COGLVertexList::AddVex(const COGLVertex& rVex)
 	m_mDataList[m_iVexCnt].xVex.Clamp();
 	++m_iVexCnt;
 	m_bVexModified = true;
+	_TouchGeometry();
 
 	return true;
 }
@@ -355,6 +512,13 @@ bool COGLVertexList::AddVex(const COGLVertex& rVex)
 
 bool COGLVertexList::AddVex(const float* m_pfVex)
 {
+	if (m_eLayout == LAYOUT_SEPARATE)
+	{
+		COGLVertex xVex;
+		xVex = m_pfVex;
+		return _AddAttrib(ATTR_VEX, m_iVexCnt, &xVex.Clamp());
+	}
+
 	if (m_iVexCnt == m_mDataList.Count())
 	{
 		if (!(m_mDataList.Add(1))) { return false; } }
@@ -363,6 +527,7 @@ bool COGLVertexList::AddVex(const float* m_pfVex)
 	m_mDataList[m_iVexCnt].xVex.Clamp();
 	++m_iVexCnt;
 	m_bVexModified = true;
+	_TouchGeometry();
 
 	return true;
 }
@@ -372,6 +537,12 @@ bool COGLVertexList::AddVex(const float* m_pfVex)
 
 bool COGLVertexList::AddVex(float fX, float fY, float fZ)
 {
+	if (m_eLayout == LAYOUT_SEPARATE)
+	{
+		COGLVertex xVex(fX, fY, fZ);
+		return _AddAttrib(ATTR_VEX, m_iVexCnt, &xVex.Clamp());
+	}
+
 	if (m_iVexCnt == m_mDataList.Count())
 	{
 		if (!(m_mDataList.Add(1))) { return false; } }
@@ -380,6 +551,7 @@ bool COGLVertexList::AddVex(float fX, float fY, float fZ)
 	m_mDataList[m_iVexCnt].xVex.Clamp();
 	++m_iVexCnt;
 	m_bVexModified = true;
+	_TouchGeometry();
 
 	return true;
 }
@@ -387,6 +559,11 @@ bool COGLVertexList::AddVex(float fX, float fY, float fZ)
 //////////////////////////////////////////////////////////////////////
 bool COGLVertexList::AddVexRange(const TVexList& mVex)
 {
+	if (m_eLayout == LAYOUT_SEPARATE)
+	{
+		return _AddAttribRange(ATTR_VEX, m_iVexCnt, mVex.Data(), mVex.Count(), sizeof(COGLVertex));
+	}
+
 	size_t iNewCnt = mVex.Count();
 	if (size_t(m_iVexCnt + iNewCnt) > m_mDataList.Count())
 	{
@@ -403,6 +580,7 @@ bool COGLVertexList::AddVexRange(const TVexList& mVex)
 
 	m_iVexCnt     += int(iNewCnt);
 	m_bVexModified = true;
+	_TouchGeometry();
 	return true;
 }
 
@@ -411,6 +589,12 @@ bool COGLVertexList::AddVexRange(const TVexList& mVex)
 
 bool COGLVertexList::AddTex(const COGLVertex& rVex)
 {
+	if (m_eLayout == LAYOUT_SEPARATE)
+	{
+		COGLVertex xTex(rVex);
+		return _AddAttrib(ATTR_TEX, m_iTexCnt, &xTex.Clamp());
+	}
+
 	if (m_iTexCnt == m_mDataList.Count())
 	{
 		if (!(m_mDataList.Add(1)))
@@ -423,6 +607,7 @@ bool COGLVertexList::AddTex(const COGLVertex& rVex)
 	m_mDataList[m_iTexCnt].xTex.Clamp();
 	++m_iTexCnt;
 	m_bVexModified = true;
+	_TouchGeometry();
 
 	return true;
 }
@@ -432,6 +617,13 @@ bool COGLVertexList::AddTex(const COGLVertex& rVex)
 
 bool COGLVertexList::AddTex(const float* m_pfVex)
 {
+	if (m_eLayout == LAYOUT_SEPARATE)
+	{
+		COGLVertex xTex;
+		xTex = m_pfVex;
+		return _AddAttrib(ATTR_TEX, m_iTexCnt, &xTex.Clamp());
+	}
+
 	if (m_iTexCnt == m_mDataList.Count())
 	{
 		if (!(m_mDataList.Add(1)))
@@ -444,6 +636,7 @@ bool COGLVertexList::AddTex(const float* m_pfVex)
 	m_mDataList[m_iTexCnt].xTex.Clamp();
 	++m_iTexCnt;
 	m_bVexModified = true;
+	_TouchGeometry();
 
 	return true;
 }
@@ -453,6 +646,12 @@ bool COGLVertexList::AddTex(const float* m_pfVex)
 
 bool COGLVertexList::AddTex(float fX, float fY, float fZ)
 {
+	if (m_eLayout == LAYOUT_SEPARATE)
+	{
+		COGLVertex xTex(fX, fY, fZ);
+		return _AddAttrib(ATTR_TEX, m_iTexCnt, &xTex.Clamp());
+	}
+
 	if (m_iTexCnt == m_mDataList.Count())
 	{
 		if (!(m_mDataList.Add(1))) { return false; } }
@@ -461,6 +660,7 @@ bool COGLVertexList::AddTex(float fX, float fY, float fZ)
 	m_mDataList[m_iTexCnt].xTex.Clamp();
 	++m_iTexCnt;
 	m_bVexModified = true;
+	_TouchGeometry();
 
 	return true;
 }
@@ -468,6 +668,11 @@ bool COGLVertexList::AddTex(float fX, float fY, float fZ)
 //////////////////////////////////////////////////////////////////////
 bool COGLVertexList::AddTexRange(const TVexList& mVex)
 {
+	if (m_eLayout == LAYOUT_SEPARATE)
+	{
+		return _AddAttribRange(ATTR_TEX, m_iTexCnt, mVex.Data(), mVex.Count(), sizeof(COGLVertex));
+	}
+
 	if (m_iTexCnt + mVex.Count() > m_mDataList.Count())
 	{
 		if (!(m_mDataList.Set(m_iTexCnt + mVex.Count())))
@@ -483,6 +688,7 @@ bool COGLVertexList::AddTexRange(const TVexList& mVex)
 
 	m_iTexCnt     += int(mVex.Count());
 	m_bVexModified = true;
+	_TouchGeometry();
 
 	return true;
 }
@@ -492,6 +698,12 @@ bool COGLVertexList::AddTexRange(const TVexList& mVex)
 
 bool COGLVertexList::AddNormal(const COGLVertex& rVex)
 {
+	if (m_eLayout == LAYOUT_SEPARATE)
+	{
+		COGLVertex xNorm(rVex);
+		return _AddAttrib(ATTR_NORM, m_iNormCnt, &xNorm.Clamp());
+	}
+
 	if (m_iNormCnt == m_mDataList.Count())
 	{
 		if (!(m_mDataList.Add(1))) { return false; } }
@@ -500,6 +712,7 @@ bool COGLVertexList::AddNormal(const COGLVertex& rVex)
 	m_mDataList[m_iNormCnt].xNorm.Clamp();
 	++m_iNormCnt;
 	m_bVexModified = true;
+	_TouchGeometry();
 
 	return true;
 }
@@ -509,6 +722,13 @@ bool COGLVertexList::AddNormal(const COGLVertex& rVex)
 
 bool COGLVertexList::AddNormal(const float* m_pfVex)
 {
+	if (m_eLayout == LAYOUT_SEPARATE)
+	{
+		COGLVertex xNorm;
+		xNorm = m_pfVex;
+		return _AddAttrib(ATTR_NORM, m_iNormCnt, &xNorm.Clamp());
+	}
+
 	if (m_iNormCnt == m_mDataList.Count())
 	{
 		if (!(m_mDataList.Add(1))) { return false; } }
@@ -517,6 +737,7 @@ bool COGLVertexList::AddNormal(const float* m_pfVex)
 	m_mDataList[m_iNormCnt].xNorm.Clamp();
 	++m_iNormCnt;
 	m_bVexModified = true;
+	_TouchGeometry();
 
 	return true;
 }
@@ -526,6 +747,12 @@ bool COGLVertexList::AddNormal(const float* m_pfVex)
 
 bool COGLVertexList::AddNormal(float fX, float fY, float fZ)
 {
+	if (m_eLayout == LAYOUT_SEPARATE)
+	{
+		COGLVertex xNorm(fX, fY, fZ);
+		return _AddAttrib(ATTR_NORM, m_iNormCnt, &xNorm.Clamp());
+	}
+
 	if (m_iNormCnt == m_mDataList.Count())
 	{
 		if (!(m_mDataList.Add(1))) { return false; } }
@@ -534,6 +761,7 @@ bool COGLVertexList::AddNormal(float fX, float fY, float fZ)
 	m_mDataList[m_iNormCnt].xNorm.Clamp();
 	++m_iNormCnt;
 	m_bVexModified = true;
+	_TouchGeometry();
 
 	return true;
 }
@@ -541,6 +769,11 @@ bool COGLVertexList::AddNormal(float fX, float fY, float fZ)
 //////////////////////////////////////////////////////////////////////
 bool COGLVertexList::AddNormalRange(const TVexList& mVex)
 {
+	if (m_eLayout == LAYOUT_SEPARATE)
+	{
+		return _AddAttribRange(ATTR_NORM, m_iNormCnt, mVex.Data(), mVex.Count(), sizeof(COGLVertex));
+	}
+
 	if (m_iNormCnt + mVex.Count() > m_mDataList.Count())
 	{
 		if (!(m_mDataList.Set(m_iNormCnt + mVex.Count()))) { return false; } }
@@ -552,6 +785,7 @@ bool COGLVertexList::AddNormalRange(const TVexList& mVex)
 
 	m_iNormCnt    += int(mVex.Count());
 	m_bVexModified = true;
+	_TouchGeometry();
 
 	return true;
 }
@@ -561,6 +795,11 @@ bool COGLVertexList::AddNormalRange(const TVexList& mVex)
 
 bool COGLVertexList::AddCol(const COGLColor& rCol)
 {
+	if (m_eLayout == LAYOUT_SEPARATE)
+	{
+		return _AddAttrib(ATTR_COL, m_iColCnt, rCol.Data());
+	}
+
 	if (m_iColCnt == m_mDataList.Count())
 	{
 		if (!(m_mDataList.Add(1))) { return false; } }
@@ -568,6 +807,7 @@ bool COGLVertexList::AddCol(const COGLColor& rCol)
 	m_mDataList[m_iColCnt].xCol = rCol.Data();
 	++m_iColCnt;
 	m_bVexModified = true;
+	_TouchGeometry();
 
 	return true;
 }
@@ -577,6 +817,11 @@ bool COGLVertexList::AddCol(const COGLColor& rCol)
 
 bool COGLVertexList::AddCol(const float* pfCol)
 {
+	if (m_eLayout == LAYOUT_SEPARATE)
+	{
+		return _AddAttrib(ATTR_COL, m_iColCnt, pfCol);
+	}
+
 	if (m_iColCnt == m_mDataList.Count())
 	{
 		if (!(m_mDataList.Add(1))) { return false; } }
@@ -584,6 +829,7 @@ bool COGLVertexList::AddCol(const float* pfCol)
 	m_mDataList[m_iColCnt].xCol = pfCol;
 	++m_iColCnt;
 	m_bVexModified = true;
+	_TouchGeometry();
 
 	return true;
 }
@@ -593,6 +839,12 @@ bool COGLVertexList::AddCol(const float* pfCol)
 
 bool COGLVertexList::AddCol(float fR, float fG, float fB, float fA)
 {
+	if (m_eLayout == LAYOUT_SEPARATE)
+	{
+		float pfCol[4] = { fR, fG, fB, fA };
+		return _AddAttrib(ATTR_COL, m_iColCnt, pfCol);
+	}
+
 	if (m_iColCnt == m_mDataList.Count())
 	{
 		if (!(m_mDataList.Add(1))) { return false; } }
@@ -604,6 +856,7 @@ bool COGLVertexList::AddCol(float fR, float fG, float fB, float fA)
 	xCol[3] = fA;
 	++m_iColCnt;
 	m_bVexModified = true;
+	_TouchGeometry();
 
 	return true;
 }
@@ -611,6 +864,24 @@ bool COGLVertexList::AddCol(float fR, float fG, float fB, float fA)
 //////////////////////////////////////////////////////////////////////
 bool COGLVertexList::AddColRange(const MemObj<COGLColor>& mCol)
 {
+	if (m_eLayout == LAYOUT_SEPARATE)
+	{
+		if (!_EnsureAttrib(ATTR_COL, m_iColCnt + mCol.Count()))
+		{
+			return false;
+		}
+
+		for (size_t nIdx = 0; nIdx < mCol.Count(); ++nIdx)
+		{
+			if (!_AddAttrib(ATTR_COL, m_iColCnt, mCol[nIdx].Data()))
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
 	if (m_iColCnt + mCol.Count() > m_mDataList.Count())
 	{
 		if (!(m_mDataList.Set(m_iColCnt + mCol.Count()))) { return false; } }
@@ -622,6 +893,7 @@ bool COGLVertexList::AddColRange(const MemObj<COGLColor>& mCol)
 
 	m_iColCnt     += int(mCol.Count());
 	m_bVexModified = true;
+	_TouchGeometry();
 
 	return true;
 }
@@ -629,6 +901,11 @@ bool COGLVertexList::AddColRange(const MemObj<COGLColor>& mCol)
 //////////////////////////////////////////////////////////////////////
 bool COGLVertexList::AddPartIdRange(const TPartIdList& mPartIdList)
 {
+	if (m_eLayout == LAYOUT_SEPARATE)
+	{
+		return _AddAttribRange(ATTR_PARTID, m_iPartIdCnt, mPartIdList.Data(), mPartIdList.Count(), sizeof(unsigned));
+	}
+
 	if (m_iPartIdCnt + mPartIdList.Count() > m_mDataList.Count())
 	{
 		if (!(m_mDataList.Set(m_iPartIdCnt + mPartIdList.Count())))
@@ -644,6 +921,7 @@ bool COGLVertexList::AddPartIdRange(const TPartIdList& mPartIdList)
 
 	m_iPartIdCnt  += int(mPartIdList.Count());
 	m_bVexModified = true;
+	_TouchGeometry();
 
 	return true;
 }
@@ -663,6 +941,7 @@ bool COGLVertexList::SetIdxList(size_t nNo, unsigned* pIdx)
 
 	memcpy(rIdx.Data(), pIdx, nNo * sizeof(unsigned));
 	m_bIdxModified = true;
+	_TouchGeometry();
 
 	return true;
 }
@@ -675,6 +954,7 @@ bool COGLVertexList::SetIdxList(Mem<unsigned>& mIdx)
 	m_mIdxList.Set(1);
 	m_mIdxList[0]  = mIdx;
 	m_bIdxModified = true;
+	_TouchGeometry();
 
 	return true;
 }
@@ -694,6 +974,7 @@ bool COGLVertexList::AddIdxList(size_t nNo, unsigned* pIdx)
 
 	memcpy(rIdx.Data(), pIdx, nNo * sizeof(unsigned));
 	m_bIdxModified = true;
+	_TouchGeometry();
 
 	return true;
 }
@@ -706,6 +987,7 @@ bool COGLVertexList::AddIdxList(Mem<unsigned>& mIdx)
 	m_mIdxList.Add(1);
 	m_mIdxList.Last() = mIdx;
 	m_bIdxModified    = true;
+	_TouchGeometry();
 
 	return true;
 }
@@ -717,6 +999,23 @@ bool COGLVertexList::AddIdxList(Mem<unsigned>& mIdx)
 void COGLVertexList::InvertNormals(float fFac)
 {
 	m_bVexModified = true;
+	_TouchGeometry();
+
+	if (m_eLayout == LAYOUT_SEPARATE)
+	{
+		size_t nIdx, nCnt = m_pAttrib[ATTR_NORM].mData.Count() / m_pAttrib[ATTR_NORM].nElSize;
+		COGLVertex xNorm;
+
+		for (nIdx = 0; nIdx < nCnt; ++nIdx)
+		{
+			_UnpackAttrib(ATTR_NORM, nIdx, &xNorm);
+			xNorm = -xNorm * fFac;
+			_PackAttrib(ATTR_NORM, nIdx, &xNorm);
+		}
+
+		return;
+	}
+
 	size_t i, n = m_mDataList.Count();
 
 	for (i = 0; i < n; i++)
@@ -726,123 +1025,1183 @@ void COGLVertexList::InvertNormals(float fFac)
 }
 
 //////////////////////////////////////////////////////////////////////
-void COGLVertexList::_LoadMatrixProjection()
+bool COGLVertexList::Reserve(size_t iCnt)
 {
-	float pfMatrix[16];
-
-	glGetFloatv(GL_PROJECTION_MATRIX, pfMatrix);
-
-	if ((m_bMatrixChangedProjection = (memcmp(m_matProjection.DataPointer(), pfMatrix, 16 * sizeof(float)) != 0)) == true)
+	if (m_eLayout == LAYOUT_INTERLEAVED)
 	{
-		memcpy(m_matProjection.DataPointer(), pfMatrix, 16 * sizeof(float));
+		return m_mDataList.Set(iCnt);
 	}
+
+	// The attribute arrays are enlarged when they are written to
+	m_nSepCnt = iCnt;
+	return true;
 }
 
 //////////////////////////////////////////////////////////////////////
-void COGLVertexList::_LoadMatrixModelView()
+// Set Storage Layout
+
+void COGLVertexList::SetLayout(ELayout eLayout)
 {
-	float pfMatrix[16];
+	if (eLayout == m_eLayout)
+	{
+		return;
+	}
 
-	glGetFloatv(GL_MODELVIEW_MATRIX, pfMatrix);
+	int iAttr;
+	size_t nIdx;
 
-	if ((m_bMatrixChangedModelView = (memcmp(m_matModelView.DataPointer(), pfMatrix, 16 * sizeof(float)) != 0)) == true)
+	if (eLayout == LAYOUT_SEPARATE)
 	{
-		memcpy(m_matModelView.DataPointer(), pfMatrix, 16 * sizeof(float));
+		size_t nCnt = m_mDataList.Count();
+
+		m_eLayout = LAYOUT_SEPARATE;
+		m_nSepCnt = nCnt;
+
+		for (iAttr = 0; iAttr < ATTR_COUNT; ++iAttr)
+		{
+			EAttribute eAttr = EAttribute(iAttr);
+			SAttrib& rAttrib = m_pAttrib[iAttr];
+
+			rAttrib.nElSize = _AttribElSize(eAttr);
+			rAttrib.mData.Set(0);
+
+			if (!_IsAttribUsed(eAttr))
+			{
+				continue;
+			}
+
+			if (!_EnsureAttrib(eAttr, nCnt))
+			{
+				throw CLU_EXCEPTION("Error creating target memory");
+			}
+
+			for (nIdx = 0; nIdx < nCnt; ++nIdx)
+			{
+				_PackAttrib(eAttr, nIdx, ((const char*) &m_mDataList[nIdx]) + s_piAttribOffset[iAttr]);
+			}
+		}
+
+		m_mDataList.Set(0);
+		m_mDataList.Prune();
 	}
-}
+	else
+	{
+		size_t nCnt = m_nSepCnt;
 
-/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-COGLVertexList::TMat4 COGLVertexList::InvertMatrix(const TMat4& _mA)
-{
-	TMat4 mInvA;
+		if (!m_mDataList.Set(nCnt))
+		{
+			throw CLU_EXCEPTION("Error creating target memory");
+		}
 
-	Clu::CMatrix<float> mA(_mA);
-	mA = Clu::CMatrixAlgoSVD<float>::Inverse(mA, 1e-5f);
-	mA.ToMatrix(mInvA);
+		memset(m_mDataList.Data(), 0, nCnt * sizeof(SData));
 
-	return mInvA;
+		for (iAttr = 0; iAttr < ATTR_COUNT; ++iAttr)
+		{
+			EAttribute eAttr = EAttribute(iAttr);
+			SAttrib& rAttrib = m_pAttrib[iAttr];
+			size_t nAttrCnt  = std::min(nCnt, rAttrib.mData.Count() / rAttrib.nElSize);
+
+			for (nIdx = 0; nIdx < nAttrCnt; ++nIdx)
+			{
+				_UnpackAttrib(eAttr, nIdx, ((char*) &m_mDataList[nIdx]) + s_piAttribOffset[iAttr]);
+			}
+
+			rAttrib.mData.Set(0);
+			rAttrib.mData.Prune();
+		}
+
+		m_nSepCnt = 0;
+		m_eLayout = LAYOUT_INTERLEAVED;
+	}
+
+	m_bVexModified = true;
+	_TouchGeometry();
 }
 
-/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-bool COGLVertexList::Apply(COGLBaseElement::EApplyMode eMode, COGLBaseElement::SApplyData& rData)
+//////////////////////////////////////////////////////////////////////
+void COGLVertexList::SetColorFormat(EColorFormat eFormat)
 {
-	if (m_iVexCnt == 0)
+	if (eFormat != m_eColFormat)
 	{
-		return true;
+		_SetAttribFormat(ATTR_COL, int(eFormat));
 	}
+}
 
-	if (m_uVexBufID == 0)
+//////////////////////////////////////////////////////////////////////
+void COGLVertexList::SetNormalFormat(ENormalFormat eFormat)
+{
+	if (eFormat != m_eNormFormat)
 	{
-		CLU_OGL_CALL(glGenBuffers(1, &m_uVexBufID));
+		_SetAttribFormat(ATTR_NORM, int(eFormat));
 	}
+}
 
-	if (m_uIdxBufID == 0)
-	{
-		CLU_OGL_CALL(glGenBuffers(1, &m_uIdxBufID));
-	}
+//////////////////////////////////////////////////////////////////////
+// Change format of color or normal attribute and convert existing data
 
-	unsigned uShaderID = 0;
-	// True if a shader is active
-	bool bShaderOn = false;
-	// This is true if a shader is active and its version is greater or equal to GLSL version 1.4
-	bool bShader_1_4 = false;
+void COGLVertexList::_SetAttribFormat(EAttribute eAttr, int iFormat)
+{
+	SAttrib& rAttrib = m_pAttrib[eAttr];
+	size_t nIdx, nCnt = (m_eLayout == LAYOUT_SEPARATE ? rAttrib.mData.Count() / rAttrib.nElSize : 0);
+	size_t nValSize = size_t(s_piAttribSize[eAttr]);
 
-	COGLShader* pxShader = dynamic_cast<COGLShader*>(rData.pCurShader);
-	if (pxShader != nullptr)
-	{
-		bShaderOn   = true;
-		bShader_1_4 = pxShader->GetFragmentShaderVersion() >= 140 || pxShader->GetVertexShaderVersion() >= 140 || pxShader->GetGeometryShaderVersion() >= 140;
-		uShaderID   = pxShader->GetShaderGlId();
+	// Unpack data to float values
+	Mem<GLubyte> mValue(nCnt * nValSize);
 
-		// TODO: Shader version test correct? Not && required?
+	for (nIdx = 0; nIdx < nCnt; ++nIdx)
+	{
+		_UnpackAttrib(eAttr, nIdx, mValue.Data() + nIdx * nValSize);
 	}
 
-	// Flag that we are in pick mode
-	bool bPickMode = (eMode == COGLBaseElement::PICK);
-
-	bool bUsePartIdAsColor = false;
-	if (bPickMode)
+	if (eAttr == ATTR_COL)
 	{
-		// Push Object ID onto name stack
-		rData.PushPickName(GetUID());
+		m_eColFormat = EColorFormat(iFormat);
+	}
+	else
+	{
+		m_eNormFormat = ENormalFormat(iFormat);
+	}
 
-		// Now store current pick name stack in list
-		uint uPickName  = rData.StorePickNameStack();
-		uint uPickColor = rData.ConvertNameToColor(uPickName, 0);
+	rAttrib.nElSize = _AttribElSize(eAttr);
+	rAttrib.mData.Set(0);
 
-		if ((m_iPartIdCnt > 0) && m_bKeepDataOnHost)
+	if (nCnt > 0)
+	{
+		if (!_EnsureAttrib(eAttr, nCnt))
 		{
-			SData* pData = m_mDataList.Data();
-			// Only update the part ID names with uPickName if necessary
-			if (pData->uPartId != rData.ConvertNameToColor(uPickName, pData->uPartId))
-			{
-				for (int iVexIdx = 0; iVexIdx < m_iVexCnt; ++iVexIdx, ++pData)
-				{
-					// Use the lower 20 bits for the part ID and the upper 12 bits for the pick name
-					pData->uPartId = rData.ConvertNameToColor(uPickName, pData->uPartId);
-				}
-
-				m_bVexModified = true;
-			}
-
-			bUsePartIdAsColor = true;
+			throw CLU_EXCEPTION("Error creating target memory");
 		}
-		else
+
+		for (nIdx = 0; nIdx < nCnt; ++nIdx)
 		{
-			//Set current color to picking ID color
-			CLU_OGL_CALL(glColor4ubv((const GLubyte*) &uPickColor));
-			rData.pfCurColor[0] = float(uPickColor & 0x000000FF) / 255.0f;
-			rData.pfCurColor[1] = float((uPickColor & 0x0000FF00) >> 8) / 255.0f;
-			rData.pfCurColor[2] = float((uPickColor & 0x00FF0000) >> 16) / 255.0f;
-			rData.pfCurColor[3] = float((uPickColor & 0xFF000000) >> 24) / 255.0f;
+			_PackAttrib(eAttr, nIdx, mValue.Data() + nIdx * nValSize);
 		}
 	}
 
-	int piUsedTexUnit[OGL_MAX_TEX_UNITS];
-	int iUsedTexUnitCnt = 0;
+	m_bVexModified = true;
+	_TouchGeometry();
+}
 
-	if (m_iTexCnt != 0)
-	{
+//////////////////////////////////////////////////////////////////////
+bool COGLVertexList::SetVex(size_t nIdx, const COGLVertex& rVex)
+{
+	return _SetAttrib(ATTR_VEX, nIdx, &rVex);
+}
+
+bool COGLVertexList::SetTex(size_t nIdx, const COGLVertex& rTex)
+{
+	return _SetAttrib(ATTR_TEX, nIdx, &rTex);
+}
+
+bool COGLVertexList::SetNormal(size_t nIdx, const COGLVertex& rNorm)
+{
+	return _SetAttrib(ATTR_NORM, nIdx, &rNorm);
+}
+
+bool COGLVertexList::SetCol(size_t nIdx, const TColor& rCol)
+{
+	return _SetAttrib(ATTR_COL, nIdx, rCol.Data());
+}
+
+bool COGLVertexList::SetPartId(size_t nIdx, unsigned uPartId)
+{
+	return _SetAttrib(ATTR_PARTID, nIdx, &uPartId);
+}
+
+//////////////////////////////////////////////////////////////////////
+COGLVertex COGLVertexList::GetVex(size_t nIdx) const
+{
+	COGLVertex xVex;
+	_GetAttrib(ATTR_VEX, nIdx, &xVex);
+	return xVex;
+}
+
+COGLVertex COGLVertexList::GetTex(size_t nIdx) const
+{
+	COGLVertex xTex;
+	_GetAttrib(ATTR_TEX, nIdx, &xTex);
+	return xTex;
+}
+
+COGLVertex COGLVertexList::GetNormal(size_t nIdx) const
+{
+	COGLVertex xNorm;
+	_GetAttrib(ATTR_NORM, nIdx, &xNorm);
+	return xNorm;
+}
+
+TColor COGLVertexList::GetCol(size_t nIdx) const
+{
+	TColor xCol;
+	_GetAttrib(ATTR_COL, nIdx, xCol.Data());
+	return xCol;
+}
+
+unsigned COGLVertexList::GetPartId(size_t nIdx) const
+{
+	GLuint uPartId;
+	_GetAttrib(ATTR_PARTID, nIdx, &uPartId);
+	return uPartId;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Set a single attribute value, which is given in the format of SData.
+
+bool COGLVertexList::_SetAttrib(EAttribute eAttr, size_t nIdx, const void* pvVal)
+{
+	if (nIdx >= _DataCount())
+	{
+		return false;
+	}
+
+	if (m_eLayout == LAYOUT_INTERLEAVED)
+	{
+		memcpy(((char*) &m_mDataList[nIdx]) + s_piAttribOffset[eAttr], pvVal, s_piAttribSize[eAttr]);
+	}
+	else
+	{
+		if (!_EnsureAttrib(eAttr, m_nSepCnt))
+		{
+			return false;
+		}
+
+		_PackAttrib(eAttr, nIdx, pvVal);
+	}
+
+	SetModified(eAttr, nIdx, 1);
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Get a single attribute value in the format of SData.
+// Returns zero for elements that have not been set.
+
+void COGLVertexList::_GetAttrib(EAttribute eAttr, size_t nIdx, void* pvVal) const
+{
+	if (m_eLayout == LAYOUT_INTERLEAVED)
+	{
+		if (nIdx < m_mDataList.Count())
+		{
+			memcpy(pvVal, ((const char*) &m_mDataList[nIdx]) + s_piAttribOffset[eAttr], s_piAttribSize[eAttr]);
+			return;
+		}
+	}
+	else
+	{
+		// Float positions of a shared buffer are only available in the buffer
+		if (nIdx < _AttribHostCount(eAttr))
+		{
+			_UnpackAttrib(eAttr, nIdx, pvVal);
+			return;
+		}
+	}
+
+	memset(pvVal, 0, s_piAttribSize[eAttr]);
+}
+
+//////////////////////////////////////////////////////////////////////
+void COGLVertexList::SetModified(EAttribute eAttr, size_t nFirst, size_t nCount)
+{
+	if (nCount == 0)
+	{
+		return;
+	}
+
+	if (eAttr == ATTR_VEX)
+	{
+		_TouchGeometry();
+	}
+
+	size_t& nModFirst = (m_eLayout == LAYOUT_INTERLEAVED ? m_nModFirst : m_pAttrib[eAttr].nModFirst);
+	size_t& nModEnd   = (m_eLayout == LAYOUT_INTERLEAVED ? m_nModEnd : m_pAttrib[eAttr].nModEnd);
+
+	if (nModFirst >= nModEnd)
+	{
+		nModFirst = nFirst;
+		nModEnd   = nFirst + nCount;
+	}
+	else
+	{
+		nModFirst = std::min(nModFirst, nFirst);
+		nModEnd   = std::max(nModEnd, nFirst + nCount);
+	}
+}
+
+//////////////////////////////////////////////////////////////////////
+size_t COGLVertexList::GetHostDataSize() const
+{
+	size_t nSize = m_mDataList.Count() * sizeof(SData);
+
+	for (int iAttr = 0; iAttr < ATTR_COUNT; ++iAttr)
+	{
+		nSize += m_pAttrib[iAttr].mData.Count();
+	}
+
+	return nSize;
+}
+
+//////////////////////////////////////////////////////////////////////
+bool COGLVertexList::_IsAttribUsed(EAttribute eAttr) const
+{
+	switch (eAttr)
+	{
+	case ATTR_VEX:
+		return m_iVexCnt > 0;
+	case ATTR_TEX:
+		return m_iTexCnt > 0;
+	case ATTR_NORM:
+		return m_iNormCnt > 0;
+	case ATTR_COL:
+		return m_iColCnt > 0;
+	case ATTR_PARTID:
+		return m_iPartIdCnt > 0;
+	case ATTR_EDGE:
+		return m_iEdgeCnt > 0;
+	default:
+		return false;
+	}
+}
+
+//////////////////////////////////////////////////////////////////////
+// Number of bytes per element of an attribute in separate layout
+
+size_t COGLVertexList::_AttribElSize(EAttribute eAttr) const
+{
+	if (eAttr == ATTR_NORM && m_eNormFormat == NORMFMT_SHORT)
+	{
+		return 4 * sizeof(GLshort);
+	}
+
+	if (eAttr == ATTR_COL && m_eColFormat == COLFMT_RGBA8)
+	{
+		return 4 * sizeof(GLubyte);
+	}
+
+	return size_t(s_piAttribSize[eAttr]);
+}
+
+//////////////////////////////////////////////////////////////////////
+// Mask of attributes that are stored in the vertex buffer in separate layout
+
+unsigned COGLVertexList::_UsedAttribMask() const
+{
+	unsigned uMask = (1 << ATTR_VEX);
+
+	if (m_iTexCnt > 0)
+	{
+		uMask |= (1 << ATTR_TEX);
+	}
+
+	if (m_iNormCnt > 0)
+	{
+		uMask |= (1 << ATTR_NORM);
+	}
+
+	if (m_iColCnt > 0)
+	{
+		uMask |= (1 << ATTR_COL);
+	}
+
+	if (m_iPartIdCnt > 0)
+	{
+		uMask |= (1 << ATTR_PARTID);
+	}
+
+	return uMask;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Ensure that attribute array has at least the given number of elements.
+// New elements are set to zero.
+
+bool COGLVertexList::_EnsureAttrib(EAttribute eAttr, size_t nCnt)
+{
+	SAttrib& rAttrib = m_pAttrib[eAttr];
+	size_t nElSize   = rAttrib.nElSize;
+	size_t nOldCnt   = rAttrib.mData.Count() / nElSize;
+
+	if (nOldCnt >= nCnt)
+	{
+		return true;
+	}
+
+	// Grow capacity geometrically, so that adding single elements is fast
+	if (rAttrib.mData.Capacity() < nCnt * nElSize)
+	{
+		if (!rAttrib.mData.Reserve(std::max(nCnt, 2 * nOldCnt) * nElSize))
+		{
+			return false;
+		}
+	}
+
+	if (!rAttrib.mData.Set(nCnt * nElSize))
+	{
+		return false;
+	}
+
+	memset(rAttrib.mData.Data() + nOldCnt * nElSize, 0, (nCnt - nOldCnt) * nElSize);
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Add an attribute value in separate layout
+
+bool COGLVertexList::_AddAttrib(EAttribute eAttr, int& iCnt, const void* pvVal)
+{
+	size_t nIdx = size_t(iCnt);
+
+	if (!_EnsureAttrib(eAttr, nIdx + 1))
+	{
+		return false;
+	}
+
+	_PackAttrib(eAttr, nIdx, pvVal);
+
+	m_nSepCnt = std::max(m_nSepCnt, nIdx + 1);
+	++iCnt;
+
+	SetModified(eAttr, nIdx, 1);
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Add a range of attribute values in separate layout
+
+bool COGLVertexList::_AddAttribRange(EAttribute eAttr, int& iCnt, const void* pvVal, size_t nValCnt, size_t nValStride)
+{
+	size_t nIdx, nFirst = size_t(iCnt);
+
+	if (!_EnsureAttrib(eAttr, nFirst + nValCnt))
+	{
+		return false;
+	}
+
+	const char* pcVal = (const char*) pvVal;
+	for (nIdx = 0; nIdx < nValCnt; ++nIdx, pcVal += nValStride)
+	{
+		_PackAttrib(eAttr, nFirst + nIdx, pcVal);
+	}
+
+	m_nSepCnt = std::max(m_nSepCnt, nFirst + nValCnt);
+	iCnt     += int(nValCnt);
+
+	SetModified(eAttr, nFirst, nValCnt);
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Pack a value given in the format of SData into the attribute array
+
+void COGLVertexList::_PackAttrib(EAttribute eAttr, size_t nIdx, const void* pvVal)
+{
+	SAttrib& rAttrib = m_pAttrib[eAttr];
+	GLubyte* pubData = rAttrib.mData.Data() + nIdx * rAttrib.nElSize;
+
+	if (eAttr == ATTR_COL && m_eColFormat == COLFMT_RGBA8)
+	{
+		const float* pfCol = (const float*) pvVal;
+
+		for (int i = 0; i < 4; ++i)
+		{
+			float fVal = pfCol[i];
+			pubData[i] = GLubyte(fVal <= 0.0f ? 0 : (fVal >= 1.0f ? 255 : int(fVal * 255.0f + 0.5f)));
+		}
+	}
+	else if (eAttr == ATTR_NORM && m_eNormFormat == NORMFMT_SHORT)
+	{
+		COGLVertex xNorm;
+		xNorm = (const float*) pvVal;
+		xNorm.Norm();
+
+		GLshort* psData = (GLshort*) pubData;
+		for (int i = 0; i < 3; ++i)
+		{
+			psData[i] = GLshort(floor(xNorm[i] * 32767.0f + 0.5f));
+		}
+		psData[3] = 0;
+	}
+	else
+	{
+		memcpy(pubData, pvVal, rAttrib.nElSize);
+	}
+}
+
+//////////////////////////////////////////////////////////////////////
+// Unpack a value of the attribute array into the format of SData
+
+void COGLVertexList::_UnpackAttrib(EAttribute eAttr, size_t nIdx, void* pvVal) const
+{
+	const SAttrib& rAttrib = m_pAttrib[eAttr];
+	const GLubyte* pubData = _AttribUploadData(eAttr) + nIdx * rAttrib.nElSize;
+
+	if (eAttr == ATTR_COL && m_eColFormat == COLFMT_RGBA8)
+	{
+		float* pfCol = (float*) pvVal;
+
+		for (int i = 0; i < 4; ++i)
+		{
+			pfCol[i] = float(pubData[i]) / 255.0f;
+		}
+	}
+	else if (eAttr == ATTR_NORM && m_eNormFormat == NORMFMT_SHORT)
+	{
+		float* pfNorm          = (float*) pvVal;
+		const GLshort* psData = (const GLshort*) pubData;
+
+		for (int i = 0; i < 3; ++i)
+		{
+			pfNorm[i] = std::max(float(psData[i]) / 32767.0f, -1.0f);
+		}
+	}
+	else
+	{
+		memcpy(pvVal, pubData, rAttrib.nElSize);
+	}
+}
+
+//////////////////////////////////////////////////////////////////////
+// Copy vertex data in the layout of the given vertex list
+
+void COGLVertexList::_CopyVertexData(const COGLVertexList& rVexList)
+{
+	m_eLayout     = rVexList.m_eLayout;
+	m_eColFormat  = rVexList.m_eColFormat;
+	m_eNormFormat = rVexList.m_eNormFormat;
+
+	m_mDataList = rVexList.m_mDataList;
+	m_nSepCnt   = rVexList.m_nSepCnt;
+
+	for (int iAttr = 0; iAttr < ATTR_COUNT; ++iAttr)
+	{
+		SAttrib& rAttrib           = m_pAttrib[iAttr];
+		const SAttrib& rSrcAttrib = rVexList.m_pAttrib[iAttr];
+
+		rAttrib.mData      = rSrcAttrib.mData;
+		rAttrib.nElSize    = rSrcAttrib.nElSize;
+		rAttrib.nBufOffset = rSrcAttrib.nBufOffset;
+		rAttrib.nModFirst  = rAttrib.nModEnd = 0;
+	}
+
+	m_nModFirst = m_nModEnd = 0;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Use shared buffer for vertex positions
+
+bool COGLVertexList::SetSharedVexSource(CSharedBuffer* pBuffer)
+{
+	if (pBuffer && (pBuffer->GetElementCount() % 3 != 0))
+	{
+		return false;
+	}
+
+	if (pBuffer)
+	{
+		pBuffer->AddRef();
+	}
+
+	if (m_pSharedVex)
+	{
+		if (m_bSharedVexDirect && m_bKeepDataOnHost && (m_uSharedVexFrame != 0))
+		{
+			// Keep the positions of the frame currently shown on the host
+			size_t nCnt = size_t(m_iVexCnt);
+			if (_EnsureAttrib(ATTR_VEX, nCnt))
+			{
+				memcpy(m_pAttrib[ATTR_VEX].mData.Data(), m_pSharedVex->GetReadData(), nCnt * m_pAttrib[ATTR_VEX].nElSize);
+			}
+		}
+
+		m_pSharedVex->Release();
+	}
+
+	m_pSharedVex       = pBuffer;
+	m_uSharedVexFrame  = 0;
+	m_bSharedVexDirect = false;
+
+	if (pBuffer)
+	{
+		SetLayout(LAYOUT_SEPARATE);
+		m_bSharedVexDirect = (pBuffer->GetDataType() == CSharedBuffer::DT_FLOAT);
+	}
+
+	_TouchBounds();
+
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Take over the newest frame of the shared vertex buffer.
+// Float positions are not copied here but in _UpdateVertexBuffer().
+
+void COGLVertexList::_UpdateSharedVex()
+{
+	if (!m_pSharedVex)
+	{
+		return;
+	}
+
+	// Accessing the SData records switches to interleaved layout, which does not contain the shared positions
+	if (m_eLayout != LAYOUT_SEPARATE)
+	{
+		SetLayout(LAYOUT_SEPARATE);
+		m_uSharedVexFrame = 0;
+	}
+
+	m_pSharedVex->Acquire();
+
+	unsigned uFrame = m_pSharedVex->GetFrame();
+
+	// Nothing has been published yet, or the frame is already used
+	if ((uFrame == 0) || (uFrame == m_uSharedVexFrame))
+	{
+		return;
+	}
+
+	size_t nCnt      = m_pSharedVex->GetElementCount() / 3;
+	SAttrib& rAttrib = m_pAttrib[ATTR_VEX];
+
+	if (m_bSharedVexDirect)
+	{
+		rAttrib.mData.Set(0);
+	}
+	else
+	{
+		if (!_EnsureAttrib(ATTR_VEX, nCnt))
+		{
+			return;
+		}
+
+		float* pfVex  = (float*) rAttrib.mData.Data();
+		size_t nElCnt = 3 * nCnt;
+
+		if (m_pSharedVex->GetDataType() == CSharedBuffer::DT_DOUBLE)
+		{
+			const double* pdData = (const double*) m_pSharedVex->GetReadData();
+			for (size_t nIdx = 0; nIdx < nElCnt; ++nIdx)
+			{
+				pfVex[nIdx] = float(pdData[nIdx]);
+			}
+		}
+		else
+		{
+			const unsigned char* pucData = (const unsigned char*) m_pSharedVex->GetReadData();
+			for (size_t nIdx = 0; nIdx < nElCnt; ++nIdx)
+			{
+				pfVex[nIdx] = float(pucData[nIdx]);
+			}
+		}
+	}
+
+	m_uSharedVexFrame = uFrame;
+	m_iVexCnt         = int(nCnt);
+	AdjustDataListSize();
+
+	rAttrib.nModFirst = 0;
+	rAttrib.nModEnd   = nCnt;
+	_TouchGeometry();
+}
+
+//////////////////////////////////////////////////////////////////////
+// Host data of attribute in separate layout that is copied to the vertex buffer
+
+const GLubyte* COGLVertexList::_AttribUploadData(EAttribute eAttr) const
+{
+	if ((eAttr == ATTR_VEX) && m_bSharedVexDirect && (m_uSharedVexFrame != 0))
+	{
+		return (const GLubyte*) m_pSharedVex->GetReadData();
+	}
+
+	return m_pAttrib[eAttr].mData.Data();
+}
+
+//////////////////////////////////////////////////////////////////////
+// Number of elements of attribute in separate layout available on host
+
+size_t COGLVertexList::_AttribHostCount(EAttribute eAttr) const
+{
+	if ((eAttr == ATTR_VEX) && m_bSharedVexDirect && (m_uSharedVexFrame != 0))
+	{
+		return m_pSharedVex->GetElementCount() / 3;
+	}
+
+	return m_pAttrib[eAttr].mData.Count() / m_pAttrib[eAttr].nElSize;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Copy modified vertex data to the currently bound vertex buffer.
+// If the number of vertices or the used attributes have not changed,
+// only the modified ranges are copied.
+
+void COGLVertexList::_UpdateVertexBuffer()
+{
+	size_t nVexCnt     = size_t(m_iVexCnt);
+	size_t nUploadSize = 0;
+	int iAttr;
+
+	// External vertex buffers are never written to
+	if (m_bExternalVBO)
+	{
+		return;
+	}
+
+	if (m_eLayout == LAYOUT_INTERLEAVED)
+	{
+		if (m_bVexModified || (nVexCnt != m_nBufVexCnt) || (m_uBufAttribMask != 0))
+		{
+			Clu::OpenGL::BufferData(GL_ARRAY_BUFFER, nVexCnt * sizeof(SData), m_mDataList.Data(), GL_STATIC_DRAW);
+			nUploadSize = nVexCnt * sizeof(SData);
+		}
+		else if ((m_nModFirst < m_nModEnd) && (m_nModFirst < nVexCnt))
+		{
+			size_t nModEnd = std::min(m_nModEnd, nVexCnt);
+
+			nUploadSize = (nModEnd - m_nModFirst) * sizeof(SData);
+			glBufferSubData(GL_ARRAY_BUFFER, m_nModFirst * sizeof(SData), nUploadSize, m_mDataList.Data() + m_nModFirst);
+		}
+
+		m_uBufAttribMask = 0;
+	}
+	else
+	{
+		unsigned uAttribMask = _UsedAttribMask();
+
+		if (m_bVexModified || (nVexCnt != m_nBufVexCnt) || (uAttribMask != m_uBufAttribMask))
+		{
+			size_t nBufSize = 0;
+
+			// Place the blocks of the used attributes one after the other
+			for (iAttr = 0; iAttr < ATTR_COUNT; ++iAttr)
+			{
+				if (uAttribMask & (1 << iAttr))
+				{
+					SAttrib& rAttrib = m_pAttrib[iAttr];
+
+					rAttrib.nBufOffset = nBufSize;
+					nBufSize          += (nVexCnt * rAttrib.nElSize + 15) & ~size_t(15);
+				}
+			}
+
+			Clu::OpenGL::BufferData(GL_ARRAY_BUFFER, nBufSize, NULL, GL_STATIC_DRAW);
+
+			for (iAttr = 0; iAttr < ATTR_COUNT; ++iAttr)
+			{
+				SAttrib& rAttrib = m_pAttrib[iAttr];
+
+				if (!(uAttribMask & (1 << iAttr)))
+				{
+					continue;
+				}
+
+				if (_AttribHostCount(EAttribute(iAttr)) >= nVexCnt || _EnsureAttrib(EAttribute(iAttr), nVexCnt))
+				{
+					glBufferSubData(GL_ARRAY_BUFFER, rAttrib.nBufOffset, nVexCnt * rAttrib.nElSize, _AttribUploadData(EAttribute(iAttr)));
+				}
+			}
+
+			nUploadSize = nBufSize;
+		}
+		else
+		{
+			for (iAttr = 0; iAttr < ATTR_COUNT; ++iAttr)
+			{
+				SAttrib& rAttrib = m_pAttrib[iAttr];
+				size_t nModEnd   = std::min(std::min(rAttrib.nModEnd, nVexCnt), _AttribHostCount(EAttribute(iAttr)));
+
+				if ((uAttribMask & (1 << iAttr)) && (rAttrib.nModFirst < nModEnd))
+				{
+					size_t nSize = (nModEnd - rAttrib.nModFirst) * rAttrib.nElSize;
+
+					glBufferSubData(GL_ARRAY_BUFFER, rAttrib.nBufOffset + rAttrib.nModFirst * rAttrib.nElSize, nSize,
+							_AttribUploadData(EAttribute(iAttr)) + rAttrib.nModFirst * rAttrib.nElSize);
+
+					nUploadSize += nSize;
+				}
+			}
+		}
+
+		m_uBufAttribMask = uAttribMask;
+	}
+
+	m_nBufVexCnt   = nVexCnt;
+	m_bVexModified = false;
+	m_nModFirst    = m_nModEnd = 0;
+
+	for (iAttr = 0; iAttr < ATTR_COUNT; ++iAttr)
+	{
+		m_pAttrib[iAttr].nModFirst = m_pAttrib[iAttr].nModEnd = 0;
+	}
+
+	if (nUploadSize == 0)
+	{
+		return;
+	}
+
+	m_nLastUploadSize = nUploadSize;
+
+	if (!m_bKeepDataOnHost)
+	{
+		m_mDataList.Set(0);
+		m_mDataList.Prune();
+
+		for (iAttr = 0; iAttr < ATTR_COUNT; ++iAttr)
+		{
+			m_pAttrib[iAttr].mData.Set(0);
+			m_pAttrib[iAttr].mData.Prune();
+		}
+
+		m_nSepCnt = 0;
+	}
+}
+
+//////////////////////////////////////////////////////////////////////
+// Stride and offset of attribute in vertex buffer
+
+void COGLVertexList::_GetAttribPointer(EAttribute eAttr, GLsizei& iStride, const GLvoid*& pvOffset) const
+{
+	if (m_eLayout == LAYOUT_INTERLEAVED)
+	{
+		iStride  = GLsizei(sizeof(SData));
+		pvOffset = BUFFER_OFFSET(s_piAttribOffset[eAttr]);
+	}
+	else
+	{
+		iStride  = GLsizei(m_pAttrib[eAttr].nElSize);
+		pvOffset = BUFFER_OFFSET(m_pAttrib[eAttr].nBufOffset);
+	}
+}
+
+//////////////////////////////////////////////////////////////////////
+void COGLVertexList::_LoadMatrixProjection(Clu::CMatrixStack& rStack)
+{
+	float pfMatrix[16];
+
+	rStack.GetMatrix(Clu::CMatrixStack::Projection, pfMatrix);
+
+	if ((m_bMatrixChangedProjection = (memcmp(m_matProjection.DataPointer(), pfMatrix, 16 * sizeof(float)) != 0)) == true)
+	{
+		memcpy(m_matProjection.DataPointer(), pfMatrix, 16 * sizeof(float));
+	}
+}
+
+//////////////////////////////////////////////////////////////////////
+void COGLVertexList::_LoadMatrixModelView(Clu::CMatrixStack& rStack)
+{
+	float pfMatrix[16];
+
+	rStack.GetMatrix(Clu::CMatrixStack::ModelView, pfMatrix);
+
+	if ((m_bMatrixChangedModelView = (memcmp(m_matModelView.DataPointer(), pfMatrix, 16 * sizeof(float)) != 0)) == true)
+	{
+		memcpy(m_matModelView.DataPointer(), pfMatrix, 16 * sizeof(float));
+	}
+}
+
+//////////////////////////////////////////////////////////////////////
+void COGLVertexList::_TouchGeometry()
+{
+	// Stamps are unique over all vertex lists, so that a pick hierarchy does not confuse
+	// a new vertex list with a deleted one at the same address.
+	static std::atomic<unsigned> s_uNextGeoStamp(1);
+
+	m_uGeoStamp = s_uNextGeoStamp++;
+
+	_TouchBounds();
+}
+
+//////////////////////////////////////////////////////////////////////
+void COGLVertexList::_TouchBounds()
+{
+	// Parents only have to be told once, until the bounds are evaluated again
+	if (m_bBoundInfoValid)
+	{
+		m_bBoundInfoValid = false;
+		InvalidateParentBounds();
+	}
+}
+
+//////////////////////////////////////////////////////////////////////
+const COGLBaseElement::SBoundInfo& COGLVertexList::GetBoundInfo()
+{
+	if (m_bBoundInfoValid)
+	{
+		return m_xBoundInfo;
+	}
+
+	COGLPickBVH::SGeometry xGeo;
+
+	// The vertices of shared sources and instances are only known on the GPU
+	if (m_pSharedVex || (m_iInstanceCount > 1) || !GetPickGeometry(xGeo))
+	{
+		m_xBoundInfo.Reset(false, true);
+		m_bBoundInfoValid = true;
+		return m_xBoundInfo;
+	}
+
+	m_xBoundInfo.Reset(true, false);
+	m_xBoundInfo.uGeoCnt = 1;
+
+	// Overriding the alpha value changes the current color for the following elements
+	m_xBoundInfo.bHasState = m_bOverrideAlpha;
+
+	if (!m_bUseTransform && !m_bUseGenTransform && !m_bUseScaling)
+	{
+		m_xBoundInfo.xBox.AddPoints(xGeo.pubVex, xGeo.nVexStride, xGeo.nVexCnt);
+	}
+	else
+	{
+		COGLBoundingBox xVexBox;
+		xVexBox.AddPoints(xGeo.pubVex, xGeo.nVexStride, xGeo.nVexCnt);
+
+		// Same order of transformations as in Apply()
+		double pdMat[16];
+		COGLBoundingBox::Identity(pdMat);
+
+		if (m_bUseGenTransform)
+		{
+			double pdTrans[16], pdPrev[16];
+			const float* pfTrans = m_matTrans.Data();
+			for (int i = 0; i < 16; ++i)
+			{
+				pdTrans[i] = double(pfTrans[i]);
+			}
+
+			memcpy(pdPrev, pdMat, 16 * sizeof(double));
+			COGLBoundingBox::MultMatrix(pdMat, pdPrev, pdTrans);
+		}
+
+		if (m_bUseTransform)
+		{
+			COGLBoundingBox::Translate(pdMat, m_vexTrans1[0], m_vexTrans1[1], m_vexTrans1[2]);
+			COGLBoundingBox::Rotate(pdMat, m_fRotAngle, m_vexRotAxis[0], m_vexRotAxis[1], m_vexRotAxis[2]);
+			COGLBoundingBox::Translate(pdMat, m_vexTrans2[0], m_vexTrans2[1], m_vexTrans2[2]);
+		}
+
+		if (m_bUseScaling)
+		{
+			COGLBoundingBox::Scale(pdMat, m_vexScale[0], m_vexScale[1], m_vexScale[2]);
+		}
+
+		if (COGLBoundingBox::IsAffine(pdMat))
+		{
+			m_xBoundInfo.xBox.AddBox(xVexBox, pdMat);
+		}
+		else
+		{
+			m_xBoundInfo.Reset(false, true);
+		}
+	}
+
+	m_bBoundInfoValid = true;
+	return m_xBoundInfo;
+}
+
+//////////////////////////////////////////////////////////////////////
+bool COGLVertexList::GetPickGeometry(COGLPickBVH::SGeometry& rGeo) const
+{
+	if (!m_bKeepDataOnHost || (size_t(m_iVexCnt) > _DataCount()))
+	{
+		return false;
+	}
+
+	rGeo.eMode   = m_eMode;
+	rGeo.nVexCnt = size_t(m_iVexCnt);
+
+	if (m_eLayout == LAYOUT_INTERLEAVED)
+	{
+		const GLubyte* pubData = (const GLubyte*) m_mDataList.Data();
+
+		rGeo.pubVex        = pubData + SData::iOffsetVex;
+		rGeo.nVexStride    = sizeof(SData);
+		rGeo.pubPartId     = (m_iPartIdCnt > 0 ? pubData + SData::iOffsetPartId : nullptr);
+		rGeo.nPartIdStride = sizeof(SData);
+	}
+	else
+	{
+		if (_AttribHostCount(ATTR_VEX) < rGeo.nVexCnt)
+		{
+			return false;
+		}
+
+		rGeo.pubVex     = _AttribUploadData(ATTR_VEX);
+		rGeo.nVexStride = m_pAttrib[ATTR_VEX].nElSize;
+
+		bool bPartId = (m_iPartIdCnt > 0) && (m_pAttrib[ATTR_PARTID].mData.Count() >= rGeo.nVexCnt * sizeof(GLuint));
+		rGeo.pubPartId     = (bPartId ? m_pAttrib[ATTR_PARTID].mData.Data() : nullptr);
+		rGeo.nPartIdStride = sizeof(GLuint);
+	}
+
+	rGeo.vecIdxList.clear();
+	rGeo.vecIdxCnt.clear();
+
+	for (size_t nList = 0; nList < m_mIdxList.Count(); ++nList)
+	{
+		rGeo.vecIdxList.push_back(m_mIdxList[nList].Data());
+		rGeo.vecIdxCnt.push_back(m_mIdxList[nList].Count());
+	}
+
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Called in drawing mode after the local transformations of the vertex list
+// have been applied. The pick name stack is the same as in picking mode.
+
+void COGLVertexList::_UpdatePickBVH(COGLBaseElement::SApplyData& rData)
+{
+	COGLPickBVH& xBVH = *rData.pPickBVH;
+
+	if (!xBVH.IsGeometryCurrent(this, m_uGeoStamp))
+	{
+		COGLPickBVH::SGeometry xGeo;
+		if (!GetPickGeometry(xGeo))
+		{
+			return;
+		}
+
+		xBVH.SetGeometry(this, m_uGeoStamp, xGeo);
+	}
+
+	float pfModelView[16];
+	rData.xMatrixStack.GetMatrix(Clu::CMatrixStack::ModelView, pfModelView);
+
+	rData.PushPickName(GetUID());
+
+	// Only the part of the name stack below the owner of the pick hierarchy is stored
+	size_t nNameBase = std::min(size_t(rData.uPickBVHNameBase), size_t(rData.cuMaxPickNameStackLen));
+	size_t nNameEnd  = std::min(size_t(rData.uNextPickNameStackIdx), size_t(rData.cuMaxPickNameStackLen));
+	xBVH.AddInstance(this, GetUID(), pfModelView, rData.vecPickNameStack.data() + nNameBase, nNameEnd - nNameBase);
+
+	rData.PopPickName();
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+COGLVertexList::TMat4 COGLVertexList::InvertMatrix(const TMat4& _mA)
+{
+	TMat4 mInvA;
+
+	Clu::CMatrix<float> mA(_mA);
+	mA = Clu::CMatrixAlgoSVD<float>::Inverse(mA, 1e-5f);
+	mA.ToMatrix(mInvA);
+
+	return mInvA;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+bool COGLVertexList::Apply(COGLBaseElement::EApplyMode eMode, COGLBaseElement::SApplyData& rData)
+{
+	_UpdateSharedVex();
+
+	if (m_iVexCnt == 0)
+	{
+		return true;
+	}
+
+	if (rData.eCullState == COGLBaseElement::CULL_OUTSIDE)
+	{
+		// Culled, only the change of the current color has to be kept
+		if (m_bOverrideAlpha && (eMode != COGLBaseElement::PICK))
+		{
+			float pfColor[4];
+			CLU_OGL_CALL(glGetFloatv(GL_CURRENT_COLOR, pfColor));
+			pfColor[3] = m_fOverrideAlphaValue;
+			CLU_OGL_CALL(glColor4fv(pfColor));
+			memcpy(rData.pfCurColor, pfColor, 4 * sizeof(float));
+		}
+
+		return true;
+	}
+
+	++rData.xCullStats.uDrawCnt;
+
+	if (m_uVexBufID == 0)
+	{
+		CLU_OGL_CALL(glGenBuffers(1, &m_uVexBufID));
+	}
+
+	if (m_uIdxBufID == 0)
+	{
+		CLU_OGL_CALL(glGenBuffers(1, &m_uIdxBufID));
+	}
+
+	unsigned uShaderID = 0;
+	// True if a shader is active
+	bool bShaderOn = false;
+	// This is true if a shader is active and its version is greater or equal to GLSL version 1.4
+	bool bShader_1_4 = false;
+
+	COGLShader* pxShader = dynamic_cast<COGLShader*>(rData.pCurShader);
+	if (pxShader != nullptr)
+	{
+		bShaderOn   = true;
+		bShader_1_4 = pxShader->GetFragmentShaderVersion() >= 140 || pxShader->GetVertexShaderVersion() >= 140 || pxShader->GetGeometryShaderVersion() >= 140;
+		uShaderID   = pxShader->GetShaderGlId();
+
+		// TODO: Shader version test correct? Not && required?
+	}
+
+	// Flag that we are in pick mode
+	bool bPickMode = (eMode == COGLBaseElement::PICK);
+
+	bool bUsePartIdAsColor = false;
+	if (bPickMode)
+	{
+		// Push Object ID onto name stack
+		rData.PushPickName(GetUID());
+
+		// Now store current pick name stack in list
+		uint uPickName  = rData.StorePickNameStack();
+		uint uPickColor = rData.ConvertNameToColor(uPickName, 0);
+
+		if ((m_iPartIdCnt > 0) && m_bKeepDataOnHost)
+		{
+			GLubyte* pubPartId;
+			size_t nStride;
+
+			if (m_eLayout == LAYOUT_INTERLEAVED)
+			{
+				pubPartId = ((GLubyte*) m_mDataList.Data()) + SData::iOffsetPartId;
+				nStride   = sizeof(SData);
+			}
+			else
+			{
+				_EnsureAttrib(ATTR_PARTID, size_t(m_iVexCnt));
+				pubPartId = m_pAttrib[ATTR_PARTID].mData.Data();
+				nStride   = sizeof(GLuint);
+			}
+
+			// Only update the part ID names with uPickName if necessary
+			if (*((GLuint*) pubPartId) != rData.ConvertNameToColor(uPickName, *((GLuint*) pubPartId)))
+			{
+				for (int iVexIdx = 0; iVexIdx < m_iVexCnt; ++iVexIdx, pubPartId += nStride)
+				{
+					// Use the lower 20 bits for the part ID and the upper 12 bits for the pick name
+					GLuint& uPartId = *((GLuint*) pubPartId);
+					uPartId = rData.ConvertNameToColor(uPickName, uPartId);
+				}
+
+				// Only the part IDs have to be copied to the vertex buffer
+				SetModified(ATTR_PARTID, 0, size_t(m_iVexCnt));
+			}
+
+			bUsePartIdAsColor = true;
+		}
+		else
+		{
+			//Set current color to picking ID color
+			CLU_OGL_CALL(glColor4ubv((const GLubyte*) &uPickColor));
+			rData.pfCurColor[0] = float(uPickColor & 0x000000FF) / 255.0f;
+			rData.pfCurColor[1] = float((uPickColor & 0x0000FF00) >> 8) / 255.0f;
+			rData.pfCurColor[2] = float((uPickColor & 0x00FF0000) >> 16) / 255.0f;
+			rData.pfCurColor[3] = float((uPickColor & 0xFF000000) >> 24) / 255.0f;
+		}
+	}
+
+	int piUsedTexUnit[OGL_MAX_TEX_UNITS];
+	int iUsedTexUnitCnt = 0;
+
+	if (m_iTexCnt != 0)
+	{
 		for (int iTexUnit = 0; iTexUnit < OGL_MAX_TEX_UNITS; iTexUnit++)
 		{
 			if (rData.pbActTexUnit[iTexUnit])
@@ -917,23 +2276,29 @@ bool COGLVertexList::Apply(COGLBaseElement::EApplyMode eMode, COGLBaseElement::S
 
 	if (m_bUseGenTransform)
 	{
-		CLU_OGL_CALL(glMultMatrixf(m_matTrans.Data()));
+		rData.xMatrixStack.MultMatrix(m_matTrans.Data());
 		CLU_OGL_CALL(glEnable(GL_NORMALIZE));
 	}
 
 	if (m_bUseTransform)
 	{
-		CLU_OGL_CALL(glTranslatef(m_vexTrans1[0], m_vexTrans1[1], m_vexTrans1[2]));
-		CLU_OGL_CALL(glRotatef(m_fRotAngle, m_vexRotAxis[0], m_vexRotAxis[1], m_vexRotAxis[2]));
-		CLU_OGL_CALL(glTranslatef(m_vexTrans2[0], m_vexTrans2[1], m_vexTrans2[2]));
+		rData.xMatrixStack.Translate(m_vexTrans1[0], m_vexTrans1[1], m_vexTrans1[2]);
+		rData.xMatrixStack.Rotate(m_fRotAngle, m_vexRotAxis[0], m_vexRotAxis[1], m_vexRotAxis[2]);
+		rData.xMatrixStack.Translate(m_vexTrans2[0], m_vexTrans2[1], m_vexTrans2[2]);
 	}
 
 	if (m_bUseScaling)
 	{
-		CLU_OGL_CALL(glScalef(m_vexScale[0], m_vexScale[1], m_vexScale[2]));
+		rData.xMatrixStack.Scale(m_vexScale[0], m_vexScale[1], m_vexScale[2]);
 		CLU_OGL_CALL(glEnable(GL_NORMALIZE));
 	}
 
+	// The pick hierarchy is also refit when drawing in pick mode with an out of date hierarchy
+	if (rData.pPickBVH)
+	{
+		_UpdatePickBVH(rData);
+	}
+
 	bool bCullFace = (m_bUsePolyCull || (m_bUsePolyCullWhenTransparent && (pfFrontColor[3] < 0.9999f)));
 	if (bCullFace)
 	{
@@ -985,7 +2350,7 @@ bool COGLVertexList::Apply(COGLBaseElement::EApplyMode eMode, COGLBaseElement::S
 		/************************************************************************/
 		if ((iUniformLocation = glGetUniformLocation(uShaderID, "clu_matProjection")) >= 0)
 		{
-			_LoadMatrixProjection();
+			_LoadMatrixProjection(rData.xMatrixStack);
 			glUniformMatrix4fv(iUniformLocation, 1, GL_FALSE, (const GLfloat*) m_matProjection.DataPointer());
 			bProjMatLoaded = true;
 		}
@@ -997,7 +2362,7 @@ bool COGLVertexList::Apply(COGLBaseElement::EApplyMode eMode, COGLBaseElement::S
 		{
 			if (!bProjMatLoaded)
 			{
-				_LoadMatrixProjection();
+				_LoadMatrixProjection(rData.xMatrixStack);
 				bProjMatLoaded = true;
 			}
 
@@ -1013,7 +2378,7 @@ bool COGLVertexList::Apply(COGLBaseElement::EApplyMode eMode, COGLBaseElement::S
 		/************************************************************************/
 		if ((iUniformLocation = glGetUniformLocation(uShaderID, "clu_matModelView")) >= 0)
 		{
-			_LoadMatrixModelView();
+			_LoadMatrixModelView(rData.xMatrixStack);
 			glUniformMatrix4fv(iUniformLocation, 1, GL_FALSE, (const GLfloat*) m_matModelView.DataPointer());
 			bModelMatLoaded = true;
 		}
@@ -1025,7 +2390,7 @@ bool COGLVertexList::Apply(COGLBaseElement::EApplyMode eMode, COGLBaseElement::S
 		{
 			if (!bModelMatLoaded)
 			{
-				_LoadMatrixModelView();
+				_LoadMatrixModelView(rData.xMatrixStack);
 				bModelMatLoaded = true;
 			}
 
@@ -1044,12 +2409,12 @@ bool COGLVertexList::Apply(COGLBaseElement::EApplyMode eMode, COGLBaseElement::S
 		{
 			if (!bModelMatLoaded)
 			{
-				_LoadMatrixModelView();
+				_LoadMatrixModelView(rData.xMatrixStack);
 			}
 
 			if (!bProjMatLoaded)
 			{
-				_LoadMatrixProjection();
+				_LoadMatrixProjection(rData.xMatrixStack);
 			}
 
 			// Matrix product for column-major matrices
@@ -1103,7 +2468,7 @@ bool COGLVertexList::Apply(COGLBaseElement::EApplyMode eMode, COGLBaseElement::S
 			if ((iUniformLocation = glGetUniformLocation(uShaderID, ppcTexMatrixName[iTexUnit])) >= 0)
 			{
 				float pfMatrix[16];
-				glGetFloatv(GL_TEXTURE_MATRIX, pfMatrix);
+				rData.xMatrixStack.GetTextureMatrix(iTexUnit, pfMatrix);
 				glUniformMatrix4fv(iUniformLocation, 1, GL_TRUE, (const GLfloat*) pfMatrix);
 			}
 		}
@@ -1195,32 +2560,38 @@ bool COGLVertexList::Apply(COGLBaseElement::EApplyMode eMode, COGLBaseElement::S
 	CLU_OGL_CALL(glBindBuffer(GL_ARRAY_BUFFER, m_uVexBufID));
 
 	// Only copy vertex data to device if it has been modified
-	if (m_bVexModified)
-	{
-		m_bVexModified = false;
-		Clu::OpenGL::BufferData(GL_ARRAY_BUFFER, m_iVexCnt * sizeof(SData), m_mDataList.Data(), GL_STATIC_DRAW);
+	_UpdateVertexBuffer();
 
-		if (!m_bKeepDataOnHost)
-		{
-			m_mDataList.Set(0);
-			m_mDataList.Prune();
-		}
-	}
+	// Strides, offsets and formats of the attributes in the vertex buffer
+	GLsizei iStrideVex, iStrideTex, iStrideNorm, iStrideCol, iStridePartId;
+	const GLvoid *pvOffsetVex, *pvOffsetTex, *pvOffsetNorm, *pvOffsetCol, *pvOffsetPartId;
+
+	_GetAttribPointer(ATTR_VEX, iStrideVex, pvOffsetVex);
+	_GetAttribPointer(ATTR_TEX, iStrideTex, pvOffsetTex);
+	_GetAttribPointer(ATTR_NORM, iStrideNorm, pvOffsetNorm);
+	_GetAttribPointer(ATTR_COL, iStrideCol, pvOffsetCol);
+	_GetAttribPointer(ATTR_PARTID, iStridePartId, pvOffsetPartId);
+
+	bool bColRGBA8  = (m_eLayout == LAYOUT_SEPARATE && m_eColFormat == COLFMT_RGBA8);
+	bool bNormShort = (m_eLayout == LAYOUT_SEPARATE && m_eNormFormat == NORMFMT_SHORT);
+
+	GLenum eColType  = (bColRGBA8 ? GL_UNSIGNED_BYTE : GL_FLOAT);
+	GLenum eNormType = (bNormShort ? GL_SHORT : GL_FLOAT);
 
 	if (bShader_1_4)
 	{
 		glEnableVertexAttribArray(CLUGL_VAA_VERTEX);
-		glVertexAttribPointer(CLUGL_VAA_VERTEX, 3, GL_FLOAT, GL_FALSE, sizeof(SData), BUFFER_OFFSET(SData::iOffsetVex));
+		glVertexAttribPointer(CLUGL_VAA_VERTEX, 3, GL_FLOAT, GL_FALSE, iStrideVex, pvOffsetVex);
 
 		if (bUseColor)
 		{
 			glEnableVertexAttribArray(CLUGL_VAA_COLOR);
-			glVertexAttribPointer(CLUGL_VAA_COLOR, 4, GL_FLOAT, GL_TRUE, sizeof(SData), BUFFER_OFFSET(SData::iOffsetCol));
+			glVertexAttribPointer(CLUGL_VAA_COLOR, 4, eColType, GL_TRUE, iStrideCol, pvOffsetCol);
 		}
 		else if (bUsePartIdAsColor)
 		{
 			glEnableVertexAttribArray(CLUGL_VAA_COLOR);
-			glVertexAttribPointer(CLUGL_VAA_COLOR, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(SData), BUFFER_OFFSET(SData::iOffsetPartId));
+			glVertexAttribPointer(CLUGL_VAA_COLOR, 4, GL_UNSIGNED_BYTE, GL_TRUE, iStridePartId, pvOffsetPartId);
 		}
 		else
 		{
@@ -1230,7 +2601,7 @@ bool COGLVertexList::Apply(COGLBaseElement::EApplyMode eMode, COGLBaseElement::S
 		if (bUseNorm)
 		{
 			glEnableVertexAttribArray(CLUGL_VAA_NORMAL);
-			glVertexAttribPointer(CLUGL_VAA_NORMAL, 3, GL_FLOAT, GL_FALSE, sizeof(SData), BUFFER_OFFSET(SData::iOffsetNorm));
+			glVertexAttribPointer(CLUGL_VAA_NORMAL, 3, eNormType, (bNormShort ? GL_TRUE : GL_FALSE), iStrideNorm, pvOffsetNorm);
 		}
 		else
 		{
@@ -1240,17 +2611,17 @@ bool COGLVertexList::Apply(COGLBaseElement::EApplyMode eMode, COGLBaseElement::S
 	else
 	{
 		glEnableClientState(GL_VERTEX_ARRAY);
-		glVertexPointer(3, GL_FLOAT, sizeof(SData), BUFFER_OFFSET(SData::iOffsetVex));
+		glVertexPointer(3, GL_FLOAT, iStrideVex, pvOffsetVex);
 
 		if (bUseColor)
 		{
 			glEnableClientState(GL_COLOR_ARRAY);
-			glColorPointer(4, GL_FLOAT, sizeof(SData), BUFFER_OFFSET(SData::iOffsetCol));
+			glColorPointer(4, eColType, iStrideCol, pvOffsetCol);
 		}
 		else if (bUsePartIdAsColor)
 		{
 			glEnableClientState(GL_COLOR_ARRAY);
-			glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(SData), BUFFER_OFFSET(SData::iOffsetPartId));
+			glColorPointer(4, GL_UNSIGNED_BYTE, iStridePartId, pvOffsetPartId);
 		}
 		else
 		{
@@ -1260,7 +2631,7 @@ bool COGLVertexList::Apply(COGLBaseElement::EApplyMode eMode, COGLBaseElement::S
 		if (bUseNorm)
 		{
 			glEnableClientState(GL_NORMAL_ARRAY);
-			glNormalPointer(GL_FLOAT, sizeof(SData), BUFFER_OFFSET(SData::iOffsetNorm));
+			glNormalPointer(eNormType, iStrideNorm, pvOffsetNorm);
 		}
 		else
 		{
@@ -1271,7 +2642,7 @@ bool COGLVertexList::Apply(COGLBaseElement::EApplyMode eMode, COGLBaseElement::S
 	if (bUsePartId && (glVertexAttribIPointer != nullptr))
 	{
 		glEnableVertexAttribArray(CLUGL_VAA_PARTID);
-		glVertexAttribIPointer(CLUGL_VAA_PARTID, 1, GL_INT, sizeof(SData), BUFFER_OFFSET(SData::iOffsetPartId));
+		glVertexAttribIPointer(CLUGL_VAA_PARTID, 1, GL_INT, iStridePartId, pvOffsetPartId);
 	}
 	else
 	{
@@ -1297,14 +2668,14 @@ bool COGLVertexList::Apply(COGLBaseElement::EApplyMode eMode, COGLBaseElement::S
 					}
 
 					glEnableVertexAttribArray(CLUGL_VAA_TEX0 + iUsedTexUnitIdx);
-					glVertexAttribPointer(CLUGL_VAA_TEX0 + iUsedTexUnitIdx, 3, GL_FLOAT, GL_TRUE, sizeof(SData), BUFFER_OFFSET(SData::iOffsetTex));
+					glVertexAttribPointer(CLUGL_VAA_TEX0 + iUsedTexUnitIdx, 3, GL_FLOAT, GL_TRUE, iStrideTex, pvOffsetTex);
 				}
 
 				// If there is a shader but no texture then still enable the texture coordinates
 				if ((uShaderID > 0) && (iUsedTexUnitCnt == 0))
 				{
 					glEnableVertexAttribArray(CLUGL_VAA_TEX0);
-					glVertexAttribPointer(CLUGL_VAA_TEX0, 3, GL_FLOAT, GL_TRUE, sizeof(SData), BUFFER_OFFSET(SData::iOffsetTex));
+					glVertexAttribPointer(CLUGL_VAA_TEX0, 3, GL_FLOAT, GL_TRUE, iStrideTex, pvOffsetTex);
 				}
 			}
 			else
@@ -1318,7 +2689,7 @@ bool COGLVertexList::Apply(COGLBaseElement::EApplyMode eMode, COGLBaseElement::S
 				}
 
 				glEnableVertexAttribArray(CLUGL_VAA_TEX0);
-				glVertexAttribPointer(CLUGL_VAA_TEX0, 3, GL_FLOAT, GL_TRUE, sizeof(SData), BUFFER_OFFSET(SData::iOffsetTex));
+				glVertexAttribPointer(CLUGL_VAA_TEX0, 3, GL_FLOAT, GL_TRUE, iStrideTex, pvOffsetTex);
 			}
 		}
 		else
@@ -1332,7 +2703,7 @@ bool COGLVertexList::Apply(COGLBaseElement::EApplyMode eMode, COGLBaseElement::S
 
 					glClientActiveTexture(GL_TEXTURE0 + iUsedTexUnitIdx);
 					glEnableClientState(GL_TEXTURE_COORD_ARRAY);
-					glTexCoordPointer(2, GL_FLOAT, sizeof(SData), BUFFER_OFFSET(SData::iOffsetTex));
+					glTexCoordPointer(2, GL_FLOAT, iStrideTex, pvOffsetTex);
 				}
 
 				// If there is a shader but no texture then still enable the texture coordinates
@@ -1340,14 +2711,14 @@ bool COGLVertexList::Apply(COGLBaseElement::EApplyMode eMode, COGLBaseElement::S
 				{
 					glClientActiveTexture(GL_TEXTURE0);
 					glEnableClientState(GL_TEXTURE_COORD_ARRAY);
-					glTexCoordPointer(2, GL_FLOAT, sizeof(SData), BUFFER_OFFSET(SData::iOffsetTex));
+					glTexCoordPointer(2, GL_FLOAT, iStrideTex, pvOffsetTex);
 				}
 			}
 			else
 			{
 				glEnable(GL_TEXTURE_2D);
 				glEnableClientState(GL_TEXTURE_COORD_ARRAY);
-				glTexCoordPointer(2, GL_FLOAT, sizeof(SData), BUFFER_OFFSET(SData::iOffsetTex));
+				glTexCoordPointer(2, GL_FLOAT, iStrideTex, pvOffsetTex);
 			}
 		}
 	}
@@ -39,6 +39,9 @@
 #include "OGLColor.h"
 #include "OGLBaseElement.h"
 #include "OGLBEReference.h"
+#include "OGLPickBVH.h"
+
+#include "CluTec.Viz.Base\SharedBuffer.h"
 
 #include "GL\GL.h"
 
@@ -81,6 +84,39 @@
 
 		typedef Mem<SData> TDataList;
 
+		// Storage layout of the vertex data on host and in the vertex buffer
+		enum ELayout
+		{
+			LAYOUT_INTERLEAVED = 0,	// All attributes of a vertex in one SData record
+			LAYOUT_SEPARATE			// A separate array for each attribute that is used
+		};
+
+		// Format of colors in separate layout
+		enum EColorFormat
+		{
+			COLFMT_FLOAT = 0,	// 4 floats; 16 bytes
+			COLFMT_RGBA8		// 4 normalized unsigned bytes; 4 bytes
+		};
+
+		// Format of normals in separate layout
+		enum ENormalFormat
+		{
+			NORMFMT_FLOAT = 0,	// 3 floats; 12 bytes
+			NORMFMT_SHORT		// 3 normalized signed shorts and padding; 8 bytes. Normals are stored with unit length.
+		};
+
+		enum EAttribute
+		{
+			ATTR_VEX = 0,
+			ATTR_TEX,
+			ATTR_NORM,
+			ATTR_COL,
+			ATTR_FOG,
+			ATTR_PARTID,
+			ATTR_EDGE,
+			ATTR_COUNT
+		};
+
 	public:
 
 		COGLVertexList();
@@ -98,10 +134,19 @@
 		{
 			m_mDataList.Set(0);
 			m_mIdxList.Set(0);
+			m_nSepCnt = 0;
+			for (int iAttr = 0; iAttr < ATTR_COUNT; ++iAttr)
+			{
+				m_pAttrib[iAttr].mData.Set(0);
+				m_pAttrib[iAttr].nModFirst = m_pAttrib[iAttr].nModEnd = 0;
+			}
+			m_nModFirst       = m_nModEnd = 0;
 			m_iVexCnt         = m_iNormCnt = m_iTexCnt = m_iColCnt = m_iEdgeCnt = m_iPartIdCnt = 0;
+			m_uSharedVexFrame = 0;
 			m_bVexModified    = true;
 			m_bIdxModified    = true;
 			m_bKeepDataOnHost = true;
+			_TouchGeometry();
 
 			m_matProjection.SetZero();
 			m_matModelView.SetZero();
@@ -150,9 +195,81 @@
 		bool SetIndexLists(const unsigned** const ppuIndexLists, const unsigned* const puIndexListLengths, unsigned uIndexListCount, unsigned puIndexBufferID);
 
 		// Reserve memory for the given number of vertices
-		bool Reserve(size_t iCnt) { return m_mDataList.Set(iCnt); }
+		bool Reserve(size_t iCnt);
 		// Reserve memory for the given number of vertices
-		bool ReserveAdd(int iCnt) { return m_mDataList.Add(iCnt); }
+		bool ReserveAdd(int iCnt) { return Reserve(_DataCount() + iCnt); }
+
+		/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// <summary>
+		/// 	Sets the storage layout. In separate layout each used attribute is stored in its own array, using the color and
+		/// 	normal formats set with SetColorFormat() and SetNormalFormat(). Existing data is converted. Note that accessing
+		/// 	the SData records via operator[] switches back to interleaved layout.
+		/// </summary>
+		///
+		/// <param name="eLayout"> The layout. </param>
+		/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		void SetLayout(ELayout eLayout);
+		ELayout GetLayout() const { return m_eLayout; }
+
+		// Set the storage formats used in separate layout. Existing data is converted.
+		void SetColorFormat(EColorFormat eFormat);
+		EColorFormat GetColorFormat() const { return m_eColFormat; }
+
+		void SetNormalFormat(ENormalFormat eFormat);
+		ENormalFormat GetNormalFormat() const { return m_eNormFormat; }
+
+		// Access single attributes in both layouts. Changing attributes this way
+		// only copies the modified range of the attribute to the vertex buffer.
+		bool SetVex(size_t nIdx, const COGLVertex& rVex);
+		bool SetTex(size_t nIdx, const COGLVertex& rTex);
+		bool SetNormal(size_t nIdx, const COGLVertex& rNorm);
+		bool SetCol(size_t nIdx, const TColor& rCol);
+		bool SetPartId(size_t nIdx, unsigned uPartId);
+
+		COGLVertex GetVex(size_t nIdx) const;
+		COGLVertex GetTex(size_t nIdx) const;
+		COGLVertex GetNormal(size_t nIdx) const;
+		TColor GetCol(size_t nIdx) const;
+		unsigned GetPartId(size_t nIdx) const;
+
+		// Mark a range of an attribute as modified. In interleaved layout the whole vertex records are marked.
+		void SetModified(EAttribute eAttr, size_t nFirst, size_t nCount);
+
+		// Number of bytes of vertex data stored on host
+		size_t GetHostDataSize() const;
+
+		// Number of bytes copied to the vertex buffer by the last call to Apply() that copied any data.
+		// Drawing the vertex list again without modifying it does not change this value.
+		size_t GetLastUploadSize() const { return m_nLastUploadSize; }
+
+		// Stamp that changes whenever vertices or indices may have been changed. Stamps are unique over all vertex lists.
+		unsigned GetGeometryStamp() const { return m_uGeoStamp; }
+
+		// Get the vertex and index data for a pick hierarchy. Returns false if the data is not kept on the host.
+		bool GetPickGeometry(COGLPickBVH::SGeometry& rGeo) const;
+
+		// Bounds of the vertices including the transformation of the vertex list. Vertex lists whose data is not kept on the host,
+		// that are instanced or that change the current color are not bounded.
+		virtual const SBoundInfo& GetBoundInfo();
+
+		/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// <summary>
+		/// 	Takes the vertex positions from a shared buffer with three components per vertex. Whenever the vertex list is
+		/// 	drawn, the newest frame published to the buffer is used. Float data is copied directly from the buffer to the
+		/// 	vertex buffer without a copy on the host. The vertex list switches to separate layout. Passing nullptr stops
+		/// 	using the buffer and keeps the current positions.
+		/// </summary>
+		///
+		/// <param name="pBuffer"> The shared buffer or nullptr. </param>
+		///
+		/// <returns> False if the number of elements of the buffer is not a multiple of three. </returns>
+		/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		bool SetSharedVexSource(CSharedBuffer* pBuffer);
+		CSharedBuffer* GetSharedVexSource() const { return m_pSharedVex; }
+
+		// Takes over the newest frame of the shared vertex buffer, as is done when drawing.
+		// Vertices read from the vertex list afterwards are those of this frame.
+		void UpdateSharedVex() { _UpdateSharedVex(); }
 
 		/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 		/// <summary>
@@ -175,6 +292,7 @@
 		void EnableKeepDataOnHost(bool bEnable)
 		{
 			m_bKeepDataOnHost = bEnable;
+			_TouchBounds();
 		}
 
 		int GetVexCount() { return m_iVexCnt; }
@@ -184,12 +302,12 @@
 		int GetEdgeCount() { return m_iEdgeCnt; }
 
 		// Update internal normal count, so that normals are drawn
-		void UpdateNormCount() { m_iNormCnt = int(m_mDataList.Count()); }
-		void UpdateVexCount() { m_iVexCnt = int(m_mDataList.Count()); }
-		void UpdateTexCount() { m_iTexCnt = int(m_mDataList.Count()); }
-		void UpdateColCount() { m_iColCnt = int(m_mDataList.Count()); }
-		void UpdateEdgeCount() { m_iEdgeCnt = int(m_mDataList.Count()); }
-		void UpdatePartIdCount() { m_iPartIdCnt = int(m_mDataList.Count()); }
+		void UpdateNormCount() { m_iNormCnt = int(_DataCount()); }
+		void UpdateVexCount() { m_iVexCnt = int(_DataCount()); }
+		void UpdateTexCount() { m_iTexCnt = int(_DataCount()); }
+		void UpdateColCount() { m_iColCnt = int(_DataCount()); }
+		void UpdateEdgeCount() { m_iEdgeCnt = int(_DataCount()); }
+		void UpdatePartIdCount() { m_iPartIdCnt = int(_DataCount()); }
 
 		COGLVertexList& operator<<(const COGLVertex& rVex)
 		{ AddVex(rVex); return *this; }
@@ -203,11 +321,22 @@
 		COGLVertexList& operator<<(GLenum eMode)
 		{ SetMode(eMode); return *this; }
 
-		SData& operator[](size_t i) { m_bVexModified = true; return m_mDataList[i]; }
+		SData& operator[](size_t i)
+		{
+			if (m_eLayout != LAYOUT_INTERLEAVED)
+			{
+				SetLayout(LAYOUT_INTERLEAVED);
+			}
+
+			m_bVexModified = true;
+			_TouchGeometry();
+			return m_mDataList[i];
+		}
+
 		//COGLVertex& GetTex(int iPos) { return m_mDataList[(uint)iPos].xTex; }
 		//COGLVertex& GetNormal(int iPos) { return m_mDataList[(uint)iPos].xNorm; }
 		//TColor& GetColor(int iPos) { return m_mColList[(uint)iPos]; }
-		unsigned& GetIndex(int iList, int iPos) { m_bIdxModified = true; return m_mIdxList[(uint) iList][(uint) iPos]; }
+		unsigned& GetIndex(int iList, int iPos) { m_bIdxModified = true; _TouchGeometry(); return m_mIdxList[(uint) iList][(uint) iPos]; }
 
 		bool AddVex(const COGLVertex& rVex);
 		bool AddVex(const float* pfVex);
@@ -248,7 +377,7 @@
 		void InvertNormals(float fFac = 1.0f);
 
 		void EnableScaleBackColor(bool bVal = true)
-		{ m_bScaleBackColor = bVal; }
+		{ m_bScaleBackColor = bVal; _TouchBounds(); }
 
 		bool UseScaleBackColor()
 		{ return m_bScaleBackColor; }
@@ -272,7 +401,7 @@
 		{ iFactor = m_iLineStippleFactor; iPattern = m_iLineStipplePattern; }
 
 		void EnableOverrideAlpha(bool bVal = true)
-		{ m_bOverrideAlpha = bVal; }
+		{ m_bOverrideAlpha = bVal; _TouchBounds(); }
 
 		bool UseOverrideAlpha()
 		{ return m_bOverrideAlpha; }
@@ -284,34 +413,34 @@
 		{ fValue = m_fOverrideAlphaValue; }
 
 		void EnableTransform(bool bVal = true)
-		{ m_bUseTransform = bVal; }
+		{ m_bUseTransform = bVal; _TouchBounds(); }
 
 		bool UseTransform()
 		{ return m_bUseTransform; }
 
 		void SetTranslation1(const COGLVertex& rVex)
-		{ m_vexTrans1 = rVex; }
+		{ m_vexTrans1 = rVex; _TouchBounds(); }
 
 		void GetTranslation1(COGLVertex& rVex)
 		{ rVex = m_vexTrans1; }
 
 		void SetTranslation2(const COGLVertex& rVex)
-		{ m_vexTrans2 = rVex; }
+		{ m_vexTrans2 = rVex; _TouchBounds(); }
 
 		void GetTranslation2(COGLVertex& rVex)
 		{ rVex = m_vexTrans2; }
 
 		void SetRotation(float fAngle, const COGLVertex& rAxis)
-		{ m_fRotAngle = fAngle; m_vexRotAxis = rAxis; }
+		{ m_fRotAngle = fAngle; m_vexRotAxis = rAxis; _TouchBounds(); }
 
 		void GetRotation(float& fAngle, COGLVertex& rAxis)
 		{ fAngle = m_fRotAngle; rAxis = m_vexRotAxis; }
 
 		void EnableScaling(bool bVal = true)
-		{ m_bUseScaling = bVal; }
+		{ m_bUseScaling = bVal; _TouchBounds(); }
 
 		void SetScaling(const COGLVertex& rVex)
-		{ m_vexScale = rVex; }
+		{ m_vexScale = rVex; _TouchBounds(); }
 
 		bool UseScaling()
 		{ return m_bUseScaling; }
@@ -320,13 +449,13 @@
 		{ rVex = m_vexScale; }
 
 		void EnableGenTransform(bool bVal = true)
-		{ m_bUseGenTransform = bVal; }
+		{ m_bUseGenTransform = bVal; _TouchBounds(); }
 
 		bool UseGenTransform()
 		{ return m_bUseGenTransform; }
 
 		void SetGenTransformMatrix(const Matrix<float>& matTrans)
-		{ m_matTrans = matTrans; m_matTrans = ~m_matTrans; }
+		{ m_matTrans = matTrans; m_matTrans = ~m_matTrans; _TouchBounds(); }
 
 		void GetGenTransformMatrix(Matrix<float>& matTrans)
 		{ matTrans = m_matTrans; matTrans = ~matTrans; }
@@ -358,6 +487,7 @@
 		void SetInstanceCount(int iCount)
 		{
 			m_iInstanceCount = iCount;
+			_TouchBounds();
 		}
 
 		int GetInstanceCount()
@@ -372,22 +502,70 @@
 		//TVexList& GetNormList() { return m_mNormalList; }
 		//TVexList& GetTexList() { return m_mTexList; }
 		//TColList& GetColList() { return m_mColList; }
-		TIdxList& GetIdxList() { m_bIdxModified = true; return m_mIdxList; }
+		TIdxList& GetIdxList() { m_bIdxModified = true; _TouchGeometry(); return m_mIdxList; }
 
 		//Set / Get the VertexBuffer ID
 		unsigned GetVertexBufferID() { return m_uVexBufID; };
-		void SetVertexBufferID(unsigned int uVboID) { m_uVexBufID = uVboID; };
+		void SetVertexBufferID(unsigned int uVboID) { m_uVexBufID = uVboID; _TouchBounds(); };
 
 	protected:
 
 		void AdjustDataListSize()
 		{
 			int iCnt = std::max(std::max(std::max(std::max(std::max(m_iVexCnt, m_iNormCnt), m_iTexCnt), m_iColCnt), m_iEdgeCnt), m_iPartIdCnt);
-			m_mDataList.Set(iCnt);
+
+			if (m_eLayout == LAYOUT_INTERLEAVED)
+			{
+				m_mDataList.Set(iCnt);
+			}
+			else
+			{
+				m_nSepCnt = size_t(iCnt);
+			}
 		}
 
-		void _LoadMatrixProjection();
-		void _LoadMatrixModelView();
+		// Number of vertex records. Corresponds to the size of m_mDataList in interleaved layout.
+		size_t _DataCount() const
+		{
+			return (m_eLayout == LAYOUT_INTERLEAVED ? m_mDataList.Count() : m_nSepCnt);
+		}
+
+		// Functions for separate layout
+		bool _IsAttribUsed(EAttribute eAttr) const;
+		size_t _AttribElSize(EAttribute eAttr) const;
+		unsigned _UsedAttribMask() const;
+		bool _EnsureAttrib(EAttribute eAttr, size_t nCnt);
+		bool _AddAttrib(EAttribute eAttr, int& iCnt, const void* pvVal);
+		bool _AddAttribRange(EAttribute eAttr, int& iCnt, const void* pvVal, size_t nValCnt, size_t nValStride);
+		void _PackAttrib(EAttribute eAttr, size_t nIdx, const void* pvVal);
+		void _UnpackAttrib(EAttribute eAttr, size_t nIdx, void* pvVal) const;
+		bool _SetAttrib(EAttribute eAttr, size_t nIdx, const void* pvVal);
+		void _GetAttrib(EAttribute eAttr, size_t nIdx, void* pvVal) const;
+		void _SetAttribFormat(EAttribute eAttr, int iFormat);
+		void _CopyVertexData(const COGLVertexList& rVexList);
+
+		// Take over a new frame of the shared vertex buffer
+		void _UpdateSharedVex();
+		// Host data of an attribute that is copied to the vertex buffer
+		const GLubyte* _AttribUploadData(EAttribute eAttr) const;
+		// Number of elements of an attribute available on host
+		size_t _AttribHostCount(EAttribute eAttr) const;
+
+		// Copy modified vertex data to vertex buffer
+		void _UpdateVertexBuffer();
+		void _GetAttribPointer(EAttribute eAttr, GLsizei& iStride, const GLvoid*& pvOffset) const;
+
+		void _LoadMatrixProjection(Clu::CMatrixStack& rStack);
+		void _LoadMatrixModelView(Clu::CMatrixStack& rStack);
+
+		// Set a new geometry stamp
+		void _TouchGeometry();
+
+		// Invalidate the bounds of this vertex list and of its parents
+		void _TouchBounds();
+
+		// Add this vertex list with the current model view matrix to the pick hierarchy in rData
+		void _UpdatePickBVH(COGLBaseElement::SApplyData& rData);
 
 	protected:
 
@@ -403,6 +581,42 @@
 		TDataList m_mDataList;
 		int m_iVexCnt, m_iNormCnt, m_iTexCnt, m_iColCnt, m_iEdgeCnt, m_iPartIdCnt;
 
+		struct SAttrib
+		{
+			// Host data of attribute in separate layout
+			Mem<GLubyte> mData;
+			// Number of bytes per element
+			size_t nElSize;
+			// Offset of attribute block in vertex buffer
+			size_t nBufOffset;
+			// Range of elements that have been modified since the last upload
+			size_t nModFirst, nModEnd;
+		};
+
+		ELayout m_eLayout;
+		EColorFormat m_eColFormat;
+		ENormalFormat m_eNormFormat;
+
+		// Number of vertex records in separate layout
+		size_t m_nSepCnt;
+		SAttrib m_pAttrib[ATTR_COUNT];
+
+		// Range of modified vertex records in interleaved layout
+		size_t m_nModFirst, m_nModEnd;
+
+		// Number of vertices and mask of attributes currently stored in vertex buffer
+		size_t m_nBufVexCnt;
+		unsigned m_uBufAttribMask;
+
+		// Number of bytes copied to vertex buffer in last call to Apply() that copied any data
+		size_t m_nLastUploadSize;
+
+		// Shared buffer vertex positions are taken from, its frame currently used,
+		// and whether the positions are copied directly from the float data of the buffer.
+		CSharedBuffer* m_pSharedVex;
+		unsigned m_uSharedVexFrame;
+		bool m_bSharedVexDirect;
+
 		// ID of buffer object used by vertex list
 		unsigned m_uVexBufID;
 		unsigned m_uIdxBufID;
@@ -410,6 +624,13 @@
 		bool m_bVexModified;
 		bool m_bIdxModified;
 
+		// Geometry stamp
+		unsigned m_uGeoStamp;
+
+		// Cached bounds
+		SBoundInfo m_xBoundInfo;
+		bool m_bBoundInfoValid;
+
 		TIdxList m_mIdxList;
 		// These two arrays are used to store information for
 		// glMultiDrawElements calls.
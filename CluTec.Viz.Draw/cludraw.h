@@ -109,6 +109,7 @@
 #include "OGLObjColorCube.h"
 //#include "OGLObjWireSphere.h"
 #include "OGLDisplayList.h"
+#include "OGLInstanceBatch.h"
 
 #include "OGLBaseElement.h"
 #include "OGLBaseElementList.h"
@@ -41,6 +41,7 @@
 #include"bladelist.cxx"
 #include"mvs.cxx"
 #include"multiv.cxx"
+#include"mvbatch.cxx"
 
 
 
@@ -38,6 +38,7 @@
 #include "bladelist.h"
 #include "mvs.h"
 #include "multiv.h"
+#include "mvbatch.h"
 #include "MVInfo.h"
 
 #endif
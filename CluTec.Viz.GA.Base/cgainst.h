@@ -311,5 +311,9 @@ CLUGA_EXT template CLUGA_API MultiV<TYPE> Meet(const MultiV<TYPE>& mvA,const Mul
 CLUGA_EXT template CLUGA_API MultiV<TYPE> Meet(const MultiV<TYPE>& mvA,const MultiV<TYPE>& mvB, \
 							const MultiV<TYPE>& vNegDim, TYPE dPrec);\
 \
+CLUGA_EXT template CLUGA_API bool ApplyVersor(const MultiV<TYPE>& vR, const MultiVBatch<TYPE>& mbX, MultiVBatch<TYPE>& mbY);\
+CLUGA_EXT template CLUGA_API bool ApplyProd(const MultiV<TYPE>& vA, EMVOpType eOpType, tMVPos ePos, \
+							const MultiVBatch<TYPE>& mbX, MultiVBatch<TYPE>& mbY);\
+\
 
 #endif
@@ -40,7 +40,7 @@ MultiV<CType>::MultiV(const MultiVStyle<CType>& nstyle, CType ncomps[])
 {
 	m_pStyle = const_cast<MultiVStyle<CType>*>(&nstyle);
 	m_uGADim = m_pStyle->GADim();
-	m_csStr  = "";
+	m_pcsStr = 0;
 
 	if (m_mData.Set(m_uGADim))
 	{
@@ -63,7 +63,7 @@ MultiV<CType>::MultiV()
 {
 	m_pStyle = 0;
 	m_uGADim = 0;
-	m_csStr  = "";
+	m_pcsStr = 0;
 	m_mData.Set(0);
 }
 
@@ -76,7 +76,7 @@ MultiV<CType>::MultiV(const MultiV<CType>& a)
 	m_pStyle = a.m_pStyle;
 	m_uGADim = a.m_uGADim;
 	m_mData  = a.m_mData;
-	m_csStr  = "";
+	m_pcsStr = 0;
 }
 
 ////////////////////////////////////////////////////////////////////////////////////
@@ -85,6 +85,7 @@ MultiV<CType>::MultiV(const MultiV<CType>& a)
 template<class CType>
 MultiV<CType>::~MultiV()
 {
+	delete m_pcsStr;
 }
 
 ////////////////////////////////////////////////////////////////////////////////////
@@ -95,7 +96,6 @@ void MultiV<CType>::SetStyle(const MultiVStyle<CType>& nstyle)
 {
 	m_pStyle = const_cast<MultiVStyle<CType>*>(&nstyle);
 	m_uGADim = m_pStyle->GADim();
-	m_csStr  = "";
 
 	if (m_mData.Set(m_uGADim))
 	{
@@ -957,16 +957,101 @@ bool MultiV<CType>::MTProd(const Mem<CType>& mA, const Mem<CType>& mB, short* pi
 	return true;
 }
 
+////////////////////////////////////////////////////////////////////////////////////
+/// Product with sparse product plan
+///
+/// Gives the same result as MTProd with the product table the plan was made from.
+
+template<class CType>
+bool MultiV<CType>::MTProd(const Mem<CType>& mA, const Mem<CType>& mB, const CProdPlan<CType>& rPlan)
+{
+	CType dA, dB;
+	const CType* pAData, * pBData;
+	CType* pCData;
+	pAData = mA.Data();
+	pBData = mB.Data();
+	pCData = m_mData.Data();
+
+	const typename CProdPlan<CType>::SRow* pRow = rPlan.m_vecRow.empty() ? 0 : &rPlan.m_vecRow[0];
+	const typename CProdPlan<CType>::SEntry* pEntry = rPlan.m_vecEntry.empty() ? 0 : &rPlan.m_vecEntry[0];
+	const typename CProdPlan<CType>::SEntry* pEl, * pElEnd;
+	size_t uRow, uRowCnt = rPlan.m_vecRow.size();
+
+	for (uRow = 0; uRow < uRowCnt; ++uRow, ++pRow)
+	{
+		dA = pAData[pRow->uA];
+		if (dA != CType(0))
+		{
+			pEl    = pEntry + pRow->uFirst;
+			pElEnd = pEl + pRow->uCount;
+
+			// Zero components of B are skipped as in the dense product,
+			// so that inf or nan in A times zero does not give nan.
+			for (; pEl != pElEnd; ++pEl)
+			{
+				dB = pBData[pEl->uB];
+				if (dB != CType(0))
+				{
+					pCData[pEl->uC] += pEl->dSign * dA * dB;
+				}
+			}
+		}
+	}
+
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+/// Grade mask of multivector
+
+template<class CType>
+uint MultiV<CType>::GradeMask() const
+{
+	uint i, uMask = 0;
+	short* piGrades = m_pStyle->Grades();
+	const CType* pData = m_mData.Data();
+
+	for (i = 0; i < m_uGADim; i++)
+	{
+		if (pData[i] != CType(0))
+		{
+			uMask |= 1 << piGrades[i];
+		}
+	}
+
+	return uMask;
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+/// Product of two multivectors
+
+template<class CType>
+bool MultiV<CType>::Prod(const MultiV<CType>& vA, const MultiV<CType>& vB, typename MultiVStyle<CType>::EProdTableID eTable)
+{
+	const CProdPlan<CType>* pPlan = 0;
+
+	if (IsProdPlanEnabled() && vA.m_uGADim == m_uGADim && vB.m_uGADim == m_uGADim)
+	{
+		pPlan = m_pStyle->GetProdPlan(eTable, vA.GradeMask(), vB.GradeMask());
+	}
+
+	if (pPlan)
+	{
+		return MTProd(vA.m_mData, vB.m_mData, *pPlan);
+	}
+
+	return MTProd(vA.m_mData, vB.m_mData, m_pStyle->ProdTable(eTable));
+}
+
 ////////////////////////////////////////////////////////////////////////////////////
 // Geometric Product of two Multi Vectors
 
 template<class CType>
 MultiV<CType> operator&(const MultiV<CType>& a, const MultiV<CType>& b)
 {
-	short* piTable = a.m_pStyle->GPTable();
 	MultiV<CType> c(a.m_pStyle[0]);
 
-	c.MTProd(a.m_mData, b.m_mData, piTable);
+	c.Prod(a, b, MultiVStyle<CType>::PTID_GP);
 
 	return c;
 }
@@ -977,10 +1062,9 @@ MultiV<CType> operator&(const MultiV<CType>& a, const MultiV<CType>& b)
 template<class CType>
 MultiV<CType>& operator&=(MultiV<CType>& a, const MultiV<CType>& b)
 {
-	short* piTable = a.m_pStyle->GPTable();
 	MultiV<CType> c(*a.m_pStyle);
 
-	c.MTProd(a.m_mData, b.m_mData, piTable);
+	c.Prod(a, b, MultiVStyle<CType>::PTID_GP);
 
 	a = c;
 	return a;
@@ -992,10 +1076,9 @@ MultiV<CType>& operator&=(MultiV<CType>& a, const MultiV<CType>& b)
 template<class CType>
 MultiV<CType> operator*(const MultiV<CType>& a, const MultiV<CType>& b)
 {
-	short* piTable = a.m_pStyle->IPTable();
 	MultiV<CType> c(a.m_pStyle[0]);
 
-	c.MTProd(a.m_mData, b.m_mData, piTable);
+	c.Prod(a, b, MultiVStyle<CType>::PTID_IP);
 
 	return c;
 }
@@ -1006,10 +1089,9 @@ MultiV<CType> operator*(const MultiV<CType>& a, const MultiV<CType>& b)
 template<class CType>
 MultiV<CType>& operator*=(MultiV<CType>& a, const MultiV<CType>& b)
 {
-	short* piTable = a.m_pStyle->IPTable();
 	MultiV<CType> c(a.m_pStyle[0]);
 
-	c.MTProd(a.m_mData, b.m_mData, piTable);
+	c.Prod(a, b, MultiVStyle<CType>::PTID_IP);
 
 	a = c;
 	return a;
@@ -1021,10 +1103,9 @@ MultiV<CType>& operator*=(MultiV<CType>& a, const MultiV<CType>& b)
 template<class CType>
 MultiV<CType> operator^(const MultiV<CType>& a, const MultiV<CType>& b)
 {
-	short* piTable = a.m_pStyle->OPTable();
 	MultiV<CType> c(a.m_pStyle[0]);
 
-	c.MTProd(a.m_mData, b.m_mData, piTable);
+	c.Prod(a, b, MultiVStyle<CType>::PTID_OP);
 
 	return c;
 }
@@ -1035,10 +1116,9 @@ MultiV<CType> operator^(const MultiV<CType>& a, const MultiV<CType>& b)
 template<class CType>
 MultiV<CType>& operator^=(MultiV<CType>& a, const MultiV<CType>& b)
 {
-	short* piTable = a.m_pStyle->OPTable();
 	MultiV<CType> c(a.m_pStyle[0]);
 
-	c.MTProd(a.m_mData, b.m_mData, piTable);
+	c.Prod(a, b, MultiVStyle<CType>::PTID_OP);
 
 	a = c;
 	return a;
@@ -1323,14 +1403,22 @@ char* MultiV<CType>::Str(int strstyle)
 	int isfirst = 1;
 	CStrMem hstr;
 
-	m_csStr = "[";
+	// String memory is only allocated when it is needed
+	if (!m_pcsStr)
+	{
+		m_pcsStr = new CStrMem;
+	}
+
+	CStrMem& rStr = *m_pcsStr;
+
+	rStr = "[";
 
 	if (strstyle == MVS_LIST)
 	{
 		for (i = 0; i < m_uGADim; i++)
 		{
-			m_csStr << MakeStr(CType(m_mData[i]));
-			if (i + 1 < m_uGADim) { m_csStr << ","; }
+			rStr << MakeStr(CType(m_mData[i]));
+			if (i + 1 < m_uGADim) { rStr << ","; }
 		}
 	}
 	else if (strstyle == MVS_SUM)
@@ -1341,28 +1429,28 @@ char* MultiV<CType>::Str(int strstyle)
 			{
 				if (isfirst)
 				{
-					m_csStr << " ";
+					rStr << " ";
 					isfirst = 0;
 				}
-				else{ m_csStr << "+ "; }
-				m_csStr << MakeStr(CType(m_mData[i]));
+				else{ rStr << "+ "; }
+				rStr << MakeStr(CType(m_mData[i]));
 				if (i > 0)
 				{
-					m_csStr << "^";
+					rStr << "^";
 					hstr = m_pStyle->BladeName(i);
 					if ((j = uint('^' < hstr)))
 					{
-						m_csStr << hstr.Last(int(hstr.Len() - j));
+						rStr << hstr.Last(int(hstr.Len() - j));
 					}
 				}
-				m_csStr << " ";
+				rStr << " ";
 			}
 		}
 	}
 
-	m_csStr << "]";
+	rStr << "]";
 
-	return m_csStr;
+	return rStr;
 }
 
 ////////////////////////////////////////////////////////////////////////////////////
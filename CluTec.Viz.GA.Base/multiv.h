@@ -44,6 +44,10 @@
 		#define _MAXSTRSIZE_ 1024	// Maximum String Size for String output
 #endif
 
+#ifndef _MULTIV_INLINE_DIM_
+		#define _MULTIV_INLINE_DIM_ 32	// Max. number of components stored without heap allocation
+#endif
+
 #ifdef _GNUCPP3_
     #ifndef _TMPL_
 			#define _TMPL_ <>
@@ -286,6 +290,14 @@
 		//_FRIEND_ CType Scalar _TMPL_(const MultiV<CType> &);
 
 		bool MTProd(const Mem<CType>& mA, const Mem<CType>& mB, short* piTable);
+		bool MTProd(const Mem<CType>& mA, const Mem<CType>& mB, const CProdPlan<CType>& rPlan);
+
+		// Evaluates the product of vA and vB given by the product table eTable of the style
+		// of this multivector. Uses a sparse product plan if possible. This multivector has to be zero.
+		bool Prod(const MultiV<CType>& vA, const MultiV<CType>& vB, typename MultiVStyle<CType>::EProdTableID eTable);
+
+		// Returns mask where bit g is set if multivector has non-zero components of grade g.
+		uint GradeMask() const;
 /*
         _FRIEND_ bool GradeList _TMPL_(const MultiV<CType> &mvA, Mem<uint> &mList, CType dPrec);
 
@@ -491,9 +503,11 @@
 
 //protected:
 		MultiVStyle<CType>* m_pStyle;
-		Mem<CType> m_mData;
+		// Components are stored inside the instance up to dimension 32, which covers
+		// E3GA, PGA and ConfGA. Only larger algebras allocate heap memory.
+		MemInline<CType, _MULTIV_INLINE_DIM_> m_mData;
 		uint m_uGADim;
-		CStrMem m_csStr;
+		CStrMem* m_pcsStr;	// Created by Str()
 	};
 
 #endif	// _MULTIV_H_
@@ -0,0 +1,478 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// project:   CluTec.Viz.GA.Base
+// file:      mvbatch.cxx
+//
+// summary:   multivector batch class
+//
+//            Copyright (c) 2019 by Christian Perwass.
+//
+//            This file is part of the CluTecLib library.
+//
+//            The CluTecLib library is free software: you can redistribute it and / or modify
+//            it under the terms of the GNU Lesser General Public License as published by
+//            the Free Software Foundation, either version 3 of the License, or
+//            (at your option) any later version.
+//
+//            The CluTecLib library is distributed in the hope that it will be useful,
+//            but WITHOUT ANY WARRANTY; without even the implied warranty of
+//            MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//            GNU Lesser General Public License for more details.
+//
+//            You should have received a copy of the GNU Lesser General Public License
+//            along with the CluTecLib library.
+//            If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+//  Batch processing of multivectors
+
+#include "mvbatch.h"
+
+// SIMD instruction sets used by the batch kernels
+#if defined(__AVX__)
+	#define MVBATCH_USE_AVX
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+	#define MVBATCH_USE_SSE2
+#endif
+
+#if defined(MVBATCH_USE_AVX)
+	#include <immintrin.h>
+#elif defined(MVBATCH_USE_SSE2)
+	#include <emmintrin.h>
+#endif
+
+////////////////////////////////////////////////////////////////////////////////////
+// Linear map kernel
+//
+// Evaluates for all n < nCount and r < uRows
+//   pOut[r * nOutStride + n] = sum_c pMat[r * uCols + c] * pIn[c * nInStride + n]
+
+template<class CType>
+void MultiVBatchLinMap(const CType* pMat, uint uRows, uint uCols, const CType* pIn, size_t nInStride, CType* pOut, size_t nOutStride, size_t nCount)
+{
+	size_t n;
+	uint r, c;
+	CType dSum;
+
+	for (n = 0; n < nCount; ++n)
+	{
+		for (r = 0; r < uRows; ++r)
+		{
+			const CType* pRow = pMat + r * uCols;
+
+			dSum = CType(0);
+			for (c = 0; c < uCols; ++c)
+			{
+				dSum += pRow[c] * pIn[c * nInStride + n];
+			}
+
+			pOut[r * nOutStride + n] = dSum;
+		}
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// Linear map kernel for double values
+
+template<>
+inline void MultiVBatchLinMap<double>(const double* pMat, uint uRows, uint uCols, const double* pIn, size_t nInStride, double* pOut, size_t nOutStride, size_t nCount)
+{
+	size_t n = 0;
+	uint r, c;
+
+#if defined(MVBATCH_USE_AVX)
+	for (; n + 4 <= nCount; n += 4)
+	{
+		for (r = 0; r < uRows; ++r)
+		{
+			const double* pRow = pMat + r * uCols;
+			__m256d vSum = _mm256_setzero_pd();
+
+			for (c = 0; c < uCols; ++c)
+			{
+				vSum = _mm256_add_pd(vSum, _mm256_mul_pd(_mm256_set1_pd(pRow[c]), _mm256_loadu_pd(pIn + c * nInStride + n)));
+			}
+
+			_mm256_storeu_pd(pOut + r * nOutStride + n, vSum);
+		}
+	}
+#endif
+
+#if defined(MVBATCH_USE_SSE2)
+	for (; n + 2 <= nCount; n += 2)
+	{
+		for (r = 0; r < uRows; ++r)
+		{
+			const double* pRow = pMat + r * uCols;
+			__m128d vSum = _mm_setzero_pd();
+
+			for (c = 0; c < uCols; ++c)
+			{
+				vSum = _mm_add_pd(vSum, _mm_mul_pd(_mm_set1_pd(pRow[c]), _mm_loadu_pd(pIn + c * nInStride + n)));
+			}
+
+			_mm_storeu_pd(pOut + r * nOutStride + n, vSum);
+		}
+	}
+#endif
+
+	// Remaining elements
+	for (; n < nCount; ++n)
+	{
+		for (r = 0; r < uRows; ++r)
+		{
+			const double* pRow = pMat + r * uCols;
+			double dSum = 0.0;
+
+			for (c = 0; c < uCols; ++c)
+			{
+				dSum += pRow[c] * pIn[c * nInStride + n];
+			}
+
+			pOut[r * nOutStride + n] = dSum;
+		}
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// Linear map kernel for float values
+
+template<>
+inline void MultiVBatchLinMap<float>(const float* pMat, uint uRows, uint uCols, const float* pIn, size_t nInStride, float* pOut, size_t nOutStride, size_t nCount)
+{
+	size_t n = 0;
+	uint r, c;
+
+#if defined(MVBATCH_USE_AVX)
+	for (; n + 8 <= nCount; n += 8)
+	{
+		for (r = 0; r < uRows; ++r)
+		{
+			const float* pRow = pMat + r * uCols;
+			__m256 vSum = _mm256_setzero_ps();
+
+			for (c = 0; c < uCols; ++c)
+			{
+				vSum = _mm256_add_ps(vSum, _mm256_mul_ps(_mm256_set1_ps(pRow[c]), _mm256_loadu_ps(pIn + c * nInStride + n)));
+			}
+
+			_mm256_storeu_ps(pOut + r * nOutStride + n, vSum);
+		}
+	}
+#endif
+
+#if defined(MVBATCH_USE_SSE2)
+	for (; n + 4 <= nCount; n += 4)
+	{
+		for (r = 0; r < uRows; ++r)
+		{
+			const float* pRow = pMat + r * uCols;
+			__m128 vSum = _mm_setzero_ps();
+
+			for (c = 0; c < uCols; ++c)
+			{
+				vSum = _mm_add_ps(vSum, _mm_mul_ps(_mm_set1_ps(pRow[c]), _mm_loadu_ps(pIn + c * nInStride + n)));
+			}
+
+			_mm_storeu_ps(pOut + r * nOutStride + n, vSum);
+		}
+	}
+#endif
+
+	// Remaining elements
+	for (; n < nCount; ++n)
+	{
+		for (r = 0; r < uRows; ++r)
+		{
+			const float* pRow = pMat + r * uCols;
+			float fSum = 0.0f;
+
+			for (c = 0; c < uCols; ++c)
+			{
+				fSum += pRow[c] * pIn[c * nInStride + n];
+			}
+
+			pOut[r * nOutStride + n] = fSum;
+		}
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// Apply linear map to batch
+//
+// mvCol contains for each stored component of mbX the image of the
+// corresponding basis blade. The result batch mbY stores the components
+// of the grades given by uGradeMask.
+
+template<class CType>
+bool MultiVBatchApplyMap(const MemObj<MultiV<CType> >& mvCol, uint uGradeMask, const MultiVBatch<CType>& mbX, MultiVBatch<CType>& mbY)
+{
+	if (&mbX == &mbY)
+	{
+		MultiVBatch<CType> mbTemp;
+
+		if (!MultiVBatchApplyMap(mvCol, uGradeMask, mbX, mbTemp))
+		{
+			return false;
+		}
+
+		mbY = mbTemp;
+		return true;
+	}
+
+	uint r, c;
+	uint uCols = mbX.CompCount();
+
+	if (!mbX.GetStylePtr() || (uint(mvCol.Count()) != uCols))
+	{
+		return false;
+	}
+
+	if (!mbY.Create(*mbX.GetStylePtr(), uGradeMask, mbX.Count()))
+	{
+		return false;
+	}
+
+	uint uRows = mbY.CompCount();
+	Mem<CType> mMat;
+
+	if (!mMat.Set(uRows * uCols))
+	{
+		return false;
+	}
+
+	for (r = 0; r < uRows; ++r)
+	{
+		for (c = 0; c < uCols; ++c)
+		{
+			mMat[r * uCols + c] = mvCol[c][mbY.CompIdx(r)];
+		}
+	}
+
+	if (uRows > 0 && uCols > 0)
+	{
+		MultiVBatchLinMap(mMat.Data(), uRows, uCols, mbX.CompData(0), mbX.Stride(), mbY.CompData(0), mbY.Stride(), mbX.Count());
+	}
+
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// Apply versor to batch
+//
+// Evaluates vR & X & ~vR for all multivectors X in mbX. mbY stores all grades
+// that can be non-zero. For a versor these are the grades of mbX, but vR may
+// also be any other multivector.
+
+template<class CType>
+bool ApplyVersor(const MultiV<CType>& vR, const MultiVBatch<CType>& mbX, MultiVBatch<CType>& mbY)
+{
+	uint c, uCols = mbX.CompCount();
+	uint uGradeMask = 0;
+
+	if (!mbX.GetStylePtr() || (vR.m_uGADim != mbX.GetStylePtr()->GADim()))
+	{
+		return false;
+	}
+
+	MultiV<CType> vRev = ~vR;
+	MultiV<CType> vE(*mbX.GetStylePtr());
+	MemObj<MultiV<CType> > mvCol;
+
+	mvCol.Set(uCols);
+
+	for (c = 0; c < uCols; ++c)
+	{
+		vE[mbX.CompIdx(c)] = CType(1);
+		mvCol[c]           = (vR & vE) & vRev;
+		vE[mbX.CompIdx(c)] = CType(0);
+		uGradeMask        |= mvCol[c].GradeMask();
+	}
+
+	return MultiVBatchApplyMap(mvCol, uGradeMask, mbX, mbY);
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// Apply product to batch
+//
+// Evaluates vA op X if ePos == Left, or X op vA if ePos == Right, for all
+// multivectors X in mbX, where op is the geometric, inner or outer product.
+// mbY stores all grades that can be non-zero.
+
+template<class CType>
+bool ApplyProd(const MultiV<CType>& vA, EMVOpType eOpType, tMVPos ePos, const MultiVBatch<CType>& mbX, MultiVBatch<CType>& mbY)
+{
+	uint c, uCols = mbX.CompCount();
+	uint uGradeMask = 0;
+
+	if (!mbX.GetStylePtr() || (vA.m_uGADim != mbX.GetStylePtr()->GADim()))
+	{
+		return false;
+	}
+
+	MultiV<CType> vE(*mbX.GetStylePtr());
+	MemObj<MultiV<CType> > mvCol;
+
+	mvCol.Set(uCols);
+
+	for (c = 0; c < uCols; ++c)
+	{
+		vE[mbX.CompIdx(c)] = CType(1);
+
+		switch (eOpType)
+		{
+		case MVOP_GEO:
+			mvCol[c] = (ePos == Left ? (vA & vE) : (vE & vA));
+			break;
+
+		case MVOP_INNER:
+			mvCol[c] = (ePos == Left ? (vA * vE) : (vE * vA));
+			break;
+
+		case MVOP_OUTER:
+			mvCol[c] = (ePos == Left ? (vA ^ vE) : (vE ^ vA));
+			break;
+
+		default:
+			return false;
+		}
+
+		vE[mbX.CompIdx(c)] = CType(0);
+		uGradeMask        |= mvCol[c].GradeMask();
+	}
+
+	return MultiVBatchApplyMap(mvCol, uGradeMask, mbX, mbY);
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// Constructor
+
+template<class CType>
+MultiVBatch<CType>::MultiVBatch()
+{
+	m_pStyle     = 0;
+	m_uGradeMask = 0;
+	m_nCount     = 0;
+	m_nStride    = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// Destructor
+
+template<class CType>
+MultiVBatch<CType>::~MultiVBatch()
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// Create batch
+
+template<class CType>
+bool MultiVBatch<CType>::Create(const MultiVStyle<CType>& rStyle, uint uGradeMask, size_t nCount)
+{
+	uint i, uCompCnt = 0;
+	uint uGADim      = rStyle.GADim();
+	short* piGrades  = rStyle.Grades();
+
+	if (!piGrades)
+	{
+		return false;
+	}
+
+	m_pStyle     = const_cast<MultiVStyle<CType>*>(&rStyle);
+	m_uGradeMask = uGradeMask;
+	m_nCount     = nCount;
+
+	// Pad rows to a multiple of 8 elements for SIMD processing
+	m_nStride = (nCount + 7) & ~size_t(7);
+
+	if (!m_mCompIdx.Set(uGADim))
+	{
+		return false;
+	}
+
+	for (i = 0; i < uGADim; i++)
+	{
+		if (uGradeMask & (1 << piGrades[i]))
+		{
+			m_mCompIdx[uCompCnt++] = i;
+		}
+	}
+
+	if (!m_mCompIdx.Set(uCompCnt) || !m_mData.Set(m_nStride * uCompCnt))
+	{
+		return false;
+	}
+
+	if (m_mData.Count())
+	{
+		memset(m_mData.Data(), 0, m_mData.Count() * sizeof(CType));
+	}
+
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// Position of component in list of stored components
+
+template<class CType>
+int MultiVBatch<CType>::CompPos(uint uIdx) const
+{
+	uint c, uCompCnt = CompCount();
+
+	for (c = 0; c < uCompCnt; ++c)
+	{
+		if (m_mCompIdx[c] == uIdx)
+		{
+			return int(c);
+		}
+	}
+
+	return -1;
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// Set multivector
+
+template<class CType>
+bool MultiVBatch<CType>::SetMultiV(size_t nIdx, const MultiV<CType>& vA)
+{
+	uint c, uCompCnt = CompCount();
+
+	if (!m_pStyle || (nIdx >= m_nCount) || (vA.m_uGADim != m_pStyle->GADim()))
+	{
+		return false;
+	}
+
+	for (c = 0; c < uCompCnt; ++c)
+	{
+		CompData(c)[nIdx] = vA[m_mCompIdx[c]];
+	}
+
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// Get multivector
+
+template<class CType>
+bool MultiVBatch<CType>::GetMultiV(size_t nIdx, MultiV<CType>& vA) const
+{
+	uint c, uCompCnt = CompCount();
+
+	if (!m_pStyle || (nIdx >= m_nCount))
+	{
+		return false;
+	}
+
+	vA.SetStyle(*m_pStyle);
+
+	for (c = 0; c < uCompCnt; ++c)
+	{
+		vA[m_mCompIdx[c]] = CompData(c)[nIdx];
+	}
+
+	return true;
+}
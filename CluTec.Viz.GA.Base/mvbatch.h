@@ -0,0 +1,92 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// project:   CluTec.Viz.GA.Base
+// file:      mvbatch.h
+//
+// summary:   Declares the multivector batch class
+//
+//            Copyright (c) 2019 by Christian Perwass.
+//
+//            This file is part of the CluTecLib library.
+//
+//            The CluTecLib library is free software: you can redistribute it and / or modify
+//            it under the terms of the GNU Lesser General Public License as published by
+//            the Free Software Foundation, either version 3 of the License, or
+//            (at your option) any later version.
+//
+//            The CluTecLib library is distributed in the hope that it will be useful,
+//            but WITHOUT ANY WARRANTY; without even the implied warranty of
+//            MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//            GNU Lesser General Public License for more details.
+//
+//            You should have received a copy of the GNU Lesser General Public License
+//            along with the CluTecLib library.
+//            If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+//  Batch processing of multivectors
+
+#ifndef _MVBATCH_H_
+	#define _MVBATCH_H_
+
+#include "multiv.h"
+
+	template<class CType> class MultiVBatch;
+
+	template<class CType> bool ApplyVersor(const MultiV<CType>& vR, const MultiVBatch<CType>& mbX, MultiVBatch<CType>& mbY);
+
+	template<class CType> bool ApplyProd(const MultiV<CType>& vA, EMVOpType eOpType, tMVPos ePos, const MultiVBatch<CType>& mbX, MultiVBatch<CType>& mbY);
+
+// Multivector Batch Class Declaration ----------------------
+//
+// Stores a block of multivectors of the same style as structure of arrays.
+// Only the components whose grades are given by a grade mask are stored,
+// e.g. the five vector components of conformal points. All values of one
+// component are stored consecutively, so that a linear map of the components
+// can be applied to all multivectors with SIMD instructions.
+
+	template<class CType>
+	class MultiVBatch
+	{
+	public:
+
+		MultiVBatch();
+		virtual ~MultiVBatch();
+
+		// Create batch for uCount multivectors of the given style.
+		// Bit g of uGradeMask is set if components of grade g are stored.
+		// All values are set to zero.
+		bool Create(const MultiVStyle<CType>& rStyle, uint uGradeMask, size_t nCount);
+
+		// Set or get a multivector. Components of grades not in the grade mask
+		// are ignored by SetMultiV and set to zero by GetMultiV.
+		bool SetMultiV(size_t nIdx, const MultiV<CType>& vA);
+		bool GetMultiV(size_t nIdx, MultiV<CType>& vA) const;
+
+		size_t Count() const { return m_nCount; }
+		uint GradeMask() const { return m_uGradeMask; }
+		const MultiVStyle<CType>* GetStylePtr() const { return m_pStyle; }
+
+		// Number of stored components and their indices in a multivector
+		uint CompCount() const { return uint(m_mCompIdx.Count()); }
+		uint CompIdx(uint uComp) const { return m_mCompIdx[uComp]; }
+
+		// Position of a multivector component in the list of stored components, or -1.
+		int CompPos(uint uIdx) const;
+
+		// Values of the given stored component for all multivectors
+		CType* CompData(uint uComp) const { return m_mData.Data() + uComp * m_nStride; }
+		size_t Stride() const { return m_nStride; }
+
+	protected:
+
+		MultiVStyle<CType>* m_pStyle;
+		uint m_uGradeMask;
+		size_t m_nCount;
+		size_t m_nStride;
+
+		Mem<uint> m_mCompIdx;
+		Mem<CType> m_mData;
+	};
+
+#endif	// _MVBATCH_H_
@@ -68,11 +68,16 @@ MultiVStyle<CType>::MultiVStyle(BladeList<CType>& nstyle)
 		gpTable   = 0;
 		ipTable   = 0;
 		opTable   = 0;
+		revTable  = 0;
 		dualTable = 0;
 		invoTable = 0;
 		viTable   = 0;
 		grades    = 0;
 	}
+
+	m_uGradeMaskCnt = 0;
+	memset(m_pProdPlan, 0, sizeof(m_pProdPlan));
+	InitProdPlans();
 }
 
 ////////////////////////////////////////////////////////////////////////////////////
@@ -90,10 +95,14 @@ MultiVStyle<CType>::MultiVStyle()
 	gpTable   = 0;
 	ipTable   = 0;
 	opTable   = 0;
+	revTable  = 0;
 	dualTable = 0;
 	invoTable = 0;
 	viTable   = 0;
 	grades    = 0;
+
+	m_uGradeMaskCnt = 0;
+	memset(m_pProdPlan, 0, sizeof(m_pProdPlan));
 }
 
 ////////////////////////////////////////////////////////////////////////////////////
@@ -102,6 +111,8 @@ MultiVStyle<CType>::MultiVStyle()
 template<class CType>
 MultiVStyle<CType>::~MultiVStyle()
 {
+	DeleteProdPlans();
+
 	if (style) { delete style; }
 	if (gpTable) { delete[] gpTable; }
 	if (ipTable) { delete[] ipTable; }
@@ -123,6 +134,8 @@ MultiVStyle<CType>& MultiVStyle<CType>::Init(BladeList<CType>& nstyle, short* _g
 	gadim   = base->GADim();
 	tblsize = gadim * gadim;
 
+	DeleteProdPlans();
+
 	if (nstyle.Count() == gadim)
 	{
 		if (style) { delete style; }
@@ -167,6 +180,7 @@ MultiVStyle<CType>& MultiVStyle<CType>::Init(BladeList<CType>& nstyle, short* _g
 		else{ getGrades(); }
 
 		makeReverseTable();
+		InitProdPlans();
 	}
 	else
 	{
@@ -194,6 +208,170 @@ MultiVStyle<CType>& MultiVStyle<CType>::Init(BladeList<CType>& nstyle, short* _g
 	return this[0];
 }
 
+////////////////////////////////////////////////////////////////////////////////////
+// Initialize product plans
+//
+// Allocates the arrays of product plans if the algebra is small enough.
+// The plans themselves are created on demand by GetProdPlan().
+
+template<class CType>
+void MultiVStyle<CType>::InitProdPlans()
+{
+	int iTable;
+
+	m_uGradeMaskCnt = 0;
+
+	if (!grades || dim > MAX_PROD_PLAN_DIM)
+	{
+		return;
+	}
+
+	// grades are in the range 0 to dim
+	uint uMaskCnt = 1 << (dim + 1);
+	uint uPlanCnt = uMaskCnt * uMaskCnt;
+
+	for (iTable = 0; iTable < PTID_COUNT; ++iTable)
+	{
+		m_pProdPlan[iTable] = new std::atomic<CProdPlan<CType>*>[uPlanCnt];
+
+		for (uint uIdx = 0; uIdx < uPlanCnt; ++uIdx)
+		{
+			m_pProdPlan[iTable][uIdx].store(0);
+		}
+	}
+
+	m_uGradeMaskCnt = uMaskCnt;
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// Delete product plans
+
+template<class CType>
+void MultiVStyle<CType>::DeleteProdPlans()
+{
+	int iTable;
+	uint uPlanCnt = m_uGradeMaskCnt * m_uGradeMaskCnt;
+
+	for (iTable = 0; iTable < PTID_COUNT; ++iTable)
+	{
+		if (m_pProdPlan[iTable])
+		{
+			for (uint uIdx = 0; uIdx < uPlanCnt; ++uIdx)
+			{
+				delete m_pProdPlan[iTable][uIdx].load();
+			}
+
+			delete[] m_pProdPlan[iTable];
+			m_pProdPlan[iTable] = 0;
+		}
+	}
+
+	m_uGradeMaskCnt = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// Get product plan
+//
+// If two threads request the same plan at the same time, both create it,
+// but only one is stored and the other one is deleted again.
+
+template<class CType>
+const CProdPlan<CType>* MultiVStyle<CType>::GetProdPlan(EProdTableID eTable, uint uMaskA, uint uMaskB)
+{
+	if (uMaskA >= m_uGradeMaskCnt || uMaskB >= m_uGradeMaskCnt || !m_pProdPlan[eTable])
+	{
+		return 0;
+	}
+
+	std::atomic<CProdPlan<CType>*>& rPlan = m_pProdPlan[eTable][uMaskA * m_uGradeMaskCnt + uMaskB];
+	CProdPlan<CType>* pPlan = rPlan.load(std::memory_order_acquire);
+
+	if (pPlan)
+	{
+		return pPlan;
+	}
+
+	if (!(pPlan = MakeProdPlan(eTable, uMaskA, uMaskB)))
+	{
+		return 0;
+	}
+
+	CProdPlan<CType>* pCurPlan = 0;
+	if (!rPlan.compare_exchange_strong(pCurPlan, pPlan, std::memory_order_acq_rel))
+	{
+		delete pPlan;
+		pPlan = pCurPlan;
+	}
+
+	return pPlan;
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// Make product plan
+//
+// Collects all non-zero entries of a product table for the components whose
+// grades are contained in the grade masks.
+
+template<class CType>
+CProdPlan<CType>* MultiVStyle<CType>::MakeProdPlan(EProdTableID eTable, uint uMaskA, uint uMaskB) const
+{
+	uint i, j;
+	int r;
+	short* piTable = ProdTable(eTable);
+
+	if (!piTable || !grades)
+	{
+		return 0;
+	}
+
+	CProdPlan<CType>* pPlan = new CProdPlan<CType>;
+	typename CProdPlan<CType>::SRow xRow;
+	typename CProdPlan<CType>::SEntry xEntry;
+
+	for (i = 0; i < gadim; i++)
+	{
+		if (!(uMaskA & (1 << grades[i])))
+		{
+			continue;
+		}
+
+		xRow.uA     = i;
+		xRow.uFirst = uint(pPlan->m_vecEntry.size());
+
+		for (j = 0; j < gadim; j++)
+		{
+			if (!(uMaskB & (1 << grades[j])))
+			{
+				continue;
+			}
+
+			if ((r = (int) piTable[i * gadim + j]) < 0)
+			{
+				xEntry.uB    = j;
+				xEntry.uC    = uint(-r - 1);
+				xEntry.dSign = CType(-1);
+				pPlan->m_vecEntry.push_back(xEntry);
+			}
+			else if (r > 0)
+			{
+				xEntry.uB    = j;
+				xEntry.uC    = uint(r - 1);
+				xEntry.dSign = CType(1);
+				pPlan->m_vecEntry.push_back(xEntry);
+			}
+		}
+
+		xRow.uCount = uint(pPlan->m_vecEntry.size()) - xRow.uFirst;
+
+		if (xRow.uCount > 0)
+		{
+			pPlan->m_vecRow.push_back(xRow);
+		}
+	}
+
+	return pPlan;
+}
+
 ////////////////////////////////////////////////////////////////////////////////////
 // Make Reverse Table
 
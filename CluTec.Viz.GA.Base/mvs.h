@@ -35,6 +35,9 @@
 
 #include "CluTec.Viz.Base\mem.h"
 
+#include <vector>
+#include <atomic>
+
 //#define BLADE (uint[])    // Used for casting array initialization
 
 	#define MVS_LIST 0x0001	// Multi-Vector Display Style as [1,..., ]
@@ -68,11 +71,79 @@
 
 	template<class CType> int operator==(const MultiVStyle<CType>&, const Blade<CType>&);
 
+// Product plans can be switched off, to compare them with the dense product
+// tables. Each module has its own copy of this flag. MultiV<float> and
+// MultiV<double> are instantiated in CluTec.Viz.GA, whose copy is set with
+// EnableCLUGAProdPlan().
+
+	inline bool& _ProdPlanEnabledRef()
+	{
+		static bool bEnabled = true;
+		return bEnabled;
+	}
+
+	inline bool IsProdPlanEnabled()
+	{
+		return _ProdPlanEnabledRef();
+	}
+
+	inline void EnableProdPlan(bool bVal)
+	{
+		_ProdPlanEnabledRef() = bVal;
+	}
+
+// Sparse Product Plan ---------------------------------------
+//
+// Contains those entries of a product table that can be non-zero for two
+// multivectors, which only have components of the grades given by two grade
+// masks. Bit g of a grade mask is set if the multivector has components of
+// grade g. The entries are grouped in rows by the component index of the
+// left multivector.
+
+	template<class CType>
+	class CProdPlan
+	{
+	public:
+
+		struct SRow
+		{
+			uint uA;	// Component index of left multivector
+			uint uFirst;	// Index of first entry of row
+			uint uCount;	// Number of entries in row
+		};
+
+		struct SEntry
+		{
+			uint uB;	// Component index of right multivector
+			uint uC;	// Component index of result
+			CType dSign;	// Sign of product
+		};
+
+	public:
+
+		std::vector<SRow> m_vecRow;
+		std::vector<SEntry> m_vecEntry;
+	};
+
 // Multi-Vector-Style Class Declaration ---------------------
 
 	template<class CType>
 	class MultiVStyle
 	{
+	public:
+
+		// IDs of product tables
+		enum EProdTableID
+		{
+			PTID_GP = 0,	// Geometric product
+			PTID_IP,		// Inner product
+			PTID_OP,		// Outer product
+			PTID_COUNT
+		};
+
+		// Product plans are only created for algebras up to this vector space dimension
+		enum { MAX_PROD_PLAN_DIM = 5 };
+
 	public:
 
 		MultiVStyle(BladeList<CType>& nstyle);
@@ -99,6 +170,15 @@
 		short* DualTable() const { return dualTable; }
 		short* InvoTable() const { return invoTable; }
 
+		short* ProdTable(EProdTableID eTable) const
+		{ return (eTable == PTID_GP ? gpTable : (eTable == PTID_IP ? ipTable : opTable)); }
+
+		// Returns the sparse product plan of the given product table for
+		// multivectors with the given grade masks. Plans are created on first
+		// use and kept until the tables change. Returns 0 if no plans are
+		// available for this algebra. This function is thread safe.
+		const CProdPlan<CType>* GetProdPlan(EProdTableID eTable, uint uMaskA, uint uMaskB);
+
 		short* VecInvTable() const { return viTable; }
 		short* Grades() const { return grades; }
 		char* BladeName(size_t pos);
@@ -126,6 +206,16 @@
 		void makeInvoTable();
 		void makeVecInvTable();
 		void getGrades();
+
+		void InitProdPlans();
+		void DeleteProdPlans();
+		CProdPlan<CType>* MakeProdPlan(EProdTableID eTable, uint uMaskA, uint uMaskB) const;
+
+		// Number of different grade masks. Zero if no product plans are used.
+		uint m_uGradeMaskCnt;
+
+		// For each product table an array of m_uGradeMaskCnt x m_uGradeMaskCnt plans
+		std::atomic<CProdPlan<CType>*>* m_pProdPlan[PTID_COUNT];
 	};
 
 #endif	// _MULTIVSTYLE_H_
@@ -88,3 +88,13 @@ CLUGA_API bool FinalizeCLUGA()
 
 	return true;
 }
+
+CLUGA_API void EnableCLUGAProdPlan(bool bVal)
+{
+	EnableProdPlan(bVal);
+}
+
+CLUGA_API bool IsCLUGAProdPlanEnabled()
+{
+	return IsProdPlanEnabled();
+}
@@ -63,4 +63,9 @@ CLUGA_API E8GA<float> *m_pfE8GABase;
 CLUGA_API bool InitCLUGA();
 CLUGA_API bool FinalizeCLUGA();
 
+// Enables the sparse product plans of the multivector products instantiated in this library.
+// The flag of the headers exists once per module, so other modules have to call this.
+CLUGA_API void EnableCLUGAProdPlan(bool bVal);
+CLUGA_API bool IsCLUGAProdPlanEnabled();
+
 #endif
@@ -111,6 +111,9 @@
 	CLUGA_EXT template class CLUGA_API Mem<float>;
 	CLUGA_EXT template class CLUGA_API Mem<double>;
 
+	CLUGA_EXT template class CLUGA_API MemInline<float, _MULTIV_INLINE_DIM_>;
+	CLUGA_EXT template class CLUGA_API MemInline<double, _MULTIV_INLINE_DIM_>;
+
 	CLUGA_EXT template class CLUGA_API Mem<float*>;
 	CLUGA_EXT template class CLUGA_API Mem<double*>;
 	CLUGA_EXT template class CLUGA_API Mem<Mem<uint>*>;
@@ -129,11 +132,13 @@
 	CLUGA_EXT template class CLUGA_API Blade<double>;
 	CLUGA_EXT template class CLUGA_API MultiV<double>;
 	CLUGA_EXT template class CLUGA_API MultiVStyle<double>;
+	CLUGA_EXT template class CLUGA_API MultiVBatch<double>;
 	CLUGA_EXT template class CLUGA_API RingBuf<double>;
 
 	CLUGA_EXT template class CLUGA_API Blade<float>;
 	CLUGA_EXT template class CLUGA_API MultiV<float>;
 	CLUGA_EXT template class CLUGA_API MultiVStyle<float>;
+	CLUGA_EXT template class CLUGA_API MultiVBatch<float>;
 	CLUGA_EXT template class CLUGA_API RingBuf<float>;
 
 	CLUGA_EXT template class CLUGA_API Mem<MultiV<double>* >;
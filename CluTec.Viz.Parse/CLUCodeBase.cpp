@@ -47,7 +47,9 @@
     #include <ShellApi.h>
 #endif
 
+#include "CLUParse.h"
 #include "CLUCodeBase.h"
+#include "CodeSymbolTable.h"
 
 #include <float.h>
 
@@ -56,6 +58,7 @@
 #include <functional>		// For greater<int>( )
 
 #include "CluTec.Viz.Base\TensorOperators.h"
+#include "CluTec.Viz.Base\matkernel.h"
 
 using namespace std;
 
@@ -114,6 +117,14 @@ CCLUCodeBase::CCLUCodeBase()
 
 	m_bNeedResourceHandleReset = false;
 
+	m_iCurCodeLine       = -1;
+	m_nCodeLineEnvHash   = 0;
+	m_bIncrementalExec   = false;
+	m_bAllowCodeLineSkip = false;
+	m_bCodeLineSkipInRun = false;
+	m_uCodeLineExecCount = 0;
+	m_uCodeLineSkipCount = 0;
+
 	Reset();
 }
 
@@ -148,6 +159,9 @@ void CCLUCodeBase::Reset()
 	// Reset Serial IO Ports
 	ResetSerialIO();
 
+	// Forget recorded code lines
+	ResetCodeLineCache();
+
 	// Reset Animation Time Step
 	if (m_pCLUDrawBase)
 	{
@@ -212,6 +226,18 @@ void CCLUCodeBase::ResetEnvVars()
 	// Evaluation precision
 	m_fSensitivity = 1e-12;
 
+	// Execute code tree unless script enables bytecode
+	EnableBytecode(false);
+
+	// Start a new run for incremental execution. Code lines can only be skipped
+	// if incremental execution was already enabled at the start of the run,
+	// so that all preceding lines of the run have been tracked.
+	m_nCodeLineEnvHash = 0;
+	m_setCodeLineRefVar.clear();
+	m_uCodeLineExecCount = 0;
+	m_uCodeLineSkipCount = 0;
+	m_bCodeLineSkipInRun = m_bAllowCodeLineSkip && m_bIncrementalExec;
+
 	// Visualization precision
 	if (m_pFilter)
 	{
@@ -280,6 +306,71 @@ void CCLUCodeBase::CleanUp()
 {
 }
 
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void CCLUCodeBase::SetMatrixKernel(int iKernel, int iThreadCount)
+{
+	::SetMatrixKernel(EMatrixKernel(iKernel));
+
+	if (iThreadCount >= 0)
+	{
+		CMatrixThreadPool::Global().SetThreadCount(uint(iThreadCount));
+	}
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void CCLUCodeBase::EnableProdPlan(bool bVal)
+{
+	::EnableProdPlan(bVal);
+	::EnableCLUGAProdPlan(bVal);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void CCLUCodeBase::SetVarListChunkSize(size_t uElNo)
+{
+	CVarList::SetChunkElementCount(uElNo);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void CCLUCodeBase::GetVarListAllocStats(size_t& uHeapElCnt, size_t& uChunkCnt, bool bReset)
+{
+	uHeapElCnt = CVarList::GetHeapElementAllocCount();
+	uChunkCnt  = CVarList::GetChunkAllocCount();
+
+	if (bReset)
+	{
+		CVarList::ResetAllocCounts();
+	}
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+bool CCLUCodeBase::SetIncludeCachePath(const char* pcPath)
+{
+	if (!m_pCLUParse)
+	{
+		return false;
+	}
+
+	m_pCLUParse->SetIncludeCachePath(pcPath);
+	return true;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+bool CCLUCodeBase::GetIncludeCacheStats(unsigned& uHitCnt, unsigned& uMissCnt, unsigned& uLoadCnt, unsigned& uSaveCnt)
+{
+	if (!m_pCLUParse)
+	{
+		return false;
+	}
+
+	const CIncludeCache::SStats& rStats = m_pCLUParse->GetIncludeCacheStats();
+
+	uHitCnt  = rStats.uHitCnt;
+	uMissCnt = rStats.uMissCnt;
+	uLoadCnt = rStats.uLoadCnt;
+	uSaveCnt = rStats.uSaveCnt;
+	return true;
+}
+
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 void CCLUCodeBase::SetVersion(int iMajor, int iMinor, int iRevision)
 {
@@ -504,18 +595,21 @@ bool CCLUCodeBase::ExecUserFunc(CCodeVar& rResVar, TCodePtr pCodePtr, TVarList&
 	// the local var list stack.
 	// GetVar searches first in this stack,
 	// then in ConstVarList and then in VarList.
-	CCodeVarList mLocalVarList;
+	// Functions only have a few local variables, so they are
+	// stored in sparse slots.
+	CCodeVarList mLocalVarList(CCodeVarList::SLOT_SPARSE);
 
 	// Parameters to function can be accessed via
 	// the variable _P.
+	static const int s_iSymIDParList = CCodeSymbolTable::Global().GetID("_P");
 
-	if (!mLocalVarList.New("_P", PDT_PTR_VARLIST))
+	if (!mLocalVarList.New("_P", PDT_PTR_VARLIST, s_iSymIDParList))
 	{
 		m_ErrorList.Internal(iCodeLine, iCodePos);
 		return false;
 	}
 
-	mLocalVarList["_P"] = &rParList;
+	mLocalVarList.GetVar(s_iSymIDParList) = &rParList;
 
 	PushLocal(&mLocalVarList);
 	SetCurrentNamespace(NS_LOCAL);
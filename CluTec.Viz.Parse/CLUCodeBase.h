@@ -36,8 +36,10 @@
 #endif	// _MSC_VER > 1000
 
 #include <map>
+#include <set>
 #include <string>
 #include <vector>
+#include <unordered_map>
 #include <time.h>
 #include <sys/timeb.h>
 
@@ -97,6 +99,7 @@
 #include "CluTec.Viz.Draw\OGLDrawBase.h"
 #include "CluTec.Viz.Draw\OGLLatexText.h"
 #include "CluTec.Viz.Draw\CLUDrawBase.h"
+#include "CluTec.Viz.Base\SharedBuffer.h"
 
 
 	class CCLUCodeBase : public CCodeBase
@@ -139,6 +142,30 @@
 			TENSOR_MAX_VALENCE = 10
 		};
 
+		// Point operators that are evaluated with dense kernels on lists of scalars or multivectors
+		enum EPointListOp
+		{
+			POINTLIST_ADD,
+			POINTLIST_SUBTRACT,
+			POINTLIST_PROD,
+			POINTLIST_DIV,
+			POINTLIST_WEDGE,
+			POINTLIST_INNERPROD,
+			POINTLIST_EQUAL,
+			POINTLIST_NOTEQUAL,
+			POINTLIST_GREATER,
+			POINTLIST_LESS,
+			POINTLIST_GREATEREQUAL,
+			POINTLIST_LESSEQUAL
+		};
+
+		enum EPointListType
+		{
+			POINTLIST_NONE,
+			POINTLIST_SCALAR,
+			POINTLIST_MULTIV
+		};
+
 		//struct SFontData
 		//{
 		//	string sName;
@@ -199,6 +226,57 @@
 		// Clean up stuff the user might have forgotten.
 		void CleanUp();
 
+		// Incremental execution. If enabled, the effect of every top-level code line on the
+		// global variables, the current scene and the draw state is recorded. In runs for which
+		// skipping is allowed, a line is not executed if its inputs are unchanged. Instead, its
+		// recorded effect is reproduced. The setting is kept until the script is parsed again.
+		void EnableIncrementalExec(bool bVal = true) { m_bIncrementalExec = bVal; }
+		bool IsIncrementalExecEnabled() { return m_bIncrementalExec; }
+
+		// Set by the window before each run, depending on the reason for the run.
+		void AllowCodeLineSkip(bool bVal) { m_bAllowCodeLineSkip = bVal; }
+
+		// Number of code lines executed and skipped in the current run.
+		uint GetCodeLineExecCount() { return m_uCodeLineExecCount; }
+		uint GetCodeLineSkipCount() { return m_uCodeLineSkipCount; }
+
+		// The current code line has an effect that cannot be recorded.
+		// The given value is mixed into the environment hash, which all subsequent lines depend on.
+		void MarkCodeLineVolatile(uint uValue = 0);
+
+		virtual bool SkipCodeLine(int iLine);
+		virtual void BeginCodeLine(int iLine);
+		virtual void EndCodeLine(int iLine, bool bOK);
+		virtual void ResetCodeLineCache();
+		virtual void OnAccessVar(CCodeVar& rVar, int iSymID);
+		virtual void OnCallFunc(CCodeElement& rFunc, CCodeVar& rPars);
+
+		// Select the kernels used for matrix products and decompositions (see EMatrixKernel)
+		// and the number of threads they may use. A negative thread count keeps the current
+		// count, zero uses one thread per hardware thread. Each module has its own copy of the
+		// matrix kernels, so this is virtual to reach the module the code base was created in.
+		virtual void SetMatrixKernel(int iKernel, int iThreadCount = -1);
+
+		// Enable the sparse product plans of multivector products. This is virtual
+		// for the same reason as SetMatrixKernel.
+		virtual void EnableProdPlan(bool bVal);
+
+		// Minimal number of elements per chunk of variable lists whose elements are constructed
+		// in place, and the number of list elements and chunks allocated since the last reset.
+		// These are virtual for the same reason as SetMatrixKernel.
+		virtual void SetVarListChunkSize(size_t uElNo);
+		virtual void GetVarListAllocStats(size_t& uHeapElCnt, size_t& uChunkCnt, bool bReset);
+
+		// Folder the cache of preparsed include files is stored in, and the number of hits, misses,
+		// entries read and entries written while the last script was preparsed. These refer to the
+		// preparser of the module the code base was created in, and return false if there is none.
+		virtual bool SetIncludeCachePath(const char* pcPath);
+		virtual bool GetIncludeCacheStats(unsigned& uHitCnt, unsigned& uMissCnt, unsigned& uLoadCnt, unsigned& uSaveCnt);
+
+		// Buffers filled by the host application, which scripts can read without copying them
+		// between threads. The registry may be accessed from any thread.
+		CSharedBufferRegistry& GetSharedBufferRegistry() { return m_xSharedBufferReg; }
+
 		// Return reference to Output Object List
 		const TOutObjList& GetOutputObjectList() { return m_vecOutputObject; }
 		void InsertOutputObject(const SOutputObject& rObj)
@@ -285,6 +363,7 @@
 		CCLUDrawBase* GetCLUDrawBase() { return m_pCLUDrawBase; }
 		COGLMVFilter* GetFilter() { return m_pFilter; }
 		TCVScalar& GetSensitivity() { return m_fSensitivity; }
+		virtual TCVScalar GetScalarPrec() { return m_fSensitivity; }
 		COGLBEReference GetMainSceneRef() { return m_MainSceneRef; }
 		COGLText& GetOGLText() { return m_Text; }
 		OGLDirectWrite& GetDirectWrite() { return m_xDirectWrite;  }
@@ -449,6 +528,11 @@
 		bool OpDiv(CCodeVar& rLVar, CCodeVar& rRVar, CCodeVar& rResVar, int iLine, int iPos);
 		bool OpPointDiv(CCodeVar& rLVar, CCodeVar& rRVar, CCodeVar& rResVar, int iLine, int iPos);
 
+		// Dense evaluation of point operators on two lists of the same length.
+		// GetPointListType() returns POINTLIST_NONE if the lists cannot be evaluated densely.
+		EPointListType GetPointListType(EPointListOp eOp, TVarList& rL, TVarList& rR);
+		bool OpPointList(EPointListOp eOp, EPointListType eType, TVarList& rL, TVarList& rR, TVarList& rRes, int iLine, int iPos);
+
 		bool OpPow(CCodeVar& rLVar, CCodeVar& rRVar, CCodeVar& rResVar, int iLine, int iPos);
 		bool OpGradeProj(CCodeVar& rLVar, CCodeVar& rRVar, CCodeVar& rResVar, int iLine, int iPos);
 //	bool OpElementSelect(CCodeVar& rLVar, CCodeVar& rRVar, CCodeVar& rResVar, int iLine, int iPos);
@@ -602,6 +686,47 @@
 			m_pCLUDrawBase->RTViewSetRotationAxisInversion(bAxisX, bAxisY);
 		}
 
+	protected:
+
+		// State of the code base and the draw base that determines the effect of a code line
+		struct SCodeLineState
+		{
+			COGLDrawBase::SModeState xDraw;
+			COGLVertex xBMPPos;
+			float fVBMPAlign, fHBMPAlign;
+			float fVLatexAlign, fHLatexAlign;
+			float fBitmapScale;
+			int iTextPrec;
+			int iPlotMode;
+		};
+
+		// Global variable accessed by a code line
+		struct SCodeLineVar
+		{
+			int iSymID;
+			string sName;
+			CCodeVar xIn;	// Value at first access
+			CCodeVar xOut;	// Value at end of line
+		};
+
+		// Recorded effect of a top-level code line
+		struct SCodeLine
+		{
+			bool bValid;
+			bool bReusable;
+			size_t nEnvHash;
+			size_t nSceneStart;
+			SCodeLineState xStart, xEnd;
+			vector<SCodeLineVar> vecVar;
+			vector<COGLBEReference> vecElement;
+
+			SCodeLine() { bValid = false; bReusable = false; nEnvHash = 0; nSceneStart = 0; }
+		};
+
+		void GetCodeLineState(SCodeLineState& rState);
+		void SetCodeLineState(const SCodeLineState& rState);
+		bool IsCacheableFunc(CCodeElement& rFunc);
+
 	public:
 
 		static CCLUCodeBase* sm_pCurCodeBase;
@@ -696,6 +821,21 @@
 
 		bool m_bNeedResourceHandleReset;
 
+		// Incremental execution
+		vector<SCodeLine> m_vecCodeLine;
+		int m_iCurCodeLine;	// Index of tracked code line or -1
+		size_t m_nCodeLineEnvHash;
+		set<int> m_setCodeLineRefVar;	// Reference type variables accessed by executed lines
+		unordered_map<CCodeElement*, bool> m_mapCacheableFunc;
+		bool m_bIncrementalExec;
+		bool m_bAllowCodeLineSkip;
+		bool m_bCodeLineSkipInRun;
+		uint m_uCodeLineExecCount;
+		uint m_uCodeLineSkipCount;
+
+		// Shared buffers of host application
+		CSharedBufferRegistry m_xSharedBufferReg;
+
 		#ifdef WIN32
 			TSerialIOMap m_mapSerialIO;
 		#endif
@@ -0,0 +1,700 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// project:   CluTec.Viz.Parse
+// file:      CLUCodeBase_LineCache.cpp
+//
+// summary:   Implements the incremental execution of code lines in the clu code base class
+//
+//            Copyright (c) 2019 by Christian Perwass.
+//
+//            This file is part of the CluTecLib library.
+//
+//            The CluTecLib library is free software: you can redistribute it and / or modify
+//            it under the terms of the GNU Lesser General Public License as published by
+//            the Free Software Foundation, either version 3 of the License, or
+//            (at your option) any later version.
+//
+//            The CluTecLib library is distributed in the hope that it will be useful,
+//            but WITHOUT ANY WARRANTY; without even the implied warranty of
+//            MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//            GNU Lesser General Public License for more details.
+//
+//            You should have received a copy of the GNU Lesser General Public License
+//            along with the CluTecLib library.
+//            If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Incremental execution of top-level code lines.
+//
+// While incremental execution is enabled, every executed top-level code line is tracked.
+// The record of a line contains the values of all global variables the line accessed,
+// at their first access and at the end of the line, the elements the line appended to
+// the current scene and the draw state before and after the line.
+//
+// A line can only be reproduced from its record if all its effects are contained in
+// the record. This is not the case if the line
+//   - failed or executed a break,
+//   - called an external function that is not known to be free of side effects,
+//   - printed a value or set a filter or plot mode,
+//   - accessed a pointer or vertex list variable,
+//   - changed the current scene or removed elements from it.
+// Such lines are always executed. The functions they called and the modes they set are
+// mixed into an environment hash, which every other line depends on.
+//
+// A line is skipped, if skipping is allowed for the run, the environment hash and the
+// draw state equal those at the start of the recorded execution and all accessed global
+// variables have the same values as at the start of the recorded execution. Scenes and
+// images are compared by identity. Since their content can be changed by executed lines,
+// a line is also executed if it accesses a scene or image variable that was accessed by
+// a line executed before in the same run.
+
+#include "StdAfx.h"
+
+#include "CLUCodeBase.h"
+
+#include <functional>
+
+namespace
+{
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// External functions that only depend on their parameters and only add elements to the current scene.
+
+	const char* s_pcCacheableFunc[] =
+	{
+		// List
+		"List", "SubList", "RemList", "InsList", "TransList", "CombIdxList", "PermIdxList", "sort",
+
+		// String
+		"String", "String2ASCII", "ASCII2String", "Scalar", "Counter", "HexStr2Scalar", "Scalar2HexStr",
+
+		// Info
+		"Size", "Type",
+
+		// Spaces
+		"VecC2", "RotorC2", "ReflectorC2", "VecE3", "RotorE3", "VecE8", "RotorE8",
+		"VecN3", "RotorN3", "SphereN3", "TranslatorN3", "DilatorN3", "DirVecN3",
+		"VecP3", "RotorP3", "DirVecP3", "AffineVecP3",
+
+		// Math
+		"sum", "sub", "prod", "arg", "min", "max", "argmin", "argmax", "abs", "pow", "sqrt", "inv", "fact", "sign",
+		"sin", "cos", "tan", "asin", "acos", "atan", "sinh", "cosh", "tanh", "floor", "ceil", "round", "exp", "log",
+		"isNaN", "NaN",
+
+		// Geometric algebra
+		"oprod", "iprod", "proj", "rej", "cp", "acp", "FactorizeBlade", "ApplyVersor", "GradeList", "BladeIdxList",
+		"MV2Mask",
+
+		// Matrix and tensor
+		"Matrix", "ResizeMatrix", "ReshapeMatrix", "AddRows", "AddCols", "RowSpace", "FindMainNRows", "GetRows",
+		"EigenValues", "Eigen", "SVD", "det", "Diag2Row", "Row2Diag", "DiagToRow", "RowToDiag", "IdMatrix",
+		"GetMVProductMatrix", "MV2Matrix", "Matrix2MV", "Sym2Col", "Col2Sym", "Tensor", "MV2Tensor", "Tensor2MV",
+
+		// Color
+		"Color",
+
+		// Settings that are kept until the script is parsed again. The call enabling incremental
+		// execution is not tracked, so it must not change the environment hash of the following lines.
+		"EnableIncrementalExec",
+	};
+
+	// Functions starting with "Draw" that do not only add elements to the current scene
+	const char* s_pcNonCacheableDrawFunc[] =
+	{
+		"DrawToScene", "DrawLatex",
+	};
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	template<class T>
+	void HashCombine(size_t& nHash, const T& xValue)
+	{
+		nHash ^= std::hash<T>()(xValue) + 0x9e3779b9 + (nHash << 6) + (nHash >> 2);
+	}
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Hash of the value of a variable. Values that are not compared by value only contribute their type.
+
+	void HashVar(size_t& nHash, CCodeVar& rVar)
+	{
+		ECodeDataType eType = rVar.Type();
+
+		HashCombine(nHash, int(eType));
+
+		switch (eType)
+		{
+		case PDT_STRING:
+			HashCombine(nHash, std::string(rVar.GetStringPtr()->Str()));
+			break;
+
+		case PDT_INT:
+			HashCombine(nHash, *rVar.GetIntPtr());
+			break;
+
+		case PDT_UINT:
+			HashCombine(nHash, *rVar.GetUIntPtr());
+			break;
+
+		case PDT_LONG:
+			HashCombine(nHash, *rVar.GetLongPtr());
+			break;
+
+		case PDT_FLOAT:
+			HashCombine(nHash, *rVar.GetFloatPtr());
+			break;
+
+		case PDT_DOUBLE:
+			HashCombine(nHash, *rVar.GetDoublePtr());
+			break;
+
+		case PDT_MULTIV:
+		{
+			TMultiV& rA = *rVar.GetMultiVPtr();
+			uint uIdx, uCnt = rA.GetGADim();
+			for (uIdx = 0; uIdx < uCnt; ++uIdx)
+			{
+				HashCombine(nHash, rA[uIdx]);
+			}
+		}
+		break;
+
+		case PDT_MATRIX:
+		{
+			TMatrix& rA = *rVar.GetMatrixPtr();
+			size_t nIdx, nCnt = size_t(rA.Rows()) * size_t(rA.Cols());
+			const TCVScalar* pData = rA.Data();
+			for (nIdx = 0; nIdx < nCnt; ++nIdx)
+			{
+				HashCombine(nHash, pData[nIdx]);
+			}
+		}
+		break;
+
+		case PDT_COLOR:
+		{
+			const float* pfCol = rVar.GetOGLColorPtr()->Data();
+			for (int i = 0; i < 4; ++i)
+			{
+				HashCombine(nHash, pfCol[i]);
+			}
+		}
+		break;
+
+		case PDT_VARLIST:
+		{
+			TVarList& rList = *rVar.GetVarListPtr();
+			size_t nIdx, nCnt = rList.Count();
+			for (nIdx = 0; nIdx < nCnt; ++nIdx)
+			{
+				HashVar(nHash, rList[nIdx]);
+			}
+		}
+		break;
+
+		case PDT_SCENE:
+			HashCombine(nHash, (const void*) (COGLBaseElement*) *rVar.GetScenePtr());
+			break;
+
+		case PDT_IMAGE:
+			HashCombine(nHash, (const void*) (TImage::TImagePtr) *rVar.GetImagePtr());
+			break;
+
+		default:
+			break;
+		}
+	}
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Compare values of variables. Scenes, images and code pointers are compared by identity.
+	// Pointer variables are never equal.
+
+	bool IsEqualVar(CCodeVar& rA, CCodeVar& rB)
+	{
+		if (rA.IsPtr() || rB.IsPtr())
+		{
+			return false;
+		}
+
+		ECodeDataType eType = rA.Type();
+		if (eType != rB.Type())
+		{
+			return false;
+		}
+
+		switch (eType)
+		{
+		case PDT_NOTYPE:
+			return true;
+
+		case PDT_STRING:
+			return (*rA.GetStringPtr() == *rB.GetStringPtr()) != 0;
+
+		case PDT_INT:
+			return *rA.GetIntPtr() == *rB.GetIntPtr();
+
+		case PDT_UINT:
+			return *rA.GetUIntPtr() == *rB.GetUIntPtr();
+
+		case PDT_LONG:
+			return *rA.GetLongPtr() == *rB.GetLongPtr();
+
+		case PDT_FLOAT:
+			return *rA.GetFloatPtr() == *rB.GetFloatPtr();
+
+		case PDT_DOUBLE:
+			return *rA.GetDoublePtr() == *rB.GetDoublePtr();
+
+		case PDT_MULTIV:
+		{
+			TMultiV& rMA = *rA.GetMultiVPtr();
+			TMultiV& rMB = *rB.GetMultiVPtr();
+
+			return rMA.BasePtr() == rMB.BasePtr()
+			       && rMA.GetGADim() == rMB.GetGADim()
+			       && (rMA == rMB) != 0;
+		}
+
+		case PDT_MATRIX:
+			return *rA.GetMatrixPtr() == *rB.GetMatrixPtr();
+
+		case PDT_TENSOR:
+		{
+			TTensor& rTA = *rA.GetTensorPtr();
+			TTensor& rTB = *rB.GetTensorPtr();
+
+			if (rTA.Valence() != rTB.Valence() || rTA.Size() != rTB.Size())
+			{
+				return false;
+			}
+
+			for (int iDim = 0; iDim < rTA.Valence(); ++iDim)
+			{
+				if (rTA.DimSize(iDim) != rTB.DimSize(iDim))
+				{
+					return false;
+				}
+			}
+
+			return memcmp(rTA.Data(), rTB.Data(), size_t(rTA.Size()) * sizeof(TCVScalar)) == 0;
+		}
+
+		case PDT_COLOR:
+			return memcmp(rA.GetOGLColorPtr()->Data(), rB.GetOGLColorPtr()->Data(), 4 * sizeof(float)) == 0;
+
+		case PDT_CODEPTR:
+			return *rA.GetCodePtrPtr() == *rB.GetCodePtrPtr();
+
+		case PDT_VARLIST:
+		{
+			TVarList& rLA = *rA.GetVarListPtr();
+			TVarList& rLB = *rB.GetVarListPtr();
+
+			size_t nIdx, nCnt = rLA.Count();
+			if (nCnt != rLB.Count())
+			{
+				return false;
+			}
+
+			for (nIdx = 0; nIdx < nCnt; ++nIdx)
+			{
+				if (!IsEqualVar(rLA[nIdx], rLB[nIdx]))
+				{
+					return false;
+				}
+			}
+
+			return true;
+		}
+
+		case PDT_SCENE:
+			return (COGLBaseElement*) *rA.GetScenePtr() == (COGLBaseElement*) *rB.GetScenePtr();
+
+		case PDT_IMAGE:
+			return (TImage::TImagePtr) *rA.GetImagePtr() == (TImage::TImagePtr) *rB.GetImagePtr();
+
+		default:
+			return false;
+		}
+	}
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// True if variable refers to a scene or an image, whose content may change without the variable changing.
+
+	bool IsRefVar(CCodeVar& rVar)
+	{
+		ECodeDataType eType = rVar.Type();
+
+		if (eType == PDT_SCENE || eType == PDT_IMAGE)
+		{
+			return true;
+		}
+
+		if (eType == PDT_VARLIST)
+		{
+			TVarList& rList = *rVar.GetVarListPtr();
+			size_t nIdx, nCnt = rList.Count();
+			for (nIdx = 0; nIdx < nCnt; ++nIdx)
+			{
+				if (IsRefVar(rList[nIdx]))
+				{
+					return true;
+				}
+			}
+		}
+
+		return false;
+	}
+}
+
+//////////////////////////////////////////////////////////////////////
+/// Get state that determines the effect of a code line
+
+void CCLUCodeBase::GetCodeLineState(SCodeLineState& rState)
+{
+	if (m_pDrawBase)
+	{
+		m_pDrawBase->GetModeState(rState.xDraw);
+	}
+	else
+	{
+		memset(&rState.xDraw, 0, sizeof(COGLDrawBase::SModeState));
+	}
+
+	rState.xBMPPos      = m_xBMPPos;
+	rState.fVBMPAlign   = m_fVBMPAlign;
+	rState.fHBMPAlign   = m_fHBMPAlign;
+	rState.fVLatexAlign = m_fVLatexAlign;
+	rState.fHLatexAlign = m_fHLatexAlign;
+	rState.fBitmapScale = m_fCurBitmapScale;
+	rState.iTextPrec    = m_iTextPrec;
+	rState.iPlotMode    = m_iPlotMode;
+}
+
+//////////////////////////////////////////////////////////////////////
+/// Set state recorded at the end of a code line
+
+void CCLUCodeBase::SetCodeLineState(const SCodeLineState& rState)
+{
+	if (m_pDrawBase)
+	{
+		m_pDrawBase->SetModeState(rState.xDraw);
+	}
+
+	m_xBMPPos         = rState.xBMPPos;
+	m_fVBMPAlign      = rState.fVBMPAlign;
+	m_fHBMPAlign      = rState.fHBMPAlign;
+	m_fVLatexAlign    = rState.fVLatexAlign;
+	m_fHLatexAlign    = rState.fHLatexAlign;
+	m_fCurBitmapScale = rState.fBitmapScale;
+	m_iTextPrec       = rState.iTextPrec;
+	m_iPlotMode       = rState.iPlotMode;
+}
+
+//////////////////////////////////////////////////////////////////////
+/// Check whether external function only depends on its parameters.
+/// The result is cached per function element.
+
+bool CCLUCodeBase::IsCacheableFunc(CCodeElement& rFunc)
+{
+	auto itFunc = m_mapCacheableFunc.find(&rFunc);
+	if (itFunc != m_mapCacheableFunc.end())
+	{
+		return itFunc->second;
+	}
+
+	CStrMem csName = rFunc.GetName();
+	const char* pcName = csName.Str();
+	bool bCacheable = false;
+
+	if (strncmp(pcName, "Draw", 4) == 0)
+	{
+		bCacheable = true;
+		for (const char* pcFunc : s_pcNonCacheableDrawFunc)
+		{
+			if (strcmp(pcName, pcFunc) == 0)
+			{
+				bCacheable = false;
+				break;
+			}
+		}
+	}
+	else
+	{
+		for (const char* pcFunc : s_pcCacheableFunc)
+		{
+			if (strcmp(pcName, pcFunc) == 0)
+			{
+				bCacheable = true;
+				break;
+			}
+		}
+	}
+
+	m_mapCacheableFunc[&rFunc] = bCacheable;
+	return bCacheable;
+}
+
+//////////////////////////////////////////////////////////////////////
+/// Reset all recorded code lines.
+/// Called whenever the code tree is parsed again.
+
+void CCLUCodeBase::ResetCodeLineCache()
+{
+	m_vecCodeLine.clear();
+	m_mapCacheableFunc.clear();
+	m_setCodeLineRefVar.clear();
+
+	m_iCurCodeLine       = -1;
+	m_bTrackCodeLine     = false;
+	m_bIncrementalExec   = false;
+	m_bCodeLineSkipInRun = false;
+}
+
+//////////////////////////////////////////////////////////////////////
+/// Mark current code line as not reproducible
+
+void CCLUCodeBase::MarkCodeLineVolatile(uint uValue)
+{
+	if (m_iCurCodeLine < 0)
+	{
+		return;
+	}
+
+	m_vecCodeLine[m_iCurCodeLine].bReusable = false;
+	HashCombine(m_nCodeLineEnvHash, uValue);
+}
+
+//////////////////////////////////////////////////////////////////////
+/// Start tracking of code line
+
+void CCLUCodeBase::BeginCodeLine(int iLine)
+{
+	++m_uCodeLineExecCount;
+
+	m_iCurCodeLine   = -1;
+	m_bTrackCodeLine = false;
+
+	if (!m_bIncrementalExec)
+	{
+		if (iLine < int(m_vecCodeLine.size()))
+		{
+			m_vecCodeLine[iLine] = SCodeLine();
+		}
+		return;
+	}
+
+	// The elements drawn by a line are added again when the line is skipped,
+	// so an instance batch must not collect the primitives of more than one line.
+	if (m_pDrawBase)
+	{
+		m_pDrawBase->CloseInstanceBatch();
+	}
+
+	if (iLine >= int(m_vecCodeLine.size()))
+	{
+		m_vecCodeLine.resize(iLine + 1);
+	}
+
+	SCodeLine& rLine = m_vecCodeLine[iLine];
+
+	rLine.bValid    = false;
+	rLine.bReusable = true;
+	rLine.nEnvHash  = m_nCodeLineEnvHash;
+	rLine.vecVar.clear();
+	rLine.vecElement.clear();
+
+	GetCodeLineState(rLine.xStart);
+	rLine.nSceneStart = (rLine.xStart.xDraw.pScene ? rLine.xStart.xDraw.pScene->GetElementList().size() : 0);
+
+	m_iCurCodeLine   = iLine;
+	m_bTrackCodeLine = true;
+}
+
+//////////////////////////////////////////////////////////////////////
+/// Record global variable accessed by the current code line
+
+void CCLUCodeBase::OnAccessVar(CCodeVar& rVar, int iSymID)
+{
+	if (m_iCurCodeLine < 0 || &m_mVarList.GetVar(iSymID) != &rVar)
+	{
+		return;
+	}
+
+	SCodeLine& rLine = m_vecCodeLine[m_iCurCodeLine];
+
+	for (const SCodeLineVar& rLineVar : rLine.vecVar)
+	{
+		if (rLineVar.iSymID == iSymID)
+		{
+			return;
+		}
+	}
+
+	rLine.vecVar.push_back(SCodeLineVar());
+	SCodeLineVar& rLineVar = rLine.vecVar.back();
+
+	rLineVar.iSymID = iSymID;
+	rLineVar.sName  = rVar.Name();
+
+	ECodeDataType eType = rVar.Type();
+	if (rVar.IsPtr() || eType == PDT_VEXLIST || eType == PDT_TENSOR_IDX || eType >= PDT_PTR_STRING)
+	{
+		rLine.bReusable = false;
+	}
+	else if (rLine.bReusable)
+	{
+		rLineVar.xIn = rVar;
+	}
+}
+
+//////////////////////////////////////////////////////////////////////
+/// Record call of external function by the current code line
+
+void CCLUCodeBase::OnCallFunc(CCodeElement& rFunc, CCodeVar& rPars)
+{
+	if (m_iCurCodeLine < 0 || IsCacheableFunc(rFunc))
+	{
+		return;
+	}
+
+	m_vecCodeLine[m_iCurCodeLine].bReusable = false;
+
+	HashCombine(m_nCodeLineEnvHash, std::string(rFunc.GetName().Str()));
+	HashVar(m_nCodeLineEnvHash, rPars);
+}
+
+//////////////////////////////////////////////////////////////////////
+/// Finish tracking of code line
+
+void CCLUCodeBase::EndCodeLine(int iLine, bool bOK)
+{
+	if (m_iCurCodeLine != iLine)
+	{
+		return;
+	}
+
+	m_iCurCodeLine   = -1;
+	m_bTrackCodeLine = false;
+
+	SCodeLine& rLine = m_vecCodeLine[iLine];
+
+	GetCodeLineState(rLine.xEnd);
+
+	COGLBaseElementList* pScene = rLine.xStart.xDraw.pScene;
+
+	if (!bOK || !pScene || rLine.xEnd.xDraw.pScene != pScene
+	    || pScene->GetElementList().size() < rLine.nSceneStart)
+	{
+		rLine.bReusable = false;
+	}
+
+	// Variables referring to scenes or images accessed by an executed line
+	// may have changed content.
+	for (SCodeLineVar& rLineVar : rLine.vecVar)
+	{
+		CCodeVar& rVar = m_mVarList.GetVar(rLineVar.iSymID);
+
+		if (IsRefVar(rVar) || IsRefVar(rLineVar.xIn))
+		{
+			m_setCodeLineRefVar.insert(rLineVar.iSymID);
+		}
+
+		if (rLine.bReusable)
+		{
+			if (rVar.IsPtr() || rVar.Type() >= PDT_PTR_STRING)
+			{
+				rLine.bReusable = false;
+			}
+			else
+			{
+				rLineVar.xOut = rVar;
+			}
+		}
+	}
+
+	if (!rLine.bReusable)
+	{
+		rLine.vecVar.clear();
+		rLine.bValid = true;
+		return;
+	}
+
+	// Elements appended to scene
+	const list<COGLBEReference>& listElement = pScene->GetElementList();
+	size_t nNewCnt = listElement.size() - rLine.nSceneStart;
+
+	auto itEl = listElement.end();
+	std::advance(itEl, -ptrdiff_t(nNewCnt));
+
+	rLine.vecElement.reserve(nNewCnt);
+	for (; itEl != listElement.end(); ++itEl)
+	{
+		rLine.vecElement.push_back(*itEl);
+	}
+
+	rLine.bValid = true;
+}
+
+//////////////////////////////////////////////////////////////////////
+/// Reproduce effect of code line if its inputs did not change.
+/// Returns true if the line need not be executed.
+
+bool CCLUCodeBase::SkipCodeLine(int iLine)
+{
+	if (!m_bCodeLineSkipInRun || !m_bIncrementalExec || iLine >= int(m_vecCodeLine.size()))
+	{
+		return false;
+	}
+
+	SCodeLine& rLine = m_vecCodeLine[iLine];
+
+	if (!rLine.bValid || !rLine.bReusable || rLine.nEnvHash != m_nCodeLineEnvHash)
+	{
+		return false;
+	}
+
+	SCodeLineState xState;
+	GetCodeLineState(xState);
+
+	const SCodeLineState& rStart = rLine.xStart;
+	if (!xState.xDraw.IsEqual(rStart.xDraw)
+	    || memcmp((const float*) xState.xBMPPos, (const float*) rStart.xBMPPos, 3 * sizeof(float)) != 0
+	    || xState.fVBMPAlign != rStart.fVBMPAlign || xState.fHBMPAlign != rStart.fHBMPAlign
+	    || xState.fVLatexAlign != rStart.fVLatexAlign || xState.fHLatexAlign != rStart.fHLatexAlign
+	    || xState.fBitmapScale != rStart.fBitmapScale
+	    || xState.iTextPrec != rStart.iTextPrec
+	    || xState.iPlotMode != rStart.iPlotMode)
+	{
+		return false;
+	}
+
+	for (SCodeLineVar& rLineVar : rLine.vecVar)
+	{
+		if (m_setCodeLineRefVar.count(rLineVar.iSymID) > 0
+		    || !IsEqualVar(m_mVarList.GetVar(rLineVar.iSymID), rLineVar.xIn))
+		{
+			return false;
+		}
+	}
+
+	// Reproduce effect of line
+	for (SCodeLineVar& rLineVar : rLine.vecVar)
+	{
+		if (rLineVar.xOut.Type() == PDT_NOTYPE)
+		{
+			continue;
+		}
+
+		CCodeVar& rVar = NewVar(rLineVar.sName.c_str(), PDT_NOTYPE, NS_GLOBAL, rLineVar.iSymID);
+		rVar = rLineVar.xOut;
+	}
+
+	for (const COGLBEReference& rElement : rLine.vecElement)
+	{
+		rStart.xDraw.pScene->Add(rElement);
+	}
+
+	SetCodeLineState(rLine.xEnd);
+
+	++m_uCodeLineSkipCount;
+	return true;
+}
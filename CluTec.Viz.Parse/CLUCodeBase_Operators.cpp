@@ -38,6 +38,9 @@
 #include "CluTec.Viz.Base\TensorSingleLoop.h"
 #include "CluTec.Viz.Base\TensorContractLoop.h"
 #include "CluTec.Viz.Base\TensorOperators.h"
+#include "CluTec.Viz.Base\matkernel.h"
+
+#include <atomic>
 
 
 bool CCLUCodeBase::OpAssign(CCodeVar& rLVar, CCodeVar& rRVar, int iLine, int iPos)
@@ -328,6 +331,7 @@ bool CCLUCodeBase::OpLShift(CCodeVar& _rLVar, CCodeVar& _rRVar, int iLine, int i
 
 			if (iRCount > 0)
 			{
+				rLList.EnableInPlaceChunkAlloc();
 				rLList.Add(iRCount);
 				for (i = 0; i < iRCount; i++)
 				{
@@ -349,6 +353,8 @@ bool CCLUCodeBase::OpLShift(CCodeVar& _rLVar, CCodeVar& _rRVar, int iLine, int i
 		{
 			TVarList& rLList = *rLVar.GetVarListPtr();
 
+			// Lists are often built by appending single elements
+			rLList.EnableInPlaceChunkAlloc();
 			rLList.Add(1);
 			rLList.Last() = rRVar;
 			rLList.Last().DereferencePtr();	// Don't add pointers to list
@@ -369,14 +375,11 @@ bool CCLUCodeBase::OpLShift(CCodeVar& _rLVar, CCodeVar& _rRVar, int iLine, int i
 	}
 	else if (eLType == PDT_STRING)
 	{
-		CCodeVar rResVar;
-
-		if (!OpAdd(rLVar, rRVar, rResVar, iLine, iPos))
+		// Appends to the string in place
+		if (!OpAdd(rLVar, rRVar, rLVar, iLine, iPos))
 		{
 			return false;
 		}
-
-		rLVar = rResVar;
 	}
 	else if (eLType == PDT_SCENE)
 	{
@@ -876,6 +879,264 @@ bool CCLUCodeBase::OpAND(CCodeVar& _rLVar, CCodeVar& _rRVar, CCodeVar& rResVar,
 	return true;
 }
 
+//////////////////////////////////////////////////////////////////////
+/// Dense evaluation of point operators on lists
+///
+/// If all elements of both lists are scalars or counters, or all are multivectors
+/// of the same algebra, the point operators are evaluated in a typed loop over the
+/// lists instead of calling the point operator for each pair of elements.
+/// Long lists are split across the threads of the matrix thread pool.
+/// The results are the same as those of the element by element evaluation.
+
+#define POINTLIST_SCALAR_GRAIN	4096
+#define POINTLIST_MULTIV_GRAIN	64
+
+CCLUCodeBase::EPointListType CCLUCodeBase::GetPointListType(EPointListOp eOp, TVarList& rL, TVarList& rR)
+{
+	size_t nIdx, nCount = rL.Count();
+
+	if ((nCount == 0) || (rR.Count() != nCount))
+	{
+		return POINTLIST_NONE;
+	}
+
+	ECodeDataType eType = rL(0).Type();
+
+	if ((eType == PDT_SCALAR) || (eType == PDT_COUNTER))
+	{
+		// The inner product of scalars is an error, which is reported by OpInnerProd
+		if (eOp == POINTLIST_INNERPROD)
+		{
+			return POINTLIST_NONE;
+		}
+
+		for (nIdx = 0; nIdx < nCount; ++nIdx)
+		{
+			ECodeDataType eLType = rL(nIdx).Type();
+			ECodeDataType eRType = rR(nIdx).Type();
+
+			if (((eLType != PDT_SCALAR) && (eLType != PDT_COUNTER))
+			    || ((eRType != PDT_SCALAR) && (eRType != PDT_COUNTER)))
+			{
+				return POINTLIST_NONE;
+			}
+		}
+
+		return POINTLIST_SCALAR;
+	}
+	else if (eType == PDT_MULTIV)
+	{
+		if ((eOp != POINTLIST_ADD) && (eOp != POINTLIST_SUBTRACT) && (eOp != POINTLIST_PROD)
+		    && (eOp != POINTLIST_WEDGE) && (eOp != POINTLIST_INNERPROD))
+		{
+			return POINTLIST_NONE;
+		}
+
+		TMultiV& vFirst = *rL(0).GetMultiVPtr();
+
+		if (!vFirst.HasStyle())
+		{
+			return POINTLIST_NONE;
+		}
+
+		int iBaseID = vFirst.GetBase().BaseID();
+
+		for (nIdx = 0; nIdx < nCount; ++nIdx)
+		{
+			CCodeVar& rLVar = rL(nIdx);
+			CCodeVar& rRVar = rR(nIdx);
+
+			if ((rLVar.Type() != PDT_MULTIV) || (rRVar.Type() != PDT_MULTIV))
+			{
+				return POINTLIST_NONE;
+			}
+
+			TMultiV& vA = *rLVar.GetMultiVPtr();
+			TMultiV& vB = *rRVar.GetMultiVPtr();
+
+			if (!vA.HasStyle() || !vB.HasStyle()
+			    || (vA.GetBase().BaseID() != iBaseID) || (vB.GetBase().BaseID() != iBaseID))
+			{
+				return POINTLIST_NONE;
+			}
+		}
+
+		return POINTLIST_MULTIV;
+	}
+
+	return POINTLIST_NONE;
+}
+
+//////////////////////////////////////////////////////////////////////
+/// Evaluate point operator on lists. eType is the result of GetPointListType() for the lists.
+
+bool CCLUCodeBase::OpPointList(EPointListOp eOp, EPointListType eType, TVarList& rL, TVarList& rR, TVarList& rRes, int iLine, int iPos)
+{
+	size_t nCount = rL.Count();
+
+	if (eType == POINTLIST_NONE)
+	{
+		m_ErrorList.GeneralError("Lists cannot be evaluated element by element.", iLine, iPos);
+		return false;
+	}
+
+	if (!rRes.Set(nCount))
+	{
+		m_ErrorList.OutOfMemory(iLine, iPos);
+		return false;
+	}
+
+	std::atomic<bool> bDivByZero(false), bError(false);
+	TCVScalar fSensitivity = m_fSensitivity;
+
+	// Precision of the scalar casts, as in CCodeVar::CastToScalar()
+	TCVScalar fScalarPrec = m_fSensitivity;
+	if (fScalarPrec == 0)
+	{
+		Tiny(fScalarPrec);
+	}
+
+	if (eType == POINTLIST_SCALAR)
+	{
+		MatrixParallelFor(nCount >= 2 * POINTLIST_SCALAR_GRAIN, 0, nCount, POINTLIST_SCALAR_GRAIN,
+			[&](size_t nFirst, size_t nLast)
+		{
+			for (size_t nIdx = nFirst; nIdx < nLast; ++nIdx)
+			{
+				CCodeVar& rLVar = rL(nIdx);
+				CCodeVar& rRVar = rR(nIdx);
+
+				TCVScalar fL = (rLVar.Type() == PDT_SCALAR ? *rLVar.GetScalarPtr() : TCVScalar(*rLVar.GetCounterPtr()));
+				TCVScalar fR = (rRVar.Type() == PDT_SCALAR ? *rRVar.GetScalarPtr() : TCVScalar(*rRVar.GetCounterPtr()));
+
+				// Values within the sensitivity are zero, as for CastToScalar() in the element by element operators
+				fL = (::IsZero(fL, fScalarPrec) ? TCVScalar(0) : fL);
+				fR = (::IsZero(fR, fScalarPrec) ? TCVScalar(0) : fR);
+
+				switch (eOp)
+				{
+				case POINTLIST_ADD:
+					rRes(nIdx) = fL + fR;
+					break;
+
+				case POINTLIST_SUBTRACT:
+					rRes(nIdx) = fL - fR;
+					break;
+
+				case POINTLIST_PROD:
+				case POINTLIST_WEDGE:
+					rRes(nIdx) = fL * fR;
+					break;
+
+				case POINTLIST_DIV:
+					if (fR == TCVScalar(0))
+					{
+						bDivByZero = true;
+					}
+					else
+					{
+						rRes(nIdx) = fL / fR;
+					}
+					break;
+
+				case POINTLIST_EQUAL:
+					rRes(nIdx) = TCVCounter(fL == fR ? 1 : 0);
+					break;
+
+				case POINTLIST_NOTEQUAL:
+					rRes(nIdx) = TCVCounter(fL == fR ? 0 : 1);
+					break;
+
+				case POINTLIST_GREATER:
+					rRes(nIdx) = TCVCounter(fL > fR ? 1 : 0);
+					break;
+
+				case POINTLIST_LESS:
+					rRes(nIdx) = TCVCounter(fL < fR ? 1 : 0);
+					break;
+
+				case POINTLIST_GREATEREQUAL:
+					rRes(nIdx) = TCVCounter(fL >= fR ? 1 : 0);
+					break;
+
+				case POINTLIST_LESSEQUAL:
+					rRes(nIdx) = TCVCounter(fL <= fR ? 1 : 0);
+					break;
+
+				default:
+					bError = true;
+					break;
+				}
+			}
+		});
+	}
+	else
+	{
+		MatrixParallelFor(nCount >= 2 * POINTLIST_MULTIV_GRAIN, 0, nCount, POINTLIST_MULTIV_GRAIN,
+			[&](size_t nFirst, size_t nLast)
+		{
+			try
+			{
+				TMultiV vRes;
+
+				for (size_t nIdx = nFirst; nIdx < nLast; ++nIdx)
+				{
+					TMultiV& vA = *rL(nIdx).GetMultiVPtr();
+					TMultiV& vB = *rR(nIdx).GetMultiVPtr();
+
+					switch (eOp)
+					{
+					case POINTLIST_ADD:
+						vRes = vA + vB;
+						break;
+
+					case POINTLIST_SUBTRACT:
+						vRes = vA - vB;
+						break;
+
+					case POINTLIST_PROD:
+						vRes = vA & vB;
+						break;
+
+					case POINTLIST_WEDGE:
+						vRes = vA ^ vB;
+						break;
+
+					case POINTLIST_INNERPROD:
+						vRes = vA * vB;
+						break;
+
+					default:
+						bError = true;
+						return;
+					}
+
+					rRes(nIdx).New(PDT_MULTIV);
+					rRes(nIdx) = vRes.TinyToZero(fSensitivity);
+				}
+			}
+			catch (...)
+			{
+				bError = true;
+			}
+		});
+	}
+
+	if (bDivByZero)
+	{
+		m_ErrorList.DivByZero(iLine, iPos);
+		return false;
+	}
+
+	if (bError)
+	{
+		m_ErrorList.GeneralError("Error evaluating operator on list elements.", iLine, iPos);
+		return false;
+	}
+
+	return true;
+}
+
 //////////////////////////////////////////////////////////////////////
 /// Point AND Operator .&&
 /// Element by element ANDing of lists and matrices
@@ -1157,6 +1418,12 @@ bool CCLUCodeBase::OpPointEqual(CCodeVar& _rLVar, CCodeVar& _rRVar, CCodeVar& rR
 			return false;
 		}
 
+		EPointListType eListType = GetPointListType(POINTLIST_EQUAL, rL, rR);
+		if (eListType != POINTLIST_NONE)
+		{
+			return OpPointList(POINTLIST_EQUAL, eListType, rL, rR, rRes, iLine, iPos);
+		}
+
 		int i, iCount = int(rL.Count());
 		rRes.Set(iCount);
 
@@ -1269,6 +1536,12 @@ bool CCLUCodeBase::OpPointNotEqual(CCodeVar& _rLVar, CCodeVar& _rRVar, CCodeVar&
 			return false;
 		}
 
+		EPointListType eListType = GetPointListType(POINTLIST_NOTEQUAL, rL, rR);
+		if (eListType != POINTLIST_NONE)
+		{
+			return OpPointList(POINTLIST_NOTEQUAL, eListType, rL, rR, rRes, iLine, iPos);
+		}
+
 		int i, iCount = int(rL.Count());
 		rRes.Set(iCount);
 
@@ -1430,6 +1703,12 @@ bool CCLUCodeBase::OpPointDiv(CCodeVar& _rLVar, CCodeVar& _rRVar, CCodeVar& rRes
 				return false;
 			}
 
+			EPointListType eListType = GetPointListType(POINTLIST_DIV, rL, rR);
+			if (eListType != POINTLIST_NONE)
+			{
+				return OpPointList(POINTLIST_DIV, eListType, rL, rR, rRes, iLine, iPos);
+			}
+
 			int i, iCount = int(rL.Count());
 			rRes.Set(iCount);
 
@@ -1589,6 +1868,12 @@ bool CCLUCodeBase::OpPointProd(CCodeVar& _rLVar, CCodeVar& _rRVar, CCodeVar& rRe
 				return false;
 			}
 
+			EPointListType eListType = GetPointListType(POINTLIST_PROD, rL, rR);
+			if (eListType != POINTLIST_NONE)
+			{
+				return OpPointList(POINTLIST_PROD, eListType, rL, rR, rRes, iLine, iPos);
+			}
+
 			int i, iCount = int(rL.Count());
 			rRes.Set(iCount);
 
@@ -1708,6 +1993,12 @@ bool CCLUCodeBase::OpPointInnerProd(CCodeVar& _rLVar, CCodeVar& _rRVar, CCodeVar
 			return false;
 		}
 
+		EPointListType eListType = GetPointListType(POINTLIST_INNERPROD, rL, rR);
+		if (eListType != POINTLIST_NONE)
+		{
+			return OpPointList(POINTLIST_INNERPROD, eListType, rL, rR, rRes, iLine, iPos);
+		}
+
 		int i, iCount = int(rL.Count());
 		rRes.Set(iCount);
 
@@ -1818,6 +2109,12 @@ bool CCLUCodeBase::OpPointWedge(CCodeVar& _rLVar, CCodeVar& _rRVar, CCodeVar& rR
 			return false;
 		}
 
+		EPointListType eListType = GetPointListType(POINTLIST_WEDGE, rL, rR);
+		if (eListType != POINTLIST_NONE)
+		{
+			return OpPointList(POINTLIST_WEDGE, eListType, rL, rR, rRes, iLine, iPos);
+		}
+
 		int i, iCount = int(rL.Count());
 		rRes.Set(iCount);
 
@@ -1928,6 +2225,12 @@ bool CCLUCodeBase::OpPointSubtract(CCodeVar& _rLVar, CCodeVar& _rRVar, CCodeVar&
 			return false;
 		}
 
+		EPointListType eListType = GetPointListType(POINTLIST_SUBTRACT, rL, rR);
+		if (eListType != POINTLIST_NONE)
+		{
+			return OpPointList(POINTLIST_SUBTRACT, eListType, rL, rR, rRes, iLine, iPos);
+		}
+
 		int i, iCount = int(rL.Count());
 		rRes.Set(iCount);
 
@@ -2038,6 +2341,12 @@ bool CCLUCodeBase::OpPointAdd(CCodeVar& _rLVar, CCodeVar& _rRVar, CCodeVar& rRes
 			return false;
 		}
 
+		EPointListType eListType = GetPointListType(POINTLIST_ADD, rL, rR);
+		if (eListType != POINTLIST_NONE)
+		{
+			return OpPointList(POINTLIST_ADD, eListType, rL, rR, rRes, iLine, iPos);
+		}
+
 		int i, iCount = int(rL.Count());
 		rRes.Set(iCount);
 
@@ -2155,6 +2464,12 @@ bool CCLUCodeBase::OpPointGreater(CCodeVar& _rLVar, CCodeVar& _rRVar, CCodeVar&
 			return false;
 		}
 
+		EPointListType eListType = GetPointListType(POINTLIST_GREATER, rL, rR);
+		if (eListType != POINTLIST_NONE)
+		{
+			return OpPointList(POINTLIST_GREATER, eListType, rL, rR, rRes, iLine, iPos);
+		}
+
 		int i, iCount = int(rL.Count());
 		rRes.Set(iCount);
 
@@ -2272,6 +2587,12 @@ bool CCLUCodeBase::OpPointLess(CCodeVar& _rLVar, CCodeVar& _rRVar, CCodeVar& rRe
 			return false;
 		}
 
+		EPointListType eListType = GetPointListType(POINTLIST_LESS, rL, rR);
+		if (eListType != POINTLIST_NONE)
+		{
+			return OpPointList(POINTLIST_LESS, eListType, rL, rR, rRes, iLine, iPos);
+		}
+
 		int i, iCount = int(rL.Count());
 		rRes.Set(iCount);
 
@@ -2389,6 +2710,12 @@ bool CCLUCodeBase::OpPointGreaterEqual(CCodeVar& _rLVar, CCodeVar& _rRVar, CCode
 			return false;
 		}
 
+		EPointListType eListType = GetPointListType(POINTLIST_GREATEREQUAL, rL, rR);
+		if (eListType != POINTLIST_NONE)
+		{
+			return OpPointList(POINTLIST_GREATEREQUAL, eListType, rL, rR, rRes, iLine, iPos);
+		}
+
 		int i, iCount = int(rL.Count());
 		rRes.Set(iCount);
 
@@ -2506,6 +2833,12 @@ bool CCLUCodeBase::OpPointLessEqual(CCodeVar& _rLVar, CCodeVar& _rRVar, CCodeVar
 			return false;
 		}
 
+		EPointListType eListType = GetPointListType(POINTLIST_LESSEQUAL, rL, rR);
+		if (eListType != POINTLIST_NONE)
+		{
+			return OpPointList(POINTLIST_LESSEQUAL, eListType, rL, rR, rRes, iLine, iPos);
+		}
+
 		int i, iCount = int(rL.Count());
 		rRes.Set(iCount);
 
@@ -4121,11 +4454,22 @@ bool CCLUCodeBase::OpAdd(CCodeVar& _rLVar, CCodeVar& _rRVar, CCodeVar& rResVar,
 		{
 			CStrMem csLeft, csRight;
 
-			CastToString(rLVar, csLeft);
 			CastToString(rRVar, csRight);
 
+			// If the result is the left string, append to it without copying it.
+			// The right string is cast first, in case it is the same variable.
+			if ((eLType == PDT_STRING) && (&rResVar.DereferenceVarPtr(true) == &rLVar))
+			{
+				*rLVar.GetStringPtr() << csRight;
+				return true;
+			}
+
+			CastToString(rLVar, csLeft);
+
 			rResVar.New(PDT_STRING);
-			rResVar = csLeft + csRight;
+			TString& csResult = *rResVar.GetStringPtr();
+			csResult = std::move(csLeft);
+			csResult << csRight;
 			return true;
 		}
 		else if (eLType == PDT_MULTIV)
@@ -5714,6 +6058,9 @@ bool CCLUCodeBase::OpOGLDraw(CCodeVar& _rVar, CCodeVar& rResVar, int iLine, int
 		break;
 
 	case PDT_INT:
+		// Filter and plot modes are not part of the recorded draw state
+		MarkCodeLineVolatile(uint(*rVar.GetIntPtr()));
+
 		if (!SetPlotMode(*rVar.GetIntPtr()))
 		{
 			if (!m_pDrawBase->SetMode(*rVar.GetIntPtr()))
@@ -5941,6 +6288,9 @@ bool CCLUCodeBase::OpPrint(CCodeVar& _rVar, CCodeVar& rResVar, int iLine, int iP
 	// Get reference to content of variable
 	CCodeVar& rVar = _rVar.DereferenceVarPtr(true);
 
+	// The output list is rebuilt in every run
+	MarkCodeLineVolatile();
+
 	//if (rVar.BaseType() == PDT_NOTYPE)
 	//{
 	//	m_ErrorList.InvalidType(rVar, iLine, iPos);
@@ -2492,53 +2492,40 @@ bool CCLUCodeBase::CastToHTMLString(CCodeVar& _rVar, CStrMem& csVal, const char*
 	}
 	else if (rVar.BaseType() == PDT_STRING)
 	{
-		char* pcVal, cEl;
-		int iPos, iStrPos, iMaxPos = 1000, iStrLen;
-		char pcBuf[1010];
+		TString& csText = *rVar.GetStringPtr();
+		const char* pcVal = csText.Str();
+		const char* pcEsc;
+		size_t nPos, nStart = 0, nLen = csText.Len();
 
-		csVal   = "";
-		pcVal   = rVar.GetStringPtr()->Str();
-		iStrLen = int(strlen(pcVal));
+		csVal = "";
+		csVal.Reserve(nLen);
 
-		iPos     = 0;
-		iStrPos  = 0;
-		pcBuf[0] = 0;
-		while (iStrPos < iStrLen)
+		// Append the characters between two escaped characters at once
+		for (nPos = 0; nPos < nLen; ++nPos)
 		{
-			cEl = pcVal[iStrPos++];
-			if (cEl == '<')
+			if (pcVal[nPos] == '<')
 			{
-				strcat_s(pcBuf, 1010, "&lt;");
-				iPos += 4;
+				pcEsc = "&lt;";
 			}
-			else if (cEl == '>')
+			else if (pcVal[nPos] == '>')
 			{
-				strcat_s(pcBuf, 1010, "&gt;");
-				iPos += 4;
+				pcEsc = "&gt;";
 			}
-			else if (cEl == '\n')
+			else if (pcVal[nPos] == '\n')
 			{
-				strcat_s(pcBuf, 1010, "<br>");
-				iPos += 4;
+				pcEsc = "<br>";
 			}
 			else
 			{
-				pcBuf[iPos++] = cEl;
-				pcBuf[iPos]   = 0;
+				continue;
 			}
 
-			if (iPos >= iMaxPos)
-			{
-				csVal << pcBuf;
-				iPos     = 0;
-				pcBuf[0] = 0;
-			}
+			csVal.Append(&pcVal[nStart], nPos - nStart);
+			csVal.Append(pcEsc, 4);
+			nStart = nPos + 1;
 		}
 
-		if (iPos > 0)
-		{
-			csVal << pcBuf;
-		}
+		csVal.Append(&pcVal[nStart], nLen - nStart);
 	}
 	else
 	{
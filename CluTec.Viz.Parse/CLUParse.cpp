@@ -445,6 +445,7 @@ bool CCLUParse::Init()
 			OPFUNC(TOpBinaryPtr, OpProd),	// Binary Func. Ptr.
 			0,										// Unary Assign Func Ptr
 			0);										// Binary Assign Func Ptr.
+	m_mOps[3].SetScalarOp(CCodeOperator::SCALAROP_PROD);
 
 	m_mOps[4].Init(
 			"/",									// Op. Symbol
@@ -469,6 +470,7 @@ bool CCLUParse::Init()
 			OPFUNC(TOpBinaryPtr, OpSubtract),	// Binary Func. Ptr.
 			0,										// Unary Assign Func Ptr
 			0);										// Binary Assign Func Ptr.
+	m_mOps[5].SetScalarOp(CCodeOperator::SCALAROP_SUBTRACT);
 
 	m_mOps[6].Init(
 			"+",									// Op. Symbol
@@ -481,6 +483,7 @@ bool CCLUParse::Init()
 			OPFUNC(TOpBinaryPtr, OpAdd),	// Binary Func. Ptr.
 			0,										// Unary Assign Func Ptr
 			0);										// Binary Assign Func Ptr.
+	m_mOps[6].SetScalarOp(CCodeOperator::SCALAROP_ADD);
 
 	m_mOps[7].Init(
 			"|",									// Op. Symbol
@@ -663,6 +666,7 @@ bool CCLUParse::Init()
 			OPFUNC(TOpBinaryPtr, OpGreater),		// Binary Func. Ptr.
 			0,										// Unary Assign Func Ptr
 			0);										// Binary Assign Func Ptr.
+	m_mOps[20].SetScalarOp(CCodeOperator::SCALAROP_GREATER);
 
 	m_mOps[21].Init(
 			"<",									// Op. Symbol
@@ -675,6 +679,7 @@ bool CCLUParse::Init()
 			OPFUNC(TOpBinaryPtr, OpLess),			// Binary Func. Ptr.
 			0,										// Unary Assign Func Ptr
 			0);										// Binary Assign Func Ptr.
+	m_mOps[21].SetScalarOp(CCodeOperator::SCALAROP_LESS);
 
 	m_mOps[22].Init(
 			OC_IDSYM_LSHIFT_STR,					// Op. Symbol
@@ -699,6 +704,7 @@ bool CCLUParse::Init()
 			OPFUNC(TOpBinaryPtr, OpGreaterEqual),	// Binary Func. Ptr.
 			0,										// Unary Assign Func Ptr
 			0);										// Binary Assign Func Ptr.
+	m_mOps[23].SetScalarOp(CCodeOperator::SCALAROP_GREATEREQUAL);
 
 	m_mOps[24].Init(
 			OC_IDSYM_LE_STR,						// Op. Symbol
@@ -711,6 +717,7 @@ bool CCLUParse::Init()
 			OPFUNC(TOpBinaryPtr, OpLessEqual),		// Binary Func. Ptr.
 			0,										// Unary Assign Func Ptr
 			0);										// Binary Assign Func Ptr.
+	m_mOps[24].SetScalarOp(CCodeOperator::SCALAROP_LESSEQUAL);
 
 	m_mOps[25].Init(
 			"°",									// Op. Symbol
@@ -1753,6 +1760,7 @@ int CCLUParse::InsertText(const char* pcText, int iPos, bool bParse)
 {
 	m_vecIncludeFilename.resize(1);
 	m_vecIncludeFilename[0] = m_sScriptName + ".clu";
+	m_vecIncludeStamp.clear();
 
 	return CParse::InsertText(pcText, iPos, bParse);
 }
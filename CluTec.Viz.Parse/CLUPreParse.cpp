@@ -32,6 +32,7 @@
 #include <string>
 #include <fstream>
 #include <direct.h>
+#include <limits.h>
 
 #define DNG_KEY1        0xAF37C142
 #define DNG_KEY2        0x8E2F6250
@@ -219,6 +220,8 @@ int CCLUPreParse::PreParseText(std::vector<STextLine>& x_msText, int& x_iCurLine
 {
 	m_vecIncludeFilename.clear();
 	m_vecIncludeFilename.push_back(m_sScriptName + ".clu");
+	m_vecIncludeStamp.clear();
+	m_xIncludeCache.ResetStats();
 
 	int iNewLines = DoPreParse(x_msText, x_iCurLine, x_iCurPos, pcText, -1);
 
@@ -522,6 +525,27 @@ int CCLUPreParse::DoPreParse(std::vector<STextLine>& x_msText,
 										}
 									}
 
+									// The decoded lines depend on the password
+									std::string sCacheKey = m_sIncludeFilename + "|" + m_sScriptPath + "|" + sPass;
+									size_t nFirstLine     = x_msText.size();
+
+									int iIncludeLineCount = AddCachedInclude(x_msText, sCacheKey, -1);
+									if (iIncludeLineCount >= 0)
+									{
+										m_vecIncludeFilename.pop_back();
+
+										iCurLine    += iIncludeLineCount;
+										iAddedLines += iIncludeLineCount;
+										continue;
+									}
+
+									CIncludeCache::SFileStamp xStamp;
+									if (m_xIncludeCache.IsEnabled())
+									{
+										CIncludeCache::GetFileStamp(xStamp, m_sIncludeFilename, true);
+										xStamp.bBinary = true;
+									}
+
 									if (!ReadCLUBinaryFile(m_sIncludeFilename.c_str(), mCode, mapMetaData, sError, pcPass))
 									{
 										SetError(CPB_NO_INCLUDEFILE);
@@ -552,7 +576,7 @@ int CCLUPreParse::DoPreParse(std::vector<STextLine>& x_msText,
 										}
 									}
 
-									int iIncludeLineCount = SetTextCode(x_msText, mCode.Data(), m_sIncludeFilename.c_str(), true);
+									iIncludeLineCount = SetTextCode(x_msText, mCode.Data(), m_sIncludeFilename.c_str(), true);
 									m_vecIncludeFilename.pop_back();
 
 									if (iIncludeLineCount < 0)
@@ -565,12 +589,40 @@ int CCLUPreParse::DoPreParse(std::vector<STextLine>& x_msText,
 										return iIncludeLineCount;
 									}
 
+									// Lines of binary files keep the main file positions stored in the file
+									AddIncludeToCache(x_msText, nFirstLine, m_vecIncludeStamp.size(), sCacheKey, xStamp, INT_MIN);
+
 									iCurLine    += iIncludeLineCount;
 									iAddedLines += iIncludeLineCount;
 									continue;
 								}
 								else	// include is clu source file
 								{
+									// The lines also depend on the script path, since nested include files
+									// are searched in its '_global' subfolder.
+									std::string sCacheKey = m_sIncludeFilename + "|" + m_sScriptPath;
+									int iIncMainFilePos   = (iMainFilePos < 0 ? (i - iCommentPos) : iMainFilePos);
+									size_t nFirstLine     = x_msText.size();
+									size_t nFirstStamp    = m_vecIncludeStamp.size();
+
+									// Use the preparsed lines if the include file did not change
+									int iIncludeLineCount = AddCachedInclude(x_msText, sCacheKey, iIncMainFilePos);
+									if (iIncludeLineCount >= 0)
+									{
+										m_vecIncludeFilename.pop_back();
+
+										iCurLine    += iIncludeLineCount;
+										iAddedLines += iIncludeLineCount;
+										continue;
+									}
+
+									// Get the stamp before reading the file, so that later changes are detected
+									CIncludeCache::SFileStamp xStamp;
+									if (m_xIncludeCache.IsEnabled())
+									{
+										CIncludeCache::GetFileStamp(xStamp, m_sIncludeFilename, true);
+									}
+
 									// Read include file
 									sVal = "";
 									zFile.clear();
@@ -626,9 +678,8 @@ int CCLUPreParse::DoPreParse(std::vector<STextLine>& x_msText,
 										// Switch working directory to path of include file
 
 										// Preparse include file
-										int iIncludeLineCount = DoPreParse(x_msText, x_iCurLine, x_iCurPos, sVal.c_str(), iCurLine,
-												m_sIncludeFilename.c_str(), (iMainFilePos < 0 ? (i - iCommentPos) : iMainFilePos),
-												false);
+										iIncludeLineCount = DoPreParse(x_msText, x_iCurLine, x_iCurPos, sVal.c_str(), iCurLine,
+												m_sIncludeFilename.c_str(), iIncMainFilePos, false);
 
 										// Switch back to previous working directory
 										_chdir(sCWD.c_str());
@@ -645,6 +696,8 @@ int CCLUPreParse::DoPreParse(std::vector<STextLine>& x_msText,
 											return iIncludeLineCount;
 										}
 
+										AddIncludeToCache(x_msText, nFirstLine, nFirstStamp, sCacheKey, xStamp, iIncMainFilePos);
+
 										iCurLine    += iIncludeLineCount;
 										iAddedLines += iIncludeLineCount;
 										continue;
@@ -1353,6 +1406,57 @@ int CCLUPreParse::DoPreParse(std::vector<STextLine>& x_msText,
 	return iAddedLines;
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Append the preparsed lines of an include file from the cache
+
+int CCLUPreParse::AddCachedInclude(std::vector<STextLine>& x_msText, const std::string& sKey, int iMainFilePos)
+{
+	const CIncludeCache::SEntry* pEntry = m_xIncludeCache.Find(sKey, m_vecIncludeFilename);
+	if (!pEntry)
+	{
+		return -1;
+	}
+
+	// The lines of the include file and of the source files it includes have the main file position
+	// of the include statement they were preparsed for.
+	x_msText.insert(x_msText.end(), pEntry->vecLine.begin(), pEntry->vecLine.end());
+	for (size_t nLine = x_msText.size() - pEntry->vecLine.size(); nLine < x_msText.size(); ++nLine)
+	{
+		if (x_msText[nLine].iMainFilePos == pEntry->iMainFilePos)
+		{
+			x_msText[nLine].iMainFilePos = iMainFilePos;
+		}
+	}
+
+	// Files that an enclosing include file depends on
+	m_vecIncludeStamp.insert(m_vecIncludeStamp.end(), pEntry->vecFile.begin(), pEntry->vecFile.end());
+
+	return int(pEntry->vecLine.size());
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Store the lines added to x_msText since nFirstLine as preparsed include file.
+// The files included since nFirstStamp are the files the include file depends on.
+
+void CCLUPreParse::AddIncludeToCache(const std::vector<STextLine>& x_msText, size_t nFirstLine, size_t nFirstStamp,
+		const std::string& sKey, const CIncludeCache::SFileStamp& xStamp, int iMainFilePos)
+{
+	if (!m_xIncludeCache.IsEnabled())
+	{
+		return;
+	}
+
+	CIncludeCache::SEntry xEntry;
+	xEntry.vecFile.push_back(xStamp);
+	xEntry.vecFile.insert(xEntry.vecFile.end(), m_vecIncludeStamp.begin() + nFirstStamp, m_vecIncludeStamp.end());
+	xEntry.iMainFilePos = iMainFilePos;
+	xEntry.vecLine.assign(x_msText.begin() + nFirstLine, x_msText.end());
+
+	m_xIncludeCache.Add(sKey, xEntry);
+
+	m_vecIncludeStamp.push_back(xStamp);
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Test whether current '(' symbol refers to a function call
 
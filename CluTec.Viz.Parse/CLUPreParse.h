@@ -29,6 +29,7 @@
 #include "OCIDSymDef.h"
 #include "Defines.h"
 #include "ParseTypes.h"
+#include "IncludeCache.h"
 
 #include <string>
 #include <map>
@@ -108,6 +109,28 @@ public:
 
 	bool GenTextCode(std::vector<char>& vecCode, const std::vector<STextLine>& x_msText);
 
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	/// <summary>
+	/// 	Enables the cache of preparsed include files. Include files that did not change since they were last preparsed
+	/// 	are taken from the cache. Disabling the cache removes all entries.
+	/// </summary>
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	void EnableIncludeCache(bool bVal) { m_xIncludeCache.Enable(bVal); }
+	bool IsIncludeCacheEnabled() const { return m_xIncludeCache.IsEnabled(); }
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	/// <summary>
+	/// 	Sets the folder the include cache writes its entries to, so that they are also available after a restart.
+	/// 	Entries are only kept in memory if the path is empty.
+	/// </summary>
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	void SetIncludeCachePath(const char* pcPath) { m_xIncludeCache.SetCachePath(pcPath ? pcPath : ""); }
+
+	void ClearIncludeCache() { m_xIncludeCache.Clear(); }
+
+	// Hits and misses of the include cache while the last script was preparsed
+	const CIncludeCache::SStats& GetIncludeCacheStats() const { return m_xIncludeCache.GetStats(); }
+
 protected:
 
 	// Insert lines of text before iPos.
@@ -125,6 +148,14 @@ protected:
 			int iMainFilePos = -1,
 			bool bUseScriptPath = true);
 
+	// Append the lines of an include file from the include cache, if they are valid.
+	// Returns number of lines added. Returns -1 if the cache has no valid entry.
+	int AddCachedInclude(std::vector<STextLine>& x_msText, const std::string& sKey, int iMainFilePos);
+
+	// Store the lines of an include file in the include cache.
+	void AddIncludeToCache(const std::vector<STextLine>& x_msText, size_t nFirstLine, size_t nFirstStamp,
+			const std::string& sKey, const CIncludeCache::SFileStamp& xStamp, int iMainFilePos);
+
 	// Test whether current '(' symbol refers to a function call
 	bool IsFuncCall(const char* pcInputText, int iIdx, int iLen);
 
@@ -144,6 +175,10 @@ protected:
 
 	std::vector<std::string> m_vecIncludeFilename;
 
+	// Preparsed include files and the files included while preparsing the current script
+	CIncludeCache m_xIncludeCache;
+	std::vector<CIncludeCache::SFileStamp> m_vecIncludeStamp;
+
 	/************************************************************************/
 	/* BASE                                                                 */
 	/************************************************************************/
@@ -0,0 +1,424 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// project:   CluTec.Viz.Parse
+// file:      ChunkFile.cpp
+//
+// summary:   Implements the chunk file classes
+//
+//            Copyright (c) 2019 by Christian Perwass.
+//
+//            This file is part of the CluTecLib library.
+//
+//            The CluTecLib library is free software: you can redistribute it and / or modify
+//            it under the terms of the GNU Lesser General Public License as published by
+//            the Free Software Foundation, either version 3 of the License, or
+//            (at your option) any later version.
+//
+//            The CluTecLib library is distributed in the hope that it will be useful,
+//            but WITHOUT ANY WARRANTY; without even the implied warranty of
+//            MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//            GNU Lesser General Public License for more details.
+//
+//            You should have received a copy of the GNU Lesser General Public License
+//            along with the CluTecLib library.
+//            If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "StdAfx.h"
+#include "ChunkFile.h"
+#include "zlib\zlib.h"
+
+#include "CluTec.Viz.Base\matkernel.h"
+
+#include <string.h>
+#include <atomic>
+
+static const char s_pcChunkFileID[8] = { 'C', 'L', 'U', 'C', 'H', 'U', 'N', 'K' };
+
+// Number of chunks that are compressed in parallel before they are written.
+// Limits the memory needed for the compressed data.
+static size_t ChunkGroupSize()
+{
+	return 4 * size_t(CMatrixThreadPool::Global().ThreadCount());
+}
+
+static uint32_t ChunkCRC(const void* pvData, size_t nSize)
+{
+	uLong uCRC = crc32(0L, Z_NULL, 0);
+	return uint32_t(crc32(uCRC, (const Bytef*) pvData, uInt(nSize)));
+}
+
+//////////////////////////////////////////////////////////////////////
+// Chunk File Writer
+
+CChunkFileWriter::CChunkFileWriter()
+{
+	m_pFile          = 0;
+	m_iCompressLevel = 0;
+	m_uPos           = 0;
+}
+
+CChunkFileWriter::~CChunkFileWriter()
+{
+	Abort();
+}
+
+bool CChunkFileWriter::Open(const char* pcFilename, int iCompressLevel)
+{
+	Abort();
+
+	m_sError.clear();
+	m_vecTOC.clear();
+	m_iCompressLevel = (iCompressLevel < 0 ? 0 : (iCompressLevel > 9 ? 9 : iCompressLevel));
+	m_uPos           = 0;
+
+	fopen_s(&m_pFile, pcFilename, "wb");
+	if (!m_pFile)
+	{
+		m_sError = "Could not open file for writing.";
+		return false;
+	}
+
+	// The header is written again with the final values by Close()
+	SChunkFileHeader xHeader;
+	memset(&xHeader, 0, sizeof(SChunkFileHeader));
+
+	return Write(&xHeader, sizeof(SChunkFileHeader));
+}
+
+void CChunkFileWriter::Abort()
+{
+	if (m_pFile)
+	{
+		fclose(m_pFile);
+		m_pFile = 0;
+	}
+}
+
+bool CChunkFileWriter::Write(const void* pvData, size_t nSize)
+{
+	if (nSize > 0 && fwrite(pvData, 1, nSize, m_pFile) != nSize)
+	{
+		m_sError = "Error writing to file.";
+		return false;
+	}
+
+	m_uPos += nSize;
+	return true;
+}
+
+bool CChunkFileWriter::Pad()
+{
+	static const char pcZero[8] = { 0 };
+
+	return Write(pcZero, size_t((8 - (m_uPos & 7)) & 7));
+}
+
+bool CChunkFileWriter::AddArray(const void* pvData, size_t nSize, SChunkRef& xRef)
+{
+	if (!m_pFile)
+	{
+		m_sError = "File is not open.";
+		return false;
+	}
+
+	const unsigned char* pucData = (const unsigned char*) pvData;
+	size_t nChunkCnt = (nSize + CHUNKFILE_PIECE_SIZE - 1) / CHUNKFILE_PIECE_SIZE;
+
+	if (m_vecTOC.size() + nChunkCnt > size_t(UINT32_MAX))
+	{
+		m_sError = "Too many chunks in file.";
+		return false;
+	}
+
+	xRef.uFirst = uint32_t(m_vecTOC.size());
+	xRef.uCount = uint32_t(nChunkCnt);
+	xRef.uSize  = uint64_t(nSize);
+
+	size_t nGroupSize = ChunkGroupSize();
+	std::vector< std::vector<unsigned char> > vecStored;
+	std::vector<SChunkInfo> vecInfo;
+
+	for (size_t nGroup = 0; nGroup < nChunkCnt; nGroup += nGroupSize)
+	{
+		size_t nCnt = (nChunkCnt - nGroup < nGroupSize ? nChunkCnt - nGroup : nGroupSize);
+
+		vecStored.resize(nCnt);
+		vecInfo.resize(nCnt);
+
+		MatrixParallelFor(m_iCompressLevel > 0 && nCnt > 1, 0, nCnt, 1,
+			[&](size_t nFirst, size_t nLast)
+		{
+			for (size_t nIdx = nFirst; nIdx < nLast; ++nIdx)
+			{
+				size_t nOffset = (nGroup + nIdx) * CHUNKFILE_PIECE_SIZE;
+				size_t nPiece  = (nSize - nOffset < CHUNKFILE_PIECE_SIZE ? nSize - nOffset : CHUNKFILE_PIECE_SIZE);
+				const unsigned char* pucSrc = pucData + nOffset;
+				std::vector<unsigned char>& vecBuf = vecStored[nIdx];
+				SChunkInfo& xInfo = vecInfo[nIdx];
+
+				xInfo.uSize  = nPiece;
+				xInfo.uCodec = CHUNK_CODEC_NONE;
+				vecBuf.clear();
+
+				if (m_iCompressLevel > 0)
+				{
+					uLongf uStored = compressBound(uLong(nPiece));
+					vecBuf.resize(uStored);
+
+					if ((compress2(vecBuf.data(), &uStored, pucSrc, uLong(nPiece), m_iCompressLevel) == Z_OK)
+					    && (uStored < nPiece))
+					{
+						vecBuf.resize(uStored);
+						xInfo.uCodec = CHUNK_CODEC_ZLIB;
+					}
+					else
+					{
+						vecBuf.clear();
+					}
+				}
+
+				if (xInfo.uCodec == CHUNK_CODEC_NONE)
+				{
+					xInfo.uStoredSize = nPiece;
+					xInfo.uCRC        = ChunkCRC(pucSrc, nPiece);
+				}
+				else
+				{
+					xInfo.uStoredSize = vecBuf.size();
+					xInfo.uCRC        = ChunkCRC(vecBuf.data(), vecBuf.size());
+				}
+			}
+		});
+
+		for (size_t nIdx = 0; nIdx < nCnt; ++nIdx)
+		{
+			SChunkInfo& xInfo = vecInfo[nIdx];
+
+			if (!Pad())
+			{
+				return false;
+			}
+
+			xInfo.uOffset = m_uPos;
+
+			if (xInfo.uCodec == CHUNK_CODEC_NONE)
+			{
+				if (!Write(pucData + (nGroup + nIdx) * CHUNKFILE_PIECE_SIZE, size_t(xInfo.uSize)))
+				{
+					return false;
+				}
+			}
+			else if (!Write(vecStored[nIdx].data(), vecStored[nIdx].size()))
+			{
+				return false;
+			}
+
+			m_vecTOC.push_back(xInfo);
+		}
+	}
+
+	return true;
+}
+
+bool CChunkFileWriter::Close(const SChunkRef& xRoot)
+{
+	if (!m_pFile)
+	{
+		m_sError = "File is not open.";
+		return false;
+	}
+
+	SChunkFileHeader xHeader;
+
+	memset(&xHeader, 0, sizeof(SChunkFileHeader));
+	memcpy(xHeader.pcID, s_pcChunkFileID, 8);
+	xHeader.uVersion    = CHUNKFILE_VERSION;
+	xHeader.xRoot       = xRoot;
+	xHeader.uChunkCount = m_vecTOC.size();
+
+	if (!Pad())
+	{
+		Abort();
+		return false;
+	}
+
+	xHeader.uTOCOffset = m_uPos;
+
+	if (!Write(m_vecTOC.data(), m_vecTOC.size() * sizeof(SChunkInfo))
+	    || (fseek(m_pFile, 0, SEEK_SET) != 0)
+	    || (fwrite(&xHeader, sizeof(SChunkFileHeader), 1, m_pFile) != 1))
+	{
+		m_sError = "Error writing to file.";
+		Abort();
+		return false;
+	}
+
+	bool bOK = (fclose(m_pFile) == 0);
+	m_pFile = 0;
+
+	if (!bOK)
+	{
+		m_sError = "Error writing to file.";
+	}
+
+	return bOK;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Chunk File Reader
+
+CChunkFileReader::CChunkFileReader()
+{
+	memset(&m_xHeader, 0, sizeof(SChunkFileHeader));
+}
+
+CChunkFileReader::~CChunkFileReader()
+{
+}
+
+bool CChunkFileReader::Open(const char* pcFilename)
+{
+	Close();
+	m_sError.clear();
+
+	if (!m_xFile.Open(pcFilename))
+	{
+		m_sError = m_xFile.GetError();
+		return false;
+	}
+
+	const char* pcData = m_xFile.GetData();
+	uint64_t uFileSize = m_xFile.GetSize();
+
+	if (uFileSize < sizeof(SChunkFileHeader))
+	{
+		m_sError = "Specified file is not a chunk file.";
+		Close();
+		return false;
+	}
+
+	memcpy(&m_xHeader, pcData, sizeof(SChunkFileHeader));
+
+	if (memcmp(m_xHeader.pcID, s_pcChunkFileID, 8) != 0)
+	{
+		m_sError = "Specified file is not a chunk file.";
+		Close();
+		return false;
+	}
+
+	if (m_xHeader.uVersion != CHUNKFILE_VERSION)
+	{
+		m_sError = "Cannot read chunk files of this version.";
+		Close();
+		return false;
+	}
+
+	if ((m_xHeader.uTOCOffset < sizeof(SChunkFileHeader))
+	    || (m_xHeader.uTOCOffset > uFileSize)
+	    || (m_xHeader.uChunkCount > (uFileSize - m_xHeader.uTOCOffset) / sizeof(SChunkInfo)))
+	{
+		m_sError = "Table of contents of chunk file is corrupted.";
+		Close();
+		return false;
+	}
+
+	m_vecTOC.resize(size_t(m_xHeader.uChunkCount));
+	memcpy(m_vecTOC.data(), pcData + m_xHeader.uTOCOffset, m_vecTOC.size() * sizeof(SChunkInfo));
+
+	for (const SChunkInfo& xInfo : m_vecTOC)
+	{
+		if ((xInfo.uOffset < sizeof(SChunkFileHeader))
+		    || (xInfo.uOffset > m_xHeader.uTOCOffset)
+		    || (xInfo.uStoredSize > m_xHeader.uTOCOffset - xInfo.uOffset)
+		    || (xInfo.uSize > CHUNKFILE_PIECE_SIZE)
+		    || ((xInfo.uCodec == CHUNK_CODEC_NONE) && (xInfo.uStoredSize != xInfo.uSize))
+		    || (xInfo.uCodec > CHUNK_CODEC_ZLIB))
+		{
+			m_sError = "Table of contents of chunk file is corrupted.";
+			Close();
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void CChunkFileReader::Close()
+{
+	m_xFile.Close();
+	m_vecTOC.clear();
+	memset(&m_xHeader, 0, sizeof(SChunkFileHeader));
+}
+
+bool CChunkFileReader::ReadArray(const SChunkRef& xRef, void* pvData)
+{
+	if (!m_xFile.IsOpen())
+	{
+		m_sError = "File is not open.";
+		return false;
+	}
+
+	if (uint64_t(xRef.uFirst) + xRef.uCount > m_vecTOC.size())
+	{
+		m_sError = "Chunk file references missing data.";
+		return false;
+	}
+
+	// Destination offset of each chunk
+	std::vector<uint64_t> vecOffset(size_t(xRef.uCount) + 1);
+
+	vecOffset[0] = 0;
+	for (uint32_t uIdx = 0; uIdx < xRef.uCount; ++uIdx)
+	{
+		vecOffset[uIdx + 1] = vecOffset[uIdx] + m_vecTOC[xRef.uFirst + uIdx].uSize;
+	}
+
+	if (vecOffset[xRef.uCount] != xRef.uSize)
+	{
+		m_sError = "Chunk file references data of wrong size.";
+		return false;
+	}
+
+	const unsigned char* pucFile = (const unsigned char*) m_xFile.GetData();
+	unsigned char* pucData       = (unsigned char*) pvData;
+	std::atomic<bool> bOK(true);
+
+	MatrixParallelFor(xRef.uCount > 1, 0, xRef.uCount, 1,
+		[&](size_t nFirst, size_t nLast)
+	{
+		for (size_t nIdx = nFirst; nIdx < nLast && bOK; ++nIdx)
+		{
+			const SChunkInfo& xInfo = m_vecTOC[xRef.uFirst + nIdx];
+			const unsigned char* pucSrc = pucFile + xInfo.uOffset;
+			unsigned char* pucDst = pucData + vecOffset[nIdx];
+
+			if (ChunkCRC(pucSrc, size_t(xInfo.uStoredSize)) != xInfo.uCRC)
+			{
+				bOK = false;
+			}
+			else if (xInfo.uCodec == CHUNK_CODEC_NONE)
+			{
+				memcpy(pucDst, pucSrc, size_t(xInfo.uSize));
+			}
+			else
+			{
+				uLongf uSize = uLongf(xInfo.uSize);
+
+				if ((uncompress(pucDst, &uSize, pucSrc, uLong(xInfo.uStoredSize)) != Z_OK)
+				    || (uSize != xInfo.uSize))
+				{
+					bOK = false;
+				}
+			}
+		}
+	});
+
+	if (!bOK)
+	{
+		m_sError = "Chunk file is corrupted.";
+		return false;
+	}
+
+	return true;
+}
@@ -0,0 +1,168 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// project:   CluTec.Viz.Parse
+// file:      ChunkFile.h
+//
+// summary:   Declares the chunk file classes
+//
+//            Copyright (c) 2019 by Christian Perwass.
+//
+//            This file is part of the CluTecLib library.
+//
+//            The CluTecLib library is free software: you can redistribute it and / or modify
+//            it under the terms of the GNU Lesser General Public License as published by
+//            the Free Software Foundation, either version 3 of the License, or
+//            (at your option) any later version.
+//
+//            The CluTecLib library is distributed in the hope that it will be useful,
+//            but WITHOUT ANY WARRANTY; without even the implied warranty of
+//            MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//            GNU Lesser General Public License for more details.
+//
+//            You should have received a copy of the GNU Lesser General Public License
+//            along with the CluTecLib library.
+//            If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Files that consist of independently compressed chunks and a table of contents.
+// Data is split into chunks of at most CHUNKFILE_PIECE_SIZE bytes, which are compressed
+// and decompressed in parallel. The writer streams the chunks to the file as they are
+// added, and the reader maps the file and decodes only the chunks that are requested.
+//
+// File layout, all values in the byte order of the machine (little endian):
+//   Header:  SChunkFileHeader
+//   Chunks:  stored bytes of each chunk, starting at a multiple of 8 bytes
+//   TOC:     one SChunkInfo per chunk
+//
+// The header references the root data, e.g. a description of the other chunks.
+
+#if !defined(_CHUNKFILE_H__INCLUDED_)
+	#define _CHUNKFILE_H__INCLUDED_
+
+#if _MSC_VER > 1000
+#pragma once
+#endif	// _MSC_VER > 1000
+
+#include <stdio.h>
+#include <stdint.h>
+#include <vector>
+#include <string>
+
+#include "CluTec.Viz.Base\MappedFile.h"
+
+#define CHUNKFILE_VERSION		1
+#define CHUNKFILE_PIECE_SIZE	(16 * 1024 * 1024)
+
+// Reference to consecutive chunks that together hold an array of uSize bytes.
+struct SChunkRef
+{
+	uint32_t uFirst;
+	uint32_t uCount;
+	uint64_t uSize;
+};
+
+struct SChunkInfo
+{
+	uint64_t uOffset;
+	uint64_t uStoredSize;
+	uint64_t uSize;
+	uint32_t uCodec;
+	// CRC32 of the stored bytes
+	uint32_t uCRC;
+};
+
+struct SChunkFileHeader
+{
+	char pcID[8];
+	uint32_t uVersion;
+	uint32_t uReserved;
+	SChunkRef xRoot;
+	uint64_t uTOCOffset;
+	uint64_t uChunkCount;
+};
+
+enum EChunkCodec
+{
+	CHUNK_CODEC_NONE = 0,
+	CHUNK_CODEC_ZLIB = 1,
+};
+
+////////////////////////////////////////////////////////////////////////////////////
+// Chunk File Writer
+//
+	class CChunkFileWriter
+	{
+	public:
+
+		CChunkFileWriter();
+		~CChunkFileWriter();
+
+		// Compression level 0 stores all chunks uncompressed. Chunks that do not become
+		// smaller when compressed are always stored uncompressed.
+		bool Open(const char* pcFilename, int iCompressLevel);
+
+		// Write nSize bytes as consecutive chunks. xRef references them in the file.
+		bool AddArray(const void* pvData, size_t nSize, SChunkRef& xRef);
+
+		// Write the table of contents and the header and close the file.
+		bool Close(const SChunkRef& xRoot);
+
+		// Close the file without completing it.
+		void Abort();
+
+		const std::string& GetError() const { return m_sError; }
+
+	protected:
+
+		CChunkFileWriter(const CChunkFileWriter&);
+		CChunkFileWriter& operator=(const CChunkFileWriter&);
+
+		bool Write(const void* pvData, size_t nSize);
+		bool Pad();
+
+	protected:
+
+		FILE* m_pFile;
+		int m_iCompressLevel;
+		uint64_t m_uPos;
+		std::vector<SChunkInfo> m_vecTOC;
+		std::string m_sError;
+	};
+
+////////////////////////////////////////////////////////////////////////////////////
+// Chunk File Reader
+//
+	class CChunkFileReader
+	{
+	public:
+
+		CChunkFileReader();
+		~CChunkFileReader();
+
+		// Map the file and read the header and the table of contents.
+		bool Open(const char* pcFilename);
+		void Close();
+
+		bool IsOpen() const { return m_xFile.IsOpen(); }
+
+		const SChunkRef& GetRoot() const { return m_xHeader.xRoot; }
+
+		// Decode the referenced chunks into pvData, which has to hold xRef.uSize bytes.
+		bool ReadArray(const SChunkRef& xRef, void* pvData);
+
+		const std::string& GetError() const { return m_sError; }
+
+	protected:
+
+		CChunkFileReader(const CChunkFileReader&);
+		CChunkFileReader& operator=(const CChunkFileReader&);
+
+	protected:
+
+		CMappedFile m_xFile;
+		SChunkFileHeader m_xHeader;
+		std::vector<SChunkInfo> m_vecTOC;
+		std::string m_sError;
+	};
+
+#endif
@@ -34,11 +34,19 @@
 CCodeBase::CCodeBase()
 {
 	m_iLoopCountLimit = 100000;
+	m_bUseBytecode = false;
+	m_bTrackCodeLine = false;
+
+	m_uTempVarPoolLimit  = 10000;
+	m_uTempVarAllocCount = 0;
+	m_uTempVarReuseCount = 0;
+
 	SetCurrentNamespace(NS_GLOBAL);
 }
 
 CCodeBase::~CCodeBase()
 {
+	ReleaseTempVarPool();
 }
 
 //////////////////////////////////////////////////////////////////////
@@ -46,7 +54,7 @@ CCodeBase::~CCodeBase()
 // Tries first to create variable in local variable list.
 // if there is no such list, then variable is created in global list.
 
-CCodeVar& CCodeBase::NewVar(const char* pcName, ECodeDataType _nType, const char* pcNamespace)
+CCodeVar& CCodeBase::NewVar(const char* pcName, ECodeDataType _nType, const char* pcNamespace, int iSymID)
 {
 	if (pcNamespace && !strcmp(pcNamespace, NS_CURRENT))
 	{
@@ -67,19 +75,19 @@ CCodeVar& CCodeBase::NewVar(const char* pcName, ECodeDataType _nType, const char
 	{
 		if (pLocalList)
 		{
-			pLocalList->New(pcName, _nType);
-			return (*pLocalList)[pcName];
+			pLocalList->New(pcName, _nType, iSymID);
+			return (iSymID < 0 ? (*pLocalList)[pcName] : pLocalList->GetVar(iSymID));
 		}
 		else
 		{
-			m_mVarList.New(pcName, _nType);
-			return m_mVarList[pcName];
+			m_mVarList.New(pcName, _nType, iSymID);
+			return (iSymID < 0 ? m_mVarList[pcName] : m_mVarList.GetVar(iSymID));
 		}
 	}
 	else	// if (!strcmp(pcNamespace, NS_GLOBAL))
 	{
-		m_mVarList.New(pcName, _nType);
-		return m_mVarList[pcName];
+		m_mVarList.New(pcName, _nType, iSymID);
+		return (iSymID < 0 ? m_mVarList[pcName] : m_mVarList.GetVar(iSymID));
 	}
 }
 
@@ -171,6 +179,75 @@ CCodeVar& CCodeBase::GetVar(const char* pcName, const char* pcNamespace)
 	return rVar;
 }
 
+//////////////////////////////////////////////////////////////////////
+// Returns Variable of type PDT_NOTYPE if error occured.
+// Same search order as GetVar for variable names.
+
+CCodeVar& CCodeBase::GetVar(int iSymID, ENamespaceID eNamespace)
+{
+	TCodeVarListPtr pLocalVar;
+
+	if (eNamespace == NSID_CURRENT)
+	{
+		eNamespace = m_eCurNamespace;
+	}
+
+	CCodeVar& rVar = m_mConstVarList.GetVar(iSymID);
+	if (rVar.Type() != PDT_NOTYPE)
+	{
+		return rVar;
+	}
+
+	if (eNamespace == NSID_ALL || eNamespace == NSID_LOCAL)
+	{
+		if ((pLocalVar = GetStackLocalVarList(0)) != 0)
+		{
+			CCodeVar& rLVar = pLocalVar->GetVar(iSymID);
+
+			if (rLVar.Type() != PDT_NOTYPE)
+			{
+				return rLVar;
+			}
+		}
+		else
+		{
+			return m_mVarList.GetVar(iSymID);
+		}
+	}
+
+	if (eNamespace == NSID_ALL || eNamespace == NSID_GLOBAL)
+	{
+		return m_mVarList.GetVar(iSymID);
+	}
+
+	return rVar;
+}
+
+///////////////////////////////////////////////////////////////
+/// Get the namespace ID
+
+ENamespaceID CCodeBase::GetNamespaceID(const char* pcNamespace)
+{
+	if (!pcNamespace || *pcNamespace == 0)
+	{
+		return NSID_ALL;
+	}
+	else if (!strcmp(pcNamespace, NS_CURRENT))
+	{
+		return NSID_CURRENT;
+	}
+	else if (!strcmp(pcNamespace, NS_LOCAL))
+	{
+		return NSID_LOCAL;
+	}
+	else if (!strcmp(pcNamespace, NS_GLOBAL))
+	{
+		return NSID_GLOBAL;
+	}
+
+	return NSID_OTHER;
+}
+
 ///////////////////////////////////////////////////////////////
 /// Set Currentnamespace
 
@@ -184,6 +261,13 @@ void CCodeBase::SetCurrentNamespace(const char* pcNamespace)
 	{
 		m_csCurNamespace = pcNamespace;
 	}
+
+	// The current namespace cannot refer to itself.
+	m_eCurNamespace = GetNamespaceID(m_csCurNamespace.Str());
+	if (m_eCurNamespace == NSID_CURRENT)
+	{
+		m_eCurNamespace = NSID_OTHER;
+	}
 }
 
 /////////////////////////////////////////////////////////////////////////
@@ -195,12 +279,31 @@ CCodeVar& CCodeBase::NewTempVar(ECodeDataType _nType)
 		m_mTempVarList.Reserve(m_mTempVarList.Count() + 100);
 	}
 
-	if (!m_mTempVarList.Add(1))
+	CCodeVar* pVar;
+
+	if (m_vecTempVarPool.size() > 0)
+	{
+		pVar = m_vecTempVarPool.back();
+		m_vecTempVarPool.pop_back();
+		++m_uTempVarReuseCount;
+	}
+	else
+	{
+		if (!(pVar = new CCodeVar))
+		{
+			throw CCluOutOfMemory(__FILE__, __FUNCTION__, __LINE__);
+		}
+
+		++m_uTempVarAllocCount;
+	}
+
+	// PushBack deletes pVar if it fails
+	if (!m_mTempVarList.PushBack(pVar))
 	{
 		throw CCluOutOfMemory(__FILE__, __FUNCTION__, __LINE__);
 	}
 
-	CCodeVar& rVar = m_mTempVarList.Last();
+	CCodeVar& rVar = *pVar;
 
 	if (_nType != PDT_NOTYPE)
 	{
@@ -249,12 +352,38 @@ void CCodeBase::DeleteTempVar(int iStartIdx, int iCount)
 		throw CCluAssertion(__FILE__, __FUNCTION__, __LINE__);
 	}
 
-	for (iIdx = iStartIdx; iIdx < iCnt; ++iIdx)
+	// Move instances to pool in reverse order
+	for (iIdx = iStartIdx + iCount - 1; iIdx >= iStartIdx; --iIdx)
+	{
+		CCodeVar& rVar = m_mTempVarList[iIdx];
+
+		if (m_vecTempVarPool.size() < m_uTempVarPoolLimit)
+		{
+			rVar.Recycle();
+			m_vecTempVarPool.push_back(&rVar);
+		}
+		else
+		{
+			delete &rVar;
+		}
+	}
+
+	// All instances are either in the pool or deleted
+	m_mTempVarList.Forget(iStartIdx, iCount);
+}
+
+/////////////////////////////////////////////////////////////////////////
+// Delete all recycled temporary variables
+void CCodeBase::ReleaseTempVarPool()
+{
+	std::vector<CCodeVar*>::iterator itEl, itEnd = m_vecTempVarPool.end();
+
+	for (itEl = m_vecTempVarPool.begin(); itEl != itEnd; ++itEl)
 	{
-		m_mTempVarList[iIdx].Destroy();
+		delete *itEl;
 	}
 
-	m_mTempVarList.Del(iStartIdx, iCount);
+	m_vecTempVarPool.clear();
 }
 
 /////////////////////////////////////////////////////////////////////////
@@ -35,6 +35,8 @@
 #include "Stack.h"
 #include "CodeErrorList.h"
 
+#include <vector>
+
 	#define NS_CURRENT "current"
 	#define NS_LOCAL "local"
 	#define NS_GLOBAL "global"
@@ -42,6 +44,18 @@
 	typedef CCodeVar* TCodeVarPtr;
 	typedef CCodeVarList* TCodeVarListPtr;
 
+	// Namespace IDs for the access of variables by symbol ID.
+	// NSID_ALL searches all namespaces, like a namespace string of 0.
+	// NSID_OTHER stands for any namespace that is neither local nor global.
+	enum ENamespaceID
+	{
+		NSID_ALL = 0,
+		NSID_CURRENT,
+		NSID_LOCAL,
+		NSID_GLOBAL,
+		NSID_OTHER
+	};
+
 	class CCodeBase
 	{
 	public:
@@ -82,7 +96,8 @@
 		// Returns Variable of type PDT_NOTYPE if error occured.
 		// Creates variable in namespace. If pcNamespace == 0, the creates variable
 		// in local if local exists. If not creates in global.
-		CCodeVar& NewVar(const char* pcName, ECodeDataType _nType = PDT_INT, const char* pcNamespace = 0);
+		// If the symbol ID of the name is known it can be passed in iSymID.
+		CCodeVar& NewVar(const char* pcName, ECodeDataType _nType = PDT_INT, const char* pcNamespace = 0, int iSymID = -1);
 		// Deletes variable using same principle as in NewVar.
 		bool DeleteVar(const char* pcName, const char* pcNamespace = 0);
 
@@ -112,11 +127,28 @@
 		// Get current number of temp vars
 		int TempVarCount() { return (int) m_mTempVarList.Count(); }
 
+		// Deletes all recycled temp var instances
+		void ReleaseTempVarPool();
+
+		// Set the maximal number of recycled temp var instances that are kept
+		void SetTempVarPoolLimit(uint uLimit) { m_uTempVarPoolLimit = uLimit; }
+
+		// Temp var statistics. NewTempVar either allocates a new instance
+		// or reuses an instance from the pool of recycled temp vars.
+		uint GetTempVarAllocCount() { return m_uTempVarAllocCount; }
+		uint GetTempVarReuseCount() { return m_uTempVarReuseCount; }
+		uint GetTempVarPoolCount() { return (uint) m_vecTempVarPool.size(); }
+		void ResetTempVarCounters() { m_uTempVarAllocCount = 0; m_uTempVarReuseCount = 0; }
+
 		// Returns Variable of type PDT_NOTYPE if error occured.
 		// Searches in namespace but always first in ConstVarList.
 		// If pcNamespace == 0, then searches in all namespaces
 		CCodeVar& GetVar(const char* pcName, const char* pcNamespace = 0);
 
+		// Same as above but for the symbol ID of a name as given by CCodeSymbolTable.
+		// Looks up variables in constant time without string comparisons.
+		CCodeVar& GetVar(int iSymID, ENamespaceID eNamespace = NSID_ALL);
+
 //	CCodeVar& GetVar(int i) { return m_mVarList[i]; }
 //	CCodeVar& GetConstVar(int i) { return m_mConstVarList[i]; }
 
@@ -127,6 +159,9 @@
 
 		void SetCurrentNamespace(const char* pcNamespace);
 
+		// Returns the namespace ID of a namespace string
+		static ENamespaceID GetNamespaceID(const char* pcNamespace);
+
 		int ConstVarCount() { return m_mConstVarList.Count(); }
 		CCodeVarList::TVarMapIt GetVarBegin() { return m_mVarList.Begin(); }
 		CCodeVarList::TVarMapIt GetVarEnd() { return m_mVarList.End(); }
@@ -136,14 +171,47 @@
 		void SetLoopCountLimit(int iLimit) { m_iLoopCountLimit = iLimit; }
 		int GetLoopCountLimit() { return m_iLoopCountLimit; }
 
+		// If enabled, code element lists are compiled to bytecode
+		// on first execution and the bytecode is run instead of the code tree.
+		void EnableBytecode(bool bVal = true) { m_bUseBytecode = bVal; }
+		bool IsBytecodeEnabled() { return m_bUseBytecode; }
+
+		// Precision below which scalar operands are treated as zero.
+		// Used by the bytecode for the inline evaluation of scalar operators.
+		virtual TCVScalar GetScalarPrec() { return 0; }
+
 		CStrMem& GetTextOutput() { return m_csOutput; }
 
+		// Incremental execution of top-level code lines.
+		// The parser calls BeginCodeLine() and EndCodeLine() around the execution of each
+		// top-level code line and does not execute a line at all if SkipCodeLine() returns true.
+		// A derived code base may record the effect of a line and reproduce it in SkipCodeLine().
+		virtual bool SkipCodeLine(int iLine) { return false; }
+		virtual void BeginCodeLine(int iLine) { }
+		virtual void EndCodeLine(int iLine, bool bOK) { }
+		virtual void ResetCodeLineCache() { }
+
+		// While a code line is tracked, labels and external functions report
+		// the variables they access and the functions they call.
+		bool IsTrackingCodeLine() { return m_bTrackCodeLine; }
+		virtual void OnAccessVar(CCodeVar& rVar, int iSymID) { }
+		virtual void OnCallFunc(CCodeElement& rFunc, CCodeVar& rPars) { }
+
 		CCodeErrorList m_ErrorList;
 
 	protected:
 
 		MemObj<CCodeVar> m_mTempVarList;
 
+		// Temp var instances that have been deleted are kept here for reuse.
+		// They are pushed in reverse order, so that a statement that is
+		// executed repeatedly obtains the same instances in the same order
+		// and can reuse the memory of their multivector and matrix values.
+		std::vector<CCodeVar*> m_vecTempVarPool;
+		uint m_uTempVarPoolLimit;
+		uint m_uTempVarAllocCount;
+		uint m_uTempVarReuseCount;
+
 		CCodeVarList m_mConstVarList;	// Variable List for pre-defined constants
 		CCodeVarList m_mVarList;	// Variable List for user variables.
 		CStack<TCodeVarPtr> m_mVarStack;
@@ -151,8 +219,11 @@
 
 		CStrMem m_csOutput;
 		CStrMem m_csCurNamespace;	// Current namespace
+		ENamespaceID m_eCurNamespace;	// ID of current namespace
 
 		int m_iLoopCountLimit;	// Maximum evaluations of a loop before error.
+		bool m_bUseBytecode;	// Execute code lists as bytecode.
+		bool m_bTrackCodeLine;	// Report variable accesses and function calls of current code line.
 	};
 
 #endif	// !defined(AFX_CODEBASE_H__85899394_3862_4967_B06C_A84E787CB1DE__INCLUDED_)
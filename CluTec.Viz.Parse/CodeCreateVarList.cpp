@@ -70,17 +70,19 @@ bool CCodeCreateVarList::Apply(CCodeBase* pCodeBase, SCodeData* pData)
 		rVarList.SetCodeList(m_pCodeList);
 
 		int iStackDepth = pCodeBase->GetActStackDepth();
-		int iStackIdx   = iStackDepth - 1;
+		int iStackIdx;
 
-		if (!rVarList.Set(iStackDepth))
+		// Only elements that are copied are constructed in the list.
+		// The chunk for them is allocated with the first such element.
+		if (iStackDepth > 1)
 		{
-			pCodeBase->m_ErrorList.OutOfMemory(iLine, iPos);
-			return false;
+			rVarList.EnableInPlaceChunkAlloc();
 		}
 
-		while (pCodeBase->Pop(pVar))
+		// Add the stack entries from bottom to top and remove them afterwards
+		for (iStackIdx = iStackDepth - 1; iStackIdx >= 0; --iStackIdx)
 		{
-			CCodeVar& rBaseVar = pVar->DereferenceVarPtr(true);
+			CCodeVar& rBaseVar = pCodeBase->GetStackVar(iStackIdx)->DereferenceVarPtr(true);
 
 			// Test whether given variable is a temporary variable
 			// and if yes, move it from the temp var list to this var list.
@@ -90,17 +92,31 @@ bool CCodeCreateVarList::Apply(CCodeBase* pCodeBase, SCodeData* pData)
 				// However, now the variable becomes part of a var list and may
 				// be overwritten.
 				rBaseVar.EnableProtect(false);
-				rVarList.Replace(iStackIdx, &rBaseVar);
+
+				if (!rVarList.PushBack(&rBaseVar))
+				{
+					pCodeBase->m_ErrorList.OutOfMemory(iLine, iPos);
+					return false;
+				}
 			}
 			else
 			{
-				rVarList[iStackIdx].CopyInstance(rBaseVar);
+				if (!rVarList.Add(1))
+				{
+					pCodeBase->m_ErrorList.OutOfMemory(iLine, iPos);
+					return false;
+				}
+
+				rVarList.Last().CopyInstance(rBaseVar);
 			}
 
 			// Do not store pointers in a constant var list
-			rVarList[iStackIdx].DereferencePtr();
+			rVarList.Last().DereferencePtr();
+		}
 
-			--iStackIdx;
+		for (iStackIdx = 0; iStackIdx < iStackDepth; ++iStackIdx)
+		{
+			pCodeBase->Pop(pVar);
 		}
 
 		// Protect constant list of variables
@@ -27,6 +27,9 @@
 #include "StdAfx.h"
 #include "CodeElementList.h"
 #include "CodeBase.h"
+#include "CodeProgram.h"
+
+#include <algorithm>
 
 //////////////////////////////////////////////////////////////////////
 // Konstruktion/Destruktion
@@ -34,13 +37,74 @@
 
 CCodeElementList::CCodeElementList()
 {
-
+	m_pProgram = 0;
 }
 
 CCodeElementList::~CCodeElementList()
 {
 	// Delete all owned elements.
 	Delete(0, (int)m_mElementList.Count());
+	ResetProgram();
+}
+
+
+//////////////////////////////////////////////////////////////////////
+// Reset Program
+
+void CCodeElementList::ResetProgram()
+{
+	std::vector<CCodeElementList*> vecVisited;
+
+	ResetProgram(vecVisited);
+}
+
+void CCodeElementList::ResetProgram(std::vector<CCodeElementList*>& vecVisited)
+{
+	if (std::find(vecVisited.begin(), vecVisited.end(), this) != vecVisited.end())
+	{
+		return;
+	}
+
+	vecVisited.push_back(this);
+
+	if (m_pProgram)
+	{
+		delete m_pProgram;
+		m_pProgram = 0;
+	}
+
+	// Parent programs contain the elements of this list
+	for (CCodeElementList* pParent : m_vecParentList)
+	{
+		pParent->ResetProgram(vecVisited);
+	}
+}
+
+//////////////////////////////////////////////////////////////////////
+// Parent lists
+
+void CCodeElementList::AddAsParent(CCodeElement* pElement)
+{
+	CCodeElementList* pList = dynamic_cast<CCodeElementList*>(pElement);
+	if (pList)
+	{
+		pList->m_vecParentList.push_back(this);
+	}
+}
+
+void CCodeElementList::RemoveAsParent(CCodeElement* pElement)
+{
+	CCodeElementList* pList = dynamic_cast<CCodeElementList*>(pElement);
+	if (pList)
+	{
+		std::vector<CCodeElementList*>::iterator itParent
+			= std::find(pList->m_vecParentList.begin(), pList->m_vecParentList.end(), this);
+
+		if (itParent != pList->m_vecParentList.end())
+		{
+			pList->m_vecParentList.erase(itParent);
+		}
+	}
 }
 
 
@@ -91,6 +155,23 @@ bool CCodeElementList::Apply(CCodeBase* pCodeBase, SCodeData *pData)
 	if (!pCodeBase) 
 		return false;
 
+	// Execute bytecode if enabled. The list is compiled on first use.
+	// If compilation fails the list is executed by walking the code tree.
+	if (pCodeBase->IsBytecodeEnabled())
+	{
+		if (!m_pProgram)
+		{
+			m_pProgram = new CCodeProgram;
+			if (!m_pProgram->Compile(*this))
+			{
+				ResetProgram();
+			}
+		}
+
+		if (m_pProgram)
+			return m_pProgram->Run(pCodeBase);
+	}
+
 	int i, n = int(m_mElementList.Count());
 
 	if (pCodeBase->LockStack() < 0)
@@ -130,6 +211,8 @@ bool CCodeElementList::Insert(CCodeElement& rElement, int iPos, bool bOwner,
 	if (!m_mElementList.Insert(iPos))
 		return false;
 
+	ResetProgram();
+
 	SCodeElementPtr &rEl = m_mElementList[iPos];
 
 	rEl.pElement = &rElement;
@@ -137,6 +220,7 @@ bool CCodeElementList::Insert(CCodeElement& rElement, int iPos, bool bOwner,
 	rEl.iTextLine = iTextLine;
 	rEl.iTextPos = iTextPos;
 
+	AddAsParent(&rElement);
 
 	return true;
 }
@@ -154,10 +238,13 @@ bool CCodeElementList::Delete(CCodeElement& rElement, int DeleteLists)
 	{
 		if(m_mElementList[i].pElement == &rElement)
 		{
+			RemoveAsParent(m_mElementList[i].pElement);
+
 			if (m_mElementList[i].bOwner)
 				delete m_mElementList[i].pElement;
 
 			m_mElementList.Del(i,1);
+			ResetProgram();
 		}
 		else
 		{
@@ -190,10 +277,13 @@ bool CCodeElementList::Delete(CStrMem& rName, int DeleteLists)
 	{
 		if(m_mElementList[i].pElement->GetName() == rName)
 		{
+			RemoveAsParent(m_mElementList[i].pElement);
+
 			if (m_mElementList[i].bOwner)
 				delete m_mElementList[i].pElement;
 
 			m_mElementList.Del(i,1);
+			ResetProgram();
 		}
 		else
 		{
@@ -226,11 +316,14 @@ bool CCodeElementList::Delete(int iPos, int iNo)
 
 	for(i=iPos;i<iMax;i++)
 	{
+		RemoveAsParent(m_mElementList[i].pElement);
+
 		if (m_mElementList[i].bOwner)
 			delete m_mElementList[i].pElement;
 	}
 
 	m_mElementList.Del(iPos, iNo);
+	ResetProgram();
 
 	return true;
 }
@@ -31,9 +31,12 @@
 #pragma once
 #endif // _MSC_VER > 1000
 
+#include <vector>
+
 #include "CodeElement.h"
 
 class CCodeBase;
+class CCodeProgram;
 
 struct SCodeElementPtr
 {
@@ -62,6 +65,7 @@ public:
 
 	CCodeElementList& operator << (CCodeElement& rElement) { Add(rElement); return *this; }
 	CCodeElement* operator[] (int iPos) { return m_mElementList[iPos].pElement; }
+	SCodeElementPtr& ElementPtr(int iPos) { return m_mElementList[iPos]; }
 
 	// if bOwner == true then list can call delete on Element.
 	bool Add(CCodeElement& rElement, bool bOwner = false,
@@ -82,9 +86,31 @@ public:
 	virtual bool Apply(CCodeBase* pCodeBase, SCodeData *pData = 0);
 	virtual bool Serialize( CXMLTree &xmlTree );
 
+	// Remove the bytecode compiled from this list. It is compiled again
+	// on the next call of Apply with bytecode enabled in the code base.
+	// The bytecode of all lists this list is part of is also removed,
+	// since it contains the elements of this list.
+	void ResetProgram();
+
+protected:
+
+	// Reset the program of this list and its parents, unless this list is in vecVisited.
+	// A list may be reached through several parents and lists may contain each other.
+	void ResetProgram(std::vector<CCodeElementList*>& vecVisited);
+
+	// Register and unregister this list as parent of pElement, if it is a list.
+	void AddAsParent(CCodeElement* pElement);
+	void RemoveAsParent(CCodeElement* pElement);
+
 protected:
 
 	Mem<SCodeElementPtr> m_mElementList;
+
+	// Bytecode of this list and all its sub-lists. Created on demand.
+	CCodeProgram *m_pProgram;
+
+	// Lists this list has been inserted into. A list may be part of several lists.
+	std::vector<CCodeElementList*> m_vecParentList;
 };
 
 #endif // !defined(AFX_OGLBASEELEMENTLIST_H__5746B287_573C_4800_9DE1_B801F31D0EB4__INCLUDED_)
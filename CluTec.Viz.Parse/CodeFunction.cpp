@@ -96,6 +96,11 @@ bool CCodeFunction::Apply(CCodeBase* pCodeBase, SCodeData* pData)
 			::OutputDebugStringA(sText.Str());
 		#endif
 
+		if (pCodeBase->IsTrackingCodeLine())
+		{
+			pCodeBase->OnCallFunc(*this, *pVar);
+		}
+
 		// Call Function
 		if (!m_pFunc(*((CCLUCodeBase*) pCodeBase), rVar, *pVar, iLine, iPos))
 		{
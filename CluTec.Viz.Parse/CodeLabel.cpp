@@ -29,6 +29,7 @@
 #include "CodeBase.h"
 #include "CodeVar.h"
 #include "OCIDSymDef.h"
+#include "CodeSymbolTable.h"
 
 #include "CluTec.Base/Logger.h"
 
@@ -40,6 +41,10 @@ CCodeLabel::CCodeLabel()
 {
 	m_StdVar.New(PDT_INT, "Unnamed");
 	m_StdVar = (int) 0;
+
+	m_pcNamespace = NS_CURRENT;
+	m_eNamespace  = NSID_CURRENT;
+	m_iSymID      = CCodeSymbolTable::INVALID_ID;
 }
 
 CCodeLabel::~CCodeLabel()
@@ -48,6 +53,36 @@ CCodeLabel::~CCodeLabel()
 }
 
 
+//////////////////////////////////////////////////////////////////////
+/// Set Label
+/// Splits off the global namespace prefix and resolves the variable name
+/// to its symbol ID, so that Apply need not compare any strings.
+
+bool CCodeLabel::SetLabel(const char *pcLabel)
+{
+	if (!pcLabel || *pcLabel == 0)
+		return false;
+
+	SetName(pcLabel);
+
+	if (m_csName[0] == OC_IDSYM_GLOBAL_CHAR)
+	{
+		m_csVarName = &(m_csName.Str()[1]);
+		m_pcNamespace = NS_GLOBAL;
+		m_eNamespace = NSID_GLOBAL;
+	}
+	else
+	{
+		m_csVarName = m_csName;
+		m_pcNamespace = NS_CURRENT;
+		m_eNamespace = NSID_CURRENT;
+	}
+
+	m_iSymID = CCodeSymbolTable::Global().GetID(m_csVarName.Str());
+
+	return true;
+}
+
 //////////////////////////////////////////////////////////////////////
 /// Apply
 /// If label refers to variable of type PDT_CODEPTR then calls Apply on Code Ptr.
@@ -66,24 +101,11 @@ bool CCodeLabel::Apply(CCodeBase* pCodeBase, SCodeData *pData)
 		iPos = pData->iTextPos;
 	}
 
-	const char* pcNamespace;
-	CStrMem csVarName;
-	if (m_csName[0] == OC_IDSYM_GLOBAL_CHAR)
-	{
-		csVarName = &(m_csName.Str()[1]);
-		pcNamespace = NS_GLOBAL;
-	}
-	else
-	{
-		csVarName = m_csName;
-		pcNamespace = NS_CURRENT;
-	}
-
-	CCodeVar& rVar = pCodeBase->GetVar(csVarName, pcNamespace);
+	CCodeVar& rVar = pCodeBase->GetVar(m_iSymID, m_eNamespace);
 
 	if (rVar.Type() == PDT_NOTYPE) // variable does not exist
 	{
-		CCodeVar& rNewVar = pCodeBase->NewVar(csVarName, PDT_NOTYPE, pcNamespace);
+		CCodeVar& rNewVar = pCodeBase->NewVar(m_csVarName, PDT_NOTYPE, m_pcNamespace, m_iSymID);
 		
 		//if (rNewVar.Type() == PDT_NOTYPE)
 		//{
@@ -93,6 +115,11 @@ bool CCodeLabel::Apply(CCodeBase* pCodeBase, SCodeData *pData)
 	
 		//// Set Standard Variable
 		//rNewVar = m_StdVar;
+		if (pCodeBase->IsTrackingCodeLine())
+		{
+			pCodeBase->OnAccessVar(rNewVar, m_iSymID);
+		}
+
 		pCodeBase->Push(&rNewVar);
 	}
 /*	else if (rVar.Type() == PDT_CODEPTR) // execute code element
@@ -120,6 +147,11 @@ bool CCodeLabel::Apply(CCodeBase* pCodeBase, SCodeData *pData)
 //		}
 //#endif
 
+		if (pCodeBase->IsTrackingCodeLine())
+		{
+			pCodeBase->OnAccessVar(rVar, m_iSymID);
+		}
+
 		if (!pCodeBase->Push(&rVar))
 		{
 			pCodeBase->m_ErrorList.Internal(iLine, iPos);
@@ -34,6 +34,7 @@
 #include "CodeElement.h"
 
 #include "CodeVar.h"
+#include "CodeBase.h"
 
 
 class CCodeLabel : public CCodeElement  
@@ -42,15 +43,25 @@ public:
 	CCodeLabel();
 	virtual ~CCodeLabel();
 
-	bool SetLabel(const char *pcLabel)
-	{ if (!pcLabel || *pcLabel == 0) return false; else SetName(pcLabel); return true; }
+	// Sets the label and resolves the variable name to its symbol ID.
+	bool SetLabel(const char *pcLabel);
 
 	virtual bool Apply(CCodeBase* pCodeBase, SCodeData *pData = 0);
 
 	CCodeVar& RefStdVar() { return m_StdVar; }
 
+	int GetSymID() { return m_iSymID; }
+
 protected:
 	CCodeVar m_StdVar;
+
+	// Variable name without namespace prefix and its namespace
+	CStrMem m_csVarName;
+	const char* m_pcNamespace;
+	ENamespaceID m_eNamespace;
+
+	// Symbol ID of variable name
+	int m_iSymID;
 };
 
 #endif // !defined(AFX_CODELABEL_H__C8137DD9_E080_487E_A460_ABB85EFD0EEB__INCLUDED_)
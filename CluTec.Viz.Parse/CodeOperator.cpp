@@ -45,6 +45,7 @@ CCodeOperator::CCodeOperator()
 	m_AUnaryFunc = 0; 
 	m_ABinaryFunc = 0;
 
+	m_eScalarOp = SCALAROP_NONE;
 }
 
 CCodeOperator::~CCodeOperator()
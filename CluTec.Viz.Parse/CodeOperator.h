@@ -49,6 +49,21 @@ typedef bool (CCodeBase::*TOpABinaryPtr)(CCodeVar& rLVar, CCodeVar& rRVar, int i
 
 class CCodeOperator : public CCodeElement  
 {
+public:
+	// Binary operators whose result for two scalar or counter operands
+	// can be evaluated inline by the bytecode interpreter.
+	enum EScalarOp
+	{
+		SCALAROP_NONE = 0,
+		SCALAROP_ADD,
+		SCALAROP_SUBTRACT,
+		SCALAROP_PROD,
+		SCALAROP_LESS,
+		SCALAROP_GREATER,
+		SCALAROP_LESSEQUAL,
+		SCALAROP_GREATEREQUAL
+	};
+
 public:
 	CCodeOperator();
 	virtual ~CCodeOperator();
@@ -59,6 +74,11 @@ public:
 
 	virtual bool Apply(CCodeBase* pCodeBase, SCodeData *pData = 0);
 
+	// The scalar operation must give the same result as the binary function
+	// for two scalar or counter operands.
+	void SetScalarOp(EScalarOp eOp) { m_eScalarOp = eOp; }
+	EScalarOp GetScalarOp() const { return m_eScalarOp; }
+
 protected:
 	// If true operator modifies one of its parameters 
 	// instead of creating a temporary variable with its result.
@@ -80,6 +100,9 @@ protected:
 	TOpAUnaryPtr m_AUnaryFunc;		// Assign Unary
 	TOpABinaryPtr m_ABinaryFunc;	// Assign Binary
 
+	// Scalar operation evaluated inline by bytecode (default = SCALAROP_NONE)
+	EScalarOp m_eScalarOp;
+
 	// auxiliary function for apply, written by Daniel Grest Jan. 2002
 	// changed 28.1.02 by C.Perwass
 	bool Eval(CCodeBase* pCodeBase, SCodeData *pData, 
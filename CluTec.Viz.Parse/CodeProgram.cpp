@@ -0,0 +1,356 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// project:   CluTec.Viz.Parse
+// file:      CodeProgram.cpp
+//
+// summary:   Implements the code program class
+//
+//            Copyright (c) 2019 by Christian Perwass.
+//
+//            This file is part of the CluTecLib library.
+//
+//            The CluTecLib library is free software: you can redistribute it and / or modify
+//            it under the terms of the GNU Lesser General Public License as published by
+//            the Free Software Foundation, either version 3 of the License, or
+//            (at your option) any later version.
+//
+//            The CluTecLib library is distributed in the hope that it will be useful,
+//            but WITHOUT ANY WARRANTY; without even the implied warranty of
+//            MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//            GNU Lesser General Public License for more details.
+//
+//            You should have received a copy of the GNU Lesser General Public License
+//            along with the CluTecLib library.
+//            If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "StdAfx.h"
+#include "CodeProgram.h"
+#include "CodeElementList.h"
+#include "CodeBase.h"
+#include "CodeNumber.h"
+#include "CodeString.h"
+#include "CodeData.h"
+#include "CodeLabel.h"
+#include "CodeOperator.h"
+#include "CodeFunction.h"
+
+#include <typeinfo>
+#include <new>
+
+//////////////////////////////////////////////////////////////////////
+// Konstruktion/Destruktion
+//////////////////////////////////////////////////////////////////////
+
+CCodeProgram::CCodeProgram()
+{
+	m_bCompiled = false;
+}
+
+CCodeProgram::~CCodeProgram()
+{
+}
+
+//////////////////////////////////////////////////////////////////////
+// Compile
+
+bool CCodeProgram::Compile(CCodeElementList& rList)
+{
+	Reset();
+
+	try
+	{
+		CompileList(rList);
+	}
+	catch (std::bad_alloc&)
+	{
+		Reset();
+		return false;
+	}
+
+	m_bCompiled = true;
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Add instructions for a list and all its sub-lists.
+// The instruction types are only used if the dynamic type of an element
+// matches exactly, since derived classes may overload Apply.
+
+void CCodeProgram::CompileList(CCodeElementList& rList)
+{
+	int iIdx, iCnt = rList.Count();
+
+	AddInstr(OPC_ENTER, &rList, 0, -1, -1, 0);
+
+	for (iIdx = 0; iIdx < iCnt; ++iIdx)
+	{
+		SCodeElementPtr& rEl = rList.ElementPtr(iIdx);
+		CCodeElement* pEl    = rEl.pElement;
+		const std::type_info& rType = typeid(*pEl);
+
+		if (rType == typeid(CCodeElementList))
+		{
+			CompileList(*static_cast<CCodeElementList*>(pEl));
+		}
+		else if (rType == typeid(CCodeNumber))
+		{
+			AddInstr(OPC_PUSH_CONST, pEl, &static_cast<CCodeNumber*>(pEl)->RefNumber(), rEl.iTextLine, rEl.iTextPos, &rList);
+		}
+		else if (rType == typeid(CCodeString))
+		{
+			AddInstr(OPC_PUSH_CONST, pEl, &static_cast<CCodeString*>(pEl)->Ref(), rEl.iTextLine, rEl.iTextPos, &rList);
+		}
+		else if (rType == typeid(CCodeData))
+		{
+			AddInstr(OPC_PUSH_CONST, pEl, &static_cast<CCodeData*>(pEl)->RefData(), rEl.iTextLine, rEl.iTextPos, &rList);
+		}
+		else if (rType == typeid(CCodeLabel))
+		{
+			AddInstr(OPC_PUSH_LABEL, pEl, 0, rEl.iTextLine, rEl.iTextPos, &rList);
+		}
+		else if (rType == typeid(CCodeOperator))
+		{
+			CCodeOperator* pOp = static_cast<CCodeOperator*>(pEl);
+
+			if (pOp->GetScalarOp() != CCodeOperator::SCALAROP_NONE)
+			{
+				AddInstr(OPC_SCALAR_OP, pEl, 0, rEl.iTextLine, rEl.iTextPos, &rList);
+				m_vecInstr.back().iScalarOp = int(pOp->GetScalarOp());
+			}
+			else
+			{
+				AddInstr(OPC_OPERATOR, pEl, 0, rEl.iTextLine, rEl.iTextPos, &rList);
+			}
+		}
+		else if (rType == typeid(CCodeFunction))
+		{
+			AddInstr(OPC_FUNCTION, pEl, 0, rEl.iTextLine, rEl.iTextPos, &rList);
+		}
+		else
+		{
+			AddInstr(OPC_APPLY, pEl, 0, rEl.iTextLine, rEl.iTextPos, &rList);
+		}
+	}
+
+	AddInstr(OPC_LEAVE, &rList, 0, -1, -1, 0);
+}
+
+//////////////////////////////////////////////////////////////////////
+
+void CCodeProgram::AddInstr(EOpCode eOp, CCodeElement* pElement, CCodeVar* pVar, int iLine, int iPos, CCodeElementList* pParentList)
+{
+	SInstr xInstr;
+
+	xInstr.eOp         = eOp;
+	xInstr.pElement    = pElement;
+	xInstr.pVar        = pVar;
+	xInstr.iTextLine   = iLine;
+	xInstr.iTextPos    = iPos;
+	xInstr.pParentList = pParentList;
+	xInstr.iScalarOp   = CCodeOperator::SCALAROP_NONE;
+
+	m_vecInstr.push_back(xInstr);
+}
+
+//////////////////////////////////////////////////////////////////////
+// Run
+//
+// Each nested list that is entered locks the stack. If an instruction
+// fails, all locks of the currently entered lists are released, which
+// is what the recursive CCodeElementList::Apply does on its way back up.
+
+bool CCodeProgram::Run(CCodeBase* pCodeBase)
+{
+	if (!pCodeBase || !m_bCompiled)
+	{
+		return false;
+	}
+
+	int iIdx, iCnt = int(m_vecInstr.size());
+	int iDepth = 0;
+	bool bOK   = true;
+	SCodeData sData;
+
+	for (iIdx = 0; iIdx < iCnt && bOK; ++iIdx)
+	{
+		const SInstr& rInstr = m_vecInstr[iIdx];
+
+		switch (rInstr.eOp)
+		{
+		case OPC_ENTER:
+			if (pCodeBase->LockStack() < 0)
+			{
+				bOK = false;
+			}
+			else
+			{
+				++iDepth;
+			}
+			break;
+
+		case OPC_LEAVE:
+			pCodeBase->UnlockStack();
+			--iDepth;
+			break;
+
+		case OPC_PUSH_CONST:
+			if (!pCodeBase->Push(rInstr.pVar))
+			{
+				pCodeBase->m_ErrorList.Internal(rInstr.iTextLine, rInstr.iTextPos);
+				bOK = false;
+			}
+			break;
+
+		case OPC_PUSH_LABEL:
+			sData.Set(rInstr.iTextLine, rInstr.iTextPos, rInstr.pParentList);
+			bOK = static_cast<CCodeLabel*>(rInstr.pElement)->CCodeLabel::Apply(pCodeBase, &sData);
+			break;
+
+		case OPC_OPERATOR:
+			sData.Set(rInstr.iTextLine, rInstr.iTextPos, rInstr.pParentList);
+			bOK = static_cast<CCodeOperator*>(rInstr.pElement)->CCodeOperator::Apply(pCodeBase, &sData);
+			break;
+
+		case OPC_SCALAR_OP:
+			if (!RunScalarOp(pCodeBase, rInstr, bOK))
+			{
+				sData.Set(rInstr.iTextLine, rInstr.iTextPos, rInstr.pParentList);
+				bOK = static_cast<CCodeOperator*>(rInstr.pElement)->CCodeOperator::Apply(pCodeBase, &sData);
+			}
+			break;
+
+		case OPC_FUNCTION:
+			sData.Set(rInstr.iTextLine, rInstr.iTextPos, rInstr.pParentList);
+			bOK = static_cast<CCodeFunction*>(rInstr.pElement)->CCodeFunction::Apply(pCodeBase, &sData);
+			break;
+
+		default:
+			sData.Set(rInstr.iTextLine, rInstr.iTextPos, rInstr.pParentList);
+			bOK = rInstr.pElement->Apply(pCodeBase, &sData);
+			break;
+		}
+	}
+
+	if (!bOK)
+	{
+		for (; iDepth > 0; --iDepth)
+		{
+			pCodeBase->UnlockStack();
+		}
+	}
+
+	return bOK;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Inline evaluation of a binary operator for scalar operands.
+//
+// The operands are cast and the result is stored exactly as in the
+// scalar branches of the operator functions of CCLUCodeBase. That is,
+// operands within the scalar precision are zero, arithmetic results are
+// scalars and comparison results are integers.
+
+bool CCodeProgram::RunScalarOp(CCodeBase* pCodeBase, const SInstr& rInstr, bool& rbOK)
+{
+	// With a single operand on the stack the operator is applied as unary operator.
+	if (pCodeBase->GetActStackDepth() < 2)
+	{
+		return false;
+	}
+
+	CCodeVar& rRVar = pCodeBase->GetStackVar(0)->DereferenceVarPtr(true);
+	CCodeVar& rLVar = pCodeBase->GetStackVar(1)->DereferenceVarPtr(true);
+
+	ECodeDataType eLType = rLVar.Type();
+	ECodeDataType eRType = rRVar.Type();
+
+	if ((eLType != PDT_SCALAR && eLType != PDT_COUNTER) ||
+		(eRType != PDT_SCALAR && eRType != PDT_COUNTER))
+	{
+		return false;
+	}
+
+	TCVScalar fPrec = pCodeBase->GetScalarPrec();
+	if (fPrec == 0)
+	{
+		Tiny(fPrec);
+	}
+
+	TCVScalar fL = (eLType == PDT_SCALAR ? *rLVar.GetScalarPtr() : TCVScalar(*rLVar.GetCounterPtr()));
+	TCVScalar fR = (eRType == PDT_SCALAR ? *rRVar.GetScalarPtr() : TCVScalar(*rRVar.GetCounterPtr()));
+
+	fL = (::IsZero(fL, fPrec) ? TCVScalar(0) : fL);
+	fR = (::IsZero(fR, fPrec) ? TCVScalar(0) : fR);
+
+	TCodeVarPtr pVar;
+	pCodeBase->Pop(pVar);
+	pCodeBase->Pop(pVar);
+
+	rbOK = true;
+
+	try
+	{
+		CCodeVar& rResVar = pCodeBase->NewTempVar();
+
+		switch (rInstr.iScalarOp)
+		{
+		case CCodeOperator::SCALAROP_ADD:
+			rResVar.New(PDT_SCALAR);
+			rResVar = TCVScalar(fL + fR);
+			break;
+
+		case CCodeOperator::SCALAROP_SUBTRACT:
+			rResVar.New(PDT_SCALAR);
+			rResVar = TCVScalar(fL - fR);
+			break;
+
+		case CCodeOperator::SCALAROP_PROD:
+			rResVar.New(PDT_SCALAR);
+			rResVar = TCVScalar(fL * fR);
+			break;
+
+		case CCodeOperator::SCALAROP_LESS:
+			rResVar = int(fL < fR ? 1 : 0);
+			break;
+
+		case CCodeOperator::SCALAROP_GREATER:
+			rResVar = int(fL > fR ? 1 : 0);
+			break;
+
+		case CCodeOperator::SCALAROP_LESSEQUAL:
+			rResVar = int(fL <= fR ? 1 : 0);
+			break;
+
+		case CCodeOperator::SCALAROP_GREATEREQUAL:
+			rResVar = int(fL >= fR ? 1 : 0);
+			break;
+
+		default:
+			pCodeBase->m_ErrorList.Internal(rInstr.iTextLine, rInstr.iTextPos);
+			rbOK = false;
+			return true;
+		}
+
+		// Temporary variable should not be changed.
+		rResVar.EnableProtect();
+
+		if (!pCodeBase->Push(&rResVar))
+		{
+			pCodeBase->m_ErrorList.OutOfMemory(rInstr.iTextLine, rInstr.iTextPos);
+			rbOK = false;
+		}
+	}
+	catch (CCluOutOfMemory&)
+	{
+		pCodeBase->m_ErrorList.OutOfMemory(rInstr.iTextLine, rInstr.iTextPos);
+		rbOK = false;
+	}
+	catch (CCluException& xEx)
+	{
+		pCodeBase->m_ErrorList.GeneralError(xEx.PrintError().c_str(), rInstr.iTextLine, rInstr.iTextPos);
+		rbOK = false;
+	}
+
+	return true;
+}
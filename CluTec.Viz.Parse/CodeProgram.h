@@ -0,0 +1,135 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// project:   CluTec.Viz.Parse
+// file:      CodeProgram.h
+//
+// summary:   Declares the code program class
+//
+//            Copyright (c) 2019 by Christian Perwass.
+//
+//            This file is part of the CluTecLib library.
+//
+//            The CluTecLib library is free software: you can redistribute it and / or modify
+//            it under the terms of the GNU Lesser General Public License as published by
+//            the Free Software Foundation, either version 3 of the License, or
+//            (at your option) any later version.
+//
+//            The CluTecLib library is distributed in the hope that it will be useful,
+//            but WITHOUT ANY WARRANTY; without even the implied warranty of
+//            MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//            GNU Lesser General Public License for more details.
+//
+//            You should have received a copy of the GNU Lesser General Public License
+//            along with the CluTecLib library.
+//            If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <vector>
+
+#include "CodeElement.h"
+
+class CCodeBase;
+class CCodeVar;
+class CCodeElementList;
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// <summary>
+/// 	Bytecode representation of a code element list.
+///
+/// 	A parsed code line is a tree of CCodeElementList instances whose leaves are pushed onto the variable stack in postfix
+/// 	order. Compile() flattens this tree into a linear instruction array, where each nested list is bracketed by
+/// 	OPC_ENTER/OPC_LEAVE, which lock and unlock the stack exactly as CCodeElementList::Apply does. Run() executes the
+/// 	instructions in a single loop without recursion and without virtual dispatch for the common element types.
+///
+/// 	Operators with a scalar operation (see CCodeOperator::SetScalarOp) are compiled to OPC_SCALAR_OP. If the two top
+/// 	stack entries are scalars or counters, Run() pops them and pushes the result without calling the operator function.
+/// 	For all other operands, and for all other element types, the element's Apply function is called, so that results are
+/// 	identical to the tree walking interpreter.
+///
+/// 	The program stores pointers into the code tree it was compiled from. It therefore has to be reset whenever that tree
+/// 	changes.
+/// </summary>
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+class CCodeProgram
+{
+public:
+
+	enum EOpCode
+	{
+		OPC_ENTER = 0,		// Lock stack at start of (sub-)list
+		OPC_LEAVE,			// Unlock stack at end of (sub-)list
+		OPC_PUSH_CONST,		// Push constant variable of number, string or data element
+		OPC_PUSH_LABEL,		// Resolve label and push variable
+		OPC_OPERATOR,		// Apply standard operator
+		OPC_SCALAR_OP,		// Evaluate binary operator inline for scalar operands, otherwise apply it
+		OPC_FUNCTION,		// Call external function
+		OPC_APPLY			// Call virtual Apply of code element
+	};
+
+	struct SInstr
+	{
+		EOpCode eOp;
+
+		// Text line and position of element in script
+		int iTextLine;
+		int iTextPos;
+
+		// The list the element is part of
+		CCodeElementList* pParentList;
+
+		// The code element executed by this instruction
+		CCodeElement* pElement;
+
+		// The constant variable for OPC_PUSH_CONST
+		CCodeVar* pVar;
+
+		// The CCodeOperator::EScalarOp for OPC_SCALAR_OP
+		int iScalarOp;
+	};
+
+public:
+
+	CCodeProgram();
+	virtual ~CCodeProgram();
+
+	void Reset() { m_vecInstr.clear(); m_bCompiled = false; }
+
+	bool IsCompiled() const { return m_bCompiled; }
+	int Count() const { return int(m_vecInstr.size()); }
+
+	const SInstr& operator[](int iIdx) const { return m_vecInstr[iIdx]; }
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	/// <summary>	Compiles the given code element list, including all nested lists, into bytecode. </summary>
+	///
+	/// <param name="rList">	The code element list. </param>
+	///
+	/// <returns>	True if it succeeds, false if it fails. </returns>
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	bool Compile(CCodeElementList& rList);
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	/// <summary>	Executes the bytecode. Has the same effect on the code base as CCodeElementList::Apply. </summary>
+	///
+	/// <param name="pCodeBase">	The code base. </param>
+	///
+	/// <returns>	True if it succeeds, false if it fails. </returns>
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	bool Run(CCodeBase* pCodeBase);
+
+protected:
+
+	void CompileList(CCodeElementList& rList);
+	void AddInstr(EOpCode eOp, CCodeElement* pElement, CCodeVar* pVar, int iLine, int iPos, CCodeElementList* pParentList);
+
+	// Evaluates the scalar operation of an OPC_SCALAR_OP instruction if the two top stack entries are scalars or counters.
+	// Returns false if the operands are of any other type. Otherwise rbOK is set to the success of the evaluation.
+	bool RunScalarOp(CCodeBase* pCodeBase, const SInstr& rInstr, bool& rbOK);
+
+protected:
+
+	std::vector<SInstr> m_vecInstr;
+	bool m_bCompiled;
+};
@@ -0,0 +1,119 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// project:   CluTec.Viz.Parse
+// file:      CodeSymbolTable.cpp
+//
+// summary:   Implements the code symbol table class
+//
+//            Copyright (c) 2019 by Christian Perwass.
+//
+//            This file is part of the CluTecLib library.
+//
+//            The CluTecLib library is free software: you can redistribute it and / or modify
+//            it under the terms of the GNU Lesser General Public License as published by
+//            the Free Software Foundation, either version 3 of the License, or
+//            (at your option) any later version.
+//
+//            The CluTecLib library is distributed in the hope that it will be useful,
+//            but WITHOUT ANY WARRANTY; without even the implied warranty of
+//            MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//            GNU Lesser General Public License for more details.
+//
+//            You should have received a copy of the GNU Lesser General Public License
+//            along with the CluTecLib library.
+//            If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "StdAfx.h"
+#include "CodeSymbolTable.h"
+
+//////////////////////////////////////////////////////////////////////
+// Konstruktion/Destruktion
+//////////////////////////////////////////////////////////////////////
+
+CCodeSymbolTable::CCodeSymbolTable()
+{
+	InitializeCriticalSection(&m_xLock);
+}
+
+CCodeSymbolTable::~CCodeSymbolTable()
+{
+	DeleteCriticalSection(&m_xLock);
+}
+
+//////////////////////////////////////////////////////////////////////
+// The process wide symbol table
+
+CCodeSymbolTable& CCodeSymbolTable::Global()
+{
+	static CCodeSymbolTable s_xTable;
+
+	return s_xTable;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Get ID of name and create one if necessary
+
+int CCodeSymbolTable::GetID(const char* pcName)
+{
+	if (!pcName || *pcName == 0)
+	{
+		return INVALID_ID;
+	}
+
+	int iID;
+
+	Lock();
+
+	TIDMap::iterator itEl = m_mapID.find(pcName);
+	if (itEl == m_mapID.end())
+	{
+		iID = int(m_mapID.size());
+		m_mapID[pcName] = iID;
+	}
+	else
+	{
+		iID = itEl->second;
+	}
+
+	Unlock();
+
+	return iID;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Find ID of name
+
+int CCodeSymbolTable::FindID(const char* pcName)
+{
+	if (!pcName || *pcName == 0)
+	{
+		return INVALID_ID;
+	}
+
+	int iID = INVALID_ID;
+
+	Lock();
+
+	TIDMap::iterator itEl = m_mapID.find(pcName);
+	if (itEl != m_mapID.end())
+	{
+		iID = itEl->second;
+	}
+
+	Unlock();
+
+	return iID;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Number of symbols
+
+int CCodeSymbolTable::Count()
+{
+	Lock();
+	int iCnt = int(m_mapID.size());
+	Unlock();
+
+	return iCnt;
+}
@@ -0,0 +1,87 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// project:   CluTec.Viz.Parse
+// file:      CodeSymbolTable.h
+//
+// summary:   Declares the code symbol table class
+//
+//            Copyright (c) 2019 by Christian Perwass.
+//
+//            This file is part of the CluTecLib library.
+//
+//            The CluTecLib library is free software: you can redistribute it and / or modify
+//            it under the terms of the GNU Lesser General Public License as published by
+//            the Free Software Foundation, either version 3 of the License, or
+//            (at your option) any later version.
+//
+//            The CluTecLib library is distributed in the hope that it will be useful,
+//            but WITHOUT ANY WARRANTY; without even the implied warranty of
+//            MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//            GNU Lesser General Public License for more details.
+//
+//            You should have received a copy of the GNU Lesser General Public License
+//            along with the CluTecLib library.
+//            If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <string>
+#include <unordered_map>
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// <summary>
+/// 	Maps variable names to unique integer symbol IDs.
+///
+/// 	Labels resolve their name to a symbol ID once at parse time. Variable lists store their variables additionally in
+/// 	slots indexed by the symbol ID, so that a variable access at run time is an array lookup without any string hashing
+/// 	or comparison. Names that are only known at run time, for example variables created by functions from strings, are
+/// 	mapped to IDs via a hash map. The table is shared by all parsers in the process and symbol IDs are never reused.
+/// </summary>
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+class CCodeSymbolTable
+{
+public:
+
+	enum
+	{
+		// ID returned for invalid or unknown names
+		INVALID_ID = -1
+	};
+
+	typedef std::unordered_map<std::string, int> TIDMap;
+
+public:
+
+	// The process wide symbol table
+	static CCodeSymbolTable& Global();
+
+	// Returns the ID of the given name. Creates a new ID if the name
+	// is not in the table yet. Returns INVALID_ID for an empty name.
+	int GetID(const char* pcName);
+
+	// Returns the ID of the given name or INVALID_ID if the name
+	// is not in the table.
+	int FindID(const char* pcName);
+
+	// Number of symbols in table
+	int Count();
+
+protected:
+
+	CCodeSymbolTable();
+	~CCodeSymbolTable();
+
+	void Lock() { EnterCriticalSection(&m_xLock); }
+	void Unlock() { LeaveCriticalSection(&m_xLock); }
+
+private:
+
+	CCodeSymbolTable(const CCodeSymbolTable&);
+	CCodeSymbolTable& operator=(const CCodeSymbolTable&);
+
+protected:
+
+	TIDMap m_mapID;
+	CRITICAL_SECTION m_xLock;
+};
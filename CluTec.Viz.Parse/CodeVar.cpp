@@ -45,6 +45,9 @@ CCodeVar::CCodeVar()
 
 	m_bProtected = false;
 	m_bIsPtr     = false;
+
+	m_nSpareType = PDT_NOTYPE;
+	m_pSpareData = 0;
 }
 
 CCodeVar::CCodeVar(const CCodeVar& rVar)
@@ -59,6 +62,9 @@ CCodeVar::CCodeVar(const CCodeVar& rVar)
 	m_bProtected = false;
 	m_bIsPtr     = false;
 
+	m_nSpareType = PDT_NOTYPE;
+	m_pSpareData = 0;
+
 	CopyInstance(rVar);
 }
 
@@ -437,6 +443,91 @@ void CCodeVar::Destroy()
 {
 	InvalidateReferences();
 	Delete(true);
+	DeleteSpareData();
+}
+
+//////////////////////////////////////////////////////////////////////
+// Reset all references to this variable and delete variable content,
+// but keep the memory of multivectors and matrices.
+void CCodeVar::Recycle()
+{
+	InvalidateReferences();
+
+	if ((m_nType == PDT_MULTIV || m_nType == PDT_MATRIX) && m_pData)
+	{
+		DeleteSpareData();
+
+		m_nSpareType = m_nType;
+		m_pSpareData = m_pData;
+
+		m_nType = PDT_NOTYPE;
+		m_pData = 0;
+	}
+
+	Delete(true);
+
+	m_bProtected = false;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Delete spare data
+
+void CCodeVar::DeleteSpareData()
+{
+	if (!m_pSpareData)
+	{
+		return;
+	}
+
+	switch (m_nSpareType)
+	{
+	case PDT_MULTIV:
+		delete ((TMultiV*) m_pSpareData);
+		break;
+
+	case PDT_MATRIX:
+		delete ((TMatrix*) m_pSpareData);
+		break;
+
+	default:
+		break;
+	}
+
+	m_nSpareType = PDT_NOTYPE;
+	m_pSpareData = 0;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Reuse the memory of the current value or of the spare data
+// for the assignment of a value of type _nType.
+
+bool CCodeVar::ReuseData(ECodeDataType _nType)
+{
+	if ((_nType != PDT_MULTIV && _nType != PDT_MATRIX) || m_bProtected)
+	{
+		return false;
+	}
+
+	if (m_nType == _nType && m_pData)
+	{
+		return true;
+	}
+
+	if (m_nSpareType != _nType || !m_pSpareData)
+	{
+		return false;
+	}
+
+	if (!Delete()) { return false; }
+
+	m_bIsPtr = false;
+	m_nType  = m_nSpareType;
+	m_pData  = m_pSpareData;
+
+	m_nSpareType = PDT_NOTYPE;
+	m_pSpareData = 0;
+
+	return true;
 }
 
 //////////////////////////////////////////////////////////////////////
@@ -444,6 +535,27 @@ void CCodeVar::Destroy()
 
 bool CCodeVar::SetVar(ECodeDataType _nType, void* pData, const char* pcName)
 {
+	// Multivectors and matrices are copied into the existing memory if possible.
+	// Empty matrices are not copied by the assignment operator of TMatrix,
+	// so they always create a new instance.
+	if ((pData != m_pData)
+	    && ((_nType != PDT_MATRIX) || (((TMatrix*) pData)->Rows() && ((TMatrix*) pData)->Cols()))
+	    && ReuseData(_nType))
+	{
+		if (pcName) { m_sName = pcName; }
+
+		if (_nType == PDT_MULTIV)
+		{
+			*((TMultiV*) m_pData) = *((TMultiV*) pData);
+		}
+		else
+		{
+			*((TMatrix*) m_pData) = *((TMatrix*) pData);
+		}
+
+		return true;
+	}
+
 	if (!New(_nType, pcName)) { return false; }
 
 	TVarPtr pVar;
@@ -130,6 +130,15 @@ public:
 	// Reset all references to this variable and delete variable content.
 	void Destroy();
 
+	// Reset all references to this variable and delete variable content,
+	// but keep the memory of a multivector or matrix as spare data, which
+	// is reused when a value of the same type is assigned next.
+	// Used for recycling temporary variables.
+	void Recycle();
+
+	// Delete spare data kept by Recycle().
+	void DeleteSpareData();
+
 	void EnableProtect(bool bVal = true) { m_bProtected = bVal; }
 	bool IsProtected() { return m_bProtected; }
 
@@ -281,6 +290,10 @@ protected:
 
 	bool SetVar(ECodeDataType _nType, void* _pData, const char* pcName = 0);
 
+	// Prepares the variable for the assignment of a value of the given type
+	// without allocating new memory. Only implemented for multivectors and matrices.
+	bool ReuseData(ECodeDataType _nType);
+
 	union UData
 	{
 		int Int;
@@ -302,6 +315,10 @@ protected:
 	// True if stored variable is pointer
 	bool m_bIsPtr;
 
+	// Memory of a previous value kept by Recycle()
+	ECodeDataType m_nSpareType;
+	void* m_pSpareData;
+
 	// List of CodeVars that reference this CodeVar
 	std::set<CCodeVar*> m_setRefBy;
 };
@@ -26,13 +26,16 @@
 
 #include "StdAfx.h"
 #include "CodeVarList.h"
+#include "CodeSymbolTable.h"
 
 //////////////////////////////////////////////////////////////////////
 // Konstruktion/Destruktion
 //////////////////////////////////////////////////////////////////////
 
-CCodeVarList::CCodeVarList()
+CCodeVarList::CCodeVarList(ESlotMode eSlotMode)
 {
+	m_eSlotMode = eSlotMode;
+
 	m_VarInvalid.New(PDT_NOTYPE, "_INVALID_");
 	m_VarInvalid.EnableProtect();
 }
@@ -48,21 +51,27 @@ CCodeVarList::~CCodeVarList()
 // New creates new variable with given name and type
 // and returns position in List. return value -1 indicates error.
 
-bool CCodeVarList::New(const char *pcName, ECodeDataType _nType)
+bool CCodeVarList::New(const char *pcName, ECodeDataType _nType, int iSymID)
 {
 	if (!pcName || *pcName == 0)
 		return false;
 
-	TVarMapIt itEl;
+	if (iSymID < 0)
+		iSymID = CCodeSymbolTable::Global().GetID(pcName);
 
 	// If variable already exists cannot create it again.
-	if ( (itEl = m_mapVarList.find( string(pcName) )) != m_mapVarList.end() )
+	if ( GetSlot(iSymID) )
 		return false;
 
 	CCodeVar& rVar = m_mapVarList[ string(pcName) ];
 
 	if ( !rVar.New( _nType, pcName ) )
+	{
+		m_mapVarList.erase( string(pcName) );
 		return false;
+	}
+
+	SetSlot(iSymID, &rVar);
 
 	return true;
 }
@@ -80,6 +89,8 @@ bool CCodeVarList::Delete(const char *pcName)
 	if ( (itEl = m_mapVarList.find( string(pcName) )) == m_mapVarList.end() )
 		return false;
 
+	SetSlot(CCodeSymbolTable::Global().FindID(pcName), 0);
+
 	m_mapVarList.erase( itEl );
 	return true;
 }
@@ -90,12 +101,56 @@ CCodeVar& CCodeVarList::GetVar(const char* pcName)
 	if ( !pcName || *pcName == 0 )
 		return m_VarInvalid;
 
-	TVarMapIt itEl;
+	return GetVar( CCodeSymbolTable::Global().FindID(pcName) );
+}
 
-	if ( (itEl = m_mapVarList.find( string(pcName) )) == m_mapVarList.end() )
-		return m_VarInvalid;
+//////////////////////////////////////////////////////////////////////
+// Set the variable pointer of a slot. If pVar == 0 the slot is cleared.
 
-	return itEl->second;
+void CCodeVarList::SetSlot(int iSymID, CCodeVar* pVar)
+{
+	if (iSymID < 0)
+		return;
+
+	if (m_eSlotMode == SLOT_DENSE)
+	{
+		if (iSymID >= int(m_vecSlot.size()))
+		{
+			if (!pVar)
+				return;
+
+			m_vecSlot.resize(iSymID + 1, 0);
+		}
+
+		m_vecSlot[iSymID] = pVar;
+		return;
+	}
+
+	int iIdx, iCnt = int(m_vecSparseSlot.size());
+	for (iIdx = 0; iIdx < iCnt; ++iIdx)
+	{
+		SSparseSlot& rSlot = m_vecSparseSlot[iIdx];
+		if (rSlot.iSymID == iSymID)
+		{
+			if (pVar)
+			{
+				rSlot.pVar = pVar;
+			}
+			else
+			{
+				m_vecSparseSlot.erase(m_vecSparseSlot.begin() + iIdx);
+			}
+			return;
+		}
+	}
+
+	if (pVar)
+	{
+		SSparseSlot xSlot;
+		xSlot.iSymID = iSymID;
+		xSlot.pVar   = pVar;
+		m_vecSparseSlot.push_back(xSlot);
+	}
 }
 
 //////////////////////////////////////////////////////////////////////
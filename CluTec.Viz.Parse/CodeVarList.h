@@ -33,6 +33,7 @@
 
 #include <map>
 #include <string>
+#include <vector>
 #include "CodeVar.h"
 
 using namespace std;
@@ -43,21 +44,40 @@ public:
 	typedef map<string,CCodeVar> TVarMap;
 	typedef map<string,CCodeVar>::iterator TVarMapIt;
 
+	// Variables are additionally stored in slots indexed by their symbol ID
+	// from CCodeSymbolTable. Dense slots are an array over all symbol IDs,
+	// which is best for the global lists. Sparse slots are a short list of
+	// ID/variable pairs, which is best for the local lists of functions.
+	enum ESlotMode
+	{
+		SLOT_DENSE,
+		SLOT_SPARSE
+	};
+
 public:
-	CCodeVarList();
+	CCodeVarList(ESlotMode eSlotMode = SLOT_DENSE);
 	virtual ~CCodeVarList();
 
 	// Empty variable list.
-	void Reset() { m_mapVarList.clear(); }
+	void Reset() { m_mapVarList.clear(); m_vecSlot.clear(); m_vecSparseSlot.clear(); }
 
 	// New creates new variable with given name and type
-	// returns false if variable already exists
-	bool New(const char *pcName, ECodeDataType _nType = PDT_INT);
+	// returns false if variable already exists.
+	// If the symbol ID of the name is known it can be passed in iSymID.
+	bool New(const char *pcName, ECodeDataType _nType = PDT_INT, int iSymID = -1);
 	bool Delete(const char *pcName);
 
 	// If variable of given name does not exist, returns variable m_VarInvalid.
 	// This variable is by default called "_INVALID_" and is of type PDT_NOTYPE.
+	// The name is mapped to its symbol ID via the hash map of the symbol table.
 	CCodeVar& GetVar(const char* pcName);
+
+	// Same as above but for the symbol ID of the name.
+	CCodeVar& GetVar(int iSymID)
+	{
+		CCodeVar* pVar = GetSlot(iSymID);
+		return (pVar ? *pVar : m_VarInvalid);
+	}
 	//{ int i = GetPos(pcName); if (i < 0) return m_VarInvalid; else return m_mVarList[i]; }
 
 	// Get Position of Var in List. Returns -1 if variable does not exist.
@@ -77,11 +97,50 @@ public:
 
 	int Count() { return (int) m_mapVarList.size(); }
 
+protected:
+
+	struct SSparseSlot
+	{
+		int iSymID;
+		CCodeVar* pVar;
+	};
+
+	CCodeVar* GetSlot(int iSymID)
+	{
+		if (m_eSlotMode == SLOT_DENSE)
+		{
+			return ((unsigned(iSymID) < unsigned(m_vecSlot.size())) ? m_vecSlot[iSymID] : 0);
+		}
+
+		int iIdx, iCnt = int(m_vecSparseSlot.size());
+		for (iIdx = 0; iIdx < iCnt; ++iIdx)
+		{
+			if (m_vecSparseSlot[iIdx].iSymID == iSymID)
+			{
+				return m_vecSparseSlot[iIdx].pVar;
+			}
+		}
+
+		return 0;
+	}
+
+	void SetSlot(int iSymID, CCodeVar* pVar);
+
+private:
+
+	// Slots point into the variable map of this instance
+	CCodeVarList(const CCodeVarList&);
+	CCodeVarList& operator=(const CCodeVarList&);
+
 protected:
 
 	TVarMap m_mapVarList;
 	TVarMapIt m_mapVarIt;
 
+	ESlotMode m_eSlotMode;
+	std::vector<CCodeVar*> m_vecSlot;
+	std::vector<SSparseSlot> m_vecSparseSlot;
+
 	CCodeVar m_VarInvalid;
 };
 
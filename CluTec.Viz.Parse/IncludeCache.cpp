@@ -0,0 +1,538 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// project:   CluTec.Viz.Parse
+// file:      IncludeCache.cpp
+//
+// summary:   Implements the include cache class
+//
+//            Copyright (c) 2019 by Christian Perwass.
+//
+//            This file is part of the CluTecLib library.
+//
+//            The CluTecLib library is free software: you can redistribute it and / or modify
+//            it under the terms of the GNU Lesser General Public License as published by
+//            the Free Software Foundation, either version 3 of the License, or
+//            (at your option) any later version.
+//
+//            The CluTecLib library is distributed in the hope that it will be useful,
+//            but WITHOUT ANY WARRANTY; without even the implied warranty of
+//            MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//            GNU Lesser General Public License for more details.
+//
+//            You should have received a copy of the GNU Lesser General Public License
+//            along with the CluTecLib library.
+//            If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "StdAfx.h"
+#include "IncludeCache.h"
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <algorithm>
+
+static const char s_pcIncludeCacheID[8] = { 'C', 'L', 'U', 'I', 'N', 'C', 'P', 'P' };
+
+// Buffered reading and writing of the values of a cache file
+class CIncludeCacheFile
+{
+public:
+
+	// Minimal number of bytes of a file stamp and a text line in a cache file
+	static const size_t c_nMinStampSize = sizeof(uint32_t) + 4 * sizeof(int64_t);
+	static const size_t c_nMinLineSize  = 3 * sizeof(uint32_t) + 4 * sizeof(int32_t);
+
+	CIncludeCacheFile() { m_pFile = 0; m_nSize = 0; }
+	~CIncludeCacheFile() { Close(); }
+
+	bool Open(const std::string& sFilename, const char* pcMode)
+	{
+		fopen_s(&m_pFile, sFilename.c_str(), pcMode);
+		if (!m_pFile)
+		{
+			return false;
+		}
+
+		// Size of file to check counts read from it
+		m_nSize = 0;
+		if ((pcMode[0] == 'r') && (fseek(m_pFile, 0, SEEK_END) == 0))
+		{
+			long iSize = ftell(m_pFile);
+			m_nSize = (iSize > 0 ? size_t(iSize) : 0);
+			fseek(m_pFile, 0, SEEK_SET);
+		}
+
+		return true;
+	}
+
+	bool Close()
+	{
+		bool bOK = true;
+		if (m_pFile)
+		{
+			bOK     = (fclose(m_pFile) == 0);
+			m_pFile = 0;
+		}
+		return bOK;
+	}
+
+	bool Write(const void* pvData, size_t nSize) { return nSize == 0 || fwrite(pvData, 1, nSize, m_pFile) == nSize; }
+	bool Read(void* pvData, size_t nSize) { return nSize == 0 || fread(pvData, 1, nSize, m_pFile) == nSize; }
+
+	template<class T>
+	bool WriteValue(const T& xVal) { return Write(&xVal, sizeof(T)); }
+
+	template<class T>
+	bool ReadValue(T& xVal) { return Read(&xVal, sizeof(T)); }
+
+	// True if the rest of the file can contain the given number of elements.
+	// Counts read from a damaged file must not be used to allocate memory otherwise.
+	bool CanRead(uint32_t uCnt, size_t nMinElSize)
+	{
+		long iPos = ftell(m_pFile);
+		if ((iPos < 0) || (size_t(iPos) > m_nSize))
+		{
+			return false;
+		}
+
+		return uint64_t(uCnt) * uint64_t(nMinElSize) <= uint64_t(m_nSize - size_t(iPos));
+	}
+
+	bool WriteString(const char* pcText, size_t nLen)
+	{
+		return WriteValue(uint32_t(nLen)) && Write(pcText, nLen);
+	}
+
+	bool ReadString(std::string& sText)
+	{
+		uint32_t uLen;
+		if (!ReadValue(uLen) || !CanRead(uLen, 1))
+		{
+			return false;
+		}
+
+		sText.resize(uLen);
+		return Read(&sText[0], uLen);
+	}
+
+	bool WriteStamp(const CIncludeCache::SFileStamp& xStamp)
+	{
+		return WriteString(xStamp.sFilename.c_str(), xStamp.sFilename.size())
+		       && WriteValue(xStamp.iModTime) && WriteValue(xStamp.iSize) && WriteValue(xStamp.uHash)
+		       && WriteValue(xStamp.iStampTime);
+	}
+
+	bool ReadStamp(CIncludeCache::SFileStamp& xStamp)
+	{
+		xStamp.bBinary = false;
+		return ReadString(xStamp.sFilename)
+		       && ReadValue(xStamp.iModTime) && ReadValue(xStamp.iSize) && ReadValue(xStamp.uHash)
+		       && ReadValue(xStamp.iStampTime);
+	}
+
+	bool WriteLine(const STextLine& xLine)
+	{
+		if (!WriteString(xLine.csText.Str(), xLine.csText.Len())
+		    || !WriteString(xLine.csInputText.Str(), xLine.csInputText.Len())
+		    || !WriteString(xLine.csFilename.Str(), xLine.csFilename.Len())
+		    || !WriteValue(int32_t(xLine.iLine))
+		    || !WriteValue(int32_t(xLine.iMainFilePos))
+		    || !WriteValue(int32_t(xLine.iInputTextStartPos))
+		    || !WriteValue(uint32_t(xLine.vecPos.size())))
+		{
+			return false;
+		}
+
+		return xLine.vecPos.empty() || Write(&xLine.vecPos[0], xLine.vecPos.size() * sizeof(int));
+	}
+
+	bool ReadLine(STextLine& xLine, std::string& sText)
+	{
+		int32_t iLine, iMainFilePos, iInputTextStartPos;
+		uint32_t uPosCnt;
+
+		if (!ReadString(sText)) { return false; }
+		xLine.csText = sText.c_str();
+
+		if (!ReadString(sText)) { return false; }
+		xLine.csInputText = sText.c_str();
+
+		if (!ReadString(sText)) { return false; }
+		xLine.csFilename = sText.c_str();
+
+		if (!ReadValue(iLine) || !ReadValue(iMainFilePos) || !ReadValue(iInputTextStartPos) || !ReadValue(uPosCnt)
+		    || !CanRead(uPosCnt, sizeof(int)))
+		{
+			return false;
+		}
+
+		xLine.iLine              = iLine;
+		xLine.iMainFilePos       = iMainFilePos;
+		xLine.iInputTextStartPos = iInputTextStartPos;
+
+		xLine.vecPos.resize(uPosCnt);
+		return uPosCnt == 0 || Read(&xLine.vecPos[0], uPosCnt * sizeof(int));
+	}
+
+protected:
+
+	FILE* m_pFile;
+	// Size of file opened for reading
+	size_t m_nSize;
+};
+
+//////////////////////////////////////////////////////////////////////
+// Include Cache
+
+CIncludeCache::CIncludeCache()
+{
+	m_bEnabled = true;
+	memset(&m_xStats, 0, sizeof(SStats));
+}
+
+CIncludeCache::~CIncludeCache()
+{
+}
+
+void CIncludeCache::Enable(bool bVal)
+{
+	m_bEnabled = bVal;
+
+	if (!m_bEnabled)
+	{
+		Clear();
+	}
+}
+
+void CIncludeCache::SetCachePath(const std::string& sPath)
+{
+	if (sPath != m_sCachePath)
+	{
+		m_sCachePath = sPath;
+		Clear();
+	}
+}
+
+void CIncludeCache::Clear()
+{
+	m_mapEntry.clear();
+}
+
+void CIncludeCache::ResetStats()
+{
+	memset(&m_xStats, 0, sizeof(SStats));
+}
+
+//////////////////////////////////////////////////////////////////////
+// Find entry and check whether its files changed
+
+const CIncludeCache::SEntry* CIncludeCache::Find(const std::string& sKey, const std::vector<std::string>& vecExclude)
+{
+	if (!m_bEnabled)
+	{
+		return 0;
+	}
+
+	std::map<std::string, SEntry>::iterator itEntry = m_mapEntry.find(sKey);
+
+	if (itEntry == m_mapEntry.end() && !m_sCachePath.empty())
+	{
+		SEntry xEntry;
+		if (Load(sKey, xEntry))
+		{
+			++m_xStats.uLoadCnt;
+			itEntry = m_mapEntry.insert(std::make_pair(sKey, SEntry())).first;
+			itEntry->second.vecFile.swap(xEntry.vecFile);
+			itEntry->second.vecLine.swap(xEntry.vecLine);
+			itEntry->second.iMainFilePos = xEntry.iMainFilePos;
+		}
+	}
+
+	if (itEntry == m_mapEntry.end())
+	{
+		++m_xStats.uMissCnt;
+		return 0;
+	}
+
+	if (!IsValid(itEntry->second, vecExclude))
+	{
+		m_mapEntry.erase(itEntry);
+		++m_xStats.uMissCnt;
+		return 0;
+	}
+
+	++m_xStats.uHitCnt;
+	return &itEntry->second;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Add entry. The lines and files of xEntry are moved to the cache.
+
+void CIncludeCache::Add(const std::string& sKey, SEntry& xEntry)
+{
+	if (!m_bEnabled || xEntry.vecFile.empty())
+	{
+		return;
+	}
+
+	// Files that could not be read cannot be checked for changes
+	for (const SFileStamp& xStamp : xEntry.vecFile)
+	{
+		if (xStamp.iSize < 0)
+		{
+			return;
+		}
+	}
+
+	SEntry& xCacheEntry = m_mapEntry[sKey];
+	xCacheEntry.vecFile.swap(xEntry.vecFile);
+	xCacheEntry.vecLine.swap(xEntry.vecLine);
+	xCacheEntry.iMainFilePos = xEntry.iMainFilePos;
+
+	if (!m_sCachePath.empty() && IsPersistent(xCacheEntry))
+	{
+		if (Save(sKey, xCacheEntry))
+		{
+			++m_xStats.uSaveCnt;
+		}
+	}
+}
+
+//////////////////////////////////////////////////////////////////////
+
+bool CIncludeCache::IsValid(SEntry& xEntry, const std::vector<std::string>& vecExclude)
+{
+	for (size_t nFile = 0; nFile < xEntry.vecFile.size(); ++nFile)
+	{
+		SFileStamp& xStamp = xEntry.vecFile[nFile];
+
+		if ((nFile > 0) && (std::find(vecExclude.begin(), vecExclude.end(), xStamp.sFilename) != vecExclude.end()))
+		{
+			return false;
+		}
+
+		SFileStamp xCurStamp;
+		if (!GetFileStamp(xCurStamp, xStamp.sFilename, false))
+		{
+			return false;
+		}
+
+		// A file modified in the second the stamp was taken may have been modified again in the same second
+		if ((xCurStamp.iModTime == xStamp.iModTime) && (xCurStamp.iSize == xStamp.iSize) && (xStamp.iModTime < xStamp.iStampTime))
+		{
+			continue;
+		}
+
+		// The file may have been written again. It has only changed if its content is different.
+		if ((xCurStamp.iSize != xStamp.iSize) || !GetFileStamp(xCurStamp, xStamp.sFilename, true)
+		    || (xCurStamp.uHash != xStamp.uHash))
+		{
+			return false;
+		}
+
+		xStamp.iModTime   = xCurStamp.iModTime;
+		xStamp.iStampTime = xCurStamp.iStampTime;
+	}
+
+	return true;
+}
+
+bool CIncludeCache::IsPersistent(const SEntry& xEntry) const
+{
+	for (const SFileStamp& xStamp : xEntry.vecFile)
+	{
+		if (xStamp.bBinary)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////
+
+bool CIncludeCache::GetFileStamp(SFileStamp& xStamp, const std::string& sFilename, bool bHash)
+{
+	struct _stat64 xStat;
+
+	xStamp.sFilename  = sFilename;
+	xStamp.iModTime   = 0;
+	xStamp.iSize      = -1;
+	xStamp.uHash      = 0;
+	xStamp.iStampTime = int64_t(time(0));
+	xStamp.bBinary    = false;
+
+	if (_stat64(sFilename.c_str(), &xStat) != 0)
+	{
+		return false;
+	}
+
+	if (bHash)
+	{
+		FILE* pFile = 0;
+		fopen_s(&pFile, sFilename.c_str(), "rb");
+		if (!pFile)
+		{
+			return false;
+		}
+
+		char pcBuffer[16384];
+		size_t nRead;
+		int64_t iSize  = 0;
+		uint64_t uHash = Hash(0, 0);
+
+		while ((nRead = fread(pcBuffer, 1, sizeof(pcBuffer), pFile)) > 0)
+		{
+			uHash  = Hash(pcBuffer, nRead, uHash);
+			iSize += int64_t(nRead);
+		}
+
+		fclose(pFile);
+
+		// The file changed while it was read
+		if (iSize != int64_t(xStat.st_size))
+		{
+			return false;
+		}
+
+		xStamp.uHash = uHash;
+	}
+
+	xStamp.iModTime = int64_t(xStat.st_mtime);
+	xStamp.iSize    = int64_t(xStat.st_size);
+
+	return true;
+}
+
+uint64_t CIncludeCache::Hash(const void* pvData, size_t nSize, uint64_t uHash)
+{
+	const unsigned char* pucData = (const unsigned char*) pvData;
+
+	for (size_t nIdx = 0; nIdx < nSize; ++nIdx)
+	{
+		uHash ^= pucData[nIdx];
+		uHash *= 0x100000001b3ULL;
+	}
+
+	return uHash;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Cache files
+
+std::string CIncludeCache::GetCacheFilename(const std::string& sKey) const
+{
+	char pcName[32];
+	sprintf_s(pcName, 32, "%016llx.clupp", (unsigned long long) Hash(sKey.c_str(), sKey.size()));
+
+	std::string sFilename = m_sCachePath;
+	if (!sFilename.empty() && (sFilename.back() != '\\') && (sFilename.back() != '/'))
+	{
+		sFilename += "\\";
+	}
+
+	return sFilename + pcName;
+}
+
+bool CIncludeCache::Load(const std::string& sKey, SEntry& xEntry)
+{
+	CIncludeCacheFile xFile;
+	char pcID[8];
+	uint32_t uVersion, uFileCnt, uLineCnt;
+	int32_t iMainFilePos;
+	std::string sFileKey, sText;
+
+	if (!xFile.Open(GetCacheFilename(sKey), "rb"))
+	{
+		return false;
+	}
+
+	if (!xFile.Read(pcID, 8) || memcmp(pcID, s_pcIncludeCacheID, 8) != 0
+	    || !xFile.ReadValue(uVersion) || (uVersion != INCLUDECACHE_VERSION))
+	{
+		return false;
+	}
+
+	// Different keys may have the same cache file
+	if (!xFile.ReadString(sFileKey) || (sFileKey != sKey))
+	{
+		return false;
+	}
+
+	if (!xFile.ReadValue(uFileCnt) || (uFileCnt == 0) || !xFile.CanRead(uFileCnt, CIncludeCacheFile::c_nMinStampSize))
+	{
+		return false;
+	}
+
+	xEntry.vecFile.resize(uFileCnt);
+	for (SFileStamp& xStamp : xEntry.vecFile)
+	{
+		if (!xFile.ReadStamp(xStamp))
+		{
+			return false;
+		}
+	}
+
+	if (!xFile.ReadValue(iMainFilePos) || !xFile.ReadValue(uLineCnt) || !xFile.CanRead(uLineCnt, CIncludeCacheFile::c_nMinLineSize))
+	{
+		return false;
+	}
+
+	xEntry.iMainFilePos = iMainFilePos;
+	xEntry.vecLine.resize(uLineCnt);
+	for (STextLine& xLine : xEntry.vecLine)
+	{
+		if (!xFile.ReadLine(xLine, sText))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool CIncludeCache::Save(const std::string& sKey, const SEntry& xEntry)
+{
+	CIncludeCacheFile xFile;
+	std::string sFilename    = GetCacheFilename(sKey);
+	std::string sTmpFilename = sFilename + ".tmp";
+
+	if (!xFile.Open(sTmpFilename, "wb"))
+	{
+		m_sError = "Cannot write include cache file '" + sTmpFilename + "'";
+		return false;
+	}
+
+	bool bOK = xFile.Write(s_pcIncludeCacheID, 8)
+		   && xFile.WriteValue(uint32_t(INCLUDECACHE_VERSION))
+		   && xFile.WriteString(sKey.c_str(), sKey.size())
+		   && xFile.WriteValue(uint32_t(xEntry.vecFile.size()));
+
+	for (size_t nFile = 0; bOK && nFile < xEntry.vecFile.size(); ++nFile)
+	{
+		bOK = xFile.WriteStamp(xEntry.vecFile[nFile]);
+	}
+
+	bOK = bOK && xFile.WriteValue(int32_t(xEntry.iMainFilePos)) && xFile.WriteValue(uint32_t(xEntry.vecLine.size()));
+
+	for (size_t nLine = 0; bOK && nLine < xEntry.vecLine.size(); ++nLine)
+	{
+		bOK = xFile.WriteLine(xEntry.vecLine[nLine]);
+	}
+
+	bOK = xFile.Close() && bOK;
+
+	// Replace the cache file only if the new one is complete
+	if (!bOK || ((remove(sFilename.c_str()) != 0) && (errno != ENOENT)) || (rename(sTmpFilename.c_str(), sFilename.c_str()) != 0))
+	{
+		remove(sTmpFilename.c_str());
+		m_sError = "Cannot write include cache file '" + sFilename + "'";
+		return false;
+	}
+
+	return true;
+}
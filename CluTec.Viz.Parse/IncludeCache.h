@@ -0,0 +1,155 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// project:   CluTec.Viz.Parse
+// file:      IncludeCache.h
+//
+// summary:   Declares the include cache class
+//
+//            Copyright (c) 2019 by Christian Perwass.
+//
+//            This file is part of the CluTecLib library.
+//
+//            The CluTecLib library is free software: you can redistribute it and / or modify
+//            it under the terms of the GNU Lesser General Public License as published by
+//            the Free Software Foundation, either version 3 of the License, or
+//            (at your option) any later version.
+//
+//            The CluTecLib library is distributed in the hope that it will be useful,
+//            but WITHOUT ANY WARRANTY; without even the implied warranty of
+//            MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//            GNU Lesser General Public License for more details.
+//
+//            You should have received a copy of the GNU Lesser General Public License
+//            along with the CluTecLib library.
+//            If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Cache of preparsed include files.
+// The preparser stores the text lines it generates for an include file together with the
+// modification time, size and content hash of the file and of all files it includes in turn.
+// When the file is included again and none of these files changed, the stored lines are
+// used instead of reading and preparsing the files again. A file whose modification time
+// changed but whose content hash is the same is not regarded as changed. Since modification
+// times only have a resolution of seconds, the content hash is also compared if a file was
+// modified in the second its stamp was taken.
+//
+// If a cache path is set, entries are also written to files in this folder, so that they
+// are available after a restart. Entries that contain lines of binary include files are
+// only kept in memory, since the decoded code must not be stored.
+//
+// File layout, all values in the byte order of the machine (little endian):
+//   Header:  ID "CLUINCPP", uint32 version
+//   Key:     string
+//   Files:   uint32 count, followed by one file stamp per file. The first one is the include file.
+//   Lines:   int32 main file position, uint32 count, followed by the fields of each line
+// Strings are stored as uint32 length followed by the characters.
+
+#if !defined(_INCLUDECACHE_H__INCLUDED_)
+	#define _INCLUDECACHE_H__INCLUDED_
+
+#if _MSC_VER > 1000
+#pragma once
+#endif	// _MSC_VER > 1000
+
+#include <stdio.h>
+#include <stdint.h>
+#include <vector>
+#include <string>
+#include <map>
+
+#include "ParseTypes.h"
+
+#define INCLUDECACHE_VERSION	1
+
+////////////////////////////////////////////////////////////////////////////////////
+// Include Cache
+//
+	class CIncludeCache
+	{
+	public:
+
+		// Modification time, size and content hash of a file
+		struct SFileStamp
+		{
+			std::string sFilename;
+			int64_t iModTime;
+			// Negative if the file could not be read
+			int64_t iSize;
+			uint64_t uHash;
+			// Time the stamp was taken
+			int64_t iStampTime;
+			// File is a binary include file
+			bool bBinary;
+		};
+
+		struct SEntry
+		{
+			// The include file, followed by all files it includes
+			std::vector<SFileStamp> vecFile;
+			// Position in the main file of the include statement the lines were preparsed for.
+			// Lines with this position are set to the position of the current include statement.
+			int iMainFilePos;
+			std::vector<STextLine> vecLine;
+		};
+
+		struct SStats
+		{
+			unsigned uHitCnt;
+			unsigned uMissCnt;
+			// Number of entries read from and written to the cache path
+			unsigned uLoadCnt;
+			unsigned uSaveCnt;
+		};
+
+	public:
+
+		CIncludeCache();
+		~CIncludeCache();
+
+		void Enable(bool bVal);
+		bool IsEnabled() const { return m_bEnabled; }
+
+		// Folder entries are written to and read from. Entries are only kept in memory if the path is empty.
+		// Changing the path removes all entries from memory, so that they are read from the new folder.
+		void SetCachePath(const std::string& sPath);
+		const std::string& GetCachePath() const { return m_sCachePath; }
+
+		// Removes all entries from memory. Files in the cache path are kept.
+		void Clear();
+
+		// Returns the entry with key sKey, or null if there is none or one of its files changed.
+		// The entry is also invalid if one of the files included by the include file is in vecExclude,
+		// so that recursive includes are reported by the preparser.
+		const SEntry* Find(const std::string& sKey, const std::vector<std::string>& vecExclude);
+
+		void Add(const std::string& sKey, SEntry& xEntry);
+
+		// Reads modification time and size of a file. The content hash is only evaluated if bHash is true.
+		static bool GetFileStamp(SFileStamp& xStamp, const std::string& sFilename, bool bHash);
+
+		// FNV-1a hash of nSize bytes
+		static uint64_t Hash(const void* pvData, size_t nSize, uint64_t uHash = 0xcbf29ce484222325ULL);
+
+		const SStats& GetStats() const { return m_xStats; }
+		void ResetStats();
+		const std::string& GetError() const { return m_sError; }
+
+	protected:
+
+		bool IsValid(SEntry& xEntry, const std::vector<std::string>& vecExclude);
+		bool IsPersistent(const SEntry& xEntry) const;
+
+		std::string GetCacheFilename(const std::string& sKey) const;
+		bool Load(const std::string& sKey, SEntry& xEntry);
+		bool Save(const std::string& sKey, const SEntry& xEntry);
+
+	protected:
+
+		bool m_bEnabled;
+		std::string m_sCachePath;
+		std::map<std::string, SEntry> m_mapEntry;
+		SStats m_xStats;
+		std::string m_sError;
+	};
+
+#endif	// _INCLUDECACHE_H__INCLUDED_
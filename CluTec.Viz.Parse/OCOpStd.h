@@ -49,6 +49,9 @@ public:
 			  TOpUnaryPtr UFunc, TOpBinaryPtr BFunc,
 			  TOpAUnaryPtr AUFunc, TOpABinaryPtr ABFunc);
 
+	// Scalar operation the bytecode interpreter may use instead of the binary function
+	void SetScalarOp(CCodeOperator::EScalarOp eOp) { m_Operator.SetScalarOp(eOp); }
+
 protected:
 	CCodeOperator m_Operator;
 };
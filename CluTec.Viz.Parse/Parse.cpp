@@ -175,6 +175,7 @@ bool CParse::Parse(int iStartLine, int iLineCount)
 	if (m_pCodeBase)
 	{
 		m_pCodeBase->ResetVarList();
+		m_pCodeBase->ResetCodeLineCache();
 	}
 
 	for (iLine = iCTLine = iStartLine; iLine <= iMaxLine; iLine++, iCTLine++)
@@ -271,9 +272,20 @@ bool CParse::RunCode(int iStartLine, int iLineCount)
 
 	for (iLine = iStartLine; iLine <= iMaxLine; iLine++)
 	{
+		if (m_pCodeBase->SkipCodeLine(iLine))
+		{
+			continue;
+		}
+
 		m_pCodeBase->ResetTempVars();
 		m_pCodeBase->ResetStack();
-		if (!m_mElementList[iLine].pElement->Apply(m_pCodeBase))
+		m_pCodeBase->BeginCodeLine(iLine);
+
+		bool bOK = m_mElementList[iLine].pElement->Apply(m_pCodeBase);
+
+		m_pCodeBase->EndCodeLine(iLine, bOK);
+
+		if (!bOK)
 		{
 			if ((m_pCodeBase->m_ErrorList.Last().iLevel == CEL_INTERNAL) &&
 			    (m_pCodeBase->m_ErrorList.Last().iNo == CERR_BREAK))
@@ -28,6 +28,8 @@
 #include "VarList.h"
 #include "CodeVar.h"
 
+size_t CVarList::sm_uChunkElNo = 8;
+
 //////////////////////////////////////////////////////////////////////
 // Konstruktion/Destruktion
 //////////////////////////////////////////////////////////////////////
@@ -53,7 +55,13 @@ CVarList::~CVarList()
 CVarList& CVarList::operator= (const CVarList& rVarList)
 {
 	int i, iNo = (int) rVarList.Count();
-	
+
+	// Elements are constructed in place and then copied
+	if (iNo > 1)
+	{
+		EnableInPlaceChunkAlloc();
+	}
+
 	Set(iNo);
 
 	for(i=0;i<iNo;i++)
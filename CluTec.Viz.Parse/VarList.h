@@ -57,6 +57,20 @@ public:
 
 	bool Order(vector<int> &rIdxList);
 
+	// Construct the elements created from now on in chunks. Called before elements
+	// are constructed in place, e.g. when a list is copied or appended to.
+	// Lists of temporary variables that are moved in are not chunk allocated.
+	void EnableInPlaceChunkAlloc()
+	{ if (!IsChunkAlloc()) EnableChunkAlloc(sm_uChunkElNo); }
+
+	// Minimal number of elements per chunk used by EnableInPlaceChunkAlloc().
+	// Zero disables chunk allocation of lists.
+	static void SetChunkElementCount(size_t uElNo) { sm_uChunkElNo = uElNo; }
+	static size_t GetChunkElementCount() { return sm_uChunkElNo; }
+
+protected:
+	static size_t sm_uChunkElNo;
+
 protected:
 	// m_pCodeList gives pointer to CodeElementList which
 	// contains the code lines that created elements of
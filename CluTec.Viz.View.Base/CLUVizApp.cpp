@@ -53,6 +53,7 @@ CCLUVizApp::CCLUVizApp()
 	m_poglWin = 0;
 	m_bIsCreated = false;
 	m_bIsEmbedded = false;
+	m_uSharedBufferPublishCnt = 0;
 }
 
 ////////////////////////////////////////////////////////////////
@@ -1973,6 +1974,75 @@ bool CCLUVizApp::SetVar(const char* pcVarName, Clu::CIDataContainer xData)
 }
 
 
+////////////////////////////////////////////////////////////////
+/// Create Shared Buffer
+
+CSharedBuffer* CCLUVizApp::CreateSharedBuffer(const char* pcName, int iDataType, const vector<int>& vecDim)
+{
+	if (!m_bOGLWinValid)
+	{
+		m_sLastError = "Visualization window does not exist.";
+		return nullptr;
+	}
+
+	if (!pcName)
+	{
+		m_sLastError = "Invalid pointer to buffer name.";
+		return nullptr;
+	}
+
+	// The registry is thread safe, so the visualization does not have to be locked
+	CSharedBuffer* pBuffer = m_poglWin->m_xParse.GetCodeBase().GetSharedBufferRegistry().Create(pcName, iDataType, vecDim);
+	if (!pBuffer)
+	{
+		m_sLastError = "Invalid data type or dimensions of shared buffer.";
+		return nullptr;
+	}
+
+	return pBuffer;
+}
+
+////////////////////////////////////////////////////////////////
+/// Remove Shared Buffer
+
+bool CCLUVizApp::RemoveSharedBuffer(const char* pcName)
+{
+	if (!m_bOGLWinValid)
+	{
+		m_sLastError = "Visualization window does not exist.";
+		return false;
+	}
+
+	if (!pcName || !m_poglWin->m_xParse.GetCodeBase().GetSharedBufferRegistry().Remove(pcName))
+	{
+		m_sLastError = "Shared buffer does not exist.";
+		return false;
+	}
+
+	return true;
+}
+
+////////////////////////////////////////////////////////////////
+/// Redraw if shared buffers were published
+
+bool CCLUVizApp::UpdateSharedBuffers()
+{
+	if (!m_bOGLWinValid)
+	{
+		return false;
+	}
+
+	unsigned uCnt = m_poglWin->m_xParse.GetCodeBase().GetSharedBufferRegistry().GetPublishCount();
+	if (uCnt == m_uSharedBufferPublishCnt)
+	{
+		return false;
+	}
+
+	m_uSharedBufferPublishCnt = uCnt;
+	m_poglWin->PostRedisplay();
+	return true;
+}
+
 bool CCLUVizApp::_SetVarMesh(const char* pcVarName, const TMesh& xMesh)
 {
 	m_poglWin->LockVis();
@@ -183,6 +183,15 @@ public:
 
 	bool SetVar(const char* pcVarName, Clu::CIDataContainer xData);
 
+	// Shared buffers, which scripts can read without the data being copied between threads.
+	// The returned buffer holds a reference owned by the caller, who has to call Release() on it.
+	CSharedBuffer* CreateSharedBuffer(const char* pcName, int iDataType, const vector<int>& vecDim);
+	bool RemoveSharedBuffer(const char* pcName);
+
+	// Redraw the view if a frame was published to one of its shared buffers since the last call.
+	// Returns true if a redraw was requested.
+	bool UpdateSharedBuffers();
+
 protected:
 	bool _SetVarMesh(const char* pcVarName, const TMesh& xMesh);
 
@@ -213,6 +222,9 @@ protected:
 	CCLUOutput* m_pOutput;
 
 	bool m_bOGLWinValid;
+
+	// Publish count of shared buffers at the last call to UpdateSharedBuffers()
+	unsigned m_uSharedBufferPublishCnt;
 	bool m_bIsCreated;
 	bool m_bIsEmbedded;
 
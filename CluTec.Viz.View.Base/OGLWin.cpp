@@ -1060,6 +1060,7 @@ int COGLWin::SetScript(const char* pcScript, bool bResetEnv, bool bReparseLatex,
 	SetColorStereoMask(piMaskLeft, piMaskRight);
 
 	EnableTransparency(true);
+	EnablePickBVH(false);
 	EnableLighting(true);
 
 	m_xParse.CollectGarbage();
@@ -393,6 +393,11 @@ void COGLWin::Draw()
 			throw CLU_EXCEPTION_NEST(__FUNCTION__, std::move(ex));
 		}
 
+		// Code lines of an incrementally executed script whose inputs did not change
+		// are only skipped for runs due to tool, pick drag and animation events.
+		m_xParse.GetCodeBase().AllowCodeLineSkip(m_iExecMode != EXEC_MODE_NONE &&
+			(m_iExecMode & ~(EXEC_MODE_TOOL | EXEC_MODE_PICKDRAG | EXEC_MODE_ANIM)) == 0);
+
 		//CLU_LOG(">>>> >> Running code...");
 
 		/************************************************************************/
@@ -530,7 +535,7 @@ void COGLWin::DisplaySceneGraph()
 		if (m_bDrawColorStereo)
 		{
 			iDispCnt = 2;
-			glGetDoublev(GL_PROJECTION_MATRIX, pdWorldProjection);
+			m_SceneApplyData.xMatrixStack.GetMatrix(Clu::CMatrixStack::Projection, pdWorldProjection);
 			m_SceneApplyData.bUseColorStereo = true;
 		}
 		else
@@ -542,7 +547,7 @@ void COGLWin::DisplaySceneGraph()
 		m_SceneApplyData.bNeedAnimate = false;
 
 		double pdWorldTransform[16];
-		glGetDoublev(GL_MODELVIEW_MATRIX, pdWorldTransform);
+		m_SceneApplyData.xMatrixStack.GetMatrix(Clu::CMatrixStack::ModelView, pdWorldTransform);
 		glEnable(GL_ALPHA_TEST);
 
 		for (int iDisp = 0; iDisp < iDispCnt; ++iDisp)
@@ -552,19 +557,19 @@ void COGLWin::DisplaySceneGraph()
 
 			if (m_bDrawColorStereo)
 			{
-				glMatrixMode(GL_PROJECTION);
-				glLoadIdentity();
-				glMultMatrixd(pdWorldProjection);
+				m_SceneApplyData.xMatrixStack.MatrixMode(Clu::CMatrixStack::Projection);
+				m_SceneApplyData.xMatrixStack.LoadIdentity();
+				m_SceneApplyData.xMatrixStack.MultMatrix(pdWorldProjection);
 
 				if (iDisp == 1)
 				{
 					m_SceneApplyData.fColorStereoSep      = m_fColorStereoSep;
 					m_SceneApplyData.fColorStereoDegAngle = m_fColorStereoDegAngle;
 
-					glTranslatef(m_fColorStereoSep, 0, 0);
-					glRotatef(m_fColorStereoDegAngle, 0, 1, 0);
+					m_SceneApplyData.xMatrixStack.Translate(m_fColorStereoSep, 0, 0);
+					m_SceneApplyData.xMatrixStack.Rotate(m_fColorStereoDegAngle, 0, 1, 0);
 
-					glMatrixMode(GL_MODELVIEW);
+					m_SceneApplyData.xMatrixStack.MatrixMode(Clu::CMatrixStack::ModelView);
 					glColorMask(m_pbColorMaskLeft[0], m_pbColorMaskLeft[1], m_pbColorMaskLeft[2], m_pbColorMaskLeft[3]);
 				}
 				else
@@ -572,10 +577,10 @@ void COGLWin::DisplaySceneGraph()
 					m_SceneApplyData.fColorStereoSep      = -m_fColorStereoSep;
 					m_SceneApplyData.fColorStereoDegAngle = -m_fColorStereoDegAngle;
 
-					glTranslatef(-m_fColorStereoSep, 0, 0);
-					glRotatef(-m_fColorStereoDegAngle, 0, 1, 0);
+					m_SceneApplyData.xMatrixStack.Translate(-m_fColorStereoSep, 0, 0);
+					m_SceneApplyData.xMatrixStack.Rotate(-m_fColorStereoDegAngle, 0, 1, 0);
 
-					glMatrixMode(GL_MODELVIEW);
+					m_SceneApplyData.xMatrixStack.MatrixMode(Clu::CMatrixStack::ModelView);
 					glColorMask(m_pbColorMaskRight[0], m_pbColorMaskRight[1], m_pbColorMaskRight[2], m_pbColorMaskRight[3]);
 				}
 
@@ -644,12 +649,20 @@ void COGLWin::DisplaySceneGraph()
 			try
 			{
 				TIMER_START(dT1);
+				// The pick hierarchy is only updated for the first view of a color stereo pair
+				if (iDisp == 0)
+				{
+					BeginPickBVHUpdate();
+				}
+
 				m_pMainScene->Apply(COGLBaseElement::DRAW, m_SceneApplyData);
+				EndPickBVHUpdate();
 				CleanFrameStack();
 				TIMER_END(dT1);
 			}
 			catch (Clu::CIException& ex)
 			{
+				EndPickBVHUpdate();
 				throw CLU_EXCEPTION_NEST("Error applying first stage of main scene", std::move(ex));
 			}
 
@@ -667,7 +680,7 @@ void COGLWin::DisplaySceneGraph()
 					m_SceneApplyData.xMatrixStack.Push(Clu::CMatrixStack::ModelView);
 
 					// Apply World Transform
-					glMultMatrixd(pdWorldTransform);
+					m_SceneApplyData.xMatrixStack.MultMatrix(pdWorldTransform);
 
 					glEnable(GL_BLEND);
 					glAlphaFunc(GL_LESS, 1.0f);
@@ -723,17 +736,17 @@ void COGLWin::DisplaySceneGraph()
 				m_SceneApplyData.xMatrixStack.Push(Clu::CMatrixStack::ModelView);
 
 				// Apply World Transform
-				glMultMatrixd(pdWorldTransform);
+				m_SceneApplyData.xMatrixStack.MultMatrix(pdWorldTransform);
 			}
 		}
 
 		if (m_bDrawColorStereo)
 		{
 			glColorMask(true, true, true, true);
-			glMatrixMode(GL_PROJECTION);
-			glLoadIdentity();
-			glMultMatrixd(pdWorldProjection);
-			glMatrixMode(GL_MODELVIEW);
+			m_SceneApplyData.xMatrixStack.MatrixMode(Clu::CMatrixStack::Projection);
+			m_SceneApplyData.xMatrixStack.LoadIdentity();
+			m_SceneApplyData.xMatrixStack.MultMatrix(pdWorldProjection);
+			m_SceneApplyData.xMatrixStack.MatrixMode(Clu::CMatrixStack::ModelView);
 		}
 
 		glDisable(GL_ALPHA_TEST);
@@ -744,7 +757,7 @@ void COGLWin::DisplaySceneGraph()
 			COGLRenderTarget* pRT = dynamic_cast<COGLRenderTarget*>(m_SceneApplyData.pCurRenderTarget);
 			if (pRT != nullptr)
 			{
-				pRT->Finalize(true);
+				pRT->Finalize(true, m_SceneApplyData.xMatrixStack);
 			}
 
 			m_SceneApplyData.pCurRenderTarget = nullptr;
@@ -1136,6 +1149,12 @@ bool COGLWin::TimedFunc()
 		// If needed evaluate pick state before visualization. This is for example needed if the user releases a mouse button
 		if (m_bPickBeforeDrawOnce)
 		{
+			// The scene is redrawn below, so the pick hierarchy of the last draw may be out of date
+			if (m_bDoAnimDisplay || (m_bAnimCode && m_bDoAnimCodeStep) || m_iAnimRotType || m_bDoRedisplay)
+			{
+				InvalidatePickBVH();
+			}
+
 			Picking(MOUSEPICK_OVER, m_iPickX, m_iPickY, m_SceneApplyData.iPickW, m_SceneApplyData.iPickH);
 
 			m_bDoPicking          = false;
@@ -468,6 +468,7 @@ bool COGLWin::EW_SetScript(const char* pcScript, bool bResetEnv, bool bReparseLa
 		SetColorStereoMask(piMaskLeft, piMaskRight);
 
 		EnableTransparency(true);
+		EnablePickBVH(false);
 		EnableLighting(true);
 
 		m_xParse.CollectGarbage();
@@ -942,6 +942,170 @@ namespace Clu
 					throw CLU_EXCEPTION( "Error setting variable to object");
 				}
 			}
+
+			//////////////////////////////////////////////////////////////////////
+			/// Set Variable Number Asynchronous
+			CLUVIZDLL_API void SetVarNumberAsync(int iHandle, const char* pcVarName, int iVal)
+			{
+				if (!pAppList)
+				{
+					throw CLU_EXCEPTION( "Application pointer is invalid");
+				}
+
+				if (!pAppList->SetVarAsync(iHandle, pcVarName, iVal))
+				{
+					throw CLU_EXCEPTION( "Error queueing number variable");
+				}
+			}
+
+			//////////////////////////////////////////////////////////////////////
+			/// Set Variable Number Asynchronous
+			CLUVIZDLL_API void SetVarNumberAsync(int iHandle, const char* pcVarName, double dVal)
+			{
+				if (!pAppList)
+				{
+					throw CLU_EXCEPTION( "Application pointer is invalid");
+				}
+
+				if (!pAppList->SetVarAsync(iHandle, pcVarName, dVal))
+				{
+					throw CLU_EXCEPTION( "Error queueing number variable");
+				}
+			}
+
+			//////////////////////////////////////////////////////////////////////
+			/// Set Variable String Asynchronous
+			CLUVIZDLL_API void SetVarStringAsync(int iHandle, const char* pcVarName, const char* pcString)
+			{
+				if (!pAppList)
+				{
+					throw CLU_EXCEPTION( "Application pointer is invalid");
+				}
+				if (!pcString)
+				{
+					throw CLU_EXCEPTION( "Nullptr --> String pointer invalid");
+				}
+
+				if (!pAppList->SetVarAsync(iHandle, pcVarName, string(pcString)))
+				{
+					throw CLU_EXCEPTION( "Error queueing string variable");
+				}
+			}
+
+			//////////////////////////////////////////////////////////////////////
+			/// Set Var Tensor Asynchronous
+			CLUVIZDLL_API void SetVarTensorAsync(int iHandle, const char* pcVarName, int iDimCnt, const int* piDim, const double* pdData)
+			{
+				if (!pAppList)
+				{
+					throw CLU_EXCEPTION( "Application pointer is invalid");
+				}
+
+				if (!pAppList->SetVarAsync(iHandle, pcVarName, iDimCnt, piDim, pdData))
+				{
+					throw CLU_EXCEPTION( "Error queueing tensor variable");
+				}
+			}
+
+			//////////////////////////////////////////////////////////////////////
+			/// Set Var Color Asynchronous
+			CLUVIZDLL_API void SetVarColorAsync(int iHandle, const char* pcVarName, double dRed, double dGreen, double dBlue, double dAlpha)
+			{
+				if (!pAppList)
+				{
+					throw CLU_EXCEPTION( "Application pointer is invalid");
+				}
+
+				if (!pAppList->SetVarAsync(iHandle, pcVarName, dRed, dGreen, dBlue, dAlpha))
+				{
+					throw CLU_EXCEPTION( "Error queueing color variable");
+				}
+			}
+
+			//////////////////////////////////////////////////////////////////////
+			/// Wait for asynchronous variable updates
+			CLUVIZDLL_API void FlushVarAsync()
+			{
+				if (!pAppList)
+				{
+					throw CLU_EXCEPTION( "Application pointer is invalid");
+				}
+
+				if (!pAppList->FlushVarAsync())
+				{
+					throw CLU_EXCEPTION( "Error applying asynchronous variable updates");
+				}
+			}
+
+			//////////////////////////////////////////////////////////////////////
+			/// Create Shared Buffer
+			CLUVIZDLL_API void* CreateSharedBuffer(int iHandle, const char* pcName, int iDataType, int iDimCnt, const int* piDim)
+			{
+				if (!pAppList)
+				{
+					throw CLU_EXCEPTION( "Application pointer is invalid");
+				}
+
+				CSharedBuffer* pBuffer = nullptr;
+				if (!pAppList->CreateSharedBuffer(iHandle, pcName, iDataType, iDimCnt, piDim, &pBuffer))
+				{
+					throw CLU_EXCEPTION( "Error creating shared buffer");
+				}
+
+				return pBuffer;
+			}
+
+			//////////////////////////////////////////////////////////////////////
+			/// Get memory to write next frame of Shared Buffer to
+			CLUVIZDLL_API void* GetSharedBufferWriteData(void* pvBuffer)
+			{
+				if (!pvBuffer)
+				{
+					throw CLU_EXCEPTION( "Nullptr --> Shared buffer pointer invalid");
+				}
+
+				return ((CSharedBuffer*) pvBuffer)->GetWriteData();
+			}
+
+			//////////////////////////////////////////////////////////////////////
+			/// Publish frame of Shared Buffer
+			CLUVIZDLL_API void PublishSharedBuffer(void* pvBuffer)
+			{
+				if (!pAppList)
+				{
+					throw CLU_EXCEPTION( "Application pointer is invalid");
+				}
+
+				if (!pAppList->PublishSharedBuffer((CSharedBuffer*) pvBuffer))
+				{
+					throw CLU_EXCEPTION( "Error publishing shared buffer");
+				}
+			}
+
+			//////////////////////////////////////////////////////////////////////
+			/// Release pointer to Shared Buffer
+			CLUVIZDLL_API void ReleaseSharedBuffer(void* pvBuffer)
+			{
+				if (pvBuffer)
+				{
+					((CSharedBuffer*) pvBuffer)->Release();
+				}
+			}
+
+			//////////////////////////////////////////////////////////////////////
+			/// Remove Shared Buffer from view
+			CLUVIZDLL_API void RemoveSharedBuffer(int iHandle, const char* pcName)
+			{
+				if (!pAppList)
+				{
+					throw CLU_EXCEPTION( "Application pointer is invalid");
+				}
+
+				if (!pAppList->RemoveSharedBuffer(iHandle, pcName))
+				{
+					throw CLU_EXCEPTION( "Error removing shared buffer");
+				}
+			}
 		} // namespace Wnd
 	} // namespace Viz
 } // namespace Clu
@@ -130,6 +130,28 @@ namespace Clu
 			CLUVIZDLL_API void GetVarColor(int iHandle, const char* pcVarName, double* pdColor4);
 
 			CLUVIZDLL_API void SetVarObject(int iHandle, const char* pcVarName, SStdVbo* pData);
+
+			// Asynchronous variable updates. The values are copied and queued without waiting for the
+			// visualization thread. They are applied before the next script run and of several writes
+			// to the same variable only the last one is applied. Errors are only reported by FlushVarAsync.
+			CLUVIZDLL_API void SetVarNumberAsync(int iHandle, const char* pcVarName, int iVal);
+			CLUVIZDLL_API void SetVarNumberAsync(int iHandle, const char* pcVarName, double dVal);
+			CLUVIZDLL_API void SetVarStringAsync(int iHandle, const char* pcVarName, const char* pcString);
+			CLUVIZDLL_API void SetVarTensorAsync(int iHandle, const char* pcVarName, int iDimCnt, const int* piDim, const double* pdData);
+			CLUVIZDLL_API void SetVarColorAsync(int iHandle, const char* pcVarName, double dRed, double dGreen, double dBlue, double dAlpha);
+
+			// Wait until all asynchronous updates queued so far are applied
+			CLUVIZDLL_API void FlushVarAsync();
+
+			// Shared buffers, which scripts of the view can read as tensor, image or vertex positions without the data
+			// being copied between threads. iDataType is CLUVIZ_IMG_UNSIGNED_BYTE, CLUVIZ_IMG_FLOAT or CLUVIZ_IMG_DOUBLE.
+			// Write a frame to the memory returned by GetSharedBufferWriteData() and pass it on with PublishSharedBuffer().
+			// The write memory changes with every publish. Buffer pointers have to be released with ReleaseSharedBuffer().
+			CLUVIZDLL_API void* CreateSharedBuffer(int iHandle, const char* pcName, int iDataType, int iDimCnt, const int* piDim);
+			CLUVIZDLL_API void* GetSharedBufferWriteData(void* pvBuffer);
+			CLUVIZDLL_API void PublishSharedBuffer(void* pvBuffer);
+			CLUVIZDLL_API void ReleaseSharedBuffer(void* pvBuffer);
+			CLUVIZDLL_API void RemoveSharedBuffer(int iHandle, const char* pcName);
 		} // namespace Wnd
 	} // namesapce Viz
 }	// namespace Clu
@@ -57,6 +57,8 @@ CCLUVizAppListMT::CCLUVizAppListMT(bool bInitAll)
 	m_uTimeout      = INFINITE;
 	m_uEventTimeout = WAIT_FOR_EVENT_TIME;
 
+	m_bVarAsyncFailed = false;
+
 	m_hMutexAccess = 0;
 	m_hMutexRun    = 0;
 	m_hMutexMsg    = 0;
@@ -299,6 +301,9 @@ void CCLUVizAppListMT::Run(void* pData)
 
 	pThis->m_dwThreadID = GetCurrentThreadId();
 
+	pThis->m_bVarAsyncFailed = false;
+	pThis->m_xVarUpdateQueue.Open();
+
 	pThis->m_bIsRunning = true;
 	pThis->m_bDoRun     = true;
 
@@ -354,6 +359,7 @@ void CCLUVizAppListMT::Run(void* pData)
 		if (!pThis->m_bDoRun)
 		{
 			pThis->m_bIsRunning = false;
+			pThis->m_xVarUpdateQueue.Close();
 			SetEvent(pThis->m_hEventMsg);
 			ReleaseMutex(pThis->m_hMutexAccess);
 			SwitchToThread();
@@ -361,6 +367,10 @@ void CCLUVizAppListMT::Run(void* pData)
 			break;
 		}
 
+		// Apply asynchronous variable updates before any message, so that they are set before the next script run
+		pThis->TC_ApplyVarUpdates();
+		pThis->TC_UpdateSharedBuffers();
+
 		if (pThis->m_iMsgID == int(pcMsgID[APP_MSG_CREATE]))
 		{
 			pThis->MsgCreate();
@@ -466,6 +476,7 @@ void CCLUVizAppListMT::Run(void* pData)
 	}
 
 	pThis->m_bIsRunning = false;
+	pThis->m_xVarUpdateQueue.Close();
 
 	#ifdef WIN32
 		CloseHandle(pThis->m_hMutexAccess);
@@ -2288,6 +2299,364 @@ bool CCLUVizAppListMT::DoSetVar(volatile CHandleValData<SVarData< Clu::SStdVbo >
 	return m_bMsgSuccess;
 }
 
+/////////////////////////////////////////////////////////////////////
+/// Set Var Int Asynchronous
+
+bool CCLUVizAppListMT::SetVarAsync(int iHandle, const char* pcVarName, int iVal, std::future<bool>* pfutDone)
+{
+	CCLUVizVarUpdateQueue::SUpdate* pUpdate = new CCLUVizVarUpdateQueue::SUpdate(iHandle, pcVarName, CCLUVizVarUpdateQueue::VAR_INT);
+
+	pUpdate->iVal = iVal;
+
+	return PushVarUpdate(pUpdate, pfutDone);
+}
+
+/////////////////////////////////////////////////////////////////////
+/// Set Var Double Asynchronous
+
+bool CCLUVizAppListMT::SetVarAsync(int iHandle, const char* pcVarName, double dVal, std::future<bool>* pfutDone)
+{
+	CCLUVizVarUpdateQueue::SUpdate* pUpdate = new CCLUVizVarUpdateQueue::SUpdate(iHandle, pcVarName, CCLUVizVarUpdateQueue::VAR_DOUBLE);
+
+	pUpdate->dVal = dVal;
+
+	return PushVarUpdate(pUpdate, pfutDone);
+}
+
+/////////////////////////////////////////////////////////////////////
+/// Set Var String Asynchronous
+
+bool CCLUVizAppListMT::SetVarAsync(int iHandle, const char* pcVarName, const string& sVal, std::future<bool>* pfutDone)
+{
+	CCLUVizVarUpdateQueue::SUpdate* pUpdate = new CCLUVizVarUpdateQueue::SUpdate(iHandle, pcVarName, CCLUVizVarUpdateQueue::VAR_STRING);
+
+	pUpdate->sVal = sVal;
+
+	return PushVarUpdate(pUpdate, pfutDone);
+}
+
+/////////////////////////////////////////////////////////////////////
+/// Set Var Tensor Asynchronous
+
+bool CCLUVizAppListMT::SetVarAsync(int iHandle, const char* pcVarName, int iDimCnt, const int* piDim, const double* pdData, std::future<bool>* pfutDone)
+{
+	if ((iDimCnt <= 0) || !piDim || !pdData)
+	{
+		m_sLastError = "Invalid tensor data.";
+		return false;
+	}
+
+	size_t nElCnt = 1;
+	for (int iDim = 0; iDim < iDimCnt; ++iDim)
+	{
+		if (piDim[iDim] <= 0)
+		{
+			m_sLastError = "Invalid tensor dimension.";
+			return false;
+		}
+
+		nElCnt *= size_t(piDim[iDim]);
+	}
+
+	CCLUVizVarUpdateQueue::SUpdate* pUpdate = new CCLUVizVarUpdateQueue::SUpdate(iHandle, pcVarName, CCLUVizVarUpdateQueue::VAR_TENSOR);
+
+	// The caller may reuse its buffers as soon as this function returns
+	pUpdate->vecDim.assign(piDim, piDim + iDimCnt);
+	pUpdate->vecData.assign(pdData, pdData + nElCnt);
+
+	return PushVarUpdate(pUpdate, pfutDone);
+}
+
+/////////////////////////////////////////////////////////////////////
+/// Set Var Color Asynchronous
+
+bool CCLUVizAppListMT::SetVarAsync(int iHandle, const char* pcVarName, double dRed, double dGreen, double dBlue, double dAlpha, std::future<bool>* pfutDone)
+{
+	CCLUVizVarUpdateQueue::SUpdate* pUpdate = new CCLUVizVarUpdateQueue::SUpdate(iHandle, pcVarName, CCLUVizVarUpdateQueue::VAR_COLOR);
+
+	pUpdate->pdColor[0] = dRed;
+	pUpdate->pdColor[1] = dGreen;
+	pUpdate->pdColor[2] = dBlue;
+	pUpdate->pdColor[3] = dAlpha;
+
+	return PushVarUpdate(pUpdate, pfutDone);
+}
+
+/////////////////////////////////////////////////////////////////////
+/// Wait until all queued asynchronous updates are applied
+
+bool CCLUVizAppListMT::FlushVarAsync()
+{
+	std::future<bool> futDone;
+
+	if (!PushVarUpdate(new CCLUVizVarUpdateQueue::SUpdate(-1, 0, CCLUVizVarUpdateQueue::VAR_NONE), &futDone))
+	{
+		return false;
+	}
+
+	if (m_uTimeout == INFINITE)
+	{
+		futDone.wait();
+	}
+	else if (futDone.wait_for(std::chrono::milliseconds(m_uTimeout)) == std::future_status::timeout)
+	{
+		m_sLastError = "Timeout while waiting for visualization.";
+		return false;
+	}
+
+	if (!futDone.get())
+	{
+		m_sLastError = "Error applying asynchronous variable updates.";
+		return false;
+	}
+
+	return true;
+}
+
+/////////////////////////////////////////////////////////////////////
+/// Queue an asynchronous update
+
+bool CCLUVizAppListMT::PushVarUpdate(CCLUVizVarUpdateQueue::SUpdate* pUpdate, std::future<bool>* pfutDone)
+{
+	if (!m_bIsRunning || m_xVarUpdateQueue.IsClosed())
+	{
+		delete pUpdate;
+		m_sLastError = "CLUViz is not running.";
+		return false;
+	}
+
+	if (pUpdate->eType != CCLUVizVarUpdateQueue::VAR_NONE && pUpdate->sName.empty())
+	{
+		delete pUpdate;
+		m_sLastError = "Invalid pointer to variable name.";
+		return false;
+	}
+
+	if (pfutDone)
+	{
+		pUpdate->vecDone.push_back(std::promise<bool>());
+		*pfutDone = pUpdate->vecDone.back().get_future();
+	}
+
+	// The visualization thread may end while the update is pushed.
+	// The queue then fails the update, so that its future does not wait forever.
+	bool bWake;
+
+	if (!m_xVarUpdateQueue.Push(pUpdate, bWake))
+	{
+		m_sLastError = "CLUViz is not running.";
+		return false;
+	}
+
+	// Only the first update after the queue was drained has to wake up the visualization thread
+	if (bWake)
+	{
+		PostThreadMessage(m_dwThreadID, 0 /*WM_APP_MSG*/, 0, 0);
+	}
+
+	return true;
+}
+
+/////////////////////////////////////////////////////////////////////
+/// Apply queued asynchronous updates. Called from thread context.
+
+void CCLUVizAppListMT::TC_ApplyVarUpdates()
+{
+	if (m_xVarUpdateQueue.IsEmpty())
+	{
+		return;
+	}
+
+	m_xVarUpdateQueue.PopCoalesced(m_vecVarUpdate);
+
+	for (size_t nIdx = 0; nIdx < m_vecVarUpdate.size(); ++nIdx)
+	{
+		CCLUVizVarUpdateQueue::SUpdate* pUpdate = m_vecVarUpdate[nIdx];
+		bool bSuccess;
+
+		if (pUpdate->eType == CCLUVizVarUpdateQueue::VAR_NONE)
+		{
+			// A flush reports whether all updates before it succeeded
+			bSuccess = !m_bVarAsyncFailed;
+			m_bVarAsyncFailed = false;
+		}
+		else if (!(bSuccess = TC_ApplyVarUpdate(pUpdate)))
+		{
+			m_bVarAsyncFailed = true;
+		}
+
+		CCLUVizVarUpdateQueue::Finish(pUpdate, bSuccess);
+	}
+
+	m_vecVarUpdate.clear();
+}
+
+/////////////////////////////////////////////////////////////////////
+/// Apply a single asynchronous update. Called from thread context.
+///
+/// Does not set m_sLastError, since callers of the asynchronous functions
+/// may write it at the same time. Failures are reported through the
+/// futures of the update and by the next flush.
+
+bool CCLUVizAppListMT::TC_ApplyVarUpdate(CCLUVizVarUpdateQueue::SUpdate* pUpdate)
+{
+	TAppMap::iterator itEl;
+
+	if ((itEl = m_mapApp.find(pUpdate->iHandle)) == m_mapApp.end())
+	{
+		// Handle not found
+		return false;
+	}
+
+	CCLUVizApp* pApp   = itEl->second;
+	const char* pcName = pUpdate->sName.c_str();
+	bool bSuccess      = false;
+
+	try
+	{
+		switch (pUpdate->eType)
+		{
+		case CCLUVizVarUpdateQueue::VAR_INT:
+			bSuccess = pApp->SetVar(pcName, pUpdate->iVal);
+			break;
+
+		case CCLUVizVarUpdateQueue::VAR_DOUBLE:
+			bSuccess = pApp->SetVar(pcName, pUpdate->dVal);
+			break;
+
+		case CCLUVizVarUpdateQueue::VAR_STRING:
+			bSuccess = pApp->SetVar(pcName, pUpdate->sVal);
+			break;
+
+		case CCLUVizVarUpdateQueue::VAR_TENSOR:
+			bSuccess = pApp->SetVar(pcName, pUpdate->vecDim, pUpdate->vecData);
+			break;
+
+		case CCLUVizVarUpdateQueue::VAR_COLOR:
+			bSuccess = pApp->SetVar(pcName, pUpdate->pdColor);
+			break;
+
+		default:
+			break;
+		}
+	}
+	catch (...)
+	{
+		bSuccess = false;
+	}
+
+	return bSuccess;
+}
+
+/////////////////////////////////////////////////////////////////////
+/// Create Shared Buffer
+
+bool CCLUVizAppListMT::CreateSharedBuffer(int iHandle, const char* pcName, int iDataType, int iDimCnt, const int* piDim, CSharedBuffer** ppBuffer)
+{
+	if (!m_bIsRunning)
+	{
+		m_sLastError = "CLUViz is not running.";
+		return false;
+	}
+
+	if (!ppBuffer || (iDimCnt <= 0) || !piDim)
+	{
+		m_sLastError = "Invalid shared buffer parameters.";
+		return false;
+	}
+
+	vector<int> vecDim(piDim, piDim + iDimCnt);
+
+	GET_ACCESS
+
+	TAppMap::iterator itEl = m_mapApp.find(iHandle);
+	if (itEl == m_mapApp.end())
+	{
+		m_sLastError = "Invalid handle.";
+		ReleaseMutex(m_hMutexAccess);
+		return false;
+	}
+
+	CCLUVizApp* pApp = itEl->second;
+
+	*ppBuffer = pApp->CreateSharedBuffer(pcName, iDataType, vecDim);
+	if (!*ppBuffer)
+	{
+		m_sLastError = pApp->GetLastError();
+	}
+
+	ReleaseMutex(m_hMutexAccess);
+
+	return *ppBuffer != nullptr;
+}
+
+/////////////////////////////////////////////////////////////////////
+/// Remove Shared Buffer
+
+bool CCLUVizAppListMT::RemoveSharedBuffer(int iHandle, const char* pcName)
+{
+	if (!m_bIsRunning)
+	{
+		m_sLastError = "CLUViz is not running.";
+		return false;
+	}
+
+	GET_ACCESS
+
+	TAppMap::iterator itEl = m_mapApp.find(iHandle);
+	if (itEl == m_mapApp.end())
+	{
+		m_sLastError = "Invalid handle.";
+		ReleaseMutex(m_hMutexAccess);
+		return false;
+	}
+
+	CCLUVizApp* pApp = itEl->second;
+
+	bool bSuccess = pApp->RemoveSharedBuffer(pcName);
+	if (!bSuccess)
+	{
+		m_sLastError = pApp->GetLastError();
+	}
+
+	ReleaseMutex(m_hMutexAccess);
+
+	return bSuccess;
+}
+
+/////////////////////////////////////////////////////////////////////
+/// Publish frame of Shared Buffer
+
+bool CCLUVizAppListMT::PublishSharedBuffer(CSharedBuffer* pBuffer)
+{
+	if (!pBuffer)
+	{
+		m_sLastError = "Invalid pointer to shared buffer.";
+		return false;
+	}
+
+	pBuffer->Publish();
+
+	// Wake up the visualization thread, which redraws the views using the buffer
+	if (m_bIsRunning)
+	{
+		PostThreadMessage(m_dwThreadID, 0 /*WM_APP_MSG*/, 0, 0);
+	}
+
+	return true;
+}
+
+/////////////////////////////////////////////////////////////////////
+/// Redraw views with new shared buffer frames. Called from thread context.
+
+void CCLUVizAppListMT::TC_UpdateSharedBuffers()
+{
+	for (TAppMap::iterator itEl = m_mapApp.begin(); itEl != m_mapApp.end(); ++itEl)
+	{
+		itEl->second->UpdateSharedBuffers();
+	}
+}
+
 /////////////////////////////////////////////////////////////////////
 /// Get Var Int
 
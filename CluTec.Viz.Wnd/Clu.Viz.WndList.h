@@ -1,10 +1,12 @@
 #pragma once
 #include "CluTec.Types1\IDataContainer.h"
 #include "CluTec.Viz.View.Base\CLUVizApp.h"
+#include "CluTec.Viz.Base\VarUpdateQueue.h"
 
 #include <map>
 #include <string>
 #include <queue>
+#include <future>
 
 #define WM_APP_MSG                      WM_USER + 0x0001
 #define APP_MSG_NONE            0x0000
@@ -408,6 +410,37 @@ public:
 	// Set vertex array data
 	bool SetVar(int iHandle, const char* pcVarName, Clu::SStdVbo* pVexArray);
 
+	// Asynchronous variable updates.
+	// The values are copied and queued without waiting for the visualization thread.
+	// Queued updates are applied before the next message is processed, in particular before
+	// the next script execution. Of several writes to the same variable only the last is applied.
+	// If pfutDone is given, it receives a future that becomes true once the value is set,
+	// or false if setting the value failed or the engine ended before.
+	bool SetVarAsync(int iHandle, const char* pcVarName, int iVal, std::future<bool>* pfutDone = nullptr);
+	bool SetVarAsync(int iHandle, const char* pcVarName, double dVal, std::future<bool>* pfutDone = nullptr);
+	bool SetVarAsync(int iHandle, const char* pcVarName, const string& sVal, std::future<bool>* pfutDone = nullptr);
+	bool SetVarAsync(int iHandle, const char* pcVarName, int iDimCnt, const int* piDim, const double* pdData, std::future<bool>* pfutDone = nullptr);
+	bool SetVarAsync(int iHandle, const char* pcVarName, double dRed, double dGreen, double dBlue, double dAlpha, std::future<bool>* pfutDone = nullptr);
+
+	// Wait until all asynchronous updates queued so far are applied.
+	// Returns false if any update applied since the last flush failed.
+	bool FlushVarAsync();
+
+	// Number of asynchronous writes that were replaced by a later write to the same variable
+	unsigned GetVarAsyncCoalescedCount()
+	{ return m_xVarUpdateQueue.GetCoalescedCount(); }
+
+	// Shared buffers of type CSharedBuffer::EDataType, which scripts of the view can read
+	// as tensor, image or vertex positions. The data is not copied between threads.
+	// The returned buffer holds a reference owned by the caller, who has to call Release() on it.
+	// The caller writes a frame to GetWriteData() and passes it on with PublishSharedBuffer().
+	bool CreateSharedBuffer(int iHandle, const char* pcName, int iDataType, int iDimCnt, const int* piDim, CSharedBuffer** ppBuffer);
+	bool RemoveSharedBuffer(int iHandle, const char* pcName);
+
+	// Publish the frame written to the buffer. Never waits for the visualization thread.
+	// Views using the buffer are redrawn. Scripts reading the buffer have to be executed with ExecUser().
+	bool PublishSharedBuffer(CSharedBuffer* pBuffer);
+
 	// Set Timeout in milliseconds
 	void SetTimeout(unsigned int uTimeout)
 	{ m_uTimeout = uTimeout; }
@@ -466,6 +499,16 @@ protected:
 	// DestryAll called from thread context
 	bool TC_DestroyAll();
 
+	// Queue an asynchronous update and wake up the visualization thread if necessary
+	bool PushVarUpdate(CCLUVizVarUpdateQueue::SUpdate* pUpdate, std::future<bool>* pfutDone);
+
+	// Apply queued asynchronous updates, called from thread context
+	void TC_ApplyVarUpdates();
+	bool TC_ApplyVarUpdate(CCLUVizVarUpdateQueue::SUpdate* pUpdate);
+
+	// Redraw views with newly published shared buffers, called from thread context
+	void TC_UpdateSharedBuffers();
+
 protected:
 
 	static void Run(void* pcData);
@@ -501,6 +544,13 @@ protected:
 	HANDLE m_hEventMsg;
 	DWORD m_dwThreadID;
 
+	// Asynchronous variable updates
+	CCLUVizVarUpdateQueue m_xVarUpdateQueue;
+	std::vector<CCLUVizVarUpdateQueue::SUpdate*> m_vecVarUpdate;
+
+	// True if an update failed since the last flush. Only used in thread context.
+	bool m_bVarAsyncFailed;
+
 	CDevice_3DX* m_pDevice3DX;
 
 	unsigned __int64 m_uDNG_This;
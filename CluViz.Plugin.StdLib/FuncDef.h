@@ -44,6 +44,7 @@
 #include "Func_Color.h"
 #include "Func_VisConfig.h"
 #include "Func_Frame.h"
+#include "Func_SharedBuffer.h"
 #include "Func_Shader.h"
 #include "Func_GLTool.h"
 
@@ -160,6 +161,7 @@ SMapExtFunc pFuncList[] =
 
 	{ "SetSphereDetailLevel", SetSphereDetailLevelFunc },
 	{ "SetCylinderDetailLevel", SetCylinderDetailLevelFunc },
+	{ "EnableInstanceBatching", EnableInstanceBatchingFunc },
 	{ "SetArrowShape", SetArrowShapeFunc },
 
 	{ "SetMode", SetModeFunc },
@@ -177,6 +179,8 @@ SMapExtFunc pFuncList[] =
 	{ "SetColorStereoPars", SetColorStereoParsFunc },
 
 	{ "EnableTransparency", EnableTransparencyFunc },
+	{ "EnablePickBVH", EnablePickBVHFunc },
+	{ "EnableFrustumCulling", EnableFrustumCullingFunc },
 
 	{ "EnablePointSprites", EnablePointSpritesFunc },
 
@@ -279,6 +283,10 @@ SMapExtFunc pFuncList[] =
 	{ "EnableSceneAutoAdaptFrontFace", EnableSceneAutoAdaptFrontFaceFunc },
 	{ "EnableScenePick", EnableScenePickFunc },
 	{ "EnableScenePickTarget", EnableScenePickTargetFunc },
+	{ "EnableScenePickBVH", EnableScenePickBVHFunc },
+	{ "EnableSceneBuffer", EnableSceneBufferFunc },
+	{ "PickRay", PickRayFunc },
+	{ "GetBoundingBox", GetBoundingBoxFunc },
 	{ "EnableSceneNotify", EnableSceneNotifyFunc },
 	{ "EnableSceneDrawModes", EnableSceneDrawModesFunc },
 	{ "EnableSceneAutoAdjustFrame", EnableSceneAutoAdjustFrameFunc },
@@ -424,6 +432,7 @@ SMapExtFunc pFuncList[] =
 	{ "ConvertImageType", ConvertBMPTypeFunc },
 
 	{ "SampleImgArea", SampleImgAreaFunc },
+	{ "_SetImageKernel", SetImageKernelFunc },
 
 	////////////////////////////////////////////////////////////
 	/// Info Functions
@@ -468,6 +477,7 @@ SMapExtFunc pFuncList[] =
 	{ "ReadData", ReadDataFunc },
 	{ "WriteData", WriteDataFunc },
 	{ "ReadMatrix", ReadMatrixFunc },
+	{ "ReadNumData", ReadNumDataFunc },
 	{ "ShowFile", ShowFileFunc },
 	{ "FileChooser", FileChooserFunc },
 	{ "SaveScreen", SaveScreenFunc },
@@ -537,6 +547,14 @@ SMapExtFunc pFuncList[] =
 
 	{ "EnableEvent", EnableEventFunc },
 
+	////////////////////////////////////////////////////////////
+	/// Script Execution
+
+	{ "EnableBytecode", EnableBytecodeFunc },
+	{ "_GetTempVarStats", GetTempVarStatsFunc },
+	{ "EnableIncrementalExec", EnableIncrementalExecFunc },
+	{ "_GetIncrementalExecStats", GetIncrementalExecStatsFunc },
+
 	////////////////////////////////////////////////////////////
 	/// Presentation Functions
 
@@ -623,6 +641,21 @@ SMapExtFunc pFuncList[] =
 
 	{ "_GetBaseElementRepositoryContentList", GetBaseElementRepositoryContentListFunc },
 	{ "_GetImageRepositoryContentList", GetImageRepositoryContentListFunc },
+	{ "_EnableRepositoryRefTracking", EnableRepositoryRefTrackingFunc },
+	{ "_GetInstanceBatchStats", GetInstanceBatchStatsFunc },
+	{ "_EnableMVInfoCache", EnableMVInfoCacheFunc },
+	{ "_GetMVInfoCacheStats", GetMVInfoCacheStatsFunc },
+	{ "_SetListChunkSize", SetListChunkSizeFunc },
+	{ "_GetListAllocStats", GetListAllocStatsFunc },
+	{ "_EnableProdPlan", EnableProdPlanFunc },
+	{ "_SetIncludeCachePath", SetIncludeCachePathFunc },
+	{ "_GetIncludeCacheStats", GetIncludeCacheStatsFunc },
+	{ "_GetMatrixStackStats", GetMatrixStackStatsFunc },
+	{ "_GetCullStats", GetCullStatsFunc },
+	{ "_GetRenderQueue", GetRenderQueueFunc },
+	{ "_GetRenderQueueStats", GetRenderQueueStatsFunc },
+	{ "_TestVarUpdateQueue", TestVarUpdateQueueFunc },
+	{ "_GetObjectUploadSize", GetVexListUploadSizeFunc },
 
 	///////////////////////////////////////////////////////
 	/// Unit Conversion functions
@@ -740,6 +773,7 @@ SMapExtFunc pFuncList[] =
 	{ "acp", ACPFunc },
 
 	{ "FactorizeBlade", FactorBladeFunc },
+	{ "ApplyVersor", ApplyVersorFunc },
 
 	{ "GradeList", GradeListFunc },
 	{ "BladeIdxList", GetMVIndicesFunc },
@@ -769,6 +803,7 @@ SMapExtFunc pFuncList[] =
 	{ "Eigen", EigenFunc },
 	{ "SVD", SVDFunc },
 	{ "det", DetFunc },
+	{ "_SetMatrixKernel", SetMatrixKernelFunc },
 
 	{ "Diag2Row", DiagToVectorFunc },
 	{ "Row2Diag", VectorToDiagFunc },
@@ -790,6 +825,13 @@ SMapExtFunc pFuncList[] =
 	{ "Tensor2MV", GetTensorMVFunc },
 	{ "GAOpTensor", GetGAOpTensorFunc },
 
+	////////////////////////////////////////////////////////////
+	/// Shared Buffer Functions
+	{ "GetSharedTensor", GetSharedTensorFunc },
+	{ "GetSharedImage", GetSharedImageFunc },
+	{ "GetSharedBufferFrame", GetSharedBufferFrameFunc },
+	{ "_PublishSharedBuffer", PublishSharedBufferFunc },
+
 	////////////////////////////////////////////////////////////
 	/// Error Propagation
 
@@ -822,6 +864,15 @@ SMapExtFunc pFuncList[] =
 	{ "SetObjectStructure", SetVexListPolyModeFunc },
 	{ "Scene:Object:Structure", SetVexListPolyModeFunc },
 
+	{ "SetObjectStorage", SetVexListStorageFunc },
+	{ "Scene:Object:Storage", SetVexListStorageFunc },
+
+	{ "SetObjectAttribute", SetVexListAttributeFunc },
+	{ "Scene:Object:Attribute", SetVexListAttributeFunc },
+
+	{ "SetObjectSharedBuffer", SetVexListSharedBufferFunc },
+	{ "Scene:Object:SharedBuffer", SetVexListSharedBufferFunc },
+
 	{ "SetObjectScale", SetVexListScaleFunc },
 	{ "Scene:Object:Scale", SetVexListScaleFunc },
 
@@ -27,8 +27,16 @@
 #include "stdafx.h"
 #include "Func_Debug.h"
 
+#include "CluTec.Viz.Base\VarUpdateQueue.h"
+
+#include <thread>
+
 //////////////////////////////////////////////////////////////////////
 // Get Content List of Base Element Repository
+//
+// Return:
+//	list with an entry [uid, type, name, reference list, reference count] per element.
+//	The reference list only contains references created while reference tracking was enabled.
 
 bool  GetBaseElementRepositoryContentListFunc(CCLUCodeBase& rCB, CCodeVar& rVar, CCodeVar& rPars, int iLine, int iPos)
 {
@@ -42,17 +50,19 @@ bool  GetBaseElementRepositoryContentListFunc(CCLUCodeBase& rCB, CCodeVar& rVar,
 	}
 
 	COGLBERepository* pRep = rCB.GetOGLDrawBase()->GetSceneRepository();
+	pRep->Lock();
 
+	const COGLBERepository::TObjectSet* psetObject     = pRep->GetObjectSet();
 	const COGLBERepository::TObjToRefMap* pmapObjToRef = pRep->GetObjToRefMap();
 
-	COGLBERepository::TObjToRefMap::const_iterator itEl;
+	COGLBERepository::TObjectSet::const_iterator itEl;
 
 	char pcPtr[32];
 	rVar.New(PDT_VARLIST);
 	TVarList& rList = *rVar.GetVarListPtr();
 
-	for (itEl = pmapObjToRef->begin();
-	     itEl != pmapObjToRef->end();
+	for (itEl = psetObject->begin();
+	     itEl != psetObject->end();
 	     ++itEl)
 	{
 		rList.Add(1);
@@ -60,8 +70,8 @@ bool  GetBaseElementRepositoryContentListFunc(CCLUCodeBase& rCB, CCodeVar& rVar,
 		rObjVar.New(PDT_VARLIST);
 		TVarList& rObjList = *rObjVar.GetVarListPtr();
 
-		const COGLBaseElement* pEl = itEl->first;
-		rObjList.Add(4);
+		COGLBaseElement* pEl = *itEl;
+		rObjList.Add(5);
 		rObjList(0) = pEl->GetUID();
 		rObjList(1) = pEl->GetTypeName().c_str();
 		rObjList(2) = pEl->GetName().c_str();
@@ -69,27 +79,38 @@ bool  GetBaseElementRepositoryContentListFunc(CCLUCodeBase& rCB, CCodeVar& rVar,
 		rObjList(3).New(PDT_VARLIST);
 		TVarList& rRefList = *rObjList(3).GetVarListPtr();
 
-		const COGLBERepository::TObjRefList& listRef = itEl->second;
-		rRefList.Add(listRef.size());
+		COGLBERepository::TObjToRefMap::const_iterator itRefs = pmapObjToRef->find(pEl);
+		if (itRefs != pmapObjToRef->end())
+		{
+			const COGLBERepository::TObjRefList& listRef = itRefs->second;
+			rRefList.Add(listRef.size());
 
-		COGLBERepository::TObjRefList::const_iterator itRef;
+			COGLBERepository::TObjRefList::const_iterator itRef;
 
-		int i = 0;
-		for (itRef = listRef.begin();
-		     itRef != listRef.end();
-		     ++itRef)
-		{
-			sprintf_s(pcPtr, 32, "%p", (*itRef));
-			rRefList(i) = pcPtr;
-			++i;
+			int i = 0;
+			for (itRef = listRef.begin();
+			     itRef != listRef.end();
+			     ++itRef)
+			{
+				sprintf_s(pcPtr, 32, "%p", (*itRef));
+				rRefList(i) = pcPtr;
+				++i;
+			}
 		}
+
+		rObjList(4) = int(COGLBERepository::GetRefCount(pEl));
 	}
 
+	pRep->Unlock();
 	return true;
 }
 
 //////////////////////////////////////////////////////////////////////
 // Get Content List of Image Repository
+//
+// Return:
+//	list with an entry [filename, width, height, reference list, reference count] per image.
+//	The reference list only contains references created while reference tracking was enabled.
 
 bool  GetImageRepositoryContentListFunc(CCLUCodeBase& rCB, CCodeVar& rVar, CCodeVar& rPars, int iLine, int iPos)
 {
@@ -105,9 +126,10 @@ bool  GetImageRepositoryContentListFunc(CCLUCodeBase& rCB, CCodeVar& rVar, CCode
 	CImageRepository& rImgRep = *((CImageRepository*)::GetImageRepositoryPtr());
 	rImgRep.Lock();
 
+	const CImageRepository::TImageSet* psetImage       = rImgRep.GetImageSet();
 	const CImageRepository::TImgToRefMap* pmapImgToRef = rImgRep.GetImgToRefMap();
 
-	CImageRepository::TImgToRefMap::const_iterator itEl;
+	CImageRepository::TImageSet::const_iterator itEl;
 
 	char pcPtr[32];
 	CStrMem csVal;
@@ -115,8 +137,8 @@ bool  GetImageRepositoryContentListFunc(CCLUCodeBase& rCB, CCodeVar& rVar, CCode
 	rVar.New(PDT_VARLIST);
 	TVarList& rList = *rVar.GetVarListPtr();
 
-	for (itEl = pmapImgToRef->begin();
-	     itEl != pmapImgToRef->end();
+	for (itEl = psetImage->begin();
+	     itEl != psetImage->end();
 	     ++itEl)
 	{
 		rList.Add(1);
@@ -124,8 +146,8 @@ bool  GetImageRepositoryContentListFunc(CCLUCodeBase& rCB, CCodeVar& rVar, CCode
 		rObjVar.New(PDT_VARLIST);
 		TVarList& rObjList = *rObjVar.GetVarListPtr();
 
-		const COGLImage* pEl = itEl->first;
-		rObjList.Add(4);
+		COGLImage* pEl = *itEl;
+		rObjList.Add(5);
 		pEl->GetFilename(csVal);
 		pEl->GetSize(iWidth, iHeight);
 		rObjList(0) = csVal;
@@ -135,22 +157,695 @@ bool  GetImageRepositoryContentListFunc(CCLUCodeBase& rCB, CCodeVar& rVar, CCode
 		rObjList(3).New(PDT_VARLIST);
 		TVarList& rRefList = *rObjList(3).GetVarListPtr();
 
-		const CImageRepository::TImgRefList& listRef = itEl->second;
-		rRefList.Add(listRef.size());
+		CImageRepository::TImgToRefMap::const_iterator itRefs = pmapImgToRef->find(pEl);
+		if (itRefs != pmapImgToRef->end())
+		{
+			const CImageRepository::TImgRefList& listRef = itRefs->second;
+			rRefList.Add(listRef.size());
 
-		CImageRepository::TImgRefList::const_iterator itRef;
+			CImageRepository::TImgRefList::const_iterator itRef;
 
-		int i = 0;
-		for (itRef = listRef.begin();
-		     itRef != listRef.end();
-		     ++itRef)
-		{
-			sprintf_s(pcPtr, 32, "%p", (*itRef));
-			rRefList(i) = pcPtr;
-			++i;
+			int i = 0;
+			for (itRef = listRef.begin();
+			     itRef != listRef.end();
+			     ++itRef)
+			{
+				sprintf_s(pcPtr, 32, "%p", (*itRef));
+				rRefList(i) = pcPtr;
+				++i;
+			}
 		}
+
+		rObjList(4) = int(CImageRepository::GetRefCount(pEl));
 	}
 
 	rImgRep.Unlock();
 	return true;
 }
+
+//////////////////////////////////////////////////////////////////////
+// Enable listing of references in the base element and image repositories
+//
+// Pars:
+// 1. (bool) true to enable
+
+bool  EnableRepositoryRefTrackingFunc(CCLUCodeBase& rCB, CCodeVar& rVar, CCodeVar& rPars, int iLine, int iPos)
+{
+	TVarList& mVars = *rPars.GetVarListPtr();
+	int iVarCount   = int(mVars.Count());
+	int iEnable;
+
+	if (iVarCount != 1)
+	{
+		int piPar[] = { 1 };
+
+		rCB.GetErrorList().WrongNoOfParams(piPar, 1, iLine, iPos);
+		return false;
+	}
+
+	if (!mVars(0).CastToCounter(iEnable))
+	{
+		rCB.GetErrorList().InvalidParType(mVars(0), 1, iLine, iPos);
+		return false;
+	}
+
+	rCB.GetOGLDrawBase()->GetSceneRepository()->EnableRefTracking(iEnable != 0);
+	((CImageRepository*)::GetImageRepositoryPtr())->EnableRefTracking(iEnable != 0);
+
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Get the number of instance batches and instances created when drawing
+//
+// Pars:
+// 1. (optional, bool) true to reset the counters after reading them
+//
+// Return:
+//	[batch count, instance count]
+
+bool  GetInstanceBatchStatsFunc(CCLUCodeBase& rCB, CCodeVar& rVar, CCodeVar& rPars, int iLine, int iPos)
+{
+	TVarList& mVars = *rPars.GetVarListPtr();
+	int iVarCount   = int(mVars.Count());
+	int iReset      = 0;
+
+	if (iVarCount > 1)
+	{
+		int piPar[] = { 0, 1 };
+
+		rCB.GetErrorList().WrongNoOfParams(piPar, 2, iLine, iPos);
+		return false;
+	}
+
+	if ((iVarCount == 1) && !mVars(0).CastToCounter(iReset))
+	{
+		rCB.GetErrorList().InvalidParType(mVars(0), 1, iLine, iPos);
+		return false;
+	}
+
+	COGLDrawBase& rDrawBase = *rCB.GetOGLDrawBase();
+	unsigned uBatchCnt, uInstanceCnt;
+
+	rDrawBase.GetInstanceBatchStats(uBatchCnt, uInstanceCnt);
+
+	if (iReset)
+	{
+		rDrawBase.ResetInstanceBatchStats();
+	}
+
+	rVar.New(PDT_VARLIST);
+	TVarList& rList = *rVar.GetVarListPtr();
+	rList.Add(2);
+	rList(0) = TCVCounter(uBatchCnt);
+	rList(1) = TCVCounter(uInstanceCnt);
+
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Enable the cache of multivector analyses used when drawing multivectors
+//
+// Pars:
+// 1. (bool) true to enable
+
+bool  EnableMVInfoCacheFunc(CCLUCodeBase& rCB, CCodeVar& rVar, CCodeVar& rPars, int iLine, int iPos)
+{
+	TVarList& mVars = *rPars.GetVarListPtr();
+	int iVarCount   = int(mVars.Count());
+	int iEnable;
+
+	if (iVarCount != 1)
+	{
+		int piPar[] = { 1 };
+
+		rCB.GetErrorList().WrongNoOfParams(piPar, 1, iLine, iPos);
+		return false;
+	}
+
+	if (!mVars(0).CastToCounter(iEnable))
+	{
+		rCB.GetErrorList().InvalidParType(mVars(0), 1, iLine, iPos);
+		return false;
+	}
+
+	rCB.GetFilter()->EnableMVInfoCache(iEnable != 0);
+
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Enable the sparse product plans of multivector products.
+// If disabled, products use the dense product tables.
+//
+// Pars:
+// 1. (bool) true to enable
+
+bool  EnableProdPlanFunc(CCLUCodeBase& rCB, CCodeVar& rVar, CCodeVar& rPars, int iLine, int iPos)
+{
+	TVarList& mVars = *rPars.GetVarListPtr();
+	int iVarCount   = int(mVars.Count());
+	int iEnable;
+
+	if (iVarCount != 1)
+	{
+		int piPar[] = { 1 };
+
+		rCB.GetErrorList().WrongNoOfParams(piPar, 1, iLine, iPos);
+		return false;
+	}
+
+	if (!mVars(0).CastToCounter(iEnable))
+	{
+		rCB.GetErrorList().InvalidParType(mVars(0), 1, iLine, iPos);
+		return false;
+	}
+
+	// Set the flag of this module, of the module of the code base and of the GA library,
+	// which instantiates the products.
+	EnableProdPlan(iEnable != 0);
+	rCB.EnableProdPlan(iEnable != 0);
+	EnableCLUGAProdPlan(iEnable != 0);
+
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Get the number of hits and misses of the cache of multivector analyses
+//
+// Pars:
+// 1. (optional, bool) true to reset the counters after reading them
+//
+// Return:
+//	[hit count, miss count]
+
+bool  GetMVInfoCacheStatsFunc(CCLUCodeBase& rCB, CCodeVar& rVar, CCodeVar& rPars, int iLine, int iPos)
+{
+	TVarList& mVars = *rPars.GetVarListPtr();
+	int iVarCount   = int(mVars.Count());
+	int iReset      = 0;
+
+	if (iVarCount > 1)
+	{
+		int piPar[] = { 0, 1 };
+
+		rCB.GetErrorList().WrongNoOfParams(piPar, 2, iLine, iPos);
+		return false;
+	}
+
+	if ((iVarCount == 1) && !mVars(0).CastToCounter(iReset))
+	{
+		rCB.GetErrorList().InvalidParType(mVars(0), 1, iLine, iPos);
+		return false;
+	}
+
+	COGLMVFilter& rFilter = *rCB.GetFilter();
+	unsigned uHitCnt, uMissCnt;
+
+	rFilter.GetMVInfoCacheStats(uHitCnt, uMissCnt);
+
+	if (iReset)
+	{
+		rFilter.ResetMVInfoCacheStats();
+	}
+
+	rVar.New(PDT_VARLIST);
+	TVarList& rList = *rVar.GetVarListPtr();
+	rList.Add(2);
+	rList(0) = TCVCounter(uHitCnt);
+	rList(1) = TCVCounter(uMissCnt);
+
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Set the minimal number of elements per chunk of variable lists,
+// whose elements are constructed in place. Zero disables chunks.
+//
+// Pars:
+// 1. (counter) number of elements
+
+bool  SetListChunkSizeFunc(CCLUCodeBase& rCB, CCodeVar& rVar, CCodeVar& rPars, int iLine, int iPos)
+{
+	TVarList& mVars = *rPars.GetVarListPtr();
+	int iVarCount   = int(mVars.Count());
+	int iElNo;
+
+	if (iVarCount != 1)
+	{
+		int piPar[] = { 1 };
+
+		rCB.GetErrorList().WrongNoOfParams(piPar, 1, iLine, iPos);
+		return false;
+	}
+
+	if (!mVars(0).CastToCounter(iElNo) || (iElNo < 0))
+	{
+		rCB.GetErrorList().InvalidParType(mVars(0), 1, iLine, iPos);
+		return false;
+	}
+
+	// Set the size for this module and for the module of the code base
+	CVarList::SetChunkElementCount(size_t(iElNo));
+	rCB.SetVarListChunkSize(size_t(iElNo));
+
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Get the number of variable list elements allocated separately on
+// the heap and the number of chunks allocated for list elements
+//
+// Pars:
+// 1. (optional, bool) true to reset the counters after reading them
+//
+// Return:
+//	[element count, chunk count]
+
+bool  GetListAllocStatsFunc(CCLUCodeBase& rCB, CCodeVar& rVar, CCodeVar& rPars, int iLine, int iPos)
+{
+	TVarList& mVars = *rPars.GetVarListPtr();
+	int iVarCount   = int(mVars.Count());
+	int iReset      = 0;
+
+	if (iVarCount > 1)
+	{
+		int piPar[] = { 0, 1 };
+
+		rCB.GetErrorList().WrongNoOfParams(piPar, 2, iLine, iPos);
+		return false;
+	}
+
+	if ((iVarCount == 1) && !mVars(0).CastToCounter(iReset))
+	{
+		rCB.GetErrorList().InvalidParType(mVars(0), 1, iLine, iPos);
+		return false;
+	}
+
+	size_t uHeapElCnt, uChunkCnt;
+
+	rCB.GetVarListAllocStats(uHeapElCnt, uChunkCnt, iReset != 0);
+
+	rVar.New(PDT_VARLIST);
+	TVarList& rList = *rVar.GetVarListPtr();
+	rList.Add(2);
+	rList(0) = TCVCounter(uHeapElCnt);
+	rList(1) = TCVCounter(uChunkCnt);
+
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Set the folder the cache of preparsed include files is stored in.
+// The cache is used when the next script is parsed. Relative paths refer to the
+// script path, the folder has to exist and an empty path keeps the cache in memory only.
+//
+// Pars:
+// 1. (string) path of the cache folder
+
+bool  SetIncludeCachePathFunc(CCLUCodeBase& rCB, CCodeVar& rVar, CCodeVar& rPars, int iLine, int iPos)
+{
+	TVarList& mVars = *rPars.GetVarListPtr();
+	int iVarCount   = int(mVars.Count());
+
+	if (iVarCount != 1)
+	{
+		int piPar[] = { 1 };
+
+		rCB.GetErrorList().WrongNoOfParams(piPar, 1, iLine, iPos);
+		return false;
+	}
+
+	if (mVars(0).BaseType() != PDT_STRING)
+	{
+		rCB.GetErrorList().InvalidParType(mVars(0), 1, iLine, iPos);
+		return false;
+	}
+
+	std::string sPath = mVars(0).GetStringPtr()->Str();
+
+	if (!sPath.empty() && (sPath.find_first_of(":") == std::string::npos) && (sPath[0] != '\\') && (sPath[0] != '/'))
+	{
+		sPath = rCB.GetScriptPath() + sPath;
+	}
+
+	if (!rCB.SetIncludeCachePath(sPath.c_str()))
+	{
+		rCB.GetErrorList().GeneralError("Include cache is not available.", iLine, iPos);
+		return false;
+	}
+
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Get the number of hits and misses of the cache of preparsed include files,
+// and the number of entries read from and written to the cache folder,
+// while the current script was parsed
+//
+// Return:
+//	[hit count, miss count, load count, save count]
+
+bool  GetIncludeCacheStatsFunc(CCLUCodeBase& rCB, CCodeVar& rVar, CCodeVar& rPars, int iLine, int iPos)
+{
+	TVarList& mVars = *rPars.GetVarListPtr();
+	int iVarCount   = int(mVars.Count());
+
+	if (iVarCount != 0)
+	{
+		int piPar[] = { 0 };
+
+		rCB.GetErrorList().WrongNoOfParams(piPar, 1, iLine, iPos);
+		return false;
+	}
+
+	unsigned uHitCnt, uMissCnt, uLoadCnt, uSaveCnt;
+
+	if (!rCB.GetIncludeCacheStats(uHitCnt, uMissCnt, uLoadCnt, uSaveCnt))
+	{
+		rCB.GetErrorList().GeneralError("Include cache is not available.", iLine, iPos);
+		return false;
+	}
+
+	rVar.New(PDT_VARLIST);
+	TVarList& rList = *rVar.GetVarListPtr();
+	rList.Add(4);
+	rList(0) = TCVCounter(uHitCnt);
+	rList(1) = TCVCounter(uMissCnt);
+	rList(2) = TCVCounter(uLoadCnt);
+	rList(3) = TCVCounter(uSaveCnt);
+
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Get the number of matrices read from and written to OpenGL, the number
+// of matrices pushed and the number of queries of the active texture unit,
+// while drawing the previous frame
+//
+// Return:
+//	[read count, write count, push count, texture unit query count]
+
+bool  GetMatrixStackStatsFunc(CCLUCodeBase& rCB, CCodeVar& rVar, CCodeVar& rPars, int iLine, int iPos)
+{
+	TVarList& mVars = *rPars.GetVarListPtr();
+	int iVarCount   = int(mVars.Count());
+
+	if (iVarCount != 0)
+	{
+		int piPar[] = { 0 };
+
+		rCB.GetErrorList().WrongNoOfParams(piPar, 1, iLine, iPos);
+		return false;
+	}
+
+	const Clu::CMatrixStack::SStats& rStats = rCB.GetCLUDrawBase()->GetMatrixStackStats();
+
+	rVar.New(PDT_VARLIST);
+	TVarList& rList = *rVar.GetVarListPtr();
+	rList.Add(4);
+	rList(0) = TCVCounter(rStats.uReadCnt);
+	rList(1) = TCVCounter(rStats.uWriteCnt);
+	rList(2) = TCVCounter(rStats.uPushCnt);
+	rList(3) = TCVCounter(rStats.uTexUnitQueryCnt);
+
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Get the number of scene elements tested against the view frustum,
+// the number of objects culled and the number of objects drawn in the previous frame
+//
+// Return:
+//	[test count, cull count, draw count]
+
+bool  GetCullStatsFunc(CCLUCodeBase& rCB, CCodeVar& rVar, CCodeVar& rPars, int iLine, int iPos)
+{
+	TVarList& mVars = *rPars.GetVarListPtr();
+	int iVarCount   = int(mVars.Count());
+
+	if (iVarCount != 0)
+	{
+		int piPar[] = { 0 };
+
+		rCB.GetErrorList().WrongNoOfParams(piPar, 1, iLine, iPos);
+		return false;
+	}
+
+	const COGLBaseElement::SCullStats& rStats = rCB.GetCLUDrawBase()->GetCullStats();
+
+	rVar.New(PDT_VARLIST);
+	TVarList& rList = *rVar.GetVarListPtr();
+	rList.Add(3);
+	rList(0) = TCVCounter(rStats.uTestCnt);
+	rList(1) = TCVCounter(rStats.uCullCnt);
+	rList(2) = TCVCounter(rStats.uDrawCnt);
+
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Get the scene of the first parameter of a render queue function
+
+static COGLScene* GetRenderQueueScene(CCLUCodeBase& rCB, CCodeVar& rPars, int iLine, int iPos)
+{
+	TVarList& mVars = *rPars.GetVarListPtr();
+	int iVarCount   = int(mVars.Count());
+
+	if (iVarCount != 1)
+	{
+		int piPar[] = { 1 };
+
+		rCB.GetErrorList().WrongNoOfParams(piPar, 1, iLine, iPos);
+		return nullptr;
+	}
+
+	if (mVars(0).BaseType() != PDT_SCENE)
+	{
+		rCB.GetErrorList().GeneralError("Expect a scene variable as parameter.", iLine, iPos);
+		return nullptr;
+	}
+
+	COGLBEReference Scene = *mVars(0).GetScenePtr();
+	COGLScene* pScene     = (Scene.IsValid() ? dynamic_cast< COGLScene* >((COGLBaseElement*) Scene) : nullptr);
+
+	if (!pScene)
+	{
+		rCB.GetErrorList().GeneralError("Scene is not valid.", iLine, iPos);
+		return nullptr;
+	}
+
+	return pScene;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Get the commands a render queue of the scene executes, without drawing.
+// The frame is assumed to be the identity and all objects to be visible.
+//
+// Return:
+//	list of strings "state <type> <name>", "draw <type> <name>" and "apply <type> <name>"
+
+bool  GetRenderQueueFunc(CCLUCodeBase& rCB, CCodeVar& rVar, CCodeVar& rPars, int iLine, int iPos)
+{
+	COGLScene* pScene = GetRenderQueueScene(rCB, rPars, iLine, iPos);
+	if (!pScene)
+	{
+		return false;
+	}
+
+	COGLRenderQueue xQueue;
+	std::vector<std::string> vecCmd;
+
+	xQueue.Build(*pScene);
+	xQueue.Record(vecCmd);
+
+	rVar.New(PDT_VARLIST);
+	TVarList& rList = *rVar.GetVarListPtr();
+	rList.Add(int(vecCmd.size()));
+
+	for (size_t nIdx = 0; nIdx < vecCmd.size(); ++nIdx)
+	{
+		rList(int(nIdx)) = vecCmd[nIdx].c_str();
+	}
+
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Get the statistics of the render queue of a scene with enabled scene buffer
+//
+// Return:
+//	[build count, draw item count, segment count, state changes of the previous frame]
+
+bool  GetRenderQueueStatsFunc(CCLUCodeBase& rCB, CCodeVar& rVar, CCodeVar& rPars, int iLine, int iPos)
+{
+	COGLScene* pScene = GetRenderQueueScene(rCB, rPars, iLine, iPos);
+	if (!pScene)
+	{
+		return false;
+	}
+
+	COGLRenderQueue* pQueue = pScene->GetRenderQueue();
+	if (!pQueue)
+	{
+		rCB.GetErrorList().GeneralError("Scene buffer is not enabled for scene. Use EnableSceneBuffer().", iLine, iPos);
+		return false;
+	}
+
+	const COGLRenderQueue::SStats& rStats = pQueue->GetStats();
+
+	rVar.New(PDT_VARLIST);
+	TVarList& rList = *rVar.GetVarListPtr();
+	rList.Add(4);
+	rList(0) = TCVCounter(rStats.uBuildCnt);
+	rList(1) = TCVCounter(rStats.uDrawItemCnt);
+	rList(2) = TCVCounter(rStats.uSegmentCnt);
+	rList(3) = TCVCounter(rStats.uStateChangeCnt);
+
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Test the queue of asynchronous variable updates of the visualization
+// engine. Producer threads push updates with futures, while this thread
+// applies updates and closes the queue before all updates are pushed,
+// as the visualization thread does when it ends.
+//
+// Parameters:
+//	1. number of producer threads
+//	2. number of updates per producer thread
+//
+// Return:
+//	[pushed count, rejected count, succeeded count, failed count, unresolved count]
+
+bool  TestVarUpdateQueueFunc(CCLUCodeBase& rCB, CCodeVar& rVar, CCodeVar& rPars, int iLine, int iPos)
+{
+	TVarList& mVars = *rPars.GetVarListPtr();
+	int iVarCount   = int(mVars.Count());
+
+	if (iVarCount != 2)
+	{
+		int piPar[] = { 2 };
+
+		rCB.GetErrorList().WrongNoOfParams(piPar, 1, iLine, iPos);
+		return false;
+	}
+
+	TCVCounter iProducerCnt, iUpdateCnt;
+
+	if (!mVars(0).CastToCounter(iProducerCnt) || (iProducerCnt <= 0))
+	{
+		rCB.GetErrorList().InvalidParType(mVars(0), 1, iLine, iPos);
+		return false;
+	}
+
+	if (!mVars(1).CastToCounter(iUpdateCnt) || (iUpdateCnt <= 0))
+	{
+		rCB.GetErrorList().InvalidParType(mVars(1), 2, iLine, iPos);
+		return false;
+	}
+
+	CCLUVizVarUpdateQueue xQueue;
+	std::vector<std::vector<std::future<bool> > > vecFuture(iProducerCnt);
+	std::vector<std::thread> vecThread;
+	std::atomic<int> iPushedCnt(0), iRejectedCnt(0);
+
+	xQueue.Open();
+
+	try
+	{
+		for (int iProducer = 0; iProducer < iProducerCnt; ++iProducer)
+		{
+			vecThread.push_back(std::thread([&, iProducer]()
+			{
+				std::vector<std::future<bool> >& rvecFuture = vecFuture[iProducer];
+
+				for (int iIdx = 0; iIdx < iUpdateCnt; ++iIdx)
+				{
+					// Alternate between two variables, so that updates are also coalesced
+					CCLUVizVarUpdateQueue::SUpdate* pUpdate
+						= new CCLUVizVarUpdateQueue::SUpdate(iProducer, (iIdx % 2 ? "a" : "b"), CCLUVizVarUpdateQueue::VAR_INT);
+
+					pUpdate->iVal = iIdx;
+					pUpdate->vecDone.push_back(std::promise<bool>());
+					rvecFuture.push_back(pUpdate->vecDone.back().get_future());
+
+					bool bWake;
+					if (xQueue.Push(pUpdate, bWake))
+					{
+						++iPushedCnt;
+					}
+					else
+					{
+						++iRejectedCnt;
+					}
+				}
+			}));
+		}
+	}
+	catch (std::exception&)
+	{
+		xQueue.Close();
+		for (std::thread& xThread : vecThread)
+		{
+			xThread.join();
+		}
+
+		rCB.GetErrorList().GeneralError("Cannot start producer threads.", iLine, iPos);
+		return false;
+	}
+
+	// Apply updates until half of them are pushed and then end while the producers are still pushing
+	int iHalfCnt = iProducerCnt * iUpdateCnt / 2;
+	std::vector<CCLUVizVarUpdateQueue::SUpdate*> vecUpdate;
+
+	while (iPushedCnt.load() < iHalfCnt)
+	{
+		xQueue.PopCoalesced(vecUpdate);
+		for (CCLUVizVarUpdateQueue::SUpdate* pUpdate : vecUpdate)
+		{
+			CCLUVizVarUpdateQueue::Finish(pUpdate, true);
+		}
+
+		std::this_thread::yield();
+	}
+
+	xQueue.Close();
+
+	for (std::thread& xThread : vecThread)
+	{
+		xThread.join();
+	}
+
+	int iSucceededCnt = 0, iFailedCnt = 0, iUnresolvedCnt = 0;
+
+	for (std::vector<std::future<bool> >& rvecFuture : vecFuture)
+	{
+		for (std::future<bool>& futDone : rvecFuture)
+		{
+			if (futDone.wait_for(std::chrono::milliseconds(0)) != std::future_status::ready)
+			{
+				++iUnresolvedCnt;
+			}
+			else if (futDone.get())
+			{
+				++iSucceededCnt;
+			}
+			else
+			{
+				++iFailedCnt;
+			}
+		}
+	}
+
+	rVar.New(PDT_VARLIST);
+	TVarList& rList = *rVar.GetVarListPtr();
+	rList.Add(5);
+	rList(0) = TCVCounter(iPushedCnt.load());
+	rList(1) = TCVCounter(iRejectedCnt.load());
+	rList(2) = TCVCounter(iSucceededCnt);
+	rList(3) = TCVCounter(iFailedCnt);
+	rList(4) = TCVCounter(iUnresolvedCnt);
+
+	return true;
+}
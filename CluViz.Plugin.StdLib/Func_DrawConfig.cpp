@@ -109,6 +109,37 @@ bool SetCylinderDetailLevelFunc(CCLUCodeBase& rCB, CCodeVar& rVar, CCodeVar& rPa
 	return true;
 }
 
+//////////////////////////////////////////////////////////////////////
+/// Enable drawing of repeated spheres, cones and cylinders as instance batches
+
+bool EnableInstanceBatchingFunc(CCLUCodeBase& rCB, CCodeVar& rVar, CCodeVar& rPars, int iLine, int iPos)
+{
+	TVarList& mVars = *rPars.GetVarListPtr();
+
+	int iVarCount = int(mVars.Count());
+	TCVCounter iVal;
+
+	if (iVarCount == 1)
+	{
+		if (!mVars(0).CastToCounter(iVal))
+		{
+			rCB.GetErrorList().InvalidParType(mVars(0), 1, iLine, iPos);
+			return false;
+		}
+	}
+	else
+	{
+		int piPar[] = { 1 };
+
+		rCB.GetErrorList().WrongNoOfParams(piPar, 1, iLine, iPos);
+		return false;
+	}
+
+	rCB.GetOGLDrawBase()->EnableInstanceBatching(iVal != 0);
+
+	return true;
+}
+
 //////////////////////////////////////////////////////////////////////
 /// Set Arrow Shape Function
 
@@ -277,3 +277,132 @@ bool EnableAnimationFunc(CCLUCodeBase &rCB, CCodeVar& rVar, CCodeVar& rPars, int
 }
 
 
+//////////////////////////////////////////////////////////////////////
+// Enable Bytecode FUNCTION
+//
+// Code lines executed after this call are compiled to bytecode
+// and run by the bytecode interpreter of the code base.
+// This setting is reset at the start of each script run.
+
+bool EnableBytecodeFunc(CCLUCodeBase &rCB, CCodeVar& rVar, CCodeVar& rPars, int iLine, int iPos)
+{
+	TVarList &mVars = *rPars.GetVarListPtr();
+	int iVarCount = int(mVars.Count());
+	TCVCounter iVal;
+
+	if (iVarCount != 1)
+	{
+		rCB.GetErrorList().WrongNoOfParams(1, iLine, iPos);
+		return false;
+	}
+
+	if (!mVars(0).CastToCounter(iVal))
+	{
+		rCB.GetErrorList().InvalidParType(mVars(0), 1, iLine, iPos);
+		return false;
+	}
+
+	rCB.EnableBytecode((iVal ? true : false));
+
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Get Temporary Variable Statistics
+//
+// Returns the list [allocated, reused, pooled, active] of counts of
+// temporary variable instances. If the optional parameter is true,
+// the allocation and reuse counters are reset after reading them.
+
+bool GetTempVarStatsFunc(CCLUCodeBase &rCB, CCodeVar& rVar, CCodeVar& rPars, int iLine, int iPos)
+{
+	TVarList &mVars = *rPars.GetVarListPtr();
+	int iVarCount = int(mVars.Count());
+	TCVCounter iVal = 0;
+
+	if (iVarCount > 1)
+	{
+		rCB.GetErrorList().WrongNoOfParams(1, iLine, iPos);
+		return false;
+	}
+
+	if (iVarCount == 1 && !mVars(0).CastToCounter(iVal))
+	{
+		rCB.GetErrorList().InvalidParType(mVars(0), 1, iLine, iPos);
+		return false;
+	}
+
+	rVar.New(PDT_VARLIST);
+	TVarList& rList = *rVar.GetVarListPtr();
+
+	rList.Add(4);
+	rList(0) = int(rCB.GetTempVarAllocCount());
+	rList(1) = int(rCB.GetTempVarReuseCount());
+	rList(2) = int(rCB.GetTempVarPoolCount());
+	rList(3) = rCB.TempVarCount();
+
+	if (iVal)
+	{
+		rCB.ResetTempVarCounters();
+	}
+
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Enable Incremental Execution FUNCTION
+//
+// If enabled, code lines whose inputs did not change are not executed
+// again in runs due to tool, pick drag and animation events. Instead,
+// their recorded effect on variables and the scene is reproduced.
+// This setting is kept until the script is parsed again.
+
+bool EnableIncrementalExecFunc(CCLUCodeBase &rCB, CCodeVar& rVar, CCodeVar& rPars, int iLine, int iPos)
+{
+	TVarList &mVars = *rPars.GetVarListPtr();
+	int iVarCount = int(mVars.Count());
+	TCVCounter iVal;
+
+	if (iVarCount != 1)
+	{
+		rCB.GetErrorList().WrongNoOfParams(1, iLine, iPos);
+		return false;
+	}
+
+	if (!mVars(0).CastToCounter(iVal))
+	{
+		rCB.GetErrorList().InvalidParType(mVars(0), 1, iLine, iPos);
+		return false;
+	}
+
+	rCB.EnableIncrementalExec((iVal ? true : false));
+
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Get Incremental Execution Statistics
+//
+// Returns the list [executed, skipped] of the number of top-level
+// code lines executed and skipped so far in the current run.
+
+bool GetIncrementalExecStatsFunc(CCLUCodeBase &rCB, CCodeVar& rVar, CCodeVar& rPars, int iLine, int iPos)
+{
+	TVarList &mVars = *rPars.GetVarListPtr();
+	int iVarCount = int(mVars.Count());
+
+	if (iVarCount != 0)
+	{
+		rCB.GetErrorList().WrongNoOfParams(0, iLine, iPos);
+		return false;
+	}
+
+	rVar.New(PDT_VARLIST);
+	TVarList& rList = *rVar.GetVarListPtr();
+
+	rList.Add(2);
+	rList(0) = int(rCB.GetCodeLineExecCount());
+	rList(1) = int(rCB.GetCodeLineSkipCount());
+
+	return true;
+}
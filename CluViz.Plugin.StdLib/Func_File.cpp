@@ -30,6 +30,7 @@
 #include "CluTec.Viz.Fltk\Fl_File_Chooser.H"
 #include "CluTec.Viz.Xml\XML.h"
 #include "CluTec.Viz.Parse\Encode.h"
+#include "CluTec.Viz.Parse\ChunkFile.h"
 
 #include "CluTec.Base/Exception.h"
 
@@ -48,6 +49,8 @@
 
 #include "CluTec.Viz.Parse\CLUCodeBase.h"
 #include "CluTec.Viz.Base\TensorOperators.h"
+#include "CluTec.Viz.Base\MappedFile.h"
+#include "CluTec.Viz.Base\NumFileParser.h"
 // For the generation of the script dependency paths
 #include "CluTec.Viz.Base\Environment.h"
 
@@ -55,6 +58,7 @@
 #include <algorithm>
 #include <functional>		// For greater<int>( )
 #include <string.h>
+#include <limits.h>
 #include "Func_File.h"
 #include <time.h>
 
@@ -179,16 +183,21 @@ bool GetDirListFunc(CCLUCodeBase& rCB, CCodeVar& rVar, CCodeVar& rPars, int iLin
 /// 1. Filename
 /// 2. Variable (any type)
 /// 3. XML Compression (0-9) (optional, default 0)
-///		OR: String giving type of file [ "xml", "bin", "bin2" ]
+///		OR: String giving type of file [ "xml", "bin", "bin2", "chunk" ]
 ///	4. (opt) "xml" : (int) xml compression rate;
 ///			 "bin" : (string) passwort for encoding bin;
 ///			 "bin2": (varlist) three integers giving [Key1,Key2,compression rate (0-9)], default is [0,0,1]
+///			 "chunk": (int) compression rate (0-9) of each chunk, default is 1
+///
+/// The "chunk" type writes the data of matrices, tensors, images and vertex lists as separately
+/// compressed chunks while the variable is traversed, so that the whole variable is never
+/// copied into one buffer. ReadVar can read single list elements of such files.
 ///
 /// Returns string "OK" if data was written, otherwise an error message.
 
 bool WriteVariableFunc(CCLUCodeBase& rCB, CCodeVar& rVar, CCodeVar& rPars, int iLine, int iPos)
 {
-	enum EFileType { FT_NONE = 0, FT_XML, FT_BIN, FT_BIN2 } eFileType = FT_XML;
+	enum EFileType { FT_NONE = 0, FT_XML, FT_BIN, FT_BIN2, FT_CHUNK } eFileType = FT_XML;
 	bool bEncode = false;
 	CStrMem csFilename;
 	TString csPassword;
@@ -242,6 +251,11 @@ bool WriteVariableFunc(CCLUCodeBase& rCB, CCodeVar& rVar, CCodeVar& rPars, int i
 			{
 				eFileType = FT_BIN2;
 			}
+			else if (csType == "chunk")
+			{
+				eFileType    = FT_CHUNK;
+				iCompression = 1;
+			}
 			else
 			{
 				rCB.GetErrorList().GeneralError("Unknown file type.", iLine, iPos);
@@ -257,7 +271,7 @@ bool WriteVariableFunc(CCLUCodeBase& rCB, CCodeVar& rVar, CCodeVar& rPars, int i
 
 	if (iVarCount >= 4)
 	{
-		if (eFileType == FT_XML)
+		if ((eFileType == FT_XML) || (eFileType == FT_CHUNK))
 		{
 			if (mVars(3).CastToCounter(iCompression))
 			{
@@ -473,6 +487,41 @@ bool WriteVariableFunc(CCLUCodeBase& rCB, CCodeVar& rVar, CCodeVar& rPars, int i
 
 		_chdir(pcCurPath);
 	}
+	else if (eFileType == FT_CHUNK)
+	{
+		char pcCurPath[500];
+		CChunkFileWriter xFile;
+		Mem<char> mData;
+		SChunkRef xRoot;
+
+		_getcwd(pcCurPath, 499);
+		_chdir(rCB.GetScriptPath().c_str());
+
+		try
+		{
+			if (!xFile.Open(csFilename.Str(), int(iCompression)))
+			{
+				throw CCluError(xFile.GetError().c_str());
+			}
+
+			// Writes the array data to the file and the variable tree to mData
+			WriteVariable(rCB, xFile, mData, mVars(1));
+
+			if (!xFile.AddArray(mData.Data(), mData.Count(), xRoot) || !xFile.Close(xRoot))
+			{
+				throw CCluError(xFile.GetError().c_str());
+			}
+
+			// Return with OK message to script
+			rVar = "OK";
+		}
+		catch (CCluException& rEx)
+		{
+			rVar = rEx.PrintError().c_str();
+		}
+
+		_chdir(pcCurPath);
+	}
 
 	return true;
 }
@@ -1205,17 +1254,21 @@ throw(CCluException)
 ///
 /// 1. Filename
 /// 2. Variable in which to write result (any type)
-/// 3. (opt) File type to read from: [ "xml" | "bin" | "bin2" ]
+/// 3. (opt) File type to read from: [ "xml" | "bin" | "bin2" | "chunk" ]
 /// 4. (opt) "bin" : (string)  Encoding password for "bin" type
 ///			 "bin2": (varlist) List containing keys [ key1, key2 ]
+///			 "chunk": (varlist) Path of indices, starting at 1, of the list element to read.
+///					For example, [ 2, 3 ] reads the third element of the second element.
+///					Only the data of this element is read from the file.
 ///
 /// Returns string "OK" if data was read, otherwise an error message.
 
 bool ReadVariableFunc(CCLUCodeBase& rCB, CCodeVar& rVar, CCodeVar& rPars, int iLine, int iPos)
 {
-	enum EFileType { FT_NONE = 0, FT_XML, FT_BIN, FT_BIN2 } eFileType = FT_XML;
+	enum EFileType { FT_NONE = 0, FT_XML, FT_BIN, FT_BIN2, FT_CHUNK } eFileType = FT_XML;
 
 	CStrMem csFilename, csPass;
+	std::vector<int> vecPath;
 	TCVCounter iKey1 = 0, iKey2 = 0;
 	TVarList& mVars  = *rPars.GetVarListPtr();
 
@@ -1263,6 +1316,10 @@ bool ReadVariableFunc(CCLUCodeBase& rCB, CCodeVar& rVar, CCodeVar& rPars, int iL
 		{
 			eFileType = FT_BIN2;
 		}
+		else if (csType == "chunk")
+		{
+			eFileType = FT_CHUNK;
+		}
 		else
 		{
 			rCB.GetErrorList().GeneralError("Invalid file type.", iLine, iPos);
@@ -1304,6 +1361,28 @@ bool ReadVariableFunc(CCLUCodeBase& rCB, CCodeVar& rVar, CCodeVar& rPars, int iL
 				return false;
 			}
 		}
+		else if (eFileType == FT_CHUNK)
+		{
+			if (mVars(3).BaseType() != PDT_VARLIST)
+			{
+				rCB.GetErrorList().GeneralError("Expect as fourth parameter list of element indices.", iLine, iPos);
+				return false;
+			}
+
+			TVarList& rList = *mVars(3).GetVarListPtr();
+			TCVCounter iIdx;
+
+			for (int iStep = 0; iStep < int(rList.Count()); ++iStep)
+			{
+				if (!rList(iStep).CastToCounter(iIdx) || (iIdx < 1))
+				{
+					rCB.GetErrorList().GeneralError("Element indices have to be positive integers.", iLine, iPos);
+					return false;
+				}
+
+				vecPath.push_back(int(iIdx) - 1);
+			}
+		}
 	}
 
 	csFilename = mVars(0).ValStr();
@@ -1521,6 +1600,40 @@ bool ReadVariableFunc(CCLUCodeBase& rCB, CCodeVar& rVar, CCodeVar& rPars, int iL
 
 		_chdir(pcCurPath);
 	}
+	else if (eFileType == FT_CHUNK)
+	{
+		CChunkFileReader xFile;
+		Mem<char> mData;
+		char pcCurPath[500];
+
+		_getcwd(pcCurPath, 499);
+		_chdir(rCB.GetScriptPath().c_str());
+
+		try
+		{
+			if (!xFile.Open(csFilename.Str()))
+			{
+				throw CCluError(xFile.GetError().c_str());
+			}
+
+			// Only the variable tree is read here. Array data is read when it is needed.
+			if (!mData.Set(size_t(xFile.GetRoot().uSize)) || !xFile.ReadArray(xFile.GetRoot(), mData.Data()))
+			{
+				throw CCluError(xFile.GetError().c_str());
+			}
+
+			ReadVariable(rCB, mVars(1), xFile, mData, FindVariable(mData, 0, vecPath));
+
+			// Return with OK message to script
+			rVar = "OK";
+		}
+		catch (CCluException& rEx)
+		{
+			rVar = rEx.PrintError().c_str();
+		}
+
+		_chdir(pcCurPath);
+	}
 
 	return true;
 }
@@ -1915,175 +2028,570 @@ throw(CCluException)
 }
 
 //////////////////////////////////////////////////////////////////////
-/// Read a single variable
+/// Write a single variable to a chunk file
+///
+/// Scalars, counters, strings, multivectors and colors are stored in the variable tree mData
+/// as for the "bin" file type. The data of matrices, tensors, images and vertex lists is
+/// written to chunks of the file right away and only referenced in the tree. Lists store the
+/// position of each element in the tree, so that single elements can be read on their own.
 
-void ReadVariable(CCLUCodeBase& rCB, CCodeVar& rVar, CXMLElement& rEl)
+void WriteVariable(CCLUCodeBase& rCB, CChunkFileWriter& xFile, Mem<char>& mData, CCodeVar& rVar)
 throw(CCluException)
 {
-	char pcText[100];
-	string sType, sError, sContent;
-
-	sType    = rEl.GetProp("type");
-	sContent = rEl.GetContent();
+	ECodeDataType eVarType = rVar.BaseType();
+	uchar cVarType         = uchar(eVarType);
+	uint uAddSize;
+	char* pcData;
+	SChunkRef xRef;
 
-	if (sType == CCodeVar::TypeStr(PDT_SCALAR))
-	{
-		TCVScalar dVal;
-		sscanf_s(sContent.c_str(), "%lg", &dVal);
-		rVar = dVal;
-	}
-	else if (sType == CCodeVar::TypeStr(PDT_COUNTER))
-	{
-		TCVCounter iVal;
-		sscanf_s(sContent.c_str(), "%d", &iVal);
-		rVar = iVal;
-	}
-	else if (sType == CCodeVar::TypeStr(PDT_STRING))
-	{
-		rVar = sContent.c_str();
-	}
-	else if (sType == CCodeVar::TypeStr(PDT_MATRIX))
+	if (eVarType == PDT_MATRIX)
 	{
-		stringstream zContent;
-		int iRows, iCols, iPos, iCount;
-		TCVScalar* pData;
-		rVar.New(PDT_MATRIX, rVar.Name().c_str());
 		TMatrix& xA = *rVar.GetMatrixPtr();
+		uint uRows  = xA.Rows();
+		uint uCols  = xA.Cols();
 
-		iRows = atoi(rEl.GetProp("rows").c_str());
-		iCols = atoi(rEl.GetProp("cols").c_str());
-
-		if (!xA.Resize(iRows, iCols))
+		if (!xFile.AddArray(xA.Data(), size_t(uRows) * size_t(uCols) * sizeof(TCVScalar), xRef))
 		{
-			sprintf_s(pcText, "Cannot create matrix of dimensions %dx%d.", iRows, iCols);
-			throw CCluError(pcText);
+			throw CCluError(xFile.GetError().c_str());
 		}
 
-		zContent.str(sContent);
-		pData  = xA.Data();
-		iCount = iRows * iCols;
-		for (iPos = 0; iPos < iCount; iPos++)
-		{
-			pcText[0] = 0;
-			zContent.getline(pcText, 99, ' ');
-			if (pcText[0] == 0)
-			{
-				throw CCluError("Not enough data for matrix");
-			}
-
-			sscanf_s(pcText, "%lg", &pData[iPos]);
-		}
+		ADD_VAR_START(2 * sizeof(uint) + sizeof(SChunkRef))
+		ADD_VAL(&uRows, sizeof(uint))
+		ADD_VAL(&uCols, sizeof(uint))
+		ADD_VAL(&xRef, sizeof(SChunkRef))
 	}
-	else if (sType == CCodeVar::TypeStr(PDT_TENSOR))
+	else if ((eVarType == PDT_TENSOR) ||
+		 (eVarType == PDT_TENSOR_IDX))
 	{
-		stringstream zContent, zDim;
-		Mem<int> mDim;
-		int iPos, iDim, iValence, iSize;
-		TCVScalar* pData;
-
-		rVar.New(PDT_TENSOR);
-		TTensor& rT = *rVar.GetTensorPtr();
+		TTensor* pT, T;
 
-		zDim.str(rEl.GetProp("dim"));
-		iValence = 0;
-		while (true)
+		if (eVarType == PDT_TENSOR_IDX)
 		{
-			pcText[0] = 0;
-			zDim.getline(pcText, 99, ' ');
-			if (pcText[0] == 0)
+			TTensorIdx& rTIdx = *rVar.GetTensorIdxPtr();
+
+			if (!MakeTensor(T, rTIdx))
 			{
-				break;
+				throw CCluError("Error creating tensor from index");
 			}
 
-			sscanf_s(pcText, "%d", &iDim);
-			iValence++;
-			mDim.Add(1);
-			mDim.Last() = iDim;
+			pT = &T;
 		}
-
-		rT.Reset(mDim);
-		pData = rT.Data();
-		iSize = rT.Size();
-
-		zContent.str(rEl.GetContent());
-		iPos = 0;
-		while (iPos < iSize)
+		else
 		{
-			pcText[0] = 0;
-			zContent.getline(pcText, 99, ' ');
-			if (pcText[0] == 0)
-			{
-				throw CCluError("Not enough data for tensor");
-			}
-
-			sscanf_s(pcText, "%lg", &pData[iPos]);
-			iPos++;
+			pT = rVar.GetTensorPtr();
 		}
-	}
-	else if (sType == CCodeVar::TypeStr(PDT_MULTIV))
-	{
-		stringstream zContent, zIdx;
-		int iPos;
-		string sBID, sIdx;
 
-		rVar.New(PDT_MULTIV, rVar.Name().c_str());
-		TMultiV& vA = *rVar.GetMultiVPtr();
+		TTensor& rT = *pT;
 
-		sIdx = rEl.GetProp("idx");
-		sBID = rEl.GetProp("bid");
+		int iDim, iValence = rT.Valence();
+		int iVal;
 
-		if (sBID == "E3")
-		{
-			vA = E3GA<TCVScalar>::vZero;
-		}
-		#ifdef USE_GA_E8
-			else if (sBID == "E8")
-			{
-				vA = E8GA<TCVScalar>::vZero;
-			}
-		#endif
-		else if (sBID == "P3")
+		if (!xFile.AddArray(rT.Data(), size_t(rT.Size()) * sizeof(TCVScalar), xRef))
 		{
-			vA = PGA<TCVScalar>::vZero;
+			throw CCluError(xFile.GetError().c_str());
 		}
-		else if (sBID == "C2")
+
+		cVarType = uchar(PDT_TENSOR);
+
+		ADD_VAR_START((iValence + 1) * sizeof(int) + sizeof(SChunkRef))
+		ADD_VAL(&iValence, sizeof(int))
+
+		for (iDim = 0; iDim < iValence; iDim++)
 		{
-			vA = El2GA<TCVScalar>::vZero;
+			iVal = rT.DimSize(iDim);
+			ADD_VAL(&iVal, sizeof(int))
 		}
-		else if (sBID == "N3")
+
+		ADD_VAL(&xRef, sizeof(SChunkRef))
+	}
+	else if (eVarType == PDT_IMAGE)
+	{
+		TImage& rImage = *rVar.GetImagePtr();
+
+		if (!rImage.IsValid())
 		{
-			vA = ConfGA<TCVScalar>::vZero;
+			throw CCluError("Invalid image");
 		}
 
-		zIdx.str(sIdx);
-		zContent.str(sContent);
-		while (true)
-		{
-			pcText[0] = 0;
-			zIdx.getline(pcText, 99, ' ');
-			if (pcText[0] == 0)
-			{
-				break;
-			}
+		int iWidth, iHeight;
+		int iImgType, iDataType, iBPP;
 
-			sscanf_s(pcText, "%d", &iPos);
+		rImage->GetSize(iWidth, iHeight);
+		rImage->GetType(iImgType, iDataType, iBPP);
 
-			pcText[0] = 0;
-			zContent.getline(pcText, 99, ' ');
-			if (pcText[0] == 0)
-			{
-				throw CCluError("Not enough data for multivector");
-			}
+		::LockImageAccess();
+		bool bOK = xFile.AddArray(rImage->GetDataPtr(), size_t(iWidth) * size_t(iHeight) * size_t(iBPP), xRef);
+		::UnlockImageAccess();
 
-			sscanf_s(pcText, "%lg", &vA[iPos]);
+		if (!bOK)
+		{
+			throw CCluError(xFile.GetError().c_str());
 		}
+
+		ADD_VAR_START(5 * sizeof(int) + sizeof(SChunkRef))
+		ADD_VAL(&iWidth, sizeof(int))
+		ADD_VAL(&iHeight, sizeof(int))
+		ADD_VAL(&iImgType, sizeof(int))
+		ADD_VAL(&iDataType, sizeof(int))
+		ADD_VAL(&iBPP, sizeof(int))
+		ADD_VAL(&xRef, sizeof(SChunkRef))
 	}
-	else if (sType == CCodeVar::TypeStr(PDT_VARLIST))
+	else if (eVarType == PDT_SCENE /* Object */)
 	{
-		/*
-		int iSize;
-		string sSize;
-		sSize = rEl.GetProp("size");
+		// The "bin" record of a vertex list stores each vertex property as one float array
+		Mem<char> mVexList;
+
+		WriteVariable(rCB, mVexList, rVar, 0);
+
+		if (!xFile.AddArray(mVexList.Data(), mVexList.Count(), xRef))
+		{
+			throw CCluError(xFile.GetError().c_str());
+		}
+
+		ADD_VAR_START(sizeof(SChunkRef))
+		ADD_VAL(&xRef, sizeof(SChunkRef))
+	}
+	else if (eVarType == PDT_VARLIST)
+	{
+		TVarList& rList = *rVar.GetVarListPtr();
+		int iVar, iCount = int(rList.Count());
+		uint64_t uElPos;
+
+		// Element count and tree position of each element
+		ADD_VAR_START(sizeof(int) + iCount * sizeof(uint64_t))
+		ADD_VAL(&iCount, sizeof(int))
+
+		size_t nTablePos = mData.Count() - iCount * sizeof(uint64_t);
+
+		for (iVar = 0; iVar < iCount; iVar++)
+		{
+			uElPos = uint64_t(mData.Count());
+			memcpy(&mData[nTablePos + iVar * sizeof(uint64_t)], &uElPos, sizeof(uint64_t));
+
+			WriteVariable(rCB, xFile, mData, rList(iVar));
+		}
+	}
+	else
+	{
+		WriteVariable(rCB, mData, rVar, 0);
+	}
+}
+
+//////////////////////////////////////////////////////////////////////
+/// Check that nSize bytes starting at position nPos lie inside the variable tree mData of a chunk file
+
+static void CheckTreeRange(const Mem<char>& mData, size_t nPos, uint64_t uSize)
+throw(CCluException)
+{
+	if ((nPos > mData.Count()) || (uSize > uint64_t(mData.Count() - nPos)))
+	{
+		throw CCluError("Variable tree of chunk file is corrupted");
+	}
+}
+
+//////////////////////////////////////////////////////////////////////
+/// Read the variable at position nPos of the variable tree mData of a chunk file
+
+void ReadVariable(CCLUCodeBase& rCB, CCodeVar& rVar, CChunkFileReader& xFile, Mem<char>& mData, size_t nPos)
+throw(CCluException)
+{
+	CheckTreeRange(mData, nPos, 1);
+
+	char* pcData  = &mData[nPos];
+	char** ppcData = &pcData;
+	ECodeDataType eVarType = ECodeDataType(uchar(*pcData));
+	SChunkRef xRef;
+
+	if (eVarType == PDT_MATRIX)
+	{
+		uint uRows, uCols;
+
+		CheckTreeRange(mData, nPos, 1 + 2 * sizeof(uint) + sizeof(SChunkRef));
+
+		++pcData;
+		GET_VAL(&uRows, sizeof(uint))
+		GET_VAL(&uCols, sizeof(uint))
+		GET_VAL(&xRef, sizeof(SChunkRef))
+
+		if (xRef.uSize != uint64_t(uRows) * uint64_t(uCols) * sizeof(TCVScalar))
+		{
+			throw CCluError("Matrix size does not fit its data. File is probably corrupted");
+		}
+
+		rVar.New(PDT_MATRIX, rVar.Name().c_str());
+		TMatrix& xVal = *rVar.GetMatrixPtr();
+
+		if (!xVal.Resize(uRows, uCols))
+		{
+			throw CCluError("Out of memory while reading matrix");
+		}
+
+		if (!xFile.ReadArray(xRef, xVal.Data()))
+		{
+			throw CCluError(xFile.GetError().c_str());
+		}
+	}
+	else if (eVarType == PDT_TENSOR)
+	{
+		int iValence, iDim;
+		uint64_t uSize = 1;
+		Mem<int> mDims;
+
+		CheckTreeRange(mData, nPos, 1 + sizeof(int));
+
+		++pcData;
+		GET_VAL(&iValence, sizeof(int))
+
+		if (iValence < 0)
+		{
+			throw CCluError("Valence of tensor is invalid. File is probably corrupted");
+		}
+
+		CheckTreeRange(mData, nPos, 1 + sizeof(int) + uint64_t(iValence) * sizeof(int) + sizeof(SChunkRef));
+
+		if (!mDims.Set(iValence))
+		{
+			throw CCluError("Valence of tensor is invalid. File is probably corrupted");
+		}
+
+		for (iDim = 0; iDim < iValence; ++iDim)
+		{
+			GET_VAL(&mDims[iDim], sizeof(int))
+
+			if (mDims[iDim] < 0)
+			{
+				throw CCluError("Negative tensor dimension. File is probably corrupted");
+			}
+
+			uSize *= uint64_t(mDims[iDim]);
+		}
+
+		GET_VAL(&xRef, sizeof(SChunkRef))
+
+		rVar.New(PDT_TENSOR, rVar.Name().c_str());
+
+		if (iValence > 0)
+		{
+			if (xRef.uSize != uSize * sizeof(TCVScalar))
+			{
+				throw CCluError("Tensor size does not fit its data. File is probably corrupted");
+			}
+
+			TTensor& tVal = *rVar.GetTensorPtr();
+			tVal.Reset(mDims);
+
+			if (!xFile.ReadArray(xRef, tVal.Data()))
+			{
+				throw CCluError(xFile.GetError().c_str());
+			}
+		}
+	}
+	else if (eVarType == PDT_IMAGE)
+	{
+		int iWidth, iHeight;
+		int iImgType, iDataType, iBPP;
+
+		CheckTreeRange(mData, nPos, 1 + 5 * sizeof(int) + sizeof(SChunkRef));
+
+		++pcData;
+		GET_VAL(&iWidth, sizeof(int))
+		GET_VAL(&iHeight, sizeof(int))
+		GET_VAL(&iImgType, sizeof(int))
+		GET_VAL(&iDataType, sizeof(int))
+		GET_VAL(&iBPP, sizeof(int))
+		GET_VAL(&xRef, sizeof(SChunkRef))
+
+		if ((iWidth < 0) || (iHeight < 0) || (iBPP < 0)
+		    || (xRef.uSize != uint64_t(iWidth) * uint64_t(iHeight) * uint64_t(iBPP)))
+		{
+			throw CCluError("File contains invalid image variable");
+		}
+
+		rVar.New(PDT_IMAGE, rVar.Name().c_str());
+		TImage& rImage = *rVar.GetImagePtr();
+
+		rImage->ResizeCanvas(1, 1);
+		rImage->ConvertType(iImgType, iDataType);
+		rImage->ResizeCanvas(iWidth, iHeight);
+
+		::LockImageAccess();
+		bool bOK = xFile.ReadArray(xRef, rImage->GetDataPtr());
+		::UnlockImageAccess();
+
+		if (!bOK)
+		{
+			throw CCluError(xFile.GetError().c_str());
+		}
+	}
+	else if (eVarType == PDT_SCENE /* Object */)
+	{
+		Mem<char> mVexList;
+
+		CheckTreeRange(mData, nPos, 1 + sizeof(SChunkRef));
+
+		++pcData;
+		GET_VAL(&xRef, sizeof(SChunkRef))
+
+		if (!mVexList.Set(size_t(xRef.uSize)))
+		{
+			throw CCluError("Out of memory while reading vertex list");
+		}
+
+		if (!xFile.ReadArray(xRef, mVexList.Data()))
+		{
+			throw CCluError(xFile.GetError().c_str());
+		}
+
+		char* pcVexList = mVexList.Data();
+		ReadVariable(rCB, rVar, &pcVexList);
+	}
+	else if (eVarType == PDT_VARLIST)
+	{
+		int iVar, iCount;
+		uint64_t uElPos;
+
+		CheckTreeRange(mData, nPos, 1 + sizeof(int));
+
+		++pcData;
+		GET_VAL(&iCount, sizeof(int))
+
+		if (iCount < 0)
+		{
+			throw CCluError("Negative variable list size. File probably corrupted");
+		}
+
+		// Table of element positions
+		CheckTreeRange(mData, nPos, 1 + sizeof(int) + uint64_t(iCount) * sizeof(uint64_t));
+
+		rVar.New(PDT_VARLIST, rVar.Name().c_str());
+		TVarList& rList = *rVar.GetVarListPtr();
+
+		if (iCount > 0)
+		{
+			rList.Set(iCount);
+
+			for (iVar = 0; iVar < iCount; iVar++)
+			{
+				memcpy(&uElPos, pcData + iVar * sizeof(uint64_t), sizeof(uint64_t));
+				ReadVariable(rCB, rList(iVar), xFile, mData, size_t(uElPos));
+			}
+		}
+	}
+	else
+	{
+		ReadVariable(rCB, rVar, ppcData);
+	}
+}
+
+//////////////////////////////////////////////////////////////////////
+/// Find the tree position of a list element in the variable tree of a chunk file
+///
+/// vecPath gives the index of the element, starting at 0, in the list at nPos,
+/// then the index in that element, and so on.
+
+size_t FindVariable(Mem<char>& mData, size_t nPos, const std::vector<int>& vecPath)
+throw(CCluException)
+{
+	int iCount;
+	uint64_t uElPos;
+
+	for (size_t nStep = 0; nStep < vecPath.size(); ++nStep)
+	{
+		CheckTreeRange(mData, nPos, 1 + sizeof(int));
+
+		char* pcData = &mData[nPos];
+
+		if (ECodeDataType(uchar(*pcData)) != PDT_VARLIST)
+		{
+			throw CCluError("Element path refers to a variable that is not a list");
+		}
+
+		memcpy(&iCount, pcData + 1, sizeof(int));
+
+		if ((vecPath[nStep] < 0) || (vecPath[nStep] >= iCount))
+		{
+			throw CCluError("Element path refers to an element that is not in the list");
+		}
+
+		CheckTreeRange(mData, nPos, 1 + sizeof(int) + uint64_t(vecPath[nStep] + 1) * sizeof(uint64_t));
+
+		memcpy(&uElPos, pcData + 1 + sizeof(int) + vecPath[nStep] * sizeof(uint64_t), sizeof(uint64_t));
+		nPos = size_t(uElPos);
+	}
+
+	return nPos;
+}
+
+//////////////////////////////////////////////////////////////////////
+/// Read a single variable
+
+void ReadVariable(CCLUCodeBase& rCB, CCodeVar& rVar, CXMLElement& rEl)
+throw(CCluException)
+{
+	char pcText[100];
+	string sType, sError, sContent;
+
+	sType    = rEl.GetProp("type");
+	sContent = rEl.GetContent();
+
+	if (sType == CCodeVar::TypeStr(PDT_SCALAR))
+	{
+		TCVScalar dVal;
+		sscanf_s(sContent.c_str(), "%lg", &dVal);
+		rVar = dVal;
+	}
+	else if (sType == CCodeVar::TypeStr(PDT_COUNTER))
+	{
+		TCVCounter iVal;
+		sscanf_s(sContent.c_str(), "%d", &iVal);
+		rVar = iVal;
+	}
+	else if (sType == CCodeVar::TypeStr(PDT_STRING))
+	{
+		rVar = sContent.c_str();
+	}
+	else if (sType == CCodeVar::TypeStr(PDT_MATRIX))
+	{
+		stringstream zContent;
+		int iRows, iCols, iPos, iCount;
+		TCVScalar* pData;
+		rVar.New(PDT_MATRIX, rVar.Name().c_str());
+		TMatrix& xA = *rVar.GetMatrixPtr();
+
+		iRows = atoi(rEl.GetProp("rows").c_str());
+		iCols = atoi(rEl.GetProp("cols").c_str());
+
+		if (!xA.Resize(iRows, iCols))
+		{
+			sprintf_s(pcText, "Cannot create matrix of dimensions %dx%d.", iRows, iCols);
+			throw CCluError(pcText);
+		}
+
+		zContent.str(sContent);
+		pData  = xA.Data();
+		iCount = iRows * iCols;
+		for (iPos = 0; iPos < iCount; iPos++)
+		{
+			pcText[0] = 0;
+			zContent.getline(pcText, 99, ' ');
+			if (pcText[0] == 0)
+			{
+				throw CCluError("Not enough data for matrix");
+			}
+
+			sscanf_s(pcText, "%lg", &pData[iPos]);
+		}
+	}
+	else if (sType == CCodeVar::TypeStr(PDT_TENSOR))
+	{
+		stringstream zContent, zDim;
+		Mem<int> mDim;
+		int iPos, iDim, iValence, iSize;
+		TCVScalar* pData;
+
+		rVar.New(PDT_TENSOR);
+		TTensor& rT = *rVar.GetTensorPtr();
+
+		zDim.str(rEl.GetProp("dim"));
+		iValence = 0;
+		while (true)
+		{
+			pcText[0] = 0;
+			zDim.getline(pcText, 99, ' ');
+			if (pcText[0] == 0)
+			{
+				break;
+			}
+
+			sscanf_s(pcText, "%d", &iDim);
+			iValence++;
+			mDim.Add(1);
+			mDim.Last() = iDim;
+		}
+
+		rT.Reset(mDim);
+		pData = rT.Data();
+		iSize = rT.Size();
+
+		zContent.str(rEl.GetContent());
+		iPos = 0;
+		while (iPos < iSize)
+		{
+			pcText[0] = 0;
+			zContent.getline(pcText, 99, ' ');
+			if (pcText[0] == 0)
+			{
+				throw CCluError("Not enough data for tensor");
+			}
+
+			sscanf_s(pcText, "%lg", &pData[iPos]);
+			iPos++;
+		}
+	}
+	else if (sType == CCodeVar::TypeStr(PDT_MULTIV))
+	{
+		stringstream zContent, zIdx;
+		int iPos;
+		string sBID, sIdx;
+
+		rVar.New(PDT_MULTIV, rVar.Name().c_str());
+		TMultiV& vA = *rVar.GetMultiVPtr();
+
+		sIdx = rEl.GetProp("idx");
+		sBID = rEl.GetProp("bid");
+
+		if (sBID == "E3")
+		{
+			vA = E3GA<TCVScalar>::vZero;
+		}
+		#ifdef USE_GA_E8
+			else if (sBID == "E8")
+			{
+				vA = E8GA<TCVScalar>::vZero;
+			}
+		#endif
+		else if (sBID == "P3")
+		{
+			vA = PGA<TCVScalar>::vZero;
+		}
+		else if (sBID == "C2")
+		{
+			vA = El2GA<TCVScalar>::vZero;
+		}
+		else if (sBID == "N3")
+		{
+			vA = ConfGA<TCVScalar>::vZero;
+		}
+
+		zIdx.str(sIdx);
+		zContent.str(sContent);
+		while (true)
+		{
+			pcText[0] = 0;
+			zIdx.getline(pcText, 99, ' ');
+			if (pcText[0] == 0)
+			{
+				break;
+			}
+
+			sscanf_s(pcText, "%d", &iPos);
+
+			pcText[0] = 0;
+			zContent.getline(pcText, 99, ' ');
+			if (pcText[0] == 0)
+			{
+				throw CCluError("Not enough data for multivector");
+			}
+
+			sscanf_s(pcText, "%lg", &vA[iPos]);
+		}
+	}
+	else if (sType == CCodeVar::TypeStr(PDT_VARLIST))
+	{
+		/*
+		int iSize;
+		string sSize;
+		sSize = rEl.GetProp("size");
 		iSize = atoi(sSize.c_str());
 		if (iSize <= 0)
 		throw CCLUError("Invalid variable list size");
@@ -2421,23 +2929,19 @@ bool ReadDataFunc(CCLUCodeBase& rCB, CCodeVar& rVar, CCodeVar& rPars, int iLine,
 
 	csFilename = mVars(0).ValStr();
 
-	ifstream zData;
-	char pcCurPath[500], pcLine[301], pcVal[2], cVal;
-	double dVal;
-
-	rVar.New(PDT_VARLIST);
-	TVarList& DList = *rVar.GetVarListPtr();
-	vector<TVarList*> vecVarList;
-	TVarList* pCurVarList;
+	CMappedFile xFile;
+	CNumFileParser xParser;
+	char pcCurPath[500];
 
 	_getcwd(pcCurPath, 499);
 	_chdir(rCB.GetScriptPath().c_str());
 
-	zData.open(csFilename.Str());
-	if (!zData.is_open())
-	{
-		_chdir(pcCurPath);
+	xFile.Open(csFilename.Str());
+
+	_chdir(pcCurPath);
 
+	if (!xFile.IsOpen())
+	{
 		char pcText[500];
 		sprintf_s(pcText, "Data file '%s' could not be opened.", csFilename.Str());
 
@@ -2445,59 +2949,35 @@ bool ReadDataFunc(CCLUCodeBase& rCB, CCodeVar& rVar, CCodeVar& rPars, int iLine,
 		return false;
 	}
 
-	vecVarList.push_back(&DList);
-	DList.Add(1);
-	DList.Last().New(PDT_VARLIST);
-	pCurVarList = ((TVarList*) DList.Last().Val());
-	vecVarList.push_back(pCurVarList);
+	// Values that are not numbers are dropped and each line is a list, even if it is empty
+	xParser.SetSeparators(pcSep);
+	xParser.SetSkipInvalid(true);
+	xParser.SetKeepEmptyLines(true);
 
-	pcVal[1]  = 0;
-	pcLine[0] = 0;
-	do
+	if (!xParser.Parse(xFile.GetData(), xFile.GetSize()))
 	{
-		cVal = (char) zData.get();
-		//zData.getline(pcLine, 299);
-		if (zData.eof() && (pcLine[0] == 0))
-		{
-			break;
-		}
-		else if (zData.eof())
-		{
-			cVal = pcSep[0];
-		}
+		rCB.GetErrorList().GeneralError(xParser.GetError().c_str(), iLine, iPos);
+		return false;
+	}
 
-		if (((cVal == pcSep[0]) || (cVal == '\n')) && (pcLine[0] != 0))
-		{
-			if (sscanf_s(pcLine, "%lg", &dVal) == 1)
-			{
-				pCurVarList->Add(1);
-				pCurVarList->Last() = (TCVScalar) dVal;
-			}
-			pcLine[0] = 0;
-		}
-		else if ((cVal != pcSep[0]) && (cVal != '\n'))
-		{
-			pcVal[0] = cVal;
-			//strcat(pcLine, pcVal);
-			strcat_s(pcLine, sizeof(pcLine), pcVal);
-		}
+	rVar.New(PDT_VARLIST);
+	TVarList& DList = *rVar.GetVarListPtr();
+	size_t nRow = 0;
 
-		if (cVal == '\n')
+	DList.Set(xParser.GetRowCount());
+	xParser.ForEachRow([&](const double* pdVal, size_t nCount)
+	{
+		DList(int(nRow)).New(PDT_VARLIST);
+		TVarList& rRow = *DList(int(nRow)).GetVarListPtr();
+
+		rRow.Set(nCount);
+		for (size_t nCol = 0; nCol < nCount; ++nCol)
 		{
-			vecVarList.pop_back();
-			pCurVarList = vecVarList.back();
-			pCurVarList->Add(1);
-			pCurVarList->Last().New(PDT_VARLIST);
-			pCurVarList = ((TVarList*) pCurVarList->Last().Val());
-			vecVarList.push_back(pCurVarList);
-			pcLine[0] = 0;
+			rRow(int(nCol)) = TCVScalar(pdVal[nCol]);
 		}
-	}
-	while (!zData.eof());
 
-	zData.close();
-
-	_chdir(pcCurPath);
+		++nRow;
+	});
 
 	return true;
 }
@@ -2686,22 +3166,21 @@ bool ReadMatrixFunc(CCLUCodeBase& rCB, CCodeVar& rVar, CCodeVar& rPars, int iLin
 
 	csFilename = mVars(0).ValStr();
 
-	ifstream zData;
-	int iLineLen, iRow, iCol, iRowCount, iColCount;
-	char pcCurPath[500], pcLine[301], pcVal[2], cVal;
-	double dVal;
-
-	rVar.New(PDT_MATRIX);
-	TMatrix& DMatrix = *rVar.GetMatrixPtr();
+	CMappedFile xFile;
+	CNumFileParser xParser;
+	char pcCurPath[500];
+	int iRowCount, iColCount;
+	double pdDim[2];
 
 	_getcwd(pcCurPath, 499);
 	_chdir(rCB.GetScriptPath().c_str());
 
-	zData.open(csFilename.Str());
-	if (!zData.is_open())
-	{
-		_chdir(pcCurPath);
+	xFile.Open(csFilename.Str());
 
+	_chdir(pcCurPath);
+
+	if (!xFile.IsOpen())
+	{
 		char pcText[500];
 		sprintf_s(pcText, "Matrix data file '%s' could not be opened.", csFilename.Str());
 
@@ -2709,82 +3188,284 @@ bool ReadMatrixFunc(CCLUCodeBase& rCB, CCodeVar& rVar, CCodeVar& rPars, int iLin
 		return false;
 	}
 
-	iRowCount = 0;
-	iColCount = 0;
-	iRow      = -1;
-	iCol      = -2;
-	pcVal[1]  = 0;
-	pcLine[0] = 0;
-	iLineLen  = 0;
-	do
+	// The first line contains the number of rows and columns
+	xParser.SetSeparators(pcSep);
+	xParser.SetLineRange(0, 0);
+	xParser.SetKeepEmptyLines(true);
+	xParser.SetColumns(std::vector<int>({ 0, 1 }));
+
+	if (!xParser.Parse(xFile.GetData(), xFile.GetSize()) || (xParser.GetRowCount() == 0))
+	{
+		rCB.GetErrorList().GeneralError("Matrix dimensions not specified.", iLine, iPos);
+		return false;
+	}
+
+	xParser.CopyTo(pdDim);
+
+	if ((pdDim[0] != pdDim[0]) || (pdDim[1] != pdDim[1]))
+	{
+		rCB.GetErrorList().GeneralError("Matrix dimensions not specified.", iLine, iPos);
+		return false;
+	}
+
+	iRowCount = int(pdDim[0]);
+	iColCount = int(pdDim[1]);
+
+	if (iRowCount <= 0)
+	{
+		rCB.GetErrorList().GeneralError("Invalid row size of matrix.", iLine, iPos);
+		return false;
+	}
+
+	if (iColCount <= 0)
+	{
+		rCB.GetErrorList().GeneralError("Invalid column size of matrix.", iLine, iPos);
+		return false;
+	}
+
+	// Each following line is a row of the matrix, also if it is empty. Missing values are zero.
+	std::vector<int> vecCol(iColCount);
+	for (int iCol = 0; iCol < iColCount; ++iCol)
+	{
+		vecCol[iCol] = iCol;
+	}
+
+	xParser.SetLineRange(1, size_t(iRowCount));
+	xParser.SetColumns(vecCol);
+	xParser.SetFillValue(0.0);
+
+	if (!xParser.Parse(xFile.GetData(), xFile.GetSize()))
+	{
+		rCB.GetErrorList().GeneralError(xParser.GetError().c_str(), iLine, iPos);
+		return false;
+	}
+
+	rVar.New(PDT_MATRIX);
+	TMatrix& DMatrix = *rVar.GetMatrixPtr();
+
+	if (!DMatrix.Resize(iRowCount, iColCount))
+	{
+		rCB.GetErrorList().GeneralError("Not enough memory for matrix.", iLine, iPos);
+		return false;
+	}
+
+	memset(DMatrix.Data(), 0, size_t(iRowCount) * size_t(iColCount) * sizeof(TCVScalar));
+	xParser.CopyTo(DMatrix.Data());
+
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////
+/// Read Numeric Data Function
+///
+/// Reads a text file of numbers into a matrix or tensor, with one row per line.
+/// Lines without values are skipped. Missing values and entries that are not numbers are NaN.
+/// Blanks, tabs and carriage returns always separate values.
+///
+/// 1. Filename
+/// 2. Separator symbols (optional). Standard is ",;". Each symbol separates values.
+/// 3. List of columns to read, starting at 1 (optional). Empty list reads all columns.
+/// 4. List of first and last line to read, starting at 1 (optional).
+///		Empty list reads all lines. If only the first line is given, reads to the end of the file.
+/// 5. "matrix" or "tensor" (optional). Standard is "matrix".
+
+bool ReadNumDataFunc(CCLUCodeBase& rCB, CCodeVar& rVar, CCodeVar& rPars, int iLine, int iPos)
+{
+	CStrMem csFilename, csSep, csType;
+	TVarList& mVars = *rPars.GetVarListPtr();
+	TCVCounter iVal;
+
+	int iVarCount = int(mVars.Count());
+
+	if ((iVarCount < 1) || (iVarCount > 5))
 	{
-		cVal = (char) zData.get();
-		//zData.getline(pcLine, 299);
-		if (zData.eof() && (pcLine[0] == 0))
+		int piPar[] = { 1, 2, 3, 4, 5 };
+
+		rCB.GetErrorList().WrongNoOfParams(piPar, 5, iLine, iPos);
+		return false;
+	}
+
+	if (mVars(0).BaseType() != PDT_STRING)
+	{
+		rCB.GetErrorList().InvalidParType(mVars(0), 1, iLine, iPos);
+		return false;
+	}
+
+	csFilename = mVars(0).ValStr();
+	csSep      = ",;";
+	csType     = "matrix";
+
+	if (iVarCount >= 2)
+	{
+		if (mVars(1).BaseType() != PDT_STRING)
 		{
-			break;
+			rCB.GetErrorList().InvalidParType(mVars(1), 2, iLine, iPos);
+			return false;
 		}
-		else if (zData.eof())
+
+		csSep = mVars(1).ValStr();
+	}
+
+	std::vector<int> vecCol;
+	if (iVarCount >= 3)
+	{
+		if (mVars(2).BaseType() != PDT_VARLIST)
 		{
-			cVal = pcSep[0];
+			rCB.GetErrorList().InvalidParType(mVars(2), 3, iLine, iPos);
+			return false;
 		}
 
-		if (((cVal == pcSep[0]) || (cVal == '\n')) && (pcLine[0] != 0))
+		TVarList& rList = *mVars(2).GetVarListPtr();
+		for (int iIdx = 0; iIdx < int(rList.Count()); ++iIdx)
 		{
-			if (sscanf_s(pcLine, "%lg", &dVal) == 1)
+			if (!rList(iIdx).CastToCounter(iVal) || (iVal < 1))
 			{
-				if (iCol == -2)
-				{
-					iRowCount = int(dVal);
-				}
-				else if (iCol == -1)
-				{
-					iColCount = int(dVal);
-					if (iRowCount <= 0)
-					{
-						rCB.GetErrorList().GeneralError("Invalid row size of matrix.", iLine, iPos);
-						return false;
-					}
-					if (iColCount <= 0)
-					{
-						rCB.GetErrorList().GeneralError("Invalid column size of matrix.", iLine, iPos);
-						return false;
-					}
-					DMatrix.Resize(iRowCount, iColCount);
-				}
-				else if ((iRow >= 0) && (iRow < iRowCount) &&
-					 (iCol >= 0) && (iCol < iColCount))
-				{
-					DMatrix(iRow + 1, iCol + 1) = TCVScalar(dVal);
-				}
+				rCB.GetErrorList().InvalidParVal(mVars(2), 3, iLine, iPos);
+				return false;
 			}
-			iLineLen  = 0;
-			pcLine[0] = 0;
-			iCol++;
+
+			vecCol.push_back(int(iVal) - 1);
+		}
+	}
+
+	size_t nFirstLine = 0, nLastLine = CNumFileParser::LINE_END;
+	if (iVarCount >= 4)
+	{
+		if (mVars(3).BaseType() != PDT_VARLIST)
+		{
+			rCB.GetErrorList().InvalidParType(mVars(3), 4, iLine, iPos);
+			return false;
+		}
+
+		TVarList& rList = *mVars(3).GetVarListPtr();
+		int iCount = int(rList.Count());
+
+		if (iCount > 2)
+		{
+			rCB.GetErrorList().InvalidParVal(mVars(3), 4, iLine, iPos);
+			return false;
 		}
-		else if ((cVal != pcSep[0]) && (cVal != '\n'))
+
+		if (iCount >= 1)
 		{
-			pcLine[iLineLen]   = cVal;
-			pcLine[++iLineLen] = 0;
+			if (!rList(0).CastToCounter(iVal) || (iVal < 1))
+			{
+				rCB.GetErrorList().InvalidParVal(mVars(3), 4, iLine, iPos);
+				return false;
+			}
+
+			nFirstLine = size_t(iVal) - 1;
 		}
 
-		if (cVal == '\n')
+		if (iCount >= 2)
 		{
-			if (iCol < 0)
+			if (!rList(1).CastToCounter(iVal) || (iVal < 1) || (size_t(iVal) - 1 < nFirstLine))
 			{
-				rCB.GetErrorList().GeneralError("Matrix dimensions not specified.", iLine, iPos);
+				rCB.GetErrorList().InvalidParVal(mVars(3), 4, iLine, iPos);
 				return false;
 			}
-			iRow++;
-			iCol = 0;
+
+			nLastLine = size_t(iVal) - 1;
 		}
 	}
-	while (!zData.eof());
 
-	zData.close();
+	if (iVarCount >= 5)
+	{
+		if (mVars(4).BaseType() != PDT_STRING)
+		{
+			rCB.GetErrorList().InvalidParType(mVars(4), 5, iLine, iPos);
+			return false;
+		}
+
+		csType = mVars(4).ValStr();
+		if ((csType != "matrix") && (csType != "tensor"))
+		{
+			rCB.GetErrorList().InvalidParVal(mVars(4), 5, iLine, iPos);
+			return false;
+		}
+	}
+
+	CMappedFile xFile;
+	CNumFileParser xParser;
+	char pcCurPath[500];
+
+	_getcwd(pcCurPath, 499);
+	_chdir(rCB.GetScriptPath().c_str());
+
+	xFile.Open(csFilename.Str());
 
 	_chdir(pcCurPath);
 
+	if (!xFile.IsOpen())
+	{
+		char pcText[500];
+		sprintf_s(pcText, "Data file '%s' could not be opened.", csFilename.Str());
+
+		rCB.GetErrorList().GeneralError(pcText);
+		return false;
+	}
+
+	xParser.SetSeparators(csSep.Str());
+	xParser.SetColumns(vecCol);
+	xParser.SetLineRange(nFirstLine, nLastLine);
+
+	if (!xParser.Parse(xFile.GetData(), xFile.GetSize()))
+	{
+		rCB.GetErrorList().GeneralError(xParser.GetError().c_str(), iLine, iPos);
+		return false;
+	}
+
+	if ((xParser.GetRowCount() == 0) || (xParser.GetColCount() == 0))
+	{
+		rCB.GetErrorList().GeneralError("Data file contains no values in the given lines.", iLine, iPos);
+		return false;
+	}
+
+	if ((xParser.GetRowCount() > size_t(INT_MAX)) || (xParser.GetColCount() > size_t(INT_MAX)))
+	{
+		rCB.GetErrorList().GeneralError("Data file contains too many values.", iLine, iPos);
+		return false;
+	}
+
+	int iRowCount = int(xParser.GetRowCount());
+	int iColCount = int(xParser.GetColCount());
+
+	try
+	{
+		if (csType == "tensor")
+		{
+			Mem<int> mDim;
+
+			mDim.Set(2);
+			mDim[0] = iRowCount;
+			mDim[1] = iColCount;
+
+			rVar.New(PDT_TENSOR);
+			TTensor& rT = *rVar.GetTensorPtr();
+
+			rT.Reset(mDim);
+			xParser.CopyTo(rT.Data());
+		}
+		else
+		{
+			rVar.New(PDT_MATRIX);
+			TMatrix& rM = *rVar.GetMatrixPtr();
+
+			if (!rM.Resize(iRowCount, iColCount))
+			{
+				rCB.GetErrorList().GeneralError("Not enough memory for matrix.", iLine, iPos);
+				return false;
+			}
+
+			xParser.CopyTo(rM.Data());
+		}
+	}
+	catch (...)
+	{
+		rCB.GetErrorList().GeneralError("Not enough memory for data.", iLine, iPos);
+		return false;
+	}
+
 	return true;
 }
 
@@ -26,12 +26,18 @@
 
 #pragma once
 
+#include <vector>
+
+class CChunkFileWriter;
+class CChunkFileReader;
+
 bool GetDirListFunc(CCLUCodeBase& rCB, CCodeVar& rVar, CCodeVar& rPars, int iLine, int iPos);
 
 bool ReadDataFunc(CCLUCodeBase& rCB, CCodeVar& rVar, CCodeVar& rPars, int iLine, int iPos);
 bool WriteDataFunc(CCLUCodeBase& rCB, CCodeVar& rVar, CCodeVar& rPars, int iLine, int iPos);
 
 bool ReadMatrixFunc(CCLUCodeBase& rCB, CCodeVar& rVar, CCodeVar& rPars, int iLine, int iPos);
+bool ReadNumDataFunc(CCLUCodeBase& rCB, CCodeVar& rVar, CCodeVar& rPars, int iLine, int iPos);
 
 bool WriteVariableFunc(CCLUCodeBase& rCB, CCodeVar& rVar, CCodeVar& rPars, int iLine, int iPos);
 bool ReadVariableFunc(CCLUCodeBase& rCB, CCodeVar& rVar, CCodeVar& rPars, int iLine, int iPos);
@@ -50,6 +56,9 @@ void WriteVariable(CCLUCodeBase& rCB, Mem<char>& mData, CCodeVar& rVar, int iPIL
 void WriteVariable(CCLUCodeBase& rCB, CXMLTree& rXMLTree, CCodeVar& rVar, int iPos) throw(CCluException);
 void ReadVariable(CCLUCodeBase& rCB, CCodeVar& rVar, char** ppcData) throw(CCluException);
 void ReadVariable(CCLUCodeBase& rCB, CCodeVar& rVar, CXMLElement& rEl) throw(CCluException);
+void WriteVariable(CCLUCodeBase& rCB, CChunkFileWriter& xFile, Mem<char>& mData, CCodeVar& rVar) throw(CCluException);
+void ReadVariable(CCLUCodeBase& rCB, CCodeVar& rVar, CChunkFileReader& xFile, Mem<char>& mData, size_t nPos) throw(CCluException);
+size_t FindVariable(Mem<char>& mData, size_t nPos, const std::vector<int>& vecPath) throw(CCluException);
 void ReadXMLTree(CCLUCodeBase& rCB, TVarList& rList, CXMLTree& rTree, int iLine, int iPos) throw(CCluException);
 void WriteXMLTree(CCLUCodeBase& rCB, TVarList& rList, CXMLTree& rTree, int iLine, int iPos) throw(CCluException);
 
@@ -862,6 +862,94 @@ bool  GetMVIndicesFunc(CCLUCodeBase& rCB, CCodeVar& rVar, CCodeVar& rPars, int i
 	return true;
 }
 
+//////////////////////////////////////////////////////////////////////
+/// Apply a versor to a list of multivectors
+//
+// Evaluates R & X & ~R for all multivectors X in the list. The versor is
+// converted into a linear map, which is applied to all multivectors at
+// once with SIMD instructions.
+
+bool  ApplyVersorFunc(CCLUCodeBase& rCB, CCodeVar& rVar, CCodeVar& rPars, int iLine, int iPos)
+{
+	TVarList& mVars = *rPars.GetVarListPtr();
+
+	int iVarCount = int(mVars.Count());
+
+	if (iVarCount != 2)
+	{
+		rCB.GetErrorList().WrongNoOfParams(2, iLine, iPos);
+		return false;
+	}
+
+	if (mVars(0).BaseType() != PDT_MULTIV)
+	{
+		rCB.GetErrorList().InvalidParType(mVars(0), 1, iLine, iPos);
+		return false;
+	}
+
+	if (mVars(1).BaseType() != PDT_VARLIST)
+	{
+		rCB.GetErrorList().InvalidParType(mVars(1), 2, iLine, iPos);
+		return false;
+	}
+
+	TMultiV& vR     = *mVars(0).GetMultiVPtr();
+	TVarList& rList = *mVars(1).GetVarListPtr();
+
+	int iIdx, iCnt = int(rList.Count());
+	uint uGradeMask = 0;
+
+	for (iIdx = 0; iIdx < iCnt; iIdx++)
+	{
+		if (rList(iIdx).BaseType() != PDT_MULTIV)
+		{
+			rCB.GetErrorList().GeneralError("Expect list of multivectors.", iLine, iPos);
+			return false;
+		}
+
+		TMultiV& vX = *rList(iIdx).GetMultiVPtr();
+		if (vX.GetGADim() != vR.GetGADim())
+		{
+			rCB.GetErrorList().GeneralError("Multivectors in list have to be of same space as versor.", iLine, iPos);
+			return false;
+		}
+
+		uGradeMask |= vX.GradeMask();
+	}
+
+	MultiVBatch<TCVScalar> mbX, mbY;
+
+	if (!mbX.Create(vR.GetStyle(), uGradeMask, size_t(iCnt)))
+	{
+		rCB.GetErrorList().OutOfMemory(iLine, iPos);
+		return false;
+	}
+
+	for (iIdx = 0; iIdx < iCnt; iIdx++)
+	{
+		mbX.SetMultiV(size_t(iIdx), *rList(iIdx).GetMultiVPtr());
+	}
+
+	if (!ApplyVersor(vR, mbX, mbY))
+	{
+		rCB.GetErrorList().GeneralError("Error applying versor.", iLine, iPos);
+		return false;
+	}
+
+	rVar.New(PDT_VARLIST);
+	TVarList& rRetList = *rVar.GetVarListPtr();
+	rRetList.Set(iCnt);
+
+	TMultiV vY;
+	for (iIdx = 0; iIdx < iCnt; iIdx++)
+	{
+		mbY.GetMultiV(size_t(iIdx), vY);
+		rRetList(iIdx) = vY;
+	}
+
+	return true;
+}
+
 //////////////////////////////////////////////////////////////////////
 /// Factorize a multivector blade
 // TODO: Update docu for FactorizeBlade. Now also for null blades.
@@ -45,4 +45,6 @@ bool GenerateMaskFunc(CCLUCodeBase &rCB, CCodeVar& rVar, CCodeVar& rPars, int iL
 
 bool FactorBladeFunc(CCLUCodeBase &rCB, CCodeVar& rVar, CCodeVar& rPars, int iLine, int iPos);
 
+bool ApplyVersorFunc(CCLUCodeBase &rCB, CCodeVar& rVar, CCodeVar& rPars, int iLine, int iPos);
+
 bool AnalyzeMVFunc(CCLUCodeBase &rCB, CCodeVar& rVar, CCodeVar& rPars, int iLine, int iPos);
@@ -30,6 +30,7 @@
 #include <algorithm>
 
 #include "CluTec.Viz.Base\TensorOperators.h"
+#include "CluTec.Viz.Base\matkernel.h"
 
 using std::sort;
 
@@ -1336,6 +1337,61 @@ bool  DetFunc(CCLUCodeBase& rCB, CCodeVar& rVar, CCodeVar& rPars, int iLine, int
 	return true;
 }
 
+//////////////////////////////////////////////////////////////////////
+/// Select Matrix Kernels
+//
+// Parameters:
+//	1. Kernels used for matrix products and decompositions:
+//	   0: original loops, 1: blocked and vectorized, 2: blocked, vectorized and multithreaded
+//	2. (opt.) Number of threads. Zero uses one thread per hardware thread.
+//
+// The kernels are set for this plugin and for the module of the code base,
+// since both evaluate matrix operations.
+
+bool SetMatrixKernelFunc(CCLUCodeBase& rCB, CCodeVar& rVar, CCodeVar& rPars, int iLine, int iPos)
+{
+	TVarList& mVars = *rPars.GetVarListPtr();
+	int iVarCount   = int(mVars.Count());
+	TCVCounter iKernel, iThreadCount = -1;
+
+	if ((iVarCount < 1) || (iVarCount > 2))
+	{
+		rCB.GetErrorList().WrongNoOfParams(1, iLine, iPos);
+		return false;
+	}
+
+	if (!mVars(0).CastToCounter(iKernel))
+	{
+		rCB.GetErrorList().InvalidParType(mVars(0), 1, iLine, iPos);
+		return false;
+	}
+
+	if ((iKernel < int(MATKERNEL_REFERENCE)) || (iKernel > int(MATKERNEL_PARALLEL)))
+	{
+		rCB.GetErrorList().GeneralError("Matrix kernel has to be 0, 1 or 2.", iLine, iPos);
+		return false;
+	}
+
+	if (iVarCount > 1)
+	{
+		if (!mVars(1).CastToCounter(iThreadCount) || (iThreadCount < 0))
+		{
+			rCB.GetErrorList().InvalidParType(mVars(1), 2, iLine, iPos);
+			return false;
+		}
+	}
+
+	SetMatrixKernel(EMatrixKernel(iKernel));
+	if (iThreadCount >= 0)
+	{
+		CMatrixThreadPool::Global().SetThreadCount(uint(iThreadCount));
+	}
+
+	rCB.SetMatrixKernel(int(iKernel), int(iThreadCount));
+
+	return true;
+}
+
 //////////////////////////////////////////////////////////////////////
 /// SVD of Matrix
 
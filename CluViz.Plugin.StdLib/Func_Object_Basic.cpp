@@ -460,6 +460,9 @@ bool  GetVexListDataFunc(CCLUCodeBase& rCB, CCodeVar& rVar, CCodeVar& rPars, int
 	//mTex = pVexList->GetTexList();
 	//mNorm = pVexList->GetNormList();
 	//mCol = pVexList->GetColList();
+	// Use the newest frame of a shared vertex buffer
+	pVexList->UpdateSharedVex();
+
 	mIdx = pVexList->GetIdxList();
 
 	mDimVex.Set(2);
@@ -492,7 +495,7 @@ bool  GetVexListDataFunc(CCLUCodeBase& rCB, CCodeVar& rVar, CCodeVar& rPars, int
 	// Get vertex data
 	for (iVex = 0, iVexPos = 0; iVex < iVexCnt; ++iVex, iVexPos += 3)
 	{
-		COGLVertex& rVex = rVexList[iVex].xVex;
+		COGLVertex rVex = rVexList.GetVex(iVex);
 		pdVex[iVexPos]     = rVex[0];
 		pdVex[iVexPos + 1] = rVex[1];
 		pdVex[iVexPos + 2] = rVex[2];
@@ -501,7 +504,7 @@ bool  GetVexListDataFunc(CCLUCodeBase& rCB, CCodeVar& rVar, CCodeVar& rPars, int
 	// Get texture coordinate data
 	for (iTex = 0, iTexPos = 0; iTex < iTexCnt; ++iTex, iTexPos += 2)
 	{
-		COGLVertex& rTex = rVexList[iTex].xTex;
+		COGLVertex rTex = rVexList.GetTex(iTex);
 		pdTex[iTexPos]     = rTex[0];
 		pdTex[iTexPos + 1] = rTex[1];
 	}
@@ -509,7 +512,7 @@ bool  GetVexListDataFunc(CCLUCodeBase& rCB, CCodeVar& rVar, CCodeVar& rPars, int
 	// Get normal data
 	for (iNorm = 0, iNormPos = 0; iNorm < iNormCnt; ++iNorm, iNormPos += 3)
 	{
-		COGLVertex& rNorm = rVexList[iNorm].xNorm;
+		COGLVertex rNorm = rVexList.GetNormal(iNorm);
 		pdNorm[iNormPos]     = rNorm[0];
 		pdNorm[iNormPos + 1] = rNorm[1];
 		pdNorm[iNormPos + 2] = rNorm[2];
@@ -518,7 +521,7 @@ bool  GetVexListDataFunc(CCLUCodeBase& rCB, CCodeVar& rVar, CCodeVar& rPars, int
 	// Get color data
 	for (iCol = 0, iColPos = 0; iCol < iColCnt; ++iCol, iColPos += 4)
 	{
-		TColor& rCol = rVexList[iCol].xCol;
+		TColor rCol = rVexList.GetCol(iCol);
 		pdCol[iColPos]     = rCol[0];
 		pdCol[iColPos + 1] = rCol[1];
 		pdCol[iColPos + 2] = rCol[2];
@@ -721,6 +724,132 @@ bool  SetVexListPolyModeFunc(CCLUCodeBase& rCB, CCodeVar& rVar, CCodeVar& rPars,
 	return true;
 }
 
+//////////////////////////////////////////////////////////////////////
+// Set vertex list storage layout
+//
+// Pars:
+// 1. (vexlist) the vertex list
+// 2. (opt)(string) layout: 'interleaved' or 'separate'
+// 3. (opt)(string) color format in separate layout: 'float' or 'rgba8'
+// 4. (opt)(string) normal format in separate layout: 'float' or 'short'
+//
+// Return:
+//	the vertex list, or the current layout if only the vertex list is given
+
+bool  SetVexListStorageFunc(CCLUCodeBase& rCB, CCodeVar& rVar, CCodeVar& rPars, int iLine, int iPos)
+{
+	TVarList& mVars = *rPars.GetVarListPtr();
+
+	int iVarCount = int(mVars.Count());
+
+	if ((iVarCount < 1) || (iVarCount > 4))
+	{
+		int piPar[] = { 1, 2, 3, 4 };
+
+		rCB.GetErrorList().WrongNoOfParams(piPar, 4, iLine, iPos);
+		return false;
+	}
+
+	if (mVars(0).BaseType() != PDT_SCENE)
+	{
+		rCB.GetErrorList().GeneralError("First parameter has to be a object.", iLine, iPos);
+		return false;
+	}
+
+	TScene scVL              = *mVars(0).GetScenePtr();
+	COGLVertexList* pVexList = dynamic_cast<COGLVertexList*>((COGLBaseElement*) scVL);
+
+	if (!pVexList)
+	{
+		rCB.GetErrorList().GeneralError("First parameter is not an object.", iLine, iPos);
+		return false;
+	}
+
+	if (iVarCount == 1)
+	{
+		if (pVexList->GetLayout() == COGLVertexList::LAYOUT_SEPARATE)
+		{
+			rVar = "separate";
+		}
+		else
+		{
+			rVar = "interleaved";
+		}
+
+		return true;
+	}
+
+	for (int iVar = 1; iVar < iVarCount; ++iVar)
+	{
+		if (mVars(iVar).BaseType() != PDT_STRING)
+		{
+			rCB.GetErrorList().InvalidParType(mVars(iVar), iVar + 1, iLine, iPos);
+			return false;
+		}
+	}
+
+	COGLVertexList::ELayout eLayout;
+	TString csValue = *mVars(1).GetStringPtr();
+
+	if (csValue == "interleaved")
+	{
+		eLayout = COGLVertexList::LAYOUT_INTERLEAVED;
+	}
+	else if (csValue == "separate")
+	{
+		eLayout = COGLVertexList::LAYOUT_SEPARATE;
+	}
+	else
+	{
+		rCB.GetErrorList().GeneralError("Unknown object storage layout. Has to be one of: 'interleaved', 'separate'.", iLine, iPos);
+		return false;
+	}
+
+	if (iVarCount >= 3)
+	{
+		csValue = *mVars(2).GetStringPtr();
+
+		if (csValue == "float")
+		{
+			pVexList->SetColorFormat(COGLVertexList::COLFMT_FLOAT);
+		}
+		else if (csValue == "rgba8")
+		{
+			pVexList->SetColorFormat(COGLVertexList::COLFMT_RGBA8);
+		}
+		else
+		{
+			rCB.GetErrorList().GeneralError("Unknown color format. Has to be one of: 'float', 'rgba8'.", iLine, iPos);
+			return false;
+		}
+	}
+
+	if (iVarCount >= 4)
+	{
+		csValue = *mVars(3).GetStringPtr();
+
+		if (csValue == "float")
+		{
+			pVexList->SetNormalFormat(COGLVertexList::NORMFMT_FLOAT);
+		}
+		else if (csValue == "short")
+		{
+			pVexList->SetNormalFormat(COGLVertexList::NORMFMT_SHORT);
+		}
+		else
+		{
+			rCB.GetErrorList().GeneralError("Unknown normal format. Has to be one of: 'float', 'short'.", iLine, iPos);
+			return false;
+		}
+	}
+
+	pVexList->SetLayout(eLayout);
+
+	rVar = scVL;
+
+	return true;
+}
+
 //////////////////////////////////////////////////////////////////////
 // Set vertex list scaling
 //
@@ -999,3 +1128,261 @@ bool SetVexListLineStippleFunc(CCLUCodeBase& rCB, CCodeVar& rVar, CCodeVar& rPar
 
 	return true;
 }
+
+//////////////////////////////////////////////////////////////////////
+// Set a range of vertex attributes
+//
+// Only the modified range of the attribute is copied to the vertex buffer
+// when the object is drawn the next time. If the object has no values of the
+// attribute yet, the attribute is added for all vertices, with zero values
+// for the vertices that are not set.
+//
+// Pars:
+// 1. (vexlist) the vertex list
+// 2. (string) the attribute: 'vex', 'tex', 'norm' or 'col'
+// 3. (counter) index of first vertex, starting at 1
+// 4. (list) the values. Vertices and normals are given as lists of 3 scalars,
+//		texture coordinates as lists of 2 or 3 scalars and colors as colors
+//		or lists of 3 or 4 scalars.
+//
+// Return:
+//	the vertex list
+
+bool  SetVexListAttributeFunc(CCLUCodeBase& rCB, CCodeVar& rVar, CCodeVar& rPars, int iLine, int iPos)
+{
+	TVarList& mVars = *rPars.GetVarListPtr();
+
+	int iVarCount = int(mVars.Count());
+	TCVCounter iFirst;
+
+	if (iVarCount != 4)
+	{
+		int piPar[] = { 4 };
+
+		rCB.GetErrorList().WrongNoOfParams(piPar, 1, iLine, iPos);
+		return false;
+	}
+
+	if (mVars(0).BaseType() != PDT_SCENE)
+	{
+		rCB.GetErrorList().GeneralError("First parameter has to be an object.", iLine, iPos);
+		return false;
+	}
+
+	TScene scVL              = *mVars(0).GetScenePtr();
+	COGLVertexList* pVexList = dynamic_cast<COGLVertexList*>((COGLBaseElement*) scVL);
+
+	if (!pVexList)
+	{
+		rCB.GetErrorList().GeneralError("First parameter is not an object.", iLine, iPos);
+		return false;
+	}
+
+	if (mVars(1).BaseType() != PDT_STRING)
+	{
+		rCB.GetErrorList().GeneralError("Second parameter has to give the attribute: 'vex', 'tex', 'norm' or 'col'.", iLine, iPos);
+		return false;
+	}
+
+	COGLVertexList::EAttribute eAttr;
+	int iMinDim, iMaxDim, iAttrCnt;
+	TString csAttr = *mVars(1).GetStringPtr();
+
+	if (csAttr == "vex")
+	{
+		eAttr    = COGLVertexList::ATTR_VEX;
+		iMinDim  = iMaxDim = 3;
+		iAttrCnt = pVexList->GetVexCount();
+	}
+	else if (csAttr == "tex")
+	{
+		eAttr    = COGLVertexList::ATTR_TEX;
+		iMinDim  = 2;
+		iMaxDim  = 3;
+		iAttrCnt = pVexList->GetTexCount();
+	}
+	else if (csAttr == "norm")
+	{
+		eAttr    = COGLVertexList::ATTR_NORM;
+		iMinDim  = iMaxDim = 3;
+		iAttrCnt = pVexList->GetNormCount();
+	}
+	else if (csAttr == "col")
+	{
+		eAttr    = COGLVertexList::ATTR_COL;
+		iMinDim  = 3;
+		iMaxDim  = 4;
+		iAttrCnt = pVexList->GetColCount();
+	}
+	else
+	{
+		rCB.GetErrorList().GeneralError("Unknown object attribute. Has to be one of: 'vex', 'tex', 'norm', 'col'.", iLine, iPos);
+		return false;
+	}
+
+	if (!mVars(2).CastToCounter(iFirst))
+	{
+		rCB.GetErrorList().InvalidParType(mVars(2), 3, iLine, iPos);
+		return false;
+	}
+
+	if (mVars(3).BaseType() != PDT_VARLIST)
+	{
+		rCB.GetErrorList().GeneralError("Fourth parameter has to be a list of values.", iLine, iPos);
+		return false;
+	}
+
+	TVarList& rValList = *mVars(3).GetVarListPtr();
+	int iValCnt        = int(rValList.Count());
+	int iVexCnt        = pVexList->GetVexCount();
+
+	if ((iFirst < 1) || (iFirst - 1 + iValCnt > iVexCnt))
+	{
+		rCB.GetErrorList().GeneralError("Range of vertices to set exceeds the number of vertices of the object.", iLine, iPos);
+		return false;
+	}
+
+	for (int iVal = 0; iVal < iValCnt; ++iVal)
+	{
+		CCodeVar& rVal = rValList(iVal);
+		float pfVal[4] = { 0.0f, 0.0f, 0.0f, 1.0f };
+
+		if (eAttr == COGLVertexList::ATTR_COL && rVal.BaseType() == PDT_COLOR)
+		{
+			memcpy(pfVal, rVal.GetOGLColorPtr()->Data(), 4 * sizeof(float));
+		}
+		else
+		{
+			if (rVal.BaseType() != PDT_VARLIST)
+			{
+				rCB.GetErrorList().GeneralError("Values have to be given as lists of scalars.", iLine, iPos);
+				return false;
+			}
+
+			TVarList& rComps = *rVal.GetVarListPtr();
+			int iComp, iCompCnt = int(rComps.Count());
+			TCVScalar dVal;
+
+			if ((iCompCnt < iMinDim) || (iCompCnt > iMaxDim))
+			{
+				rCB.GetErrorList().GeneralError("Value has wrong number of components.", iLine, iPos);
+				return false;
+			}
+
+			for (iComp = 0; iComp < iCompCnt; ++iComp)
+			{
+				if (!rComps(iComp).CastToScalar(dVal, rCB.GetSensitivity()))
+				{
+					rCB.GetErrorList().GeneralError("Components of values have to be scalars.", iLine, iPos);
+					return false;
+				}
+
+				pfVal[iComp] = float(dVal);
+			}
+		}
+
+		size_t nIdx = size_t(iFirst - 1 + iVal);
+		bool bOK;
+
+		if (eAttr == COGLVertexList::ATTR_COL)
+		{
+			TColor xCol;
+			xCol = (const float*) pfVal;
+			bOK  = pVexList->SetCol(nIdx, xCol);
+		}
+		else
+		{
+			COGLVertex xVex;
+			xVex.Set(pfVal[0], pfVal[1], pfVal[2]);
+
+			if (eAttr == COGLVertexList::ATTR_VEX)
+			{
+				bOK = pVexList->SetVex(nIdx, xVex);
+			}
+			else if (eAttr == COGLVertexList::ATTR_TEX)
+			{
+				bOK = pVexList->SetTex(nIdx, xVex);
+			}
+			else
+			{
+				bOK = pVexList->SetNormal(nIdx, xVex);
+			}
+		}
+
+		if (!bOK)
+		{
+			rCB.GetErrorList().GeneralError("Error setting object attribute.", iLine, iPos);
+			return false;
+		}
+	}
+
+	// Use attribute for all vertices
+	if ((iAttrCnt == 0) && (iValCnt > 0))
+	{
+		switch (eAttr)
+		{
+		case COGLVertexList::ATTR_TEX:
+			pVexList->UpdateTexCount();
+			break;
+
+		case COGLVertexList::ATTR_NORM:
+			pVexList->UpdateNormCount();
+			break;
+
+		case COGLVertexList::ATTR_COL:
+			pVexList->UpdateColCount();
+			break;
+
+		default:
+			break;
+		}
+	}
+
+	rVar = scVL;
+
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Get the number of bytes copied to the vertex buffer of an object
+// by the last draw that copied any data.
+//
+// Pars:
+// 1. (vexlist) the vertex list
+//
+// Return:
+//	the number of bytes
+
+bool  GetVexListUploadSizeFunc(CCLUCodeBase& rCB, CCodeVar& rVar, CCodeVar& rPars, int iLine, int iPos)
+{
+	TVarList& mVars = *rPars.GetVarListPtr();
+
+	int iVarCount = int(mVars.Count());
+
+	if (iVarCount != 1)
+	{
+		int piPar[] = { 1 };
+
+		rCB.GetErrorList().WrongNoOfParams(piPar, 1, iLine, iPos);
+		return false;
+	}
+
+	if (mVars(0).BaseType() != PDT_SCENE)
+	{
+		rCB.GetErrorList().GeneralError("First parameter has to be an object.", iLine, iPos);
+		return false;
+	}
+
+	TScene scVL              = *mVars(0).GetScenePtr();
+	COGLVertexList* pVexList = dynamic_cast<COGLVertexList*>((COGLBaseElement*) scVL);
+
+	if (!pVexList)
+	{
+		rCB.GetErrorList().GeneralError("First parameter is not an object.", iLine, iPos);
+		return false;
+	}
+
+	rVar = TCVCounter(pVexList->GetLastUploadSize());
+
+	return true;
+}
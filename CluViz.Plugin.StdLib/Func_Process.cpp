@@ -1242,3 +1242,52 @@ bool  GetBMPBoundingBoxFunc(CCLUCodeBase& rCB, CCodeVar& rVar, CCodeVar& rPars,
 
 	return true;
 }
+
+//////////////////////////////////////////////////////////////////////
+/// Select Image Kernels
+///
+/// Parameters:
+///		1. Kernels used by the pixel operators of images:
+///		   0: per pixel loops, 1: vectorized, 2: vectorized and multithreaded for large images
+///		2. (opt.) Number of threads. Zero uses one thread per hardware thread.
+///
+
+bool  SetImageKernelFunc(CCLUCodeBase& rCB, CCodeVar& rVar, CCodeVar& rPars, int iLine, int iPos)
+{
+	TVarList& mVars = *rPars.GetVarListPtr();
+	int iVarCount   = int(mVars.Count());
+	TCVCounter iKernel, iThreadCount = -1;
+
+	if ((iVarCount < 1) || (iVarCount > 2))
+	{
+		int piPar[] = { 1, 2 };
+
+		rCB.GetErrorList().WrongNoOfParams(piPar, 2, iLine, iPos);
+		return false;
+	}
+
+	if (!mVars(0).CastToCounter(iKernel))
+	{
+		rCB.GetErrorList().InvalidParType(mVars(0), 1, iLine, iPos);
+		return false;
+	}
+
+	if ((iKernel < int(COGLImage::PIXKERNEL_SCALAR)) || (iKernel > int(COGLImage::PIXKERNEL_PARALLEL)))
+	{
+		rCB.GetErrorList().GeneralError("Image kernel has to be 0, 1 or 2.", iLine, iPos);
+		return false;
+	}
+
+	if (iVarCount > 1)
+	{
+		if (!mVars(1).CastToCounter(iThreadCount) || (iThreadCount < 0))
+		{
+			rCB.GetErrorList().InvalidParType(mVars(1), 2, iLine, iPos);
+			return false;
+		}
+	}
+
+	COGLImage::SetPixelKernel(COGLImage::EPixelKernel(iKernel), int(iThreadCount));
+
+	return true;
+}
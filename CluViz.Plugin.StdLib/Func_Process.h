@@ -41,3 +41,4 @@ bool GetBMPBoundingBoxFunc(CCLUCodeBase& rCB, CCodeVar& rVar, CCodeVar& rPars, i
 bool ClearBMPFunc(CCLUCodeBase& rCB, CCodeVar& rVar, CCodeVar& rPars, int iLine, int iPos);
 
 bool SampleImgAreaFunc(CCLUCodeBase& rCB, CCodeVar& rVar, CCodeVar& rPars, int iLine, int iPos);
+bool SetImageKernelFunc(CCLUCodeBase& rCB, CCodeVar& rVar, CCodeVar& rPars, int iLine, int iPos);
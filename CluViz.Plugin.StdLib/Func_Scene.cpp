@@ -797,6 +797,344 @@ bool EnableScenePickTargetFunc(CCLUCodeBase& rCB, CCodeVar& rVar, CCodeVar& rPar
 	return true;
 }
 
+//////////////////////////////////////////////////////////////////////
+// Enable/Disable the bounding volume hierarchy for CPU picking of a scene.
+// The hierarchy is updated whenever the scene is drawn.
+
+bool EnableScenePickBVHFunc(CCLUCodeBase& rCB, CCodeVar& rVar, CCodeVar& rPars, int iLine, int iPos)
+{
+	TVarList& mVars = *rPars.GetVarListPtr();
+
+	int iVarCount      = int(mVars.Count());
+	TCVCounter iEnable = 1;
+
+	if ((iVarCount < 1) || (iVarCount > 2))
+	{
+		int piPar[] = { 1, 2 };
+
+		rCB.GetErrorList().WrongNoOfParams(piPar, 2, iLine, iPos);
+		return false;
+	}
+
+	if (mVars(0).BaseType() != PDT_SCENE)
+	{
+		rCB.GetErrorList().GeneralError("Expect a scene variable as parameter.", iLine, iPos);
+		return false;
+	}
+
+	if (iVarCount > 1)
+	{
+		if (!mVars(1).CastToCounter(iEnable))
+		{
+			rCB.GetErrorList().GeneralError("Expect true or false as second parameter.", iLine, iPos);
+			return false;
+		}
+	}
+
+	COGLBEReference Scene = *mVars(0).GetScenePtr();
+
+	if (!Scene.IsValid())
+	{
+		rCB.GetErrorList().GeneralError("Scene is not valid.", iLine, iPos);
+		return false;
+	}
+
+	COGLScene* pScene = dynamic_cast< COGLScene* >((COGLBaseElement*) Scene);
+	if (!pScene)
+	{
+		rCB.GetErrorList().GeneralError("Scene is not valid.", iLine, iPos);
+		return false;
+	}
+
+	pScene->EnablePickBVH(iEnable != 0);
+
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Enable/Disable drawing a scene with a render queue, which draws the objects
+// of the scene and of its sub-scenes sorted by their colors, materials,
+// textures and shaders. Transparent objects are drawn from back to front.
+
+bool EnableSceneBufferFunc(CCLUCodeBase& rCB, CCodeVar& rVar, CCodeVar& rPars, int iLine, int iPos)
+{
+	TVarList& mVars = *rPars.GetVarListPtr();
+
+	int iVarCount      = int(mVars.Count());
+	TCVCounter iEnable = 1;
+
+	if ((iVarCount < 1) || (iVarCount > 2))
+	{
+		int piPar[] = { 1, 2 };
+
+		rCB.GetErrorList().WrongNoOfParams(piPar, 2, iLine, iPos);
+		return false;
+	}
+
+	if (mVars(0).BaseType() != PDT_SCENE)
+	{
+		rCB.GetErrorList().GeneralError("Expect a scene variable as parameter.", iLine, iPos);
+		return false;
+	}
+
+	if (iVarCount > 1)
+	{
+		if (!mVars(1).CastToCounter(iEnable))
+		{
+			rCB.GetErrorList().GeneralError("Expect true or false as second parameter.", iLine, iPos);
+			return false;
+		}
+	}
+
+	COGLBEReference Scene = *mVars(0).GetScenePtr();
+
+	if (!Scene.IsValid())
+	{
+		rCB.GetErrorList().GeneralError("Scene is not valid.", iLine, iPos);
+		return false;
+	}
+
+	COGLScene* pScene = dynamic_cast< COGLScene* >((COGLBaseElement*) Scene);
+	if (!pScene)
+	{
+		rCB.GetErrorList().GeneralError("Scene is not valid.", iLine, iPos);
+		return false;
+	}
+
+	pScene->EnableBufferScene(iEnable != 0);
+
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Evaluate a pick ray on the CPU
+//
+// Parameters:
+//	1. A scene with enabled pick hierarchy, or a list of objects
+//	2. The ray origin as E3 vector
+//	3. The ray direction as E3 vector
+//	4. (opt) The distance from the ray at which points and lines are still hit
+//
+// For a scene the ray is given in the frame of the scene and the result
+// refers to the state of the scene when it was last drawn. Objects in a list
+// are evaluated in their local frame, which does not need an OpenGL context.
+//
+// Returns:
+//	An empty list if nothing is hit, otherwise the list
+//	[object, ray parameter of hit, [x, y, z] of hit, part id].
+
+bool PickRayFunc(CCLUCodeBase& rCB, CCodeVar& rVar, CCodeVar& rPars, int iLine, int iPos)
+{
+	TVarList& mVars = *rPars.GetVarListPtr();
+
+	int iVarCount  = int(mVars.Count());
+	TCVScalar dTol = 0;
+
+	if ((iVarCount < 3) || (iVarCount > 4))
+	{
+		int piPar[] = { 3, 4 };
+
+		rCB.GetErrorList().WrongNoOfParams(piPar, 2, iLine, iPos);
+		return false;
+	}
+
+	if ((mVars(1).BaseType() != PDT_MULTIV) || (mVars(2).BaseType() != PDT_MULTIV))
+	{
+		rCB.GetErrorList().GeneralError("Expect ray origin and direction as E3 vectors.", iLine, iPos);
+		return false;
+	}
+
+	TMultiV vOrigE3, vDirE3;
+	if (!rCB.CastMVtoE3(*mVars(1).GetMultiVPtr(), vOrigE3))
+	{
+		rCB.GetErrorList().InvalidParType(mVars(1), 2, iLine, iPos);
+		return false;
+	}
+
+	if (!rCB.CastMVtoE3(*mVars(2).GetMultiVPtr(), vDirE3))
+	{
+		rCB.GetErrorList().InvalidParType(mVars(2), 3, iLine, iPos);
+		return false;
+	}
+
+	if (iVarCount > 3)
+	{
+		if (!mVars(3).CastToScalar(dTol, rCB.GetSensitivity()) || (dTol < 0))
+		{
+			rCB.GetErrorList().GeneralError("Expect a non-negative pick tolerance as fourth parameter.", iLine, iPos);
+			return false;
+		}
+	}
+
+	COGLPickBVH::SRay xRay;
+	xRay.pfOrig[0] = float(vOrigE3[E3GA < TCVScalar > ::iE1]);
+	xRay.pfOrig[1] = float(vOrigE3[E3GA < TCVScalar > ::iE2]);
+	xRay.pfOrig[2] = float(vOrigE3[E3GA < TCVScalar > ::iE3]);
+	xRay.pfDir[0]  = float(vDirE3[E3GA < TCVScalar > ::iE1]);
+	xRay.pfDir[1]  = float(vDirE3[E3GA < TCVScalar > ::iE2]);
+	xRay.pfDir[2]  = float(vDirE3[E3GA < TCVScalar > ::iE3]);
+	xRay.fTol      = float(dTol);
+
+	COGLPickBVH::SHit xHit;
+	COGLBEReference refHit;
+	bool bHit = false;
+
+	if (mVars(0).BaseType() == PDT_SCENE)
+	{
+		COGLBEReference Scene = *mVars(0).GetScenePtr();
+
+		COGLScene* pScene = dynamic_cast< COGLScene* >((COGLBaseElement*) Scene);
+		if (!Scene.IsValid() || !pScene)
+		{
+			rCB.GetErrorList().GeneralError("Scene is not valid.", iLine, iPos);
+			return false;
+		}
+
+		COGLPickBVH* pPickBVH = pScene->GetPickBVH();
+		if (!pPickBVH)
+		{
+			rCB.GetErrorList().GeneralError("Pick hierarchy is not enabled for scene. Use EnableScenePickBVH().", iLine, iPos);
+			return false;
+		}
+
+		if ((bHit = pPickBVH->PickRay(xRay, xHit)))
+		{
+			refHit = pScene->GetElementWithUID(xHit.uUID);
+		}
+	}
+	else if (mVars(0).BaseType() == PDT_VARLIST)
+	{
+		TVarList& rObjList = *mVars(0).GetVarListPtr();
+		int iObj, iObjCnt  = int(rObjList.Count());
+
+		COGLPickBVH xPickBVH;
+		xPickBVH.BeginUpdate();
+
+		for (iObj = 0; iObj < iObjCnt; ++iObj)
+		{
+			COGLVertexList* pVexList = nullptr;
+			if (rObjList(iObj).BaseType() == PDT_SCENE)
+			{
+				pVexList = dynamic_cast< COGLVertexList* >((COGLBaseElement*) *rObjList(iObj).GetScenePtr());
+			}
+
+			if (!pVexList)
+			{
+				rCB.GetErrorList().GeneralError("Expect a list of objects as first parameter.", iLine, iPos);
+				return false;
+			}
+
+			COGLPickBVH::SGeometry xGeo;
+			if (!pVexList->GetPickGeometry(xGeo))
+			{
+				rCB.GetErrorList().GeneralError("Object data is not available on the host.", iLine, iPos);
+				return false;
+			}
+
+			xPickBVH.SetGeometry(pVexList, pVexList->GetGeometryStamp(), xGeo);
+			xPickBVH.AddInstance(pVexList, unsigned(iObj), nullptr);
+		}
+
+		xPickBVH.EndUpdate();
+
+		if ((bHit = xPickBVH.PickRay(xRay, xHit)))
+		{
+			refHit = *rObjList(int(xHit.uUID)).GetScenePtr();
+		}
+	}
+	else
+	{
+		rCB.GetErrorList().GeneralError("Expect a scene or a list of objects as first parameter.", iLine, iPos);
+		return false;
+	}
+
+	rVar.New(PDT_VARLIST);
+	TVarList& rList = *rVar.GetVarListPtr();
+
+	if (!bHit)
+	{
+		return true;
+	}
+
+	rList.Set(4);
+	rList(0) = refHit;
+	rList(1) = TCVScalar(xHit.fT);
+
+	rList(2).New(PDT_VARLIST);
+	TVarList& rPos = *rList(2).GetVarListPtr();
+	rPos.Set(3);
+	rPos(0) = TCVScalar(xHit.pfPos[0]);
+	rPos(1) = TCVScalar(xHit.pfPos[1]);
+	rPos(2) = TCVScalar(xHit.pfPos[2]);
+
+	rList(3) = TCVCounter(xHit.uPartId);
+
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Get the axis aligned bounding box of a scene or an object
+//
+// Parameters:
+//	1. A scene or an object
+//
+// The box is given in the frame the element is drawn in, i.e. it includes
+// the transformations of the element itself. Does not need an OpenGL context.
+//
+// Returns:
+//	An empty list if the element has no bounds, otherwise the list
+//	[[min x, min y, min z], [max x, max y, max z]].
+
+bool GetBoundingBoxFunc(CCLUCodeBase& rCB, CCodeVar& rVar, CCodeVar& rPars, int iLine, int iPos)
+{
+	TVarList& mVars = *rPars.GetVarListPtr();
+	int iVarCount   = int(mVars.Count());
+
+	if (iVarCount != 1)
+	{
+		rCB.GetErrorList().WrongNoOfParams(1, iLine, iPos);
+		return false;
+	}
+
+	if (mVars(0).BaseType() != PDT_SCENE)
+	{
+		rCB.GetErrorList().InvalidParType(mVars(0), 1, iLine, iPos);
+		return false;
+	}
+
+	COGLBEReference refElement = *mVars(0).GetScenePtr();
+	if (!refElement.IsValid())
+	{
+		rCB.GetErrorList().GeneralError("Scene is not valid.", iLine, iPos);
+		return false;
+	}
+
+	const COGLBaseElement::SBoundInfo& xInfo = refElement->GetBoundInfo();
+
+	rVar.New(PDT_VARLIST);
+	TVarList& rList = *rVar.GetVarListPtr();
+
+	if (!xInfo.bBounded || xInfo.xBox.IsEmpty())
+	{
+		return true;
+	}
+
+	rList.Set(2);
+	for (int iBound = 0; iBound < 2; ++iBound)
+	{
+		const float* pfBound = (iBound == 0 ? xInfo.xBox.GetMin() : xInfo.xBox.GetMax());
+
+		rList(iBound).New(PDT_VARLIST);
+		TVarList& rPos = *rList(iBound).GetVarListPtr();
+		rPos.Set(3);
+		rPos(0) = TCVScalar(pfBound[0]);
+		rPos(1) = TCVScalar(pfBound[1]);
+		rPos(2) = TCVScalar(pfBound[2]);
+	}
+
+	return true;
+}
+
 //////////////////////////////////////////////////////////////////////
 // Enable/Disable local time
 
@@ -0,0 +1,490 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// project:   CluViz.Plugin.StdLib.rtl
+// file:      Func_SharedBuffer.cpp
+//
+// summary:   Implements the shared buffer functions
+//
+//            Copyright (c) 2019 by Christian Perwass.
+//
+//            This file is part of the CluTecLib library.
+//
+//            The CluTecLib library is free software: you can redistribute it and / or modify
+//            it under the terms of the GNU Lesser General Public License as published by
+//            the Free Software Foundation, either version 3 of the License, or
+//            (at your option) any later version.
+//
+//            The CluTecLib library is distributed in the hope that it will be useful,
+//            but WITHOUT ANY WARRANTY; without even the implied warranty of
+//            MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//            GNU Lesser General Public License for more details.
+//
+//            You should have received a copy of the GNU Lesser General Public License
+//            along with the CluTecLib library.
+//            If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "stdafx.h"
+
+#include "Func_SharedBuffer.h"
+
+//////////////////////////////////////////////////////////////////////
+// Get a shared buffer by the name given in a parameter.
+// The returned buffer holds a reference that has to be released.
+
+static CSharedBuffer* GetSharedBufferPar(CCLUCodeBase& rCB, CCodeVar& rPar, int iParIdx, int iLine, int iPos)
+{
+	if (rPar.BaseType() != PDT_STRING)
+	{
+		rCB.GetErrorList().InvalidParType(rPar, iParIdx, iLine, iPos);
+		return nullptr;
+	}
+
+	TString csName = *rPar.GetStringPtr();
+
+	CSharedBuffer* pBuffer = rCB.GetSharedBufferRegistry().Get(std::string(csName.Str()));
+	if (!pBuffer)
+	{
+		rCB.GetErrorList().GeneralError("Shared buffer of given name does not exist.", iLine, iPos);
+		return nullptr;
+	}
+
+	return pBuffer;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Get the newest published frame of a shared buffer as tensor
+//
+// Pars:
+// 1. (string) the name of the shared buffer
+//
+// Return:
+//	tensor with the dimensions of the buffer
+
+bool  GetSharedTensorFunc(CCLUCodeBase& rCB, CCodeVar& rVar, CCodeVar& rPars, int iLine, int iPos)
+{
+	TVarList& mVars = *rPars.GetVarListPtr();
+
+	int iVarCount = int(mVars.Count());
+
+	if (iVarCount != 1)
+	{
+		int piPar[] = { 1 };
+
+		rCB.GetErrorList().WrongNoOfParams(piPar, 1, iLine, iPos);
+		return false;
+	}
+
+	CSharedBuffer* pBuffer = GetSharedBufferPar(rCB, mVars(0), 1, iLine, iPos);
+	if (!pBuffer)
+	{
+		return false;
+	}
+
+	pBuffer->Acquire();
+
+	const std::vector<int>& vecDim = pBuffer->GetDim();
+	Mem<int> mDim;
+
+	mDim.Set(int(vecDim.size()));
+	for (size_t nDim = 0; nDim < vecDim.size(); ++nDim)
+	{
+		mDim[int(nDim)] = vecDim[nDim];
+	}
+
+	rVar.New(PDT_TENSOR);
+	TTensor& rT = *rVar.GetTensorPtr();
+
+	try
+	{
+		rT.Reset(mDim);
+	}
+	catch (...)
+	{
+		pBuffer->Release();
+		rCB.GetErrorList().GeneralError("Cannot create tensor of shared buffer size.", iLine, iPos);
+		return false;
+	}
+
+	TCVScalar* pData = rT.Data();
+	size_t nElCnt    = pBuffer->GetElementCount();
+
+	// Tensors store doubles, so this is the only copy of the data
+	switch (pBuffer->GetDataType())
+	{
+	case CSharedBuffer::DT_UINT8:
+	{
+		const unsigned char* pSrc = (const unsigned char*) pBuffer->GetReadData();
+		for (size_t nIdx = 0; nIdx < nElCnt; ++nIdx)
+		{
+			pData[nIdx] = TCVScalar(pSrc[nIdx]);
+		}
+	}
+	break;
+
+	case CSharedBuffer::DT_FLOAT:
+	{
+		const float* pSrc = (const float*) pBuffer->GetReadData();
+		for (size_t nIdx = 0; nIdx < nElCnt; ++nIdx)
+		{
+			pData[nIdx] = TCVScalar(pSrc[nIdx]);
+		}
+	}
+	break;
+
+	case CSharedBuffer::DT_DOUBLE:
+		memcpy(pData, pBuffer->GetReadData(), nElCnt * sizeof(double));
+		break;
+	}
+
+	pBuffer->Release();
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Get the newest published frame of a shared buffer as image
+//
+// Pars:
+// 1. (string) the name of the shared buffer.
+//		The buffer has to be of type uint8 or float and of dimensions
+//		[height, width] or [height, width, channels] with 1, 3 or 4 channels.
+//
+// Return:
+//	luminance, RGB or RGBA image
+
+bool  GetSharedImageFunc(CCLUCodeBase& rCB, CCodeVar& rVar, CCodeVar& rPars, int iLine, int iPos)
+{
+	TVarList& mVars = *rPars.GetVarListPtr();
+
+	int iVarCount = int(mVars.Count());
+
+	if (iVarCount != 1)
+	{
+		int piPar[] = { 1 };
+
+		rCB.GetErrorList().WrongNoOfParams(piPar, 1, iLine, iPos);
+		return false;
+	}
+
+	CSharedBuffer* pBuffer = GetSharedBufferPar(rCB, mVars(0), 1, iLine, iPos);
+	if (!pBuffer)
+	{
+		return false;
+	}
+
+	const std::vector<int>& vecDim = pBuffer->GetDim();
+	int iChannels = (vecDim.size() == 3 ? vecDim[2] : 1);
+	int iImgType, iDataType;
+
+	if (vecDim.size() < 2 || vecDim.size() > 3)
+	{
+		pBuffer->Release();
+		rCB.GetErrorList().GeneralError("Shared buffer has to be of dimensions [height, width] or [height, width, channels].", iLine, iPos);
+		return false;
+	}
+
+	if (iChannels == 1)
+	{
+		iImgType = CLUVIZ_IMG_LUMINANCE;
+	}
+	else if (iChannels == 3)
+	{
+		iImgType = CLUVIZ_IMG_RGB;
+	}
+	else if (iChannels == 4)
+	{
+		iImgType = CLUVIZ_IMG_RGBA;
+	}
+	else
+	{
+		pBuffer->Release();
+		rCB.GetErrorList().GeneralError("Shared buffer images have to have 1, 3 or 4 channels.", iLine, iPos);
+		return false;
+	}
+
+	if (pBuffer->GetDataType() == CSharedBuffer::DT_UINT8)
+	{
+		iDataType = CLUVIZ_IMG_UNSIGNED_BYTE;
+	}
+	else if (pBuffer->GetDataType() == CSharedBuffer::DT_FLOAT)
+	{
+		iDataType = CLUVIZ_IMG_FLOAT;
+	}
+	else
+	{
+		pBuffer->Release();
+		rCB.GetErrorList().GeneralError("Shared buffer images have to be of type uint8 or float.", iLine, iPos);
+		return false;
+	}
+
+	rVar.New(PDT_IMAGE);
+	TImage& rImg = *rVar.GetImagePtr();
+	if (!rImg.IsValid())
+	{
+		pBuffer->Release();
+		rCB.GetErrorList().GeneralError("Cannot create image.", iLine, iPos);
+		return false;
+	}
+	COGLImage& oglImage = *((COGLImage*) rImg);
+
+	pBuffer->Acquire();
+
+	oglImage.SetFilename("Memory");
+	if (!oglImage.CopyImage(vecDim[1], vecDim[0], iImgType, iDataType, pBuffer->GetReadData()))
+	{
+		pBuffer->Release();
+		rCB.GetErrorList().GeneralError("Cannot create image.", iLine, iPos);
+		return false;
+	}
+
+	pBuffer->Release();
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Get the frame number of the newest published data of a shared buffer
+//
+// Pars:
+// 1. (string) the name of the shared buffer
+//
+// Return:
+//	the number of frames published up to the newest frame
+
+bool  GetSharedBufferFrameFunc(CCLUCodeBase& rCB, CCodeVar& rVar, CCodeVar& rPars, int iLine, int iPos)
+{
+	TVarList& mVars = *rPars.GetVarListPtr();
+
+	int iVarCount = int(mVars.Count());
+
+	if (iVarCount != 1)
+	{
+		int piPar[] = { 1 };
+
+		rCB.GetErrorList().WrongNoOfParams(piPar, 1, iLine, iPos);
+		return false;
+	}
+
+	CSharedBuffer* pBuffer = GetSharedBufferPar(rCB, mVars(0), 1, iLine, iPos);
+	if (!pBuffer)
+	{
+		return false;
+	}
+
+	pBuffer->Acquire();
+	rVar = TCVCounter(pBuffer->GetFrame());
+
+	pBuffer->Release();
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Use a shared buffer as vertex position source of a vertex list.
+// The buffer has to contain 3 elements per vertex. Float buffers are uploaded
+// to the vertex buffer directly, without a copy in the vertex list.
+//
+// Pars:
+// 1. (vexlist) the vertex list
+// 2. (opt)(string) the name of the shared buffer. No name or an empty name removes the source.
+//
+// Return:
+//	the vertex list
+
+bool  SetVexListSharedBufferFunc(CCLUCodeBase& rCB, CCodeVar& rVar, CCodeVar& rPars, int iLine, int iPos)
+{
+	TVarList& mVars = *rPars.GetVarListPtr();
+
+	int iVarCount = int(mVars.Count());
+
+	if ((iVarCount < 1) || (iVarCount > 2))
+	{
+		int piPar[] = { 1, 2 };
+
+		rCB.GetErrorList().WrongNoOfParams(piPar, 2, iLine, iPos);
+		return false;
+	}
+
+	if (mVars(0).BaseType() != PDT_SCENE)
+	{
+		rCB.GetErrorList().GeneralError("First parameter has to be a object.", iLine, iPos);
+		return false;
+	}
+
+	TScene scVL              = *mVars(0).GetScenePtr();
+	COGLVertexList* pVexList = dynamic_cast<COGLVertexList*>((COGLBaseElement*) scVL);
+
+	if (!pVexList)
+	{
+		rCB.GetErrorList().GeneralError("First parameter is not an object.", iLine, iPos);
+		return false;
+	}
+
+	CSharedBuffer* pBuffer = nullptr;
+
+	if (iVarCount == 2)
+	{
+		if (mVars(1).BaseType() != PDT_STRING)
+		{
+			rCB.GetErrorList().InvalidParType(mVars(1), 2, iLine, iPos);
+			return false;
+		}
+
+		if (mVars(1).GetStringPtr()->Len() > 0)
+		{
+			pBuffer = GetSharedBufferPar(rCB, mVars(1), 2, iLine, iPos);
+			if (!pBuffer)
+			{
+				return false;
+			}
+		}
+	}
+
+	bool bOK = pVexList->SetSharedVexSource(pBuffer);
+
+	// The vertex list holds its own reference
+	if (pBuffer)
+	{
+		pBuffer->Release();
+	}
+
+	if (!bOK)
+	{
+		rCB.GetErrorList().GeneralError("Number of elements of shared buffer has to be a multiple of 3.", iLine, iPos);
+		return false;
+	}
+
+	rVar = mVars(0);
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Publish a frame to a shared buffer, as the host application does.
+// The buffer is created if it does not exist or if its type or dimensions differ.
+// This is used to test scripts reading shared buffers without a host application.
+//
+// Pars:
+// 1. (string) the name of the shared buffer
+// 2. (tensor) the data of the frame. The buffer has the dimensions of the tensor.
+// 3. (string) the element type: "uint8", "float" or "double"
+//
+// Return:
+//	the number of frames published to the buffer
+
+bool  PublishSharedBufferFunc(CCLUCodeBase& rCB, CCodeVar& rVar, CCodeVar& rPars, int iLine, int iPos)
+{
+	TVarList& mVars = *rPars.GetVarListPtr();
+
+	int iVarCount = int(mVars.Count());
+
+	if (iVarCount != 3)
+	{
+		int piPar[] = { 3 };
+
+		rCB.GetErrorList().WrongNoOfParams(piPar, 1, iLine, iPos);
+		return false;
+	}
+
+	if (mVars(0).BaseType() != PDT_STRING)
+	{
+		rCB.GetErrorList().InvalidParType(mVars(0), 1, iLine, iPos);
+		return false;
+	}
+
+	if (mVars(1).BaseType() != PDT_TENSOR)
+	{
+		rCB.GetErrorList().InvalidParType(mVars(1), 2, iLine, iPos);
+		return false;
+	}
+
+	if (mVars(2).BaseType() != PDT_STRING)
+	{
+		rCB.GetErrorList().InvalidParType(mVars(2), 3, iLine, iPos);
+		return false;
+	}
+
+	TString csName = *mVars(0).GetStringPtr();
+	TString csType = *mVars(2).GetStringPtr();
+	TTensor& rT    = *mVars(1).GetTensorPtr();
+	int iDataType;
+
+	if (csType == "uint8")
+	{
+		iDataType = CSharedBuffer::DT_UINT8;
+	}
+	else if (csType == "float")
+	{
+		iDataType = CSharedBuffer::DT_FLOAT;
+	}
+	else if (csType == "double")
+	{
+		iDataType = CSharedBuffer::DT_DOUBLE;
+	}
+	else
+	{
+		rCB.GetErrorList().GeneralError("Element type has to be 'uint8', 'float' or 'double'.", iLine, iPos);
+		return false;
+	}
+
+	std::vector<int> vecDim(size_t(rT.Valence()));
+	for (int iDim = 0; iDim < rT.Valence(); ++iDim)
+	{
+		vecDim[iDim] = rT.DimSize(iDim);
+	}
+
+	CSharedBufferRegistry& rReg = rCB.GetSharedBufferRegistry();
+	std::string sName(csName.Str());
+
+	// Keep an existing buffer, so that objects using it see the new frame
+	CSharedBuffer* pBuffer = rReg.Get(sName);
+	if (pBuffer && ((pBuffer->GetDataType() != iDataType) || (pBuffer->GetDim() != vecDim)))
+	{
+		pBuffer->Release();
+		pBuffer = nullptr;
+	}
+
+	if (!pBuffer)
+	{
+		pBuffer = rReg.Create(sName, iDataType, vecDim);
+		if (!pBuffer)
+		{
+			rCB.GetErrorList().GeneralError("Cannot create shared buffer.", iLine, iPos);
+			return false;
+		}
+	}
+
+	const TCVScalar* pData = rT.Data();
+	size_t nElCnt          = pBuffer->GetElementCount();
+
+	switch (pBuffer->GetDataType())
+	{
+	case CSharedBuffer::DT_UINT8:
+	{
+		unsigned char* pDst = (unsigned char*) pBuffer->GetWriteData();
+		for (size_t nIdx = 0; nIdx < nElCnt; ++nIdx)
+		{
+			TCVScalar dVal = pData[nIdx];
+			pDst[nIdx]     = (unsigned char) (dVal < 0 ? 0 : (dVal > 255 ? 255 : dVal));
+		}
+	}
+	break;
+
+	case CSharedBuffer::DT_FLOAT:
+	{
+		float* pDst = (float*) pBuffer->GetWriteData();
+		for (size_t nIdx = 0; nIdx < nElCnt; ++nIdx)
+		{
+			pDst[nIdx] = float(pData[nIdx]);
+		}
+	}
+	break;
+
+	case CSharedBuffer::DT_DOUBLE:
+		memcpy(pBuffer->GetWriteData(), pData, nElCnt * sizeof(double));
+		break;
+	}
+
+	pBuffer->Publish();
+	rVar = TCVCounter(pBuffer->GetPublishCount());
+
+	pBuffer->Release();
+	return true;
+}
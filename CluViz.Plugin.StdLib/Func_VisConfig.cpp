@@ -81,6 +81,59 @@ bool EnableTransparencyFunc(CCLUCodeBase& rCB, CCodeVar& rVar, CCodeVar& rPars,
 	return true;
 }
 
+//////////////////////////////////////////////////////////////////////
+/// Enable picking with a bounding volume hierarchy of the main scene,
+/// which avoids drawing the scene in pick mode.
+
+bool EnablePickBVHFunc(CCLUCodeBase& rCB, CCodeVar& rVar, CCodeVar& rPars, int iLine, int iPos)
+{
+	TVarList& mVars = *rPars.GetVarListPtr();
+	int iVarCount   = int(mVars.Count());
+	TCVCounter iVal;
+
+	if (iVarCount != 1)
+	{
+		rCB.GetErrorList().WrongNoOfParams(1, iLine, iPos);
+		return false;
+	}
+
+	if (!mVars(0).CastToCounter(iVal))
+	{
+		rCB.GetErrorList().InvalidParType(mVars(0), 1, iLine, iPos);
+		return false;
+	}
+
+	rCB.GetCLUDrawBase()->EnablePickBVH((iVal != 0));
+
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////
+/// Enable skipping scene elements that lie outside of the view frustum.
+
+bool EnableFrustumCullingFunc(CCLUCodeBase& rCB, CCodeVar& rVar, CCodeVar& rPars, int iLine, int iPos)
+{
+	TVarList& mVars = *rPars.GetVarListPtr();
+	int iVarCount   = int(mVars.Count());
+	TCVCounter iVal;
+
+	if (iVarCount != 1)
+	{
+		rCB.GetErrorList().WrongNoOfParams(1, iLine, iPos);
+		return false;
+	}
+
+	if (!mVars(0).CastToCounter(iVal))
+	{
+		rCB.GetErrorList().InvalidParType(mVars(0), 1, iLine, iPos);
+		return false;
+	}
+
+	rCB.GetCLUDrawBase()->EnableFrustumCulling((iVal != 0));
+
+	return true;
+}
+
 //////////////////////////////////////////////////////////////////////
 /// Enable Color Stereo Display
 